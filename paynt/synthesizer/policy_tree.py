@@ -312,8 +312,34 @@ class PolicyTree:
     def double_check(self, quotient, prop):
         leaves = self.collect_leaves()
         logger.info("double-checking {} families...".format(len(leaves)))
+        sat_leaves = []
         for leaf in leaves:
-            leaf.double_check(quotient,prop)
+            if leaf.sat:
+                sat_leaves.append(leaf)
+            else:
+                leaf.double_check(quotient,prop)
+        if sat_leaves:
+            # verify all satisfying leaves in one native sweep: deposit the policies into a
+            # registry and check the restrictions of the quotient without building the MDPs
+            registry = payntbind.synthesis.SchedulerRegistry()
+            undefined_action = payntbind.synthesis.SchedulerRegistry.UNDEFINED_ACTION
+            policy_handles = []
+            family_choices = []
+            for leaf in sat_leaves:
+                policy,_ = self.policies[leaf.policy_index]
+                policy_handles.append(registry.insert_policy(
+                    [action if action is not None else undefined_action for action in policy]))
+                family_choices.append(quotient.coloring.selectCompatibleChoices(leaf.family.family))
+            DOUBLE_CHECK_PRECISION = 1e-6
+            default_precision = Property.model_checking_precision
+            Property.set_model_checking_precision(DOUBLE_CHECK_PRECISION)
+            sat_mask,values = payntbind.synthesis.verify_policy_tree_leaves(
+                Property.environment, quotient.quotient_mdp, quotient.choice_to_action, registry,
+                family_choices, policy_handles, prop.formula_alt, prop.threshold, prop.minimizing)
+            Property.set_model_checking_precision(default_precision)
+            for index,leaf in enumerate(sat_leaves):
+                if not sat_mask[index]:
+                    logger.warning("policy should be SAT but (most likely due to model checking precision) has value {}".format(values[index]))
         logger.info("all solutions are OK")
 
     
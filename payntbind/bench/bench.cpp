@@ -0,0 +1,280 @@
+#include "src/synthesis/quotient/Coloring.h"
+#include "src/synthesis/quotient/Family.h"
+#include "src/synthesis/synthesizer/SynthesizerArCore.h"
+#include "src/synthesis/translation/BinaryModelExport.h"
+#include "src/synthesis/verification/MdpModelChecker.h"
+
+#include <storm/environment/Environment.h>
+#include <storm/logic/AtomicLabelFormula.h>
+#include <storm/logic/EventuallyFormula.h>
+#include <storm/logic/ProbabilityOperatorFormula.h>
+#include <storm/models/sparse/Mdp.h>
+#include <storm/models/sparse/StateLabeling.h>
+#include <storm/storage/SparseMatrix.h>
+#include <storm/storage/sparse/ModelComponents.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Micro-benchmark driver for the payntbind hot kernels. The fixtures generate synthetic
+ * quotients and colorings at a configurable scale, so regressions in the native entry points
+ * surface in minutes instead of in slower end-to-end runs days later.
+ *
+ *   payntbind-bench [filter-substring] [--scale N] [--reps N] [--list]
+ *
+ * Each benchmark is run reps times at the given scale and the median wall time is reported.
+ */
+
+namespace {
+
+/** Deterministic generator so that runs are comparable across machines and commits. */
+struct Lcg {
+    uint64_t state = 0x853c49e6748fea9b;
+    uint64_t next(uint64_t bound) {
+        state = state*6364136223846793005 + 1442695040888963407;
+        return (state >> 33) % bound;
+    }
+};
+
+struct Fixture {
+    uint64_t num_states;
+    uint64_t choices_per_state;
+    uint64_t num_holes;
+    uint64_t options_per_hole;
+
+    uint64_t numChoices() const {
+        return num_states*choices_per_state;
+    }
+
+    std::vector<uint64_t> rowGroups() const {
+        std::vector<uint64_t> row_groups(num_states+1);
+        for(uint64_t state = 0; state <= num_states; ++state) {
+            row_groups[state] = state*choices_per_state;
+        }
+        return row_groups;
+    }
+
+    synthesis::Family family() const {
+        synthesis::Family family;
+        for(uint64_t hole = 0; hole < num_holes; ++hole) {
+            family.addHole(options_per_hole);
+        }
+        return family;
+    }
+
+    std::vector<std::vector<std::pair<uint64_t,uint64_t>>> choiceToAssignment() const {
+        Lcg rng;
+        std::vector<std::vector<std::pair<uint64_t,uint64_t>>> choice_to_assignment(numChoices());
+        for(uint64_t choice = 0; choice < numChoices(); ++choice) {
+            choice_to_assignment[choice].push_back(
+                std::make_pair(rng.next(num_holes),rng.next(options_per_hole))
+            );
+        }
+        return choice_to_assignment;
+    }
+
+    synthesis::Coloring coloring(synthesis::Family const& family) const {
+        return synthesis::Coloring(family,rowGroups(),choiceToAssignment());
+    }
+
+    /** A subfamily with a random non-trivial restriction of every hole. */
+    synthesis::Family subfamily(synthesis::Family const& family) const {
+        Lcg rng;
+        synthesis::Family subfamily(family);
+        for(uint64_t hole = 0; hole < num_holes; ++hole) {
+            std::vector<uint64_t> options;
+            for(uint64_t option = 0; option < options_per_hole; ++option) {
+                if(options.empty() or rng.next(2) == 0) {
+                    options.push_back(option);
+                }
+            }
+            subfamily.holeSetOptions(hole,options);
+        }
+        return subfamily;
+    }
+
+    /** Quotient MDP with two successors per row and targets in the last tenth of the states. */
+    std::shared_ptr<storm::models::sparse::Mdp<double>> quotientMdp() const {
+        Lcg rng;
+        storm::storage::SparseMatrixBuilder<double> builder(numChoices(),num_states,2*numChoices(),true,true,num_states);
+        for(uint64_t state = 0; state < num_states; ++state) {
+            builder.newRowGroup(state*choices_per_state);
+            for(uint64_t offset = 0; offset < choices_per_state; ++offset) {
+                uint64_t dst1 = (state+1) % num_states;
+                uint64_t dst2 = rng.next(num_states);
+                if(dst2 == dst1) {
+                    dst2 = (dst2+1) % num_states;
+                }
+                if(dst1 > dst2) {
+                    std::swap(dst1,dst2);
+                }
+                builder.addNextValue(state*choices_per_state+offset,dst1,0.5);
+                builder.addNextValue(state*choices_per_state+offset,dst2,0.5);
+            }
+        }
+        storm::storage::sparse::ModelComponents<double> components;
+        components.transitionMatrix = builder.build();
+        storm::models::sparse::StateLabeling labeling(num_states);
+        storm::storage::BitVector init(num_states,false);
+        init.set(0,true);
+        labeling.addLabel("init",std::move(init));
+        storm::storage::BitVector target(num_states,false);
+        for(uint64_t state = num_states - num_states/10; state < num_states; ++state) {
+            target.set(state,true);
+        }
+        labeling.addLabel("target",std::move(target));
+        components.stateLabeling = std::move(labeling);
+        return std::make_shared<storm::models::sparse::Mdp<double>>(std::move(components));
+    }
+};
+
+std::shared_ptr<storm::logic::Formula const> maxReachabilityFormula() {
+    auto target = std::make_shared<storm::logic::AtomicLabelFormula const>("target");
+    auto eventually = std::make_shared<storm::logic::EventuallyFormula const>(target);
+    storm::logic::OperatorInformation info(storm::solver::OptimizationDirection::Maximize);
+    return std::make_shared<storm::logic::ProbabilityOperatorFormula const>(eventually,info);
+}
+
+struct Benchmark {
+    std::string name;
+    std::function<void(Fixture const&)> run;
+};
+
+std::vector<Benchmark> buildBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+
+    benchmarks.push_back({"coloring_construct", [](Fixture const& fixture) {
+        auto family = fixture.family();
+        synthesis::Coloring coloring(family,fixture.rowGroups(),fixture.choiceToAssignment());
+    }});
+
+    benchmarks.push_back({"coloring_select_compatible", [](Fixture const& fixture) {
+        auto family = fixture.family();
+        auto coloring = fixture.coloring(family);
+        auto subfamily = fixture.subfamily(family);
+        coloring.selectCompatibleChoices(subfamily);
+    }});
+
+    benchmarks.push_back({"coloring_select_batch", [](Fixture const& fixture) {
+        auto family = fixture.family();
+        auto coloring = fixture.coloring(family);
+        std::vector<synthesis::Family> subfamilies(32,fixture.subfamily(family));
+        coloring.selectCompatibleChoicesBatch(subfamilies);
+    }});
+
+    benchmarks.push_back({"coloring_select_refined", [](Fixture const& fixture) {
+        auto family = fixture.family();
+        auto coloring = fixture.coloring(family);
+        auto parent_selection = coloring.selectCompatibleChoices(family);
+        auto subfamily = fixture.subfamily(family);
+        coloring.selectCompatibleChoicesRefined(subfamily,parent_selection,0);
+    }});
+
+    benchmarks.push_back({"coloring_collect_hole_options", [](Fixture const& fixture) {
+        auto family = fixture.family();
+        auto coloring = fixture.coloring(family);
+        storm::storage::BitVector choices(fixture.numChoices(),true);
+        coloring.collectHoleOptions(choices);
+    }});
+
+    benchmarks.push_back({"coloring_score_split", [](Fixture const& fixture) {
+        auto family = fixture.family();
+        auto coloring = fixture.coloring(family);
+        storm::storage::BitVector choices(fixture.numChoices(),true);
+        coloring.scoreSplitCandidates(family,choices);
+    }});
+
+    benchmarks.push_back({"family_refine", [](Fixture const& fixture) {
+        auto family = fixture.family();
+        Lcg rng;
+        for(uint64_t iteration = 0; iteration < fixture.num_states; ++iteration) {
+            synthesis::Family subfamily(family);
+            subfamily.holeSetOptions(rng.next(fixture.num_holes),std::vector<uint64_t>{0});
+        }
+    }});
+
+    benchmarks.push_back({"restricted_value_iteration", [](Fixture const& fixture) {
+        auto mdp = fixture.quotientMdp();
+        storm::storage::BitVector choice_mask(fixture.numChoices(),true);
+        storm::storage::BitVector target_states(fixture.num_states,false);
+        for(uint64_t state = fixture.num_states - fixture.num_states/10; state < fixture.num_states; ++state) {
+            target_states.set(state,true);
+        }
+        storm::storage::BitVector constraint_states(fixture.num_states,true);
+        synthesis::restrictedValueIteration<double>(
+            mdp->getTransitionMatrix(),choice_mask,target_states,constraint_states,false,1e-6,1000
+        );
+    }});
+
+    benchmarks.push_back({"ar_core_run", [](Fixture const& fixture) {
+        auto family = fixture.family();
+        auto coloring = fixture.coloring(family);
+        synthesis::SynthesizerArCore<double> core(fixture.quotientMdp(),coloring,maxReachabilityFormula());
+        core.pushFamily(family);
+        storm::Environment env;
+        core.run(env,64);
+    }});
+
+    benchmarks.push_back({"model_binary_roundtrip", [](Fixture const& fixture) {
+        auto mdp = fixture.quotientMdp();
+        auto buffer = synthesis::serializeModelBinary(*mdp);
+        synthesis::deserializeModelBinary(buffer.data(),buffer.size());
+    }});
+
+    return benchmarks;
+}
+
+double medianMilliseconds(std::function<void()> const& run, uint64_t reps) {
+    std::vector<double> times;
+    times.reserve(reps);
+    for(uint64_t rep = 0; rep < reps; ++rep) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto stop = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double,std::milli>(stop-start).count());
+    }
+    std::sort(times.begin(),times.end());
+    return times[times.size()/2];
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    uint64_t scale = 100000;
+    uint64_t reps = 5;
+    bool list_only = false;
+    for(int arg = 1; arg < argc; ++arg) {
+        if(std::strcmp(argv[arg],"--scale") == 0 and arg+1 < argc) {
+            scale = std::stoull(argv[++arg]);
+        } else if(std::strcmp(argv[arg],"--reps") == 0 and arg+1 < argc) {
+            reps = std::stoull(argv[++arg]);
+        } else if(std::strcmp(argv[arg],"--list") == 0) {
+            list_only = true;
+        } else {
+            filter = argv[arg];
+        }
+    }
+
+    Fixture fixture{scale,4,8,8};
+    auto benchmarks = buildBenchmarks();
+    for(auto const& benchmark: benchmarks) {
+        if(not filter.empty() and benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if(list_only) {
+            std::cout << benchmark.name << "\n";
+            continue;
+        }
+        double median = medianMilliseconds([&]{ benchmark.run(fixture); },reps);
+        std::cout << benchmark.name << " scale=" << scale << " reps=" << reps
+            << " median=" << median << "ms" << std::endl;
+    }
+    return 0;
+}
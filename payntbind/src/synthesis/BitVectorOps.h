@@ -0,0 +1,103 @@
+#pragma once
+
+#include <storm/storage/BitVector.h>
+#include <storm/utility/macros.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace synthesis {
+
+/*
+ * Shared block-wise primitives over BitVector contents. Several hot loops used to hand-roll
+ * per-bit scans of masks; these helpers work on 64-bit blocks through the vector's integer
+ * accessors, so every caller runs on the same word-level substrate. getAsInt returns the block
+ * with the bit at the given index as its most significant bit.
+ */
+
+/**
+ * Number of positions set in both vectors, counted block-wise without materializing the
+ * intersection (\c (a&b).getNumberOfSetBits() allocates a full-length temporary).
+ */
+inline uint64_t maskedAndCount(storm::storage::BitVector const& a, storm::storage::BitVector const& b) {
+    STORM_LOG_ASSERT(a.size() == b.size(), "mask sizes differ");
+    uint64_t count = 0;
+    for(uint64_t index = 0; index < a.size(); index += 64) {
+        uint64_t block = std::min<uint64_t>(64,a.size()-index);
+        count += std::popcount(a.getAsInt(index,block) & b.getAsInt(index,block));
+    }
+    return count;
+}
+
+/**
+ * First index in [\p begin, \p end) hit by the stride whose bit is set, or \p end if there is
+ * none. Each 64-bit block is fetched once and all-zero blocks are skipped whole.
+ */
+inline uint64_t firstSetInRange(storm::storage::BitVector const& bits, uint64_t begin, uint64_t end, uint64_t stride = 1) {
+    if(stride == 1) {
+        return begin < end ? std::min(bits.getNextSetIndex(begin),end) : end;
+    }
+    uint64_t cached_block_begin = bits.size();
+    uint64_t word = 0;
+    for(uint64_t index = begin; index < end;) {
+        uint64_t block_begin = index & ~uint64_t(63);
+        if(block_begin != cached_block_begin) {
+            cached_block_begin = block_begin;
+            uint64_t block = std::min<uint64_t>(64,bits.size()-block_begin);
+            word = bits.getAsInt(block_begin,block) << (64-block);
+        }
+        if(word == 0) {
+            // whole block clear: jump to the first stride hit past it
+            index += (block_begin+64-index + stride-1)/stride*stride;
+            continue;
+        }
+        if(word & (uint64_t(1) << (63-(index-block_begin)))) {
+            return index;
+        }
+        index += stride;
+    }
+    return end;
+}
+
+/** Whether some bit in [\p begin, \p end) is set, scanning whole blocks at a time. */
+inline bool anyInRange(storm::storage::BitVector const& bits, uint64_t begin, uint64_t end) {
+    return firstSetInRange(bits,begin,end) < end;
+}
+
+/** Whether every bit in [\p begin, \p end) is set, scanning whole blocks at a time. */
+inline bool allInRange(storm::storage::BitVector const& bits, uint64_t begin, uint64_t end) {
+    return begin >= end or bits.getNextUnsetIndex(begin) >= end;
+}
+
+/** Set the bits at the given indices. */
+inline void scatterSet(storm::storage::BitVector& bits, uint64_t const* begin, uint64_t const* end) {
+    for(uint64_t const* it = begin; it != end; ++it) {
+        bits.set(*it,true);
+    }
+}
+
+/** Set the bits at the given indices. */
+inline void scatterSet(storm::storage::BitVector& bits, std::vector<uint64_t> const& indices) {
+    scatterSet(bits,indices.data(),indices.data()+indices.size());
+}
+
+/**
+ * The bits of \p source at the set positions of \p mask, packed to the front in mask order;
+ * the result has one bit per set bit of the mask. Only the set positions are visited.
+ */
+inline storm::storage::BitVector compress(storm::storage::BitVector const& source, storm::storage::BitVector const& mask) {
+    STORM_LOG_ASSERT(source.size() == mask.size(), "mask sizes differ");
+    storm::storage::BitVector packed(mask.getNumberOfSetBits(),false);
+    uint64_t position = 0;
+    for(uint64_t index: mask) {
+        if(source.get(index)) {
+            packed.set(position,true);
+        }
+        position++;
+    }
+    return packed;
+}
+
+}
@@ -0,0 +1,42 @@
+#include "BitVectorPool.h"
+
+namespace synthesis {
+
+storm::storage::BitVector BitVectorPool::acquire(uint64_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++num_acquired;
+    auto bucket = pool.find(size);
+    if(bucket == pool.end() or bucket->second.empty()) {
+        return storm::storage::BitVector(size,false);
+    }
+    storm::storage::BitVector vector = std::move(bucket->second.back());
+    bucket->second.pop_back();
+    vector.clear();
+    return vector;
+}
+
+void BitVectorPool::release(storm::storage::BitVector&& vector) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pool[vector.size()].push_back(std::move(vector));
+}
+
+uint64_t BitVectorPool::numPooled() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t total = 0;
+    for(auto const& [size,vectors]: pool) {
+        total += vectors.size();
+    }
+    return total;
+}
+
+uint64_t BitVectorPool::numAcquired() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return num_acquired;
+}
+
+BitVectorPool& bitVectorPool() {
+    static BitVectorPool pool;
+    return pool;
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <storm/storage/BitVector.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Pool of full-length choice and state masks. On large quotients a mask runs to megabytes and
+ * the hot loops churn through hundreds per second, so instead of hitting the allocator each
+ * time, callers lease a cleared vector of the required size and return it once done. Vectors
+ * are pooled per size; a released vector of a size nobody asks for again just sits in the pool
+ * until process exit.
+ */
+class BitVectorPool {
+public:
+
+    /** Lease a cleared vector of the given size. */
+    storm::storage::BitVector acquire(uint64_t size);
+    /** Return a leased vector to the pool. */
+    void release(storm::storage::BitVector&& vector);
+
+    /** Number of vectors currently waiting in the pool. */
+    uint64_t numPooled() const;
+    /** Number of vectors leased over the lifetime of the pool. */
+    uint64_t numAcquired() const;
+
+protected:
+
+    mutable std::mutex mutex;
+    /** Released vectors, grouped by size. */
+    std::map<uint64_t,std::vector<storm::storage::BitVector>> pool;
+    /** Lifetime acquisition counter. */
+    uint64_t num_acquired = 0;
+};
+
+/** The process-wide mask pool. */
+BitVectorPool& bitVectorPool();
+
+}
@@ -0,0 +1,41 @@
+#include "CancellationToken.h"
+
+namespace synthesis {
+
+void CancellationToken::cancel() {
+    flag.store(true, std::memory_order_relaxed);
+}
+
+void CancellationToken::setDeadline(double seconds) {
+    deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((int64_t)(seconds*1e6));
+    deadline_set.store(true, std::memory_order_relaxed);
+}
+
+void CancellationToken::clearDeadline() {
+    deadline_set.store(false, std::memory_order_relaxed);
+}
+
+void CancellationToken::reset() {
+    flag.store(false, std::memory_order_relaxed);
+    deadline_set.store(false, std::memory_order_relaxed);
+}
+
+bool CancellationToken::isCancelled() const {
+    if(flag.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    return deadline_set.load(std::memory_order_relaxed) and std::chrono::steady_clock::now() >= deadline;
+}
+
+void CancellationToken::setProgressCallback(std::function<void(uint64_t,double)> callback, uint64_t stride) {
+    progress_callback = std::move(callback);
+    progress_stride = stride > 0 ? stride : 1;
+}
+
+void CancellationToken::reportProgress(uint64_t iteration, double bound) const {
+    if(progress_callback and iteration % progress_stride == 0) {
+        progress_callback(iteration,bound);
+    }
+}
+
+}
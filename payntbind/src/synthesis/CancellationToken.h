@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace synthesis {
+
+/**
+ * Cooperative cancellation for long-running native calls. The orchestrator hands the same
+ * token to a native entry point and keeps a reference; the entry point polls the token at
+ * iteration granularity and, when the flag is raised or the deadline has passed, stops at
+ * the next boundary and returns whatever partial result it has - the caller learns about
+ * the interruption by querying the token. A progress callback can be attached to observe
+ * the computation (iterations done, current bound) every \p stride iterations; note that
+ * the callback runs on the thread of the computation.
+ */
+class CancellationToken {
+public:
+
+    /** Raise the cancellation flag. */
+    void cancel();
+    /** Cancel automatically once the given number of seconds has elapsed from now. */
+    void setDeadline(double seconds);
+    /** Remove the deadline; an already raised flag stays raised. */
+    void clearDeadline();
+    /** Lower the flag and remove the deadline so the token can guard another call. */
+    void reset();
+
+    /** Whether the flag is raised or the deadline has passed. */
+    bool isCancelled() const;
+
+    /**
+     * Attach a progress callback, replacing any previous one.
+     * @param callback invoked with (iterations done, current bound)
+     * @param stride number of iterations between invocations
+     */
+    void setProgressCallback(std::function<void(uint64_t,double)> callback, uint64_t stride = 1);
+    /** Invoke the progress callback if one is attached and \p iteration falls on the stride. */
+    void reportProgress(uint64_t iteration, double bound) const;
+
+private:
+
+    std::atomic<bool> flag{false};
+    std::atomic<bool> deadline_set{false};
+    std::chrono::steady_clock::time_point deadline;
+    std::function<void(uint64_t,double)> progress_callback;
+    uint64_t progress_stride = 1;
+};
+
+}
@@ -0,0 +1,120 @@
+#include "Trace.h"
+
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace synthesis {
+namespace trace {
+
+namespace {
+
+/** Registry of the buffers of all threads. Buffers outlive their threads so that the
+ * report can still account for work done on joined workers. */
+std::mutex registry_mutex;
+std::vector<ThreadBuffer*>& registry() {
+    static std::vector<ThreadBuffer*> buffers;
+    return buffers;
+}
+
+}
+
+PhaseStats* ThreadBuffer::slot(char const* name) {
+    uint64_t known = num_phases.load(std::memory_order_relaxed);
+    for(uint64_t index = 0; index < known; ++index) {
+        // phase names are string literals, so pointer comparison handles the common case
+        if(phases[index].name == name or std::strcmp(phases[index].name,name) == 0) {
+            return &phases[index];
+        }
+    }
+    if(known == CAPACITY) {
+        return nullptr;
+    }
+    phases[known].name = name;
+    num_phases.store(known+1, std::memory_order_release);
+    return &phases[known];
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = []() {
+        auto* fresh = new ThreadBuffer();
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry().push_back(fresh);
+        return fresh;
+    }();
+    return *buffer;
+}
+
+ScopedTimer::ScopedTimer(char const* name)
+    : stats(threadBuffer().slot(name)), start(std::chrono::steady_clock::now()) {}
+
+ScopedTimer::~ScopedTimer() {
+    if(stats == nullptr) {
+        return;
+    }
+    uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now()-start
+    ).count();
+    stats->count.fetch_add(1, std::memory_order_relaxed);
+    stats->total_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+    uint64_t known_max = stats->max_ns.load(std::memory_order_relaxed);
+    while(elapsed_ns > known_max and not stats->max_ns.compare_exchange_weak(known_max, elapsed_ns, std::memory_order_relaxed)) {
+    }
+}
+
+std::string report() {
+    // aggregate the per-thread counters by phase name
+    std::vector<std::string> names;
+    std::vector<uint64_t> counts, totals, maxima;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for(auto* buffer: registry()) {
+            uint64_t known = buffer->num_phases.load(std::memory_order_acquire);
+            for(uint64_t index = 0; index < known; ++index) {
+                auto const& stats = buffer->phases[index];
+                uint64_t position = 0;
+                while(position < names.size() and names[position] != stats.name) {
+                    ++position;
+                }
+                if(position == names.size()) {
+                    names.push_back(stats.name);
+                    counts.push_back(0);
+                    totals.push_back(0);
+                    maxima.push_back(0);
+                }
+                counts[position] += stats.count.load(std::memory_order_relaxed);
+                totals[position] += stats.total_ns.load(std::memory_order_relaxed);
+                maxima[position] = std::max(maxima[position], stats.max_ns.load(std::memory_order_relaxed));
+            }
+        }
+    }
+    std::ostringstream json;
+    json << "{";
+    for(uint64_t index = 0; index < names.size(); ++index) {
+        if(index > 0) {
+            json << ",";
+        }
+        json << "\"" << names[index] << "\":{"
+            << "\"count\":" << counts[index]
+            << ",\"total_ns\":" << totals[index]
+            << ",\"max_ns\":" << maxima[index] << "}";
+    }
+    json << "}";
+    return json.str();
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for(auto* buffer: registry()) {
+        uint64_t known = buffer->num_phases.load(std::memory_order_acquire);
+        for(uint64_t index = 0; index < known; ++index) {
+            buffer->phases[index].count.store(0, std::memory_order_relaxed);
+            buffer->phases[index].total_ns.store(0, std::memory_order_relaxed);
+            buffer->phases[index].max_ns.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+}
+}
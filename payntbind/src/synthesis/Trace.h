@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace synthesis {
+namespace trace {
+
+/** Nanosecond counters of one phase: number of entries, accumulated and maximum duration. */
+struct PhaseStats {
+    char const* name = nullptr;
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+};
+
+/**
+ * Fixed-size per-thread phase table. Each thread writes only to its own table, so recording
+ * costs two relaxed atomic additions; the report reads the counters of every registered
+ * thread without stopping them.
+ */
+struct ThreadBuffer {
+    static const uint64_t CAPACITY = 64;
+    PhaseStats phases[CAPACITY];
+    std::atomic<uint64_t> num_phases{0};
+
+    /** Get (or append) the slot of the given phase; phases beyond the capacity are dropped. */
+    PhaseStats* slot(char const* name);
+};
+
+/** The calling thread's buffer, registered globally on first use. */
+ThreadBuffer& threadBuffer();
+
+/** Records the wall time spent between construction and destruction into the phase slot. */
+class ScopedTimer {
+public:
+    ScopedTimer(char const* name);
+    ~ScopedTimer();
+private:
+    PhaseStats* stats;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * Aggregate the counters of all threads into a JSON object mapping each phase to its
+ * count, total_ns and max_ns.
+ */
+std::string report();
+
+/** Zero the counters of all threads. */
+void reset();
+
+}
+}
+
+/**
+ * Scoped hot-path timer; the phase name must be a string literal. Tracing is on by default
+ * so that per-phase breakdowns are available from production runs; compile with
+ * -DPAYNT_DISABLE_TRACE to remove the probes entirely.
+ */
+#ifndef PAYNT_DISABLE_TRACE
+#define PAYNT_TRACE_SCOPE(phase) ::synthesis::trace::ScopedTimer paynt_trace_scope_timer(phase)
+#else
+#define PAYNT_TRACE_SCOPE(phase)
+#endif
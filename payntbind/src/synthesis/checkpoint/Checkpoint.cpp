@@ -0,0 +1,290 @@
+#include "Checkpoint.h"
+
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/exceptions/WrongFormatException.h>
+#include <storm/utility/macros.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace synthesis {
+
+namespace {
+
+const uint64_t CHECKPOINT_MAGIC = 0x50434845434b5054; // "PCHECKPT"
+const uint64_t CHECKPOINT_VERSION = 1;
+
+/** In-memory serializer for one section blob. */
+struct BlobWriter {
+    std::vector<char> data;
+
+    void writeUint(uint64_t value) {
+        char const* bytes = reinterpret_cast<char const*>(&value);
+        data.insert(data.end(),bytes,bytes+sizeof(value));
+    }
+
+    void writeDouble(double value) {
+        char const* bytes = reinterpret_cast<char const*>(&value);
+        data.insert(data.end(),bytes,bytes+sizeof(value));
+    }
+
+    void writeUintVector(std::vector<uint64_t> const& values) {
+        writeUint(values.size());
+        char const* bytes = reinterpret_cast<char const*>(values.data());
+        data.insert(data.end(),bytes,bytes+values.size()*sizeof(uint64_t));
+    }
+};
+
+/** Bounds-checked deserializer for one section blob. */
+struct BlobReader {
+    char const* data;
+    uint64_t size;
+    uint64_t position = 0;
+
+    BlobReader(std::vector<char> const& blob) : data(blob.data()), size(blob.size()) {}
+
+    void readBytes(void* destination, uint64_t count) {
+        STORM_LOG_THROW(position+count <= size, storm::exceptions::WrongFormatException, "checkpoint section is truncated");
+        std::memcpy(destination,data+position,count);
+        position += count;
+    }
+
+    uint64_t readUint() {
+        uint64_t value;
+        readBytes(&value,sizeof(value));
+        return value;
+    }
+
+    double readDouble() {
+        double value;
+        readBytes(&value,sizeof(value));
+        return value;
+    }
+
+    std::vector<uint64_t> readUintVector() {
+        uint64_t count = readUint();
+        STORM_LOG_THROW(position+count*sizeof(uint64_t) <= size, storm::exceptions::WrongFormatException, "checkpoint section is truncated");
+        std::vector<uint64_t> values(count);
+        readBytes(values.data(),count*sizeof(uint64_t));
+        return values;
+    }
+};
+
+uint64_t contentHash(std::vector<char> const& data) {
+    // FNV-1a, same scheme the coloring snapshot uses for its quotient hash
+    uint64_t hash = 0xcbf29ce484222325;
+    for(char byte: data) {
+        hash = (hash ^ static_cast<unsigned char>(byte)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+void writeFamilyBlob(BlobWriter& out, Family const& family) {
+    out.writeUint(family.numHoles());
+    for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+        out.writeUint(family.holeNumOptionsTotal(hole));
+        out.writeUintVector(family.holeOptions(hole));
+    }
+}
+
+Family readFamilyBlob(BlobReader& in) {
+    Family family;
+    uint64_t num_holes = in.readUint();
+    for(uint64_t hole = 0; hole < num_holes; ++hole) {
+        family.addHole(in.readUint());
+        family.holeSetOptions(hole,in.readUintVector());
+    }
+    return family;
+}
+
+}
+
+Checkpoint::Checkpoint(std::string const& path) : path(path) {
+    std::ifstream in(path, std::ios::binary);
+    if(not in.good()) {
+        std::ofstream out(path, std::ios::binary);
+        STORM_LOG_THROW(out.good(), storm::exceptions::InvalidArgumentException, "cannot open checkpoint " << path << " for writing");
+        uint64_t header[2] = {CHECKPOINT_MAGIC,CHECKPOINT_VERSION};
+        out.write(reinterpret_cast<char const*>(header),sizeof(header));
+        return;
+    }
+    uint64_t header[2];
+    in.read(reinterpret_cast<char*>(header),sizeof(header));
+    STORM_LOG_THROW(
+        in.good() and header[0] == CHECKPOINT_MAGIC and header[1] == CHECKPOINT_VERSION,
+        storm::exceptions::WrongFormatException, path << " is not a compatible checkpoint"
+    );
+    // replay the log; a record truncated by a crash ends the replay, keeping the state
+    // as of the last complete append
+    while(true) {
+        uint64_t name_size;
+        in.read(reinterpret_cast<char*>(&name_size),sizeof(name_size));
+        if(not in.good()) {
+            break;
+        }
+        std::string section(name_size,'\0');
+        in.read(section.data(),name_size);
+        uint64_t data_size;
+        in.read(reinterpret_cast<char*>(&data_size),sizeof(data_size));
+        if(not in.good()) {
+            break;
+        }
+        std::vector<char> data(data_size);
+        in.read(data.data(),data_size);
+        if(not in.good()) {
+            break;
+        }
+        section_hash[section] = contentHash(data);
+        sections[section] = std::move(data);
+    }
+}
+
+void Checkpoint::appendRecord(std::string const& section, std::vector<char> const& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    STORM_LOG_THROW(out.good(), storm::exceptions::InvalidArgumentException, "cannot open checkpoint " << path << " for appending");
+    uint64_t name_size = section.size();
+    out.write(reinterpret_cast<char const*>(&name_size),sizeof(name_size));
+    out.write(section.data(),name_size);
+    uint64_t data_size = data.size();
+    out.write(reinterpret_cast<char const*>(&data_size),sizeof(data_size));
+    out.write(data.data(),data_size);
+}
+
+void Checkpoint::store(std::string const& section, std::vector<char>&& data) {
+    uint64_t hash = contentHash(data);
+    auto entry = section_hash.find(section);
+    if(entry != section_hash.end() and entry->second == hash and sections[section] == data) {
+        return;
+    }
+    appendRecord(section,data);
+    section_hash[section] = hash;
+    sections[section] = std::move(data);
+}
+
+std::vector<char> const& Checkpoint::sectionData(std::string const& section) const {
+    auto entry = sections.find(section);
+    STORM_LOG_THROW(entry != sections.end(), storm::exceptions::InvalidArgumentException, "checkpoint has no section " << section);
+    return entry->second;
+}
+
+void Checkpoint::storeFamily(std::string const& section, Family const& family) {
+    BlobWriter out;
+    writeFamilyBlob(out,family);
+    store(section,std::move(out.data));
+}
+
+Family Checkpoint::loadFamily(std::string const& section) const {
+    BlobReader in(sectionData(section));
+    return readFamilyBlob(in);
+}
+
+void Checkpoint::storeFamilyQueue(std::string const& section, FamilyQueue const& queue) {
+    BlobWriter out;
+    out.writeUint(queue.isMaximizing() ? 1 : 0);
+    auto entries = queue.enqueuedEntries();
+    out.writeUint(entries.size());
+    for(auto const& [bound,handle]: entries) {
+        out.writeDouble(bound);
+        writeFamilyBlob(out,queue.family(handle));
+    }
+    store(section,std::move(out.data));
+}
+
+FamilyQueue Checkpoint::loadFamilyQueue(std::string const& section) const {
+    BlobReader in(sectionData(section));
+    FamilyQueue queue(in.readUint() == 1);
+    uint64_t num_entries = in.readUint();
+    for(uint64_t entry = 0; entry < num_entries; ++entry) {
+        double bound = in.readDouble();
+        queue.push(readFamilyBlob(in),bound);
+    }
+    return queue;
+}
+
+void Checkpoint::storeSchedulerRegistry(std::string const& section, SchedulerRegistry const& registry) {
+    BlobWriter out;
+    out.writeUint(registry.numPolicies());
+    for(uint64_t handle = 0; handle < registry.numPolicies(); ++handle) {
+        out.writeUintVector(registry.getPolicy(handle));
+    }
+    store(section,std::move(out.data));
+}
+
+SchedulerRegistry Checkpoint::loadSchedulerRegistry(std::string const& section) const {
+    BlobReader in(sectionData(section));
+    SchedulerRegistry registry;
+    uint64_t num_policies = in.readUint();
+    for(uint64_t handle = 0; handle < num_policies; ++handle) {
+        // re-inserting distinct policies in handle order reproduces the original handles
+        uint64_t restored_handle = registry.insertPolicy(in.readUintVector());
+        STORM_LOG_THROW(restored_handle == handle, storm::exceptions::WrongFormatException, "checkpoint section " << section << " holds duplicate policies");
+    }
+    return registry;
+}
+
+void Checkpoint::storeWords(std::string const& section, std::vector<uint64_t> const& words) {
+    BlobWriter out;
+    out.writeUintVector(words);
+    store(section,std::move(out.data));
+}
+
+std::vector<uint64_t> Checkpoint::loadWords(std::string const& section) const {
+    BlobReader in(sectionData(section));
+    return in.readUintVector();
+}
+
+void Checkpoint::storeValues(std::string const& section, std::vector<double> const& values) {
+    BlobWriter out;
+    out.writeUint(values.size());
+    for(double value: values) {
+        out.writeDouble(value);
+    }
+    store(section,std::move(out.data));
+}
+
+std::vector<double> Checkpoint::loadValues(std::string const& section) const {
+    BlobReader in(sectionData(section));
+    uint64_t count = in.readUint();
+    std::vector<double> values(count);
+    for(uint64_t index = 0; index < count; ++index) {
+        values[index] = in.readDouble();
+    }
+    return values;
+}
+
+bool Checkpoint::hasSection(std::string const& section) const {
+    return sections.find(section) != sections.end();
+}
+
+std::vector<std::string> Checkpoint::sectionNames() const {
+    std::vector<std::string> names;
+    for(auto const& [section,data]: sections) {
+        names.push_back(section);
+    }
+    return names;
+}
+
+void Checkpoint::compact() {
+    std::string temporary = path + ".compact";
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        STORM_LOG_THROW(out.good(), storm::exceptions::InvalidArgumentException, "cannot open " << temporary << " for writing");
+        uint64_t header[2] = {CHECKPOINT_MAGIC,CHECKPOINT_VERSION};
+        out.write(reinterpret_cast<char const*>(header),sizeof(header));
+    }
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::app);
+        for(auto const& [section,data]: sections) {
+            uint64_t name_size = section.size();
+            out.write(reinterpret_cast<char const*>(&name_size),sizeof(name_size));
+            out.write(section.data(),name_size);
+            uint64_t data_size = data.size();
+            out.write(reinterpret_cast<char const*>(&data_size),sizeof(data_size));
+            out.write(data.data(),data_size);
+        }
+    }
+    STORM_LOG_THROW(std::rename(temporary.c_str(),path.c_str()) == 0, storm::exceptions::InvalidArgumentException, "cannot replace checkpoint " << path);
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "src/synthesis/quotient/Family.h"
+#include "src/synthesis/quotient/FamilyQueue.h"
+#include "src/synthesis/verification/SchedulerRegistry.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Checkpoint of the native synthesis state, so that an interrupted run restarts from its last
+ * save instead of from zero. The file is a log of named sections: storing an object appends a
+ * fresh copy of its section only when its content changed since the last store, and restoring
+ * replays the log keeping the latest copy of each section. A crash mid-append loses at most
+ * the section being written; everything before the truncation point restores normally.
+ * Colorings keep their dedicated snapshot format (\ref Coloring::saveSnapshot) and are
+ * referenced from a checkpoint by path.
+ */
+class Checkpoint {
+public:
+
+    /** Open the checkpoint at \p path, replaying its sections if the file already exists. */
+    Checkpoint(std::string const& path);
+
+    /** Store a family under the given section name. */
+    void storeFamily(std::string const& section, Family const& family);
+    Family loadFamily(std::string const& section) const;
+
+    /** Store the enqueued families and bounds of a queue. Handles are not preserved. */
+    void storeFamilyQueue(std::string const& section, FamilyQueue const& queue);
+    FamilyQueue loadFamilyQueue(std::string const& section) const;
+
+    /** Store a policy registry. Restoring preserves the policy handles. */
+    void storeSchedulerRegistry(std::string const& section, SchedulerRegistry const& registry);
+    SchedulerRegistry loadSchedulerRegistry(std::string const& section) const;
+
+    /** Store a plain word vector, e.g. iteration counters or hole orderings. */
+    void storeWords(std::string const& section, std::vector<uint64_t> const& words);
+    std::vector<uint64_t> loadWords(std::string const& section) const;
+
+    /** Store a plain value vector, e.g. the current optimum. */
+    void storeValues(std::string const& section, std::vector<double> const& values);
+    std::vector<double> loadValues(std::string const& section) const;
+
+    bool hasSection(std::string const& section) const;
+    std::vector<std::string> sectionNames() const;
+
+    /** Rewrite the log with only the latest copy of each section, dropping superseded ones. */
+    void compact();
+
+protected:
+
+    /** Store raw section data, appending to the log only if the content changed. */
+    void store(std::string const& section, std::vector<char>&& data);
+    /** The current data of a section; throws if the section is absent. */
+    std::vector<char> const& sectionData(std::string const& section) const;
+    /** Append one section record to the log. */
+    void appendRecord(std::string const& section, std::vector<char> const& data);
+
+    /** Path of the checkpoint file. */
+    std::string path;
+    /** Latest data of each section. */
+    std::map<std::string,std::vector<char>> sections;
+    /** Content hash of each section as of its last append, to skip unchanged stores. */
+    std::map<std::string,uint64_t> section_hash;
+};
+
+}
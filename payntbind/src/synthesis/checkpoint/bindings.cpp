@@ -0,0 +1,23 @@
+#include "../synthesis.h"
+
+#include "Checkpoint.h"
+
+void bindings_checkpoint(py::module& m) {
+
+    py::class_<synthesis::Checkpoint>(m, "Checkpoint", "Incremental checkpoint of the native synthesis state.")
+        .def(py::init<std::string const&>(), py::arg("path"), "open the checkpoint, replaying its sections if the file exists")
+        .def("storeFamily", &synthesis::Checkpoint::storeFamily, py::arg("section"), py::arg("family"), py::call_guard<py::gil_scoped_release>())
+        .def("loadFamily", &synthesis::Checkpoint::loadFamily, py::arg("section"))
+        .def("storeFamilyQueue", &synthesis::Checkpoint::storeFamilyQueue, py::arg("section"), py::arg("queue"), py::call_guard<py::gil_scoped_release>())
+        .def("loadFamilyQueue", &synthesis::Checkpoint::loadFamilyQueue, py::arg("section"))
+        .def("storeSchedulerRegistry", &synthesis::Checkpoint::storeSchedulerRegistry, py::arg("section"), py::arg("registry"), py::call_guard<py::gil_scoped_release>())
+        .def("loadSchedulerRegistry", &synthesis::Checkpoint::loadSchedulerRegistry, py::arg("section"))
+        .def("storeWords", &synthesis::Checkpoint::storeWords, py::arg("section"), py::arg("words"))
+        .def("loadWords", &synthesis::Checkpoint::loadWords, py::arg("section"))
+        .def("storeValues", &synthesis::Checkpoint::storeValues, py::arg("section"), py::arg("values"))
+        .def("loadValues", &synthesis::Checkpoint::loadValues, py::arg("section"))
+        .def("hasSection", &synthesis::Checkpoint::hasSection, py::arg("section"))
+        .def("sectionNames", &synthesis::Checkpoint::sectionNames)
+        .def("compact", &synthesis::Checkpoint::compact, py::call_guard<py::gil_scoped_release>())
+        ;
+}
@@ -1,5 +1,8 @@
 #include "Counterexample.h"
 
+#include "src/synthesis/BitVectorOps.h"
+#include "src/synthesis/Trace.h"
+
 #include <storm/storage/BitVector.h>
 #include <storm/exceptions/InvalidArgumentException.h>
 #include <storm/exceptions/NotImplementedException.h>
@@ -45,7 +48,22 @@ namespace synthesis {
         uint64_t hole_count,
         std::vector<std::set<uint64_t>> const& mdp_holes,
         std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulae
-        ) : quotient_mdp(quotient_mdp), hole_count(hole_count), mdp_holes(mdp_holes) {
+        ) : quotient_mdp(quotient_mdp), hole_count(hole_count) {
+
+        // flatten the per-state hole sets into one arena
+        uint64_t total_holes = 0;
+        for(auto const& state_holes: mdp_holes) {
+            total_holes += state_holes.size();
+        }
+        this->mdp_holes_offset.reserve(mdp_holes.size()+1);
+        this->mdp_holes_flat.reserve(total_holes);
+        this->mdp_holes_offset.push_back(0);
+        for(auto const& state_holes: mdp_holes) {
+            for(uint64_t hole: state_holes) {
+                this->mdp_holes_flat.push_back(hole);
+            }
+            this->mdp_holes_offset.push_back(this->mdp_holes_flat.size());
+        }
 
         // create label formulae for our own labels
         std::shared_ptr<storm::logic::Formula const> const& target_label_formula = std::make_shared<storm::logic::AtomicLabelFormula>(this->target_label);
@@ -109,6 +127,34 @@ namespace synthesis {
             }
             this->formula_modified.push_back(modified_formula);
         }
+
+        // conflict reuse bookkeeping, one slot per formula
+        uint64_t num_formulae = this->formula_safety.size();
+        this->reuse_conflict.resize(num_formulae);
+        this->reuse_conflict_valid.resize(num_formulae, false);
+        this->reuse_conflict_bound.resize(num_formulae);
+        this->reuse_dirty_holes.resize(num_formulae, storm::storage::BitVector(hole_count,false));
+    }
+
+    template <typename ValueType, typename StateType>
+    uint64_t CounterexampleGenerator<ValueType,StateType>::numDtmcStates() const {
+        return this->use_quotient_matrix ? this->quotient_mdp.getNumberOfStates() : this->dtmc->getNumberOfStates();
+    }
+
+    template <typename ValueType, typename StateType>
+    StateType CounterexampleGenerator<ValueType,StateType>::dtmcInitialState() const {
+        if(this->use_quotient_matrix) {
+            return *(this->quotient_mdp.getInitialStates().begin());
+        }
+        return *(this->dtmc->getInitialStates().begin());
+    }
+
+    template <typename ValueType, typename StateType>
+    typename storm::storage::SparseMatrix<ValueType>::const_rows CounterexampleGenerator<ValueType,StateType>::stateRow(StateType state) const {
+        if(this->use_quotient_matrix) {
+            return this->quotient_mdp.getTransitionMatrix().getRow(this->state_to_choice[state]);
+        }
+        return this->dtmc->getTransitionMatrix().getRow(state);
     }
 
     template <typename ValueType, typename StateType>
@@ -116,27 +162,86 @@ namespace synthesis {
         storm::models::sparse::Dtmc<ValueType> const& dtmc,
         std::vector<uint64_t> const& state_map
         ) {
-        
+        this->dtmc = std::make_shared<storm::models::sparse::Dtmc<ValueType>>(dtmc);
+        this->use_quotient_matrix = false;
+        this->state_map = state_map;
+        this->computeWaves();
+    }
+
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::prepareDtmcDirect(storm::storage::BitVector const& choice_mask) {
+        this->dtmc = NULL;
+        this->use_quotient_matrix = true;
+        uint64_t num_states = this->quotient_mdp.getNumberOfStates();
+        // select one choice per state: the first enabled one, defaulting to the first choice
+        auto const& row_group_indices = this->quotient_mdp.getTransitionMatrix().getRowGroupIndices();
+        this->state_to_choice.resize(num_states);
+        for(StateType state = 0; state < num_states; state++) {
+            uint64_t selected = row_group_indices[state];
+            for(uint64_t choice = row_group_indices[state]; choice < row_group_indices[state+1]; choice++) {
+                if(choice_mask[choice]) {
+                    selected = choice;
+                    break;
+                }
+            }
+            this->state_to_choice[state] = selected;
+        }
+        // state indices coincide with quotient state indices
+        this->state_map.resize(num_states);
+        for(StateType state = 0; state < num_states; state++) {
+            this->state_map[state] = state;
+        }
+        this->computeWaves();
+    }
+
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::computeWaves() {
+
         // Clear up previous DTMC metadata
         this->hole_wave.clear();
         this->wave_states.clear();
 
         // Get DTMC info
-        this->dtmc = std::make_shared<storm::models::sparse::Dtmc<ValueType>>(dtmc);
-        this->state_map = state_map;
-        uint64_t dtmc_states = this->dtmc->getNumberOfStates();
-        StateType initial_state = *(this->dtmc->getInitialStates().begin());
-        storm::storage::SparseMatrix<ValueType> const& transition_matrix = this->dtmc->getTransitionMatrix();
+        uint64_t dtmc_states = this->numDtmcStates();
+        StateType initial_state = this->dtmcInitialState();
+
+        // Flatten the transition structure (columns per row, rows separated by a sentinel): the
+        // wave order depends only on this structure and on the state map, so if both coincide with
+        // the previously prepared DTMC, the previously computed wave order is reused as is
+        std::vector<StateType> row_columns;
+        std::vector<ValueType> row_values;
+        for(StateType state = 0; state < dtmc_states; state++) {
+            for(auto entry: this->stateRow(state)) {
+                row_columns.push_back(entry.getColumn());
+                row_values.push_back(entry.getValue());
+            }
+            row_columns.push_back(dtmc_states);
+            row_values.push_back(ValueType(0));
+        }
+        if(this->conflict_reuse) {
+            this->updateConflictReuse(row_columns, row_values);
+        }
+        if(this->state_map == this->cached_state_map && row_columns == this->cached_row_columns) {
+            this->hole_wave = this->cached_hole_wave;
+            this->wave_states = this->cached_wave_states;
+            this->cached_row_values = std::move(row_values);
+            return;
+        }
 
         // Mark all holes as unregistered
         this->hole_wave.resize(this->hole_count,0);
-        
-        // Associate states of a DTMC with relevant holes and store their count
-        std::vector<std::set<uint64_t>> dtmc_holes(dtmc_states);
+
+        // Associate states of a DTMC with relevant holes and store their count; for each hole,
+        // remember the states that contain it so that hole registration can decrement the counts
+        // of affected states only instead of recounting the whole state space every wave
         std::vector<uint64_t> unregistered_holes_count(dtmc_states, 0);
+        std::vector<std::vector<StateType>> hole_to_dtmc_states(this->hole_count);
         for(StateType state = 0; state < dtmc_states; state++) {
-            dtmc_holes[state] = this->mdp_holes[state_map[state]];
-            unregistered_holes_count[state] = dtmc_holes[state].size();
+            uint64_t mdp_state = state_map[state];
+            unregistered_holes_count[state] = this->mdp_holes_offset[mdp_state+1] - this->mdp_holes_offset[mdp_state];
+            for(uint64_t index = this->mdp_holes_offset[mdp_state]; index < this->mdp_holes_offset[mdp_state+1]; index++) {
+                hole_to_dtmc_states[this->mdp_holes_flat[index]].push_back(state);
+            }
         }
 
         // Prepare to explore
@@ -174,7 +279,7 @@ namespace synthesis {
                 this->wave_states.back().push_back(state);
 
                 // Reach successors
-                for(auto entry: transition_matrix.getRow(state)) {
+                for(auto entry: this->stateRow(state)) {
                     StateType successor = entry.getColumn();
                     if(reachable_flag[successor]) {
                         // already reached
@@ -208,24 +313,20 @@ namespace synthesis {
             this->wave_states.push_back(std::vector<StateType>());
             blocking_candidate_set = false;
             
-            // Register all unregistered holes of this blocking state
-            for(uint64_t hole: dtmc_holes[blocking_candidate]) {
+            // Register all unregistered holes of this blocking state and decrement the counts
+            // of the states containing them
+            uint64_t blocking_mdp_state = state_map[blocking_candidate];
+            for(uint64_t index = this->mdp_holes_offset[blocking_mdp_state]; index < this->mdp_holes_offset[blocking_mdp_state+1]; index++) {
+                uint64_t hole = this->mdp_holes_flat[index];
                 if(this->hole_wave[hole] == 0) {
                     hole_wave[hole] = current_wave;
                     // std::cout << "[storm] hole " << hole << " expanded in wave " << current_wave << std::endl;
-                }
-            }
-
-            // Recompute number of unregistered holes in each state
-            for(StateType state = 0; state < dtmc_states; state++) {
-                unregistered_holes_count[state] = 0;
-                for(uint64_t hole: dtmc_holes[state]) {
-                    if(this->hole_wave[hole] == 0) {
-                        unregistered_holes_count[state]++;
+                    for(StateType state: hole_to_dtmc_states[hole]) {
+                        unregistered_holes_count[state]--;
                     }
                 }
             }
-            
+
             // Unblock the states from the blocking horizon
             std::vector<StateType> old_blocking_horizon;
             old_blocking_horizon.swap(state_horizon_blocking);
@@ -244,21 +345,141 @@ namespace synthesis {
                 }
             }
         }
+
+        // Remember the key and the wave order for the next DTMC
+        this->cached_state_map = state_map;
+        this->cached_row_columns = std::move(row_columns);
+        this->cached_row_values = std::move(row_values);
+        this->cached_hole_wave = this->hole_wave;
+        this->cached_wave_states = this->wave_states;
+    }
+
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::updateConflictReuse(
+        std::vector<StateType> const& row_columns,
+        std::vector<ValueType> const& row_values
+        ) {
+        if(this->state_map != this->cached_state_map || this->cached_row_columns.empty()) {
+            // incomparable DTMCs: drop all cached conflicts
+            for(uint64_t formula_index = 0; formula_index < this->reuse_conflict_valid.size(); formula_index++) {
+                this->reuse_conflict_valid[formula_index] = false;
+            }
+            return;
+        }
+        // walk both flattened transition structures state by state (each segmented by its own
+        // sentinels) and collect the holes of every state whose row differs
+        uint64_t dtmc_states = this->numDtmcStates();
+        storm::storage::BitVector changed_holes(this->hole_count, false);
+        bool any_changed = false;
+        uint64_t cursor = 0;
+        uint64_t cached_cursor = 0;
+        for(StateType state = 0; state < dtmc_states; state++) {
+            uint64_t row_begin = cursor;
+            while(row_columns[cursor] != dtmc_states) {
+                cursor++;
+            }
+            uint64_t cached_row_begin = cached_cursor;
+            while(this->cached_row_columns[cached_cursor] != dtmc_states) {
+                cached_cursor++;
+            }
+            bool changed = (cursor-row_begin) != (cached_cursor-cached_row_begin);
+            if(!changed) {
+                for(uint64_t offset = 0; offset < cursor-row_begin; offset++) {
+                    if(row_columns[row_begin+offset] != this->cached_row_columns[cached_row_begin+offset]
+                        || row_values[row_begin+offset] != this->cached_row_values[cached_row_begin+offset]) {
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+            cursor++;
+            cached_cursor++;
+            if(changed) {
+                any_changed = true;
+                uint64_t mdp_state = this->state_map[state];
+                scatterSet(changed_holes,
+                    this->mdp_holes_flat.data()+this->mdp_holes_offset[mdp_state],
+                    this->mdp_holes_flat.data()+this->mdp_holes_offset[mdp_state+1]);
+            }
+        }
+        if(any_changed) {
+            for(auto & dirty_holes: this->reuse_dirty_holes) {
+                dirty_holes |= changed_holes;
+            }
+        }
+    }
+
+    template <typename ValueType, typename StateType>
+    uint64_t CounterexampleGenerator<ValueType,StateType>::registerMdpBounds (
+        std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const> mdp_bounds,
+        std::vector<StateType> const& mdp_quotient_state_map
+        ) {
+        STORM_LOG_THROW(mdp_bounds != NULL, storm::exceptions::InvalidArgumentException, "Cannot register empty MDP bounds.");
+        uint64_t quotient_states = this->quotient_mdp.getNumberOfStates();
+        std::vector<ValueType> bounds(quotient_states);
+        std::vector<uint64_t> bounds_epoch(quotient_states, 0);
+        auto const& mdp_values = mdp_bounds->getValueVector();
+        uint64_t mdp_states = mdp_values.size();
+        for(StateType state = 0; state < mdp_states; state++) {
+            bounds[mdp_quotient_state_map[state]] = mdp_values[state];
+            bounds_epoch[mdp_quotient_state_map[state]] = 1;
+        }
+        this->registered_bounds.push_back(std::move(bounds));
+        this->registered_bounds_epoch.push_back(std::move(bounds_epoch));
+        return this->registered_bounds.size()-1;
+    }
+
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::clearRegisteredBounds() {
+        this->registered_bounds.clear();
+        this->registered_bounds_epoch.clear();
+    }
+
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::activateBounds (
+        std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const> mdp_bounds,
+        std::vector<StateType> const& mdp_quotient_state_map
+        ) {
+        if(mdp_bounds == NULL) {
+            this->active_bounds = NULL;
+            this->active_bounds_epoch = NULL;
+            return;
+        }
+        // map the bounds onto the quotient state space: the flat lookup array persists across
+        // conflicts, entries written in previous epochs are treated as absent
+        this->workspace_quotient_bounds.resize(this->quotient_mdp.getNumberOfStates());
+        this->workspace_bounds_epoch.resize(this->quotient_mdp.getNumberOfStates(), 0);
+        this->workspace_epoch++;
+        auto const& mdp_values = mdp_bounds->getValueVector();
+        uint64_t mdp_states = mdp_values.size();
+        for(StateType state = 0; state < mdp_states; state++) {
+            this->workspace_quotient_bounds[mdp_quotient_state_map[state]] = mdp_values[state];
+            this->workspace_bounds_epoch[mdp_quotient_state_map[state]] = this->workspace_epoch;
+        }
+        this->active_bounds = &this->workspace_quotient_bounds;
+        this->active_bounds_epoch = &this->workspace_bounds_epoch;
+        this->active_epoch = this->workspace_epoch;
+    }
+
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::activateRegisteredBounds (uint64_t bounds_id) {
+        STORM_LOG_THROW(bounds_id < this->registered_bounds.size(), storm::exceptions::InvalidArgumentException, "Invalid bounds id.");
+        this->active_bounds = &this->registered_bounds[bounds_id];
+        this->active_bounds_epoch = &this->registered_bounds_epoch[bounds_id];
+        this->active_epoch = 1;
     }
 
     template <typename ValueType, typename StateType>
     void CounterexampleGenerator<ValueType,StateType>::prepareSubdtmc (
         uint64_t formula_index,
-        std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const> mdp_bounds,
-        std::vector<StateType> const& mdp_quotient_state_map,
         std::vector<std::vector<std::pair<StateType,ValueType>>> & matrix_subdtmc,
         storm::models::sparse::StateLabeling & labeling_subdtmc,
         std::unordered_map<std::string,storm::models::sparse::StandardRewardModel<ValueType>> & reward_models_subdtmc
         ) {
 
         // Get DTMC info
-        StateType dtmc_states = dtmc->getNumberOfStates();
-        
+        StateType dtmc_states = this->numDtmcStates();
+
         // Introduce expanded state space
         uint64_t sink_state_false = dtmc_states;
         uint64_t sink_state_true = dtmc_states+1;
@@ -280,56 +501,45 @@ namespace synthesis {
         // Associate true sink with the target label
         labeling_subdtmc.addLabelToState(this->target_label, sink_state_true);
 
-        // Map MDP bounds onto the state space of a quotient MDP
-        bool have_bounds = mdp_bounds != NULL;
-        std::vector<ValueType> quotient_mdp_bounds;
-        if(have_bounds) {
-            auto const& mdp_values = mdp_bounds->getValueVector();
-            quotient_mdp_bounds.resize(this->quotient_mdp.getNumberOfStates());
-            uint64_t mdp_states = mdp_values.size();
-            for(StateType state = 0; state < mdp_states; state++) {
-                quotient_mdp_bounds[mdp_quotient_state_map[state]] = mdp_values[state];
-            }
-        }
-
-        
-
-        // Construct transition matrix (as well as the reward model) for the subdtmc
+        // Construct transition matrix (as well as the reward model) for the subdtmc; MDP bounds
+        // are read from the active flat lookup set up beforehand
         if(!this->formula_reward[formula_index]) {
             // Probability formula: no reward models
             double default_bound = this->formula_safety[formula_index] ? 0 : 1;
             for(StateType state = 0; state < dtmc_states; state++) {
                 StateType mdp_state = this->state_map[state];
-                std::vector<std::pair<StateType,ValueType>> r;
-                double probability = have_bounds ? quotient_mdp_bounds[mdp_state] : default_bound;
-                r.emplace_back(sink_state_false, 1-probability);
-                r.emplace_back(sink_state_true, probability);
-                matrix_subdtmc.push_back(r);
+                double probability = default_bound;
+                if(this->active_bounds != NULL && (*this->active_bounds_epoch)[mdp_state] == this->active_epoch) {
+                    probability = (*this->active_bounds)[mdp_state];
+                }
+                matrix_subdtmc[state].emplace_back(sink_state_false, 1-probability);
+                matrix_subdtmc[state].emplace_back(sink_state_true, probability);
             }
         } else {
             // Reward formula: one reward model
-            assert(dtmc->hasRewardModel(this->formula_reward_name[formula_index]));
+            assert(this->use_quotient_matrix
+                ? this->quotient_mdp.hasRewardModel(this->formula_reward_name[formula_index])
+                : dtmc->hasRewardModel(this->formula_reward_name[formula_index]));
 
             std::vector<ValueType> state_rewards_subdtmc(dtmc_states+2);
             double default_reward = 0;
             for(StateType state = 0; state < dtmc_states; state++) {
                 StateType mdp_state = this->state_map[state];
-                double reward = have_bounds ? quotient_mdp_bounds[mdp_state] : default_reward;
+                double reward = default_reward;
+                if(this->active_bounds != NULL && (*this->active_bounds_epoch)[mdp_state] == this->active_epoch) {
+                    reward = (*this->active_bounds)[mdp_state];
+                }
                 state_rewards_subdtmc[state] = reward;
 
-                std::vector<std::pair<StateType,ValueType>> r;
-                r.emplace_back(sink_state_true, 1);
-                matrix_subdtmc.push_back(r);
+                matrix_subdtmc[state].emplace_back(sink_state_true, 1);
             }
-            storm::models::sparse::StandardRewardModel<ValueType> reward_model_subdtmc(state_rewards_subdtmc);
-            reward_models_subdtmc.emplace(this->formula_reward_name[formula_index], reward_model_subdtmc);
+            storm::models::sparse::StandardRewardModel<ValueType> reward_model_subdtmc(std::move(state_rewards_subdtmc));
+            reward_models_subdtmc.emplace(this->formula_reward_name[formula_index], std::move(reward_model_subdtmc));
         }
 
         // Add self-loops to sink states
         for(StateType state = sink_state_false; state <= sink_state_true; state++) {
-            std::vector<std::pair<StateType,ValueType>> r;
-            r.emplace_back(state, 1);
-            matrix_subdtmc.push_back(r);
+            matrix_subdtmc[state].emplace_back(state, 1);
         }
     }
 
@@ -344,11 +554,10 @@ namespace synthesis {
     ) {
         
         // Get DTMC info
-        uint64_t dtmc_states = this->dtmc->getNumberOfStates();
-        storm::storage::SparseMatrix<ValueType> const& transition_matrix = this->dtmc->getTransitionMatrix();
-        StateType initial_state = *(this->dtmc->getInitialStates().begin());
-        
-        // Expand states from the new wave: 
+        uint64_t dtmc_states = this->numDtmcStates();
+        StateType initial_state = this->dtmcInitialState();
+
+        // Expand states from the new wave:
         // - expand transition probabilities
         // std::cout << "expanded " << to_expand.size() << " states in this wave " << std::endl;
         for(StateType state : to_expand) {
@@ -358,7 +567,7 @@ namespace synthesis {
             }*/
             // std::cout << std::endl;
             matrix_subdtmc[state].clear();
-            for(auto entry: transition_matrix.getRow(state)) {
+            for(auto entry: this->stateRow(state)) {
                 matrix_subdtmc[state].emplace_back(entry.getColumn(), entry.getValue());
             }
         }
@@ -366,7 +575,9 @@ namespace synthesis {
 
         if(this->formula_reward[index]) {
             // - expand state rewards
-            storm::models::sparse::StandardRewardModel<ValueType> const& reward_model_dtmc = dtmc->getRewardModel(this->formula_reward_name[index]);
+            storm::models::sparse::StandardRewardModel<ValueType> const& reward_model_dtmc = this->use_quotient_matrix
+                ? this->quotient_mdp.getRewardModel(this->formula_reward_name[index])
+                : dtmc->getRewardModel(this->formula_reward_name[index]);
             assert(reward_model_dtmc.hasStateRewards() or reward_model_dtmc.hasStateActionRewards());
             storm::models::sparse::StandardRewardModel<ValueType> & reward_model_subdtmc = (reward_models_subdtmc.find(this->formula_reward_name[index]))->second;
             for(StateType state : to_expand) {
@@ -374,7 +585,8 @@ namespace synthesis {
                 if(reward_model_dtmc.hasStateRewards()) {
                     reward = reward_model_dtmc.getStateReward(state);
                 } else {
-                    reward = reward_model_dtmc.getStateActionReward(state);
+                    uint64_t row = this->use_quotient_matrix ? this->state_to_choice[state] : state;
+                    reward = reward_model_dtmc.getStateActionReward(row);
                 }
                 reward_model_subdtmc.setStateReward(state, reward);
             }
@@ -443,23 +655,75 @@ namespace synthesis {
         uint64_t formula_index,
         ValueType formula_bound,
         std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const> mdp_bounds,
-        std::vector<StateType> const& mdp_quotient_state_map
+        std::vector<StateType> const& mdp_quotient_state_map,
+        uint64_t minimize_attempts,
+        double minimize_time_limit
+        ) {
+        PAYNT_TRACE_SCOPE("counterexample.constructConflict");
+        this->activateBounds(mdp_bounds, mdp_quotient_state_map);
+        return this->constructConflictActive(formula_index, formula_bound, minimize_attempts, minimize_time_limit);
+    }
+
+    template <typename ValueType, typename StateType>
+    std::vector<uint64_t> CounterexampleGenerator<ValueType,StateType>::constructConflictRegistered (
+        uint64_t formula_index,
+        ValueType formula_bound,
+        uint64_t bounds_id,
+        uint64_t minimize_attempts,
+        double minimize_time_limit
+        ) {
+        this->activateRegisteredBounds(bounds_id);
+        return this->constructConflictActive(formula_index, formula_bound, minimize_attempts, minimize_time_limit);
+    }
+
+    template <typename ValueType, typename StateType>
+    std::vector<uint64_t> CounterexampleGenerator<ValueType,StateType>::constructConflictActive (
+        uint64_t formula_index,
+        ValueType formula_bound,
+        uint64_t minimize_attempts,
+        double minimize_time_limit
         ) {
         this->timer_conflict.start();
+        uint64_t model_check_us_before = this->timer_model_check.getTimeInMicroseconds();
+
+        // Serve the conflict from the reuse cache: if only holes outside of the cached conflict
+        // changed since it was recorded, the violating sub-DTMC is untouched and the conflict
+        // applies to the current DTMC as well
+        if(this->conflict_reuse && this->reuse_conflict_valid[formula_index]
+            && this->reuse_conflict_bound[formula_index] == formula_bound) {
+            bool untouched = true;
+            for(uint64_t hole: this->reuse_conflict[formula_index]) {
+                if(this->reuse_dirty_holes[formula_index].get(hole)) {
+                    untouched = false;
+                    break;
+                }
+            }
+            if(untouched) {
+                this->num_reused_conflicts++;
+                this->recordConflictStats(std::make_tuple(0, 0, this->reuse_conflict[formula_index].size(), 0));
+                this->timer_conflict.stop();
+                return this->reuse_conflict[formula_index];
+            }
+        }
 
         // Clear hint result
         this->hint_result = NULL;
         
         // Get DTMC info
-        StateType dtmc_states = this->dtmc->getNumberOfStates();
+        StateType dtmc_states = this->numDtmcStates();
         
-        // Prepare to construct sub-DTMCs
-        std::vector<std::vector<std::pair<StateType,ValueType>>> matrix_subdtmc;
+        // Prepare to construct sub-DTMCs; the rerouted rows live in the workspace and only get
+        // cleared here, retaining their capacity from previous conflicts
+        if(this->workspace_matrix.size() < dtmc_states+2) {
+            this->workspace_matrix.resize(dtmc_states+2);
+        }
+        for(StateType state = 0; state < dtmc_states+2; state++) {
+            this->workspace_matrix[state].clear();
+        }
+        std::vector<std::vector<std::pair<StateType,ValueType>>> & matrix_subdtmc = this->workspace_matrix;
         storm::models::sparse::StateLabeling labeling_subdtmc(dtmc_states+2);
         std::unordered_map<std::string, storm::models::sparse::StandardRewardModel<ValueType>> reward_models_subdtmc;
-        this->prepareSubdtmc(
-            formula_index, mdp_bounds, mdp_quotient_state_map, matrix_subdtmc, labeling_subdtmc, reward_models_subdtmc
-        );
+        this->prepareSubdtmc(formula_index, matrix_subdtmc, labeling_subdtmc, reward_models_subdtmc);
 
         // Explore subDTMCs wave by wave
         uint64_t wave_last = this->wave_states.size()-1;
@@ -470,8 +734,9 @@ namespace synthesis {
             std::cout << this->hole_wave[hole] << ",";
         }
         std::cout << std::endl;*/
+        bool satisfied = true;
         while(true) {
-            bool satisfied = this->expandAndCheck(
+            satisfied = this->expandAndCheck(
                 formula_index, formula_bound, matrix_subdtmc, labeling_subdtmc,
                 reward_models_subdtmc, this->wave_states[wave]
             );
@@ -485,19 +750,259 @@ namespace synthesis {
             wave++;
         }
 
+        // Optionally, greedily minimize the conflict: tentatively drop the holes of one wave at a
+        // time (in their order of registration), re-route every explored state containing a
+        // dropped hole back to its shortcut row and re-check; the drop is kept if the violation
+        // persists. Each attempt costs one model-checking call, bounded by the given budget.
+        std::vector<bool> wave_removed(wave+1, false);
+        if(minimize_attempts > 0 && !satisfied && wave >= 1) {
+            storm::utility::Stopwatch timer_minimize(true);
+            bool is_reward = this->formula_reward[formula_index];
+            double default_bound = is_reward ? 0 : (this->formula_safety[formula_index] ? 0 : 1);
+            storm::models::sparse::StandardRewardModel<ValueType> * reward_model_subdtmc = NULL;
+            if(is_reward) {
+                reward_model_subdtmc = &(reward_models_subdtmc.find(this->formula_reward_name[formula_index])->second);
+            }
+            uint64_t attempts = 0;
+            for(uint64_t candidate = 1; candidate <= wave; candidate++) {
+                if(attempts >= minimize_attempts) {
+                    break;
+                }
+                if(minimize_time_limit > 0 && (double)timer_minimize.getTimeInMilliseconds()/1000 >= minimize_time_limit) {
+                    break;
+                }
+                attempts++;
+                wave_removed[candidate] = true;
+
+                // mark holes dropped under the tentative conflict
+                std::vector<bool> hole_removed(this->hole_count, false);
+                for(uint64_t hole = 0; hole < this->hole_count; hole++) {
+                    uint64_t wave_registered = this->hole_wave[hole];
+                    if(wave_registered > 0 && wave_registered <= wave && wave_removed[wave_registered]) {
+                        hole_removed[hole] = true;
+                    }
+                }
+
+                // a state stays expanded only if it contains no dropped hole
+                std::vector<StateType> to_expand;
+                for(uint64_t wave_index = 0; wave_index <= wave; wave_index++) {
+                    for(StateType state: this->wave_states[wave_index]) {
+                        StateType mdp_state = this->state_map[state];
+                        bool permitted = true;
+                        for(uint64_t index = this->mdp_holes_offset[mdp_state]; index < this->mdp_holes_offset[mdp_state+1]; index++) {
+                            if(hole_removed[this->mdp_holes_flat[index]]) {
+                                permitted = false;
+                                break;
+                            }
+                        }
+                        if(permitted) {
+                            to_expand.push_back(state);
+                            continue;
+                        }
+                        double bound = default_bound;
+                        if(this->active_bounds != NULL && (*this->active_bounds_epoch)[mdp_state] == this->active_epoch) {
+                            bound = (*this->active_bounds)[mdp_state];
+                        }
+                        matrix_subdtmc[state].clear();
+                        if(!is_reward) {
+                            matrix_subdtmc[state].emplace_back(dtmc_states, 1-bound);
+                            matrix_subdtmc[state].emplace_back(dtmc_states+1, bound);
+                        } else {
+                            matrix_subdtmc[state].emplace_back(dtmc_states+1, 1);
+                            reward_model_subdtmc->setStateReward(state, bound);
+                        }
+                    }
+                }
+                bool tentative_satisfied = this->expandAndCheck(
+                    formula_index, formula_bound, matrix_subdtmc, labeling_subdtmc,
+                    reward_models_subdtmc, to_expand
+                );
+                if(tentative_satisfied) {
+                    // the dropped holes were essential
+                    wave_removed[candidate] = false;
+                }
+            }
+        }
+
         // Return a set of critical holes
         std::vector<uint64_t> critical_holes;
         for(uint64_t hole = 0; hole < this->hole_count; hole++) {
             uint64_t wave_registered = this->hole_wave[hole];
-            if(wave_registered > 0 && wave_registered <= wave) {
+            if(wave_registered > 0 && wave_registered <= wave && !wave_removed[wave_registered]) {
                 critical_holes.push_back(hole);
             }
         }
+
+        // Cache the conflict for reuse against sibling DTMCs; a run that never found a violation
+        // yields no reusable conflict
+        if(this->conflict_reuse) {
+            if(!satisfied) {
+                this->reuse_conflict[formula_index] = critical_holes;
+                this->reuse_conflict_valid[formula_index] = true;
+                this->reuse_conflict_bound[formula_index] = formula_bound;
+                this->reuse_dirty_holes[formula_index].clear();
+            } else {
+                this->reuse_conflict_valid[formula_index] = false;
+            }
+        }
+
+        // Record per-conflict statistics
+        uint64_t states_touched = 0;
+        for(uint64_t wave_index = 0; wave_index <= wave; wave_index++) {
+            states_touched += this->wave_states[wave_index].size();
+        }
+        this->recordConflictStats(std::make_tuple(
+            wave, states_touched, critical_holes.size(),
+            this->timer_model_check.getTimeInMicroseconds() - model_check_us_before
+        ));
         this->timer_conflict.stop();
 
         return critical_holes;
     }
 
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::setConflictReuse(bool enabled) {
+        this->conflict_reuse = enabled;
+        if(!enabled) {
+            for(uint64_t formula_index = 0; formula_index < this->reuse_conflict_valid.size(); formula_index++) {
+                this->reuse_conflict_valid[formula_index] = false;
+            }
+        }
+    }
+
+    template <typename ValueType, typename StateType>
+    uint64_t CounterexampleGenerator<ValueType,StateType>::numReusedConflicts() const {
+        return this->num_reused_conflicts;
+    }
+
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::recordConflictStats(std::tuple<uint64_t,uint64_t,uint64_t,uint64_t> const& record) {
+        if(this->stats_capacity == 0) {
+            return;
+        }
+        if(this->stats_ring.size() < this->stats_capacity) {
+            this->stats_ring.push_back(record);
+        } else {
+            this->stats_ring[this->stats_next] = record;
+        }
+        this->stats_next = (this->stats_next+1) % this->stats_capacity;
+    }
+
+    template <typename ValueType, typename StateType>
+    std::vector<std::tuple<uint64_t,uint64_t,uint64_t,uint64_t>> CounterexampleGenerator<ValueType,StateType>::fetchConflictStats() {
+        std::vector<std::tuple<uint64_t,uint64_t,uint64_t,uint64_t>> records;
+        uint64_t num_records = this->stats_ring.size();
+        records.reserve(num_records);
+        uint64_t start = num_records < this->stats_capacity ? 0 : this->stats_next;
+        for(uint64_t index = 0; index < num_records; index++) {
+            records.push_back(this->stats_ring[(start+index) % num_records]);
+        }
+        this->stats_ring.clear();
+        this->stats_next = 0;
+        return records;
+    }
+
+    template <typename ValueType, typename StateType>
+    void CounterexampleGenerator<ValueType,StateType>::setConflictStatsCapacity(uint64_t capacity) {
+        this->stats_capacity = capacity;
+        this->stats_ring.clear();
+        this->stats_next = 0;
+    }
+
+    template <typename ValueType, typename StateType>
+    std::vector<std::vector<uint64_t>> CounterexampleGenerator<ValueType,StateType>::constructConflicts (
+        std::vector<uint64_t> const& formula_indices,
+        std::vector<ValueType> const& formula_bounds,
+        std::vector<std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const>> const& mdp_bounds,
+        std::vector<StateType> const& mdp_quotient_state_map
+        ) {
+        return constructConflictsFused(formula_indices, formula_bounds, mdp_bounds, mdp_quotient_state_map).first;
+    }
+
+    template <typename ValueType, typename StateType>
+    std::pair<std::vector<std::vector<uint64_t>>,std::vector<uint64_t>> CounterexampleGenerator<ValueType,StateType>::constructConflictsFused (
+        std::vector<uint64_t> const& formula_indices,
+        std::vector<ValueType> const& formula_bounds,
+        std::vector<std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const>> const& mdp_bounds,
+        std::vector<StateType> const& mdp_quotient_state_map
+        ) {
+        STORM_LOG_THROW(
+            formula_indices.size() == formula_bounds.size() && formula_indices.size() == mdp_bounds.size(),
+            storm::exceptions::InvalidArgumentException, "Number of formula bounds must match the number of formula indices."
+        );
+        this->timer_conflict.start();
+
+        // Clear hint result
+        this->hint_result = NULL;
+
+        // Get DTMC info
+        uint64_t num_queries = formula_indices.size();
+        StateType dtmc_states = this->numDtmcStates();
+
+        // Prepare one sub-DTMC per queried formula
+        std::vector<std::vector<std::vector<std::pair<StateType,ValueType>>>> matrix_subdtmc(num_queries);
+        std::vector<storm::models::sparse::StateLabeling> labeling_subdtmc(num_queries, storm::models::sparse::StateLabeling(dtmc_states+2));
+        std::vector<std::unordered_map<std::string, storm::models::sparse::StandardRewardModel<ValueType>>> reward_models_subdtmc(num_queries);
+        std::vector<std::unique_ptr<storm::modelchecker::CheckResult>> hints(num_queries);
+        for(uint64_t query = 0; query < num_queries; query++) {
+            matrix_subdtmc[query].resize(dtmc_states+2);
+            this->activateBounds(mdp_bounds[query], mdp_quotient_state_map);
+            this->prepareSubdtmc(
+                formula_indices[query], matrix_subdtmc[query], labeling_subdtmc[query], reward_models_subdtmc[query]
+            );
+        }
+
+        // Expand all sub-DTMCs in lockstep, wave by wave, dropping a query once it is unsatisfied
+        uint64_t wave_last = this->wave_states.size()-1;
+        std::vector<uint64_t> conflict_wave(num_queries, wave_last);
+        storm::storage::BitVector query_active(num_queries, true);
+        for(uint64_t wave = 0; wave <= wave_last; wave++) {
+            for(uint64_t query: query_active) {
+                this->hint_result = std::move(hints[query]);
+                bool satisfied = this->expandAndCheck(
+                    formula_indices[query], formula_bounds[query], matrix_subdtmc[query],
+                    labeling_subdtmc[query], reward_models_subdtmc[query], this->wave_states[wave]
+                );
+                hints[query] = std::move(this->hint_result);
+                if(!satisfied) {
+                    conflict_wave[query] = wave;
+                    query_active.set(query,false);
+                }
+            }
+            if(query_active.empty()) {
+                break;
+            }
+        }
+        this->hint_result = NULL;
+
+        // Return a set of critical holes per query; a conflict contains exactly the holes
+        // registered up to its violation wave, so the cross-formula intersection is the
+        // registration prefix of the earliest violation wave
+        uint64_t wave_earliest = wave_last;
+        std::vector<std::vector<uint64_t>> conflicts(num_queries);
+        for(uint64_t query = 0; query < num_queries; query++) {
+            if(conflict_wave[query] < wave_earliest) {
+                wave_earliest = conflict_wave[query];
+            }
+            for(uint64_t hole = 0; hole < this->hole_count; hole++) {
+                uint64_t wave_registered = this->hole_wave[hole];
+                if(wave_registered > 0 && wave_registered <= conflict_wave[query]) {
+                    conflicts[query].push_back(hole);
+                }
+            }
+        }
+        std::vector<uint64_t> conflict_intersection;
+        for(uint64_t hole = 0; hole < this->hole_count; hole++) {
+            uint64_t wave_registered = this->hole_wave[hole];
+            if(wave_registered > 0 && wave_registered <= wave_earliest) {
+                conflict_intersection.push_back(hole);
+            }
+        }
+        this->timer_conflict.stop();
+
+        return std::make_pair(conflicts,conflict_intersection);
+    }
+
     template <typename ValueType, typename StateType>
     void CounterexampleGenerator<ValueType,StateType>::printProfiling() {
         std::cout << "[s] conflict: " << this->timer_conflict << std::endl;
@@ -7,8 +7,12 @@
 #include "storm/modelchecker/results/ExplicitQualitativeCheckResult.h"
 
 #include "storm/models/sparse/Dtmc.h"
+#include "storm/storage/BitVector.h"
+#include "storm/storage/SparseMatrix.h"
 #include "storm/utility/Stopwatch.h"
 
+#include <tuple>
+
 namespace synthesis {
 
     template<typename ValueType = double, typename StateType = uint64_t>
@@ -48,6 +52,14 @@ namespace synthesis {
             storm::models::sparse::Dtmc<ValueType> const& dtmc,
             std::vector<uint64_t> const& state_map
             );
+
+        /*!
+         * Zero-copy variant of prepareDtmc: view the DTMC directly through the quotient MDP
+         * matrix, selecting in every state the first choice enabled in \p choice_mask. State
+         * indices then coincide with quotient state indices and no DTMC is ever materialized.
+         * @param choice_mask For each choice of the quotient MDP, whether it is selected.
+         */
+        void prepareDtmcDirect(storm::storage::BitVector const& choice_mask);
         
         /*!
          * Construct a counterexample to a prepared DTMC and a formula with
@@ -56,12 +68,80 @@ namespace synthesis {
          * @param formula_bound Formula threshold for CE construction.
          * @param mdp_bounds MDP model checking result in the primary direction (NULL if not used).
          * @param mdp_quotient_state_mdp A mapping of MDP states to the states of a quotient MDP.
+         * @param minimize_attempts If positive, greedily minimize the found conflict: try
+         *   dropping hole groups in their order of registration and keep a drop if the violation
+         *   persists, spending at most this many additional model-checking calls.
+         * @param minimize_time_limit Time budget (in seconds) for the minimization phase;
+         *   0 means no time limit.
          * @return A list of holes relevant in the CE.
          */
         std::vector<uint64_t> constructConflict(
             uint64_t formula_index,
             ValueType formula_bound,
             std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const> mdp_bounds,
+            std::vector<StateType> const& mdp_quotient_state_map,
+            uint64_t minimize_attempts = 0,
+            double minimize_time_limit = 0
+            );
+
+        /*!
+         * Flatten the given MDP bounds onto the quotient state space and store them in the
+         * registered bounds table. Register once per family check and reference by id afterwards:
+         * subsequent conflicts then read the bounds from a flat per-state array instead of going
+         * through the check-result interface.
+         * @return The id of the registered bounds.
+         */
+        uint64_t registerMdpBounds(
+            std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const> mdp_bounds,
+            std::vector<StateType> const& mdp_quotient_state_map
+            );
+
+        /*! Drop all registered bounds, invalidating previously returned ids. */
+        void clearRegisteredBounds();
+
+        /*!
+         * Same as constructConflict, but reading MDP bounds registered under the given id.
+         */
+        std::vector<uint64_t> constructConflictRegistered(
+            uint64_t formula_index,
+            ValueType formula_bound,
+            uint64_t bounds_id,
+            uint64_t minimize_attempts = 0,
+            double minimize_time_limit = 0
+            );
+
+        /*!
+         * Construct counterexamples to a prepared DTMC for several formulae at once. All
+         * sub-DTMCs are expanded in lockstep, wave by wave, so the common expansion prefix is
+         * walked once instead of once per formula.
+         * @param formula_indices Formula indices.
+         * @param formula_bounds For each queried formula, its threshold for CE construction.
+         * @param mdp_bounds For each queried formula, the MDP model checking result in the
+         *   primary direction (NULL if not used).
+         * @param mdp_quotient_state_map A mapping of MDP states to the states of a quotient MDP.
+         * @return For each queried formula, a list of holes relevant in its CE.
+         */
+        std::vector<std::vector<uint64_t>> constructConflicts(
+            std::vector<uint64_t> const& formula_indices,
+            std::vector<ValueType> const& formula_bounds,
+            std::vector<std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const>> const& mdp_bounds,
+            std::vector<StateType> const& mdp_quotient_state_map
+            );
+
+        /*!
+         * Same as constructConflicts, but additionally returning the intersection of the
+         * per-formula conflicts. Conflicts are prefix-closed in hole registration order - a
+         * conflict contains exactly the holes registered up to its violation wave - so the
+         * intersection is the registration prefix of the earliest violation wave and comes out
+         * of the shared expansion for free. It is the strongest fact all violated formulae
+         * agree on and typically prunes most in multi-objective CEGIS.
+         * @return For each queried formula, a list of holes relevant in its CE, plus the
+         *   intersection of these lists.
+         */
+        std::pair<std::vector<std::vector<uint64_t>>,std::vector<uint64_t>> constructConflictsFused(
+            std::vector<uint64_t> const& formula_indices,
+            std::vector<ValueType> const& formula_bounds,
+            std::vector<std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const>> const& mdp_bounds,
             std::vector<StateType> const& mdp_quotient_state_map
             );
 
@@ -70,6 +150,28 @@ namespace synthesis {
          */
         void printProfiling();
 
+        /*!
+         * Fetch the recorded per-conflict statistics, oldest first, and clear the buffer. Each
+         * record holds (waves expanded, states touched, holes in conflict, model-check
+         * microseconds), so CE behavior can be scraped in bulk every N CEGIS iterations.
+         */
+        std::vector<std::tuple<uint64_t,uint64_t,uint64_t,uint64_t>> fetchConflictStats();
+
+        /*! Set the capacity of the per-conflict statistics ring buffer (0 disables recording). */
+        void setConflictStatsCapacity(uint64_t capacity);
+
+        /*!
+         * Enable or disable cross-assignment conflict reuse (enabled by default). Sibling CEGIS
+         * assignments often differ in a single hole: when the prepared DTMC differs from the
+         * previous one only in states whose holes do not occur in the latest conflict of a
+         * formula (and the bound is unchanged), that conflict is returned again without any
+         * expansion or model checking.
+         */
+        void setConflictReuse(bool enabled);
+
+        /*! Number of conflicts served from the reuse cache so far. */
+        uint64_t numReusedConflicts() const;
+
     protected:
 
         /** Identify states of an MDP having some label. */
@@ -78,12 +180,28 @@ namespace synthesis {
             storm::logic::Formula const& label
             );
 
+        /** Flatten the given MDP bounds into the workspace and make them the active lookup. */
+        void activateBounds(
+            std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const> mdp_bounds,
+            std::vector<StateType> const& mdp_quotient_state_map
+            );
+
+        /** Make the registered bounds with the given id the active lookup. */
+        void activateRegisteredBounds(uint64_t bounds_id);
+
+        /** Construct a conflict using the active bounds lookup. */
+        std::vector<uint64_t> constructConflictActive(
+            uint64_t formula_index,
+            ValueType formula_bound,
+            uint64_t minimize_attempts,
+            double minimize_time_limit
+            );
+
         /**
-         * Prepare data structures for sub-DTMC construction.
+         * Prepare data structures for sub-DTMC construction; MDP bounds are read from the active
+         * lookup set up beforehand.
          * @param formula_index Formula index.
-         * @param mdp_bounds MDP model checking result in the primary direction.
-         * @param matrix_dtmc (output) Copy of the transition matrix of the DTMC.
-         * @param matrix_subdtmc (output) Matrix of shortcuts.
+         * @param matrix_subdtmc (output) Matrix of shortcuts; rows must be pre-sized and cleared.
          * @param labeling_subdtdmc (output) Labeling marking target states.
          * @param reward_model_subdtmc (output) If the reward property is
          *   investigated, this map will contain exactly one reward model
@@ -91,8 +209,6 @@ namespace synthesis {
          */
         void prepareSubdtmc(
             uint64_t formula_index,
-            std::shared_ptr<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType> const> mdp_bounds,
-            std::vector<StateType> const& mdp_quotient_state_map,
             std::vector<std::vector<std::pair<StateType,ValueType>>> & matrix_subdtmc,
             storm::models::sparse::StateLabeling & labeling_subdtmc,
             std::unordered_map<std::string,storm::models::sparse::StandardRewardModel<ValueType>> & reward_models_subdtmc
@@ -121,8 +237,11 @@ namespace synthesis {
         storm::models::sparse::Mdp<ValueType> const& quotient_mdp;
         // Number of significant holes
         uint64_t hole_count;
-        // Significant holes in MDP states
-        std::vector<std::set<uint64_t>> mdp_holes;
+        // Significant holes of MDP states, stored as one flat sorted arena: the holes of state s
+        // occupy mdp_holes_flat[mdp_holes_offset[s] .. mdp_holes_offset[s+1]), which keeps the
+        // wave-loop scans over hole sets on contiguous memory
+        std::vector<uint64_t> mdp_holes_offset;
+        std::vector<uint64_t> mdp_holes_flat;
 
         // Formula bounds: safety (<,<=) or liveness (>,>=)
         std::vector<bool> formula_safety;
@@ -142,8 +261,21 @@ namespace synthesis {
         // Flags for target states
         std::vector<std::shared_ptr<storm::modelchecker::ExplicitQualitativeCheckResult const>> mdp_targets;
 
-        // DTMC under investigation
+        /** Compute the wave expansion order of the current DTMC view. */
+        void computeWaves();
+        /** Number of states of the current DTMC view. */
+        uint64_t numDtmcStates() const;
+        /** Initial state of the current DTMC view. */
+        StateType dtmcInitialState() const;
+        /** Transition row of the given state in the current DTMC view. */
+        typename storm::storage::SparseMatrix<ValueType>::const_rows stateRow(StateType state) const;
+
+        // DTMC under investigation (NULL in zero-copy mode)
         std::shared_ptr<storm::models::sparse::Dtmc<ValueType>> dtmc;
+        // Whether the DTMC is viewed directly through the quotient MDP matrix (zero-copy mode)
+        bool use_quotient_matrix = false;
+        // In zero-copy mode, the selected quotient choice of each state
+        std::vector<uint64_t> state_to_choice;
         // DTMC to MDP state mapping
         std::vector<uint64_t> state_map;
         // For each hole, a wave when it was registered (0 = unregistered).
@@ -151,9 +283,69 @@ namespace synthesis {
         // For each wave, a set of states that were expanded.
         std::vector<std::vector<StateType>> wave_states;
 
+        // Key of the previously prepared DTMC (state map + flattened transition structure):
+        // consecutive CEGIS DTMCs often coincide, in which case the wave order is reused as is.
+        std::vector<uint64_t> cached_state_map;
+        std::vector<StateType> cached_row_columns;
+        // Wave order computed for the cached key.
+        std::vector<uint64_t> cached_hole_wave;
+        std::vector<std::vector<StateType>> cached_wave_states;
+
+        // Cross-assignment conflict reuse. The latest conflict of each formula is kept together
+        // with the set of holes whose states' rows changed since it was recorded: as long as that
+        // dirty set stays disjoint from the conflict, the violating sub-DTMC is untouched and the
+        // conflict applies to the current DTMC as well.
+        bool conflict_reuse = true;
+        // Row values of the previously prepared DTMC, segmented like cached_row_columns.
+        std::vector<ValueType> cached_row_values;
+        // Per formula: the latest conflict, whether it is still usable and the bound it was
+        // constructed for.
+        std::vector<std::vector<uint64_t>> reuse_conflict;
+        std::vector<bool> reuse_conflict_valid;
+        std::vector<ValueType> reuse_conflict_bound;
+        // Per formula, the holes changed since its conflict was recorded.
+        std::vector<storm::storage::BitVector> reuse_dirty_holes;
+        uint64_t num_reused_conflicts = 0;
+
+        /** Accumulate the holes whose rows changed relative to the previously prepared DTMC. */
+        void updateConflictReuse(
+            std::vector<StateType> const& row_columns,
+            std::vector<ValueType> const& row_values
+            );
+
+        // Reusable sub-DTMC workspace: the rerouted matrix rows and the per-state bound lookups
+        // persist across constructConflict calls, so repeated conflicts only clear them (keeping
+        // their capacity) instead of re-allocating them.
+        // Rerouted transition matrix rows.
+        std::vector<std::vector<std::pair<StateType,ValueType>>> workspace_matrix;
+        // MDP bounds mapped onto the quotient state space, tagged by the epoch they were written in.
+        std::vector<ValueType> workspace_quotient_bounds;
+        std::vector<uint64_t> workspace_bounds_epoch;
+        uint64_t workspace_epoch = 0;
+
+        // Registered MDP bounds, flattened onto the quotient state space at registration time
+        // (epoch entries are 1 for states the bounds cover).
+        std::vector<std::vector<ValueType>> registered_bounds;
+        std::vector<std::vector<uint64_t>> registered_bounds_epoch;
+        // Active per-quotient-state bounds lookup used when constructing shortcut rows
+        // (NULL if no bounds are available).
+        std::vector<ValueType> const* active_bounds = NULL;
+        std::vector<uint64_t> const* active_bounds_epoch = NULL;
+        uint64_t active_epoch = 0;
+
         // Hint for future model checking.
         std::unique_ptr<storm::modelchecker::CheckResult> hint_result;
 
+        /** Append one record to the statistics ring buffer, overwriting the oldest when full. */
+        void recordConflictStats(std::tuple<uint64_t,uint64_t,uint64_t,uint64_t> const& record);
+
+        // Per-conflict statistics ring buffer (waves expanded, states touched, holes in conflict,
+        // model-check microseconds)
+        std::vector<std::tuple<uint64_t,uint64_t,uint64_t,uint64_t>> stats_ring;
+        uint64_t stats_capacity = 1024;
+        // Position the next record is written to
+        uint64_t stats_next = 0;
+
         // Profiling
         storm::utility::Stopwatch timer_conflict;
         storm::utility::Stopwatch timer_model_check;
@@ -18,6 +18,9 @@
 #include <storm/environment/Environment.h>
 #include <storm/environment/solver/SolverEnvironment.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace synthesis {
 
 
@@ -219,6 +222,58 @@ bool CounterexampleGeneratorMdp<ValueType,StateType>::exploreWave () {
     this->wave_states.push_back(std::vector<StateType>());
     blocking_candidate_set = false;
 
+    // With lookahead enabled, score the cheapest blocking candidates concurrently and commit the
+    // best one: fewest newly registered holes first, fewest unblocked states (smallest expansion)
+    // as a tie-breaker
+    if(this->candidate_lookahead > 1 && state_horizon_blocking.size() > 1) {
+        std::vector<StateType> candidates = state_horizon_blocking;
+        uint64_t num_candidates = std::min((uint64_t)candidates.size(), this->candidate_lookahead);
+        std::partial_sort(
+            candidates.begin(), candidates.begin()+num_candidates, candidates.end(),
+            [&](StateType a, StateType b) { return unregistered_holes_count[a] < unregistered_holes_count[b]; }
+        );
+        candidates.resize(num_candidates);
+        std::vector<std::pair<uint64_t,uint64_t>> candidate_score(num_candidates);
+        auto score_candidate = [&](uint64_t index) {
+            StateType candidate = candidates[index];
+            std::set<uint64_t> registered;
+            for(uint64_t hole: mdp_holes[candidate]) {
+                if(this->hole_wave[hole] == 0) {
+                    registered.insert(hole);
+                }
+            }
+            uint64_t unblocked = 0;
+            for(StateType state: state_horizon_blocking) {
+                bool would_unblock = true;
+                for(uint64_t hole: mdp_holes[state]) {
+                    if(this->hole_wave[hole] == 0 && registered.count(hole) == 0) {
+                        would_unblock = false;
+                        break;
+                    }
+                }
+                if(would_unblock) {
+                    unblocked++;
+                }
+            }
+            candidate_score[index] = std::make_pair(registered.size(), unblocked);
+        };
+        std::vector<std::thread> threads;
+        for(uint64_t index = 1; index < num_candidates; index++) {
+            threads.emplace_back(score_candidate, index);
+        }
+        score_candidate(0);
+        for(auto& thread: threads) {
+            thread.join();
+        }
+        uint64_t best = 0;
+        for(uint64_t index = 1; index < num_candidates; index++) {
+            if(candidate_score[index] < candidate_score[best]) {
+                best = index;
+            }
+        }
+        blocking_candidate = candidates[best];
+    }
+
     // Register all unregistered holes of this blocking state
     for(uint64_t hole: mdp_holes[blocking_candidate]) {
         if(this->hole_wave[hole] == 0) {
@@ -259,6 +314,12 @@ bool CounterexampleGeneratorMdp<ValueType,StateType>::exploreWave () {
     return false;
 }
 
+template <typename ValueType, typename StateType>
+void CounterexampleGeneratorMdp<ValueType,StateType>::setCandidateLookahead(uint64_t k) {
+    STORM_LOG_THROW(k > 0, storm::exceptions::InvalidArgumentException, "Candidate lookahead must be positive.");
+    this->candidate_lookahead = k;
+}
+
 // prepareSubmdp
 template <typename ValueType, typename StateType>
 void CounterexampleGeneratorMdp<ValueType,StateType>::prepareSubmdp (
@@ -60,6 +60,13 @@ public:
      */
     bool exploreWave ();
 
+    /*!
+     * Set the number of cheapest blocking candidates evaluated when starting a new wave.
+     * With k > 1, the candidates are scored concurrently (newly registered holes, then number of
+     * unblocked states) and the best one is committed; k = 1 keeps the default greedy choice.
+     */
+    void setCandidateLookahead(uint64_t k);
+
     /*!
      * Construct a counterexample to a prepared DTMC and a formula with
      * the given index.
@@ -176,6 +183,8 @@ protected:
     // blocking state containing currently the least number of unregistered holes + flag if the value was set
     StateType blocking_candidate;
     bool blocking_candidate_set;
+    // number of cheapest blocking candidates evaluated per wave (1 = greedy choice)
+    uint64_t candidate_lookahead = 1;
     // wave increases by one when new holes of a blocking candidate are registered
     uint64_t current_wave;
 
@@ -2,9 +2,46 @@
 
 #include "Counterexample.h"
 #include "CounterexampleMdp.h"
+#include "../quotient/Family.h"
+
+namespace synthesis {
+
+/**
+ * Generalize a conflict within the family: any family member that agrees with \p assignment on
+ * the conflict holes is excluded by the induced counterexample clause.
+ * @param family the analyzed family
+ * @param conflict indices of relevant holes in the counterexample
+ * @param assignment for each hole, the option of the rejected assignment
+ * @return the number of family members covered by the generalization (0 if the assignment options
+ *  of the conflict holes are no longer in the family); as a double since the count is a product
+ *  over all non-conflict holes and easily exceeds 64 bits
+ */
+double pruneFamilyWithConflict(
+    Family const& family, std::vector<uint64_t> const& conflict, std::vector<uint64_t> const& assignment
+) {
+    std::vector<bool> hole_in_conflict(family.numHoles(), false);
+    for(uint64_t hole: conflict) {
+        if(not family.holeContains(hole,assignment[hole])) {
+            return 0;
+        }
+        hole_in_conflict[hole] = true;
+    }
+    double pruned = 1;
+    for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+        if(not hole_in_conflict[hole]) {
+            pruned *= family.holeNumOptions(hole);
+        }
+    }
+    return pruned;
+}
+
+}
 
 void bindings_counterexamples(py::module& m) {
 
+    m.def("prune_family_with_conflict", &synthesis::pruneFamilyWithConflict,
+        py::arg("family"), py::arg("conflict"), py::arg("assignment"));
+
     py::class_<synthesis::CounterexampleGenerator<>>(m, "CounterexampleGenerator", "Counterexample generation")
         .def(
             py::init<
@@ -14,12 +51,41 @@ void bindings_counterexamples(py::module& m) {
             >(),
             py::arg("quotient_mdp"), py::arg("hole_count"), py::arg("mdp_holes"), py::arg("formulae")
         )
-        .def("prepare_dtmc", &synthesis::CounterexampleGenerator<>::prepareDtmc, py::arg("dtmc"), py::arg("quotient_state_map"))
+        .def("prepare_dtmc", &synthesis::CounterexampleGenerator<>::prepareDtmc, py::arg("dtmc"), py::arg("quotient_state_map"), py::call_guard<py::gil_scoped_release>())
+        .def("prepare_dtmc_direct", &synthesis::CounterexampleGenerator<>::prepareDtmcDirect, py::arg("choice_mask"), py::call_guard<py::gil_scoped_release>())
         .def(
             "construct_conflict", &synthesis::CounterexampleGenerator<>::constructConflict,
-            py::arg("formula_index"), py::arg("formula_bound"), py::arg("mdp_bounds"), py::arg("mdp_quotient_state_map")
+            py::arg("formula_index"), py::arg("formula_bound"), py::arg("mdp_bounds"), py::arg("mdp_quotient_state_map"),
+            py::arg("minimize_attempts") = 0, py::arg("minimize_time_limit") = 0,
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def(
+            "register_mdp_bounds", &synthesis::CounterexampleGenerator<>::registerMdpBounds,
+            py::arg("mdp_bounds"), py::arg("mdp_quotient_state_map")
+        )
+        .def("clear_registered_bounds", &synthesis::CounterexampleGenerator<>::clearRegisteredBounds)
+        .def(
+            "construct_conflict_registered", &synthesis::CounterexampleGenerator<>::constructConflictRegistered,
+            py::arg("formula_index"), py::arg("formula_bound"), py::arg("bounds_id"),
+            py::arg("minimize_attempts") = 0, py::arg("minimize_time_limit") = 0,
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def(
+            "construct_conflicts", &synthesis::CounterexampleGenerator<>::constructConflicts,
+            py::arg("formula_indices"), py::arg("formula_bounds"), py::arg("mdp_bounds"), py::arg("mdp_quotient_state_map"),
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def(
+            "construct_conflicts_fused", &synthesis::CounterexampleGenerator<>::constructConflictsFused,
+            py::arg("formula_indices"), py::arg("formula_bounds"), py::arg("mdp_bounds"), py::arg("mdp_quotient_state_map"),
+            py::call_guard<py::gil_scoped_release>(),
+            "construct conflicts for several formulae over one shared expansion, returns (per-formula conflicts, their intersection)"
         )
         .def("print_profiling", &synthesis::CounterexampleGenerator<>::printProfiling)
+        .def("fetch_conflict_stats", &synthesis::CounterexampleGenerator<>::fetchConflictStats)
+        .def("set_conflict_stats_capacity", &synthesis::CounterexampleGenerator<>::setConflictStatsCapacity, py::arg("capacity"))
+        .def("set_conflict_reuse", &synthesis::CounterexampleGenerator<>::setConflictReuse, py::arg("enabled"))
+        .def_property_readonly("num_reused_conflicts", &synthesis::CounterexampleGenerator<>::numReusedConflicts)
         ;
 
 
@@ -33,7 +99,8 @@ void bindings_counterexamples(py::module& m) {
             >(),
             py::arg("quotient_mdp"), py::arg("hole_count"), py::arg("mdp_holes"), py::arg("formulae")
         )
-        .def("prepare_mdp", &synthesis::CounterexampleGeneratorMdp<>::prepareMdp)
-        .def("construct_conflict", &synthesis::CounterexampleGeneratorMdp<>::constructConflict)
+        .def("prepare_mdp", &synthesis::CounterexampleGeneratorMdp<>::prepareMdp, py::call_guard<py::gil_scoped_release>())
+        .def("construct_conflict", &synthesis::CounterexampleGeneratorMdp<>::constructConflict, py::call_guard<py::gil_scoped_release>())
+        .def("set_candidate_lookahead", &synthesis::CounterexampleGeneratorMdp<>::setCandidateLookahead, py::arg("k"))
         ;
 }
@@ -2,13 +2,129 @@
 
 #include "madp/base/Globals.h"
 #include "madp/base/E.h"
+#include "madp/base/IndexTools.h"
+#include "madp/base/TransitionModelMapping.h"
+#include "madp/base/TransitionModelMappingSparse.h"
+#include "madp/base/ObservationModelMapping.h"
+#include "madp/base/ObservationModelMappingSparse.h"
+#include "madp/base/RewardModelMapping.h"
+#include "madp/base/RewardModelMappingSparse.h"
+#include "madp/base/RewardModelMappingSparseMapped.h"
 #include "madp/parser/MADPParser.h"
 
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
 #include <stack>
+#include <thread>
 
 namespace synthesis {
-    
-    
+
+    namespace {
+
+    /**
+     * Flattened view of a family of per-joint-action probability matrices: one contiguous
+     * slab of doubles with precomputed strides. The joint-space expansion reads probabilities
+     * billions of times; indexing a plain array replaces a virtual table lookup per read.
+     */
+    struct FlatConditionalTable {
+        /** All probabilities, laid out [table][row][column]. */
+        std::vector<double> probabilities;
+        /** Entries per row. */
+        uint64_t row_stride = 0;
+        /** Entries per table (joint action). */
+        uint64_t table_stride = 0;
+        bool filled = false;
+
+        /** Bulk accessor: the contiguous row of the given table. */
+        double const* row(uint64_t table, uint64_t row_index) const {
+            return probabilities.data() + table*table_stride + row_index*row_stride;
+        }
+    };
+
+    /**
+     * Hybrid reward table: the rewards are gathered once into a dense slab over the joint
+     * actions that carry a nonzero reward anywhere (typically a handful), addressed through a
+     * per-joint-action column map; joint actions outside the slab are zero everywhere.
+     * Extraction then fills the reward row of a state in one sweep over the slab row instead
+     * of paying a mapped-matrix lookup per (state, joint action) pair.
+     */
+    struct RewardSlab {
+        /** Marks a joint action without any nonzero reward. */
+        static constexpr uint64_t NO_COLUMN = std::numeric_limits<uint64_t>::max();
+        /** Slab of rewards, laid out [state][column]. */
+        std::vector<double> values;
+        /** For each joint action, its slab column, or \ref NO_COLUMN. */
+        std::vector<uint64_t> joint_action_column;
+        /** Number of slab columns (joint actions with some nonzero reward). */
+        uint64_t num_columns = 0;
+        bool filled = false;
+
+        /** Bulk accessor: the rewards of all joint actions of a state, in joint-action order. */
+        void extractRewardVector(uint64_t state, std::vector<double>& rewards) const {
+            rewards.assign(joint_action_column.size(),0);
+            double const* row = values.data() + state*num_columns;
+            for(uint64_t joint_action = 0; joint_action < joint_action_column.size(); joint_action++) {
+                if(joint_action_column[joint_action] != NO_COLUMN) {
+                    rewards[joint_action] = row[joint_action_column[joint_action]];
+                }
+            }
+        }
+    };
+
+    /** Gather the nonzero structure and values of a reward matrix into a \ref RewardSlab. */
+    template<typename MatrixType>
+    RewardSlab buildRewardSlab(MatrixType const& matrix, uint64_t num_states, uint64_t num_joint_actions) {
+        RewardSlab slab;
+        slab.joint_action_column.assign(num_joint_actions,RewardSlab::NO_COLUMN);
+        for(auto row_it = matrix.begin1(); row_it != matrix.end1(); ++row_it) {
+            for(auto entry_it = row_it.begin(); entry_it != row_it.end(); ++entry_it) {
+                if(*entry_it != 0 and slab.joint_action_column[entry_it.index2()] == RewardSlab::NO_COLUMN) {
+                    slab.joint_action_column[entry_it.index2()] = slab.num_columns++;
+                }
+            }
+        }
+        slab.values.assign(num_states*slab.num_columns,0);
+        for(auto row_it = matrix.begin1(); row_it != matrix.end1(); ++row_it) {
+            for(auto entry_it = row_it.begin(); entry_it != row_it.end(); ++entry_it) {
+                uint64_t column = slab.joint_action_column[entry_it.index2()];
+                if(column != RewardSlab::NO_COLUMN) {
+                    slab.values[entry_it.index1()*slab.num_columns + column] = *entry_it;
+                }
+            }
+        }
+        slab.filled = true;
+        return slab;
+    }
+
+    /** Flatten the dense mapping matrices of a model into one stride-indexed slab. */
+    template<typename ModelMapping>
+    FlatConditionalTable flattenMatrices(ModelMapping const* mapping, uint64_t num_tables, uint64_t num_rows, uint64_t num_columns) {
+        FlatConditionalTable table;
+        if(mapping == NULL) {
+            return table;
+        }
+        table.row_stride = num_columns;
+        table.table_stride = num_rows*num_columns;
+        table.probabilities.resize(num_tables*table.table_stride);
+        for(uint64_t index = 0; index < num_tables; index++) {
+            auto const* matrix = mapping->GetMatrixPtr(index);
+            double *slab = table.probabilities.data() + index*table.table_stride;
+            for(uint64_t row = 0; row < num_rows; row++) {
+                for(uint64_t column = 0; column < num_columns; column++) {
+                    slab[row*num_columns + column] = (*matrix)(row,column);
+                }
+            }
+        }
+        table.filled = true;
+        return table;
+    }
+
+    }
+
+
     void DecPomdp::collectActions(DecPOMDPDiscrete *model) {
         
         // individual actions
@@ -22,12 +138,18 @@ namespace synthesis {
             }
         }
 
-        // joint actions
-        this->joint_actions.resize(model->GetNrJointActions());
-        for(uint64_t joint_action_index = 0; joint_action_index < model->GetNrJointActions(); joint_action_index++) {
-            for(auto action: model->JointToIndividualActionIndices(joint_action_index)) {
-                this->joint_actions[joint_action_index].push_back(action);
-            }
+        // joint actions: decode the joint indices locally from precomputed strides instead of
+        // querying (and caching) each tuple in the model
+        std::vector<size_t> agent_num_actions(this->num_agents);
+        for(uint64_t agent = 0; agent < this->num_agents; agent++) {
+            agent_num_actions[agent] = model->GetNrActions(agent);
+        }
+        auto action_step_size = IndexTools::CalculateStepSizeVector(agent_num_actions);
+        uint64_t num_joint_actions = model->GetNrJointActions();
+        this->joint_actions.resize(num_joint_actions);
+        for(uint64_t joint_action_index = 0; joint_action_index < num_joint_actions; joint_action_index++) {
+            auto action_tuple = IndexTools::JointToIndividualIndicesStepSize(joint_action_index, action_step_size);
+            this->joint_actions[joint_action_index].assign(action_tuple.begin(), action_tuple.end());
         }
     }
 
@@ -41,13 +163,17 @@ namespace synthesis {
             }
         }
 
-        // joint observations
+        // joint observations: decode the joint indices locally from precomputed strides
+        std::vector<size_t> agent_num_observations(this->num_agents);
+        for(uint64_t agent = 0; agent < this->num_agents; agent++) {
+            agent_num_observations[agent] = model->GetNrObservations(agent);
+        }
+        auto observation_step_size = IndexTools::CalculateStepSizeVector(agent_num_observations);
         uint64_t num_joint_observations = model->GetNrJointObservations();
         this->joint_observations.resize(num_joint_observations);
         for(uint64_t joint_observation_index = 0; joint_observation_index < num_joint_observations; joint_observation_index++) {
-            for(auto observation: model->JointToIndividualObservationIndices(joint_observation_index)) {
-                this->joint_observations[joint_observation_index].push_back(observation);
-            }
+            auto observation_tuple = IndexTools::JointToIndividualIndicesStepSize(joint_observation_index, observation_step_size);
+            this->joint_observations[joint_observation_index].assign(observation_tuple.begin(), observation_tuple.end());
         }
     }
 
@@ -124,37 +250,116 @@ namespace synthesis {
         this->num_agents = model->GetNrAgents();
         this->discount_factor = model->GetDiscount();
         this->reward_minimizing = model->GetRewardType() == COST;
-        this->agent_prototype_row_index.resize(this->num_agents);
-
 
         this->collectActions(model);
         this->collectObservations(model);
 
-        // multiply transition and observation probabilities
-        std::vector<std::vector<std::vector<std::pair<MadpState,double>>>> madp_transition_matrix;
-        for(uint64_t src = 0; src < model->GetNrStates(); src++) {
-            std::vector<std::vector<std::pair<MadpState,double>>> row_group;
-            
-            for(uint64_t joint_action = 0; joint_action < model->GetNrJointActions(); joint_action++) {
-                std::vector<std::pair<MadpState,double>> row;
-                
-                for(uint64_t dst = 0; dst < model->GetNrStates(); dst++) {
-                    double transition_prob = model->GetTransitionProbability(src, joint_action, dst);
-                    if(transition_prob == 0) {
+        // multiply transition and observation probabilities; the joint-space expansion is a pure
+        // product computation independent per source state, so it is split among workers
+        uint64_t num_madp_states = model->GetNrStates();
+        uint64_t num_madp_joint_actions = model->GetNrJointActions();
+        uint64_t num_madp_joint_observations = model->GetNrJointObservations();
+        std::vector<std::vector<std::vector<std::pair<MadpState,double>>>> madp_transition_matrix(num_madp_states);
+        // when the parser stored the models in their sparse mapping forms, iterate their
+        // nonzero structure directly instead of probing every (dst,obs) pair
+        auto const* sparse_transitions =
+            dynamic_cast<TransitionModelMappingSparse const*>(model->GetTransitionModelDiscretePtr());
+        auto const* sparse_observations =
+            dynamic_cast<ObservationModelMappingSparse const*>(model->GetObservationModelDiscretePtr());
+        bool models_are_sparse = sparse_transitions != NULL and sparse_observations != NULL;
+        // dense mapping forms are flattened once into stride-indexed slabs, so the expansion
+        // reads contiguous rows instead of paying a virtual lookup per probability
+        FlatConditionalTable flat_transitions, flat_observations;
+        if(not models_are_sparse) {
+            flat_transitions = flattenMatrices(
+                dynamic_cast<TransitionModelMapping const*>(model->GetTransitionModelDiscretePtr()),
+                num_madp_joint_actions, num_madp_states, num_madp_states
+            );
+            flat_observations = flattenMatrices(
+                dynamic_cast<ObservationModelMapping const*>(model->GetObservationModelDiscretePtr()),
+                num_madp_joint_actions, num_madp_states, num_madp_joint_observations
+            );
+        }
+        bool models_are_flat = flat_transitions.filled and flat_observations.filled;
+        auto expandStates = [&](uint64_t src_begin, uint64_t src_end) {
+            for(uint64_t src = src_begin; src < src_end; src++) {
+                std::vector<std::vector<std::pair<MadpState,double>>> row_group;
+                row_group.reserve(num_madp_joint_actions);
+
+                for(uint64_t joint_action = 0; joint_action < num_madp_joint_actions; joint_action++) {
+                    std::vector<std::pair<MadpState,double>> row;
+
+                    if(models_are_sparse) {
+                        boost::numeric::ublas::matrix_row<const TransitionModelMappingSparse::SparseMatrix>
+                            transition_row(*sparse_transitions->GetMatrixPtr(joint_action), src);
+                        for(auto transition_it = transition_row.begin(); transition_it != transition_row.end(); ++transition_it) {
+                            uint64_t dst = transition_it.index();
+                            double transition_prob = *transition_it;
+                            boost::numeric::ublas::matrix_row<const ObservationModelMappingSparse::SparseMatrix>
+                                observation_row(*sparse_observations->GetMatrixPtr(joint_action), dst);
+                            for(auto observation_it = observation_row.begin(); observation_it != observation_row.end(); ++observation_it) {
+                                uint64_t obs = observation_it.index();
+                                row.push_back(std::make_pair(std::make_pair(dst,obs), transition_prob*(*observation_it)));
+                            }
+                        }
+                        row_group.push_back(std::move(row));
+                        continue;
+                    }
+
+                    if(models_are_flat) {
+                        double const* transition_row = flat_transitions.row(joint_action,src);
+                        for(uint64_t dst = 0; dst < num_madp_states; dst++) {
+                            double transition_prob = transition_row[dst];
+                            if(transition_prob == 0) {
+                                continue;
+                            }
+                            double const* observation_row = flat_observations.row(joint_action,dst);
+                            for(uint64_t obs = 0; obs < num_madp_joint_observations; obs++) {
+                                double observation_prob = observation_row[obs];
+                                if(observation_prob == 0) {
+                                    continue;
+                                }
+                                row.push_back(std::make_pair(std::make_pair(dst,obs), transition_prob*observation_prob));
+                            }
+                        }
+                        row_group.push_back(std::move(row));
                         continue;
                     }
-                    
-                    for(uint64_t obs = 0; obs < model->GetNrJointObservations(); obs++) {
-                        double observation_prob = model->GetObservationProbability(joint_action, dst, obs);
-                        if(observation_prob == 0) {
+
+                    for(uint64_t dst = 0; dst < num_madp_states; dst++) {
+                        double transition_prob = model->GetTransitionProbability(src, joint_action, dst);
+                        if(transition_prob == 0) {
                             continue;
                         }
-                        row.push_back(std::make_pair(std::make_pair(dst,obs), transition_prob*observation_prob));
+
+                        for(uint64_t obs = 0; obs < num_madp_joint_observations; obs++) {
+                            double observation_prob = model->GetObservationProbability(joint_action, dst, obs);
+                            if(observation_prob == 0) {
+                                continue;
+                            }
+                            row.push_back(std::make_pair(std::make_pair(dst,obs), transition_prob*observation_prob));
+                        }
                     }
+                    row_group.push_back(std::move(row));
                 }
-                row_group.push_back(row);
+                madp_transition_matrix[src] = std::move(row_group);
+            }
+        };
+        uint64_t num_workers = std::min<uint64_t>(std::max(std::thread::hardware_concurrency(),1u), num_madp_states);
+        if(num_workers <= 1) {
+            expandStates(0,num_madp_states);
+        } else {
+            uint64_t states_per_worker = (num_madp_states+num_workers-1)/num_workers;
+            std::vector<std::thread> workers;
+            for(uint64_t worker = 1; worker < num_workers; worker++) {
+                uint64_t src_begin = std::min(worker*states_per_worker,num_madp_states);
+                uint64_t src_end = std::min(src_begin+states_per_worker,num_madp_states);
+                workers.emplace_back(expandStates,src_begin,src_end);
+            }
+            expandStates(0,states_per_worker);
+            for(auto& worker: workers) {
+                worker.join();
             }
-            madp_transition_matrix.push_back(row_group);
         }
 
         // create initial observation for the (unique) initial state
@@ -212,6 +417,17 @@ namespace synthesis {
         for(uint64_t joint_action = 0; joint_action < model->GetNrJointActions(); joint_action++) {
             madp_row_group.push_back(joint_action);
         }
+        // gather the reward mapping into a dense slab over the joint actions that actually
+        // carry rewards, so each state row is extracted in one sweep instead of one mapping
+        // lookup per joint action
+        RewardSlab reward_slab;
+        if(auto const* sparse_rewards = dynamic_cast<RewardModelMappingSparse const*>(model->GetRewardModelPtr())) {
+            reward_slab = buildRewardSlab(*sparse_rewards->GetMatrixPtr(), num_madp_states, num_madp_joint_actions);
+        } else if(auto const* mapped_rewards = dynamic_cast<RewardModelMappingSparseMapped const*>(model->GetRewardModelPtr())) {
+            reward_slab = buildRewardSlab(*mapped_rewards->GetMatrixPtr(), num_madp_states, num_madp_joint_actions);
+        } else if(auto const* dense_rewards = dynamic_cast<RewardModelMapping const*>(model->GetRewardModelPtr())) {
+            reward_slab = buildRewardSlab(*dense_rewards->GetMatrixPtr(), num_madp_states, num_madp_joint_actions);
+        }
         assert(this->row_joint_action.size() == this->num_states());
         assert(this->row_reward.size() == this->num_states());
         for(uint64_t storm_state = 0; storm_state < this->num_states(); storm_state++) {
@@ -222,13 +438,21 @@ namespace synthesis {
             } else {
                 this->row_joint_action[storm_state] = madp_row_group;
                 std::vector<double> rewards;
-                for(uint64_t joint_action = 0; joint_action < model->GetNrJointActions(); joint_action++) {
-                    rewards.push_back(model->GetReward(madp_state.first, joint_action));
+                if(reward_slab.filled) {
+                    reward_slab.extractRewardVector(madp_state.first, rewards);
+                } else {
+                    for(uint64_t joint_action = 0; joint_action < model->GetNrJointActions(); joint_action++) {
+                        rewards.push_back(model->GetReward(madp_state.first, joint_action));
+                    }
                 }
                 this->row_reward[storm_state] = std::move(rewards);
             }
         }
 
+        this->finalizeComponents();
+    }
+
+    void DecPomdp::finalizeComponents() {
         this->agent_observation_memory_size.resize(this->num_agents);
         for (uint64_t agent = 0; agent < this->num_agents; agent++) {
             this->agent_observation_memory_size[agent].resize(this->agent_num_observations(agent), 1);
@@ -237,6 +461,8 @@ namespace synthesis {
         this->max_successor_memory_size.resize(this->num_joint_observations());
 
         // for each agent and each row assign corresponding action index
+        this->agent_prototype_row_index.clear();
+        this->agent_prototype_row_index.resize(this->num_agents);
         std::vector<uint64_t> agent_actions_indeces;
         std::vector<uint64_t>::iterator it;
         for (int agent = 0; agent < this->num_agents; agent++) {
@@ -302,6 +528,23 @@ namespace synthesis {
             }
         }
         
+        if(this->discounted) {
+            // every discounted row additionally reaches the discount sink
+            auto sink_obs = this->state_joint_observation[this->discount_sink_state];
+            for(uint64_t state = 0; state < this->num_states(); state++) {
+                if(state == this->initial_state || state == this->discount_sink_state) {
+                    continue;
+                }
+                auto observ = this->state_joint_observation[state];
+                observation_successor_sets[observ].insert(sink_obs);
+                for (uint64_t agent = 0; agent < this->num_agents; agent++) {
+                    uint64_t agent_src_obs = this->joint_observations[observ][agent];
+                    uint64_t agent_sink_obs = this->joint_observations[sink_obs][agent];
+                    agent_observation_successor_sets[agent][agent_src_obs].insert(agent_sink_obs);
+                }
+            }
+        }
+
         for(uint64_t obs = 0; obs < num_observations; obs++) {
             this->observation_successors[obs] = std::vector<uint64_t>(
                 observation_successor_sets[obs].begin(),
@@ -484,10 +727,18 @@ namespace synthesis {
         uint64_t current_row = 0;
         for(uint64_t state = 0; state < this->num_states(); state++) {
             builder.newRowGroup(current_row);
-            for(auto row: this->transition_matrix[state]) {
-                for(auto entry: row) {
-                    builder.addNextValue(current_row, entry.first, entry.second);
-                } 
+            // no discounting in the initial state because it selects the actual initial state
+            bool discount_state = this->discounted
+                and state != this->initial_state and state != this->discount_sink_state;
+            for(auto const& row: this->transition_matrix[state]) {
+                for(auto const& entry: row) {
+                    builder.addNextValue(current_row, entry.first,
+                        discount_state ? entry.second*this->discount_factor : entry.second);
+                }
+                if(discount_state) {
+                    // the sink was created last, so its column follows all the original ones
+                    builder.addNextValue(current_row, this->discount_sink_state, 1-this->discount_factor);
+                }
                 current_row++;
             }
         }
@@ -504,6 +755,9 @@ namespace synthesis {
         for(uint64_t state = 0; state < this->num_quotient_states; state++) {
             auto prototype_state = this->state_prototype[state];
             auto observation = this->state_joint_observation[prototype_state];
+            // no discounting in the initial state because it selects the actual initial state
+            bool discount_state = this->discounted
+                and prototype_state != this->initial_state and prototype_state != this->discount_sink_state;
             builder.newRowGroup(this->row_groups[state]);
             for (uint64_t row = this->row_groups[state]; row < this->row_groups[state+1]; row++) {
                 auto prototype_state_row = this->row_prototype_state[row];
@@ -516,7 +770,19 @@ namespace synthesis {
                     } else {
                         dst = (*dst_it).second;
                     }
-                    builder.addNextValue(row, dst, entry.second);
+                    builder.addNextValue(row, dst,
+                        discount_state ? entry.second*this->discount_factor : entry.second);
+                }
+                if(discount_state) {
+                    // the sink prototype was created last, so its duplicates follow all others
+                    uint64_t sink_dst;
+                    auto sink_it = this->prototype_duplicates[this->discount_sink_state].find(agents_dst_mem);
+                    if (sink_it == this->prototype_duplicates[this->discount_sink_state].end()) {
+                        sink_dst = this->prototype_duplicates[this->discount_sink_state].at(agent_default_memories);
+                    } else {
+                        sink_dst = (*sink_it).second;
+                    }
+                    builder.addNextValue(row, sink_dst, 1-this->discount_factor);
                 }
             }
         }
@@ -604,6 +870,270 @@ namespace synthesis {
     }
 
 
+    // binary cache layout: every field is 8-byte aligned, strings are length-prefixed and
+    // zero-padded to the word size
+    const char DECPOMDP_CACHE_MAGIC[8] = {'P','A','Y','N','T','D','E','C'};
+    const uint64_t DECPOMDP_CACHE_VERSION = 1;
+
+    static void cacheWriteUint(std::ofstream& out, uint64_t value) {
+        out.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    static void cacheWriteDouble(std::ofstream& out, double value) {
+        out.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    static void cacheWriteString(std::ofstream& out, std::string const& value) {
+        cacheWriteUint(out, value.size());
+        uint64_t padded_size = (value.size()+7)/8*8;
+        std::string buffer(padded_size, '\0');
+        std::copy(value.begin(), value.end(), buffer.begin());
+        out.write(buffer.data(), padded_size);
+    }
+
+    static void cacheWriteUintVector(std::ofstream& out, std::vector<uint64_t> const& values) {
+        cacheWriteUint(out, values.size());
+        out.write(reinterpret_cast<char const*>(values.data()), values.size()*sizeof(uint64_t));
+    }
+
+    static void cacheWriteDoubleVector(std::ofstream& out, std::vector<double> const& values) {
+        cacheWriteUint(out, values.size());
+        out.write(reinterpret_cast<char const*>(values.data()), values.size()*sizeof(double));
+    }
+
+    static uint64_t cacheReadUint(std::ifstream& in) {
+        uint64_t value = 0;
+        in.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    static double cacheReadDouble(std::ifstream& in) {
+        double value = 0;
+        in.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    static std::string cacheReadString(std::ifstream& in) {
+        uint64_t size = cacheReadUint(in);
+        if(not in.good()) {
+            return "";
+        }
+        uint64_t padded_size = (size+7)/8*8;
+        std::string buffer(padded_size, '\0');
+        in.read(&buffer[0], padded_size);
+        buffer.resize(size);
+        return buffer;
+    }
+
+    static std::vector<uint64_t> cacheReadUintVector(std::ifstream& in) {
+        uint64_t size = cacheReadUint(in);
+        if(not in.good()) {
+            return {};
+        }
+        std::vector<uint64_t> values(size);
+        in.read(reinterpret_cast<char*>(values.data()), size*sizeof(uint64_t));
+        return values;
+    }
+
+    static std::vector<double> cacheReadDoubleVector(std::ifstream& in) {
+        uint64_t size = cacheReadUint(in);
+        if(not in.good()) {
+            return {};
+        }
+        std::vector<double> values(size);
+        in.read(reinterpret_cast<char*>(values.data()), size*sizeof(double));
+        return values;
+    }
+
+    /** FNV-1a hash of the file contents, @return 0 if the file cannot be read */
+    static uint64_t hashFileContents(std::string const& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        if(not in) {
+            return 0;
+        }
+        uint64_t hash = 0xcbf29ce484222325ull;
+        char buffer[1<<16];
+        while(in.read(buffer, sizeof(buffer)) or in.gcount() > 0) {
+            for(std::streamsize i = 0; i < in.gcount(); i++) {
+                hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 0x100000001b3ull;
+            }
+        }
+        return hash != 0 ? hash : 1;
+    }
+
+    void DecPomdp::saveToCache(std::string const& cache_filename, uint64_t content_hash) {
+        std::ofstream out(cache_filename, std::ios::binary);
+        if(not out) {
+            // the cache is only an accelerator: inability to write it is not an error
+            return;
+        }
+        out.write(DECPOMDP_CACHE_MAGIC, sizeof(DECPOMDP_CACHE_MAGIC));
+        cacheWriteUint(out, DECPOMDP_CACHE_VERSION);
+        cacheWriteUint(out, content_hash);
+
+        cacheWriteUint(out, this->num_agents);
+        cacheWriteUint(out, this->reward_minimizing ? 1 : 0);
+        cacheWriteDouble(out, this->discount_factor);
+        cacheWriteUint(out, this->initial_state);
+
+        for(uint64_t agent = 0; agent < this->num_agents; agent++) {
+            cacheWriteUint(out, this->agent_action_labels[agent].size());
+            for(auto const& label: this->agent_action_labels[agent]) {
+                cacheWriteString(out, label);
+            }
+        }
+        cacheWriteUint(out, this->num_joint_actions());
+        for(auto const& action_tuple: this->joint_actions) {
+            cacheWriteUintVector(out, action_tuple);
+        }
+        for(uint64_t agent = 0; agent < this->num_agents; agent++) {
+            cacheWriteUint(out, this->agent_observation_labels[agent].size());
+            for(auto const& label: this->agent_observation_labels[agent]) {
+                cacheWriteString(out, label);
+            }
+        }
+        cacheWriteUint(out, this->num_joint_observations());
+        for(auto const& observation_tuple: this->joint_observations) {
+            cacheWriteUintVector(out, observation_tuple);
+        }
+
+        cacheWriteUint(out, this->num_states());
+        for(auto const& madp_state: this->storm_to_madp_states) {
+            cacheWriteUint(out, madp_state.first);
+            cacheWriteUint(out, madp_state.second);
+        }
+        cacheWriteUintVector(out, this->state_joint_observation);
+        for(auto const& row_group: this->transition_matrix) {
+            cacheWriteUint(out, row_group.size());
+            for(auto const& row: row_group) {
+                cacheWriteUint(out, row.size());
+                for(auto const& entry: row) {
+                    cacheWriteUint(out, entry.first);
+                    cacheWriteDouble(out, entry.second);
+                }
+            }
+        }
+        for(auto const& row_group: this->row_joint_action) {
+            cacheWriteUintVector(out, row_group);
+        }
+        for(auto const& row_group: this->row_reward) {
+            cacheWriteDoubleVector(out, row_group);
+        }
+    }
+
+    std::unique_ptr<DecPomdp> DecPomdp::loadFromCache(std::string const& cache_filename, uint64_t content_hash) {
+        std::ifstream in(cache_filename, std::ios::binary);
+        if(not in) {
+            return NULL;
+        }
+        char magic[8];
+        in.read(magic, sizeof(magic));
+        if(not in.good() or not std::equal(magic, magic+sizeof(magic), DECPOMDP_CACHE_MAGIC)) {
+            return NULL;
+        }
+        if(cacheReadUint(in) != DECPOMDP_CACHE_VERSION or cacheReadUint(in) != content_hash or not in.good()) {
+            return NULL;
+        }
+
+        std::unique_ptr<DecPomdp> decpomdp(new DecPomdp());
+        decpomdp->num_agents = cacheReadUint(in);
+        decpomdp->reward_minimizing = cacheReadUint(in) == 1;
+        decpomdp->discount_factor = cacheReadDouble(in);
+        decpomdp->initial_state = cacheReadUint(in);
+        if(not in.good()) {
+            return NULL;
+        }
+
+        decpomdp->agent_action_labels.resize(decpomdp->num_agents);
+        for(uint64_t agent = 0; agent < decpomdp->num_agents; agent++) {
+            uint64_t num_labels = cacheReadUint(in);
+            if(not in.good()) {
+                return NULL;
+            }
+            decpomdp->agent_action_labels[agent].reserve(num_labels);
+            for(uint64_t label = 0; label < num_labels; label++) {
+                decpomdp->agent_action_labels[agent].push_back(cacheReadString(in));
+            }
+        }
+        uint64_t num_joint_actions = cacheReadUint(in);
+        if(not in.good()) {
+            return NULL;
+        }
+        decpomdp->joint_actions.reserve(num_joint_actions);
+        for(uint64_t joint_action = 0; joint_action < num_joint_actions; joint_action++) {
+            decpomdp->joint_actions.push_back(cacheReadUintVector(in));
+        }
+        decpomdp->agent_observation_labels.resize(decpomdp->num_agents);
+        for(uint64_t agent = 0; agent < decpomdp->num_agents; agent++) {
+            uint64_t num_labels = cacheReadUint(in);
+            if(not in.good()) {
+                return NULL;
+            }
+            decpomdp->agent_observation_labels[agent].reserve(num_labels);
+            for(uint64_t label = 0; label < num_labels; label++) {
+                decpomdp->agent_observation_labels[agent].push_back(cacheReadString(in));
+            }
+        }
+        uint64_t num_joint_observations = cacheReadUint(in);
+        if(not in.good()) {
+            return NULL;
+        }
+        decpomdp->joint_observations.reserve(num_joint_observations);
+        for(uint64_t joint_observation = 0; joint_observation < num_joint_observations; joint_observation++) {
+            decpomdp->joint_observations.push_back(cacheReadUintVector(in));
+        }
+
+        uint64_t num_states = cacheReadUint(in);
+        if(not in.good()) {
+            return NULL;
+        }
+        decpomdp->storm_to_madp_states.reserve(num_states);
+        for(uint64_t state = 0; state < num_states; state++) {
+            uint64_t madp_state = cacheReadUint(in);
+            uint64_t madp_observation = cacheReadUint(in);
+            decpomdp->storm_to_madp_states.push_back(std::make_pair(madp_state,madp_observation));
+        }
+        decpomdp->state_joint_observation = cacheReadUintVector(in);
+        decpomdp->transition_matrix.resize(num_states);
+        for(uint64_t state = 0; state < num_states; state++) {
+            uint64_t num_rows = cacheReadUint(in);
+            if(not in.good()) {
+                return NULL;
+            }
+            decpomdp->transition_matrix[state].resize(num_rows);
+            for(uint64_t row = 0; row < num_rows; row++) {
+                uint64_t num_entries = cacheReadUint(in);
+                if(not in.good()) {
+                    return NULL;
+                }
+                decpomdp->transition_matrix[state][row].reserve(num_entries);
+                for(uint64_t entry = 0; entry < num_entries; entry++) {
+                    uint64_t dst = cacheReadUint(in);
+                    double prob = cacheReadDouble(in);
+                    decpomdp->transition_matrix[state][row].push_back(std::make_pair(dst,prob));
+                }
+            }
+        }
+        decpomdp->row_joint_action.resize(num_states);
+        for(uint64_t state = 0; state < num_states; state++) {
+            decpomdp->row_joint_action[state] = cacheReadUintVector(in);
+        }
+        decpomdp->row_reward.resize(num_states);
+        for(uint64_t state = 0; state < num_states; state++) {
+            decpomdp->row_reward[state] = cacheReadDoubleVector(in);
+        }
+        if(not in.good()) {
+            return NULL;
+        }
+
+        // rebuild the derived components
+        for(uint64_t state = 0; state < num_states; state++) {
+            decpomdp->madp_to_storm_states.insert(std::make_pair(decpomdp->storm_to_madp_states[state],state));
+        }
+        decpomdp->finalizeComponents();
+        return decpomdp;
+    }
+
     POMDPDiscrete *parse_as_pomdp(std::string filename) {
         try {
             POMDPDiscrete *model = new POMDPDiscrete("","",filename);
@@ -655,6 +1185,16 @@ namespace synthesis {
     }
 
     std::unique_ptr<DecPomdp> parseDecPomdp(std::string filename) {
+        // try the binary cache first, keyed by the hash of the source file
+        uint64_t content_hash = hashFileContents(filename);
+        std::string cache_filename = filename + ".paynt.bin";
+        if(content_hash != 0) {
+            auto cached = DecPomdp::loadFromCache(cache_filename, content_hash);
+            if(cached != NULL) {
+                STORM_PRINT_AND_LOG("MADP: loaded the model from the binary cache\n");
+                return cached;
+            }
+        }
         DecPOMDPDiscrete *madp_decpomdp = parseMadp(filename);
         if(madp_decpomdp == NULL) {
             return NULL;
@@ -663,28 +1203,77 @@ namespace synthesis {
         // std::cerr << madp_decpomdp->SoftPrint() << std::endl;
         std::unique_ptr<DecPomdp> decpomdp = std::make_unique<DecPomdp>(madp_decpomdp);
         free(madp_decpomdp);
+        if(content_hash != 0) {
+            decpomdp->saveToCache(cache_filename, content_hash);
+        }
         return decpomdp;
     }
 
-    
-    void DecPomdp::applyDiscountFactorTransformation() {
+    std::vector<std::unique_ptr<DecPomdp>> parseDecPomdpBatch(std::vector<std::string> const& filenames) {
+        std::vector<std::unique_ptr<DecPomdp>> models(filenames.size());
+
+        // models served by the binary cache skip the pipeline altogether
+        struct ParseJob {
+            uint64_t index;
+            uint64_t content_hash;
+            std::string cache_filename;
+        };
+        std::vector<ParseJob> jobs;
+        for(uint64_t index = 0; index < filenames.size(); index++) {
+            uint64_t content_hash = hashFileContents(filenames[index]);
+            std::string cache_filename = filenames[index] + ".paynt.bin";
+            if(content_hash != 0) {
+                auto cached = DecPomdp::loadFromCache(cache_filename, content_hash);
+                if(cached != NULL) {
+                    models[index] = std::move(cached);
+                    continue;
+                }
+            }
+            jobs.push_back(ParseJob{index, content_hash, std::move(cache_filename)});
+        }
 
-        if(this->discounted || this->discount_factor == 1) {
-            return;
+        // two-stage pipeline with a double-buffered hand-over slot: the parser thread reads
+        // the next file while this thread converts the current one; the MADP parser is not
+        // re-entrant, so at most one parse runs at a time
+        DecPOMDPDiscrete *parsed = NULL;
+        std::thread parser;
+        auto launchParse = [&](uint64_t job) {
+            parser = std::thread([&,job]() {
+                parsed = parseMadp(filenames[jobs[job].index]);
+            });
+        };
+        if(not jobs.empty()) {
+            launchParse(0);
         }
-        this->discount_sink_state = this->freshSink(this->discount_sink_label);
-        for(uint64_t state = 0; state < this->num_states(); state++) {
-            if(state == this->initial_state || state == this->discount_sink_state) {
-                // no discounting in the initial state because it selects the actual initial state
+        for(uint64_t job = 0; job < jobs.size(); job++) {
+            parser.join();
+            DecPOMDPDiscrete *madp_decpomdp = parsed;
+            parsed = NULL;
+            if(job+1 < jobs.size()) {
+                launchParse(job+1);
+            }
+            if(madp_decpomdp == NULL) {
                 continue;
             }
-            for(StormRow &row: this->transition_matrix[state]) {
-                for(auto &entry: row) {
-                    entry.second *= this->discount_factor;
-                }
-                row.push_back(std::make_pair(this->discount_sink_state,1-this->discount_factor));
+            auto decpomdp = std::make_unique<DecPomdp>(madp_decpomdp);
+            free(madp_decpomdp);
+            if(jobs[job].content_hash != 0) {
+                decpomdp->saveToCache(jobs[job].cache_filename, jobs[job].content_hash);
             }
+            models[jobs[job].index] = std::move(decpomdp);
         }
+        return models;
+    }
+
+
+    void DecPomdp::applyDiscountFactorTransformation() {
+
+        if(this->discounted || this->discount_factor == 1) {
+            return;
+        }
+        // only the sink itself is created here: the stored prototype rows stay untouched and
+        // the discounting is applied on the fly when the matrices are constructed
+        this->discount_sink_state = this->freshSink(this->discount_sink_label);
         this->discounted = true;
         this->computeAvailableActions();
         this->countSuccessors();
@@ -789,19 +1378,24 @@ namespace synthesis {
         this->row_prototype_state.clear();
         this->row_agent_memory.clear();
         uint64_t prototype_row = 0;
-        std::map<uint64_t, uint64_t> prototype_state_to_row;
-        
-        // TODO can simplify this: state (s,x) will have the same rows as state (s,0)
+        // state (s,x) has the same rows as state (s,0): the cartesian product over agent
+        // successor memories is computed once per prototype and replayed for its duplicates
+        std::map<uint64_t, std::pair<uint64_t,uint64_t>> prototype_state_to_block;
+
         for (uint64_t state = 0; state < this->num_quotient_states; state++) {
             this->row_groups[state] = this->row_prototype_state.size();
             auto prototype_state = this->state_prototype[state];
             auto joint_obs = this->state_joint_observation[prototype_state];
-            auto prototype_state_to_row_it = prototype_state_to_row.find(prototype_state);
-            if (prototype_state_to_row_it == prototype_state_to_row.end()) {
-                prototype_state_to_row.insert({prototype_state, prototype_row});
-            } else {
-                prototype_row = (*prototype_state_to_row_it).second;
+            auto block_it = prototype_state_to_block.find(prototype_state);
+            if (block_it != prototype_state_to_block.end()) {
+                for (uint64_t block_row = (*block_it).second.first; block_row < (*block_it).second.second; block_row++) {
+                    this->row_prototype_state.push_back(this->row_prototype_state[block_row]);
+                    this->row_prototype.push_back(this->row_prototype[block_row]);
+                    this->row_agent_memory.push_back(this->row_agent_memory[block_row]);
+                }
+                continue;
             }
+            uint64_t block_begin = this->row_prototype_state.size();
 
             std::vector<std::vector<uint64_t>> agent_max_successor_memories;
             std::vector<std::vector<uint64_t>::iterator> agent_memory_iterator;
@@ -842,6 +1436,7 @@ namespace synthesis {
                     agent_memory_iterator[agent] = agent_max_successor_memories[agent].begin();
                 }
             }
+            prototype_state_to_block.insert({prototype_state, {block_begin, this->row_prototype_state.size()}});
         }
         this->num_quotient_rows = this->row_prototype_state.size();
         this->row_groups[this->num_quotient_states] = this->num_quotient_rows;
@@ -23,6 +23,20 @@ namespace synthesis {
 
         DecPomdp(DecPOMDPDiscrete *model);
 
+        /**
+         * Load a model previously stored by \ref saveToCache.
+         * @param content_hash hash of the source file the cache must have been created from
+         * @return NULL if the cache is absent, damaged or was created from a different source
+         */
+        static std::unique_ptr<DecPomdp> loadFromCache(std::string const& cache_filename, uint64_t content_hash);
+
+        /**
+         * Serialize the collected model to a binary cache file so that subsequent runs skip
+         * both the MADP parse and the joint-space expansion. Failure to write is silent: the
+         * cache is only an accelerator.
+         */
+        void saveToCache(std::string const& cache_filename, uint64_t content_hash);
+
         /** Number of agents. */
         uint64_t num_agents;
         
@@ -87,6 +101,11 @@ namespace synthesis {
 
         double discount_factor;
 
+        /**
+         * Add the discount sink and mark the model as discounted. The stored prototype rows
+         * stay untouched: rows are scaled and the sink entries appended on the fly during
+         * matrix construction, so the transformation itself costs only the fresh sink.
+         */
         void applyDiscountFactorTransformation();
 
         void set_constraint_bound(double bound) {
@@ -167,6 +186,16 @@ namespace synthesis {
 
     private:
 
+        /** Construct an empty dec-POMDP to be filled from a binary cache. */
+        DecPomdp() = default;
+
+        /**
+         * Compute the components derived from the collected model (per-observation memory
+         * sizes, prototype row indices, available actions, observation successors). Called
+         * at the end of the construction from MADP as well as after a cache load.
+         */
+        void finalizeComponents();
+
         /**
          * Build the state space:
          * - compute total number of states (@num_states)
@@ -253,5 +282,15 @@ namespace synthesis {
      */
      std::unique_ptr<DecPomdp> parseDecPomdp(std::string filename);
 
+    /**
+     * Parse a batch of MADP files with a two-stage pipeline: a parser thread reads the next
+     * file while the current one is converted to the Storm-friendly representation, with a
+     * double-buffered hand-over slot in between. The MADP parser is not re-entrant, so the
+     * parse stage stays serialized; the conversion (and binary cache write) of each model is
+     * hidden behind the parse of the next one.
+     * @return for each file its model, or NULL on a parsing error
+     */
+    std::vector<std::unique_ptr<DecPomdp>> parseDecPomdpBatch(std::vector<std::string> const& filenames);
+
 } // namespace synthesis
 
@@ -6,9 +6,9 @@ void bindings_decpomdp(py::module& m) {
 
     py::class_<synthesis::DecPomdp>(m, "DecPomdp", "dec-POMDP")
         // .def(py::init<std::string const&>(), "constructor.", py::arg("filename"));
-        .def("construct_quotient_mdp", &synthesis::DecPomdp::constructQuotientMdp)
-        .def("construct_mdp", &synthesis::DecPomdp::constructMdp)
-        .def("construct_pomdp", &synthesis::DecPomdp::constructPomdp)
+        .def("construct_quotient_mdp", &synthesis::DecPomdp::constructQuotientMdp, py::call_guard<py::gil_scoped_release>())
+        .def("construct_mdp", &synthesis::DecPomdp::constructMdp, py::call_guard<py::gil_scoped_release>())
+        .def("construct_pomdp", &synthesis::DecPomdp::constructPomdp, py::call_guard<py::gil_scoped_release>())
         .def("set_agent_observation_memory_size", &synthesis::DecPomdp::setAgentObservationMemorySize, "Set memory size to a selected agent and its observation.", py::arg("agent"), py::arg("observation"), py::arg("memory_size"))
         .def("set_global_memory_size", &synthesis::DecPomdp::setGlobalMemorySize, py::arg("memory_size"))
         .def_property_readonly("num_agents", [](synthesis::DecPomdp& decpomdp) {return decpomdp.num_agents;})
@@ -47,6 +47,8 @@ void bindings_decpomdp(py::module& m) {
         .def_property_readonly("state_to_memory_joint_observation", [](synthesis::DecPomdp& decpomdp) {return decpomdp.state_to_memory_joint_observation;})
         ;
 
-    m.def("parse_decpomdp", &synthesis::parseDecPomdp,  py::arg("filename"));
+    m.def("parse_decpomdp", &synthesis::parseDecPomdp,  py::arg("filename"), py::call_guard<py::gil_scoped_release>());
+    m.def("parse_decpomdp_batch", &synthesis::parseDecPomdpBatch, py::arg("filenames"), py::call_guard<py::gil_scoped_release>(),
+        "parse a batch of files, overlapping the parse of each file with the conversion of the previous one");
 
 }
@@ -16,6 +16,9 @@
 #include "IndexTools.h"
 #include "Scope.h"
 
+#include <map>
+#include <mutex>
+
 using namespace std;
 
 bool IndexTools::Increment(Index& index, size_t nrElems)
@@ -365,6 +368,100 @@ size_t * IndexTools::CalculateStepSize(const vector<size_t>& nrElems, size_t n)
     return(step_size);
 }
 
+namespace {
+    /// Magic-number division: floor(n / d) computed as (magic(d) * n) >> 64.
+    /** Valid for any 32 bit n and d > 1 with magic(d) = ceil(2^64 / d),
+     * see Lemire et al., "Faster remainder by direct computation". */
+    inline Index MagicDivide(Index n, unsigned long long magic)
+    {
+        return((Index)(((unsigned __int128)magic * n) >> 64));
+    }
+}
+
+IndexTools::StepSizeTable::StepSizeTable(const vector<size_t>& nrElems)
+{
+    _m_stepSize = CalculateStepSizeVector(nrElems);
+    _m_magic.resize(_m_stepSize.size());
+    for(Index i = 0; i < _m_stepSize.size(); i++)
+    {
+        size_t step = _m_stepSize[i];
+        //ceil(2^64 / step); a step size of 1 is marked with 0 and
+        //special-cased in the conversions
+        _m_magic[i] = (step > 1) ? 0xFFFFFFFFFFFFFFFFull / step + 1 : 0;
+    }
+}
+
+void IndexTools::StepSizeTable::JointToIndividual(Index jointI,
+        vector<Index>& result) const
+{
+    size_t vec_size = _m_stepSize.size();
+    if(result.size() != vec_size)
+        result.resize(vec_size);
+    Index remainder = jointI;
+    for(Index i = 0; i < vec_size; i++)
+    {
+        Index aI = _m_magic[i] ?
+            MagicDivide(remainder, _m_magic[i]) : remainder;
+        result[i] = aI;
+        remainder -= aI * (Index)_m_stepSize[i];
+    }
+}
+
+Index IndexTools::StepSizeTable::IndividualToJoint(
+        const vector<Index>& indices) const
+{
+    size_t vec_size = _m_stepSize.size();
+    Index jointI = 0;
+    for(Index i = 0; i < vec_size; i++)
+        jointI += indices[i] * _m_stepSize[i];
+    return(jointI);
+}
+
+void IndexTools::StepSizeTable::JointToIndividual(const Index* jointIs,
+        size_t nrIndices, Index* result) const
+{
+    size_t vec_size = _m_stepSize.size();
+    for(size_t j = 0; j < nrIndices; j++)
+    {
+        Index remainder = jointIs[j];
+        for(Index i = 0; i < vec_size; i++)
+        {
+            Index aI = _m_magic[i] ?
+                MagicDivide(remainder, _m_magic[i]) : remainder;
+            result[j * vec_size + i] = aI;
+            remainder -= aI * (Index)_m_stepSize[i];
+        }
+    }
+}
+
+void IndexTools::StepSizeTable::IndividualToJoint(const Index* indices,
+        size_t nrIndices, Index* result) const
+{
+    size_t vec_size = _m_stepSize.size();
+    for(size_t j = 0; j < nrIndices; j++)
+    {
+        Index jointI = 0;
+        for(Index i = 0; i < vec_size; i++)
+            jointI += indices[j * vec_size + i] * _m_stepSize[i];
+        result[j] = jointI;
+    }
+}
+
+const IndexTools::StepSizeTable& IndexTools::GetStepSizeTable(
+        const vector<size_t>& nrElems)
+{
+    //map nodes are stable, so returned references survive later
+    //insertions; the mutex makes first use safe from worker threads
+    static map<vector<size_t>, StepSizeTable> tableCache;
+    static mutex tableMutex;
+    lock_guard<mutex> lock(tableMutex);
+    map<vector<size_t>, StepSizeTable>::iterator it = tableCache.find(nrElems);
+    if(it == tableCache.end())
+        it = tableCache.insert(make_pair(nrElems,
+                                         StepSizeTable(nrElems))).first;
+    return(it->second);
+}
+
 size_t IndexTools::CalculateNumberOfSequences(size_t o, size_t seqLength)
 {
     // sequences have length seqLength, 
@@ -109,12 +109,55 @@ namespace IndexTools {
      * the same size as nrElems).
      */
     std::vector<size_t> CalculateStepSizeVector(const std::vector<size_t>& nrElems);
-    /**\brief Calculates the step size array from the first n entries 
-     * of nrElems. 
+    /**\brief Calculates the step size array from the first n entries
+     * of nrElems.
      * (so the array's size is n).
      */
     size_t * CalculateStepSize(const std::vector<size_t>& nrElems, size_t n);
 
+    /// A cached mixed-radix conversion table for a fixed nrElems vector.
+    /** Stores the step size of each position together with a magic-number
+     * reciprocal of it, so the division/modulo chain of
+     * JointToIndividualIndices becomes a chain of multiply-shifts.
+     * Tables are constructed once per distinct nrElems vector, see
+     * GetStepSizeTable. */
+    class StepSizeTable
+    {
+    private:
+        std::vector<size_t> _m_stepSize;
+        /// Per position ceil(2^64 / stepSize): n / stepSize == (magic*n)>>64.
+        /** A magic number of 0 marks a step size of 1 (always the last
+         * position), whose reciprocal does not fit 64 bits; there the
+         * quotient simply equals the remainder. */
+        std::vector<unsigned long long> _m_magic;
+    public:
+        StepSizeTable(const std::vector<size_t>& nrElems);
+
+        size_t GetVectorSize() const { return(_m_stepSize.size()); }
+        const std::vector<size_t>& GetStepSizes() const
+            { return(_m_stepSize); }
+
+        /// Convert a joint index to individual indices without divisions.
+        void JointToIndividual(Index jointI, std::vector<Index>& result)
+            const;
+        /// Convert individual indices to their joint index.
+        Index IndividualToJoint(const std::vector<Index>& indices) const;
+        /// Batch variant: converts nrIndices joint indices in one call.
+        /** result must provide room for nrIndices*GetVectorSize() entries
+         * and is filled row by row. */
+        void JointToIndividual(const Index* jointIs, size_t nrIndices,
+                Index* result) const;
+        /// Batch variant: converts nrIndices individual index vectors
+        /// (stored row by row in indices) to joint indices in one call.
+        void IndividualToJoint(const Index* indices, size_t nrIndices,
+                Index* result) const;
+    };
+
+    /**\brief Returns the conversion table for nrElems, constructing and
+     * caching it on first use. The returned reference stays valid for the
+     * lifetime of the program. */
+    const StepSizeTable& GetStepSizeTable(const std::vector<size_t>& nrElems);
+
     // LIndex versions of all functions
 
     /// LIndex equivalent function.
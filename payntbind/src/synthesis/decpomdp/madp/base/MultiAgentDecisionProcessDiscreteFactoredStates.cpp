@@ -482,13 +482,22 @@ void MultiAgentDecisionProcessDiscreteFactoredStates::CacheFlatTransitionModel(b
 
 
     for(Index sI=0; sI<GetNrStates(); sI++)
+    {
+        vector<Index> X = StateIndexToFactorValueIndices(sI);
         for(Index jaI=0; jaI<GetNrJointActions(); jaI++)
+        {
+            vector<Index> A = JointToIndividualActionIndices(jaI);
+            //compute the whole row at once, so the scope restrictions of X
+            //and A are shared by all successor states
+            vector<double> probs = _m_2dbn.GetYProbabilities(X,A);
             for(Index sucsI=0; sucsI<GetNrStates(); sucsI++)
             {
-                double p = GetTransitionProbability(sI, jaI, sucsI);
-                if(! Globals::EqualProbability(p, 0) )                
+                double p = probs[sucsI];
+                if(! Globals::EqualProbability(p, 0) )
                     _m_p_tModel->Set(sI, jaI, sucsI, p);
             }
+        }
+    }
 
     _m_cached_FlatTM = true;
 }
@@ -529,27 +538,37 @@ void MultiAgentDecisionProcessDiscreteFactoredStates::CacheFlatObservationModel(
                                              GetNrJointObservations());
     }
     
-    for(Index sI=0; sI<GetNrStates(); sI++)
+    if(!_m_eventObservability)
     {
         for(Index jaI=0; jaI<GetNrJointActions(); jaI++)
+        {
+            vector<Index> A = JointToIndividualActionIndices(jaI);
             for(Index sucsI=0; sucsI<GetNrStates(); sucsI++)
+            {
+                vector<Index> Y = StateIndexToFactorValueIndices(sucsI);
+                //compute the whole row at once, so the scope restrictions of
+                //A and Y are shared by all joint observations
+                vector<double> probs = _m_2dbn.GetOProbabilities(A,Y);
                 for(Index joI=0; joI<GetNrJointObservations(); joI++)
                 {
-                    if(_m_eventObservability)
+                    double p = probs[joI];
+                    if(! Globals::EqualProbability(p, 0) )
+                        _m_p_oModel->Set(jaI, sucsI, joI, p);
+                }
+            }
+        }
+    }
+    else
+    {
+        for(Index sI=0; sI<GetNrStates(); sI++)
+            for(Index jaI=0; jaI<GetNrJointActions(); jaI++)
+                for(Index sucsI=0; sucsI<GetNrStates(); sucsI++)
+                    for(Index joI=0; joI<GetNrJointObservations(); joI++)
                     {
                         double p = GetObservationProbability(sI, jaI, sucsI, joI);
-                        if(! Globals::EqualProbability(p, 0) )                
+                        if(! Globals::EqualProbability(p, 0) )
                             _m_p_oModel->Set(sI, jaI, sucsI, joI, p);
                     }
-                    else
-                    {
-                        double p = GetObservationProbability(jaI, sucsI, joI);
-                        if(! Globals::EqualProbability(p, 0) )                
-                            _m_p_oModel->Set(jaI, sucsI, joI, p);
-                    }
-                }
-        if(!_m_eventObservability)
-            break;
     }
     _m_cached_FlatOM = true;
 }
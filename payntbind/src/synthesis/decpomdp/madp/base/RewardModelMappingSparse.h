@@ -65,6 +65,10 @@ public:
     double Get(Index s_i, Index ja_i) const
         { return(_m_R(s_i,ja_i)); }
 
+    /// Get a pointer to the reward matrix.
+    const SparseMatrix* GetMatrixPtr() const
+        { return(&_m_R); }
+
     //data manipulation funtions:
     /// Sets R(s_i,ja_i)
     /** Index ja_i, Index s_i, are indices of the state and taken
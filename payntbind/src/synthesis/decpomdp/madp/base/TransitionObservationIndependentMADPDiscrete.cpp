@@ -51,6 +51,7 @@ TransitionObservationIndependentMADPDiscrete(
     _m_nrJointObservations=0;
     _m_p_tModel = 0;
     _m_p_oModel = 0;
+    _m_stateIndexTable = 0;
     // these are pointers to get around the const-ness of their Get functions
     _m_jointStatesMap=new map<vector<Index>, State*>;
     _m_indivStateIndicesMap = new map< Index, vector<Index> >;
@@ -617,6 +618,7 @@ bool TransitionObservationIndependentMADPDiscrete::SetInitialized(bool b)
         _m_actionStepSize=IndexTools::CalculateStepSizeVector(_m_nrIndivActions);
         _m_observationStepSize=IndexTools::CalculateStepSizeVector(_m_nrIndivObs);
         _m_stateStepSize=IndexTools::CalculateStepSizeVector(_m_nrIndivStates);
+        _m_stateIndexTable=&IndexTools::GetStepSizeTable(_m_nrIndivStates);
 
         _m_initialized = b;
 
@@ -801,15 +803,19 @@ GetTransitionProbability(Index sI,
     double p=1;
     if(!_m_jointModelsGenerated)
     {
-        vector<Index> sIs=JointToIndividualStateIndices(sI),
-            sucSIs=JointToIndividualStateIndices(sucSI);
+        //translate both joint state indices in one batch through the
+        //cached mixed-radix table, bypassing the memo map
+        size_t nrAg=GetNrAgents();
+        Index jointSIs[2]={sI,sucSI};
+        Index indivSIs[2*nrAg];
+        _m_stateIndexTable->JointToIndividual(jointSIs,2,indivSIs);
         vector<Index> aIs=JointToIndividualActionIndices(jaI);
-        for(Index agI = 0; agI < GetNrAgents(); agI++)
+        for(Index agI = 0; agI < nrAg; agI++)
         {
             p*=GetIndividualMADPD(agI)->GetTransitionProbability(
-                sIs[agI],
+                indivSIs[agI],
                 aIs[agI],
-                sucSIs[agI]);
+                indivSIs[nrAg+agI]);
             if(p==0)
                 break;
         }
@@ -28,6 +28,7 @@
 #include "OGet.h"
 #include <map>
 #include "StateDistributionVector.h"
+#include "IndexTools.h"
 
 /** 
  * \brief TransitionObservationIndependentMADPDiscrete is an base class that 
@@ -79,6 +80,9 @@ private:
     std::vector<size_t> _m_actionStepSize;
     std::vector<size_t> _m_observationStepSize;
     std::vector<size_t> _m_stateStepSize;
+    /**The cached mixed-radix table for joint state index conversions,
+     * owned by IndexTools::GetStepSizeTable. */
+    const IndexTools::StepSizeTable* _m_stateIndexTable;
 
     /**Vector that stores the number of individual states. (Created by
      * CreateJointStates() )*/
@@ -311,8 +315,8 @@ public:
                 return(_m_indivStateIndicesMap->find(jointSI)->second);
             else
             {
-                std::vector<Index> ind_sI=
-                    IndexTools::JointToIndividualIndicesStepSize(jointSI,_m_stateStepSize);
+                std::vector<Index> ind_sI;
+                _m_stateIndexTable->JointToIndividual(jointSI,ind_sI);
                 _m_indivStateIndicesMap->insert(make_pair(jointSI,ind_sI));
                 return(_m_indivStateIndicesMap->find(jointSI)->second);
             }
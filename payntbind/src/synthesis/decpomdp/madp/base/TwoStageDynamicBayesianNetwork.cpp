@@ -231,8 +231,54 @@ GetYProbability( const vector<Index>& X,
     return(p);
 }
 
+vector<double> TwoStageDynamicBayesianNetwork::
+GetYProbabilities( const vector<Index>& X,
+                    const vector<Index>& A) const
+{
+    size_t nrSF = _m_madp->GetNrStateFactors();
+    if(X.size() != nrSF)
+        throw E("TwoStageDynamicBayesianNetwork::GetYProbabilities only implemented for full state vectors");
+    if(A.size() != _m_madp->GetNrAgents())
+        throw E("TwoStageDynamicBayesianNetwork::GetYProbabilities only implemented for full joint actions");
+
+    //the X and A restrictions do not depend on Y: compute them once per CPT
+    vector<vector<Index> > X_restr(nrSF);
+    vector<vector<Index> > A_restr(nrSF);
+    for(Index y=0; y < nrSF; y++)
+    {
+        X_restr[y].resize(GetXSoI_Y(y).size());
+        IndexTools::RestrictIndividualIndicesToScope(X, GetXSoI_Y(y), X_restr[y] );
+        A_restr[y].resize(GetASoI_Y(y).size());
+        IndexTools::RestrictIndividualIndicesToScope(A, GetASoI_Y(y), A_restr[y] );
+    }
+
+    const vector<size_t>& nrValsPerFactor = _m_madp->GetNrValuesPerFactor();
+    size_t nrY = 1;
+    for(Index y=0; y < nrSF; y++)
+        nrY *= nrValsPerFactor[y];
+
+    //enumerate the joint NS states in flat-index order
+    vector<double> probs(nrY, 0.0);
+    vector<Index> Y(nrSF, 0);
+    Index YI = 0;
+    do {
+        double p = 1.0;
+        for(Index y=0; y < nrSF; y++)
+        {
+            vector<Index> Y_restr(GetYSoI_Y(y).size());
+            IndexTools::RestrictIndividualIndicesToScope(Y, GetYSoI_Y(y), Y_restr );
+            Index iiI = IndividualToJointYiiIndices(y, X_restr[y], A_restr[y], Y_restr);
+            p *= _m_Y_CPDs[y]->Get(Y[y], iiI);
+            if(p == 0.0)
+                break;
+        }
+        probs[YI++] = p;
+    } while(! IndexTools::Increment( Y, nrValsPerFactor ) );
+    return(probs);
+}
+
 double TwoStageDynamicBayesianNetwork::
-GetYProbabilityGeneral( 
+GetYProbabilityGeneral(
                     const Scope& Xscope,
                     const vector<Index>& X,
                     const Scope& Ascope,
@@ -350,8 +396,59 @@ GetOProbability( const vector<Index>& A,
     }
     return(p);
 }
+vector<double> TwoStageDynamicBayesianNetwork::
+GetOProbabilities( const vector<Index>& A,
+                    const vector<Index>& Y) const
+{
+    size_t nrAgents = _m_madp->GetNrAgents();
+    if(A.size() != nrAgents)
+        throw E("TwoStageDynamicBayesianNetwork::GetOProbabilities only implemented for full joint actions");
+
+    //the A and Y restrictions do not depend on O: compute them once per CPT
+    vector<vector<Index> > A_restr(nrAgents);
+    vector<vector<Index> > Y_restr(nrAgents);
+    vector<size_t> nrObs(nrAgents);
+    for(Index o=0; o < nrAgents; o++)
+    {
+        if(GetXSoI_O(o).size() > 0)
+        {
+          stringstream errormsg;
+          errormsg << "Observation Factor " << o << " has a non-null PS SF scope, which was ignored.";
+          throw E(errormsg.str());
+        }
+        A_restr[o].resize(GetASoI_O(o).size());
+        IndexTools::RestrictIndividualIndicesToScope(A, GetASoI_O(o), A_restr[o] );
+        Y_restr[o].resize(GetYSoI_O(o).size());
+        IndexTools::RestrictIndividualIndicesToScope(Y, GetYSoI_O(o), Y_restr[o] );
+        nrObs[o] = _m_madp->GetNrObservations(o);
+    }
+
+    size_t nrJO = 1;
+    for(Index o=0; o < nrAgents; o++)
+        nrJO *= nrObs[o];
+
+    //enumerate the joint observations in flat-index order
+    vector<double> probs(nrJO, 0.0);
+    vector<Index> O(nrAgents, 0);
+    Index OI = 0;
+    do {
+        double p = 1.0;
+        for(Index o=0; o < nrAgents; o++)
+        {
+            vector<Index> O_restr(GetOSoI_O(o).size());
+            IndexTools::RestrictIndividualIndicesToScope(O, GetOSoI_O(o), O_restr );
+            Index iiI = IndividualToJointOiiIndices(o, A_restr[o], Y_restr[o], O_restr);
+            p *= _m_O_CPDs[o]->Get(O[o], iiI);
+            if(p == 0.0)
+                break;
+        }
+        probs[OI++] = p;
+    } while(! IndexTools::Increment( O, nrObs ) );
+    return(probs);
+}
+
 double TwoStageDynamicBayesianNetwork::
-GetOProbability( const vector<Index>& X, 
+GetOProbability( const vector<Index>& X,
                  const vector<Index>& A,
                     const vector<Index>& Y,
                     const vector<Index>& O) const
@@ -380,6 +380,14 @@ class TwoStageDynamicBayesianNetwork
         double GetYProbability( const std::vector<Index>& X,
                                 const std::vector<Index>& A,
                                 const std::vector<Index>& Y) const;
+        ///Get the probabilities of all joint NS states Y given X,A.
+        /**Returns a vector indexed by the flat joint index of Y. The X and A
+         * scope restrictions of each CPT are computed only once and shared by
+         * all Y, so this is much cheaper than querying GetYProbability for
+         * each Y separately (e.g., when flattening the model).
+         */
+        std::vector<double> GetYProbabilities( const std::vector<Index>& X,
+                                const std::vector<Index>& A) const;
         ///Get the probability of Y given X,A. general version
         /**We need to discriminate between 
          * \li  Y, the vector of next-stage state variables 
@@ -430,6 +438,13 @@ class TwoStageDynamicBayesianNetwork
         double GetOProbability( const std::vector<Index>& A,
                                 const std::vector<Index>& Y,
                                 const std::vector<Index>& O) const;
+        ///Get the probabilities of all joint observations O given A,Y.
+        /**Returns a vector indexed by the flat joint observation index. The A
+         * and Y scope restrictions of each CPT are computed only once and
+         * shared by all O (cf. GetYProbabilities).
+         */
+        std::vector<double> GetOProbabilities( const std::vector<Index>& A,
+                                const std::vector<Index>& Y) const;
         double GetOProbability( const std::vector<Index>& X,
                                 const std::vector<Index>& A,
                                 const std::vector<Index>& Y,
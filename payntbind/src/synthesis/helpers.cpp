@@ -1,4 +1,11 @@
 #include "synthesis.h"
+#include "BitVectorPool.h"
+#include "CancellationToken.h"
+#include "Trace.h"
+
+#include <pybind11/numpy.h>
+
+#include <algorithm>
 
 #include <storm/adapters/RationalNumberAdapter.h>
 #include <storm/logic/Formula.h>
@@ -16,6 +23,12 @@
 #include <storm/models/sparse/Model.h>
 
 #include <storm/storage/jani/TemplateEdge.h>
+#include <storm/modelchecker/results/ExplicitQuantitativeCheckResult.h>
+
+#include "verification/MdpModelChecker.h"
+#include "verification/QuantizedQuotientChecker.h"
+#include "verification/SchedulerRegistry.h"
+#include "verification/CheckResultCache.h"
 
 namespace synthesis {
 
@@ -62,6 +75,14 @@ void define_helpers(py::module& m) {
 
     m.def("set_loglevel_off", []() { storm::utility::setLogLevel(l3pp::LogLevel::OFF); }, "set loglevel for storm to off");
 
+    m.def("trace_report", &synthesis::trace::report, "aggregate the hot-path trace counters of all threads into a JSON string");
+    m.def("trace_reset", &synthesis::trace::reset, "zero the hot-path trace counters");
+
+    m.def("bitvector_pool_stats", []() {
+        auto const& pool = synthesis::bitVectorPool();
+        return std::make_pair(pool.numPooled(),pool.numAcquired());
+    }, "number of pooled and lifetime-acquired mask buffers of the native mask pool");
+
     m.def("set_precision_native", [](storm::NativeSolverEnvironment& nsenv, double value) {
         nsenv.setPrecision(storm::utility::convertNumber<storm::RationalNumber>(value));
     });
@@ -77,14 +98,188 @@ void define_helpers(py::module& m) {
         std::vector<double> result(matrix.getRowCount());
         matrix.multiplyWithVector(vector, result);
         return result;
-    }, py::arg("matrix"), py::arg("vector"));
+    }, py::arg("matrix"), py::arg("vector"), py::call_guard<py::gil_scoped_release>());
 
     m.def("multiply_with_vector_exact", [] (storm::storage::SparseMatrix<storm::RationalNumber> matrix,std::vector<storm::RationalNumber> vector) {
         std::vector<storm::RationalNumber> result(matrix.getRowCount());
         matrix.multiplyWithVector(vector, result);
         return result;
-    }, py::arg("matrix"), py::arg("vector"));
+    }, py::arg("matrix"), py::arg("vector"), py::call_guard<py::gil_scoped_release>());
 
     m.def("janiTemplateEdgeAddAssignments", &synthesis::janiTemplateEdgeAddAssignments, py::arg("template_edge"), py::arg("assignments"));
+
+    m.def("store_result_vector", [](storm::modelchecker::ExplicitQuantitativeCheckResult<double> const& result) {
+        return synthesis::storeResultVector<double>(std::vector<double>(result.getValueVector()));
+    }, py::arg("result"), "register a result vector for warm-started model checking, returns its id");
+    m.def("drop_result_vector", &synthesis::dropResultVector<double>, py::arg("vector_id"));
+    m.def("verify_mdp_warm", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp, storm::logic::Formula const& formula, bool produce_schedulers, uint64_t initial_values_id) {
+        return synthesis::verifyMdp<double>(env, mdp, formula, produce_schedulers, initial_values_id);
+    }, py::arg("env"), py::arg("mdp"), py::arg("formula"), py::arg("produce_schedulers"), py::arg("initial_values_id"), py::call_guard<py::gil_scoped_release>());
+
+    m.def("verify_mdp_bidirectional", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp, storm::logic::Formula const& formula) {
+        return synthesis::verifyMdpBidirectional<double>(env, mdp, formula);
+    }, py::arg("env"), py::arg("mdp"), py::arg("formula"),
+        "check both optimization directions in one fused sweep, returns (minimizing result, maximizing result)",
+        py::call_guard<py::gil_scoped_release>());
+    m.def("verify_mdp_bidirectional_exact", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& mdp, storm::logic::Formula const& formula) {
+        return synthesis::verifyMdpBidirectional<storm::RationalNumber>(env, mdp, formula);
+    }, py::arg("env"), py::arg("mdp"), py::arg("formula"),
+        "check both optimization directions in one fused sweep, returns (minimizing result, maximizing result)",
+        py::call_guard<py::gil_scoped_release>());
+
+    m.def("verify_mdp_budgeted", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp, storm::logic::Formula const& formula, uint64_t max_iterations) {
+        return synthesis::verifyMdpBudgeted<double>(env, mdp, formula, max_iterations);
+    }, py::arg("env"), py::arg("mdp"), py::arg("formula"), py::arg("max_iterations"),
+        "budgeted interval-iteration check, returns the bound on the optimistic side and whether it converged",
+        py::call_guard<py::gil_scoped_release>());
+    m.def("verify_mdp_budgeted_exact", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& mdp, storm::logic::Formula const& formula, uint64_t max_iterations) {
+        return synthesis::verifyMdpBudgeted<storm::RationalNumber>(env, mdp, formula, max_iterations);
+    }, py::arg("env"), py::arg("mdp"), py::arg("formula"), py::arg("max_iterations"),
+        "budgeted interval-iteration check, returns the bound on the optimistic side and whether it converged",
+        py::call_guard<py::gil_scoped_release>());
+
+    m.def("verify_restricted_mdp_qualitative", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp, storm::storage::BitVector const& choice_mask, storm::logic::Formula const& formula) {
+        return synthesis::verifyRestrictedMdpQualitative<double>(env, quotient_mdp, choice_mask, formula);
+    }, py::arg("env"), py::arg("quotient_mdp"), py::arg("choice_mask"), py::arg("formula"),
+        "graph-based qualitative check of the restricted quotient, returns the (prob0, prob1) state sets",
+        py::call_guard<py::gil_scoped_release>());
+
+    m.def("verify_restricted_mdp_reward_bounded", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp, storm::storage::BitVector const& choice_mask, storm::logic::Formula const& formula, std::string const& reward_model_name, uint64_t reward_bound) {
+        return synthesis::verifyRestrictedMdpRewardBounded<double>(env, quotient_mdp, choice_mask, formula, reward_model_name, reward_bound);
+    }, py::arg("env"), py::arg("quotient_mdp"), py::arg("choice_mask"), py::arg("formula"), py::arg("reward_model_name"), py::arg("reward_bound"),
+        "reward-bounded reachability on the restricted quotient via epoch sweeps, without unfolding the bound",
+        py::call_guard<py::gil_scoped_release>());
+    m.def("verify_restricted_mdp_reward_bounded_exact", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& quotient_mdp, storm::storage::BitVector const& choice_mask, storm::logic::Formula const& formula, std::string const& reward_model_name, uint64_t reward_bound) {
+        return synthesis::verifyRestrictedMdpRewardBounded<storm::RationalNumber>(env, quotient_mdp, choice_mask, formula, reward_model_name, reward_bound);
+    }, py::arg("env"), py::arg("quotient_mdp"), py::arg("choice_mask"), py::arg("formula"), py::arg("reward_model_name"), py::arg("reward_bound"),
+        "reward-bounded reachability on the restricted quotient via epoch sweeps, without unfolding the bound",
+        py::call_guard<py::gil_scoped_release>());
+
+    py::class_<synthesis::QuantizedQuotientChecker<double>>(m, "QuantizedQuotientChecker",
+        "Threshold checking of restricted quotients over a float32 shadow of the transition matrix, "
+        "with transparent promotion to double precision for bounds close to the threshold.")
+        .def(py::init<storm::Environment const&, std::shared_ptr<storm::models::sparse::Mdp<double>> const&, storm::logic::Formula const&>(),
+            py::arg("env"), py::arg("quotient_mdp"), py::arg("formula"), py::call_guard<py::gil_scoped_release>())
+        .def("check_threshold", &synthesis::QuantizedQuotientChecker<double>::checkThreshold,
+            py::arg("choice_mask"), py::arg("threshold"), py::arg("decide_below"), py::arg("max_iterations"),
+            py::call_guard<py::gil_scoped_release>(),
+            "decide the restricted quotient against the threshold, returns the initial-state bound and whether the decision was reached")
+        .def_property_readonly("num_checks", &synthesis::QuantizedQuotientChecker<double>::numChecks)
+        .def_property_readonly("num_promotions", &synthesis::QuantizedQuotientChecker<double>::numPromotions);
+
+    m.def("compute_expected_visits", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp, storm::storage::BitVector const& scheduler_choices) {
+        auto* visits = new std::vector<double>(synthesis::computeExpectedVisits<double>(env, mdp, scheduler_choices));
+        // hand the vector to the array as its base, so the counts cross into python without a copy
+        py::capsule base(visits, [](void* ptr) { delete reinterpret_cast<std::vector<double>*>(ptr); });
+        return py::array_t<double>({visits->size()}, {sizeof(double)}, visits->data(), base);
+    }, py::arg("env"), py::arg("mdp"), py::arg("scheduler_choices"),
+        "expected state-visit counts under the given memoryless scheduler");
+    m.def("compute_expected_visits_exact", &synthesis::computeExpectedVisits<storm::RationalNumber>,
+        py::arg("env"), py::arg("mdp"), py::arg("scheduler_choices"), py::call_guard<py::gil_scoped_release>(),
+        "expected state-visit counts under the given memoryless scheduler");
+
+    // result views: paynt typically reads one initial-state value plus an argmax, so these
+    // accessors avoid copying the full value vector into python on every check
+    m.def("result_at", [](storm::modelchecker::ExplicitQuantitativeCheckResult<double> const& result, uint64_t state) {
+        return result[state];
+    }, py::arg("result"), py::arg("state"));
+    m.def("result_at_exact", [](storm::modelchecker::ExplicitQuantitativeCheckResult<storm::RationalNumber> const& result, uint64_t state) {
+        return result[state];
+    }, py::arg("result"), py::arg("state"));
+    m.def("result_extrema", [](storm::modelchecker::ExplicitQuantitativeCheckResult<double> const& result) {
+        auto const& values = result.getValueVector();
+        auto minmax = std::minmax_element(values.begin(), values.end());
+        uint64_t argmin = std::distance(values.begin(), minmax.first);
+        uint64_t argmax = std::distance(values.begin(), minmax.second);
+        return std::make_tuple(*minmax.first, argmin, *minmax.second, argmax);
+    }, py::arg("result"), "returns (min value, argmin state, max value, argmax state)", py::call_guard<py::gil_scoped_release>());
+    // bulk scheduler extraction: python previously walked the scheduler object state by state,
+    // which takes seconds on large models; these pack the selection into one array natively
+    m.def("scheduler_to_choice_array", [](storm::storage::Scheduler<double> const& scheduler, std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp) {
+        auto const& row_group_indices = mdp->getTransitionMatrix().getRowGroupIndices();
+        uint64_t state_count = mdp->getNumberOfStates();
+        auto* choices = new std::vector<uint64_t>(state_count);
+        for(uint64_t state = 0; state < state_count; state++) {
+            auto const& choice = scheduler.getChoice(state);
+            (*choices)[state] = row_group_indices[state] + (choice.isDefined() ? choice.getDeterministicChoice() : 0);
+        }
+        py::capsule base(choices, [](void* ptr) { delete reinterpret_cast<std::vector<uint64_t>*>(ptr); });
+        return py::array_t<uint64_t>({choices->size()}, {sizeof(uint64_t)}, choices->data(), base);
+    }, py::arg("scheduler"), py::arg("mdp"),
+        "the global choice index selected in every state, as a packed array; undefined states take their first choice");
+    m.def("choice_array_to_mask", [](py::array_t<uint64_t> const& state_to_choice, uint64_t num_choices) {
+        storm::storage::BitVector mask(num_choices, false);
+        auto choices = state_to_choice.unchecked<1>();
+        for(py::ssize_t state = 0; state < choices.shape(0); state++) {
+            mask.set(choices(state));
+        }
+        return mask;
+    }, py::arg("state_to_choice"), py::arg("num_choices"),
+        "the choice mask enabling exactly the given global choice indices");
+
+    m.def("result_values_view", [](py::object result) {
+        auto const& values = result.cast<storm::modelchecker::ExplicitQuantitativeCheckResult<double> const&>().getValueVector();
+        // the result object becomes the base of the array, keeping the vector alive; no copy is made
+        return py::array_t<double>({values.size()}, {sizeof(double)}, values.data(), result);
+    }, py::arg("result"), "zero-copy numpy view of the value vector, valid as long as the result is alive");
+
+    m.def("verify_policy_tree_leaves", [](storm::Environment const& env, std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp, std::vector<uint64_t> const& choice_to_action, synthesis::SchedulerRegistry const& registry, std::vector<storm::storage::BitVector> const& family_choices, std::vector<uint64_t> const& policy_handles, storm::logic::Formula const& formula, double threshold, bool threshold_is_upper_bound) {
+        return synthesis::verifyPolicyTreeLeaves<double>(env, quotient_mdp, choice_to_action, registry, family_choices, policy_handles, formula, threshold, threshold_is_upper_bound);
+    }, py::arg("env"), py::arg("quotient_mdp"), py::arg("choice_to_action"), py::arg("registry"), py::arg("family_choices"), py::arg("policy_handles"), py::arg("formula"), py::arg("threshold"), py::arg("threshold_is_upper_bound"),
+        "re-verify leaf policies of a policy tree in one parallel sweep, returns a sat mask and the values",
+        py::call_guard<py::gil_scoped_release>());
+
+    py::class_<synthesis::SchedulerRegistry>(m, "SchedulerRegistry", "Deduplicating storage for memoryless policies, accessed via integer handles.")
+        .def(py::init<>())
+        .def_readonly_static("UNDEFINED_ACTION", &synthesis::SchedulerRegistry::UNDEFINED_ACTION)
+        .def("insert_policy", &synthesis::SchedulerRegistry::insertPolicy, py::arg("policy"), "store a policy, returns its handle; identical policies share a handle")
+        .def("insert_scheduler", &synthesis::SchedulerRegistry::insertScheduler, py::arg("scheduler"), "store the deterministic choices of a scheduler, returns the handle")
+        .def("get_policy", &synthesis::SchedulerRegistry::getPolicy, py::arg("handle"))
+        .def("num_policies", &synthesis::SchedulerRegistry::numPolicies)
+        .def("policies_are_compatible", &synthesis::SchedulerRegistry::policiesAreCompatible, py::arg("handle1"), py::arg("handle2"), "whether two policies agree on every state where both are defined")
+        .def("merge_policies", &synthesis::SchedulerRegistry::mergePolicies, py::arg("handle1"), py::arg("handle2"), "merge two compatible policies into their union, returns the handle")
+        .def("merge_policies_exclusively", &synthesis::SchedulerRegistry::mergePoliciesExclusively, py::arg("handle1"), py::arg("handle2"), "fill the undefined states of each policy with the choices of the other, returns both handles");
+
+    py::class_<synthesis::CheckResultCache<double>>(m, "CheckResultCache", "Bounded cache for initial-state check results, keyed by (quotient id, mask fingerprint, formula id).")
+        .def(py::init<uint64_t>(), py::arg("capacity") = 1 << 16)
+        .def_readonly_static("NO_SCHEDULER", &synthesis::CheckResultCache<double>::NO_SCHEDULER)
+        .def_static("mask_fingerprint", &synthesis::CheckResultCache<double>::maskFingerprint, py::arg("mask"), "64-bit fingerprint of a choice mask", py::call_guard<py::gil_scoped_release>())
+        .def("lookup", [](synthesis::CheckResultCache<double>& cache, uint64_t quotient_id, uint64_t mask_fingerprint, uint64_t formula_id) -> py::object {
+            double value;
+            uint64_t scheduler_handle;
+            if(not cache.lookup(quotient_id, mask_fingerprint, formula_id, value, scheduler_handle)) {
+                return py::none();
+            }
+            if(scheduler_handle == synthesis::CheckResultCache<double>::NO_SCHEDULER) {
+                return py::make_tuple(value, py::none());
+            }
+            return py::make_tuple(value, scheduler_handle);
+        }, py::arg("quotient_id"), py::arg("mask_fingerprint"), py::arg("formula_id"),
+            "returns (initial-state value, scheduler handle or None) of a previous identical check, or None on a miss")
+        .def("insert", &synthesis::CheckResultCache<double>::insert,
+            py::arg("quotient_id"), py::arg("mask_fingerprint"), py::arg("formula_id"), py::arg("value"),
+            py::arg("scheduler_handle") = synthesis::CheckResultCache<double>::NO_SCHEDULER,
+            "store a check result, evicting the oldest entry when the cache is full")
+        .def("clear", &synthesis::CheckResultCache<double>::clear)
+        .def_property_readonly("size", &synthesis::CheckResultCache<double>::size)
+        .def_property_readonly("num_lookups", &synthesis::CheckResultCache<double>::numLookups)
+        .def_property_readonly("num_hits", &synthesis::CheckResultCache<double>::numHits);
+
+    py::class_<synthesis::CancellationToken, std::shared_ptr<synthesis::CancellationToken>>(m, "CancellationToken",
+        "Cooperative cancellation for long-running native calls, polled at iteration granularity.")
+        .def(py::init<>())
+        .def("cancel", &synthesis::CancellationToken::cancel, "raise the cancellation flag")
+        .def("set_deadline", &synthesis::CancellationToken::setDeadline, py::arg("seconds"), "cancel automatically once the given number of seconds has elapsed from now")
+        .def("clear_deadline", &synthesis::CancellationToken::clearDeadline)
+        .def("reset", &synthesis::CancellationToken::reset, "lower the flag and remove the deadline so the token can guard another call")
+        .def_property_readonly("cancelled", &synthesis::CancellationToken::isCancelled)
+        .def("set_progress_callback", [](synthesis::CancellationToken& token, py::function callback, uint64_t stride) {
+            // the callback is invoked from native threads with the GIL released
+            token.setProgressCallback([callback](uint64_t iteration, double bound) {
+                py::gil_scoped_acquire guard;
+                callback(iteration,bound);
+            }, stride);
+        }, py::arg("callback"), py::arg("stride") = 1,
+            "attach a progress callback invoked with (iterations done, current bound) every stride iterations");
 }
 
@@ -0,0 +1,103 @@
+#include "ObservationStacking.h"
+
+#include "src/synthesis/translation/componentTranslations.h"
+
+#include <storm/adapters/RationalNumberAdapter.h>
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/storage/BitVector.h>
+
+#include <algorithm>
+#include <map>
+
+namespace synthesis {
+
+template<typename ValueType>
+std::pair<std::shared_ptr<storm::models::sparse::Pomdp<ValueType>>,std::vector<uint64_t>> stackObservations(
+    storm::models::sparse::Pomdp<ValueType> const& pomdp,
+    std::vector<uint32_t> const& state_to_obs_class,
+    uint64_t history_length
+) {
+    STORM_LOG_THROW(history_length >= 1, storm::exceptions::InvalidArgumentException,
+        "history length must be positive");
+    STORM_LOG_THROW(state_to_obs_class.size() == pomdp.getNumberOfStates(), storm::exceptions::InvalidArgumentException,
+        "expected an observation class per state");
+    auto const& matrix = pomdp.getTransitionMatrix();
+    std::vector<uint64_t> const& row_groups = matrix.getRowGroupIndices();
+    uint64_t initial_state = *pomdp.getInitialStates().begin();
+
+    // histories are interned on first sight, so only reachable ones occupy an observation class
+    std::map<std::vector<uint32_t>,uint64_t> history_to_class;
+    // stacked states, indexed in discovery order
+    std::map<std::pair<uint64_t,uint64_t>,uint64_t> stacked_index;
+    std::vector<uint64_t> stacked_to_state;
+    std::vector<std::vector<uint32_t>> stacked_history;
+    std::vector<uint32_t> stacked_obs;
+    auto addStackedState = [&](uint64_t state, std::vector<uint32_t> history) {
+        auto [history_entry,history_inserted] = history_to_class.try_emplace(history,history_to_class.size());
+        uint64_t history_class = history_entry->second;
+        auto [entry,inserted] = stacked_index.try_emplace(std::make_pair(state,history_class),stacked_to_state.size());
+        if(inserted) {
+            stacked_to_state.push_back(state);
+            stacked_history.push_back(std::move(history));
+            stacked_obs.push_back((uint32_t)history_class);
+        }
+        return entry->second;
+    };
+    addStackedState(initial_state,{state_to_obs_class[initial_state]});
+
+    // explore reachable stacked states in discovery order, building the rows along the way
+    storm::storage::SparseMatrixBuilder<ValueType> builder(0,0,0,false,true,0);
+    std::vector<uint64_t> new_to_old_choice;
+    std::vector<std::pair<uint64_t,ValueType>> row_entries;
+    uint64_t stacked_choice = 0;
+    for(uint64_t stacked_state = 0; stacked_state < stacked_to_state.size(); ++stacked_state) {
+        builder.newRowGroup(stacked_choice);
+        uint64_t state = stacked_to_state[stacked_state];
+        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+            row_entries.clear();
+            for(auto const& entry: matrix.getRow(choice)) {
+                uint64_t successor = entry.getColumn();
+                // append the successor class, keeping the last history_length classes
+                std::vector<uint32_t> successor_history = stacked_history[stacked_state];
+                if(successor_history.size() == history_length) {
+                    successor_history.erase(successor_history.begin());
+                }
+                successor_history.push_back(state_to_obs_class[successor]);
+                uint64_t stacked_successor = addStackedState(successor,std::move(successor_history));
+                row_entries.emplace_back(stacked_successor,entry.getValue());
+            }
+            std::sort(row_entries.begin(),row_entries.end());
+            for(auto const& [column,value]: row_entries) {
+                builder.addNextValue(stacked_choice,column,value);
+            }
+            new_to_old_choice.push_back(choice);
+            ++stacked_choice;
+        }
+    }
+
+    uint64_t num_stacked_choices = new_to_old_choice.size();
+    storm::storage::sparse::ModelComponents<ValueType> components;
+    components.transitionMatrix = builder.build();
+    components.stateLabeling = translateStateLabeling(pomdp,stacked_to_state,0);
+    storm::storage::BitVector choice_mask(num_stacked_choices,true);
+    if(pomdp.hasChoiceLabeling()) {
+        components.choiceLabeling = translateChoiceLabeling(pomdp,new_to_old_choice,choice_mask);
+    }
+    components.rewardModels = translateRewardModels(pomdp,new_to_old_choice,choice_mask);
+    components.observabilityClasses = std::move(stacked_obs);
+    auto stacked = std::make_shared<storm::models::sparse::Pomdp<ValueType>>(std::move(components));
+    return std::make_pair(stacked,std::move(stacked_to_state));
+}
+
+template std::pair<std::shared_ptr<storm::models::sparse::Pomdp<double>>,std::vector<uint64_t>> stackObservations<double>(
+    storm::models::sparse::Pomdp<double> const& pomdp,
+    std::vector<uint32_t> const& state_to_obs_class,
+    uint64_t history_length
+);
+template std::pair<std::shared_ptr<storm::models::sparse::Pomdp<storm::RationalNumber>>,std::vector<uint64_t>> stackObservations<storm::RationalNumber>(
+    storm::models::sparse::Pomdp<storm::RationalNumber> const& pomdp,
+    std::vector<uint32_t> const& state_to_obs_class,
+    uint64_t history_length
+);
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <storm/models/sparse/Pomdp.h>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Build the observation-stacked POMDP for finite-history synthesis: each state of the result is
+ * an original state annotated with the sequence of the last (up to) \p history_length observation
+ * classes seen along the run, and its observation is the (interned) history itself. Only
+ * reachable (state,history) pairs are explored, so unreachable histories occupy no state and no
+ * observation class. State labeling, choice labeling and reward models carry over from the
+ * original model, making the result directly consumable by the unfolding/coloring pipeline.
+ * @param pomdp the POMDP to stack
+ * @param state_to_obs_class for each state, its observation class (e.g. from ObservationEvaluator)
+ * @param history_length number of observation classes remembered, at least 1
+ * @return the stacked POMDP and for each of its states the original state
+ */
+template<typename ValueType>
+std::pair<std::shared_ptr<storm::models::sparse::Pomdp<ValueType>>,std::vector<uint64_t>> stackObservations(
+    storm::models::sparse::Pomdp<ValueType> const& pomdp,
+    std::vector<uint32_t> const& state_to_obs_class,
+    uint64_t history_length
+);
+
+}
@@ -1,11 +1,18 @@
 #include "PomdpManager.h"
 
+#include "src/synthesis/Trace.h"
+#include "src/synthesis/translation/componentTranslations.h"
+
 #include "storm/exceptions/InvalidArgumentException.h"
 #include "storm/exceptions/NotSupportedException.h"
 #include "storm/storage/sparse/ModelComponents.h"
 #include "storm/storage/SparseMatrix.h"
 #include "storm/models/sparse/StandardRewardModel.h"
 #include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/utility/constants.h"
+
+#include <algorithm>
+#include <thread>
 
 namespace synthesis {
    
@@ -59,8 +66,10 @@ PomdpManager<ValueType>::PomdpManager(storm::models::sparse::Pomdp<ValueType> co
 
     this->observation_memory_size.resize(num_observations, 1);
     this->prototype_duplicates.resize(num_prototype_states);
-    
+
     this->max_successor_memory_size.resize(num_observations);
+    this->observation_changed.resize(num_observations, false);
+    this->observation_affected.resize(num_observations, false);
 }
 
 
@@ -85,7 +94,7 @@ void PomdpManager<ValueType>::buildStateSpace() {
 
 
 template<typename ValueType>
-uint64_t PomdpManager<ValueType>::translateState(uint64_t prototype, uint64_t memory) {
+uint64_t PomdpManager<ValueType>::translateState(uint64_t prototype, uint64_t memory) const {
     if(memory >= this->prototype_duplicates[prototype].size()) {
         memory = 0;
     }
@@ -216,9 +225,57 @@ void PomdpManager<ValueType>::buildDesignSpaceSpurious() {
 
 template<typename ValueType>
 std::shared_ptr<storm::models::sparse::Mdp<ValueType>> PomdpManager<ValueType>::constructMdp() {
+    PAYNT_TRACE_SCOPE("unfolding.constructMdp");
+
+    // nothing changed since the last unfolding
+    bool any_changed = false;
+    for(uint64_t obs = 0; obs < this->pomdp.getNrObservations(); obs++) {
+        if(this->observation_changed[obs]) {
+            any_changed = true;
+            break;
+        }
+    }
+    if(this->mdp != NULL && not any_changed) {
+        return this->mdp;
+    }
+
+    // remember the previous unfolding: rows of a state are identical across its memory copies and
+    // only depend on the memory sizes of its successor observations, so states of unaffected
+    // observations can copy their rows from the previous MDP (through a state renumbering)
+    this->mdp_old = this->mdp;
+    if(this->mdp_old != NULL) {
+        this->prototype_duplicates_old = this->prototype_duplicates;
+        for(uint64_t obs = 0; obs < this->pomdp.getNrObservations(); obs++) {
+            bool affected = false;
+            for(auto dst_obs: this->observation_successors[obs]) {
+                if(this->observation_changed[dst_obs]) {
+                    affected = true;
+                    break;
+                }
+            }
+            this->observation_affected[obs] = affected;
+        }
+        this->state_remap_old_to_new.resize(this->num_states);
+        for(uint64_t old_state = 0; old_state < this->num_states; old_state++) {
+            // this map is completed after the new state space is built
+            this->state_remap_old_to_new[old_state] = this->state_prototype[old_state];
+        }
+    }
+
     this->buildStateSpace();
     this->buildTransitionMatrixSpurious();
 
+    if(this->mdp_old != NULL) {
+        // translate the remembered prototypes to the new state indices, keeping memory indices
+        auto const& old_matrix = this->mdp_old->getTransitionMatrix();
+        uint64_t old_num_states = old_matrix.getRowGroupCount();
+        for(uint64_t old_state = 0; old_state < old_num_states; old_state++) {
+            uint64_t prototype = this->state_remap_old_to_new[old_state];
+            uint64_t memory = old_state - this->prototype_duplicates_old[prototype][0];
+            this->state_remap_old_to_new[old_state] = this->translateState(prototype,memory);
+        }
+    }
+
     storm::storage::sparse::ModelComponents<ValueType> components;
     components.transitionMatrix = this->constructTransitionMatrix();
     // TODO remove unreachable states
@@ -230,6 +287,12 @@ std::shared_ptr<storm::models::sparse::Mdp<ValueType>> PomdpManager<ValueType>::
     this->mdp = std::make_shared<storm::models::sparse::Mdp<ValueType>>(std::move(components));
     this->buildDesignSpaceSpurious();
 
+    // the pending changes have been incorporated
+    std::fill(this->observation_changed.begin(), this->observation_changed.end(), false);
+    this->mdp_old = NULL;
+    this->prototype_duplicates_old.clear();
+    this->state_remap_old_to_new.clear();
+
     return this->mdp;
 }
 
@@ -259,24 +322,248 @@ storm::models::sparse::StateLabeling PomdpManager<ValueType>::constructStateLabe
 
 template<typename ValueType>
 storm::storage::SparseMatrix<ValueType> PomdpManager<ValueType>::constructTransitionMatrix() {
+
+    // the row layout is fixed upfront: each unfolded row has as many entries as its prototype row
+    std::vector<uint64_t> entry_offset(this->num_rows+1, 0);
+    for(uint64_t row = 0; row < this->num_rows; row++) {
+        entry_offset[row+1] = entry_offset[row] + this->pomdp.getTransitionMatrix().getRow(this->row_prototype[row]).getNumberOfEntries();
+    }
+    uint64_t num_entries = entry_offset[this->num_rows];
+    std::vector<uint64_t> entry_column(num_entries);
+    std::vector<ValueType> entry_value(num_entries);
+
+    // fill the entries of the given state range
+    auto fillStates = [&](uint64_t state_begin, uint64_t state_end) {
+        for(uint64_t state = state_begin; state < state_end; state++) {
+            auto prototype_state = this->state_prototype[state];
+            auto observation = this->pomdp.getObservation(prototype_state);
+            if(this->mdp_old != NULL && not this->observation_affected[observation]) {
+                // unaffected observation: copy the rows of any previous duplicate of this
+                // prototype, renumbering the destinations
+                auto const& old_matrix = this->mdp_old->getTransitionMatrix();
+                auto const& old_row_groups = old_matrix.getRowGroupIndices();
+                uint64_t old_row = old_row_groups[this->prototype_duplicates_old[prototype_state][0]];
+                for (uint64_t row = this->row_groups[state]; row < this->row_groups[state+1]; row++) {
+                    uint64_t index = entry_offset[row];
+                    for(auto const &entry: old_matrix.getRow(old_row)) {
+                        entry_column[index] = this->state_remap_old_to_new[entry.getColumn()];
+                        entry_value[index] = entry.getValue();
+                        index++;
+                    }
+                    old_row++;
+                }
+                continue;
+            }
+            for (uint64_t row = this->row_groups[state]; row < this->row_groups[state+1]; row++) {
+                auto prototype_row = this->row_prototype[row];
+                auto dst_mem = this->row_memory[row];
+                uint64_t index = entry_offset[row];
+                for(auto const &entry: this->pomdp.getTransitionMatrix().getRow(prototype_row)) {
+                    entry_column[index] = this->translateState(entry.getColumn(),dst_mem);
+                    entry_value[index] = entry.getValue();
+                    index++;
+                }
+            }
+        }
+    };
+
+    uint64_t num_workers = this->unfolding_threads;
+    if(num_workers <= 1 || this->num_states < num_workers) {
+        fillStates(0, this->num_states);
+    } else {
+        std::vector<std::thread> threads;
+        uint64_t states_per_worker = (this->num_states + num_workers - 1) / num_workers;
+        for(uint64_t worker = 1; worker < num_workers; worker++) {
+            uint64_t state_begin = std::min(worker*states_per_worker, this->num_states);
+            uint64_t state_end = std::min((worker+1)*states_per_worker, this->num_states);
+            threads.emplace_back(fillStates, state_begin, state_end);
+        }
+        fillStates(0, std::min(states_per_worker, this->num_states));
+        for(auto& thread: threads) {
+            thread.join();
+        }
+    }
+
+    // merge the precomputed entries serially
     storm::storage::SparseMatrixBuilder<ValueType> builder(
         this->num_rows, this->num_states, 0, true, true, this->num_states
     );
     for(uint64_t state = 0; state < this->num_states; state++) {
         builder.newRowGroup(this->row_groups[state]);
         for (uint64_t row = this->row_groups[state]; row < this->row_groups[state+1]; row++) {
-            auto prototype_row = this->row_prototype[row];
-            auto dst_mem = this->row_memory[row];
-            for(auto const &entry: this->pomdp.getTransitionMatrix().getRow(prototype_row)) {
-                auto dst = this->translateState(entry.getColumn(),dst_mem);
-                builder.addNextValue(row, dst, entry.getValue());
+            for(uint64_t index = entry_offset[row]; index < entry_offset[row+1]; index++) {
+                builder.addNextValue(row, entry_column[index], entry_value[index]);
             }
         }
     }
-
     return builder.build();
 }
 
+template<typename ValueType>
+void PomdpManager<ValueType>::constructUnfoldingPlan() {
+    this->buildStateSpace();
+    this->buildTransitionMatrixSpurious();
+    this->buildDesignSpaceSpurious();
+    // the cached MDP (if any) no longer matches the plan arrays
+    this->mdp = NULL;
+    std::fill(this->observation_changed.begin(), this->observation_changed.end(), false);
+}
+
+template<typename ValueType>
+std::vector<std::pair<uint64_t,ValueType>> PomdpManager<ValueType>::unfoldedRow(uint64_t row) const {
+    std::vector<std::pair<uint64_t,ValueType>> entries;
+    auto prototype_row = this->row_prototype[row];
+    auto dst_mem = this->row_memory[row];
+    for(auto const &entry: this->pomdp.getTransitionMatrix().getRow(prototype_row)) {
+        entries.emplace_back(this->translateState(entry.getColumn(),dst_mem), entry.getValue());
+    }
+    return entries;
+}
+
+template<typename ValueType>
+void PomdpManager<ValueType>::setUnfoldingThreads(uint64_t num_threads) {
+    STORM_LOG_THROW(num_threads > 0, storm::exceptions::InvalidArgumentException, "number of threads must be positive");
+    this->unfolding_threads = num_threads;
+}
+
+template<typename ValueType>
+std::vector<uint64_t> PomdpManager<ValueType>::rankObservationsForMemoryInjection(
+    std::vector<ValueType> const& mdp_result_values
+) const {
+    STORM_LOG_THROW(
+        mdp_result_values.size() == this->state_prototype.size(), storm::exceptions::InvalidArgumentException,
+        "result vector size does not match the unfolded MDP"
+    );
+    auto num_observations = this->pomdp.getNrObservations();
+
+    // memory copies of a prototype are consecutive in the unfolded MDP, so the value spread of
+    // each prototype and its aggregation per observation happen in one pass over the states
+    std::vector<ValueType> observation_spread(num_observations, storm::utility::zero<ValueType>());
+    uint64_t state = 0;
+    while(state < this->state_prototype.size()) {
+        auto prototype = this->state_prototype[state];
+        ValueType value_min = mdp_result_values[state];
+        ValueType value_max = value_min;
+        for(state++; state < this->state_prototype.size() and this->state_prototype[state] == prototype; state++) {
+            auto value = mdp_result_values[state];
+            if(value < value_min) { value_min = value; }
+            if(value > value_max) { value_max = value; }
+        }
+        auto obs = this->pomdp.getObservation(prototype);
+        if(value_max-value_min > observation_spread[obs]) {
+            observation_spread[obs] = value_max-value_min;
+        }
+    }
+
+    // weight the spread by the number of observations feeding into this one
+    std::vector<uint64_t> observation_fanin(num_observations,0);
+    for(uint64_t obs = 0; obs < num_observations; obs++) {
+        for(auto dst_obs: this->observation_successors[obs]) {
+            observation_fanin[dst_obs]++;
+        }
+    }
+    std::vector<ValueType> observation_score(num_observations);
+    std::vector<uint64_t> ranking;
+    for(uint64_t obs = 0; obs < num_observations; obs++) {
+        if(storm::utility::isZero(observation_spread[obs])) {
+            continue;
+        }
+        observation_score[obs] = observation_spread[obs] * storm::utility::convertNumber<ValueType>(observation_fanin[obs]+1);
+        ranking.push_back(obs);
+    }
+    std::stable_sort(ranking.begin(), ranking.end(), [&](uint64_t a, uint64_t b) {
+        return observation_score[a] > observation_score[b];
+    });
+    return ranking;
+}
+
+
+template<typename ValueType>
+std::tuple<uint64_t,std::vector<uint64_t>,std::vector<uint64_t>,std::vector<uint64_t>,std::vector<uint64_t>> PomdpManager<ValueType>::extractFsc(
+    std::vector<uint64_t> const& hole_assignment
+) const {
+    STORM_LOG_THROW(
+        hole_assignment.size() == this->num_holes, storm::exceptions::InvalidArgumentException,
+        "assignment size does not match the number of holes"
+    );
+    auto num_observations = this->pomdp.getNrObservations();
+    uint64_t num_nodes = 0;
+    for(uint64_t obs = 0; obs < num_observations; obs++) {
+        if(num_nodes < this->observation_memory_size[obs]) {
+            num_nodes = this->observation_memory_size[obs];
+        }
+    }
+
+    std::vector<uint64_t> fsc_action(num_nodes*num_observations,0);
+    std::vector<uint64_t> fsc_update(num_nodes*num_observations,0);
+    std::vector<uint64_t> fsc_action_hole(num_nodes*num_observations,this->num_holes);
+    std::vector<uint64_t> fsc_update_hole(num_nodes*num_observations,this->num_holes);
+    for(uint64_t node = 0; node < num_nodes; node++) {
+        for(uint64_t obs = 0; obs < num_observations; obs++) {
+            // nodes beyond the memory size of this observation behave as node 0
+            auto mem = node < this->observation_memory_size[obs] ? node : 0;
+            auto cell = node*num_observations + obs;
+            if(this->observation_actions[obs] > 1) {
+                auto action_hole = this->action_holes[obs][mem];
+                fsc_action[cell] = hole_assignment[action_hole];
+                fsc_action_hole[cell] = action_hole;
+            }
+            if(this->max_successor_memory_size[obs] > 1) {
+                auto memory_hole = this->memory_holes[obs][mem];
+                fsc_update[cell] = hole_assignment[memory_hole];
+                fsc_update_hole[cell] = memory_hole;
+            }
+        }
+    }
+    return std::make_tuple(
+        num_nodes, std::move(fsc_action), std::move(fsc_update), std::move(fsc_action_hole), std::move(fsc_update_hole)
+    );
+}
+
+
+template<typename ValueType>
+std::pair<std::vector<uint64_t>,std::vector<uint64_t>> PomdpManager<ValueType>::analyzeSchedulerConsistency(
+    storm::storage::BitVector const& choices
+) const {
+    STORM_LOG_THROW(
+        choices.size() == this->num_rows, storm::exceptions::InvalidArgumentException,
+        "choice mask size does not match the unfolded MDP"
+    );
+    auto num_observations = this->pomdp.getNrObservations();
+
+    // flat (observation, option) buckets
+    std::vector<uint64_t> option_offset(num_observations+1,0);
+    for(uint64_t obs = 0; obs < num_observations; obs++) {
+        option_offset[obs+1] = option_offset[obs] + this->observation_actions[obs];
+    }
+    std::vector<bool> option_selected(option_offset[num_observations],false);
+
+    std::vector<uint64_t> num_options_selected(num_observations,0);
+    for(uint64_t state = 0; state < this->num_states; state++) {
+        auto obs = this->pomdp.getObservation(this->state_prototype[state]);
+        for(uint64_t row = this->row_groups[state]; row < this->row_groups[state+1]; row++) {
+            if(not choices[row]) {
+                continue;
+            }
+            // rows without an action hole all map to the sole option 0
+            uint64_t option = this->row_action_hole[row] < this->num_holes ? this->row_action_option[row] : 0;
+            auto bucket = option_offset[obs] + option;
+            if(not option_selected[bucket]) {
+                option_selected[bucket] = true;
+                num_options_selected[obs]++;
+            }
+        }
+    }
+
+    std::vector<uint64_t> inconsistent_observations;
+    for(uint64_t obs = 0; obs < num_observations; obs++) {
+        if(num_options_selected[obs] > 1) {
+            inconsistent_observations.push_back(obs);
+        }
+    }
+    return std::make_pair(std::move(inconsistent_observations), std::move(num_options_selected));
+}
+
 
 template<typename ValueType>
 storm::models::sparse::StandardRewardModel<ValueType> PomdpManager<ValueType>::constructRewardModel(
@@ -303,14 +590,224 @@ storm::models::sparse::StandardRewardModel<ValueType> PomdpManager<ValueType>::c
 template<typename ValueType>
 void PomdpManager<ValueType>::setObservationMemorySize(uint64_t obs, uint64_t memory_size) {
     assert(obs < this->pomdp.getNrObservations());
-    this->observation_memory_size[obs] = memory_size;
+    if(this->observation_memory_size[obs] != memory_size) {
+        this->observation_memory_size[obs] = memory_size;
+        this->observation_changed[obs] = true;
+    }
 }
 
 template<typename ValueType>
 void PomdpManager<ValueType>::setGlobalMemorySize(uint64_t memory_size) {
     for(uint64_t obs = 0; obs < this->pomdp.getNrObservations(); obs++) {
-        this->observation_memory_size[obs] = memory_size;
+        this->setObservationMemorySize(obs, memory_size);
+    }
+}
+
+template<typename ValueType>
+uint64_t PomdpManager<ValueType>::pruneUnreachableMemoryCells() {
+    auto num_observations = this->pomdp.getNrObservations();
+
+    // forward reachability over the belief-support graph from the initial observations
+    std::vector<bool> observation_reachable(num_observations,false);
+    std::vector<uint64_t> horizon;
+    for(auto state: this->pomdp.getInitialStates()) {
+        auto obs = this->pomdp.getObservation(state);
+        if(not observation_reachable[obs]) {
+            observation_reachable[obs] = true;
+            horizon.push_back(obs);
+        }
     }
+    while(not horizon.empty()) {
+        auto obs = horizon.back();
+        horizon.pop_back();
+        for(auto dst_obs: this->observation_successors[obs]) {
+            if(not observation_reachable[dst_obs]) {
+                observation_reachable[dst_obs] = true;
+                horizon.push_back(dst_obs);
+            }
+        }
+    }
+
+    // an observation without a reachable predecessor can only occur initially, i.e. with memory 0
+    std::vector<bool> observation_entered(num_observations,false);
+    for(uint64_t obs = 0; obs < num_observations; obs++) {
+        if(not observation_reachable[obs]) {
+            continue;
+        }
+        for(auto dst_obs: this->observation_successors[obs]) {
+            observation_entered[dst_obs] = true;
+        }
+    }
+
+    uint64_t cells_pruned = 0;
+    for(uint64_t obs = 0; obs < num_observations; obs++) {
+        if(observation_reachable[obs] and observation_entered[obs]) {
+            continue;
+        }
+        if(this->observation_memory_size[obs] > 1) {
+            cells_pruned += this->observation_memory_size[obs]-1;
+            this->setObservationMemorySize(obs,1);
+        }
+    }
+    return cells_pruned;
+}
+
+
+template<typename ValueType>
+void PomdpManager<ValueType>::recordVisitMass(storm::storage::BitVector const& choices, uint64_t num_sweeps) {
+    STORM_LOG_THROW(this->mdp != NULL, storm::exceptions::InvalidArgumentException, "the POMDP has not been unfolded yet");
+    auto const& matrix = this->mdp->getTransitionMatrix();
+    this->state_visit_mass.resize(this->num_states,0);
+    std::vector<double> occupancy(this->num_states,0);
+    for(uint64_t state: this->mdp->getInitialStates()) {
+        occupancy[state] = 1;
+    }
+    std::vector<double> occupancy_next(this->num_states);
+    for(uint64_t sweep = 0; sweep < num_sweeps; sweep++) {
+        std::fill(occupancy_next.begin(),occupancy_next.end(),0);
+        for(uint64_t state = 0; state < this->num_states; state++) {
+            double mass = occupancy[state];
+            if(mass == 0) {
+                continue;
+            }
+            this->state_visit_mass[state] += mass;
+            // split the mass evenly among the selected rows of the group; states the mask
+            // avoids entirely propagate over all of their rows
+            uint64_t num_selected = 0;
+            for(uint64_t row = this->row_groups[state]; row < this->row_groups[state+1]; row++) {
+                if(choices[row]) {
+                    num_selected++;
+                }
+            }
+            bool any_selected = num_selected > 0;
+            if(not any_selected) {
+                num_selected = this->row_groups[state+1]-this->row_groups[state];
+            }
+            double share = mass / num_selected;
+            for(uint64_t row = this->row_groups[state]; row < this->row_groups[state+1]; row++) {
+                if(any_selected and not choices[row]) {
+                    continue;
+                }
+                for(auto const& entry: matrix.getRow(row)) {
+                    occupancy_next[entry.getColumn()] += share * storm::utility::convertNumber<double>(entry.getValue());
+                }
+            }
+        }
+        occupancy.swap(occupancy_next);
+    }
+    // mass that arrived after the last sweep
+    for(uint64_t state = 0; state < this->num_states; state++) {
+        this->state_visit_mass[state] += occupancy[state];
+    }
+}
+
+template<typename ValueType>
+void PomdpManager<ValueType>::clearVisitMass() {
+    this->state_visit_mass.clear();
+}
+
+template<typename ValueType>
+std::vector<uint64_t> PomdpManager<ValueType>::repartitionHotFirst() {
+    STORM_LOG_THROW(this->mdp != NULL and this->state_visit_mass.size() == this->num_states,
+        storm::exceptions::InvalidArgumentException, "no visit mass has been recorded for the current unfolding");
+
+    // hot-first state order; the sort is stable so that equally (un)visited states keep
+    // their current relative order and hence their locality
+    std::vector<uint64_t> new_to_old(this->num_states);
+    for(uint64_t state = 0; state < this->num_states; state++) {
+        new_to_old[state] = state;
+    }
+    std::stable_sort(new_to_old.begin(),new_to_old.end(),
+        [&](uint64_t a, uint64_t b) { return this->state_visit_mass[a] > this->state_visit_mass[b]; }
+    );
+    std::vector<uint64_t> old_to_new(this->num_states);
+    for(uint64_t state = 0; state < this->num_states; state++) {
+        old_to_new[new_to_old[state]] = state;
+    }
+
+    // permute the row layout first to obtain the row mapping
+    std::vector<uint64_t> new_row_groups(this->num_states+1);
+    std::vector<uint64_t> new_row_to_old;
+    new_row_to_old.reserve(this->num_rows);
+    for(uint64_t state = 0; state < this->num_states; state++) {
+        new_row_groups[state] = new_row_to_old.size();
+        uint64_t old_state = new_to_old[state];
+        for(uint64_t row = this->row_groups[old_state]; row < this->row_groups[old_state+1]; row++) {
+            new_row_to_old.push_back(row);
+        }
+    }
+    new_row_groups[this->num_states] = this->num_rows;
+
+    // transition matrix with remapped and re-sorted columns
+    auto const& matrix = this->mdp->getTransitionMatrix();
+    storm::storage::SparseMatrixBuilder<ValueType> builder(
+        this->num_rows, this->num_states, matrix.getEntryCount(), true, true, this->num_states
+    );
+    std::vector<std::pair<uint64_t,ValueType>> row_entries;
+    for(uint64_t state = 0; state < this->num_states; state++) {
+        builder.newRowGroup(new_row_groups[state]);
+        for(uint64_t row = new_row_groups[state]; row < new_row_groups[state+1]; row++) {
+            row_entries.clear();
+            for(auto const& entry: matrix.getRow(new_row_to_old[row])) {
+                row_entries.emplace_back(old_to_new[entry.getColumn()],entry.getValue());
+            }
+            std::sort(row_entries.begin(),row_entries.end(),
+                [](std::pair<uint64_t,ValueType> const& a, std::pair<uint64_t,ValueType> const& b) { return a.first < b.first; }
+            );
+            for(auto const& [column,value]: row_entries) {
+                builder.addNextValue(row,column,value);
+            }
+        }
+    }
+
+    storm::storage::sparse::ModelComponents<ValueType> components;
+    components.transitionMatrix = builder.build();
+    uint64_t initial_state = *(this->mdp->getInitialStates().begin());
+    components.stateLabeling = synthesis::translateStateLabeling(*this->mdp,new_to_old,old_to_new[initial_state]);
+    storm::storage::BitVector all_rows(this->num_rows,true);
+    if(this->mdp->hasChoiceLabeling()) {
+        components.choiceLabeling = synthesis::translateChoiceLabeling(*this->mdp,new_row_to_old,all_rows);
+    }
+    components.rewardModels = synthesis::translateRewardModels(*this->mdp,new_row_to_old,all_rows);
+    this->mdp = std::make_shared<storm::models::sparse::Mdp<ValueType>>(std::move(components));
+
+    // permute the state- and row-indexed members alongside the model
+    auto permuteStates = [&](std::vector<uint64_t>& items) {
+        std::vector<uint64_t> permuted(items.size());
+        for(uint64_t state = 0; state < this->num_states; state++) {
+            permuted[state] = items[new_to_old[state]];
+        }
+        items = std::move(permuted);
+    };
+    permuteStates(this->state_prototype);
+    permuteStates(this->state_memory);
+    auto permuteRows = [&](std::vector<uint64_t>& items) {
+        std::vector<uint64_t> permuted(items.size());
+        for(uint64_t row = 0; row < this->num_rows; row++) {
+            permuted[row] = items[new_row_to_old[row]];
+        }
+        items = std::move(permuted);
+    };
+    permuteRows(this->row_prototype);
+    permuteRows(this->row_memory);
+    permuteRows(this->row_action_hole);
+    permuteRows(this->row_action_option);
+    permuteRows(this->row_memory_hole);
+    permuteRows(this->row_memory_option);
+    this->row_groups = std::move(new_row_groups);
+    for(uint64_t state = 0; state < this->num_states; state++) {
+        this->prototype_duplicates[this->state_prototype[state]][this->state_memory[state]] = state;
+    }
+    std::vector<double> permuted_mass(this->num_states);
+    for(uint64_t state = 0; state < this->num_states; state++) {
+        permuted_mass[state] = this->state_visit_mass[new_to_old[state]];
+    }
+    this->state_visit_mass = std::move(permuted_mass);
+
+    // the incremental-reconstruction cache tracks the canonical layout; invalidate it
+    this->mdp_old = NULL;
+
+    return new_to_old;
 }
 
 
@@ -3,6 +3,9 @@
 #include <storm/adapters/RationalNumberAdapter.h>
 #include <storm/models/sparse/Mdp.h>
 #include <storm/models/sparse/Pomdp.h>
+#include <storm/storage/BitVector.h>
+
+#include <tuple>
 
 namespace synthesis {
 
@@ -28,8 +31,101 @@ public:
     // set memory size to all observations
     void setGlobalMemorySize(uint64_t memory_size);
 
+    /**
+     * Prune provably unreachable memory cells before unfolding. A reachability pass over the
+     * belief-support graph (@observation_successors) identifies observations that are not
+     * reachable from the initial observations, as well as reachable observations with no
+     * predecessor: neither can ever be entered with a non-zero memory, so their memory size is
+     * reset to 1 and the corresponding holes disappear from the design space.
+     * @return the number of pruned memory cells
+     */
+    uint64_t pruneUnreachableMemoryCells();
+
     // unfold memory model (a priori memory update) into the POMDP
     std::shared_ptr<storm::models::sparse::Mdp<ValueType>> constructMdp();
+
+    // set the number of threads used to fill the unfolded transition matrix (default 1)
+    void setUnfoldingThreads(uint64_t num_threads);
+
+    /**
+     * Rank observations by their potential to benefit from an additional memory state. For each
+     * observation, compute in one pass over the unfolded MDP the largest value spread across the
+     * memory copies of its states, weighted by the number of observations it succeeds (fan-in).
+     * @param mdp_result_values for each state of the unfolded MDP, its value in the last result
+     * @return observations with a positive spread, most promising first
+     */
+    std::vector<uint64_t> rankObservationsForMemoryInjection(std::vector<ValueType> const& mdp_result_values) const;
+
+    /**
+     * Extract the FSC induced by a hole assignment as dense row-major (node x observation)
+     * lookup tables, suitable for direct deployment. Nodes exceeding the memory size of an
+     * observation behave as node 0, mirroring @translateState.
+     * @param hole_assignment for each hole, the selected option
+     * @return a tuple (number of nodes, action table, update table, action hole table, update
+     *  hole table); the hole tables map each cell back to the deciding hole (num_holes if the
+     *  cell was not governed by a hole) for tracing
+     */
+    std::tuple<uint64_t,std::vector<uint64_t>,std::vector<uint64_t>,std::vector<uint64_t>,std::vector<uint64_t>> extractFsc(
+        std::vector<uint64_t> const& hole_assignment
+    ) const;
+
+    /**
+     * Check per observation whether a scheduler of the unfolded MDP picks the same action across
+     * all memory copies. Selected rows are bucketed by (observation, action-hole option) in one
+     * pass over the unfolded MDP.
+     * @param choices mask of the rows selected by the scheduler
+     * @return a pair (observations with more than one selected option, for each observation the
+     *  number of distinct selected options)
+     */
+    std::pair<std::vector<uint64_t>,std::vector<uint64_t>> analyzeSchedulerConsistency(
+        storm::storage::BitVector const& choices
+    ) const;
+
+    /**
+     * Accumulate state-visit mass from the sub-MDP induced by the rows of the last masked
+     * check: the occupancy of the initial state is propagated forward through the unfolded
+     * matrix for a number of sweeps, split evenly among the selected rows of each state, and
+     * summed per state into @state_visit_mass. Recorded across the early AR iterations, this
+     * profiles which (prototype,memory) states carry the probability mass under good
+     * schedulers. States whose row group the mask avoids entirely propagate over all rows.
+     * @param choices mask of the rows selected by the last check
+     * @param num_sweeps propagation depth
+     */
+    void recordVisitMass(storm::storage::BitVector const& choices, uint64_t num_sweeps = 16);
+    /** Reset the accumulated visit mass. */
+    void clearVisitMass();
+
+    /**
+     * Renumber the states of the unfolded MDP hot-first: by decreasing accumulated visit
+     * mass, with ties keeping their current relative order. Every state- and row-indexed
+     * member of the manager is permuted alongside @mdp, so the design space, FSC extraction
+     * and result mapping keep working on the repartitioned model, while the value vector
+     * accesses of subsequent VI sweeps concentrate on one compact index range. A later
+     * @constructMdp rebuilds in canonical order, dropping the repartition.
+     * @return the permutation as a new-to-old state map
+     */
+    std::vector<uint64_t> repartitionHotFirst();
+
+    // accumulated per-state visit mass of the current unfolding (see @recordVisitMass)
+    std::vector<double> state_visit_mass;
+
+    /**
+     * Compute the unfolding in compressed form only: the state space, the row layout
+     * (row groups, prototype row and memory update per row) and the design space, without ever
+     * materializing the unfolded transition matrix. Each prototype row is stored once; the rows
+     * of all memory copies are derivable from it plus the per-row memory update.
+     */
+    void constructUnfoldingPlan();
+
+    // materialize a single row of the (possibly unmaterialized) unfolded MDP
+    std::vector<std::pair<uint64_t,ValueType>> unfoldedRow(uint64_t row) const;
+
+    // row groups of the unfolded MDP
+    std::vector<uint64_t> const& unfoldedRowGroups() const { return this->row_groups; }
+    // for each unfolded row, its prototype row
+    std::vector<uint64_t> const& unfoldedRowPrototype() const { return this->row_prototype; }
+    // for each unfolded row, its memory update
+    std::vector<uint64_t> const& unfoldedRowMemory() const { return this->row_memory; }
     
     /** Design space associated with this POMDP. */
 
@@ -82,7 +178,7 @@ private:
      * If the prototype does not have the corresponding memory
      * equivalent, default to @memory=0.
      */
-    uint64_t translateState(uint64_t prototype, uint64_t memory);
+    uint64_t translateState(uint64_t prototype, uint64_t memory) const;
 
     // compute max memory size among all destinations of a prototype row
     uint64_t maxSuccessorMemorySize(uint64_t prototype_row);
@@ -109,6 +205,24 @@ private:
     storm::models::sparse::Pomdp<ValueType> const& pomdp;
     // for each row of a POMDP contains its index in its row group
     std::vector<uint64_t> prototype_row_index;
+
+    /** Incremental reconstruction. */
+
+    // observations whose memory size changed since the last unfolding
+    std::vector<bool> observation_changed;
+    // observations whose unfolded rows are affected by the pending changes (some successor
+    // observation changed); rows of unaffected observations are copied from the previous MDP
+    std::vector<bool> observation_affected;
+    // MDP of the previous unfolding (NULL when a full rebuild is required)
+    std::shared_ptr<storm::models::sparse::Mdp<ValueType>> mdp_old;
+    // state space layout of the previous unfolding
+    std::vector<std::vector<uint64_t>> prototype_duplicates_old;
+    // for each state of the previous unfolding, its index in the new one
+    std::vector<uint64_t> state_remap_old_to_new;
+
+    // number of threads filling the unfolded transition matrix; the row layout is fixed upfront,
+    // so entry ranges are computed independently per state partition and merged serially
+    uint64_t unfolding_threads = 1;
     
     // number of states in an unfolded MDP
     uint64_t num_states;
@@ -7,6 +7,8 @@
 #include "storm/models/sparse/StandardRewardModel.h"
 #include "storm/adapters/RationalNumberAdapter.h"
 
+#include <thread>
+
 namespace synthesis {
         
     template<typename ValueType>
@@ -61,6 +63,86 @@ namespace synthesis {
 
 
 
+    template<typename ValueType>
+    void PomdpManagerAposteriori<ValueType>::setInterestingPosteriors(std::vector<uint64_t> const& posteriors) {
+        this->posterior_interesting.assign(this->pomdp.getNrObservations(), false);
+        for(auto posterior: posteriors) {
+            STORM_LOG_THROW(posterior < this->pomdp.getNrObservations(), storm::exceptions::InvalidArgumentException, "invalid posterior observation index");
+            this->posterior_interesting[posterior] = true;
+        }
+    }
+
+    template<typename ValueType>
+    void PomdpManagerAposteriori<ValueType>::clearInterestingPosteriors() {
+        this->posterior_interesting.clear();
+    }
+
+
+    template<typename ValueType>
+    std::pair<std::vector<std::vector<uint64_t>>,std::vector<uint64_t>> PomdpManagerAposteriori<ValueType>::checkSchedulerConsistency(
+        storm::storage::BitVector const& choices, uint64_t num_threads
+    ) const {
+        STORM_LOG_THROW(
+            choices.size() == this->coloring.size(), storm::exceptions::InvalidArgumentException,
+            "the choice mask does not match the last unfolded MDP"
+        );
+        uint64_t num_holes = this->hole_num_options.size();
+        uint64_t num_rows = this->coloring.size();
+
+        auto collectOptions = [&](uint64_t row_begin, uint64_t row_end, std::vector<std::set<uint64_t>>& hole_options) {
+            for(uint64_t row = choices.getNextSetIndex(row_begin); row < row_end; row = choices.getNextSetIndex(row+1)) {
+                for(auto const& [hole,option]: this->coloring[row]) {
+                    hole_options[hole].insert(option);
+                }
+            }
+        };
+
+        std::vector<std::set<uint64_t>> hole_options(num_holes);
+        uint64_t num_workers = num_threads;
+        if(num_workers <= 1 || num_rows < num_workers) {
+            collectOptions(0, num_rows, hole_options);
+        } else {
+            std::vector<std::vector<std::set<uint64_t>>> worker_hole_options(num_workers, std::vector<std::set<uint64_t>>(num_holes));
+            std::vector<std::thread> threads;
+            uint64_t rows_per_worker = (num_rows + num_workers - 1) / num_workers;
+            for(uint64_t worker = 1; worker < num_workers; worker++) {
+                uint64_t row_begin = std::min(worker*rows_per_worker, num_rows);
+                uint64_t row_end = std::min((worker+1)*rows_per_worker, num_rows);
+                threads.emplace_back(collectOptions, row_begin, row_end, std::ref(worker_hole_options[worker]));
+            }
+            collectOptions(0, std::min(rows_per_worker, num_rows), std::ref(worker_hole_options[0]));
+            for(auto& thread: threads) {
+                thread.join();
+            }
+            for(auto const& worker_options: worker_hole_options) {
+                for(uint64_t hole = 0; hole < num_holes; hole++) {
+                    hole_options[hole].insert(worker_options[hole].begin(), worker_options[hole].end());
+                }
+            }
+        }
+
+        // holes are keyed by their prior observation
+        std::vector<uint64_t> hole_prior(num_holes);
+        for(auto const& [key,hole]: this->action_holes) {
+            hole_prior[hole] = key.second;
+        }
+        for(auto const& [key,hole]: this->update_holes) {
+            hole_prior[hole] = std::get<1>(key);
+        }
+        std::set<uint64_t> inconsistent_observations;
+        std::vector<std::vector<uint64_t>> hole_options_list(num_holes);
+        for(uint64_t hole = 0; hole < num_holes; hole++) {
+            hole_options_list[hole] = std::vector<uint64_t>(hole_options[hole].begin(), hole_options[hole].end());
+            if(hole_options[hole].size() > 1) {
+                inconsistent_observations.insert(hole_prior[hole]);
+            }
+        }
+        return std::make_pair(
+            std::move(hole_options_list),
+            std::vector<uint64_t>(inconsistent_observations.begin(), inconsistent_observations.end())
+        );
+    }
+
     template<typename ValueType>
     void PomdpManagerAposteriori<ValueType>::clear_before_unfolding() {
         
@@ -114,6 +196,10 @@ namespace synthesis {
                 this->hole_num_options.push_back(num_actions);
 
                 for(auto posterior: this->observation_posteriors[prior]) {
+                    if(not this->posteriorInteresting(posterior)) {
+                        // memory update fixed to 0, no hole needed
+                        continue;
+                    }
                     // delta(n,z,z') in mu(z')
                     auto num_updates = this->observation_memory_size[posterior];
                     this->update_holes[std::make_tuple(mem,prior,posterior)] = num_holes++;
@@ -152,17 +238,20 @@ namespace synthesis {
         auto const& posteriors = this->row_posteriors[prototype_row];
         auto action_hole = this->action_holes[std::make_pair(memory,prior)];
         
-        // iterate over all combinations of memory updates
+        // iterate over all combinations of memory updates; uninteresting posteriors
+        // contribute the sole update 0
         uint64_t num_combinations = 1;
         for(auto posterior: posteriors) {
-            num_combinations *= this->observation_memory_size[posterior];
+            if(this->posteriorInteresting(posterior)) {
+                num_combinations *= this->observation_memory_size[posterior];
+            }
         }
         std::map<uint64_t,uint64_t> combination;
         for(uint64_t c=0 ; c<num_combinations; c++) {
             uint64_t index = c;
             for(int64_t i=posteriors.size()-1; i>=0; i--) {
                 auto posterior = posteriors[i];
-                auto posterior_size = this->observation_memory_size[posterior];
+                auto posterior_size = this->posteriorInteresting(posterior) ? this->observation_memory_size[posterior] : 1;
                 combination[posterior] = index % posterior_size;
                 index = index / posterior_size;
             }
@@ -181,6 +270,9 @@ namespace synthesis {
             coloring[action_hole] = action;
             for(uint64_t index = 0; index < posteriors.size(); index++) {
                 auto posterior = posteriors[index];
+                if(not this->posteriorInteresting(posterior)) {
+                    continue;
+                }
                 auto update_hole = this->update_holes[std::make_tuple(memory,prior,posterior)];
                 coloring[update_hole] = combination[posterior];
             }
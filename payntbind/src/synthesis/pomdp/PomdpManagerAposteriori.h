@@ -3,6 +3,7 @@
 #include <storm/adapters/RationalNumberAdapter.h>
 #include <storm/models/sparse/Mdp.h>
 #include <storm/models/sparse/Pomdp.h>
+#include <storm/storage/BitVector.h>
 
 #include <stack>
 
@@ -25,6 +26,28 @@ namespace synthesis {
         // set memory size to all observations
         void setGlobalMemorySize(uint64_t memory_size);
 
+        /**
+         * Restrict update holes to the given posteriors (e.g. those whose holes were actually
+         * used in the previous iteration). For the remaining posteriors the memory update is
+         * fixed to 0 and no hole is created, shrinking both the unfolded MDP and the coloring.
+         */
+        void setInterestingPosteriors(std::vector<uint64_t> const& posteriors);
+        // make all posteriors interesting again (the default)
+        void clearInterestingPosteriors();
+
+        /**
+         * Scheduler-consistency scan over the last unfolded MDP. The hole structure is strictly
+         * partitioned by the prior observation, so the row hole maps are scanned by parallel
+         * workers and the per-hole option sets merge without cross-observation conflicts.
+         * @param choices mask of unfolded rows selected by the scheduler
+         * @param num_threads number of worker threads
+         * @return for each hole the options used by the selected rows, and the sorted list of
+         *   observations owning a hole to which the scheduler assigns two or more options
+         */
+        std::pair<std::vector<std::vector<uint64_t>>,std::vector<uint64_t>> checkSchedulerConsistency(
+            storm::storage::BitVector const& choices, uint64_t num_threads = 1
+        ) const;
+
         // MDP obtained after last unfolding
         std::shared_ptr<storm::models::sparse::Mdp<ValueType>> mdp;
         // for each state contains its prototype state (reverse of prototype_duplicates)
@@ -53,6 +76,13 @@ namespace synthesis {
         // for each observation, a set of successor observations
         std::vector<std::set<uint64_t>> observation_posteriors;
 
+        // mask of posteriors that keep their update holes (empty = all of them)
+        std::vector<bool> posterior_interesting;
+        // whether the given posterior keeps its update holes
+        bool posteriorInteresting(uint64_t posterior) const {
+            return this->posterior_interesting.empty() or this->posterior_interesting[posterior];
+        }
+
         // clear auxiliary data structures before unfolding
         void clear_before_unfolding();
         // clear auxiliary data structures after unfolding
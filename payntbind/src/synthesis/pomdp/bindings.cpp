@@ -2,6 +2,7 @@
 
 #include "PomdpManager.h"
 #include "PomdpManagerAposteriori.h"
+#include "ObservationStacking.h"
 #include <storm/adapters/RationalNumberAdapter.h>
 #include <string>
 
@@ -12,7 +13,21 @@ void bindings_pomdp_vt(py::module& m, std::string const& vtSuffix) {
         .def(py::init<storm::models::sparse::Pomdp<ValueType> const&>(), "Constructor.", py::arg("pomdp"))
         .def("set_observation_memory_size", &synthesis::PomdpManager<ValueType>::setObservationMemorySize, "Set memory size to a selected observation.", py::arg("observation"), py::arg("memory_size"))
         .def("set_global_memory_size", &synthesis::PomdpManager<ValueType>::setGlobalMemorySize, "Set memory size to all observations.", py::arg("memory_size"))
-        .def("construct_mdp", &synthesis::PomdpManager<ValueType>::constructMdp, "Unfold memory model (a priori memory update) into the POMDP.")
+        .def("prune_unreachable_memory_cells", &synthesis::PomdpManager<ValueType>::pruneUnreachableMemoryCells, "Reset the memory size of observations that cannot be entered with non-zero memory.")
+        .def("construct_mdp", &synthesis::PomdpManager<ValueType>::constructMdp, "Unfold memory model (a priori memory update) into the POMDP.", py::call_guard<py::gil_scoped_release>())
+        .def("set_unfolding_threads", &synthesis::PomdpManager<ValueType>::setUnfoldingThreads, "Set the number of threads used to fill the unfolded transition matrix.", py::arg("num_threads"))
+        .def("rank_observations_for_memory_injection", &synthesis::PomdpManager<ValueType>::rankObservationsForMemoryInjection, "Rank observations by value spread across memory copies, weighted by fan-in.", py::arg("mdp_result_values"))
+        .def("extract_fsc", &synthesis::PomdpManager<ValueType>::extractFsc, "Extract the FSC of a hole assignment as dense (node x observation) lookup tables.", py::arg("hole_assignment"))
+        .def("analyze_scheduler_consistency", &synthesis::PomdpManager<ValueType>::analyzeSchedulerConsistency, "Per observation, check whether the scheduler picks the same action across memory copies.", py::arg("choices"))
+        .def("record_visit_mass", &synthesis::PomdpManager<ValueType>::recordVisitMass, "Accumulate state-visit mass under the rows selected by the last check.", py::arg("choices"), py::arg("num_sweeps") = 16, py::call_guard<py::gil_scoped_release>())
+        .def("clear_visit_mass", &synthesis::PomdpManager<ValueType>::clearVisitMass, "Reset the accumulated visit mass.")
+        .def("repartition_hot_first", &synthesis::PomdpManager<ValueType>::repartitionHotFirst, "Renumber the states of the unfolded MDP by decreasing visit mass, permuting the design space alongside.", py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("state_visit_mass", [](synthesis::PomdpManager<ValueType>& manager) {return manager.state_visit_mass;})
+        .def("construct_unfolding_plan", &synthesis::PomdpManager<ValueType>::constructUnfoldingPlan, "Compute the unfolding in compressed form, without materializing the transition matrix.")
+        .def("unfolded_row", &synthesis::PomdpManager<ValueType>::unfoldedRow, "Materialize a single row of the unfolded MDP.", py::arg("row"))
+        .def_property_readonly("unfolded_row_groups", [](synthesis::PomdpManager<ValueType>& manager) {return manager.unfoldedRowGroups();})
+        .def_property_readonly("unfolded_row_prototype", [](synthesis::PomdpManager<ValueType>& manager) {return manager.unfoldedRowPrototype();})
+        .def_property_readonly("unfolded_row_memory", [](synthesis::PomdpManager<ValueType>& manager) {return manager.unfoldedRowMemory();})
         .def_property_readonly("state_prototype", [](synthesis::PomdpManager<ValueType>& manager) {return manager.state_prototype;})
         .def_property_readonly("state_memory", [](synthesis::PomdpManager<ValueType>& manager) {return manager.state_memory;})
         .def_property_readonly("observation_memory_size", [](synthesis::PomdpManager<ValueType>& manager) {return manager.observation_memory_size;})
@@ -33,7 +48,14 @@ void bindings_pomdp_vt(py::module& m, std::string const& vtSuffix) {
         .def(py::init<storm::models::sparse::Pomdp<ValueType> const&>(), "Constructor.")
         .def("set_observation_memory_size", &synthesis::PomdpManagerAposteriori<ValueType>::setObservationMemorySize)
         .def("set_global_memory_size", &synthesis::PomdpManagerAposteriori<ValueType>::setGlobalMemorySize)
-        .def("construct_mdp", &synthesis::PomdpManagerAposteriori<ValueType>::constructMdp)
+        .def("construct_mdp", &synthesis::PomdpManagerAposteriori<ValueType>::constructMdp, py::call_guard<py::gil_scoped_release>())
+        .def("set_interesting_posteriors", &synthesis::PomdpManagerAposteriori<ValueType>::setInterestingPosteriors, "Restrict update holes to the given posteriors; others get a fixed update 0.", py::arg("posteriors"))
+        .def("clear_interesting_posteriors", &synthesis::PomdpManagerAposteriori<ValueType>::clearInterestingPosteriors)
+        .def(
+            "check_scheduler_consistency", &synthesis::PomdpManagerAposteriori<ValueType>::checkSchedulerConsistency,
+            py::arg("choices"), py::arg("num_threads") = 1, py::call_guard<py::gil_scoped_release>(),
+            "For the selected rows, collect the options of each hole and the observations whose holes are assigned inconsistently."
+        )
         .def_property_readonly("state_prototype", [](synthesis::PomdpManagerAposteriori<ValueType>& manager) {return manager.state_prototype;})
         .def_property_readonly("state_memory", [](synthesis::PomdpManagerAposteriori<ValueType>& manager) {return manager.state_memory;})
         .def_property_readonly("coloring", [](synthesis::PomdpManagerAposteriori<ValueType>& manager) {return manager.coloring;})
@@ -42,6 +64,10 @@ void bindings_pomdp_vt(py::module& m, std::string const& vtSuffix) {
         .def_property_readonly("update_holes", [](synthesis::PomdpManagerAposteriori<ValueType>& manager) {return manager.update_holes;})
         ;
 
+    m.def(("stackObservations" + vtSuffix).c_str(), &synthesis::stackObservations<ValueType>,
+        py::arg("pomdp"), py::arg("state_to_obs_class"), py::arg("history_length"),
+        "build the POMDP whose observations are the last history_length observation classes, returns the model and the new-to-old state map",
+        py::call_guard<py::gil_scoped_release>());
 }
 
 void bindings_pomdp(py::module& m) {
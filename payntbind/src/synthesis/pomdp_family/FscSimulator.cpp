@@ -0,0 +1,235 @@
+#include "FscSimulator.h"
+
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/utility/constants.h>
+
+#include <thread>
+
+namespace synthesis {
+
+    namespace {
+
+        uint64_t splitmix64(uint64_t & state) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        /** xoshiro256** generator; one instance per worker, seeded via splitmix64. */
+        class Xoshiro256 {
+        public:
+            Xoshiro256(uint64_t seed) {
+                for(uint64_t word = 0; word < 4; ++word) {
+                    state[word] = splitmix64(seed);
+                }
+            }
+            uint64_t next() {
+                uint64_t const result = rotl(state[1]*5,7)*9;
+                uint64_t const t = state[1] << 17;
+                state[2] ^= state[0];
+                state[3] ^= state[1];
+                state[1] ^= state[2];
+                state[0] ^= state[3];
+                state[2] ^= t;
+                state[3] = rotl(state[3],45);
+                return result;
+            }
+            /** A uniform draw from [0,1). */
+            double nextUniform() {
+                return (next() >> 11) * 0x1.0p-53;
+            }
+        private:
+            static uint64_t rotl(uint64_t x, int k) {
+                return (x << k) | (x >> (64-k));
+            }
+            uint64_t state[4];
+        };
+
+    }
+
+    template<typename ValueType>
+    FscSimulator<ValueType>::AliasTable::AliasTable(std::vector<uint64_t> values, std::vector<double> probabilities)
+    : value(std::move(values)) {
+        uint64_t size = value.size();
+        alias.resize(size,0);
+        accept.assign(size,1.0);
+        // Walker's method: split buckets into underfull and overfull and pair them up
+        std::vector<double> scaled(size);
+        std::vector<uint64_t> underfull;
+        std::vector<uint64_t> overfull;
+        for(uint64_t bucket = 0; bucket < size; ++bucket) {
+            scaled[bucket] = probabilities[bucket]*size;
+            (scaled[bucket] < 1.0 ? underfull : overfull).push_back(bucket);
+        }
+        while(not underfull.empty() and not overfull.empty()) {
+            uint64_t small = underfull.back(); underfull.pop_back();
+            uint64_t large = overfull.back(); overfull.pop_back();
+            accept[small] = scaled[small];
+            alias[small] = large;
+            scaled[large] -= 1.0-scaled[small];
+            (scaled[large] < 1.0 ? underfull : overfull).push_back(large);
+        }
+        // leftovers are full buckets up to rounding
+    }
+
+    template<typename ValueType>
+    uint64_t FscSimulator<ValueType>::AliasTable::sample(double uniform_bucket, double uniform_accept) const {
+        uint64_t bucket = (uint64_t)(uniform_bucket*value.size());
+        if(bucket >= value.size()) {
+            bucket = value.size()-1;
+        }
+        return uniform_accept < accept[bucket] ? value[bucket] : value[alias[bucket]];
+    }
+
+    template<typename ValueType>
+    FscSimulator<ValueType>::FscSimulator(
+        storm::models::sparse::Model<ValueType> const& quotient,
+        std::vector<uint32_t> const& state_to_obs_class,
+        uint64_t num_actions,
+        std::vector<uint64_t> const& choice_to_action
+    ) : quotient(quotient), state_to_obs_class(state_to_obs_class),
+        num_actions(num_actions), choice_to_action(choice_to_action) {
+
+        this->initial_state = *(this->quotient.getInitialStates().begin());
+        std::vector<uint64_t> const& row_groups = this->quotient.getTransitionMatrix().getRowGroupIndices();
+        this->state_action_choices.resize(this->quotient.getNumberOfStates());
+        for(uint64_t state = 0; state < this->quotient.getNumberOfStates(); ++state) {
+            this->state_action_choices[state].resize(this->num_actions);
+            for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+                this->state_action_choices[state][this->choice_to_action[choice]].push_back(choice);
+            }
+        }
+        // preprocess transition rows into alias tables
+        this->choice_row_table.resize(this->quotient.getNumberOfChoices());
+        std::vector<uint64_t> destinations;
+        std::vector<double> probabilities;
+        for(uint64_t choice = 0; choice < this->quotient.getNumberOfChoices(); ++choice) {
+            destinations.clear();
+            probabilities.clear();
+            for(auto const& entry: this->quotient.getTransitionMatrix().getRow(choice)) {
+                destinations.push_back(entry.getColumn());
+                probabilities.push_back(storm::utility::convertNumber<double>(entry.getValue()));
+            }
+            this->choice_row_table[choice] = AliasTable(destinations,probabilities);
+        }
+    }
+
+    template<typename ValueType>
+    std::map<std::string,double> FscSimulator<ValueType>::simulate(
+        std::vector<std::vector<std::map<uint64_t,double>>> const& action_function,
+        std::vector<std::vector<std::map<uint64_t,double>>> const& update_function,
+        std::string const& target_label,
+        uint64_t num_rollouts,
+        uint64_t rollout_length,
+        uint64_t seed,
+        uint64_t num_threads
+    ) {
+        STORM_LOG_THROW(
+            this->quotient.getStateLabeling().containsLabel(target_label),
+            storm::exceptions::InvalidArgumentException, "unexpected label " << target_label
+        );
+        storm::storage::BitVector const& target_states = this->quotient.getStateLabeling().getStates(target_label);
+        uint64_t num_nodes = action_function.size();
+
+        // preprocess FSC cells into alias tables
+        std::vector<std::vector<AliasTable>> action_table(num_nodes);
+        std::vector<std::vector<AliasTable>> update_table(num_nodes);
+        std::vector<uint64_t> values;
+        std::vector<double> probabilities;
+        for(uint64_t node = 0; node < num_nodes; ++node) {
+            for(auto const& cell: action_function[node]) {
+                values.clear();
+                probabilities.clear();
+                for(auto const& [action,prob]: cell) {
+                    values.push_back(action);
+                    probabilities.push_back(prob);
+                }
+                action_table[node].push_back(AliasTable(values,probabilities));
+            }
+            for(auto const& cell: update_function[node]) {
+                values.clear();
+                probabilities.clear();
+                for(auto const& [memory,prob]: cell) {
+                    values.push_back(memory);
+                    probabilities.push_back(prob);
+                }
+                update_table[node].push_back(AliasTable(values,probabilities));
+            }
+        }
+
+        uint64_t num_workers = std::max<uint64_t>(num_threads,1);
+        num_workers = std::min<uint64_t>(num_workers,num_rollouts);
+        num_workers = std::max<uint64_t>(num_workers,1);
+        std::vector<uint64_t> worker_hits(num_workers,0);
+        std::vector<uint64_t> worker_steps_to_hit(num_workers,0);
+        std::vector<uint64_t> worker_invalid(num_workers,0);
+        auto simulateBatch = [&](uint64_t worker, uint64_t batch_size) {
+            Xoshiro256 rng(seed + worker);
+            for(uint64_t rollout = 0; rollout < batch_size; ++rollout) {
+                uint64_t state = this->initial_state;
+                uint64_t node = 0;
+                for(uint64_t step = 0; step <= rollout_length; ++step) {
+                    if(target_states[state]) {
+                        ++worker_hits[worker];
+                        worker_steps_to_hit[worker] += step;
+                        break;
+                    }
+                    if(step == rollout_length) {
+                        break;
+                    }
+                    uint64_t obs_class = this->state_to_obs_class[state];
+                    uint64_t action = action_table[node][obs_class].sample(rng.nextUniform(),rng.nextUniform());
+                    node = update_table[node][obs_class].sample(rng.nextUniform(),rng.nextUniform());
+                    std::vector<uint64_t> const& variants = this->state_action_choices[state][action];
+                    if(variants.empty()) {
+                        // the FSC picked an action unavailable in this state
+                        ++worker_invalid[worker];
+                        break;
+                    }
+                    uint64_t variant = 0;
+                    if(variants.size() > 1) {
+                        variant = (uint64_t)(rng.nextUniform()*variants.size());
+                        if(variant >= variants.size()) {
+                            variant = variants.size()-1;
+                        }
+                    }
+                    state = this->choice_row_table[variants[variant]].sample(rng.nextUniform(),rng.nextUniform());
+                }
+            }
+        };
+        uint64_t rollouts_per_worker = num_rollouts/num_workers;
+        uint64_t rollouts_remaining = num_rollouts%num_workers;
+        if(num_workers == 1) {
+            simulateBatch(0,num_rollouts);
+        } else {
+            std::vector<std::thread> workers;
+            workers.reserve(num_workers-1);
+            for(uint64_t worker = 1; worker < num_workers; ++worker) {
+                workers.emplace_back(simulateBatch, worker, rollouts_per_worker + (worker < rollouts_remaining ? 1 : 0));
+            }
+            simulateBatch(0, rollouts_per_worker + (0 < rollouts_remaining ? 1 : 0));
+            for(auto& worker: workers) {
+                worker.join();
+            }
+        }
+
+        uint64_t hits = 0;
+        uint64_t steps_to_hit = 0;
+        uint64_t invalid = 0;
+        for(uint64_t worker = 0; worker < num_workers; ++worker) {
+            hits += worker_hits[worker];
+            steps_to_hit += worker_steps_to_hit[worker];
+            invalid += worker_invalid[worker];
+        }
+        std::map<std::string,double> statistics;
+        statistics["rollouts"] = (double)num_rollouts;
+        statistics["target_hits"] = (double)hits;
+        statistics["target_fraction"] = num_rollouts > 0 ? (double)hits/num_rollouts : 0;
+        statistics["avg_steps_to_target"] = hits > 0 ? (double)steps_to_hit/hits : 0;
+        statistics["invalid_rollouts"] = (double)invalid;
+        return statistics;
+    }
+
+    template class FscSimulator<double>;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <storm/models/sparse/Model.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace synthesis {
+
+    /**
+     * Monte-Carlo simulator of an FSC on the quotient POMDP. Rollouts sample actions and memory
+     * updates from the FSC, a choice variant uniformly among the choices implementing the sampled
+     * action, and successors from the transition rows. All distributions are preprocessed into
+     * alias tables, so every sample is a constant-time draw, and rollout batches are partitioned
+     * across worker threads, each with an independently seeded xoshiro generator.
+     */
+    template<typename ValueType>
+    class FscSimulator {
+
+    public:
+
+        FscSimulator(
+            storm::models::sparse::Model<ValueType> const& quotient,
+            std::vector<uint32_t> const& state_to_obs_class,
+            uint64_t num_actions,
+            std::vector<uint64_t> const& choice_to_action
+        );
+
+        /**
+         * Run \p num_rollouts rollouts of at most \p rollout_length steps from the initial state
+         * of the quotient, following the given FSC from memory node 0.
+         * @param action_function for each node in the FSC and for each observation class, a
+         *  dictionary containing entries (action,probability)
+         * @param update_function for each node in the FSC and for each observation class, a
+         *  dictionary containing entries (memory,probability)
+         * @param target_label label of the target states
+         * @param num_rollouts number of rollouts
+         * @param rollout_length maximum number of steps per rollout
+         * @param seed seed of the random generator
+         * @param num_threads number of simulating threads
+         * @return a dictionary with entries "rollouts", "target_hits", "target_fraction",
+         *  "avg_steps_to_target" (over hitting rollouts) and "invalid_rollouts" (rollouts that
+         *  sampled an action unavailable in the current state and were aborted)
+         */
+        std::map<std::string,double> simulate(
+            std::vector<std::vector<std::map<uint64_t,double>>> const& action_function,
+            std::vector<std::vector<std::map<uint64_t,double>>> const& update_function,
+            std::string const& target_label,
+            uint64_t num_rollouts,
+            uint64_t rollout_length,
+            uint64_t seed,
+            uint64_t num_threads = 1
+        );
+
+    private:
+
+        /**
+         * Walker alias table of a discrete distribution: a draw picks a uniform bucket and
+         * accepts its value or takes the stored alias, i.e. two uniforms per sample regardless
+         * of the support size.
+         */
+        class AliasTable {
+        public:
+            AliasTable() = default;
+            AliasTable(std::vector<uint64_t> values, std::vector<double> probabilities);
+            /** Sample a value given two uniform draws from [0,1). */
+            uint64_t sample(double uniform_bucket, double uniform_accept) const;
+        private:
+            std::vector<uint64_t> value;
+            std::vector<uint64_t> alias;
+            std::vector<double> accept;
+        };
+
+        /** The quotient model. */
+        storm::models::sparse::Model<ValueType> const& quotient;
+        /** For each state of the quotient, its observation class. */
+        std::vector<uint32_t> state_to_obs_class;
+        /** Overall number of actions. */
+        uint64_t num_actions;
+        /** For each choice of the quotient, the corresponding action. */
+        std::vector<uint64_t> choice_to_action;
+
+        /** The initial state of the quotient. */
+        uint64_t initial_state;
+        /** For each state-action pair, a list of choices that implement this action. */
+        std::vector<std::vector<std::vector<uint64_t>>> state_action_choices;
+        /** For each choice of the quotient, the alias table of its transition row. */
+        std::vector<AliasTable> choice_row_table;
+    };
+
+}
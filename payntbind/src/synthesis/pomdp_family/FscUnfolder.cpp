@@ -1,6 +1,15 @@
 #include "FscUnfolder.h"
 
 #include "src/synthesis/translation/componentTranslations.h"
+#include "src/synthesis/verification/MdpModelChecker.h"
+
+#include <storm/environment/Environment.h>
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/modelchecker/results/ExplicitQuantitativeCheckResult.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
 
 namespace synthesis {
 
@@ -15,6 +24,12 @@ namespace synthesis {
         num_actions(num_actions), choice_to_action(choice_to_action) {
         
         this->state_translator = ItemKeyTranslator<std::pair<uint64_t,uint64_t>>();
+        this->num_obs_classes = 0;
+        for(uint64_t obs_class: this->state_to_obs_class) {
+            if(obs_class+1 > this->num_obs_classes) {
+                this->num_obs_classes = obs_class+1;
+            }
+        }
         this->state_action_choices.resize(this->quotient.getNumberOfStates());
         std::vector<uint64_t> const& row_groups = this->quotient.getTransitionMatrix().getRowGroupIndices();
         for(uint64_t state = 0; state < this->quotient.getNumberOfStates(); ++state) {
@@ -38,9 +53,81 @@ namespace synthesis {
 
     template<typename ValueType>
     uint64_t FscUnfolder<ValueType>::numberOfTranslatedStates() {
+        if(this->dense_indexing_enabled) {
+            return this->product_to_dense.size();
+        }
         return this->state_translator.numTranslations();
     }
 
+    template<typename ValueType>
+    void FscUnfolder<ValueType>::enableDenseIndexing(bool enable) {
+        this->dense_indexing_enabled = enable;
+    }
+
+    template<typename ValueType>
+    void FscUnfolder<ValueType>::enableDistributionDedup(bool enable) {
+        this->distribution_dedup_enabled = enable;
+    }
+
+    template<typename ValueType>
+    void FscUnfolder<ValueType>::computeCellRepresentatives() {
+        uint64_t num_cells = this->fsc_num_nodes*this->num_obs_classes;
+        this->cell_representative.resize(num_cells);
+        // cells are keyed by their packed distribution pair; within one observation class the
+        // first node carrying a given pair represents every later node carrying the same pair
+        std::map<std::tuple<uint64_t,std::vector<uint64_t>,std::vector<double>,std::vector<uint64_t>,std::vector<double>>,uint64_t> representative;
+        for(uint64_t node = 0; node < this->fsc_num_nodes; ++node) {
+            for(uint64_t obs_class = 0; obs_class < this->num_obs_classes; ++obs_class) {
+                uint64_t cell = node*this->num_obs_classes + obs_class;
+                auto key = std::make_tuple(
+                    obs_class,
+                    std::vector<uint64_t>(this->fsc_action_targets.begin()+this->fsc_action_offsets[cell],this->fsc_action_targets.begin()+this->fsc_action_offsets[cell+1]),
+                    std::vector<double>(this->fsc_action_probs.begin()+this->fsc_action_offsets[cell],this->fsc_action_probs.begin()+this->fsc_action_offsets[cell+1]),
+                    std::vector<uint64_t>(this->fsc_update_targets.begin()+this->fsc_update_offsets[cell],this->fsc_update_targets.begin()+this->fsc_update_offsets[cell+1]),
+                    std::vector<double>(this->fsc_update_probs.begin()+this->fsc_update_offsets[cell],this->fsc_update_probs.begin()+this->fsc_update_offsets[cell+1])
+                );
+                auto [entry,inserted] = representative.try_emplace(std::move(key),node);
+                this->cell_representative[cell] = entry->second;
+            }
+        }
+    }
+
+    template<typename ValueType>
+    uint64_t FscUnfolder<ValueType>::denseIndex(uint64_t state, uint64_t memory, uint64_t action) {
+        return (state*this->fsc_num_nodes + memory)*(this->num_actions+1) + action;
+    }
+
+    template<typename ValueType>
+    uint64_t FscUnfolder<ValueType>::translateProductState(uint64_t state, uint64_t memory, uint64_t action) {
+        if(this->distribution_dedup_enabled) {
+            // a product state only ever consults the cell of its node and observation, so nodes
+            // behaving identically for this observation collapse onto the representative
+            memory = this->cell_representative[memory*this->num_obs_classes + this->state_to_obs_class[state]];
+        }
+        if(not this->dense_indexing_enabled) {
+            return this->state_translator.translate(state,std::make_pair(memory,action));
+        }
+        uint64_t dense_index = this->denseIndex(state,memory,action);
+        if(this->dense_epoch[dense_index] != this->dense_current_epoch) {
+            this->dense_epoch[dense_index] = this->dense_current_epoch;
+            this->dense_to_product[dense_index] = this->product_to_dense.size();
+            this->product_to_dense.push_back(dense_index);
+        }
+        return this->dense_to_product[dense_index];
+    }
+
+    template<typename ValueType>
+    std::tuple<uint64_t,uint64_t,uint64_t> FscUnfolder<ValueType>::retrieveProductState(uint64_t translated_state) {
+        if(not this->dense_indexing_enabled) {
+            auto[state,memory_action] = this->state_translator.retrieve(translated_state);
+            return std::make_tuple(state,memory_action.first,memory_action.second);
+        }
+        uint64_t dense_index = this->product_to_dense[translated_state];
+        uint64_t action = dense_index % (this->num_actions+1);
+        dense_index /= this->num_actions+1;
+        return std::make_tuple(dense_index/this->fsc_num_nodes, dense_index%this->fsc_num_nodes, action);
+    }
+
     template<typename ValueType>
     uint64_t FscUnfolder<ValueType>::numberOfTranslatedChoices() {
         return this->product_choice_to_choice.size();
@@ -50,25 +137,32 @@ namespace synthesis {
     uint64_t FscUnfolder<ValueType>::translateInitialState() {
         uint64_t initial_state = *(this->quotient.getInitialStates().begin());
         uint64_t initial_memory = 0;
-        return this->state_translator.translate(initial_state,std::make_pair(initial_memory,invalidAction()));
+        return this->translateProductState(initial_state,initial_memory,invalidAction());
     }
     
     
     template<typename ValueType>
-    void FscUnfolder<ValueType>::buildStateSpace(
-        std::vector<std::vector<std::map<uint64_t,double>>> action_function,
-        std::vector<std::vector<std::map<uint64_t,double>>> update_function
-    ) {
-        this->state_translator.resize(this->quotient.getNumberOfStates());
+    void FscUnfolder<ValueType>::buildStateSpace() {
+        if(this->dense_indexing_enabled) {
+            uint64_t dense_size = this->denseIndex(this->quotient.getNumberOfStates()-1,this->fsc_num_nodes-1,invalidAction())+1;
+            if(this->dense_to_product.size() < dense_size) {
+                this->dense_to_product.resize(dense_size);
+                this->dense_epoch.assign(dense_size,0);
+                this->dense_current_epoch = 0;
+            }
+            this->dense_current_epoch++;
+            this->product_to_dense.clear();
+        } else {
+            this->state_translator.resize(this->quotient.getNumberOfStates());
+        }
         uint64_t translated_state = this->translateInitialState();
         while(true) {
-            auto[state,memory_action] = this->state_translator.retrieve(translated_state);
-            auto[memory,action] = memory_action;
-            uint64_t observation = this->state_to_obs_class[state];
+            auto[state,memory,action] = this->retrieveProductState(translated_state);
+            uint64_t cell = memory*this->num_obs_classes + this->state_to_obs_class[state];
             if(action == invalidAction()) {
                 // random choice of an action
-                for(auto [action,_] : action_function[memory][observation]) {
-                    this->state_translator.translate(state,std::make_pair(memory,action));
+                for(uint64_t index = this->fsc_action_offsets[cell]; index < this->fsc_action_offsets[cell+1]; ++index) {
+                    this->translateProductState(state,memory,this->fsc_action_targets[index]);
                 }
             } else { // action != invalidAction()) {
                 // executing variants of the selected actions
@@ -76,8 +170,8 @@ namespace synthesis {
                     for(auto const &entry: this->quotient.getTransitionMatrix().getRow(choice)) {
                         uint64_t state_dst = entry.getColumn();
                         // executing memory update
-                        for(auto [memory_dst,_] : update_function[memory][observation]) {
-                            this->state_translator.translate(state_dst,std::make_pair(memory_dst,invalidAction()));
+                        for(uint64_t index = this->fsc_update_offsets[cell]; index < this->fsc_update_offsets[cell+1]; ++index) {
+                            this->translateProductState(state_dst,this->fsc_update_targets[index],invalidAction());
                         }
                     }
                 }
@@ -88,29 +182,32 @@ namespace synthesis {
             }
         }
 
-        this->product_state_to_state = this->state_translator.translationToItem();
+        if(this->dense_indexing_enabled) {
+            this->product_state_to_state.resize(numberOfTranslatedStates());
+            for(uint64_t product_state = 0; product_state < numberOfTranslatedStates(); ++product_state) {
+                this->product_state_to_state[product_state] = std::get<0>(this->retrieveProductState(product_state));
+            }
+        } else {
+            this->product_state_to_state = this->state_translator.translationToItem();
+        }
         // this->product_state_to_state_memory_action = this->state_translator.translationToItemKey();
     }
 
     template<typename ValueType>
-    storm::storage::SparseMatrix<ValueType> FscUnfolder<ValueType>::buildTransitionMatrix(
-        std::vector<std::vector<std::map<uint64_t,double>>> action_function,
-        std::vector<std::vector<std::map<uint64_t,double>>> update_function
-    ) {
+    storm::storage::SparseMatrix<ValueType> FscUnfolder<ValueType>::buildTransitionMatrix() {
         this->product_choice_to_choice.clear();
         storm::storage::SparseMatrixBuilder<ValueType> builder(0, 0, 0, false, true, 0);
         for(uint64_t translated_state = 0; translated_state < numberOfTranslatedStates(); ++translated_state) {
             builder.newRowGroup(numberOfTranslatedChoices());
-            auto[state,memory_action] = this->state_translator.retrieve(translated_state);
-            auto[memory,action] = memory_action;
-            uint64_t observation = this->state_to_obs_class[state];
+            auto[state,memory,action] = this->retrieveProductState(translated_state);
+            uint64_t cell = memory*this->num_obs_classes + this->state_to_obs_class[state];
             if(action == invalidAction()) {
                 // random choice of an action
                 uint64_t product_choice = numberOfTranslatedChoices();
                 this->product_choice_to_choice.push_back(invalidChoice());
-                for(auto [action,prob] : action_function[memory][observation]) {
-                    uint64_t translated_dst = this->state_translator.translate(state,std::make_pair(memory,action));
-                    builder.addNextValue(product_choice, translated_dst, prob);
+                for(uint64_t index = this->fsc_action_offsets[cell]; index < this->fsc_action_offsets[cell+1]; ++index) {
+                    uint64_t translated_dst = this->translateProductState(state,memory,this->fsc_action_targets[index]);
+                    builder.addNextValue(product_choice, translated_dst, this->fsc_action_probs[index]);
                 }
             } else { // action == invalidAction()
                 // executing variants of the selected actions
@@ -120,9 +217,9 @@ namespace synthesis {
                     for(auto const &entry: this->quotient.getTransitionMatrix().getRow(choice)) {
                         uint64_t state_dst = entry.getColumn();
                         // executing memory update
-                        for(auto [memory_dst,prob] : update_function[memory][observation]) {
-                            uint64_t translated_dst = this->state_translator.translate(state_dst,std::make_pair(memory_dst,invalidAction()));
-                            builder.addNextValue(product_choice, translated_dst, entry.getValue()*prob);
+                        for(uint64_t index = this->fsc_update_offsets[cell]; index < this->fsc_update_offsets[cell+1]; ++index) {
+                            uint64_t translated_dst = this->translateProductState(state_dst,this->fsc_update_targets[index],invalidAction());
+                            builder.addNextValue(product_choice, translated_dst, entry.getValue()*this->fsc_update_probs[index]);
                         }
                     }
                 }
@@ -138,14 +235,70 @@ namespace synthesis {
         std::vector<std::vector<std::map<uint64_t,double>>> action_function,
         std::vector<std::vector<std::map<uint64_t,double>>> update_function
     ) {
-        this->buildStateSpace(action_function,update_function);
+        // flatten the per-cell maps into the CSR members
+        this->fsc_num_nodes = action_function.size();
+        uint64_t num_cells = this->fsc_num_nodes*this->num_obs_classes;
+        this->fsc_action_offsets.assign(num_cells+1,0);
+        this->fsc_action_targets.clear();
+        this->fsc_action_probs.clear();
+        this->fsc_update_offsets.assign(num_cells+1,0);
+        this->fsc_update_targets.clear();
+        this->fsc_update_probs.clear();
+        for(uint64_t node = 0; node < this->fsc_num_nodes; ++node) {
+            for(uint64_t obs_class = 0; obs_class < this->num_obs_classes; ++obs_class) {
+                uint64_t cell = node*this->num_obs_classes + obs_class;
+                for(auto [action,prob] : action_function[node][obs_class]) {
+                    this->fsc_action_targets.push_back(action);
+                    this->fsc_action_probs.push_back(prob);
+                }
+                this->fsc_action_offsets[cell+1] = this->fsc_action_targets.size();
+                for(auto [memory_dst,prob] : update_function[node][obs_class]) {
+                    this->fsc_update_targets.push_back(memory_dst);
+                    this->fsc_update_probs.push_back(prob);
+                }
+                this->fsc_update_offsets[cell+1] = this->fsc_update_targets.size();
+            }
+        }
+        this->unfold();
+    }
+
+    template<typename ValueType>
+    void FscUnfolder<ValueType>::applyFscFlat(
+        std::vector<uint64_t> action_offsets,
+        std::vector<uint64_t> action_targets,
+        std::vector<double> action_probs,
+        std::vector<uint64_t> update_offsets,
+        std::vector<uint64_t> update_targets,
+        std::vector<double> update_probs
+    ) {
+        STORM_LOG_THROW(
+            action_offsets.size() > 1 and (action_offsets.size()-1) % this->num_obs_classes == 0
+                and action_offsets.size() == update_offsets.size(),
+            storm::exceptions::InvalidArgumentException, "malformed FSC offset arrays"
+        );
+        this->fsc_num_nodes = (action_offsets.size()-1)/this->num_obs_classes;
+        this->fsc_action_offsets = std::move(action_offsets);
+        this->fsc_action_targets = std::move(action_targets);
+        this->fsc_action_probs = std::move(action_probs);
+        this->fsc_update_offsets = std::move(update_offsets);
+        this->fsc_update_targets = std::move(update_targets);
+        this->fsc_update_probs = std::move(update_probs);
+        this->unfold();
+    }
+
+    template<typename ValueType>
+    void FscUnfolder<ValueType>::unfold() {
+        if(this->distribution_dedup_enabled) {
+            this->computeCellRepresentatives();
+        }
+        this->buildStateSpace();
         storm::storage::sparse::ModelComponents<ValueType> components;
         auto translated_initial_state = this->translateInitialState();
         components.stateLabeling = synthesis::translateStateLabeling(
-            this->quotient,this->state_translator.translationToItem(),translated_initial_state
+            this->quotient,this->product_state_to_state,translated_initial_state
         );
         
-        components.transitionMatrix = this->buildTransitionMatrix(action_function,update_function);
+        components.transitionMatrix = this->buildTransitionMatrix();
         storm::storage::BitVector translated_choice_mask(numberOfTranslatedChoices(),true);
         auto quotient_num_choices = this->quotient.getNumberOfChoices();
         for(uint64_t translated_choice = 0; translated_choice<numberOfTranslatedChoices(); ++translated_choice) {
@@ -163,6 +316,62 @@ namespace synthesis {
         this->product = std::make_shared<storm::models::sparse::Mdp<ValueType>>(std::move(components));
     }
 
+    template<typename ValueType>
+    std::vector<double> FscUnfolder<ValueType>::evaluateFscs(
+        std::vector<std::vector<std::vector<std::map<uint64_t,double>>>> const& action_functions,
+        std::vector<std::vector<std::vector<std::map<uint64_t,double>>>> const& update_functions,
+        std::shared_ptr<storm::logic::Formula const> formula,
+        uint64_t num_threads
+    ) {
+        STORM_LOG_THROW(
+            action_functions.size() == update_functions.size(), storm::exceptions::InvalidArgumentException,
+            "the numbers of action and update functions differ"
+        );
+        STORM_LOG_THROW(num_threads > 0, storm::exceptions::InvalidArgumentException, "number of threads must be positive");
+        uint64_t num_fscs = action_functions.size();
+        std::vector<double> fsc_values(num_fscs,0);
+
+        auto evaluateRange = [&](FscUnfolder<ValueType> *unfolder, uint64_t fsc_begin, uint64_t fsc_end) {
+            storm::Environment env;
+            for(uint64_t fsc = fsc_begin; fsc < fsc_end; ++fsc) {
+                unfolder->applyFsc(action_functions[fsc],update_functions[fsc]);
+                auto result = synthesis::verifyMdp<ValueType>(env,unfolder->product,*formula,false);
+                uint64_t product_initial_state = *(unfolder->product->getInitialStates().begin());
+                fsc_values[fsc] = result->template asExplicitQuantitativeCheckResult<ValueType>()[product_initial_state];
+            }
+        };
+
+        if(num_threads == 1 or num_fscs <= 1) {
+            evaluateRange(this,0,num_fscs);
+            return fsc_values;
+        }
+
+        // partition the batch across worker unfolders, evaluating the first partition on this one
+        if(num_threads > num_fscs) {
+            num_threads = num_fscs;
+        }
+        std::vector<std::unique_ptr<FscUnfolder<ValueType>>> workers;
+        for(uint64_t worker = 1; worker < num_threads; ++worker) {
+            workers.push_back(std::make_unique<FscUnfolder<ValueType>>(
+                this->quotient,this->state_to_obs_class,this->num_actions,this->choice_to_action
+            ));
+            workers.back()->enableDenseIndexing(this->dense_indexing_enabled);
+            workers.back()->enableDistributionDedup(this->distribution_dedup_enabled);
+        }
+        uint64_t fscs_per_thread = (num_fscs+num_threads-1)/num_threads;
+        std::vector<std::thread> threads;
+        for(uint64_t worker = 1; worker < num_threads; ++worker) {
+            uint64_t fsc_begin = worker*fscs_per_thread;
+            uint64_t fsc_end = std::min(fsc_begin+fscs_per_thread,num_fscs);
+            threads.emplace_back(evaluateRange,workers[worker-1].get(),fsc_begin,fsc_end);
+        }
+        evaluateRange(this,0,std::min(fscs_per_thread,num_fscs));
+        for(auto& thread: threads) {
+            thread.join();
+        }
+        return fsc_values;
+    }
+
     template<typename ValueType>
     void FscUnfolder<ValueType>::clearMemory() {
         this->state_translator.clear();
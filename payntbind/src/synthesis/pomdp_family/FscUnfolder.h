@@ -7,6 +7,9 @@
 #include <storm/models/sparse/Mdp.h>
 #include <storm/storage/BitVector.h>
 
+#include <map>
+#include <tuple>
+
 
 namespace synthesis {
     
@@ -35,6 +38,65 @@ namespace synthesis {
             std::vector<std::vector<std::map<uint64_t,double>>> update_function
         );
 
+        /**
+         * Create a product of the quotient POMDP and the given FSC, passed in flat CSR form: the
+         * distribution of cell (node,observation class) occupies entries
+         * [offsets[node*num_classes+class], offsets[node*num_classes+class+1]) of the target and
+         * probability arrays. Avoids marshalling and iterating per-cell maps.
+         * @param action_offsets offsets into the action distributions
+         * @param action_targets actions, concatenated over all cells
+         * @param action_probs action probabilities, concatenated over all cells
+         * @param update_offsets offsets into the update distributions
+         * @param update_targets memory updates, concatenated over all cells
+         * @param update_probs update probabilities, concatenated over all cells
+         */
+        void applyFscFlat(
+            std::vector<uint64_t> action_offsets,
+            std::vector<uint64_t> action_targets,
+            std::vector<double> action_probs,
+            std::vector<uint64_t> update_offsets,
+            std::vector<uint64_t> update_targets,
+            std::vector<double> update_probs
+        );
+
+        /**
+         * Enable dense product-state indexing: since the number of FSC nodes is known upfront, product
+         * states are indexed by flat epoch-stamped arrays over (state,node,action) instead of hashing
+         * through \ref ItemKeyTranslator, removing map lookups from the product inner loop. Product
+         * indices are still assigned in exploration order, so unreachable tuples occupy no product state.
+         * Trades O(states * nodes * actions) words of memory for hash-free lookups.
+         */
+        void enableDenseIndexing(bool enable);
+
+        /**
+         * Enable distribution interning: FSC cells (node, observation class) whose action and
+         * update distributions coincide collapse onto one representative node during product
+         * construction, so repeated (observation, distribution) pairs share their product states
+         * and rows. The product then tracks the number of distinct distributions rather than
+         * the number of FSC entries; controllers from gradient-based methods carry many
+         * duplicate distributions and shrink substantially. The merged product is
+         * probabilistically equivalent to the unmerged one.
+         */
+        void enableDistributionDedup(bool enable);
+
+        /**
+         * Score a batch of FSCs against the quotient: for each FSC, construct the product and model
+         * check it, returning only the values in the product initial state. All intermediate models
+         * stay on the C++ side. With \p num_threads > 1, the batch is partitioned across worker
+         * unfolders evaluating concurrently.
+         * @param action_functions for each FSC, its action function (see \ref applyFsc)
+         * @param update_functions for each FSC, its update function
+         * @param formula formula to model check
+         * @param num_threads number of evaluating threads
+         * @return for each FSC, the model checking result in the initial state of its product
+         */
+        std::vector<double> evaluateFscs(
+            std::vector<std::vector<std::vector<std::map<uint64_t,double>>>> const& action_functions,
+            std::vector<std::vector<std::vector<std::map<uint64_t,double>>>> const& update_functions,
+            std::shared_ptr<storm::logic::Formula const> formula,
+            uint64_t num_threads = 1
+        );
+
         /** The constructed product with an FSC. */
         std::shared_ptr<storm::models::sparse::Mdp<ValueType>> product;
         /** For each choice of the product MDP, the original choice. */
@@ -71,14 +133,47 @@ namespace synthesis {
         uint64_t numberOfTranslatedStates();
         uint64_t numberOfTranslatedChoices();
 
-        void buildStateSpace(
-            std::vector<std::vector<std::map<uint64_t,double>>> action_function,
-            std::vector<std::vector<std::map<uint64_t,double>>> update_function
-        );
-        storm::storage::SparseMatrix<ValueType> buildTransitionMatrix(
-            std::vector<std::vector<std::map<uint64_t,double>>> action_function,
-            std::vector<std::vector<std::map<uint64_t,double>>> update_function
-        );
+        /** Whether product states are indexed densely instead of through \ref state_translator. */
+        bool dense_indexing_enabled = false;
+        /** Number of FSC nodes of the current unfolding (valid in dense mode). */
+        uint64_t fsc_num_nodes;
+        /** For each (state,node,action) tuple, its product state; valid if the epoch stamp is current. */
+        std::vector<uint64_t> dense_to_product;
+        /** For each (state,node,action) tuple, the epoch in which its product state was assigned. */
+        std::vector<uint64_t> dense_epoch;
+        /** Current epoch of the dense index; advanced on every unfolding. */
+        uint64_t dense_current_epoch = 0;
+        /** For each product state, its (state,node,action) tuple, flattened. */
+        std::vector<uint64_t> product_to_dense;
+
+        /** Flatten a (state,node,action) tuple (dense mode). */
+        uint64_t denseIndex(uint64_t state, uint64_t memory, uint64_t action);
+        /** Translate a product state, creating a new translation upon the first visit. */
+        uint64_t translateProductState(uint64_t state, uint64_t memory, uint64_t action);
+        /** Retrieve the (state,memory,action) tuple of a product state. */
+        std::tuple<uint64_t,uint64_t,uint64_t> retrieveProductState(uint64_t translated_state);
+
+        /** Number of observation classes of the quotient. */
+        uint64_t num_obs_classes;
+        /** The FSC of the current unfolding, in flat CSR form (see \ref applyFscFlat). */
+        std::vector<uint64_t> fsc_action_offsets;
+        std::vector<uint64_t> fsc_action_targets;
+        std::vector<double> fsc_action_probs;
+        std::vector<uint64_t> fsc_update_offsets;
+        std::vector<uint64_t> fsc_update_targets;
+        std::vector<double> fsc_update_probs;
+
+        /** Whether identical FSC cells are merged during product construction. */
+        bool distribution_dedup_enabled = false;
+        /** For each cell, the node of the first cell with the same distributions (valid when dedup is on). */
+        std::vector<uint64_t> cell_representative;
+        /** Group the cells of the current FSC by identical distributions (see \ref enableDistributionDedup). */
+        void computeCellRepresentatives();
+
+        /** Unfold the FSC stored in the flat members into \ref product. */
+        void unfold();
+        void buildStateSpace();
+        storm::storage::SparseMatrix<ValueType> buildTransitionMatrix();
 
         void clearMemory();
 
@@ -1,5 +1,7 @@
 #include "GameAbstractionSolver.h"
 
+#include "src/synthesis/BitVectorPool.h"
+#include "src/synthesis/Trace.h"
 #include "src/synthesis/pomdp_family/SmgAbstraction.h"
 #include "src/synthesis/smg/smgModelChecker.h"
 #include "src/synthesis/translation/componentTranslations.h"
@@ -7,12 +9,14 @@
 #include "src/synthesis/translation/ItemTranslator.h"
 
 #include <storm/environment/solver/GameSolverEnvironment.h>
+#include <storm/exceptions/InvalidArgumentException.h>
 #include <storm/environment/solver/NativeSolverEnvironment.h>
 #include <storm/models/sparse/Smg.h>
 #include <storm/solver/GameSolver.h>
 #include <storm/storage/PlayerIndex.h>
 #include <storm/utility/builder.h>
 
+#include <cmath>
 #include <queue>
 
 namespace synthesis {
@@ -27,7 +31,7 @@ namespace synthesis {
         std::string const& target_label,
         double precision
     ) : quotient(quotient), quotient_num_actions(quotient_num_actions), choice_to_action(choice_to_action),
-        player1_maximizing(player1_maximizing) {
+        player1_maximizing(player1_maximizing), formula(formula), target_label(target_label), precision(precision) {
 
         auto quotient_num_states = quotient.getNumberOfStates();
         auto quotient_num_choices = quotient.getNumberOfChoices();
@@ -59,11 +63,11 @@ namespace synthesis {
     
     template<typename ValueType>
     void GameAbstractionSolver<ValueType>::setupSolverEnvironment(double precision) {
-        this->env.solver().game().setPrecision(storm::utility::convertNumber<storm::RationalNumber>(precision));
+        this->setSolverPrecision(precision);
 
         // value iteration
         // this->env.solver().game().setMethod(storm::solver::GameMethod::ValueIteration);
-        
+
         // policy iteration
         this->env.solver().game().setMethod(storm::solver::GameMethod::PolicyIteration);
         this->env.solver().setLinearEquationSolverType(storm::solver::EquationSolverType::Native);
@@ -71,6 +75,26 @@ namespace synthesis {
         this->env.solver().setLinearEquationSolverPrecision(env.solver().game().getPrecision());
     }
 
+    template<typename ValueType>
+    void GameAbstractionSolver<ValueType>::setSolverPrecision(double precision) {
+        this->env.solver().game().setPrecision(storm::utility::convertNumber<storm::RationalNumber>(precision));
+        this->env.solver().setLinearEquationSolverPrecision(env.solver().game().getPrecision());
+    }
+
+    template<typename ValueType>
+    void GameAbstractionSolver<ValueType>::enableAdaptivePrecision(double coarse_precision, double threshold, double epsilon) {
+        this->adaptive_precision_enabled = true;
+        this->coarse_precision = coarse_precision;
+        this->threshold = threshold;
+        this->threshold_epsilon = epsilon;
+    }
+
+    template<typename ValueType>
+    void GameAbstractionSolver<ValueType>::disableAdaptivePrecision() {
+        this->adaptive_precision_enabled = false;
+        this->setSolverPrecision(this->precision);
+    }
+
     
     template<typename ValueType>
     storm::OptimizationDirection GameAbstractionSolver<ValueType>::getOptimizationDirection(bool maximizing) {
@@ -80,9 +104,24 @@ namespace synthesis {
 
     template<typename ValueType>
     void GameAbstractionSolver<ValueType>::solveSg(storm::storage::BitVector const& quotient_choice_mask) {
+        PAYNT_TRACE_SCOPE("game.solveSg");
+        if(this->solution_cache_enabled) {
+            auto cached_solution = this->solution_cache.find(quotient_choice_mask);
+            if(cached_solution != this->solution_cache.end()) {
+                // the same restricted game has been solved before
+                auto const& solution = cached_solution->second;
+                this->solution_state_values = solution.state_values;
+                this->solution_value = solution.value;
+                this->solution_state_to_player1_action = solution.state_to_player1_action;
+                this->solution_state_to_quotient_choice = solution.state_to_quotient_choice;
+                this->solution_valid = true;
+                return;
+            }
+        }
         if(profiling_enabled) {
             this->timer_total.start();
         }
+        this->solution_interrupted = false;
 
         uint64_t quotient_num_states = this->quotient.getNumberOfStates();
         uint64_t quotient_num_choices = this->quotient.getNumberOfChoices();
@@ -94,7 +133,7 @@ namespace synthesis {
         std::vector<std::vector<uint64_t>> player2_state_to_choices;
         
         std::queue<uint64_t> unexplored_states;
-        storm::storage::BitVector state_is_encountered(quotient_num_states);
+        auto state_is_encountered = bitVectorPool().acquire(quotient_num_states);
         unexplored_states.push(quotient_initial_state);
         state_is_encountered.set(quotient_initial_state,true);
         auto const& quotient_row_group_indices = this->quotient.getTransitionMatrix().getRowGroupIndices();
@@ -121,6 +160,7 @@ namespace synthesis {
                 }
             }
         }
+        bitVectorPool().release(std::move(state_is_encountered));
         uint64_t player1_num_states = state_to_player1_state.numTranslations();
         uint64_t player2_num_states = state_action_to_player2_state.numTranslations();
         
@@ -128,35 +168,61 @@ namespace synthesis {
         uint64_t player1_target_state = player1_num_states++;
         uint64_t player2_target_state = player2_num_states++;
 
-        // build the matrix of Player 1
-        std::vector<uint64_t> player1_choice_to_action;
-        storm::storage::SparseMatrixBuilder<storm::storage::sparse::state_type> player1_matrix_builder(0,0,0,false,true);
-        uint64_t player1_num_rows = 0;
-        for(uint64_t player1_state=0; player1_state<player1_num_states-1; player1_state++) {
-            player1_matrix_builder.newRowGroup(player1_num_rows);
-            uint64_t state = state_to_player1_state.retrieve(player1_state);
-            for(uint64_t action: player1_state_to_actions[player1_state]) {
-                player1_choice_to_action.push_back(action);
-                uint64_t player2_state = state_action_to_player2_state.translate(state,action);
-                player1_matrix_builder.addNextValue(player1_num_rows,player2_state,1);
-                player1_num_rows++;
+        // check whether the game skeleton matches the previous construction: if so, the Player 1
+        // matrix can be reused and only Player 2 buckets containing changed choices are recomputed
+        bool skeleton_match = this->cached_choice_mask.size() == quotient_choice_mask.size()
+            and state_to_player1_state.translationToItem() == this->cached_player1_state_to_state
+            and player1_state_to_actions == this->cached_player1_state_to_actions
+            and state_action_to_player2_state.translationToItemKey() == this->cached_player2_state_to_state_action;
+
+        if(not skeleton_match) {
+            // build the matrix of Player 1
+            std::vector<uint64_t> player1_choice_to_action;
+            storm::storage::SparseMatrixBuilder<storm::storage::sparse::state_type> player1_matrix_builder(0,0,0,false,true);
+            uint64_t player1_num_rows = 0;
+            for(uint64_t player1_state=0; player1_state<player1_num_states-1; player1_state++) {
+                player1_matrix_builder.newRowGroup(player1_num_rows);
+                uint64_t state = state_to_player1_state.retrieve(player1_state);
+                for(uint64_t action: player1_state_to_actions[player1_state]) {
+                    player1_choice_to_action.push_back(action);
+                    uint64_t player2_state = state_action_to_player2_state.translate(state,action);
+                    player1_matrix_builder.addNextValue(player1_num_rows,player2_state,1);
+                    player1_num_rows++;
+                }
             }
+            // fresh target state of Player 1
+            player1_matrix_builder.newRowGroup(player1_num_rows);
+            player1_matrix_builder.addNextValue(player1_num_rows,player2_target_state,1);
+            player1_num_rows++;
+            this->cached_player1_matrix = player1_matrix_builder.build();
+            this->cached_player1_choice_to_action = std::move(player1_choice_to_action);
         }
-        // fresh target state of Player 1
-        player1_matrix_builder.newRowGroup(player1_num_rows);
-        player1_matrix_builder.addNextValue(player1_num_rows,player2_target_state,1);
-        player1_num_rows++;
-        auto player1_matrix = player1_matrix_builder.build();
 
-        
         // build the matrix of Player 2
         std::vector<uint64_t> player2_choice_to_quotient_choice;
         storm::storage::SparseMatrixBuilder<ValueType> player2_matrix_builder(0,0,0,false,true);
         // build the reward vector
         std::vector<double> player2_row_rewards;
         uint64_t player2_num_rows = 0;
+        auto const& cached_player2_row_group_indices = this->cached_player2_matrix.getRowGroupIndices();
         for(uint64_t player2_state=0; player2_state<player2_num_states-1; player2_state++) {
             player2_matrix_builder.newRowGroup(player2_num_rows);
+            if(skeleton_match and player2_state_to_choices[player2_state] == this->cached_player2_state_to_choices[player2_state]) {
+                // bucket untouched by the mask diff: copy its translated rows from the cached matrix
+                for(
+                    uint64_t cached_row = cached_player2_row_group_indices[player2_state];
+                    cached_row < cached_player2_row_group_indices[player2_state+1];
+                    cached_row++
+                ) {
+                    for(auto const& entry: this->cached_player2_matrix.getRow(cached_row)) {
+                        player2_matrix_builder.addNextValue(player2_num_rows,entry.getColumn(),entry.getValue());
+                    }
+                    player2_choice_to_quotient_choice.push_back(this->cached_player2_choice_to_quotient_choice[cached_row]);
+                    player2_row_rewards.push_back(this->cached_player2_row_rewards[cached_row]);
+                    player2_num_rows++;
+                }
+                continue;
+            }
             auto [state,action] = state_action_to_player2_state.retrieve(player2_state);
             if(state_is_target[state]) {
                 // target state, transition to the target state of Player 1 and gain unit reward
@@ -185,7 +251,30 @@ namespace synthesis {
         player2_choice_to_quotient_choice.push_back(quotient_num_choices);
         player2_row_rewards.push_back(0);
         player2_num_rows++;
-        auto player2_matrix = player2_matrix_builder.build();
+        this->cached_player2_matrix = player2_matrix_builder.build();
+        this->cached_player2_choice_to_quotient_choice = std::move(player2_choice_to_quotient_choice);
+        this->cached_player2_row_rewards = player2_row_rewards;
+
+        // remember the skeleton of this construction for the next diff
+        this->cached_choice_mask = quotient_choice_mask;
+        this->cached_player1_state_to_state = state_to_player1_state.translationToItem();
+        this->cached_player1_state_to_actions = player1_state_to_actions;
+        this->cached_player2_state_to_state_action = state_action_to_player2_state.translationToItemKey();
+        this->cached_player2_state_to_choices = player2_state_to_choices;
+
+        auto const& player1_matrix = this->cached_player1_matrix;
+        auto const& player2_matrix = this->cached_player2_matrix;
+        auto const& player1_choice_to_action = this->cached_player1_choice_to_action;
+        auto const& player2_choice_to_quotient_choice = this->cached_player2_choice_to_quotient_choice;
+
+        // the game is built; bail out before the solve if the token has fired in the meantime
+        if(this->cancellation_token != nullptr and this->cancellation_token->isCancelled()) {
+            this->solution_interrupted = true;
+            if(profiling_enabled) {
+                this->timer_total.stop();
+            }
+            return;
+        }
 
         // solve the game
         auto solver = storm::solver::GameSolverFactory<ValueType>().create(env, player1_matrix, player2_matrix);
@@ -193,10 +282,38 @@ namespace synthesis {
         auto player1_direction = this->getOptimizationDirection(this->player1_maximizing);
         auto player2_direction = this->getOptimizationDirection(not this->player1_maximizing);
         std::vector<double> player1_state_values(player1_num_states,0);
+        if(this->warm_start_enabled and this->solution_valid) {
+            // seed the iteration with the values of the previous solve
+            for(uint64_t player1_state=0; player1_state<player1_num_states-1; player1_state++) {
+                auto state = state_to_player1_state.retrieve(player1_state);
+                player1_state_values[player1_state] = this->solution_state_values[state];
+            }
+        }
         if(profiling_enabled) {
             this->timer_game_solving.start();
         }
+        if(this->adaptive_precision_enabled) {
+            this->setSolverPrecision(this->coarse_precision);
+        }
         solver->solveGame(this->env, player1_direction, player2_direction, player1_state_values, player2_row_rewards);
+        if(this->cancellation_token != nullptr) {
+            this->cancellation_token->reportProgress(1,player1_state_values[state_to_player1_state.translate(quotient_initial_state)]);
+        }
+        if(this->adaptive_precision_enabled) {
+            // refine only if the coarse value is too close to the threshold to decide the comparison
+            auto coarse_value = player1_state_values[state_to_player1_state.translate(quotient_initial_state)];
+            if(this->cancellation_token != nullptr and this->cancellation_token->isCancelled()) {
+                // keep the coarse values as a partial result
+                this->solution_interrupted = true;
+            } else if(std::abs(coarse_value - this->threshold) <= this->threshold_epsilon) {
+                this->setSolverPrecision(this->precision);
+                // the refining solve continues from the coarse values
+                solver->solveGame(this->env, player1_direction, player2_direction, player1_state_values, player2_row_rewards);
+                if(this->cancellation_token != nullptr) {
+                    this->cancellation_token->reportProgress(2,player1_state_values[state_to_player1_state.translate(quotient_initial_state)]);
+                }
+            }
+        }
         if(profiling_enabled) {
             this->timer_game_solving.stop();
         }
@@ -238,10 +355,20 @@ namespace synthesis {
         }
 
         this->solution_value = this->solution_state_values[quotient_initial_state];
+        this->solution_valid = true;
+
+        // an interrupted (coarse) solution must not be served to later identical masks
+        if(this->solution_cache_enabled and not this->solution_interrupted) {
+            this->solution_cache[quotient_choice_mask] = CachedSolution {
+                this->solution_state_values, this->solution_value,
+                this->solution_state_to_player1_action, this->solution_state_to_quotient_choice
+            };
+        }
     }
 
     template<typename ValueType>
     void GameAbstractionSolver<ValueType>::solveSmg(storm::storage::BitVector const& quotient_choice_mask) {
+        PAYNT_TRACE_SCOPE("game.solveSmg");
         if(profiling_enabled) {
             this->timer_total.start();
         }
@@ -296,9 +423,94 @@ namespace synthesis {
 
         uint64_t quotient_initial_state = *(this->quotient.getInitialStates().begin());
         this->solution_value = this->solution_state_values[quotient_initial_state];
+        this->solution_valid = true;
+    }
+
+
+    template<typename ValueType>
+    uint64_t GameAbstractionSolver<ValueType>::submitGame(storm::storage::BitVector const& quotient_choice_mask) {
+        std::unique_ptr<GameAbstractionSolver<ValueType>> worker;
+        {
+            std::lock_guard<std::mutex> lock(this->worker_mutex);
+            if(not this->idle_workers.empty()) {
+                worker = std::move(this->idle_workers.back());
+                this->idle_workers.pop_back();
+            }
+        }
+        if(worker == nullptr) {
+            worker = std::make_unique<GameAbstractionSolver<ValueType>>(
+                this->quotient, this->quotient_num_actions, this->choice_to_action, this->formula,
+                this->player1_maximizing, this->target_label, this->precision
+            );
+        }
+        worker->enableWarmStart(this->warm_start_enabled);
+        // each worker memoizes its own solutions
+        worker->enableSolutionCache(this->solution_cache_enabled);
+        // one token cancels the whole batch
+        worker->setCancellationToken(this->cancellation_token);
+
+        auto pending = std::make_unique<PendingGame>();
+        pending->solver = std::move(worker);
+        GameAbstractionSolver<ValueType> *solver = pending->solver.get();
+        pending->thread = std::thread([solver, mask = quotient_choice_mask]() {
+            solver->solveSg(mask);
+        });
+
+        std::lock_guard<std::mutex> lock(this->worker_mutex);
+        uint64_t future_id = this->pending_games.size();
+        this->pending_games.push_back(std::move(pending));
+        return future_id;
+    }
+
+    template<typename ValueType>
+    double GameAbstractionSolver<ValueType>::collectSolution(uint64_t future_id) {
+        STORM_LOG_THROW(
+            future_id < this->pending_games.size(), storm::exceptions::InvalidArgumentException,
+            "invalid future identifier"
+        );
+        auto& pending = *(this->pending_games[future_id]);
+        STORM_LOG_THROW(
+            not pending.collected, storm::exceptions::InvalidArgumentException,
+            "solution has already been collected"
+        );
+        pending.thread.join();
+        pending.collected = true;
+
+        auto const& solver = *(pending.solver);
+        this->solution_state_values = solver.solution_state_values;
+        this->solution_value = solver.solution_value;
+        this->solution_state_to_player1_action = solver.solution_state_to_player1_action;
+        this->solution_state_to_quotient_choice = solver.solution_state_to_quotient_choice;
+        this->solution_interrupted = solver.solution_interrupted;
+        this->solution_valid = true;
+
+        std::lock_guard<std::mutex> lock(this->worker_mutex);
+        this->idle_workers.push_back(std::move(pending.solver));
+        return this->solution_value;
     }
 
+    template <typename ValueType>
+    void GameAbstractionSolver<ValueType>::setCancellationToken(std::shared_ptr<CancellationToken> token) {
+        cancellation_token = token;
+    }
 
+    template <typename ValueType>
+    void GameAbstractionSolver<ValueType>::enableWarmStart(bool enable) {
+        warm_start_enabled = enable;
+    }
+
+    template <typename ValueType>
+    void GameAbstractionSolver<ValueType>::enableSolutionCache(bool enable) {
+        solution_cache_enabled = enable;
+        if(not enable) {
+            clearSolutionCache();
+        }
+    }
+
+    template <typename ValueType>
+    void GameAbstractionSolver<ValueType>::clearSolutionCache() {
+        solution_cache.clear();
+    }
 
     template <typename ValueType>
     void GameAbstractionSolver<ValueType>::enableProfiling(bool enable) {
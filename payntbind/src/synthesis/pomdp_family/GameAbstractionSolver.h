@@ -1,10 +1,17 @@
 #pragma once
 
+#include "src/synthesis/CancellationToken.h"
+
 #include <storm/models/sparse/Model.h>
 #include <storm/environment/Environment.h>
 #include <storm/utility/Stopwatch.h>
 #include <storm/logic/GameFormula.h>
 
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 namespace synthesis {
 
     template<typename ValueType>
@@ -49,6 +56,20 @@ namespace synthesis {
         void solveSg(storm::storage::BitVector const& quotient_choice_mask);
         void solveSmg(storm::storage::BitVector const& quotient_choice_mask);
 
+        /**
+         * Submit a game for asynchronous solving. The game is solved on a worker solver in a background
+         * thread, so sibling sub-games can be solved concurrently while the caller coordinates.
+         * @param quotient_choice_mask Choices of the quotient that remained in the sub-MDP.
+         * @return an identifier to pass to \ref collectSolution
+         */
+        uint64_t submitGame(storm::storage::BitVector const& quotient_choice_mask);
+        /**
+         * Wait for a submitted game to finish and install its result into the solution members.
+         * Each submitted game must be collected exactly once.
+         * @return the value of the game in the initial state
+         */
+        double collectSolution(uint64_t future_id);
+
         /** For each state, the value of the game. */
         std::vector<double> solution_state_values;
         /** Value of the game in the initial state. */
@@ -65,6 +86,46 @@ namespace synthesis {
          */
         std::vector<uint64_t> solution_state_to_quotient_choice;
 
+        /**
+         * Enable warm-started game solving: value iteration of each \ref solveSg call is seeded with
+         * \ref solution_state_values of the previous solve (the parent family in the policy-tree loop),
+         * mapped onto the states of the current sub-game. States unseen by the previous solve start at 0.
+         */
+        void enableWarmStart(bool enable);
+
+        /**
+         * Enable the precision ladder: each \ref solveSg call first solves at \p coarse_precision and only
+         * refines to the constructor precision when the coarse game value lies within \p epsilon of
+         * \p threshold. The refining solve continues from the coarse values.
+         * @param coarse_precision precision of the first solve
+         * @param threshold the property threshold the value is compared against
+         * @param epsilon how close to the threshold the coarse value must be to trigger refinement
+         */
+        void enableAdaptivePrecision(double coarse_precision, double threshold, double epsilon);
+        void disableAdaptivePrecision();
+
+        /**
+         * Enable the solution cache: solutions of \ref solveSg are memoized by the choice mask, and a
+         * repeated mask short-circuits the solve entirely. Across a policy-tree run many distinct nodes
+         * induce the same restricted game, so duplicate masks are common.
+         */
+        void enableSolutionCache(bool enable);
+        /** Drop all memoized solutions. */
+        void clearSolutionCache();
+
+        /**
+         * Attach a cancellation token: \ref solveSg polls it between its phases (game
+         * construction, coarse solve, refining solve) and stops at the next boundary when it
+         * fires. A cancellation before any solve leaves the solution members untouched; a
+         * cancellation between the coarse and the refining solve keeps the coarse values as a
+         * partial result. Either way \ref solution_interrupted is raised. The token is also
+         * handed to the worker solvers spawned by \ref submitGame.
+         */
+        void setCancellationToken(std::shared_ptr<CancellationToken> token);
+
+        /** Whether the last solve was cut short by the cancellation token. */
+        bool solution_interrupted = false;
+
         // Profiling
         void enableProfiling(bool enable);
         void printProfiling();
@@ -76,6 +137,10 @@ namespace synthesis {
         std::vector<uint64_t> choice_to_action;
         std::shared_ptr<storm::logic::GameFormula const> game_formula;
         bool player1_maximizing;
+        /** Constructor arguments kept around to spawn worker solvers for asynchronous solving. */
+        std::shared_ptr<storm::logic::Formula const> formula;
+        std::string target_label;
+        double precision;
         
         /** Identification of target states. */
         storm::storage::BitVector state_is_target;
@@ -88,9 +153,71 @@ namespace synthesis {
         /** Solver environment. */
         storm::Environment env;
 
+        /**
+         * Cached game of the previous \ref solveSg call. Successive choice masks in the policy-tree loop differ in
+         * few choices; when the diff leaves the game skeleton (reachable states, actions, (state,action) buckets)
+         * intact, the Player 1 matrix is reused as is and the Player 2 matrix is rebuilt by copying the rows of
+         * unchanged buckets, recomputing only the buckets containing changed choices.
+         */
+        storm::storage::BitVector cached_choice_mask;
+        storm::storage::SparseMatrix<storm::storage::sparse::state_type> cached_player1_matrix;
+        storm::storage::SparseMatrix<ValueType> cached_player2_matrix;
+        std::vector<uint64_t> cached_player1_choice_to_action;
+        std::vector<uint64_t> cached_player2_choice_to_quotient_choice;
+        std::vector<double> cached_player2_row_rewards;
+        /** Game skeleton of the previous construction, used to detect structural matches. */
+        std::vector<uint64_t> cached_player1_state_to_state;
+        std::vector<std::set<uint64_t>> cached_player1_state_to_actions;
+        std::vector<std::pair<uint64_t,uint64_t>> cached_player2_state_to_state_action;
+        std::vector<std::vector<uint64_t>> cached_player2_state_to_choices;
+
         void setupSolverEnvironment(double precisions);
+        /** Set the precision of the game and linear equation solvers. */
+        void setSolverPrecision(double precision);
         storm::OptimizationDirection getOptimizationDirection(bool maximizing);
 
+        /** Whether the precision ladder is enabled. */
+        bool adaptive_precision_enabled = false;
+        /** Precision of the first solve of the ladder. */
+        double coarse_precision;
+        /** Property threshold the game value is compared against. */
+        double threshold;
+        /** Distance to the threshold below which the coarse solve is refined. */
+        double threshold_epsilon;
+
+        /** A game submitted via \ref submitGame, solved on a dedicated worker solver. */
+        struct PendingGame {
+            std::unique_ptr<GameAbstractionSolver<ValueType>> solver;
+            std::thread thread;
+            bool collected = false;
+        };
+        /** Submitted games, indexed by their identifier. */
+        std::vector<std::unique_ptr<PendingGame>> pending_games;
+        /** Worker solvers of collected games, reused by subsequent submissions. */
+        std::vector<std::unique_ptr<GameAbstractionSolver<ValueType>>> idle_workers;
+        /** Protects \p pending_games and \p idle_workers. */
+        std::mutex worker_mutex;
+
+        /** A memoized solution of \ref solveSg. */
+        struct CachedSolution {
+            std::vector<double> state_values;
+            double value;
+            std::vector<uint64_t> state_to_player1_action;
+            std::vector<uint64_t> state_to_quotient_choice;
+        };
+        /** Memoized solutions, keyed by the (exact) choice mask. */
+        std::unordered_map<storm::storage::BitVector,CachedSolution> solution_cache;
+        /** Whether solutions are memoized by the choice mask. */
+        bool solution_cache_enabled = false;
+
+        /** Cancellation token polled by the solve calls, if attached. */
+        std::shared_ptr<CancellationToken> cancellation_token;
+
+        /** Whether to seed value iteration with the solution of the previous solve. */
+        bool warm_start_enabled = false;
+        /** Whether \ref solution_state_values holds the result of a completed solve. */
+        bool solution_valid = false;
+
         // Profiling
         bool profiling_enabled = false;
         storm::utility::Stopwatch timer_total;
@@ -1,17 +1,24 @@
 #include "ObservationEvaluator.h"
 
+#include <storm/exceptions/InvalidArgumentException.h>
 #include <storm/exceptions/InvalidTypeException.h>
 #include <storm/exceptions/NotSupportedException.h>
 #include <storm/storage/expressions/ExpressionEvaluator.h>
 #include <storm-pomdp/transformer/MakePOMDPCanonic.h>
 
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
 namespace synthesis {
 
     template<typename ValueType>
     ObservationEvaluator<ValueType>::ObservationEvaluator(
         storm::prism::Program & prism,
-        storm::models::sparse::Model<ValueType> const& model
+        storm::models::sparse::Model<ValueType> const& model,
+        uint64_t num_threads
     ) {
+        STORM_LOG_THROW(num_threads > 0, storm::exceptions::InvalidArgumentException, "number of threads must be positive");
         // substitute constants and simplify formulas in the program
         prism = prism.substituteConstantsFormulas(true,true);
 
@@ -29,48 +36,176 @@ namespace synthesis {
             this->obs_expr_is_boolean[o] = obs_expr.hasBooleanType();
         }
 
-        // evaluate observation expression for each state valuation
-        storm::expressions::ExpressionEvaluator<double> evaluator(prism.getManager());
+        // lower the expressions: bare variable references are read directly from the state
+        // valuations, the remaining expressions go through the evaluator, which then only needs
+        // the variables that actually occur in them
+        std::map<storm::expressions::Variable,std::vector<uint32_t>> variable_to_bare_expressions;
+        std::vector<uint32_t> general_expressions;
+        std::set<storm::expressions::Variable> evaluator_variables;
+        for(uint32_t o = 0; o < this->num_obs_expressions; o++) {
+            auto const& obs_expr = prism.getObservationLabels()[o].getStatePredicateExpression();
+            if(obs_expr.getBaseExpression().isVariableExpression()) {
+                variable_to_bare_expressions[obs_expr.getBaseExpression().asVariableExpression().getVariable()].push_back(o);
+            } else {
+                general_expressions.push_back(o);
+                for(auto const& var: obs_expr.getVariables()) {
+                    evaluator_variables.insert(var);
+                }
+            }
+        }
+
         auto const& state_valuations = model.getStateValuations();
-        // associate each evaluation with the unique observation class
-        this->state_to_obs_class.resize(model.getNumberOfStates());
-        this->num_obs_classes = 0;
-        for(uint64_t state = 0; state < model.getNumberOfStates(); state++) {
+        uint64_t num_states = model.getNumberOfStates();
 
-            // collect state valuation into evaluator
+        // evaluate observation expressions of one state into a word per expression
+        auto evaluateState = [&](storm::expressions::ExpressionEvaluator<double>& evaluator, uint64_t state, uint64_t *evaluation_words) {
+            // collect state valuation
             for(auto it = state_valuations.at(state).begin(); it != state_valuations.at(state).end(); ++it) {
                 // we pass Jani variables to the evaluator, but it seems to work, perhaps it works with variable names
                 auto const& var = it.getVariable();
+                uint64_t value;
                 if(it.isBoolean()) {
-                    evaluator.setBooleanValue(var, it.getBooleanValue());
+                    value = it.getBooleanValue() ? 1 : 0;
+                    if(evaluator_variables.count(var) > 0) {
+                        evaluator.setBooleanValue(var, it.getBooleanValue());
+                    }
                 } else if(it.isInteger()) {
-                    evaluator.setIntegerValue(var, it.getIntegerValue());
+                    value = it.getIntegerValue();
+                    if(evaluator_variables.count(var) > 0) {
+                        evaluator.setIntegerValue(var, it.getIntegerValue());
+                    }
                 } else {
                     // this is a rational variable: we skip it in a hope that this variable encodes reward value
                     // which is not relevant for the observation
                     // evaluator.setRationalValue(var, it.getRationalValue());
+                    continue;
+                }
+                auto bare_expressions = variable_to_bare_expressions.find(var);
+                if(bare_expressions != variable_to_bare_expressions.end()) {
+                    for(uint32_t o: bare_expressions->second) {
+                        evaluation_words[o] = value;
+                    }
+                }
+            }
+            // evaluate the remaining expressions
+            for(uint32_t o: general_expressions) {
+                evaluation_words[o] = evaluator.asInt(prism.getObservationLabels()[o].getStatePredicateExpression());
+            }
+        };
+
+        std::vector<uint64_t> evaluation_words(num_states*this->num_obs_expressions,0);
+        if(num_threads == 1 or num_states < num_threads) {
+            storm::expressions::ExpressionEvaluator<double> evaluator(prism.getManager());
+            for(uint64_t state = 0; state < num_states; state++) {
+                evaluateState(evaluator,state,&evaluation_words[state*this->num_obs_expressions]);
+            }
+        } else {
+            // parallel sweep, each worker with its own evaluator
+            uint64_t states_per_thread = (num_states+num_threads-1)/num_threads;
+            auto evaluateRange = [&](uint64_t state_begin, uint64_t state_end) {
+                storm::expressions::ExpressionEvaluator<double> evaluator(prism.getManager());
+                for(uint64_t state = state_begin; state < state_end; state++) {
+                    evaluateState(evaluator,state,&evaluation_words[state*this->num_obs_expressions]);
                 }
+            };
+            std::vector<std::thread> threads;
+            for(uint64_t worker = 1; worker < num_threads; worker++) {
+                uint64_t state_begin = worker*states_per_thread;
+                uint64_t state_end = std::min(state_begin+states_per_thread,num_states);
+                threads.emplace_back(evaluateRange,state_begin,state_end);
             }
-            
-            // evaluate observation expressions and assign class
+            evaluateRange(0,states_per_thread);
+            for(auto& thread: threads) {
+                thread.join();
+            }
+        }
+
+        // associate each evaluation with the unique observation class: order states by their
+        // packed evaluation so that equal evaluations form runs and each run is classified at
+        // once, instead of a map lookup per state
+        uint64_t num_expressions = this->num_obs_expressions;
+        // ties are broken by the state index so that the first state of each run is the first
+        // state having this evaluation
+        auto evaluationLess = [&](uint64_t state1, uint64_t state2) {
+            uint64_t const* eval1 = &evaluation_words[state1*num_expressions];
+            uint64_t const* eval2 = &evaluation_words[state2*num_expressions];
+            for(uint64_t o = 0; o < num_expressions; o++) {
+                if(eval1[o] != eval2[o]) {
+                    return eval1[o] < eval2[o];
+                }
+            }
+            return state1 < state2;
+        };
+        auto evaluationEqual = [&](uint64_t state1, uint64_t state2) {
+            uint64_t const* eval1 = &evaluation_words[state1*num_expressions];
+            uint64_t const* eval2 = &evaluation_words[state2*num_expressions];
+            return std::equal(eval1,eval1+num_expressions,eval2);
+        };
+        std::vector<uint64_t> state_order(num_states);
+        std::iota(state_order.begin(),state_order.end(),0);
+        if(num_threads == 1 or num_states < num_threads) {
+            std::sort(state_order.begin(),state_order.end(),evaluationLess);
+        } else {
+            // sort per-worker blocks in parallel, then merge the sorted blocks
+            uint64_t states_per_thread = (num_states+num_threads-1)/num_threads;
+            auto sortRange = [&](uint64_t order_begin, uint64_t order_end) {
+                std::sort(state_order.begin()+order_begin,state_order.begin()+order_end,evaluationLess);
+            };
+            std::vector<std::thread> threads;
+            for(uint64_t worker = 1; worker < num_threads; worker++) {
+                uint64_t order_begin = std::min(worker*states_per_thread,num_states);
+                uint64_t order_end = std::min(order_begin+states_per_thread,num_states);
+                threads.emplace_back(sortRange,order_begin,order_end);
+            }
+            sortRange(0,states_per_thread);
+            for(auto& thread: threads) {
+                thread.join();
+            }
+            for(uint64_t width = states_per_thread; width < num_states; width *= 2) {
+                for(uint64_t order_begin = 0; order_begin+width < num_states; order_begin += 2*width) {
+                    uint64_t order_middle = order_begin+width;
+                    uint64_t order_end = std::min(order_begin+2*width,num_states);
+                    std::inplace_merge(
+                        state_order.begin()+order_begin, state_order.begin()+order_middle,
+                        state_order.begin()+order_end, evaluationLess
+                    );
+                }
+            }
+        }
+
+        // identify the runs of equal evaluations
+        std::vector<std::pair<uint64_t,uint64_t>> runs;
+        uint64_t run_begin = 0;
+        for(uint64_t index = 1; index <= num_states; index++) {
+            if(index == num_states or not evaluationEqual(state_order[index-1],state_order[index])) {
+                runs.emplace_back(run_begin,index);
+                run_begin = index;
+            }
+        }
+        // assign class ids in the order of the first state of each run, which yields the same
+        // ids as the original first-encounter scan
+        std::sort(runs.begin(),runs.end(),[&](std::pair<uint64_t,uint64_t> const& run1, std::pair<uint64_t,uint64_t> const& run2) {
+            return state_order[run1.first] < state_order[run2.first];
+        });
+        this->state_to_obs_class.resize(num_states);
+        this->num_obs_classes = 0;
+        this->obs_class_to_evaluation.reserve(runs.size());
+        for(auto const& [begin,end]: runs) {
+            uint64_t representative = state_order[begin];
             storm::storage::BitVector evaluation(OBS_EXPR_VALUE_SIZE*num_obs_expressions);
             for (uint32_t o = 0; o < num_obs_expressions; o++) {
                 evaluation.setFromInt(
                     OBS_EXPR_VALUE_SIZE*o,
                     OBS_EXPR_VALUE_SIZE,
-                    evaluator.asInt(prism.getObservationLabels()[o].getStatePredicateExpression())
+                    evaluation_words[representative*num_expressions+o]
                 );
             }
-            auto result = this->obs_evaluation_to_class.insert(std::make_pair(evaluation,this->num_obs_classes));
-            if(not result.second) {
-                // existing evaluation
-                this->state_to_obs_class[state] = result.first->second;
-            } else {
-                // new evaluation
-                this->state_to_obs_class[state] = this->num_obs_classes;
-                this->obs_class_to_evaluation.push_back(evaluation);
-                this->num_obs_classes++;
+            this->obs_class_to_evaluation.push_back(evaluation);
+            this->obs_evaluation_to_class.emplace(std::move(evaluation),this->num_obs_classes);
+            for(uint64_t index = begin; index < end; index++) {
+                this->state_to_obs_class[state_order[index]] = this->num_obs_classes;
             }
+            this->num_obs_classes++;
         }
     }
 
@@ -79,28 +214,48 @@ namespace synthesis {
         return this->obs_class_to_evaluation[obs_class].getAsInt(OBS_EXPR_VALUE_SIZE*obs_expr,OBS_EXPR_VALUE_SIZE);
     }
 
+    template<typename ValueType>
+    std::shared_ptr<storm::models::sparse::Pomdp<ValueType>> ObservationEvaluator<ValueType>::buildSubPomdp(
+        storm::storage::sparse::ModelComponents<ValueType> && components,
+        std::vector<uint64_t> const& state_sub_to_full
+    ) {
+        uint64_t num_states = state_sub_to_full.size();
+        std::vector<uint32_t> observability_classes(num_states);
+        for(uint64_t state = 0; state < num_states; state++) {
+            observability_classes[state] = this->state_to_obs_class[state_sub_to_full[state]];
+        }
+        components.observabilityClasses = std::move(observability_classes);
+
+        auto pomdp = storm::models::sparse::Pomdp<ValueType>(std::move(components));
+        auto pomdp_canonic = storm::transformer::MakePOMDPCanonic<ValueType>(pomdp).transform();
+        return pomdp_canonic;
+        // return std::make_shared<storm::models::sparse::Pomdp<ValueType>>(std::move(components));
+    }
+
     template<typename ValueType>
     std::shared_ptr<storm::models::sparse::Pomdp<ValueType>> ObservationEvaluator<ValueType>::addObservationsToSubMdp(
         storm::models::sparse::Mdp<ValueType> const& sub_mdp,
         std::vector<uint64_t> state_sub_to_full
     ) {
-
         storm::storage::sparse::ModelComponents<ValueType> components;
         components.transitionMatrix = sub_mdp.getTransitionMatrix();
         components.stateLabeling = sub_mdp.getStateLabeling();
         components.rewardModels = sub_mdp.getRewardModels();
         components.choiceLabeling = sub_mdp.getChoiceLabeling();
-        
-        std::vector<uint32_t> observability_classes(sub_mdp.getNumberOfStates());
-        for(uint64_t state = 0; state < sub_mdp.getNumberOfStates(); state++) {
-            observability_classes[state] = this->state_to_obs_class[state_sub_to_full[state]];
-        }
-        components.observabilityClasses = observability_classes;
+        return buildSubPomdp(std::move(components),state_sub_to_full);
+    }
 
-        auto pomdp = storm::models::sparse::Pomdp<ValueType>(std::move(components));
-        auto pomdp_canonic = storm::transformer::MakePOMDPCanonic<ValueType>(pomdp).transform();
-        return pomdp_canonic;
-        // return std::make_shared<storm::models::sparse::Pomdp<ValueType>>(std::move(components));
+    template<typename ValueType>
+    std::shared_ptr<storm::models::sparse::Pomdp<ValueType>> ObservationEvaluator<ValueType>::addObservationsToSubMdp(
+        storm::models::sparse::Mdp<ValueType> && sub_mdp,
+        std::vector<uint64_t> state_sub_to_full
+    ) {
+        storm::storage::sparse::ModelComponents<ValueType> components;
+        components.transitionMatrix = std::move(sub_mdp.getTransitionMatrix());
+        components.stateLabeling = std::move(sub_mdp.getStateLabeling());
+        components.rewardModels = std::move(sub_mdp.getRewardModels());
+        components.choiceLabeling = std::move(sub_mdp.getOptionalChoiceLabeling());
+        return buildSubPomdp(std::move(components),state_sub_to_full);
     }
 
     
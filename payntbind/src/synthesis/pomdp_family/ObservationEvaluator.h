@@ -5,6 +5,7 @@
 #include "storm/models/sparse/Mdp.h"
 #include "storm/models/sparse/Pomdp.h"
 #include "storm/storage/BitVector.h"
+#include "storm/storage/sparse/ModelComponents.h"
 
 namespace synthesis {
 
@@ -13,9 +14,16 @@ namespace synthesis {
 
     public:
 
+        /**
+         * Evaluate observation expressions and assign observation classes to the states of the model.
+         * Expressions that are bare variable references are read directly from the state valuations;
+         * only variables occurring in the remaining expressions are fed to the expression evaluator.
+         * @param num_threads number of threads evaluating the expressions and sorting the evaluations
+         */
         ObservationEvaluator(
             storm::prism::Program & prism,
-            storm::models::sparse::Model<ValueType> const& model
+            storm::models::sparse::Model<ValueType> const& model,
+            uint64_t num_threads = 1
         );
 
         /** Number of observation expressions. */
@@ -43,9 +51,27 @@ namespace synthesis {
             std::vector<uint64_t> state_sub_to_full
         );
 
+        /**
+         * Create a sub-POMDP from the given sub-MDP by associating its states with observations.
+         * The components of the sub-MDP are stolen instead of copied, leaving it empty; use this
+         * overload when the sub-MDP is discarded afterwards.
+         * @param mdp a sub-MDP
+         * @param state_sub_to_full for each state of the sub-MDP the index of the original state
+         */
+        std::shared_ptr<storm::models::sparse::Pomdp<ValueType>> addObservationsToSubMdp(
+            storm::models::sparse::Mdp<ValueType> && sub_mdp,
+            std::vector<uint64_t> state_sub_to_full
+        );
+
         // TODO observation valuations
 
     private:
+        /** Attach observability classes to the components and build the canonic sub-POMDP. */
+        std::shared_ptr<storm::models::sparse::Pomdp<ValueType>> buildSubPomdp(
+            storm::storage::sparse::ModelComponents<ValueType> && components,
+            std::vector<uint64_t> const& state_sub_to_full
+        );
+
         /** Bitwidth of observation expression value size. */
         static const int OBS_EXPR_VALUE_SIZE = 64;
         /** Mapping of observation expressions evaluation to a unique observation class. */
@@ -63,11 +63,35 @@ namespace synthesis {
         }
 
         uint64_t game_num_states = state_action_to_game_state.numTranslations();
-        storm::storage::SparseMatrixBuilder<ValueType> game_matrix_builder(0,0,0,false,true);
+
+        // count pass: exact numbers of game choices and matrix entries, so that the builder and
+        // the choice mappings are allocated once instead of growing row by row
+        uint64_t game_num_choices_total = 0;
+        uint64_t game_num_entries = 0;
+        for(uint64_t game_state = 0; game_state < game_num_states; ++game_state) {
+            auto [state,state_action] = state_action_to_game_state.retrieve(game_state);
+            if(state_action == quotient_num_actions) {
+                // Player 1 state: one unit-probability row per enabled action
+                game_num_choices_total += state_enabled_actions[state].size();
+                game_num_entries += state_enabled_actions[state].size();
+            } else {
+                // Player 2 state: one row per enabled choice
+                game_num_choices_total += game_state_to_choices[game_state].size();
+                for(uint64_t choice: game_state_to_choices[game_state]) {
+                    game_num_entries += quotient.getTransitionMatrix().getRow(choice).getNumberOfEntries();
+                }
+            }
+        }
+
+        storm::storage::SparseMatrixBuilder<ValueType> game_matrix_builder(
+            game_num_choices_total,game_num_states,game_num_entries,true,true,game_num_states
+        );
         uint64_t game_num_choices = 0;
         // for Player 1, contains a representative choice with the appropriate label; for Player 2, contains the corresponding choice
         std::vector<uint64_t> game_choice_to_quotient_choice;
+        game_choice_to_quotient_choice.reserve(game_num_choices_total);
         std::vector<bool> game_choice_is_player1;
+        game_choice_is_player1.reserve(game_num_choices_total);
 
         for(uint64_t game_state = 0; game_state < game_num_states; ++game_state) {
             auto [state,state_action] = state_action_to_game_state.retrieve(game_state);
@@ -28,6 +28,9 @@ public:
         storm::storage::BitVector const& quotient_choice_mask
     );
 
+    /** Create an empty abstraction to be filled by a layered builder (see \ref SmgAbstractionStack). */
+    SmgAbstraction() = default;
+
     /** The game. */
     std::shared_ptr<storm::models::sparse::Smg<ValueType>> smg;
     /**
@@ -0,0 +1,218 @@
+#include "SmgAbstractionStack.h"
+
+#include "src/synthesis/translation/componentTranslations.h"
+#include "src/synthesis/posmg/Posmg.h"
+
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/storage/PlayerIndex.h>
+#include <storm/utility/macros.h>
+
+#include <queue>
+
+namespace synthesis {
+
+    template<typename ValueType>
+    SmgAbstractionStack<ValueType>::SmgAbstractionStack(
+        storm::models::sparse::Model<ValueType> const& quotient,
+        uint64_t quotient_num_actions,
+        std::vector<uint64_t> const& choice_to_action,
+        storm::storage::BitVector const& quotient_choice_mask
+    ) : quotient(quotient), quotient_num_actions(quotient_num_actions), choice_to_action(choice_to_action),
+        coarsest_choice_mask(quotient_choice_mask) {
+        coarsest = std::make_shared<SmgAbstraction<ValueType>>(
+            quotient,quotient_num_actions,choice_to_action,quotient_choice_mask
+        );
+        level_removed_choices.emplace_back();
+    }
+
+    template<typename ValueType>
+    uint64_t SmgAbstractionStack<ValueType>::pushLevel(storm::storage::BitVector const& quotient_choice_mask) {
+        storm::storage::BitVector previous_mask = levelChoiceMask(numLevels()-1);
+        STORM_LOG_THROW(
+            quotient_choice_mask.isSubsetOf(previous_mask), storm::exceptions::InvalidArgumentException,
+            "a refinement level must enable a subset of the choices of its predecessor"
+        );
+        std::vector<uint64_t> removed_choices;
+        for(uint64_t choice: previous_mask & ~quotient_choice_mask) {
+            removed_choices.push_back(choice);
+        }
+        level_removed_choices.push_back(std::move(removed_choices));
+        return numLevels()-1;
+    }
+
+    template<typename ValueType>
+    void SmgAbstractionStack<ValueType>::popLevel() {
+        STORM_LOG_THROW(
+            numLevels() > 1, storm::exceptions::InvalidArgumentException, "the coarsest level cannot be removed"
+        );
+        level_removed_choices.pop_back();
+    }
+
+    template<typename ValueType>
+    uint64_t SmgAbstractionStack<ValueType>::numLevels() const {
+        return level_removed_choices.size();
+    }
+
+    template<typename ValueType>
+    storm::storage::BitVector SmgAbstractionStack<ValueType>::levelChoiceMask(uint64_t level) const {
+        storm::storage::BitVector mask = coarsest_choice_mask;
+        for(uint64_t l = 1; l <= level; ++l) {
+            for(uint64_t choice: level_removed_choices[l]) {
+                mask.set(choice,false);
+            }
+        }
+        return mask;
+    }
+
+    template<typename ValueType>
+    std::shared_ptr<SmgAbstraction<ValueType>> SmgAbstractionStack<ValueType>::build(uint64_t level) const {
+        STORM_LOG_THROW(
+            level < numLevels(), storm::exceptions::InvalidArgumentException, "the level is not on the stack"
+        );
+        if(level == 0) {
+            return coarsest;
+        }
+        storm::storage::BitVector quotient_choice_mask = levelChoiceMask(level);
+
+        auto const& game_matrix = coarsest->smg->getTransitionMatrix();
+        auto const& game_row_groups = game_matrix.getRowGroupIndices();
+        uint64_t game_num_states = game_matrix.getRowGroupCount();
+        uint64_t game_num_choices = game_matrix.getRowCount();
+        auto const& state_to_quotient = coarsest->state_to_quotient_state_action;
+        auto const& choice_to_quotient = coarsest->choice_to_quotient_choice;
+
+        // a color row survives iff its quotient choice is still enabled; an action row survives
+        // iff its color state kept at least one row
+        storm::storage::BitVector game_choice_enabled(game_num_choices,false);
+        storm::storage::BitVector game_state_alive(game_num_states,false);
+        for(uint64_t game_state = 0; game_state < game_num_states; ++game_state) {
+            if(state_to_quotient[game_state].second == quotient_num_actions) {
+                continue;
+            }
+            for(uint64_t game_choice = game_row_groups[game_state]; game_choice < game_row_groups[game_state+1]; ++game_choice) {
+                if(quotient_choice_mask[choice_to_quotient[game_choice]]) {
+                    game_choice_enabled.set(game_choice,true);
+                    game_state_alive.set(game_state,true);
+                }
+            }
+        }
+        for(uint64_t game_state = 0; game_state < game_num_states; ++game_state) {
+            if(state_to_quotient[game_state].second != quotient_num_actions) {
+                continue;
+            }
+            for(uint64_t game_choice = game_row_groups[game_state]; game_choice < game_row_groups[game_state+1]; ++game_choice) {
+                uint64_t color_state = game_matrix.getRow(game_choice).begin()->getColumn();
+                if(game_state_alive[color_state]) {
+                    game_choice_enabled.set(game_choice,true);
+                    game_state_alive.set(game_state,true);
+                }
+            }
+        }
+
+        uint64_t game_initial_state = *(coarsest->smg->getInitialStates().begin());
+        storm::storage::BitVector game_state_reachable(game_num_states,false);
+        std::queue<uint64_t> unexplored_states;
+        unexplored_states.push(game_initial_state);
+        game_state_reachable.set(game_initial_state,true);
+        while(not unexplored_states.empty()) {
+            uint64_t game_state = unexplored_states.front();
+            unexplored_states.pop();
+            for(uint64_t game_choice = game_row_groups[game_state]; game_choice < game_row_groups[game_state+1]; ++game_choice) {
+                if(not game_choice_enabled[game_choice]) {
+                    continue;
+                }
+                for(auto const& entry: game_matrix.getRow(game_choice)) {
+                    uint64_t game_state_dst = entry.getColumn();
+                    if(not game_state_reachable[game_state_dst]) {
+                        game_state_reachable.set(game_state_dst,true);
+                        unexplored_states.push(game_state_dst);
+                    }
+                }
+            }
+        }
+
+        std::vector<uint64_t> old_to_new_state(game_num_states,game_num_states);
+        std::vector<uint64_t> new_to_old_state;
+        uint64_t num_new_states = 0;
+        uint64_t num_new_choices = 0;
+        uint64_t num_new_entries = 0;
+        for(uint64_t game_state: game_state_reachable) {
+            old_to_new_state[game_state] = num_new_states++;
+            new_to_old_state.push_back(game_state);
+            for(uint64_t game_choice = game_row_groups[game_state]; game_choice < game_row_groups[game_state+1]; ++game_choice) {
+                if(not game_choice_enabled[game_choice]) {
+                    continue;
+                }
+                num_new_choices++;
+                num_new_entries += game_matrix.getRow(game_choice).getNumberOfEntries();
+            }
+        }
+
+        storm::storage::SparseMatrixBuilder<ValueType> matrix_builder(
+            num_new_choices,num_new_states,num_new_entries,true,true,num_new_states
+        );
+        std::vector<uint64_t> new_choice_to_quotient_choice;
+        new_choice_to_quotient_choice.reserve(num_new_choices);
+        storm::storage::BitVector new_choice_is_action_row(num_new_choices,false);
+        uint64_t new_choice = 0;
+        for(uint64_t new_state = 0; new_state < num_new_states; ++new_state) {
+            uint64_t game_state = new_to_old_state[new_state];
+            matrix_builder.newRowGroup(new_choice);
+            bool action_row = state_to_quotient[game_state].second == quotient_num_actions;
+            for(uint64_t game_choice = game_row_groups[game_state]; game_choice < game_row_groups[game_state+1]; ++game_choice) {
+                if(not game_choice_enabled[game_choice]) {
+                    continue;
+                }
+                for(auto const& entry: game_matrix.getRow(game_choice)) {
+                    matrix_builder.addNextValue(new_choice,old_to_new_state[entry.getColumn()],entry.getValue());
+                }
+                if(action_row) {
+                    // re-pick the representative variant among the still enabled rows of the color state
+                    uint64_t color_state = game_matrix.getRow(game_choice).begin()->getColumn();
+                    uint64_t representative = game_row_groups[color_state];
+                    while(not game_choice_enabled[representative]) {
+                        representative++;
+                    }
+                    new_choice_to_quotient_choice.push_back(choice_to_quotient[representative]);
+                    new_choice_is_action_row.set(new_choice,true);
+                } else {
+                    new_choice_to_quotient_choice.push_back(choice_to_quotient[game_choice]);
+                }
+                new_choice++;
+            }
+        }
+
+        std::vector<uint64_t> new_to_old_quotient_state(num_new_states);
+        std::vector<storm::storage::PlayerIndex> new_state_to_player(num_new_states);
+        for(uint64_t new_state = 0; new_state < num_new_states; ++new_state) {
+            auto [state,action] = state_to_quotient[new_to_old_state[new_state]];
+            new_to_old_quotient_state[new_state] = state;
+            new_state_to_player[new_state] = action == quotient_num_actions ? 0 : 1;
+        }
+
+        storm::storage::sparse::ModelComponents<ValueType> components;
+        components.transitionMatrix = matrix_builder.build();
+        uint64_t new_initial_state = old_to_new_state[game_initial_state];
+        components.stateLabeling = synthesis::translateStateLabeling(quotient,new_to_old_quotient_state,new_initial_state);
+        components.statePlayerIndications = std::move(new_state_to_player);
+        storm::storage::BitVector new_choice_mask(num_new_choices,true);
+        components.choiceLabeling = synthesis::translateChoiceLabeling(quotient,new_choice_to_quotient_choice,new_choice_mask);
+        components.rewardModels = synthesis::translateRewardModels(quotient,new_choice_to_quotient_choice,new_choice_is_action_row);
+
+        auto abstraction = std::make_shared<SmgAbstraction<ValueType>>();
+        if (quotient.getType() == storm::models::ModelType::Pomdp) {
+            components.observabilityClasses = synthesis::translateObservabilityClasses(quotient,new_to_old_quotient_state);
+            abstraction->smg = std::make_shared<synthesis::Posmg<ValueType>>(std::move(components));
+        } else {
+            abstraction->smg = std::make_shared<storm::models::sparse::Smg<ValueType>>(std::move(components));
+        }
+        abstraction->state_to_quotient_state_action.reserve(num_new_states);
+        for(uint64_t new_state = 0; new_state < num_new_states; ++new_state) {
+            abstraction->state_to_quotient_state_action.push_back(state_to_quotient[new_to_old_state[new_state]]);
+        }
+        abstraction->choice_to_quotient_choice = std::move(new_choice_to_quotient_choice);
+        return abstraction;
+    }
+
+    template class SmgAbstractionStack<double>;
+}
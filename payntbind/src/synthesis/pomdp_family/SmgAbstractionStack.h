@@ -0,0 +1,76 @@
+#pragma once
+
+#include "SmgAbstraction.h"
+
+#include <storm/models/sparse/Model.h>
+#include <storm/storage/BitVector.h>
+
+#include <memory>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Layered game abstraction for a stack of refinement levels sharing one quotient. The coarsest
+ * game is constructed once; every further level is stored only as the delta against its
+ * predecessor (the quotient choices the refinement removed), so the memory of the stack scales
+ * with the refinement size and not with the number of levels. The game of any level is assembled
+ * on demand by restricting the coarsest game, skipping the quotient exploration of
+ * \ref SmgAbstraction entirely.
+ */
+template<typename ValueType>
+class SmgAbstractionStack {
+public:
+
+    /**
+     * Build the coarsest game of the stack (level 0).
+     * @param quotient The quotient MDP. If the quotient is a POMDP, then level games can be recast to a Posmg.
+     * @param quotient_num_actions The total number of distinct actions in the quotient.
+     * @param choice_to_action For each row of the quotient, the associated action.
+     * @param quotient_choice_mask Choices of the quotient enabled at the coarsest level.
+     */
+    SmgAbstractionStack(
+        storm::models::sparse::Model<ValueType> const& quotient,
+        uint64_t quotient_num_actions,
+        std::vector<uint64_t> const& choice_to_action,
+        storm::storage::BitVector const& quotient_choice_mask
+    );
+
+    /**
+     * Add a refinement level on top of the stack. The mask must be a subset of the mask of the
+     * current topmost level; only the removed choices are stored.
+     * @return the index of the new level
+     */
+    uint64_t pushLevel(storm::storage::BitVector const& quotient_choice_mask);
+    /** Remove the topmost level. Level 0 cannot be removed. */
+    void popLevel();
+    /** Number of levels, including the coarsest one. */
+    uint64_t numLevels() const;
+
+    /** Reassemble the quotient choice mask of the given level from the stored deltas. */
+    storm::storage::BitVector levelChoiceMask(uint64_t level) const;
+    /**
+     * Assemble the game of the given level. Level 0 returns the cached coarsest game; any other
+     * level is carved out of the coarsest game by dropping the color rows of removed choices,
+     * the action rows whose color states died and the states left unreachable.
+     */
+    std::shared_ptr<SmgAbstraction<ValueType>> build(uint64_t level) const;
+
+protected:
+
+    /** The quotient MDP. */
+    storm::models::sparse::Model<ValueType> const& quotient;
+    /** The total number of distinct actions in the quotient. */
+    uint64_t quotient_num_actions;
+    /** For each row of the quotient, the associated action. */
+    std::vector<uint64_t> choice_to_action;
+
+    /** The game of level 0. */
+    std::shared_ptr<SmgAbstraction<ValueType>> coarsest;
+    /** Quotient choices enabled at level 0. */
+    storm::storage::BitVector coarsest_choice_mask;
+    /** For each level, the quotient choices removed from the preceding level (empty for level 0). */
+    std::vector<std::vector<uint64_t>> level_removed_choices;
+};
+
+}
@@ -2,20 +2,33 @@
 
 #include "ObservationEvaluator.h"
 #include "FscUnfolder.h"
+#include "FscSimulator.h"
 #include "GameAbstractionSolver.h"
 #include "SmgAbstraction.h"
+#include "SmgAbstractionStack.h"
 
 void bindings_pomdp_family(py::module& m) {
 
     py::class_<synthesis::ObservationEvaluator<double>>(m, "ObservationEvaluator")
-        .def(py::init<storm::prism::Program &,storm::models::sparse::Model<double> const& >(), py::arg("prism"), py::arg("model"))
+        .def(py::init<storm::prism::Program &,storm::models::sparse::Model<double> const&,uint64_t>(), py::arg("prism"), py::arg("model"), py::arg("num_threads") = 1)
         .def_property_readonly("num_obs_expressions", [](synthesis::ObservationEvaluator<double>& e) {return e.num_obs_expressions;} )
         .def_property_readonly("obs_expr_label", [](synthesis::ObservationEvaluator<double>& e) {return e.obs_expr_label;} )
         .def_property_readonly("obs_expr_is_boolean", [](synthesis::ObservationEvaluator<double>& e) {return e.obs_expr_is_boolean;} )
         .def_property_readonly("num_obs_classes", [](synthesis::ObservationEvaluator<double>& e) {return e.num_obs_classes;} )
         .def_property_readonly("state_to_obs_class", [](synthesis::ObservationEvaluator<double>& e) {return e.state_to_obs_class;} )
         .def("obs_class_value", &synthesis::ObservationEvaluator<double>::observationClassValue, py::arg("obs_class"), py::arg("obs_expr"))
-        .def("add_observations_to_submdp", &synthesis::ObservationEvaluator<double>::addObservationsToSubMdp, py::arg("mdp"), py::arg("state_sub_to_full"))
+        .def(
+            "add_observations_to_submdp",
+            py::overload_cast<storm::models::sparse::Mdp<double> const&,std::vector<uint64_t>>(&synthesis::ObservationEvaluator<double>::addObservationsToSubMdp),
+            py::arg("mdp"), py::arg("state_sub_to_full"), py::call_guard<py::gil_scoped_release>()
+        )
+        .def(
+            "add_observations_to_submdp_move",
+            [](synthesis::ObservationEvaluator<double>& e, storm::models::sparse::Mdp<double>& mdp, std::vector<uint64_t> state_sub_to_full) {
+                return e.addObservationsToSubMdp(std::move(mdp),std::move(state_sub_to_full));
+            },
+            py::arg("mdp"), py::arg("state_sub_to_full"), py::call_guard<py::gil_scoped_release>()
+        )
         ;
 
     py::class_<synthesis::FscUnfolder<double>>(m, "FscUnfolder")
@@ -25,13 +38,41 @@ void bindings_pomdp_family(py::module& m) {
             uint64_t,
             std::vector<uint64_t> const&>()
         )
-        .def("apply_fsc", &synthesis::FscUnfolder<double>::applyFsc, py::arg("action_function"), py::arg("udate_function"))
+        .def("apply_fsc", &synthesis::FscUnfolder<double>::applyFsc, py::arg("action_function"), py::arg("udate_function"), py::call_guard<py::gil_scoped_release>())
+        .def(
+            "apply_fsc_flat", &synthesis::FscUnfolder<double>::applyFscFlat,
+            py::arg("action_offsets"), py::arg("action_targets"), py::arg("action_probs"),
+            py::arg("update_offsets"), py::arg("update_targets"), py::arg("update_probs"),
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def("enable_dense_indexing", &synthesis::FscUnfolder<double>::enableDenseIndexing)
+        .def("enable_distribution_dedup", &synthesis::FscUnfolder<double>::enableDistributionDedup)
+        .def(
+            "evaluate_fscs", &synthesis::FscUnfolder<double>::evaluateFscs,
+            py::arg("action_functions"), py::arg("update_functions"), py::arg("formula"), py::arg("num_threads") = 1,
+            py::call_guard<py::gil_scoped_release>()
+        )
         .def_property_readonly("product", [](synthesis::FscUnfolder<double>& m) {return m.product;} )
         .def_property_readonly("product_choice_to_choice", [](synthesis::FscUnfolder<double>& m) {return m.product_choice_to_choice;} )
         // .def_property_readonly("product_state_to_state", [](synthesis::FscUnfolder<double>& m) {return m.product_state_to_state;} )
         // .def_property_readonly("product_state_to_state_memory_action", [](synthesis::FscUnfolder<double>& m) {return m.product_state_to_state_memory_action;} )
         ;
 
+    py::class_<synthesis::FscSimulator<double>>(m, "FscSimulator")
+        .def(
+            py::init<storm::models::sparse::Model<double> const&,
+            std::vector<uint32_t> const&,
+            uint64_t,
+            std::vector<uint64_t> const&>()
+        )
+        .def(
+            "simulate", &synthesis::FscSimulator<double>::simulate,
+            py::arg("action_function"), py::arg("update_function"), py::arg("target_label"),
+            py::arg("num_rollouts"), py::arg("rollout_length"), py::arg("seed"), py::arg("num_threads") = 1,
+            py::call_guard<py::gil_scoped_release>()
+        )
+        ;
+
     // m.def("randomize_action_variant", &synthesis::randomizeActionVariant<double>);
     py::class_<synthesis::GameAbstractionSolver<double>>(m, "GameAbstractionSolver")
         .def(
@@ -46,12 +87,24 @@ void bindings_pomdp_family(py::module& m) {
             >(),
             py::arg("quotient"), py::arg("num_actions"), py::arg("choice_to_action"), py::arg("formula"), py::arg("player1_maximizing"), py::arg("target_label"), py::arg("precision")
         )
-        .def("solve_sg", &synthesis::GameAbstractionSolver<double>::solveSg)
-        .def("solve_smg", &synthesis::GameAbstractionSolver<double>::solveSmg)
+        .def("solve_sg", &synthesis::GameAbstractionSolver<double>::solveSg, py::call_guard<py::gil_scoped_release>())
+        .def("solve_smg", &synthesis::GameAbstractionSolver<double>::solveSmg, py::call_guard<py::gil_scoped_release>())
+        .def("submit_game", &synthesis::GameAbstractionSolver<double>::submitGame, py::call_guard<py::gil_scoped_release>())
+        .def("collect_solution", &synthesis::GameAbstractionSolver<double>::collectSolution, py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("solution_state_values", [](synthesis::GameAbstractionSolver<double>& solver) {return solver.solution_state_values;})
         .def_property_readonly("solution_value", [](synthesis::GameAbstractionSolver<double>& solver) {return solver.solution_value;})
         .def_property_readonly("solution_state_to_player1_action", [](synthesis::GameAbstractionSolver<double>& solver) {return solver.solution_state_to_player1_action;})
         .def_property_readonly("solution_state_to_quotient_choice", [](synthesis::GameAbstractionSolver<double>& solver) {return solver.solution_state_to_quotient_choice;})
+        .def_property_readonly("solution_interrupted", [](synthesis::GameAbstractionSolver<double>& solver) {return solver.solution_interrupted;})
+        .def("set_cancellation_token", &synthesis::GameAbstractionSolver<double>::setCancellationToken, py::arg("token"))
+        .def("enable_warm_start", &synthesis::GameAbstractionSolver<double>::enableWarmStart)
+        .def(
+            "enable_adaptive_precision", &synthesis::GameAbstractionSolver<double>::enableAdaptivePrecision,
+            py::arg("coarse_precision"), py::arg("threshold"), py::arg("epsilon")
+        )
+        .def("disable_adaptive_precision", &synthesis::GameAbstractionSolver<double>::disableAdaptivePrecision)
+        .def("enable_solution_cache", &synthesis::GameAbstractionSolver<double>::enableSolutionCache)
+        .def("clear_solution_cache", &synthesis::GameAbstractionSolver<double>::clearSolutionCache)
         .def("enable_profiling", &synthesis::GameAbstractionSolver<double>::enableProfiling)
         .def("print_profiling", &synthesis::GameAbstractionSolver<double>::printProfiling)
         ;
@@ -67,4 +120,24 @@ void bindings_pomdp_family(py::module& m) {
         .def_readonly("state_to_quotient_state_action", &synthesis::SmgAbstraction<double>::state_to_quotient_state_action)
         .def_readonly("choice_to_quotient_choice", &synthesis::SmgAbstraction<double>::choice_to_quotient_choice)
         ;
+
+        py::class_<synthesis::SmgAbstractionStack<double>>(m, "SmgAbstractionStack")
+        .def(py::init<
+            storm::models::sparse::Model<double> const&,
+            uint64_t,
+            std::vector<uint64_t> const&,
+            storm::storage::BitVector const&
+        >(), py::arg("model"), py::arg("num_actions"), py::arg("choice_to_action"), py::arg("choice_mask"),
+            py::keep_alive<1,2>()
+        )
+        .def("pushLevel", &synthesis::SmgAbstractionStack<double>::pushLevel, py::arg("choice_mask"))
+        .def("popLevel", &synthesis::SmgAbstractionStack<double>::popLevel)
+        .def("numLevels", &synthesis::SmgAbstractionStack<double>::numLevels)
+        .def("levelChoiceMask", &synthesis::SmgAbstractionStack<double>::levelChoiceMask, py::arg("level"))
+        .def(
+            "build", &synthesis::SmgAbstractionStack<double>::build, py::arg("level"),
+            py::call_guard<py::gil_scoped_release>(),
+            "assemble the game of the given level from the coarsest game"
+        )
+        ;
 }
@@ -2,6 +2,11 @@
 
 #include "src/synthesis/translation/componentTranslations.h"
 
+#include <storm/exceptions/NotSupportedException.h>
+
+#include <map>
+#include <tuple>
+
 namespace synthesis {
 
 template<typename ValueType, typename RewardModelType>
@@ -50,6 +55,26 @@ storm::models::sparse::Pomdp<ValueType,RewardModelType> Posmg<ValueType,RewardMo
     return storm::models::sparse::Pomdp<ValueType,RewardModelType>(std::move(components));
 }
 
+template<typename ValueType, typename RewardModelType>
+std::shared_ptr<storm::models::sparse::Mdp<ValueType,RewardModelType>> Posmg<ValueType,RewardModelType>::getMdpView()
+{
+    if (mdpView == nullptr)
+    {
+        mdpView = std::make_shared<storm::models::sparse::Mdp<ValueType,RewardModelType>>(getMdp());
+    }
+    return mdpView;
+}
+
+template<typename ValueType, typename RewardModelType>
+std::shared_ptr<storm::models::sparse::Pomdp<ValueType,RewardModelType>> Posmg<ValueType,RewardModelType>::getPomdpView()
+{
+    if (pomdpView == nullptr)
+    {
+        pomdpView = std::make_shared<storm::models::sparse::Pomdp<ValueType,RewardModelType>>(getPomdp());
+    }
+    return pomdpView;
+}
+
 template<typename ValueType, typename RewardModelType>
 void Posmg<ValueType,RewardModelType>::calculateP0ObservationCount()
 {
@@ -76,6 +101,178 @@ void Posmg<ValueType,RewardModelType>::calculateP0ObservationCount()
 
 template class Posmg<double>;
 
+template<typename ValueType, typename RewardModelType>
+std::tuple<Posmg<ValueType,RewardModelType>,std::vector<uint64_t>,std::vector<uint64_t>> lumpAdversaryStates(
+    Posmg<ValueType,RewardModelType> const& posmg, storm::storage::PlayerIndex optimizingPlayer)
+{
+    auto const& matrix = posmg.getTransitionMatrix();
+    auto const& rowGroupIndices = matrix.getRowGroupIndices();
+    auto const& observations = posmg.getObservations();
+    auto const& playerIndications = posmg.getStatePlayerIndications();
+    auto const& stateLabeling = posmg.getStateLabeling();
+    uint64_t stateCount = posmg.getNumberOfStates();
+
+    // per-row reward signatures across all reward models (state-action rewards only, matching
+    // the reward translation used below)
+    std::vector<std::vector<ValueType> const*> rewardVectors;
+    for (auto const& rewardModel : posmg.getRewardModels())
+    {
+        STORM_LOG_THROW(
+            !rewardModel.second.hasStateRewards() && !rewardModel.second.hasTransitionRewards() && rewardModel.second.hasStateActionRewards(),
+            storm::exceptions::NotSupportedException, "expected state-action rewards");
+        rewardVectors.push_back(&rewardModel.second.getStateActionRewardVector());
+    }
+    bool hasChoiceLabeling = posmg.hasChoiceLabeling();
+
+    // initial partition: states of the optimizing player form singletons (and stay so, since
+    // every refinement keeps the previous block in the signature), adversary states are seeded
+    // by player, observation and state labels
+    std::vector<uint64_t> stateBlock(stateCount);
+    uint64_t blockCount = 0;
+    {
+        std::map<std::tuple<storm::storage::PlayerIndex,uint32_t,std::set<std::string>>,uint64_t> signatureToBlock;
+        for (uint64_t state = 0; state < stateCount; state++)
+        {
+            if (playerIndications[state] == optimizingPlayer)
+            {
+                stateBlock[state] = blockCount++;
+                continue;
+            }
+            auto signature = std::make_tuple(playerIndications[state], observations[state], stateLabeling.getLabelsOfState(state));
+            auto [entry,inserted] = signatureToBlock.try_emplace(std::move(signature), blockCount);
+            if (inserted)
+            {
+                blockCount++;
+            }
+            stateBlock[state] = entry->second;
+        }
+    }
+
+    // refine until the states of each block agree row for row on the distribution over the
+    // blocks, the action rewards and the choice labels
+    using RowSignature = std::tuple<std::vector<std::pair<uint64_t,ValueType>>,std::vector<ValueType>,std::set<std::string>>;
+    using StateSignature = std::pair<uint64_t,std::vector<RowSignature>>;
+    while (true)
+    {
+        std::map<StateSignature,uint64_t> signatureToBlock;
+        std::vector<uint64_t> newBlock(stateCount);
+        uint64_t newBlockCount = 0;
+        for (uint64_t state = 0; state < stateCount; state++)
+        {
+            StateSignature signature;
+            signature.first = stateBlock[state];
+            if (playerIndications[state] != optimizingPlayer)
+            {
+                for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state+1]; row++)
+                {
+                    std::map<uint64_t,ValueType> distribution;
+                    for (auto const& entry : matrix.getRow(row))
+                    {
+                        distribution[stateBlock[entry.getColumn()]] += entry.getValue();
+                    }
+                    std::vector<ValueType> rewards;
+                    rewards.reserve(rewardVectors.size());
+                    for (auto const* rewardVector : rewardVectors)
+                    {
+                        rewards.push_back((*rewardVector)[row]);
+                    }
+                    std::set<std::string> labels;
+                    if (hasChoiceLabeling)
+                    {
+                        labels = posmg.getChoiceLabeling().getLabelsOfChoice(row);
+                    }
+                    signature.second.emplace_back(
+                        std::vector<std::pair<uint64_t,ValueType>>(distribution.begin(),distribution.end()),
+                        std::move(rewards), std::move(labels));
+                }
+            }
+            auto [entry,inserted] = signatureToBlock.try_emplace(std::move(signature), newBlockCount);
+            if (inserted)
+            {
+                newBlockCount++;
+            }
+            newBlock[state] = entry->second;
+        }
+        // refinement only splits blocks, so an unchanged count means a stable partition
+        bool stable = newBlockCount == blockCount;
+        stateBlock = std::move(newBlock);
+        blockCount = newBlockCount;
+        if (stable)
+        {
+            break;
+        }
+    }
+
+    // blocks are numbered by their first member, so the quotient preserves the relative order
+    // of the representatives
+    std::vector<uint64_t> quotientStateToState(blockCount, stateCount);
+    for (uint64_t state = 0; state < stateCount; state++)
+    {
+        if (quotientStateToState[stateBlock[state]] == stateCount)
+        {
+            quotientStateToState[stateBlock[state]] = state;
+        }
+    }
+    uint64_t quotientRowCount = 0;
+    for (auto representative : quotientStateToState)
+    {
+        quotientRowCount += rowGroupIndices[representative+1] - rowGroupIndices[representative];
+    }
+
+    storm::storage::SparseMatrixBuilder<ValueType> builder(quotientRowCount, blockCount, 0, false, true, blockCount);
+    std::vector<uint64_t> quotientChoiceToChoice;
+    quotientChoiceToChoice.reserve(quotientRowCount);
+    uint64_t quotientRow = 0;
+    for (uint64_t block = 0; block < blockCount; block++)
+    {
+        builder.newRowGroup(quotientRow);
+        uint64_t representative = quotientStateToState[block];
+        for (uint64_t row = rowGroupIndices[representative]; row < rowGroupIndices[representative+1]; row++)
+        {
+            std::map<uint64_t,ValueType> distribution;
+            for (auto const& entry : matrix.getRow(row))
+            {
+                distribution[stateBlock[entry.getColumn()]] += entry.getValue();
+            }
+            for (auto const& [dst,value] : distribution)
+            {
+                builder.addNextValue(quotientRow, dst, value);
+            }
+            quotientChoiceToChoice.push_back(row);
+            quotientRow++;
+        }
+    }
+
+    storm::storage::sparse::ModelComponents<ValueType,RewardModelType> components;
+    components.transitionMatrix = builder.build();
+    uint64_t quotientInitialState = stateBlock[*posmg.getInitialStates().begin()];
+    components.stateLabeling = synthesis::translateStateLabeling(posmg, quotientStateToState, quotientInitialState);
+    storm::storage::BitVector quotientChoiceMask(quotientRowCount, true);
+    if (hasChoiceLabeling)
+    {
+        components.choiceLabeling = synthesis::translateChoiceLabeling(posmg, quotientChoiceToChoice, quotientChoiceMask);
+    }
+    components.rewardModels = synthesis::translateRewardModels(posmg, quotientChoiceToChoice, quotientChoiceMask);
+    std::vector<uint32_t> quotientObservations;
+    quotientObservations.reserve(blockCount);
+    std::vector<storm::storage::PlayerIndex> quotientPlayerIndications;
+    quotientPlayerIndications.reserve(blockCount);
+    for (auto representative : quotientStateToState)
+    {
+        quotientObservations.push_back(observations[representative]);
+        quotientPlayerIndications.push_back(playerIndications[representative]);
+    }
+    components.observabilityClasses = std::move(quotientObservations);
+    components.statePlayerIndications = std::move(quotientPlayerIndications);
+
+    return std::make_tuple(
+        Posmg<ValueType,RewardModelType>(std::move(components)),
+        std::move(stateBlock), std::move(quotientStateToState));
+}
+
+template std::tuple<Posmg<double>,std::vector<uint64_t>,std::vector<uint64_t>> lumpAdversaryStates<double>(
+    Posmg<double> const& posmg, storm::storage::PlayerIndex optimizingPlayer);
+
 
 template<typename ValueType, typename RewardModelType>
 Posmg<ValueType,RewardModelType> posmgFromPomdp(
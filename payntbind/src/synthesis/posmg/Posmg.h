@@ -5,6 +5,8 @@
 #include <storm/models/sparse/Pomdp.h>
 #include <storm/adapters/RationalFunctionAdapter.h>
 
+#include <tuple>
+
 namespace synthesis {
 
 /**
@@ -49,6 +51,21 @@ class Posmg : public storm::models::sparse::Smg<ValueType,RewardModelType> {
      */
     storm::models::sparse::Pomdp<ValueType,RewardModelType> getPomdp();
 
+    /**
+     * @brief Get a shared view of the underlying MDP
+     *
+     * The view is built on the first call and shared afterwards, so repeated calls do not copy
+     * the components again. The POSMG is immutable after construction, so the view never goes stale.
+     */
+    std::shared_ptr<storm::models::sparse::Mdp<ValueType,RewardModelType>> getMdpView();
+
+    /**
+     * @brief Get a shared view of the underlying POMDP
+     *
+     * Built on the first call and shared afterwards, see getMdpView.
+     */
+    std::shared_ptr<storm::models::sparse::Pomdp<ValueType,RewardModelType>> getPomdpView();
+
     private:
     /**
      * @brief Calculate number of player 0 observations and store it in p0ObservationCount
@@ -60,8 +77,32 @@ class Posmg : public storm::models::sparse::Smg<ValueType,RewardModelType> {
 
     /** Number of observations corresponding to player 0 states */
     uint64_t p0ObservationCount;
+
+    /** Lazily built MDP view, shared by all getMdpView callers */
+    std::shared_ptr<storm::models::sparse::Mdp<ValueType,RewardModelType>> mdpView;
+
+    /** Lazily built POMDP view, shared by all getPomdpView callers */
+    std::shared_ptr<storm::models::sparse::Pomdp<ValueType,RewardModelType>> pomdpView;
 };
 
+/**
+ * @brief Lump observation-equivalent adversary states of a POSMG.
+ *
+ * Partition refinement restricted to the adversary states: the partition is seeded by player,
+ * observation and state labels (states of the optimizing player are kept as singletons) and
+ * refined until the states of each block agree row for row on the distributions over the
+ * blocks, the action rewards and the choice labels. The reduced game keeps the rows of the
+ * first state of each block; the returned mappings make the reduction transparent to the
+ * prototype bookkeeping of PosmgManager.
+ * @param posmg the game to lump
+ * @param optimizingPlayer index of the player whose states are never merged
+ * @return the reduced game, a state-to-block mapping and a block-to-representative mapping
+ */
+template<typename ValueType,typename RewardModelType = storm::models::sparse::StandardRewardModel<ValueType>>
+std::tuple<Posmg<ValueType,RewardModelType>,std::vector<uint64_t>,std::vector<uint64_t>> lumpAdversaryStates(
+    Posmg<ValueType,RewardModelType> const& posmg,
+    storm::storage::PlayerIndex optimizingPlayer = 0);
+
 /**
  * @brief Create a POSMG from a POMDP and state indications.
  * @param pomdp Base POMDP
@@ -0,0 +1,63 @@
+#include "PosmgCheckingSession.h"
+
+#include "../smg/modelchecker/SparseSmgRpatlModelChecker.h"
+
+#include <storm/api/verification.h>
+#include <storm/environment/solver/GameSolverEnvironment.h>
+#include <storm/environment/solver/MinMaxSolverEnvironment.h>
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/utility/constants.h>
+
+namespace synthesis {
+
+template<typename ValueType>
+PosmgCheckingSession<ValueType>::PosmgCheckingSession(bool only_initial_states, bool produce_schedulers)
+    : only_initial_states(only_initial_states), produce_schedulers(produce_schedulers) {
+    // intentionally left empty: the default environment is adjusted through the setters
+}
+
+template<typename ValueType>
+void PosmgCheckingSession<ValueType>::setPrecision(double precision) {
+    auto precision_rational = storm::utility::convertNumber<storm::RationalNumber>(precision);
+    this->env.solver().minMax().setPrecision(precision_rational);
+    this->env.solver().game().setPrecision(precision_rational);
+}
+
+template<typename ValueType>
+void PosmgCheckingSession<ValueType>::setMaximalNumberOfIterations(uint64_t max_iterations) {
+    this->env.solver().game().setMaximalNumberOfIterations(max_iterations);
+}
+
+template<typename ValueType>
+std::shared_ptr<storm::modelchecker::CheckResult> PosmgCheckingSession<ValueType>::check(
+    Posmg<ValueType> const& game,
+    std::shared_ptr<storm::logic::Formula const> formula
+) {
+    auto task = storm::api::createTask<ValueType>(formula,this->only_initial_states);
+    task.setProduceSchedulers(this->produce_schedulers);
+    synthesis::SparseSmgRpatlModelChecker<storm::models::sparse::Smg<ValueType>> modelchecker(game);
+    if(not modelchecker.canHandle(task)) {
+        return nullptr;
+    }
+    return modelchecker.check(this->env,task);
+}
+
+template<typename ValueType>
+std::vector<std::shared_ptr<storm::modelchecker::CheckResult>> PosmgCheckingSession<ValueType>::checkBatch(
+    std::vector<std::shared_ptr<Posmg<ValueType>>> const& games,
+    std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulas
+) {
+    STORM_LOG_THROW(games.size() == formulas.size(), storm::exceptions::InvalidArgumentException,
+        "expected one formula per game");
+    std::vector<std::shared_ptr<storm::modelchecker::CheckResult>> results;
+    results.reserve(games.size());
+    for(uint64_t index = 0; index < games.size(); ++index) {
+        results.push_back(this->check(*games[index],formulas[index]));
+    }
+    return results;
+}
+
+
+template class PosmgCheckingSession<double>;
+
+}
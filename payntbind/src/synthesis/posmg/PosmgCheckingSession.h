@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Posmg.h"
+
+#include <storm/environment/Environment.h>
+#include <storm/logic/Formula.h>
+#include <storm/modelchecker/results/CheckResult.h>
+
+#include <memory>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Checking session for sequences of closely related POSMGs. The session owns one
+ * storm::Environment with the solver selections applied once, so repeated checks skip the
+ * per-call environment construction and solver re-selection of \ref modelCheckSmg; together
+ * with the cached game helpers of the RPATL checker (which keep their converted matrices and
+ * work vectors), back-to-back checks of a game-synthesis loop pay only for the iteration
+ * itself. Batches of (game,formula) pairs are checked natively in one call.
+ */
+template<typename ValueType>
+class PosmgCheckingSession {
+public:
+
+    /**
+     * @param only_initial_states restrict results to the initial states
+     * @param produce_schedulers produce optimal schedulers alongside the values
+     */
+    PosmgCheckingSession(bool only_initial_states = false, bool produce_schedulers = true);
+
+    /** Set the precision of the min-max and game solvers. */
+    void setPrecision(double precision);
+    /** Set the iteration limit of the game solver. */
+    void setMaximalNumberOfIterations(uint64_t max_iterations);
+
+    /** Check a single game under the session environment. */
+    std::shared_ptr<storm::modelchecker::CheckResult> check(
+        Posmg<ValueType> const& game,
+        std::shared_ptr<storm::logic::Formula const> formula
+    );
+
+    /**
+     * Check a batch of (game,formula) pairs back-to-back.
+     * @param games the games, matched with \p formulas by index
+     * @param formulas one formula per game
+     * @return for each pair, its check result
+     */
+    std::vector<std::shared_ptr<storm::modelchecker::CheckResult>> checkBatch(
+        std::vector<std::shared_ptr<Posmg<ValueType>>> const& games,
+        std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulas
+    );
+
+protected:
+
+    /** The environment shared by all checks of this session. */
+    storm::Environment env;
+    /** Whether results are restricted to the initial states. */
+    bool only_initial_states;
+    /** Whether optimal schedulers are produced alongside the values. */
+    bool produce_schedulers;
+};
+
+}
@@ -26,6 +26,11 @@ namespace synthesis {
     template<typename ValueType>
     void PosmgManager<ValueType>::setObservationMemorySize(uint64_t observation, uint64_t memorySize)
     {
+        auto it = this->optPlayerObservationMemorySize.find(observation);
+        if (it == this->optPlayerObservationMemorySize.end() || it->second != memorySize)
+        {
+            this->changedObservations.insert(observation);
+        }
         this->optPlayerObservationMemorySize[observation] = memorySize;
     }
 
@@ -253,6 +258,43 @@ namespace synthesis {
         return this->prototypeDuplicates[prototype][memory];
     }
 
+    template<typename ValueType>
+    void PosmgManager<ValueType>::calculatePrototypeAffected()
+    {
+        auto prototypeCount = this->posmg.getNumberOfStates();
+        this->prototypeAffected.assign(prototypeCount, false);
+        auto const& transitionMat = this->posmg.getTransitionMatrix();
+        auto const& rowGroupIndices = transitionMat.getRowGroupIndices();
+
+        for (uint64_t prototype = 0; prototype < prototypeCount; prototype++)
+        {
+            bool affected = false;
+            if (isOptPlayerState(prototype))
+            {
+                // the number of destination memory copies per row must be preserved
+                auto observation = this->posmg.getObservation(prototype);
+                affected = this->maxSuccesorDuplicateCount.at(observation)
+                    != this->maxSuccesorDuplicateCountOld.at(observation);
+            }
+            // destinations must keep their duplicate counts so the renumbering is exact
+            for (uint64_t row = rowGroupIndices[prototype];
+                !affected && row < rowGroupIndices[prototype+1];
+                row++)
+            {
+                for (auto const& entry : transitionMat.getRow(row))
+                {
+                    auto dst = entry.getColumn();
+                    if (this->stateDuplicateCount[dst] != this->stateDuplicateCountOld[dst])
+                    {
+                        affected = true;
+                        break;
+                    }
+                }
+            }
+            this->prototypeAffected[prototype] = affected;
+        }
+    }
+
     template<typename ValueType>
     storm::storage::SparseMatrix<double> PosmgManager<ValueType>::constructTransitionMatrix()
     {
@@ -262,6 +304,28 @@ namespace synthesis {
         for (uint64_t state = 0; state < this->stateCount; state++)
         {
             builder.newRowGroup(this->rowGroups[state]);
+            auto statePrototype = this->statePrototype[state];
+            auto stateMem = this->stateMemory[state];
+            if (this->mdpOld != nullptr && !this->prototypeAffected[statePrototype]
+                && (isOptPlayerState(statePrototype) || stateMem < this->stateDuplicateCountOld[statePrototype]))
+            {
+                // rows of optimizing player duplicates are identical across memory copies, rows of
+                // other player duplicates pass their own memory to the destinations; copy the rows
+                // of the matching previous duplicate, renumbering the destinations
+                auto oldDuplicate = isOptPlayerState(statePrototype)
+                    ? this->prototypeDuplicatesOld[statePrototype][0]
+                    : this->prototypeDuplicatesOld[statePrototype][stateMem];
+                auto const& oldMatrix = this->mdpOld->getTransitionMatrix();
+                auto oldRow = oldMatrix.getRowGroupIndices()[oldDuplicate];
+                for (uint64_t row = this->rowGroups[state]; row < this->rowGroups[state+1]; row++, oldRow++)
+                {
+                    for (auto const& entry : oldMatrix.getRow(oldRow))
+                    {
+                        builder.addNextValue(row, this->stateRemapOldToNew[entry.getColumn()], entry.getValue());
+                    }
+                }
+                continue;
+            }
             for (uint64_t row = this->rowGroups[state]; row < this->rowGroups[state+1]; row++)
             {
                 auto prototypeRow = this->rowPrototype[row];
@@ -420,9 +484,39 @@ namespace synthesis {
     template<typename ValueType>
     std::shared_ptr<storm::models::sparse::Mdp<double>> PosmgManager<ValueType>::constructMdp()
     {
+        // nothing changed since the last unfolding
+        if (this->mdp != nullptr && this->changedObservations.empty())
+        {
+            return this->mdp;
+        }
+
+        // remember the previous unfolding; states whose unfolded rows are unaffected by the memory
+        // changes copy them from the previous MDP (through a state renumbering)
+        this->mdpOld = this->mdp;
+        if (this->mdpOld != nullptr)
+        {
+            this->prototypeDuplicatesOld = this->prototypeDuplicates;
+            this->stateDuplicateCountOld = this->stateDuplicateCount;
+            this->maxSuccesorDuplicateCountOld = this->maxSuccesorDuplicateCount;
+            this->stateRemapOldToNew = this->statePrototype;
+        }
+
         this->buildStateSpace();
         this->buildTransitionMatrixSpurious();
 
+        if (this->mdpOld != nullptr)
+        {
+            // translate the remembered prototypes to the new state indices, keeping memory indices
+            auto oldStateCount = this->stateRemapOldToNew.size();
+            for (uint64_t oldState = 0; oldState < oldStateCount; oldState++)
+            {
+                auto prototype = this->stateRemapOldToNew[oldState];
+                auto memory = oldState - this->prototypeDuplicatesOld[prototype][0];
+                this->stateRemapOldToNew[oldState] = this->translateState(prototype, memory);
+            }
+            this->calculatePrototypeAffected();
+        }
+
         storm::storage::sparse::ModelComponents<ValueType> components;
         components.transitionMatrix = this->constructTransitionMatrix();
         components.stateLabeling = this->constructStateLabeling();
@@ -430,6 +524,13 @@ namespace synthesis {
 
         this->buildDesignSpaceSpurious();
 
+        // the pending changes have been incorporated
+        this->changedObservations.clear();
+        this->mdpOld = nullptr;
+        this->prototypeDuplicatesOld.clear();
+        this->stateDuplicateCountOld.clear();
+        this->stateRemapOldToNew.clear();
+
         return this->mdp;
     }
 
@@ -144,6 +144,11 @@ class PosmgManager {
 
         void buildDesignSpaceSpurious();
 
+        /**
+         * @brief Determine which prototypes cannot reuse their unfolded rows from the previous MDP
+         */
+        void calculatePrototypeAffected();
+
 
         /**
          * @brief Determine if prototype state belongs to optimizing player (specified by optimizingPlayer property).
@@ -204,6 +209,26 @@ class PosmgManager {
         // Unfolded mdp created from posmg
         std::shared_ptr<storm::models::sparse::Mdp<ValueType>> mdp;
 
+        /** Incremental reconstruction. */
+
+        // Optimizing player observations whose memory size changed since the last unfolding
+        std::set<uint64_t> changedObservations;
+
+        // MDP of the previous unfolding (NULL when a full rebuild is required); rows of states
+        // unaffected by the memory changes are copied from it
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> mdpOld;
+
+        // State space layout of the previous unfolding
+        std::vector<std::vector<uint64_t>> prototypeDuplicatesOld;
+        std::vector<uint64_t> stateDuplicateCountOld;
+        std::unordered_map<uint32_t, uint64_t> maxSuccesorDuplicateCountOld;
+
+        // For each state of the previous unfolding, its index in the new one
+        std::vector<uint64_t> stateRemapOldToNew;
+
+        // For each prototype, whether its unfolded rows changed since the previous unfolding
+        std::vector<bool> prototypeAffected;
+
 
 }; // class PosmgManager
 
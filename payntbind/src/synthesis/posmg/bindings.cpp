@@ -1,6 +1,7 @@
 #include "../synthesis.h"
 
 #include "Posmg.h"
+#include "PosmgCheckingSession.h"
 #include "PosmgManager.h"
 
 #include "storm/models/sparse/Smg.h"
@@ -14,6 +15,8 @@ void bindings_posmg(py::module &m) {
         .def("get_mdp", &synthesis::Posmg<double>::getMdp)
         .def_property_readonly("nondeterministic_choice_indices", [](synthesis::Posmg<double> const& m) { return m.getNondeterministicChoiceIndices(); })
         .def("get_pomdp", &synthesis::Posmg<double>::getPomdp)
+        .def("get_mdp_view", &synthesis::Posmg<double>::getMdpView)
+        .def("get_pomdp_view", &synthesis::Posmg<double>::getPomdpView)
         // this binding (calculation) is done in stormpy for mdp, but posmg doesn't inherit from mdp, so it is also copied here
         .def("get_nr_available_actions", [](synthesis::Posmg<double> const& posmg, uint64_t stateIndex)
             { return posmg.getNondeterministicChoiceIndices()[stateIndex+1] - posmg.getNondeterministicChoiceIndices()[stateIndex] ; },
@@ -26,10 +29,22 @@ void bindings_posmg(py::module &m) {
 
     m.def("posmg_from_pomdp", &synthesis::posmgFromPomdp<double>, py::arg("pomdp"), py::arg("state_player_indications"));
     m.def("posmg_from_smg", &synthesis::posmgFromSmg<double>, py::arg("smg"), py::arg("observability_classes"));
+    m.def("lump_adversary_states", &synthesis::lumpAdversaryStates<double>, py::arg("posmg"), py::arg("optimizing_player") = 0,
+        py::call_guard<py::gil_scoped_release>(),
+        "lump observation-equivalent adversary states, returns (reduced game, state-to-block mapping, block-to-representative mapping)");
+
+    py::class_<synthesis::PosmgCheckingSession<double>>(m, "PosmgCheckingSession")
+        .def(py::init<bool,bool>(), py::arg("only_initial_states") = false, py::arg("produce_schedulers") = true)
+        .def("set_precision", &synthesis::PosmgCheckingSession<double>::setPrecision, py::arg("precision"))
+        .def("set_maximal_number_of_iterations", &synthesis::PosmgCheckingSession<double>::setMaximalNumberOfIterations, py::arg("max_iterations"))
+        .def("check", &synthesis::PosmgCheckingSession<double>::check, py::arg("game"), py::arg("formula"), py::call_guard<py::gil_scoped_release>())
+        .def("check_batch", &synthesis::PosmgCheckingSession<double>::checkBatch, py::arg("games"), py::arg("formulas"),
+            py::call_guard<py::gil_scoped_release>(),
+            "check a batch of (game,formula) pairs back-to-back under the session environment");
 
     py::class_<synthesis::PosmgManager<double>, std::shared_ptr<synthesis::PosmgManager<double>>>(m, "PosmgManager")
         .def(py::init<synthesis::Posmg<double> const&, uint64_t>(), py::arg("posmg"), py::arg("optimizing_player"))
-        .def("construct_mdp", &synthesis::PosmgManager<double>::constructMdp)
+        .def("construct_mdp", &synthesis::PosmgManager<double>::constructMdp, py::call_guard<py::gil_scoped_release>())
         .def("get_observation_mapping", &synthesis::PosmgManager<double>::getObservationMapping)
         .def("set_observation_memory_size", &synthesis::PosmgManager<double>::setObservationMemorySize,
             py::arg("observation"), py::arg("memory_size"))
@@ -0,0 +1,63 @@
+#include "AssignmentEnumerator.h"
+
+namespace synthesis {
+
+AssignmentEnumerator::AssignmentEnumerator(Family const& family) : family(family) {
+    reset();
+}
+
+void AssignmentEnumerator::reset() {
+    auto num_holes = family.numHoles();
+    digits.assign(num_holes,0);
+    directions.assign(num_holes,1);
+    started = false;
+    exhausted = num_holes == 0;
+    num_yielded = 0;
+}
+
+bool AssignmentEnumerator::done() const {
+    return exhausted;
+}
+
+uint64_t AssignmentEnumerator::numYielded() const {
+    return num_yielded;
+}
+
+uint64_t AssignmentEnumerator::numHoles() const {
+    return family.numHoles();
+}
+
+std::vector<uint64_t> AssignmentEnumerator::nextBlock(uint64_t max_count) {
+    auto num_holes = family.numHoles();
+    std::vector<uint64_t> block;
+    block.reserve(max_count*num_holes);
+    for(uint64_t row = 0; row < max_count and not exhausted; ++row) {
+        if(not started) {
+            started = true;
+        } else {
+            // advance the lowest digit that can still move; digits that cannot reverse
+            // their direction, which reflects the enumeration of the higher holes
+            uint64_t hole = 0;
+            while(hole < num_holes) {
+                int64_t next = static_cast<int64_t>(digits[hole]) + directions[hole];
+                if(next >= 0 and next < static_cast<int64_t>(family.holeNumOptions(hole))) {
+                    digits[hole] = next;
+                    break;
+                }
+                directions[hole] = -directions[hole];
+                ++hole;
+            }
+            if(hole == num_holes) {
+                exhausted = true;
+                break;
+            }
+        }
+        for(uint64_t hole = 0; hole < num_holes; ++hole) {
+            block.push_back(family.holeOptions(hole)[digits[hole]]);
+        }
+        ++num_yielded;
+    }
+    return block;
+}
+
+}
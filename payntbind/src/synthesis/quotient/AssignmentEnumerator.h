@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Family.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Enumerator of all assignments of a family in mixed-radix Gray-code order: consecutive
+ * assignments differ in the option of exactly one hole, so an exhaustive check can update
+ * its restriction incrementally instead of rebuilding it per assignment. Assignments are
+ * yielded in blocks as a dense row-major matrix with one column per hole.
+ */
+class AssignmentEnumerator {
+public:
+
+    AssignmentEnumerator(Family const& family);
+
+    /** Whether all assignments have been yielded. */
+    bool done() const;
+    /** Number of assignments yielded so far. */
+    uint64_t numYielded() const;
+    /** Number of holes, i.e. the number of columns of a yielded block. */
+    uint64_t numHoles() const;
+
+    /**
+     * Yield up to \p max_count assignments as a row-major matrix of hole options with
+     * numHoles() columns. Consecutive rows, also across block boundaries, differ in exactly
+     * one hole.
+     */
+    std::vector<uint64_t> nextBlock(uint64_t max_count);
+
+    /** Restart the enumeration. */
+    void reset();
+
+protected:
+
+    /** The enumerated family. */
+    Family family;
+    /** Current option index of each hole into its option list. */
+    std::vector<uint64_t> digits;
+    /** Direction in which each digit currently moves (reflected Gray code). */
+    std::vector<int64_t> directions;
+    /** Whether the current digits have been yielded yet. */
+    bool started = false;
+    /** Whether the enumeration is exhausted. */
+    bool exhausted = false;
+    /** Number of assignments yielded so far. */
+    uint64_t num_yielded = 0;
+};
+
+}
@@ -0,0 +1,162 @@
+#include "ColoredBisimulation.h"
+
+#include "src/synthesis/translation/componentTranslations.h"
+
+#include <storm/storage/BitVector.h>
+#include <storm/storage/SparseMatrix.h>
+#include <storm/storage/sparse/ModelComponents.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+
+namespace synthesis {
+
+    template<typename ValueType>
+    ColoredBisimulation<ValueType>::ColoredBisimulation(
+        storm::models::sparse::Model<ValueType> const& quotient,
+        std::vector<std::vector<std::pair<uint64_t,uint64_t>>> const& choice_to_assignment
+    ) {
+        auto const& matrix = quotient.getTransitionMatrix();
+        uint64_t num_states = quotient.getNumberOfStates();
+        uint64_t num_choices = quotient.getNumberOfChoices();
+        auto const& row_groups = matrix.getRowGroupIndices();
+
+        // the partition-independent part of a choice signature: its hole assignments, its
+        // labels and its state-action rewards, interned into one id
+        std::vector<uint64_t> choice_static(num_choices);
+        {
+            std::map<std::tuple<
+                std::vector<std::pair<uint64_t,uint64_t>>,std::set<std::string>,std::vector<ValueType>
+            >,uint64_t> static_id;
+            for(uint64_t choice = 0; choice < num_choices; ++choice) {
+                std::set<std::string> labels;
+                if(quotient.hasChoiceLabeling()) {
+                    labels = quotient.getChoiceLabeling().getLabelsOfChoice(choice);
+                }
+                std::vector<ValueType> rewards;
+                for(auto const& [name,reward_model]: quotient.getRewardModels()) {
+                    if(reward_model.hasStateActionRewards()) {
+                        rewards.push_back(reward_model.getStateActionReward(choice));
+                    }
+                }
+                auto entry = static_id.try_emplace(
+                    std::make_tuple(choice_to_assignment[choice],std::move(labels),std::move(rewards)),
+                    static_id.size()
+                );
+                choice_static[choice] = entry.first->second;
+            }
+        }
+
+        // initial partition: by state labels
+        uint64_t num_classes;
+        this->state_to_class.resize(num_states);
+        {
+            std::map<std::set<std::string>,uint64_t> class_of_labels;
+            for(uint64_t state = 0; state < num_states; ++state) {
+                auto entry = class_of_labels.try_emplace(
+                    quotient.getStateLabeling().getLabelsOfState(state), class_of_labels.size()
+                );
+                this->state_to_class[state] = entry.first->second;
+            }
+            num_classes = class_of_labels.size();
+        }
+
+        // refinement: split by the set of choice signatures until the partition is stable;
+        // class ids are handed out in order of the first state of each class, so they stay
+        // aligned with the state order of the original model
+        std::vector<uint64_t> choice_signature(num_choices);
+        std::vector<std::vector<std::pair<uint64_t,ValueType>>> choice_distribution(num_choices);
+        while(true) {
+            std::map<std::pair<uint64_t,std::vector<std::pair<uint64_t,ValueType>>>,uint64_t> signature_id;
+            for(uint64_t choice = 0; choice < num_choices; ++choice) {
+                std::map<uint64_t,ValueType> distribution;
+                for(auto const& entry: matrix.getRow(choice)) {
+                    distribution[this->state_to_class[entry.getColumn()]] += entry.getValue();
+                }
+                std::vector<std::pair<uint64_t,ValueType>> distribution_flat(distribution.begin(),distribution.end());
+                auto entry = signature_id.try_emplace(
+                    std::make_pair(choice_static[choice],distribution_flat), signature_id.size()
+                );
+                choice_signature[choice] = entry.first->second;
+                choice_distribution[choice] = std::move(distribution_flat);
+            }
+            std::map<std::pair<uint64_t,std::vector<uint64_t>>,uint64_t> class_id;
+            std::vector<uint64_t> new_state_to_class(num_states);
+            for(uint64_t state = 0; state < num_states; ++state) {
+                std::vector<uint64_t> signatures;
+                for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+                    signatures.push_back(choice_signature[choice]);
+                }
+                std::sort(signatures.begin(),signatures.end());
+                signatures.erase(std::unique(signatures.begin(),signatures.end()),signatures.end());
+                auto entry = class_id.try_emplace(
+                    std::make_pair(this->state_to_class[state],std::move(signatures)), class_id.size()
+                );
+                new_state_to_class[state] = entry.first->second;
+            }
+            bool stable = class_id.size() == num_classes;
+            num_classes = class_id.size();
+            this->state_to_class = std::move(new_state_to_class);
+            if(stable) {
+                break;
+            }
+        }
+
+        // representatives; class ids increase with their first state, so this is one pass
+        this->class_to_state.resize(num_classes);
+        storm::storage::BitVector class_found(num_classes,false);
+        for(uint64_t state = 0; state < num_states; ++state) {
+            uint64_t state_class = this->state_to_class[state];
+            if(not class_found[state_class]) {
+                class_found.set(state_class,true);
+                this->class_to_state[state_class] = state;
+            }
+        }
+
+        // assemble the reduced model from the representatives, collapsing choices of a
+        // representative that share their signature; the signatures and the aggregated
+        // distributions of the last (stable) refinement round are still current
+        storm::storage::SparseMatrixBuilder<ValueType> builder(0,0,0,false,true,num_classes);
+        uint64_t reduced_choice = 0;
+        for(uint64_t state_class = 0; state_class < num_classes; ++state_class) {
+            builder.newRowGroup(reduced_choice);
+            uint64_t state = this->class_to_state[state_class];
+            std::set<uint64_t> seen_signatures;
+            for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+                if(not seen_signatures.insert(choice_signature[choice]).second) {
+                    continue;
+                }
+                for(auto const& [dst_class,probability]: choice_distribution[choice]) {
+                    builder.addNextValue(reduced_choice,dst_class,probability);
+                }
+                this->reduced_choice_to_choice.push_back(choice);
+                this->reduced_choice_to_assignment.push_back(choice_to_assignment[choice]);
+                ++reduced_choice;
+            }
+        }
+        uint64_t num_reduced_choices = reduced_choice;
+
+        storm::storage::sparse::ModelComponents<ValueType> components;
+        components.transitionMatrix = builder.build();
+        uint64_t initial_state = *(quotient.getInitialStates().begin());
+        components.stateLabeling = synthesis::translateStateLabeling(
+            quotient,this->class_to_state,this->state_to_class[initial_state]
+        );
+        storm::storage::BitVector reduced_choice_mask(num_reduced_choices,true);
+        if(quotient.hasChoiceLabeling()) {
+            components.choiceLabeling = synthesis::translateChoiceLabeling(
+                quotient,this->reduced_choice_to_choice,reduced_choice_mask
+            );
+        }
+        components.rewardModels = synthesis::translateRewardModels(
+            quotient,this->reduced_choice_to_choice,reduced_choice_mask
+        );
+        this->reduced = std::make_shared<storm::models::sparse::Mdp<ValueType>>(std::move(components));
+    }
+
+
+    template class ColoredBisimulation<double>;
+    template class ColoredBisimulation<storm::RationalNumber>;
+}
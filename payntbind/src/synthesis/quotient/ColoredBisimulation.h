@@ -0,0 +1,51 @@
+#pragma once
+
+#include <storm/adapters/RationalNumberAdapter.h>
+#include <storm/models/sparse/Model.h>
+#include <storm/models/sparse/Mdp.h>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace synthesis {
+
+    /**
+     * Coloring-preserving bisimulation quotienting. Partition refinement over the quotient MDP
+     * that treats the hole assignments of a choice as part of its signature, alongside its
+     * labels, its state-action rewards and its distribution over the current partition. Two
+     * states merge only if their sets of choice signatures coincide, so the reduced model is
+     * strongly bisimilar to the original and every reduced choice carries the exact hole
+     * assignments of the original choices it stands for; the translated assignments plug
+     * directly into \ref Coloring. Probabilities and rewards are compared exactly, without an
+     * epsilon.
+     */
+    template<typename ValueType>
+    class ColoredBisimulation {
+
+    public:
+
+        /**
+         * Compute the bisimulation quotient of \p quotient.
+         * @param quotient the quotient MDP
+         * @param choice_to_assignment for each choice, its hole assignments
+         */
+        ColoredBisimulation(
+            storm::models::sparse::Model<ValueType> const& quotient,
+            std::vector<std::vector<std::pair<uint64_t,uint64_t>>> const& choice_to_assignment
+        );
+
+        /** The reduced model. */
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> reduced;
+        /** For each choice of the reduced model, its hole assignments. */
+        std::vector<std::vector<std::pair<uint64_t,uint64_t>>> reduced_choice_to_assignment;
+        /** For each state of the original model, its equivalence class (= reduced state). */
+        std::vector<uint64_t> state_to_class;
+        /** For each equivalence class, its representative original state. */
+        std::vector<uint64_t> class_to_state;
+        /** For each choice of the reduced model, its representative original choice. */
+        std::vector<uint64_t> reduced_choice_to_choice;
+
+    };
+}
@@ -1,12 +1,59 @@
 #include "Coloring.h"
 
+#include "src/synthesis/BitVectorOps.h"
+#include "src/synthesis/Trace.h"
+#include "src/synthesis/translation/componentTranslations.h"
+
+#include <storm/adapters/RationalNumberAdapter.h>
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/exceptions/WrongFormatException.h>
+#include <storm/utility/macros.h>
+
+#include <fstream>
+#include <map>
+#include <thread>
+
 namespace synthesis {
 
 Coloring::Coloring(
     Family const& family, std::vector<uint64_t> const& row_groups,
     std::vector<std::vector<std::pair<uint64_t,uint64_t>>> choice_to_assignment
-) : family(family), choice_to_assignment(choice_to_assignment) {
-    
+) : family(family), choice_to_assignment(choice_to_assignment), row_groups(row_groups) {
+
+    auto num_choices = numChoices();
+    assignment_offset.resize(num_choices+1,0);
+    for(uint64_t choice = 0; choice<num_choices; ++choice) {
+        assignment_offset[choice+1] = assignment_offset[choice] + choice_to_assignment[choice].size();
+    }
+    assignment_hole.reserve(assignment_offset[num_choices]);
+    assignment_option.reserve(assignment_offset[num_choices]);
+    for(uint64_t choice = 0; choice<num_choices; ++choice) {
+        for(auto const& [hole,option]: choice_to_assignment[choice]) {
+            assignment_hole.push_back(hole);
+            assignment_option.push_back(option);
+        }
+    }
+
+    buildChoiceMasks();
+
+    // group states by identical coloring signatures
+    auto num_states = row_groups.size()-1;
+    state_to_group.resize(num_states);
+    std::map<std::vector<std::vector<std::pair<uint64_t,uint64_t>>>,uint64_t> signature_to_group;
+    for(uint64_t state = 0; state<num_states; ++state) {
+        std::vector<std::vector<std::pair<uint64_t,uint64_t>>> signature;
+        for(uint64_t choice = row_groups[state]; choice<row_groups[state+1]; ++choice) {
+            signature.push_back(choice_to_assignment[choice]);
+        }
+        auto [entry,inserted] = signature_to_group.try_emplace(std::move(signature),group_representative.size());
+        if(inserted) {
+            group_representative.push_back(state);
+        }
+        state_to_group[state] = entry->second;
+    }
+}
+
+void Coloring::buildChoiceMasks() {
     auto num_choices = numChoices();
     colored_choices.resize(num_choices,false);
     uncolored_choices.resize(num_choices,false);
@@ -18,25 +65,150 @@ Coloring::Coloring(
         }
     }
 
-
     auto num_holes = family.numHoles();
     choice_to_holes.resize(num_choices);
+    hole_to_choices.resize(num_holes);
+    hole_option_to_choices.resize(num_holes);
+    hole_option_choice_mask.resize(num_holes);
+    for(uint64_t hole = 0; hole < num_holes; ++hole) {
+        hole_option_to_choices[hole].resize(family.holeNumOptionsTotal(hole));
+        hole_option_choice_mask[hole].resize(family.holeNumOptionsTotal(hole));
+    }
     for(uint64_t choice = 0; choice<num_choices; ++choice) {
         choice_to_holes[choice] = BitVector(num_holes,false);
         for(auto const& [hole,option]: choice_to_assignment[choice]) {
+            if(not choice_to_holes[choice][hole]) {
+                hole_to_choices[hole].push_back(choice);
+                hole_option_to_choices[hole][option].push_back(choice);
+            }
             choice_to_holes[choice].set(hole,true);
         }
     }
 
-
     auto num_states = row_groups.size()-1;
     state_to_holes.resize(num_states);
     for(uint64_t state = 0; state<num_states; ++state) {
         state_to_holes[state] = BitVector(num_holes,false);
         for(uint64_t choice = row_groups[state]; choice<row_groups[state+1]; ++choice) {
-            state_to_holes[state] = state_to_holes[state] | choice_to_holes[choice]; 
+            state_to_holes[state] = state_to_holes[state] | choice_to_holes[choice];
+        }
+    }
+}
+
+uint64_t Coloring::numStateGroups() const {
+    return group_representative.size();
+}
+
+
+namespace {
+
+const uint64_t COLORING_SNAPSHOT_MAGIC = 0x50434f4c4f52494e; // "PCOLORIN"
+const uint64_t COLORING_SNAPSHOT_VERSION = 1;
+
+void writeWords(std::ofstream& out, std::vector<uint64_t> const& data) {
+    uint64_t size = data.size();
+    out.write(reinterpret_cast<char const*>(&size),sizeof(size));
+    out.write(reinterpret_cast<char const*>(data.data()),size*sizeof(uint64_t));
+}
+
+std::vector<uint64_t> readWords(std::ifstream& in) {
+    uint64_t size;
+    in.read(reinterpret_cast<char*>(&size),sizeof(size));
+    std::vector<uint64_t> data(size);
+    in.read(reinterpret_cast<char*>(data.data()),size*sizeof(uint64_t));
+    return data;
+}
+
+std::vector<std::vector<std::pair<uint64_t,uint64_t>>> assignmentFromFlat(
+    std::vector<uint64_t> const& assignment_offset,
+    std::vector<uint64_t> const& assignment_hole,
+    std::vector<uint64_t> const& assignment_option
+) {
+    uint64_t num_choices = assignment_offset.size()-1;
+    std::vector<std::vector<std::pair<uint64_t,uint64_t>>> choice_to_assignment(num_choices);
+    for(uint64_t choice = 0; choice<num_choices; ++choice) {
+        for(uint64_t index = assignment_offset[choice]; index < assignment_offset[choice+1]; ++index) {
+            choice_to_assignment[choice].push_back(
+                std::make_pair(assignment_hole[index],assignment_option[index])
+            );
         }
     }
+    return choice_to_assignment;
+}
+
+std::vector<std::vector<std::pair<uint64_t,uint64_t>>> assignmentFromSnapshot(ColoringSnapshot const& snapshot) {
+    return assignmentFromFlat(snapshot.assignment_offset,snapshot.assignment_hole,snapshot.assignment_option);
+}
+
+}
+
+Coloring::Coloring(
+    Family const& family, std::vector<uint64_t> const& row_groups,
+    std::vector<uint64_t> const& assignment_offset,
+    std::vector<uint64_t> const& assignment_hole,
+    std::vector<uint64_t> const& assignment_option
+) : Coloring(family,row_groups,assignmentFromFlat(assignment_offset,assignment_hole,assignment_option)) {}
+
+uint64_t Coloring::quotientHash() const {
+    // FNV-1a over the row groups and the flattened color index
+    uint64_t hash = 0xcbf29ce484222325;
+    auto mix = [&hash](uint64_t word) {
+        hash = (hash ^ word) * 0x100000001b3;
+    };
+    for(auto word: row_groups) {
+        mix(word);
+    }
+    for(auto word: assignment_offset) {
+        mix(word);
+    }
+    for(uint64_t index = 0; index < assignment_hole.size(); ++index) {
+        mix(assignment_hole[index]);
+        mix(assignment_option[index]);
+    }
+    return hash;
+}
+
+void Coloring::saveSnapshot(std::string const& path) const {
+    std::ofstream out(path, std::ios::binary);
+    STORM_LOG_THROW(out.good(), storm::exceptions::WrongFormatException, "cannot open " << path << " for writing");
+    uint64_t header[3] = {COLORING_SNAPSHOT_MAGIC,COLORING_SNAPSHOT_VERSION,quotientHash()};
+    out.write(reinterpret_cast<char const*>(header),sizeof(header));
+    writeWords(out,row_groups);
+    writeWords(out,assignment_offset);
+    writeWords(out,assignment_hole);
+    writeWords(out,assignment_option);
+    writeWords(out,state_to_group);
+    writeWords(out,group_representative);
+}
+
+Coloring Coloring::fromSnapshot(Family const& family, std::string const& path) {
+    std::ifstream in(path, std::ios::binary);
+    STORM_LOG_THROW(in.good(), storm::exceptions::WrongFormatException, "cannot open snapshot " << path);
+    uint64_t header[3];
+    in.read(reinterpret_cast<char*>(header),sizeof(header));
+    STORM_LOG_THROW(
+        header[0] == COLORING_SNAPSHOT_MAGIC and header[1] == COLORING_SNAPSHOT_VERSION,
+        storm::exceptions::WrongFormatException, path << " is not a compatible coloring snapshot"
+    );
+    ColoringSnapshot snapshot;
+    snapshot.row_groups = readWords(in);
+    snapshot.assignment_offset = readWords(in);
+    snapshot.assignment_hole = readWords(in);
+    snapshot.assignment_option = readWords(in);
+    snapshot.state_to_group = readWords(in);
+    snapshot.group_representative = readWords(in);
+    STORM_LOG_THROW(in.good(), storm::exceptions::WrongFormatException, "snapshot " << path << " is truncated");
+    return Coloring(family,std::move(snapshot));
+}
+
+Coloring::Coloring(Family const& family, ColoringSnapshot&& snapshot)
+    : family(family), choice_to_assignment(assignmentFromSnapshot(snapshot)), row_groups(std::move(snapshot.row_groups)) {
+    assignment_offset = std::move(snapshot.assignment_offset);
+    assignment_hole = std::move(snapshot.assignment_hole);
+    assignment_option = std::move(snapshot.assignment_option);
+    state_to_group = std::move(snapshot.state_to_group);
+    group_representative = std::move(snapshot.group_representative);
+    buildChoiceMasks();
 }
 
 const uint64_t Coloring::numChoices() const {
@@ -51,25 +223,347 @@ std::vector<BitVector> const& Coloring::getStateToHoles() const {
     return state_to_holes;
 }
 
+bool Coloring::choiceIsCompatible(Family const& family, uint64_t choice) const {
+    for(uint64_t index = assignment_offset[choice]; index < assignment_offset[choice+1]; ++index) {
+        if(not family.holeContains(assignment_hole[index],assignment_option[index])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Family const& Coloring::getFamily() const {
+    return family;
+}
+
 BitVector Coloring::selectCompatibleChoices(Family const& subfamily) const {
-    auto selection = BitVector(uncolored_choices);
-    for(auto choice: colored_choices) {
-        if(subfamily.includesAssignment(choice_to_assignment[choice])) {
-            selection.set(choice,true);
+    BitVector selection(numChoices(),false);
+    selectCompatibleChoices(subfamily,selection);
+    return selection;
+}
+
+void Coloring::selectCompatibleChoices(Family const& subfamily, BitVector& selection) const {
+    PAYNT_TRACE_SCOPE("quotient.selectCompatibleChoices");
+    selection = uncolored_choices;
+    // a hole with a full option set cannot make a choice incompatible, so states touching only
+    // such holes are accepted wholesale; on game quotients this covers the adversary states,
+    // whose per-state holes are rarely refined
+    auto num_holes = family.numHoles();
+    BitVector hole_is_full(num_holes,false);
+    for(uint64_t hole = 0; hole < num_holes; ++hole) {
+        if(subfamily.holeNumOptions(hole) == family.holeNumOptionsTotal(hole)) {
+            hole_is_full.set(hole,true);
+        }
+    }
+    // evaluate compatibility once per state group
+    std::vector<bool> group_is_full(numStateGroups(),false);
+    std::vector<std::vector<bool>> group_selection(numStateGroups());
+    for(uint64_t group = 0; group < numStateGroups(); ++group) {
+        uint64_t state = group_representative[group];
+        if(state_to_holes[state].isSubsetOf(hole_is_full)) {
+            group_is_full[group] = true;
+            continue;
+        }
+        group_selection[group].resize(row_groups[state+1]-row_groups[state]);
+        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+            if(colored_choices[choice] and choiceIsCompatible(subfamily,choice)) {
+                group_selection[group][choice-row_groups[state]] = true;
+            }
+        }
+    }
+    // fan results out to member states
+    uint64_t num_states = row_groups.size()-1;
+    for(uint64_t state = 0; state < num_states; ++state) {
+        auto group = state_to_group[state];
+        if(group_is_full[group]) {
+            for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+                selection.set(choice,true);
+            }
+            continue;
+        }
+        auto const& selected = group_selection[group];
+        for(uint64_t offset = 0; offset < selected.size(); ++offset) {
+            if(selected[offset]) {
+                selection.set(row_groups[state]+offset,true);
+            }
+        }
+    }
+}
+std::vector<uint64_t> Coloring::selectAssignmentChoices(Family const& assignment) const {
+    uint64_t num_states = row_groups.size()-1;
+    // pick once per state group, fan the row offset out to member states
+    std::vector<uint64_t> group_choice_offset(numStateGroups());
+    for(uint64_t group = 0; group < numStateGroups(); ++group) {
+        uint64_t state = group_representative[group];
+        uint64_t num_rows = row_groups[state+1]-row_groups[state];
+        uint64_t selected_offset = num_rows;
+        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+            if(not colored_choices[choice] or choiceIsCompatible(assignment,choice)) {
+                selected_offset = choice-row_groups[state];
+                break;
+            }
+        }
+        STORM_LOG_THROW(selected_offset < num_rows, storm::exceptions::InvalidArgumentException,
+            "state has no choice compatible with the assignment");
+        group_choice_offset[group] = selected_offset;
+    }
+    std::vector<uint64_t> state_to_choice(num_states);
+    for(uint64_t state = 0; state < num_states; ++state) {
+        state_to_choice[state] = row_groups[state]+group_choice_offset[state_to_group[state]];
+    }
+    return state_to_choice;
+}
+
+template<typename ValueType>
+std::shared_ptr<storm::models::sparse::Dtmc<ValueType>> Coloring::applyAssignment(
+    Family const& assignment, storm::models::sparse::Model<ValueType> const& quotient
+) const {
+    PAYNT_TRACE_SCOPE("quotient.applyAssignment");
+    auto state_to_choice = selectAssignmentChoices(assignment);
+    uint64_t num_states = state_to_choice.size();
+    // one enabled row per state, no row groups
+    storm::storage::SparseMatrixBuilder<ValueType> builder(num_states,num_states,0,false,false);
+    auto const& matrix = quotient.getTransitionMatrix();
+    for(uint64_t state = 0; state < num_states; ++state) {
+        for(auto const& entry: matrix.getRow(state_to_choice[state])) {
+            builder.addNextValue(state,entry.getColumn(),entry.getValue());
+        }
+    }
+    storm::storage::sparse::ModelComponents<ValueType> components;
+    components.stateLabeling = quotient.getStateLabeling();
+    components.stateValuations = quotient.getOptionalStateValuations();
+    components.transitionMatrix = builder.build();
+    BitVector dtmc_choice_mask(num_states,true);
+    components.rewardModels = synthesis::translateRewardModels(quotient,state_to_choice,dtmc_choice_mask);
+    return std::make_shared<storm::models::sparse::Dtmc<ValueType>>(std::move(components));
+}
+
+template std::shared_ptr<storm::models::sparse::Dtmc<double>> Coloring::applyAssignment<double>(
+    Family const& assignment, storm::models::sparse::Model<double> const& quotient) const;
+template std::shared_ptr<storm::models::sparse::Dtmc<storm::RationalNumber>> Coloring::applyAssignment<storm::RationalNumber>(
+    Family const& assignment, storm::models::sparse::Model<storm::RationalNumber> const& quotient) const;
+
+BitVector Coloring::selectCompatibleChoicesRefined(
+    Family const& subfamily, BitVector const& parent_selection, uint64_t refined_hole
+) const {
+    PAYNT_TRACE_SCOPE("quotient.selectCompatibleChoicesRefined");
+    auto selection = BitVector(parent_selection);
+    // refinement only removes options of the refined hole: a selected choice loses
+    // compatibility exactly when its option on this hole was removed, so only the choices of
+    // the removed options are visited
+    auto num_options = family.holeNumOptionsTotal(refined_hole);
+    for(uint64_t option = 0; option < num_options; ++option) {
+        if(subfamily.holeContains(refined_hole,option)) {
+            continue;
+        }
+        for(auto choice: hole_option_to_choices[refined_hole][option]) {
+            selection.set(choice,false);
         }
     }
     return selection;
 }
 
+void Coloring::updateCompatibleChoicesForHole(Family const& subfamily, BitVector& selection, uint64_t hole) const {
+    // choices labeled with an option outside the subfamily are incompatible outright; only
+    // the choices of the remaining options need the full compatibility check
+    auto num_options = family.holeNumOptionsTotal(hole);
+    for(uint64_t option = 0; option < num_options; ++option) {
+        auto const& choices = hole_option_to_choices[hole][option];
+        if(subfamily.holeContains(hole,option)) {
+            for(auto choice: choices) {
+                selection.set(choice,choiceIsCompatible(subfamily,choice));
+            }
+        } else {
+            for(auto choice: choices) {
+                selection.set(choice,false);
+            }
+        }
+    }
+}
+
+BitVector const& Coloring::choicesWithHoleOption(uint64_t hole, uint64_t option) const {
+    auto& mask = hole_option_choice_mask[hole][option];
+    if(mask.size() == 0) {
+        mask = BitVector(numChoices(),false);
+        for(auto choice: hole_option_to_choices[hole][option]) {
+            mask.set(choice,true);
+        }
+    }
+    return mask;
+}
+
+void Coloring::pruneConflictChoices(BitVector& selection, std::vector<std::pair<uint64_t,uint64_t>> const& conflict) const {
+    for(auto const& [hole,option]: conflict) {
+        for(auto choice: hole_option_to_choices[hole][option]) {
+            selection.set(choice,false);
+        }
+    }
+}
+
+std::vector<BitVector> Coloring::selectCompatibleChoicesBatch(std::vector<Family> const& subfamilies) const {
+    PAYNT_TRACE_SCOPE("quotient.selectCompatibleChoicesBatch");
+    std::vector<BitVector> selections;
+    selections.reserve(subfamilies.size());
+    for(uint64_t index = 0; index < subfamilies.size(); ++index) {
+        selections.push_back(BitVector(uncolored_choices));
+    }
+    for(auto choice: colored_choices) {
+        for(uint64_t index = 0; index < subfamilies.size(); ++index) {
+            if(choiceIsCompatible(subfamilies[index],choice)) {
+                selections[index].set(choice,true);
+            }
+        }
+    }
+    return selections;
+}
 
 
 std::vector<BitVector> Coloring::collectHoleOptionsMask(BitVector const& choices) const {
+    return collectHoleOptionsMaskRange(choices,0,numChoices());
+}
+
+
+std::vector<std::vector<uint64_t>> Coloring::symmetricHoleOrbits() const {
+    uint64_t num_holes = family.numHoles();
+    // column of a hole: its (choice,option) pairs in sorted order; a hole permutation maps the
+    // coloring onto itself exactly when it only permutes holes with identical columns
+    std::vector<std::vector<std::pair<uint64_t,uint64_t>>> hole_column(num_holes);
+    for(uint64_t choice = 0; choice < numChoices(); ++choice) {
+        for(auto const& [hole,option]: choice_to_assignment[choice]) {
+            hole_column[hole].emplace_back(choice,option);
+        }
+    }
+    for(auto& column: hole_column) {
+        std::sort(column.begin(),column.end());
+    }
+    std::map<std::pair<uint64_t,std::vector<std::pair<uint64_t,uint64_t>>>,std::vector<uint64_t>> column_to_holes;
+    for(uint64_t hole = 0; hole < num_holes; ++hole) {
+        column_to_holes[std::make_pair(family.holeNumOptionsTotal(hole),std::move(hole_column[hole]))].push_back(hole);
+    }
+    std::vector<std::vector<uint64_t>> orbits;
+    for(auto& [column,holes]: column_to_holes) {
+        if(holes.size() > 1) {
+            orbits.push_back(std::move(holes));
+        }
+    }
+    return orbits;
+}
+
+
+std::pair<uint64_t,std::vector<std::vector<uint64_t>>> Coloring::scoreSplitCandidates(
+    Family const& subfamily, BitVector const& inconsistent_choices
+) const {
+    PAYNT_TRACE_SCOPE("quotient.scoreSplitCandidates");
+    auto num_holes = family.numHoles();
+    auto used_options = collectHoleOptionsMask(inconsistent_choices);
 
+    // pick the hole with the most distinct used options
+    uint64_t splitter = num_holes;
+    uint64_t splitter_score = 1;
+    for(uint64_t hole = 0; hole < num_holes; ++hole) {
+        uint64_t score = maskedAndCount(used_options[hole],subfamily.holeOptionsMask(hole));
+        if(score > splitter_score) {
+            splitter = hole;
+            splitter_score = score;
+        }
+    }
+
+    std::vector<std::vector<uint64_t>> suboptions;
+    if(splitter == num_holes) {
+        // no inconsistency: split the first non-trivial hole into halves
+        for(uint64_t hole = 0; hole < num_holes; ++hole) {
+            if(subfamily.holeNumOptions(hole) > 1) {
+                splitter = hole;
+                break;
+            }
+        }
+        auto const& options = subfamily.holeOptions(splitter);
+        uint64_t half = options.size()/2;
+        suboptions.push_back(std::vector<uint64_t>(options.begin(),options.begin()+half));
+        suboptions.push_back(std::vector<uint64_t>(options.begin()+half,options.end()));
+        return std::make_pair(splitter,suboptions);
+    }
+
+    // each used option seeds its own subfamily, unused options go into one extra bucket
+    auto used = used_options[splitter] & subfamily.holeOptionsMask(splitter);
+    std::vector<uint64_t> other_options;
+    for(auto option: subfamily.holeOptions(splitter)) {
+        if(not used[option]) {
+            other_options.push_back(option);
+        }
+    }
+    if(not other_options.empty()) {
+        suboptions.push_back(other_options);
+    }
+    for(auto option: used) {
+        suboptions.push_back(std::vector<uint64_t>{option});
+    }
+    return std::make_pair(splitter,suboptions);
+}
+
+std::pair<std::vector<BitVector>,std::vector<Family>> Coloring::partitionHoleOptions(
+    Family const& subfamily, uint64_t hole, std::vector<uint64_t> const& scores, uint64_t k
+) const {
+    PAYNT_TRACE_SCOPE("quotient.partitionHoleOptions");
+    auto const& options = subfamily.holeOptions(hole);
+    STORM_LOG_THROW(
+        k > 0 and not options.empty(), storm::exceptions::WrongFormatException,
+        "cannot partition an empty hole or into zero buckets"
+    );
+
+    // counting sort: scores are small, so bucketing by score value orders the options
+    uint64_t max_score = 0;
+    for(uint64_t option: options) {
+        if(scores[option] > max_score) {
+            max_score = scores[option];
+        }
+    }
+    std::vector<std::vector<uint64_t>> score_buckets(max_score+1);
+    for(uint64_t option: options) {
+        score_buckets[scores[option]].push_back(option);
+    }
+
+    // deal the options round-robin in descending score order
+    uint64_t num_buckets = std::min<uint64_t>(k,options.size());
+    std::vector<BitVector> bucket_masks(num_buckets,BitVector(subfamily.holeNumOptionsTotal(hole),false));
+    uint64_t bucket = 0;
+    for(uint64_t score = max_score+1; score-- > 0;) {
+        for(uint64_t option: score_buckets[score]) {
+            bucket_masks[bucket].set(option,true);
+            bucket = (bucket+1) % num_buckets;
+        }
+    }
+
+    std::vector<Family> children;
+    children.reserve(num_buckets);
+    for(auto const& mask: bucket_masks) {
+        Family child(subfamily);
+        child.holeSetOptions(hole,mask);
+        children.push_back(std::move(child));
+    }
+    return std::make_pair(std::move(bucket_masks),std::move(children));
+}
+
+std::vector<double> Coloring::weightHolesByVisits(std::vector<double> const& state_visits) const {
+    std::vector<double> hole_weight(family.numHoles(),0);
+    uint64_t num_states = state_to_holes.size();
+    for(uint64_t state = 0; state < num_states; ++state) {
+        if(state_visits[state] == 0) {
+            continue;
+        }
+        for(auto hole: state_to_holes[state]) {
+            hole_weight[hole] += state_visits[state];
+        }
+    }
+    return hole_weight;
+}
+
+std::vector<BitVector> Coloring::collectHoleOptionsMaskRange(BitVector const& choices, uint64_t begin, uint64_t end) const {
     std::vector<BitVector> hole_options_mask(family.numHoles());
     for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
         hole_options_mask[hole] = BitVector(family.holeNumOptionsTotal(hole),false);
     }
-    for(auto choice: choices) {
+    for(uint64_t choice = choices.getNextSetIndex(begin); choice < end; choice = choices.getNextSetIndex(choice+1)) {
         for(auto const& [hole,option]: choice_to_assignment[choice]) {
             hole_options_mask[hole].set(option,true);
         }
@@ -77,9 +571,7 @@ std::vector<BitVector> Coloring::collectHoleOptionsMask(BitVector const& choices
     return hole_options_mask;
 }
 
-
-std::vector<std::vector<uint64_t>> Coloring::collectHoleOptions(BitVector const& choices) const {
-    auto hole_options_mask = collectHoleOptionsMask(choices);
+std::vector<std::vector<uint64_t>> Coloring::holeOptionsMaskToOptions(std::vector<BitVector> const& hole_options_mask) const {
     std::vector<std::vector<uint64_t>> hole_options(family.numHoles());
     for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
         for(auto option: hole_options_mask[hole]) {
@@ -89,4 +581,34 @@ std::vector<std::vector<uint64_t>> Coloring::collectHoleOptions(BitVector const&
     return hole_options;
 }
 
+std::vector<std::vector<uint64_t>> Coloring::collectHoleOptions(BitVector const& choices) const {
+    return holeOptionsMaskToOptions(collectHoleOptionsMask(choices));
+}
+
+std::vector<std::vector<uint64_t>> Coloring::collectHoleOptions(BitVector const& choices, uint64_t num_threads) const {
+    if(num_threads <= 1) {
+        return collectHoleOptions(choices);
+    }
+    std::vector<std::vector<BitVector>> partial_masks(num_threads);
+    std::vector<std::thread> workers;
+    uint64_t num_choices = numChoices();
+    for(uint64_t thread = 0; thread < num_threads; ++thread) {
+        uint64_t begin = num_choices*thread/num_threads;
+        uint64_t end = num_choices*(thread+1)/num_threads;
+        workers.emplace_back([this,&choices,&partial_masks,thread,begin,end]() {
+            partial_masks[thread] = collectHoleOptionsMaskRange(choices,begin,end);
+        });
+    }
+    for(auto& worker: workers) {
+        worker.join();
+    }
+    auto& hole_options_mask = partial_masks[0];
+    for(uint64_t thread = 1; thread < num_threads; ++thread) {
+        for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+            hole_options_mask[hole] |= partial_masks[thread][hole];
+        }
+    }
+    return holeOptionsMaskToOptions(hole_options_mask);
+}
+
 }
\ No newline at end of file
@@ -2,9 +2,12 @@
 
 #include "src/synthesis/quotient/Family.h"
 
+#include <storm/models/sparse/Dtmc.h>
+#include <storm/models/sparse/Model.h>
 #include <storm/storage/BitVector.h>
 
 #include <cstdint>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -12,27 +15,178 @@ namespace synthesis {
 
 using BitVector = storm::storage::BitVector;
 
+/**
+ * Construction-time indices of a \ref Coloring in the form stored in a binary snapshot: the
+ * flattened choice-to-assignment table plus the state signature groups, i.e. exactly the parts
+ * that are expensive to recompute. Cheap per-choice masks are rebuilt on load.
+ */
+struct ColoringSnapshot {
+    std::vector<uint64_t> row_groups;
+    std::vector<uint64_t> assignment_offset;
+    std::vector<uint64_t> assignment_hole;
+    std::vector<uint64_t> assignment_option;
+    std::vector<uint64_t> state_to_group;
+    std::vector<uint64_t> group_representative;
+};
+
 
 class Coloring {
 public:
-    
+
     Coloring(
         Family const& family, std::vector<uint64_t> const& row_groups,
         std::vector<std::vector<std::pair<uint64_t,uint64_t>>> choice_to_assignment
     );
 
+    /**
+     * Construct from the flat (CSR-style) form of the choice-to-assignment table: the colors of
+     * choice c are the pairs (assignment_hole[i],assignment_option[i]) for i in
+     * [assignment_offset[c],assignment_offset[c+1]). Semantically identical to the nested-list
+     * constructor, but the bindings can fill the three buffers straight from numpy arrays
+     * without boxing every pair into a Python object.
+     */
+    Coloring(
+        Family const& family, std::vector<uint64_t> const& row_groups,
+        std::vector<uint64_t> const& assignment_offset,
+        std::vector<uint64_t> const& assignment_hole,
+        std::vector<uint64_t> const& assignment_option
+    );
+
+    /** Restore a coloring previously stored via \ref saveSnapshot. */
+    static Coloring fromSnapshot(Family const& family, std::string const& path);
+    /** Store the constructed indices in a versioned binary snapshot at the given path. */
+    void saveSnapshot(std::string const& path) const;
+    /** Hash of the quotient structure (row groups and colors), used to key snapshot files. */
+    uint64_t quotientHash() const;
+
+    /** Number of distinct state coloring signatures (see \ref state_to_group). */
+    uint64_t numStateGroups() const;
+
     /** Get choice-to-assignment mapping. */
     std::vector<std::vector<std::pair<uint64_t,uint64_t>>> const& getChoiceToAssignment() const;
     /** Get a mapping from states to holes involved in its choices. */
     std::vector<BitVector> const& getStateToHoles() const;
     
     /** Get a mask of choices compatible with the family. */
+    /** The family of the quotient. */
+    Family const& getFamily() const;
+
     BitVector selectCompatibleChoices(Family const& subfamily) const;
+    /**
+     * Variant of \ref selectCompatibleChoices writing into a caller-provided mask of matching
+     * size, so hot loops reuse one buffer instead of allocating a fresh mask per call.
+     */
+    void selectCompatibleChoices(Family const& subfamily, BitVector& selection) const;
+    /**
+     * For each of the given subfamilies, get a mask of compatible choices. The choice-to-assignment
+     * table is crossed only once, so querying a whole queue of subfamilies is cheaper than repeated
+     * calls to \ref selectCompatibleChoices.
+     */
+    std::vector<BitVector> selectCompatibleChoicesBatch(std::vector<Family> const& subfamilies) const;
+    /**
+     * Get a mask of choices compatible with a subfamily obtained by refining \p refined_hole of its
+     * parent. Only choices labeled by \p refined_hole are re-checked, all other choices inherit
+     * their compatibility from \p parent_selection.
+     * @param subfamily the refined family
+     * @param parent_selection choices compatible with the parent family
+     * @param refined_hole the single hole in which the subfamily differs from its parent
+     */
+    BitVector selectCompatibleChoicesRefined(
+        Family const& subfamily, BitVector const& parent_selection, uint64_t refined_hole
+    ) const;
+    /**
+     * Re-evaluate the compatibility of the choices colored by the given hole. Valid when
+     * \p subfamily differs from the family that produced \p selection only in this hole,
+     * e.g. between consecutive assignments of a Gray-code enumeration; unlike
+     * \ref selectCompatibleChoicesRefined, the option may change rather than narrow.
+     */
+    void updateCompatibleChoicesForHole(Family const& subfamily, BitVector& selection, uint64_t hole) const;
+    /**
+     * Get the mask of choices labeled by the given hole with the given option. The mask is
+     * decompressed from the inverted index on first query and cached.
+     */
+    BitVector const& choicesWithHoleOption(uint64_t hole, uint64_t option) const;
+    /**
+     * Remove from \p selection every choice labeled by any of the given (hole,option)
+     * assignments, e.g. the conflict of a counterexample. Only the choices of the listed
+     * assignments are visited.
+     */
+    void pruneConflictChoices(BitVector& selection, std::vector<std::pair<uint64_t,uint64_t>> const& conflict) const;
+    /**
+     * Group holes into symmetry orbits: two holes share an orbit when they label exactly the
+     * same choices with the same option sets, so any permutation of holes within an orbit maps
+     * the choice-to-assignment table onto itself. Subfamilies that differ only by such a
+     * permutation are equivalent; a refinement loop keeps one canonical representative per
+     * equivalence class (see \ref Family::isCanonical). Singleton orbits are omitted.
+     * @return list of orbits, each a sorted list of at least two holes
+     */
+    std::vector<std::vector<uint64_t>> symmetricHoleOrbits() const;
     /** For each hole, collect options (colors) involved in any of the given choices. */
     std::vector<std::vector<uint64_t>> collectHoleOptions(BitVector const& choices) const;
-    
+    /**
+     * Parallel version of \ref collectHoleOptions: the choice range is partitioned among
+     * \p num_threads workers that accumulate private option masks, which are merged afterwards.
+     */
+    std::vector<std::vector<uint64_t>> collectHoleOptions(BitVector const& choices, uint64_t num_threads) const;
+    /**
+     * Choose a hole to split the given subfamily on, based on the options used by the given
+     * (inconsistent) choices. The hole with the most distinct used options wins; its options are
+     * partitioned with each used option seeding its own subfamily and the unused family options
+     * collected in one extra bucket. If no hole is inconsistent, the first non-trivial hole is
+     * split into halves.
+     * @return the chosen hole and the option partition for the subfamilies
+     */
+    std::pair<uint64_t,std::vector<std::vector<uint64_t>>> scoreSplitCandidates(
+        Family const& subfamily, BitVector const& inconsistent_choices
+    ) const;
+    /**
+     * Partition the options of the given hole of the subfamily into at most \p k balanced
+     * buckets by descending score and build the induced child families in the same pass.
+     * Scores are small non-negative integers (e.g. visit counts), so the options are ordered
+     * by a counting sort and dealt round-robin, balancing both the bucket sizes and the score
+     * mass across the children.
+     * @param subfamily the family being split
+     * @param hole the hole to split on
+     * @param scores for each option of the hole (over the full domain), its score
+     * @param k the maximal number of buckets
+     * @return for each bucket, the mask of its options and the induced child family
+     */
+    std::pair<std::vector<BitVector>,std::vector<Family>> partitionHoleOptions(
+        Family const& subfamily, uint64_t hole, std::vector<uint64_t> const& scores, uint64_t k
+    ) const;
+    /**
+     * For a singleton family (see \ref Family::isAssignment), pick the executed choice of every
+     * state: the first choice of the state whose colors are included in the assignment.
+     * Compatibility is evaluated once per state group.
+     * @return for each state, the selected choice of the quotient
+     */
+    std::vector<uint64_t> selectAssignmentChoices(Family const& assignment) const;
+    /**
+     * Compose the DTMC induced by a singleton family directly: the rows selected by
+     * \ref selectAssignmentChoices are copied into a matrix with one row per state and no
+     * row-group structure, the state space and labeling of the quotient are kept as they are
+     * and the reward models are restricted to the selected rows. This skips the generic
+     * mask-and-restrict machinery, which CEGIS otherwise pays per enumerated assignment.
+     */
+    template<typename ValueType>
+    std::shared_ptr<storm::models::sparse::Dtmc<ValueType>> applyAssignment(
+        Family const& assignment, storm::models::sparse::Model<ValueType> const& quotient
+    ) const;
+    /**
+     * Weight each hole by the expected visits of the states it labels: the weight of a hole
+     * is the sum of \p state_visits over the states whose choices involve the hole. Feeds
+     * visit-aware split scoring, where rarely visited holes should not win the split.
+     */
+    std::vector<double> weightHolesByVisits(std::vector<double> const& state_visits) const;
+
 protected:
 
+    /** Restore from loaded snapshot data (see \ref fromSnapshot). */
+    Coloring(Family const& family, ColoringSnapshot&& snapshot);
+
+    /** Rebuild the per-choice and per-state masks that are not part of a snapshot. */
+    void buildChoiceMasks();
+
     /** Reference to the unrefined family. */
     Family family;
     /** For each choice, a list of hole-option pairs (colors). */
@@ -43,6 +197,17 @@ protected:
     
     /** For each state, identification of holes associated with its choices. */
     std::vector<BitVector> choice_to_holes;
+    /** For each hole, a list of colored choices labeled by this hole. */
+    std::vector<std::vector<uint64_t>> hole_to_choices;
+    /**
+     * Inverted index of \ref choice_to_assignment: for each hole and each option of its full
+     * domain, the sorted list of choices labeled by that pair. Incremental selection and
+     * conflict pruning walk only the choices of the affected options instead of rescanning
+     * all choices of the hole.
+     */
+    std::vector<std::vector<std::vector<uint64_t>>> hole_option_to_choices;
+    /** Lazily decompressed per-(hole,option) choice masks (see \ref choicesWithHoleOption). */
+    mutable std::vector<std::vector<BitVector>> hole_option_choice_mask;
     /** For each state, identification of holes associated with its choices. */
     std::vector<BitVector> state_to_holes;
 
@@ -51,8 +216,38 @@ protected:
     /** Choices labeled by some hole. */
     BitVector colored_choices;
 
+    /**
+     * CSR-style view of \ref choice_to_assignment: the colors of choice c are the (hole,option)
+     * pairs at positions [assignment_offset[c],assignment_offset[c+1]) of the two flat arrays.
+     * Compatibility selection walks these contiguous buffers instead of chasing one heap vector
+     * per choice.
+     */
+    std::vector<uint64_t> assignment_offset;
+    /** Flattened hole components of \ref choice_to_assignment. */
+    std::vector<uint64_t> assignment_hole;
+    /** Flattened option components of \ref choice_to_assignment. */
+    std::vector<uint64_t> assignment_option;
+
+    /** Check whether the colors of the given choice are included in the family. */
+    bool choiceIsCompatible(Family const& family, uint64_t choice) const;
+
+    /** Row groups of the quotient. */
+    std::vector<uint64_t> row_groups;
+    /**
+     * States are grouped by identical coloring signatures (the list of assignment lists of their
+     * choices, in row order). Compatibility is evaluated once per group and fanned out to member
+     * states; on parameter-sharing sketches the compression is substantial.
+     */
+    std::vector<uint64_t> state_to_group;
+    /** For each group, its representative state. */
+    std::vector<uint64_t> group_representative;
+
     /** For each hole, collect options (colors) involved in any of the given choices. */
     std::vector<BitVector> collectHoleOptionsMask(BitVector const& choices) const;
+    /** Collect hole option masks over the choice range [\p begin,\p end). */
+    std::vector<BitVector> collectHoleOptionsMaskRange(BitVector const& choices, uint64_t begin, uint64_t end) const;
+    /** Turn per-hole option masks into per-hole option lists. */
+    std::vector<std::vector<uint64_t>> holeOptionsMaskToOptions(std::vector<BitVector> const& hole_options_mask) const;
 };
 
 }
\ No newline at end of file
@@ -1,14 +1,22 @@
 #include "ColoringSmt.h"
 
+#include "src/synthesis/Trace.h"
 #include "src/synthesis/translation/choiceTransformation.h"
 
+#include <storm/adapters/RationalNumberAdapter.h>
 #include <storm/storage/sparse/StateValuations.h>
 #include <storm/exceptions/UnexpectedException.h>
 
+#include <fstream>
+#include <map>
 #include <sstream>
+#include <thread>
 
 namespace synthesis {
 
+/** Number of relevant states above which per-state constructor passes are spread across threads. */
+const uint64_t COLORING_SETUP_PARALLEL_THRESHOLD = 1ull << 14;
+
 
 template<typename ValueType>
 ColoringSmt<ValueType>::ColoringSmt(
@@ -85,27 +93,96 @@ ColoringSmt<ValueType>::ColoringSmt(
         state_path_enabled.push_back(BitVector(numPaths()));
     }
 
-    // store state valuations in terms of hole options
-    state_valuation.resize(numStates());
-    for(uint64_t state: state_is_relevant) {
-        for(uint64_t variable = 0; variable < variable_name.size(); ++variable) {
-            storm::expressions::Variable const& program_variable = program_variables[variable];
-            int64_t value;
-            if(program_variable.hasBooleanType()) {
-                value = (int64_t)state_valuations.getBooleanValue(state,program_variable);
-            } else {
-                value = state_valuations.getIntegerValue(state,program_variable);
-            }
-            bool domain_option_found = false;
-            for(uint64_t domain_option = 0; domain_option < variable_domain[variable].size(); ++domain_option) {
-                if(variable_domain[variable][domain_option] == value) {
-                    state_valuation[state].push_back(domain_option);
-                    domain_option_found = true;
-                    break;
+    // per-state constructor passes are independent; spread them across threads for large
+    // quotients, following the worker-chunk pattern used elsewhere; solver expressions are
+    // excluded since they share the single solver context
+    uint64_t num_workers = std::max(std::thread::hardware_concurrency(), 1u);
+    if(state_is_relevant.getNumberOfSetBits() < COLORING_SETUP_PARALLEL_THRESHOLD) {
+        num_workers = 1;
+    }
+    num_workers = std::min<uint64_t>(num_workers, numStates());
+    num_workers = std::max<uint64_t>(num_workers, 1);
+    auto forEachStateChunk = [&](auto const& body) {
+        if(num_workers == 1) {
+            body(0, 0, numStates());
+            return;
+        }
+        uint64_t states_per_worker = (numStates() + num_workers - 1) / num_workers;
+        std::vector<std::thread> workers;
+        workers.reserve(num_workers-1);
+        for(uint64_t worker = 1; worker < num_workers; ++worker) {
+            uint64_t state_begin = std::min(worker*states_per_worker, numStates());
+            uint64_t state_end = std::min(state_begin+states_per_worker, numStates());
+            workers.emplace_back(body, worker, state_begin, state_end);
+        }
+        body(0, 0, std::min(states_per_worker, numStates()));
+        for(auto& worker: workers) {
+            worker.join();
+        }
+    };
+
+    // store state valuations in terms of hole options, bit-packed per state
+    for(uint64_t variable = 0; variable < numVariables(); ++variable) {
+        uint64_t bits = 1;
+        while((uint64_t(1) << bits) < variable_domain[variable].size()) {
+            ++bits;
+        }
+        variable_bits.push_back(bits);
+    }
+    uint64_t bits_per_state = 0;
+    for(uint64_t bits: variable_bits) {
+        bits_per_state += bits;
+    }
+    valuation_words_per_state = (bits_per_state+63)/64;
+    state_valuation_packed.resize(numStates()*valuation_words_per_state,0);
+
+    // states occupy disjoint words, so extraction and packing run without synchronization;
+    // each worker records a violation instead of throwing so that exceptions are raised
+    // after the join
+    std::vector<char> worker_option_missing(num_workers, 0);
+    forEachStateChunk([&](uint64_t worker, uint64_t state_begin, uint64_t state_end) {
+        std::vector<uint64_t> valuation(numVariables());
+        for(uint64_t state = state_begin; state < state_end; ++state) {
+            if(not state_is_relevant[state]) {
+                continue;
+            }
+            for(uint64_t variable = 0; variable < variable_name.size(); ++variable) {
+                storm::expressions::Variable const& program_variable = program_variables[variable];
+                int64_t value;
+                if(program_variable.hasBooleanType()) {
+                    value = (int64_t)state_valuations.getBooleanValue(state,program_variable);
+                } else {
+                    value = state_valuations.getIntegerValue(state,program_variable);
+                }
+                bool domain_option_found = false;
+                for(uint64_t domain_option = 0; domain_option < variable_domain[variable].size(); ++domain_option) {
+                    if(variable_domain[variable][domain_option] == value) {
+                        valuation[variable] = domain_option;
+                        domain_option_found = true;
+                        break;
+                    }
+                }
+                if(not domain_option_found) {
+                    worker_option_missing[worker] = 1;
+                    return;
                 }
             }
-            STORM_LOG_THROW(domain_option_found, storm::exceptions::UnexpectedException, "Hole option not found.");
+            packStateValuation(state,valuation);
         }
+    });
+    for(char option_missing: worker_option_missing) {
+        STORM_LOG_THROW(option_missing == 0, storm::exceptions::UnexpectedException, "Hole option not found.");
+    }
+
+    // group relevant states by identical tree-variable valuations
+    state_to_valuation_class.resize(numStates());
+    std::map<std::vector<uint64_t>,uint64_t> valuation_to_class;
+    for(uint64_t state: state_is_relevant) {
+        auto [entry,inserted] = valuation_to_class.try_emplace(stateValuation(state),valuation_class_representative.size());
+        if(inserted) {
+            valuation_class_representative.push_back(state);
+        }
+        state_to_valuation_class[state] = entry->second;
     }
     timers["ColoringSmt::0"].stop();
 
@@ -116,123 +193,138 @@ ColoringSmt<ValueType>::ColoringSmt(
     for(std::vector<bool> const& path: getRoot()->paths) {
         path_action_hole.push_back(getRoot()->getPathActionHole(path));
     }
+    // workers assemble label strings of disjoint choice slots
     choice_path_label.resize(numChoices());
-    for(uint64_t state: state_is_relevant) {
-        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
-            for(uint64_t path = 0; path < numPaths(); ++path) {
-                std::string label = "p" + std::to_string(choice) + "_" + std::to_string(path);
-                choice_path_label[choice].push_back(label);
+    forEachStateChunk([&](uint64_t worker, uint64_t state_begin, uint64_t state_end) {
+        for(uint64_t state = state_begin; state < state_end; ++state) {
+            if(not state_is_relevant[state]) {
+                continue;
+            }
+            for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+                for(uint64_t path = 0; path < numPaths(); ++path) {
+                    std::string label = "p" + std::to_string(choice) + "_" + std::to_string(path);
+                    choice_path_label[choice].push_back(label);
+                }
             }
         }
-    }
+    });
 
-    std::vector<const TerminalNode*> terminals;
     for(uint64_t path = 0; path < numPaths(); ++path) {
         terminals.push_back(getRoot()->getTerminal(getRoot()->paths[path]));
     }
 
-    // allocate array for path expressions
-    uint64_t longest_path = 0;
+    // prepare for lazy materialization of path expressions
+    longest_path = 0;
     for(uint64_t path = 0; path < numPaths(); ++path) {
         longest_path = std::max(longest_path,(uint64_t) getRoot()->paths[path].size());
     }
-    z3::expr_vector state_valuation_int(ctx);
-    z3::array<Z3_ast> clause_array(longest_path-1+num_actions);
-
     getRoot()->substituteActionExpressions();
     choice_path_expresssion.resize(numChoices());
-    for(uint64_t state = 0; state < numStates(); ++state) {
-        if(not state_is_relevant[state]) {
-            continue;
-        }
-
-        for(uint64_t value: state_valuation[state]) {
-            state_valuation_int.push_back(ctx.int_val(value));
-        }
-        timers["ColoringSmt::1-2 createPrefixSubstitutions"].start();
-        getRoot()->createPrefixSubstitutions(state_valuation[state], state_valuation_int);
-        timers["ColoringSmt::1-2 createPrefixSubstitutions"].stop();
-        state_valuation_int.resize(0);
-
-        timers["ColoringSmt::1-3"].start();
-        for(uint64_t path = 0; path < numPaths(); ++path) {
-            timers["ColoringSmt::1-3-1"].start();
-            getRoot()->substitutePrefixExpression(getRoot()->paths[path], clause_array);
-            timers["ColoringSmt::1-3-1"].stop();
+    state_expressions_built = BitVector(numStates(),false);
+    timers["ColoringSmt::1 create choice colors"].stop();
 
-            timers["ColoringSmt::1-3-2"].start();
-            for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
-                timers["ColoringSmt::1-3-2-1"].start();
-                uint64_t num_clauses = getRoot()->paths[path].size()-1;
-                uint64_t action = choice_to_action[choice];
-                clause_array[num_clauses++] = terminals[path]->action_expression[action];
-                timers["ColoringSmt::1-3-2-1"].stop();
-                timers["ColoringSmt::1-3-2-2"].start();
-                if(action == dont_care_action) {
-                    for(uint64_t unavailable_action: ~state_available_actions[state]) {
-                        clause_array[num_clauses++] = terminals[path]->action_expression[unavailable_action];
-                    }
-                }
-                timers["ColoringSmt::1-3-2-2"].stop();
-                choice_path_expresssion[choice].push_back(z3::expr(ctx, Z3_mk_or(ctx, num_clauses, clause_array.ptr())));
-                // choice_path_expresssion[choice].push_back(Z3_mk_or(ctx, num_clauses, clause_array.ptr()));
-            }
-            timers["ColoringSmt::1-3-2"].stop();
+    // fingerprint the construction inputs (FNV-1a); two colorings with the same hash assert
+    // the same base theory, which makes persisted conflict cores transferable between them
+    uint64_t hash = 14695981039346656037ull;
+    auto hashWord = [&hash](uint64_t word) {
+        for(uint64_t byte = 0; byte < 8; ++byte) {
+            hash = (hash ^ ((word >> (8*byte)) & 0xff)) * 1099511628211ull;
         }
-        timers["ColoringSmt::1-3"].stop();
+    };
+    for(uint64_t group: row_groups) { hashWord(group); }
+    for(uint64_t action: choice_to_action) { hashWord(action); }
+    hashWord(num_actions);
+    hashWord(dont_care_action);
+    for(std::string const& name: variable_name) {
+        for(char character: name) { hashWord((uint64_t)character); }
     }
-    timers["ColoringSmt::1 create choice colors"].stop();
+    for(auto const& domain: variable_domain) {
+        hashWord(domain.size());
+        for(int64_t value: domain) { hashWord((uint64_t)value); }
+    }
+    for(auto const& [parent,child_true,child_false]: tree_list) {
+        hashWord(parent); hashWord(child_true); hashWord(child_false);
+    }
+    for(uint64_t word: state_valuation_packed) { hashWord(word); }
+    for(uint64_t state: state_is_relevant) { hashWord(state); }
+    template_hash = hash;
 
     if(not this->enable_harmonization) {
         timers[__FUNCTION__].stop();
         return;
     }
 
-    timers["ColoringSmt::2 create harmonizing variants"].start();
-    // std::cout << "ColoringSmt::2 create harmonizing variants" << std::endl << std::flush;
-
     getRoot()->substituteActionExpressionsHarmonizing(harmonizing_variable);
     choice_path_expresssion_harm.resize(numChoices());
-    for(uint64_t state = 0; state < numStates(); ++state) {
-        if(not state_is_relevant[state]) {
-            continue;
-        }
+    state_expressions_harm_built = BitVector(numStates(),false);
 
-        for(uint64_t value: state_valuation[state]) {
-            state_valuation_int.push_back(ctx.int_val(value));
-        }
-        timers["ColoringSmt::2-2 createPrefixSubstitutionsHarmonizing"].start();
-        getRoot()->createPrefixSubstitutionsHarmonizing(state_valuation[state], state_valuation_int, harmonizing_variable);
-        timers["ColoringSmt::2-2 createPrefixSubstitutionsHarmonizing"].stop();
-        state_valuation_int.resize(0);
+    timers[__FUNCTION__].stop();
+}
 
-        timers["ColoringSmt::2-3"].start();
-        for(uint64_t path = 0; path < numPaths(); ++path) {
-            timers["ColoringSmt::2-3-1"].start();
-            getRoot()->substitutePrefixExpressionHarmonizing(getRoot()->paths[path], clause_array);
-            timers["ColoringSmt::2-3-1"].stop();
+template<typename ValueType>
+void ColoringSmt<ValueType>::buildChoicePathExpressions(uint64_t state) {
+    if(state_expressions_built[state] or not state_is_relevant[state]) {
+        return;
+    }
+    state_expressions_built.set(state,true);
+    ++counters["state_expressions_built"];
+    timers[__FUNCTION__].start();
 
-            timers["ColoringSmt::2-3-2"].start();
-            for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
-                uint64_t action = choice_to_action[choice];
-                uint64_t num_clauses = getRoot()->paths[path].size()-1;
-                clause_array[num_clauses++] = terminals[path]->action_expression_harmonizing[action];
-                if(action == dont_care_action) {
-                    for(uint64_t unavailable_action: ~state_available_actions[state]) {
-                        clause_array[num_clauses++] = terminals[path]->action_expression_harmonizing[unavailable_action];
-                    }
+    z3::expr_vector state_valuation_int(ctx);
+    z3::array<Z3_ast> clause_array(longest_path-1+num_actions);
+    auto valuation = stateValuation(state);
+    for(uint64_t value: valuation) {
+        state_valuation_int.push_back(ctx.int_val(value));
+    }
+    getRoot()->createPrefixSubstitutions(valuation, state_valuation_int);
+
+    for(uint64_t path = 0; path < numPaths(); ++path) {
+        getRoot()->substitutePrefixExpression(getRoot()->paths[path], clause_array);
+        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+            uint64_t num_clauses = getRoot()->paths[path].size()-1;
+            uint64_t action = choice_to_action[choice];
+            clause_array[num_clauses++] = terminals[path]->action_expression[action];
+            if(action == dont_care_action) {
+                for(uint64_t unavailable_action: ~state_available_actions[state]) {
+                    clause_array[num_clauses++] = terminals[path]->action_expression[unavailable_action];
                 }
-                choice_path_expresssion_harm[choice].push_back(z3::expr(ctx, Z3_mk_or(ctx, num_clauses, clause_array.ptr())));
-                // choice_path_expresssion_harm[choice].push_back(Z3_mk_or(ctx, num_clauses, clause_array.ptr()));
             }
-            timers["ColoringSmt::2-3-2"].stop();
+            choice_path_expresssion[choice].push_back(z3::expr(ctx, Z3_mk_or(ctx, num_clauses, clause_array.ptr())));
         }
-        timers["ColoringSmt::2-3"].stop();
     }
-    timers["ColoringSmt::2 create harmonizing variants"].stop();
+    timers[__FUNCTION__].stop();
+}
+
+template<typename ValueType>
+void ColoringSmt<ValueType>::buildChoicePathExpressionsHarmonizing(uint64_t state) {
+    if(state_expressions_harm_built[state] or not state_is_relevant[state]) {
+        return;
+    }
+    state_expressions_harm_built.set(state,true);
+    timers[__FUNCTION__].start();
 
-    getRoot()->clearCache();
+    z3::expr_vector state_valuation_int(ctx);
+    z3::array<Z3_ast> clause_array(longest_path-1+num_actions);
+    auto valuation = stateValuation(state);
+    for(uint64_t value: valuation) {
+        state_valuation_int.push_back(ctx.int_val(value));
+    }
+    getRoot()->createPrefixSubstitutionsHarmonizing(valuation, state_valuation_int, harmonizing_variable);
 
+    for(uint64_t path = 0; path < numPaths(); ++path) {
+        getRoot()->substitutePrefixExpressionHarmonizing(getRoot()->paths[path], clause_array);
+        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+            uint64_t action = choice_to_action[choice];
+            uint64_t num_clauses = getRoot()->paths[path].size()-1;
+            clause_array[num_clauses++] = terminals[path]->action_expression_harmonizing[action];
+            if(action == dont_care_action) {
+                for(uint64_t unavailable_action: ~state_available_actions[state]) {
+                    clause_array[num_clauses++] = terminals[path]->action_expression_harmonizing[unavailable_action];
+                }
+            }
+            choice_path_expresssion_harm[choice].push_back(z3::expr(ctx, Z3_mk_or(ctx, num_clauses, clause_array.ptr())));
+        }
+    }
     timers[__FUNCTION__].stop();
 }
 
@@ -248,6 +340,42 @@ void ColoringSmt<ValueType>::enableStateExploration(storm::models::sparse::Nonde
     this->choice_destinations = synthesis::computeChoiceDestinations(model);
 }
 
+template<typename ValueType>
+void ColoringSmt<ValueType>::setCancellationToken(std::shared_ptr<CancellationToken> token) {
+    this->cancellation_token = token;
+}
+
+template<typename ValueType>
+void ColoringSmt<ValueType>::packStateValuation(uint64_t state, std::vector<uint64_t> const& valuation) {
+    uint64_t word = state*valuation_words_per_state;
+    uint64_t bit = 0;
+    for(uint64_t variable = 0; variable < numVariables(); ++variable) {
+        if(bit+variable_bits[variable] > 64) {
+            ++word;
+            bit = 0;
+        }
+        state_valuation_packed[word] |= valuation[variable] << bit;
+        bit += variable_bits[variable];
+    }
+}
+
+template<typename ValueType>
+std::vector<uint64_t> ColoringSmt<ValueType>::stateValuation(uint64_t state) const {
+    std::vector<uint64_t> valuation(numVariables());
+    uint64_t word = state*valuation_words_per_state;
+    uint64_t bit = 0;
+    for(uint64_t variable = 0; variable < numVariables(); ++variable) {
+        if(bit+variable_bits[variable] > 64) {
+            ++word;
+            bit = 0;
+        }
+        uint64_t mask = (variable_bits[variable] == 64) ? ~uint64_t(0) : ((uint64_t(1) << variable_bits[variable])-1);
+        valuation[variable] = (state_valuation_packed[word] >> bit) & mask;
+        bit += variable_bits[variable];
+    }
+    return valuation;
+}
+
 template<typename ValueType>
 const uint64_t ColoringSmt<ValueType>::numStates() const {
     return row_groups.size()-1;
@@ -285,12 +413,41 @@ uint64_t ColoringSmt<ValueType>::numPaths() {
 
 template<typename ValueType>
 bool ColoringSmt<ValueType>::check() {
-    timers[__FUNCTION__].start();
+    timers["check"].start();
     bool sat = solver.check() == z3::sat;
-    timers[__FUNCTION__].stop();
+    timers["check"].stop();
+    ++counters["check_calls"];
+    ++counters[sat ? "check_sat" : "check_unsat"];
+    return sat;
+}
+
+template<typename ValueType>
+bool ColoringSmt<ValueType>::check(z3::expr_vector const& assumptions) {
+    timers["check"].start();
+    bool sat = solver.check(assumptions) == z3::sat;
+    timers["check"].stop();
+    ++counters["check_calls"];
+    ++counters[sat ? "check_sat" : "check_unsat"];
     return sat;
 }
 
+template<typename ValueType>
+z3::expr const& ColoringSmt<ValueType>::getChoicePathGuard(uint64_t choice, uint64_t path) {
+    if(choice_path_guard.empty()) {
+        choice_path_guard.resize(numChoices());
+    }
+    if(choice_path_guard[choice].empty()) {
+        choice_path_guard[choice].resize(numPaths());
+    }
+    if(not choice_path_guard[choice][path].has_value()) {
+        buildChoicePathExpressions(choice_to_state[choice]);
+        z3::expr guard = ctx.bool_const(choice_path_label[choice][path].c_str());
+        solver.add(z3::implies(guard,choice_path_expresssion[choice][path]));
+        choice_path_guard[choice][path] = guard;
+    }
+    return choice_path_guard[choice][path].value();
+}
+
 template<typename ValueType>std::vector<std::tuple<uint64_t,std::string,std::string>> ColoringSmt<ValueType>::getFamilyInfo() {
     std::vector<std::tuple<uint64_t,std::string,std::string>> hole_info(family.numHoles());
     getRoot()->loadHoleInfo(hole_info);
@@ -357,14 +514,30 @@ BitVector ColoringSmt<ValueType>::selectCompatibleChoices(Family const& subfamil
         }
     }
 
+    // per-query cache of path evaluations, one entry per valuation class
+    std::vector<bool> valuation_class_evaluated(valuation_class_representative.size(),false);
+    std::vector<BitVector> valuation_class_path_enabled(valuation_class_representative.size());
+
     while(not unexplored_states.empty()) {
         uint64_t state = unexplored_states.front(); unexplored_states.pop();
         if(state_is_relevant[state]) {
-            state_path_enabled[state].clear();
-            for(uint64_t path = 0; path < numPaths(); ++path) {
-                bool path_enabled = getRoot()->isPathEnabledInState(getRoot()->paths[path],subfamily,state_valuation[state]);
-                state_path_enabled[state].set(path,path_enabled);
+            uint64_t valuation_class = state_to_valuation_class[state];
+            if(valuation_class_evaluated[valuation_class]) {
+                ++counters["valuation_cache_hits"];
+            } else {
+                ++counters["valuation_cache_misses"];
+            }
+            if(not valuation_class_evaluated[valuation_class]) {
+                auto valuation = stateValuation(state);
+                BitVector path_enabled_mask(numPaths(),false);
+                for(uint64_t path = 0; path < numPaths(); ++path) {
+                    bool path_enabled = getRoot()->isPathEnabledInState(getRoot()->paths[path],subfamily,valuation);
+                    path_enabled_mask.set(path,path_enabled);
+                }
+                valuation_class_path_enabled[valuation_class] = std::move(path_enabled_mask);
+                valuation_class_evaluated[valuation_class] = true;
             }
+            state_path_enabled[state] = valuation_class_path_enabled[valuation_class];
         }
         bool any_choice_enabled = false;
         uint64_t num_choices_enabled = 0;
@@ -500,6 +673,8 @@ void ColoringSmt<ValueType>::loadUnsatCore(z3::expr_vector const& unsat_core_exp
         critical_states.insert(state);
     }
     for(uint64_t state: critical_states) {
+        // states of the core are repeat offenders; prioritize them in later interval scans
+        recordStateConflict(state);
         for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
             if(not choices[choice]) {
                 continue;
@@ -514,58 +689,347 @@ void ColoringSmt<ValueType>::loadUnsatCore(z3::expr_vector const& unsat_core_exp
     return;
 }
 
+template<typename ValueType>
+void ColoringSmt<ValueType>::recordLearnedCore(Family const& subfamily) {
+    if(this->unsat_core.empty() or learned_cores.size() >= MAX_LEARNED_CORES) {
+        return;
+    }
+    LearnedCore learned_core;
+    std::vector<uint64_t> key;
+    for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+        if(subfamily.holeNumOptions(hole) == family.holeNumOptions(hole)) {
+            continue;
+        }
+        learned_core.restricted_holes.emplace_back(hole,subfamily.holeOptions(hole));
+        key.push_back(hole);
+        for(uint64_t option: subfamily.holeOptions(hole)) {
+            key.push_back(option);
+        }
+    }
+    learned_core.core = this->unsat_core;
+    key.push_back(family.numHoles()); // separates the hole part from the core part
+    for(auto [choice,path]: learned_core.core) {
+        key.push_back(choice);
+        key.push_back(path);
+    }
+    auto [entry,inserted] = learned_core_keys.insert(std::move(key));
+    if(inserted) {
+        learned_cores.push_back(std::move(learned_core));
+    }
+}
+
+template<typename ValueType>
+void ColoringSmt<ValueType>::preassertLearnedCore(LearnedCore const& learned_core) {
+    Family subfamily(family);
+    for(auto const& [hole,options]: learned_core.restricted_holes) {
+        subfamily.holeSetOptions(hole,options);
+    }
+    z3::expr_vector encoding(ctx);
+    getRoot()->collectFamilyEncoding(subfamily,encoding);
+    z3::expr_vector colors(ctx);
+    for(auto [choice,path]: learned_core.core) {
+        colors.push_back(getChoicePathGuard(choice,path));
+    }
+    solver.add(z3::implies(z3::mk_and(encoding), not z3::mk_and(colors)));
+}
+
+template<typename ValueType>
+uint64_t ColoringSmt<ValueType>::loadClauseDatabase(std::string const& path) {
+    timers[__FUNCTION__].start();
+    std::ifstream database(path, std::ios::binary);
+    auto readWord = [&database]() {
+        uint64_t word = 0;
+        database.read(reinterpret_cast<char*>(&word),sizeof(word));
+        return word;
+    };
+    // a missing or stale database is the expected state after a sketch or template change,
+    // not an error: the run simply starts cold and rebuilds it
+    if(not database or readWord() != CLAUSE_DATABASE_MAGIC or readWord() != template_hash) {
+        timers[__FUNCTION__].stop();
+        return 0;
+    }
+    uint64_t num_cores = readWord();
+    for(uint64_t index = 0; index < num_cores and database; ++index) {
+        LearnedCore learned_core;
+        std::vector<uint64_t> key;
+        uint64_t num_restricted = readWord();
+        for(uint64_t restricted = 0; restricted < num_restricted; ++restricted) {
+            uint64_t hole = readWord();
+            std::vector<uint64_t> options(readWord());
+            for(uint64_t& option: options) {
+                option = readWord();
+            }
+            STORM_LOG_THROW(hole < family.numHoles(), storm::exceptions::UnexpectedException, "corrupted clause database");
+            key.push_back(hole);
+            key.insert(key.end(),options.begin(),options.end());
+            learned_core.restricted_holes.emplace_back(hole,std::move(options));
+        }
+        uint64_t num_pairs = readWord();
+        key.push_back(family.numHoles());
+        for(uint64_t pair = 0; pair < num_pairs; ++pair) {
+            uint64_t choice = readWord();
+            uint64_t path = readWord();
+            STORM_LOG_THROW(choice < numChoices() and path < numPaths(), storm::exceptions::UnexpectedException, "corrupted clause database");
+            key.push_back(choice);
+            key.push_back(path);
+            learned_core.core.emplace_back(choice,path);
+        }
+        auto [entry,inserted] = learned_core_keys.insert(std::move(key));
+        if(inserted) {
+            preassertLearnedCore(learned_core);
+            learned_cores.push_back(std::move(learned_core));
+        }
+    }
+    counters["clause_database_loaded"] = learned_cores.size();
+    timers[__FUNCTION__].stop();
+    return learned_cores.size();
+}
+
+template<typename ValueType>
+uint64_t ColoringSmt<ValueType>::saveClauseDatabase(std::string const& path) {
+    timers[__FUNCTION__].start();
+    std::ofstream database(path, std::ios::binary | std::ios::trunc);
+    STORM_LOG_THROW(bool(database), storm::exceptions::UnexpectedException, "cannot open clause database for writing");
+    auto writeWord = [&database](uint64_t word) {
+        database.write(reinterpret_cast<char const*>(&word),sizeof(word));
+    };
+    writeWord(CLAUSE_DATABASE_MAGIC);
+    writeWord(template_hash);
+    writeWord(learned_cores.size());
+    for(LearnedCore const& learned_core: learned_cores) {
+        writeWord(learned_core.restricted_holes.size());
+        for(auto const& [hole,options]: learned_core.restricted_holes) {
+            writeWord(hole);
+            writeWord(options.size());
+            for(uint64_t option: options) {
+                writeWord(option);
+            }
+        }
+        writeWord(learned_core.core.size());
+        for(auto [choice,path]: learned_core.core) {
+            writeWord(choice);
+            writeWord(path);
+        }
+    }
+    timers[__FUNCTION__].stop();
+    return learned_cores.size();
+}
+
+template<typename ValueType>
+void ColoringSmt<ValueType>::recordStateConflict(uint64_t state) {
+    if(state_conflict_score.empty()) {
+        state_conflict_score.resize(numStates(),0);
+    }
+    state_conflict_score[state] += conflict_weight;
+    conflict_scan_order_current = false;
+}
+
+template<typename ValueType>
+void ColoringSmt<ValueType>::advanceConflictClock() {
+    conflict_weight /= CONFLICT_DECAY;
+    if(conflict_weight > 1e100) {
+        // rescale so that the weights stay representable; the relative scores are unchanged
+        for(double& score: state_conflict_score) {
+            score /= conflict_weight;
+        }
+        conflict_weight = 1;
+        conflict_scan_order_current = false;
+    }
+}
+
+template<typename ValueType>
+std::vector<uint64_t> const& ColoringSmt<ValueType>::conflictScanOrder() {
+    if(conflict_scan_order_current) {
+        return conflict_scan_order;
+    }
+    conflict_scan_order.clear();
+    if(state_in_conflict_scan_order.size() == 0) {
+        state_in_conflict_scan_order = BitVector(numStates(),false);
+    } else {
+        state_in_conflict_scan_order.clear();
+    }
+    // only states whose decayed score is still notable take part in the priority scan
+    std::vector<std::pair<double,uint64_t>> scored;
+    for(uint64_t state = 0; state < state_conflict_score.size(); ++state) {
+        if(state_conflict_score[state] >= conflict_weight*CONFLICT_SCORE_MIN) {
+            scored.emplace_back(state_conflict_score[state],state);
+        }
+    }
+    std::sort(scored.begin(),scored.end(),
+        [](std::pair<double,uint64_t> const& a, std::pair<double,uint64_t> const& b) { return a.first > b.first; }
+    );
+    for(auto const& [score,state]: scored) {
+        conflict_scan_order.push_back(state);
+        state_in_conflict_scan_order.set(state,true);
+    }
+    conflict_scan_order_current = true;
+    return conflict_scan_order;
+}
+
+template<typename ValueType>
+bool ColoringSmt<ValueType>::areChoicesConsistentInterval(
+    BitVector const& choices, Family const& subfamily,
+    std::vector<std::vector<uint64_t>> & hole_options, bool & consistent
+) {
+    // for each terminal action hole demanded by some state, the admissible options
+    std::map<uint64_t,BitVector> action_hole_allowed;
+    bool defer_to_solver = false;
+    bool conflict_found = false;
+    uint64_t conflict_state = 0;
+    // process the selected choices of a state; returns false when the state defers the query
+    // to the solver or produces a definite inconsistency
+    auto scanState = [&](uint64_t state) {
+        if(not state_is_relevant[state]) {
+            return true;
+        }
+        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+            if(not choices[choice]) {
+                continue;
+            }
+            if(state_path_enabled[state].getNumberOfSetBits() != 1) {
+                // the state can be routed to multiple terminals, deferring to the solver
+                defer_to_solver = true;
+                return false;
+            }
+            uint64_t path = *state_path_enabled[state].begin();
+            uint64_t path_hole = path_action_hole[path];
+            auto [entry,inserted] = action_hole_allowed.try_emplace(path_hole,BitVector(num_actions,false));
+            BitVector & allowed = entry->second;
+            if(inserted) {
+                for(uint64_t option: subfamily.holeOptions(path_hole)) {
+                    allowed.set(option,true);
+                }
+            }
+            uint64_t action = choice_to_action[choice];
+            BitVector demanded(num_actions,false);
+            demanded.set(action,true);
+            if(action == dont_care_action) {
+                demanded |= ~state_available_actions[state];
+            }
+            allowed &= demanded;
+            if(allowed.empty()) {
+                // the intersection only ever shrinks, so this verdict is definite
+                conflict_found = true;
+                conflict_state = state;
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // historically conflicting states are scanned first: the same few states produce most
+    // inconsistencies across AR iterations, so a definite conflict typically returns within
+    // the first states of the priority pass instead of after a full scan
+    for(uint64_t state: conflictScanOrder()) {
+        if(not scanState(state)) {
+            break;
+        }
+    }
+    if(not defer_to_solver and not conflict_found) {
+        uint64_t previous_state = numStates();
+        for(uint64_t choice: choices) {
+            uint64_t state = choice_to_state[choice];
+            if(state == previous_state) {
+                // the whole row group was scanned when its first selected choice came up
+                continue;
+            }
+            previous_state = state;
+            if(state_in_conflict_scan_order.size() > 0 and state_in_conflict_scan_order[state]) {
+                // already covered by the priority pass
+                continue;
+            }
+            if(not scanState(state)) {
+                break;
+            }
+        }
+    }
+    if(defer_to_solver) {
+        return false;
+    }
+    if(conflict_found) {
+        consistent = false;
+        recordStateConflict(conflict_state);
+        return true;
+    }
+    consistent = true;
+    // build a witness assignment; the routing holes are unconstrained since every state is
+    // routed to its terminal under any subfamily assignment, so any option works
+    for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+        auto entry = action_hole_allowed.find(hole);
+        if(entry != action_hole_allowed.end()) {
+            hole_options[hole].push_back(entry->second.getNextSetIndex(0));
+        } else {
+            hole_options[hole].push_back(subfamily.holeOptions(hole).front());
+        }
+    }
+    return true;
+}
+
 template<typename ValueType>
 std::pair<bool,std::vector<std::vector<uint64_t>>> ColoringSmt<ValueType>::areChoicesConsistent(BitVector const& choices, Family const& subfamily) {
+    PAYNT_TRACE_SCOPE("quotient.areChoicesConsistent");
     timers[__FUNCTION__].start();
+    advanceConflictClock();
     std::vector<std::vector<uint64_t>> hole_options_vector(family.numHoles());
 
-    /*for(uint64_t choice: choices) {
-        uint64_t action = choice_to_action[choice];
-        uint64_t state = choice_to_state[choice];
-        if(not state_is_relevant[state]) {
-            continue;
+    timers["areChoicesConsistent::0 interval fast path"].start();
+    bool interval_consistent;
+    bool interval_decided = areChoicesConsistentInterval(choices,subfamily,hole_options_vector,interval_consistent);
+    timers["areChoicesConsistent::0 interval fast path"].stop();
+    if(interval_decided) {
+        ++counters["consistency_interval_decided"];
+        if(interval_consistent) {
+            timers[__FUNCTION__].stop();
+            return std::make_pair(true,hole_options_vector);
         }
-        if(state_path_enabled[state].getNumberOfSetBits() == 1) {
-            std::cout << (action == this->dont_care_action);
+        if(not this->enable_harmonization) {
+            timers[__FUNCTION__].stop();
+            return std::make_pair(false,hole_options_vector);
         }
-    }*/
+        // an inconsistency explanation is required: defer to the solver for the UNSAT core
+    } else {
+        ++counters["consistency_interval_fallback"];
+    }
 
     timers["areChoicesConsistent::1 is scheduler consistent?"].start();
-    solver.push();
-    getRoot()->addFamilyEncoding(subfamily,solver);
-    solver.push();
+    if(cancellation_token != nullptr and cancellation_token->isCancelled()) {
+        // report the selection as inconsistent without an explanation; the caller learns
+        // about the interruption from the token
+        timers["areChoicesConsistent::1 is scheduler consistent?"].stop();
+        timers[__FUNCTION__].stop();
+        return std::make_pair(false,hole_options_vector);
+    }
+    // collect assumptions first so that guarded colors are asserted at the base solver level and
+    // clauses learned over them survive the family push/pop below
+    z3::expr_vector choice_assumptions(ctx);
     for(uint64_t choice: choices) {
         uint64_t state = choice_to_state[choice];
         if(not state_is_relevant[state]) {
             continue;
         }
         for(uint64_t path: state_path_enabled[state]) {
-            const char *label = choice_path_label[choice][path].c_str();
-            solver.add(choice_path_expresssion[choice][path], label);
-            // Z3_solver_assert_and_track(ctx, solver.operator Z3_solver(), choice_path_expresssion[choice][path], ctx.bool_const(label));
+            choice_assumptions.push_back(getChoicePathGuard(choice,path));
         }
     }
-    bool consistent = check();
+    solver.push();
+    getRoot()->addFamilyEncoding(subfamily,solver);
+    bool consistent = check(choice_assumptions);
     timers["areChoicesConsistent::1 is scheduler consistent?"].stop();
 
     if(consistent) {
         z3::model model = solver.get_model();
         solver.pop();
-        solver.pop();
         getRoot()->loadHoleAssignmentFromModel(model,hole_options_vector);
         timers[__FUNCTION__].stop();
         return std::make_pair(true,hole_options_vector);
     }
 
     if(not this->enable_harmonization) {
-        solver.pop();
         solver.pop();
         timers[__FUNCTION__].stop();
         return std::make_pair(false,hole_options_vector);
     }
 
-    solver.pop();
-
     timers["areChoicesConsistent::2 better unsat core"].start();
     solver.push();
     std::queue<uint64_t> unexplored_states;
@@ -573,7 +1037,21 @@ std::pair<bool,std::vector<std::vector<uint64_t>>> ColoringSmt<ValueType>::areCh
     BitVector state_reached(numStates(),false);
     state_reached.set(initial_state,true);
     consistent = true;
+    uint64_t states_processed = 0;
     while(consistent) {
+        if(cancellation_token != nullptr) {
+            if(cancellation_token->isCancelled()) {
+                // stop at the state boundary and bail out of the core search; the partial
+                // exploration is discarded and the selection is reported as inconsistent
+                solver.pop();
+                solver.pop();
+                timers["areChoicesConsistent::2 better unsat core"].stop();
+                timers[__FUNCTION__].stop();
+                return std::make_pair(false,hole_options_vector);
+            }
+            cancellation_token->reportProgress(states_processed,0);
+        }
+        ++states_processed;
         STORM_LOG_THROW(not unexplored_states.empty(), storm::exceptions::UnexpectedException, "all states explored but UNSAT core not found");
         uint64_t state = unexplored_states.front(); unexplored_states.pop();
         for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
@@ -581,6 +1059,7 @@ std::pair<bool,std::vector<std::vector<uint64_t>>> ColoringSmt<ValueType>::areCh
                 continue;
             }
             if(state_is_relevant[state]) {
+                buildChoicePathExpressions(state);
                 for(uint64_t path: state_path_enabled[state]) {
                     const char *label = choice_path_label[choice][path].c_str();
                     solver.add(choice_path_expresssion[choice][path], label);
@@ -596,12 +1075,14 @@ std::pair<bool,std::vector<std::vector<uint64_t>>> ColoringSmt<ValueType>::areCh
     solver.pop();
     // loadUnsatCore(unsat_core_expr,subfamily);
     loadUnsatCore(unsat_core_expr,subfamily,choices);
+    recordLearnedCore(subfamily);
     timers["areChoicesConsistent::2 better unsat core"].stop();
 
     if(PRINT_UNSAT_CORE)
         std::cout << "-- unsat core start --" << std::endl;
     timers["areChoicesConsistent::3 unsat core analysis"].start();
     for(auto [choice,path]: this->unsat_core) {
+        buildChoicePathExpressionsHarmonizing(choice_to_state[choice]);
         const char *label = choice_path_label[choice][path].c_str();
         solver.add(choice_path_expresssion_harm[choice][path], label);
         // Z3_solver_assert_and_track(ctx, solver.operator Z3_solver(), choice_path_expresssion_harm[choice][path], ctx.bool_const(label));
@@ -655,7 +1136,146 @@ std::pair<bool,std::vector<std::vector<uint64_t>>> ColoringSmt<ValueType>::areCh
     return std::make_pair(false,hole_options_vector);
 }
 
+template<typename ValueType>
+std::vector<std::vector<std::pair<uint64_t,uint64_t>>> ColoringSmt<ValueType>::enumerateInconsistencyCores(
+    BitVector const& choices, Family const& subfamily, uint64_t max_cores
+) {
+    timers[__FUNCTION__].start();
+    std::vector<std::vector<std::pair<uint64_t,uint64_t>>> cores;
+
+    z3::expr_vector choice_assumptions(ctx);
+    for(uint64_t choice: choices) {
+        uint64_t state = choice_to_state[choice];
+        if(not state_is_relevant[state]) {
+            continue;
+        }
+        for(uint64_t path: state_path_enabled[state]) {
+            choice_assumptions.push_back(getChoicePathGuard(choice,path));
+        }
+    }
+
+    solver.push();
+    getRoot()->addFamilyEncoding(subfamily,solver);
+    while(cores.size() < max_cores) {
+        if(cancellation_token != nullptr and cancellation_token->isCancelled()) {
+            // the cores found so far are a valid partial result
+            break;
+        }
+        if(cancellation_token != nullptr) {
+            cancellation_token->reportProgress(cores.size(),0);
+        }
+        if(check(choice_assumptions)) {
+            break;
+        }
+        std::vector<std::pair<uint64_t,uint64_t>> core;
+        std::set<std::string> core_labels;
+        for(z3::expr expr: solver.unsat_core()) {
+            std::string label = expr.decl().name().str();
+            std::istringstream iss(label);
+            char prefix; iss >> prefix;
+            if(prefix == 'h' or prefix == 'z') {
+                continue;
+            }
+            uint64_t choice,path; iss >> choice; iss >> prefix; iss >> path;
+            core.emplace_back(choice,path);
+            core_labels.insert(label);
+        }
+        if(core.empty()) {
+            // the family encoding itself is inconsistent, nothing to enumerate
+            break;
+        }
+        cores.push_back(core);
+        // exclude the found core from the assumptions and re-solve
+        z3::expr_vector remaining_assumptions(ctx);
+        for(z3::expr const& assumption: choice_assumptions) {
+            if(core_labels.find(assumption.decl().name().str()) == core_labels.end()) {
+                remaining_assumptions.push_back(assumption);
+            }
+        }
+        choice_assumptions = remaining_assumptions;
+    }
+    solver.pop();
+
+    std::sort(cores.begin(),cores.end(),[](auto const& left, auto const& right) {
+        return left.size() < right.size();
+    });
+    timers[__FUNCTION__].stop();
+    return cores;
+}
+
+template<typename ValueType>
+std::vector<std::pair<uint64_t,std::vector<std::vector<uint64_t>>>> ColoringSmt<ValueType>::harmonizeInconsistentScheduler(
+    BitVector const& choices, Family const& subfamily
+) {
+    timers[__FUNCTION__].start();
+    STORM_LOG_THROW(
+        this->enable_harmonization, storm::exceptions::UnexpectedException, "harmonization is not enabled"
+    );
+    std::vector<std::pair<uint64_t,std::vector<std::vector<uint64_t>>>> harmonizations;
+
+    solver.push();
+    getRoot()->addFamilyEncoding(subfamily,solver);
+
+    // find an UNSAT core via incremental state exploration
+    solver.push();
+    std::queue<uint64_t> unexplored_states;
+    unexplored_states.push(initial_state);
+    BitVector state_reached(numStates(),false);
+    state_reached.set(initial_state,true);
+    bool consistent = true;
+    while(consistent) {
+        STORM_LOG_THROW(not unexplored_states.empty(), storm::exceptions::UnexpectedException, "all states explored but UNSAT core not found");
+        uint64_t state = unexplored_states.front(); unexplored_states.pop();
+        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+            if(not choices[choice]) {
+                continue;
+            }
+            if(state_is_relevant[state]) {
+                buildChoicePathExpressions(state);
+                for(uint64_t path: state_path_enabled[state]) {
+                    const char *label = choice_path_label[choice][path].c_str();
+                    solver.add(choice_path_expresssion[choice][path], label);
+                }
+                consistent = check();
+            }
+            visitChoice(choice,state_reached,unexplored_states);
+            break;
+        }
+    }
+    z3::expr_vector unsat_core_expr = solver.unsat_core();
+    solver.pop();
+    loadUnsatCore(unsat_core_expr,subfamily,choices);
+    recordLearnedCore(subfamily);
+
+    // assert the harmonizing variant of the core once, then sweep candidate holes
+    for(auto [choice,path]: this->unsat_core) {
+        buildChoicePathExpressionsHarmonizing(choice_to_state[choice]);
+        const char *label = choice_path_label[choice][path].c_str();
+        solver.add(choice_path_expresssion_harm[choice][path], label);
+    }
+    for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+        solver.push();
+        solver.add(harmonizing_variable == (int)hole);
+        if(check()) {
+            z3::model model = solver.get_model();
+            std::vector<std::vector<uint64_t>> hole_options_vector(family.numHoles());
+            getRoot()->loadHoleAssignmentFromModel(model,hole_options_vector);
+            getRoot()->loadHoleAssignmentFromModelHarmonizing(model,hole_options_vector,hole);
+            if(hole_options_vector[hole][0] > hole_options_vector[hole][1]) {
+                std::swap(hole_options_vector[hole][0],hole_options_vector[hole][1]);
+            }
+            harmonizations.emplace_back(hole,hole_options_vector);
+        }
+        solver.pop();
+    }
+    solver.pop();
+
+    timers[__FUNCTION__].stop();
+    return harmonizations;
+}
+
 
 template class ColoringSmt<>;
+template class ColoringSmt<storm::RationalNumber>;
 
 }
\ No newline at end of file
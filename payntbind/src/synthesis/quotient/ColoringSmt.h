@@ -1,5 +1,6 @@
 #pragma once
 
+#include "src/synthesis/CancellationToken.h"
 #include "src/synthesis/quotient/Family.h"
 #include "src/synthesis/quotient/TreeNode.h"
 
@@ -8,7 +9,10 @@
 #include <storm/utility/Stopwatch.h>
 
 #include <cstdint>
+#include <optional>
 #include <queue>
+#include <set>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -78,6 +82,28 @@ public:
         BitVector const& choices, Family const& subfamily
     );
 
+    /**
+     * Enumerate up to \p max_cores distinct inconsistency cores of the given choice selection
+     * within one solver session: each found core is excluded from the assumption set and the query
+     * is re-solved, so no per-call solver warm-up is paid.
+     * @return the found cores as lists of (choice,path) pairs, ordered by increasing size; empty
+     * if the selection is consistent
+     */
+    std::vector<std::vector<std::pair<uint64_t,uint64_t>>> enumerateInconsistencyCores(
+        BitVector const& choices, Family const& subfamily, uint64_t max_cores
+    );
+
+    /**
+     * Run the full harmonization sweep for an inconsistent choice selection: find an UNSAT core,
+     * assert its harmonizing variant once and then iterate candidate harmonizing holes with the
+     * solver state reused across the sweep.
+     * @return for every feasible harmonizing hole, the corresponding hole assignment (with the two
+     * options of the harmonizing hole in ascending order)
+     */
+    std::vector<std::pair<uint64_t,std::vector<std::vector<uint64_t>>>> harmonizeInconsistentScheduler(
+        BitVector const& choices, Family const& subfamily
+    );
+
     std::map<std::string,storm::utility::Stopwatch> timers;
     std::vector<std::pair<std::string,double>> getProfilingInfo() {
         std::vector<std::pair<std::string,double>> profiling;
@@ -87,14 +113,60 @@ public:
         return profiling;
     }
 
+    /** Event counters (solver calls, sat/unsat verdicts, cache hits) keyed by name. */
+    std::map<std::string,uint64_t> counters;
+    /**
+     * Get a structured profiling report: all event counters plus per-phase times in seconds
+     * (timer entries are prefixed with "time:"). Suitable for scraping per synthesis run.
+     */
+    std::map<std::string,double> getProfilingReport() {
+        std::map<std::string,double> report;
+        for(auto const& [name,count]: counters) {
+            report[name] = (double)count;
+        }
+        for(auto const& [method,timer]: timers) {
+            report["time:" + method] = (double)(timer.getTimeInMilliseconds())/1000;
+        }
+        return report;
+    }
+
+    /**
+     * Attach a cancellation token: \ref areChoicesConsistent polls it around every solver call
+     * of the UNSAT-core search and stops at the next boundary when it fires, returning the
+     * selection as inconsistent with the (partial) assignments collected so far - the caller
+     * learns about the interruption by querying the token. The token also receives progress
+     * reports (states processed) during the core search.
+     */
+    void setCancellationToken(std::shared_ptr<CancellationToken> token);
+
     /** A list of choice-path indices appeared in the last UNSAT core. */
     std::vector<std::pair<uint64_t,uint64_t>> unsat_core;
 
+    /**
+     * Pre-assert the conflict cores persisted by a previous run on the same coloring. Each
+     * stored core is replayed as an implication "subfamily encoding => not (core colors)",
+     * which is a consequence of the (deterministic) base assertions, so the solver starts
+     * with the lemmas it would otherwise re-learn query by query. Databases whose template
+     * hash does not match this coloring - a changed sketch or tree template - are ignored.
+     * Call right after construction, before the first query.
+     * @return the number of pre-asserted cores
+     */
+    uint64_t loadClauseDatabase(std::string const& path);
+    /**
+     * Persist the conflict cores learned so far (including the loaded ones) for the next run
+     * on the same coloring, tagged by the template hash.
+     * @return the number of stored cores
+     */
+    uint64_t saveClauseDatabase(std::string const& path);
+
 protected:
 
     /** Whether a check for an admissible family member is done before choice selection. */
     const bool CHECK_FAMILY_CONSISTENCE = true;
 
+    /** Cancellation token polled by the long-running queries, if attached. */
+    std::shared_ptr<CancellationToken> cancellation_token;
+
     /** Row groups of the quotient. */
     const std::vector<uint64_t> row_groups;
     /** For each choice, the state it comes from. */
@@ -115,8 +187,21 @@ protected:
     /** Whether the don't-care action is present in the MDP. */
     const bool dontCareActionDefined() const;
 
-    /** Valuation of each state. */
-    std::vector<std::vector<uint64_t>> state_valuation;
+    /**
+     * Valuations of all relevant states, bit-packed into one contiguous word array: each variable
+     * occupies a fixed number of bits (enough for its domain) and each state occupies the same
+     * number of words. For large quotients this shrinks valuation storage by an order of magnitude
+     * compared to one heap vector per state.
+     */
+    std::vector<uint64_t> state_valuation_packed;
+    /** For each variable, the number of bits its domain index occupies. */
+    std::vector<uint64_t> variable_bits;
+    /** Number of words each state occupies in \ref state_valuation_packed. */
+    uint64_t valuation_words_per_state;
+    /** Store the valuation of the given state. */
+    void packStateValuation(uint64_t state, std::vector<uint64_t> const& valuation);
+    /** Retrieve the valuation of the given state. */
+    std::vector<uint64_t> stateValuation(uint64_t state) const;
     /** Only relevant states are taken into account when checking consistency. */
     const BitVector state_is_relevant;
 
@@ -152,15 +237,42 @@ protected:
 
     /** Check the current SMT formula. */
     bool check();
+    /** Check the current SMT formula under the given assumptions. */
+    bool check(z3::expr_vector const& assumptions);
 
     /** For each path, an index of the hole that occurs at its end. */
     std::vector<uint64_t> path_action_hole;
+    /** For each path, its terminal node. */
+    std::vector<const TerminalNode *> terminals;
+    /** Length of the longest path in the tree. */
+    uint64_t longest_path;
+    /**
+     * States for which choice-path expressions have been materialized. Expressions are built
+     * lazily on the first consistency query that touches a state, so shallow synthesis runs never
+     * pay the construction cost of states (and template depths) they do not reach.
+     */
+    BitVector state_expressions_built;
+    /** States for which harmonizing choice-path expressions have been materialized. */
+    BitVector state_expressions_harm_built;
+    /** Materialize choice-path expressions of the given state, unless done before. */
+    void buildChoicePathExpressions(uint64_t state);
+    /** Materialize harmonizing choice-path expressions of the given state, unless done before. */
+    void buildChoicePathExpressionsHarmonizing(uint64_t state);
     /** For each choice and path, a label passed to SMT solver. */
     std::vector<std::vector<std::string>> choice_path_label;
     /** For each choice, its color expressed as a conjunction of all path implications. */
     std::vector<std::vector<z3::expr>> choice_path_expresssion;
     // std::vector<std::vector<Z3_ast>> choice_path_expresssion;
 
+    /**
+     * For each choice and path, the activation literal guarding its color. The guarded implication
+     * is asserted permanently (at the base solver level) on first use, so consecutive consistency
+     * queries re-select colors via assumptions and the solver retains learned clauses over them.
+     */
+    std::vector<std::vector<std::optional<z3::expr>>> choice_path_guard;
+    /** Get the activation literal of the given choice-path, asserting its guarded color on first use. */
+    z3::expr const& getChoicePathGuard(uint64_t choice, uint64_t path);
+
 
     /** Whether harmonization is required. */
     const bool enable_harmonization;
@@ -173,6 +285,50 @@ protected:
     /** For each state, whether (in the last subfamily) the path was enabled. */
     std::vector<BitVector> state_path_enabled;
 
+    /**
+     * Try to decide scheduler consistency by pure interval reasoning, without the solver. All
+     * tree predicates are axis-aligned comparisons, so whenever every relevant state has exactly
+     * one enabled path, any subfamily assignment routes the state down that path and consistency
+     * reduces to intersecting, per terminal, the actions demanded by the states routed to it.
+     * Returns true iff the query was decided this way; the verdict is stored in \p consistent
+     * and, if consistent, a witness assignment is stored in \p hole_options. States with
+     * multiple enabled paths require the solver and make this method return false.
+     */
+    bool areChoicesConsistentInterval(
+        BitVector const& choices, Family const& subfamily,
+        std::vector<std::vector<uint64_t>> & hole_options, bool & consistent
+    );
+
+    /** Decay base of the per-state conflict scores; one consistency query is one time step. */
+    static constexpr double CONFLICT_DECAY = 0.95;
+    /** Normalized score below which a state drops out of the priority scan. */
+    static constexpr double CONFLICT_SCORE_MIN = 0.01;
+    /** For each state, its exponentially decayed conflict score (scaled by @conflict_weight). */
+    std::vector<double> state_conflict_score;
+    /** Weight of the next recorded conflict; growing the weight decays older scores in O(1). */
+    double conflict_weight = 1;
+    /** Whether @conflict_scan_order matches the current scores. */
+    bool conflict_scan_order_current = true;
+    /** Historically conflicting states, most conflicting first (see @recordStateConflict). */
+    std::vector<uint64_t> conflict_scan_order;
+    /** Mask of the states in @conflict_scan_order. */
+    BitVector state_in_conflict_scan_order;
+    /** Bump the conflict score of a state that produced a definite inconsistency. */
+    void recordStateConflict(uint64_t state);
+    /** Advance the decay clock by one query, rescaling the scores when the weight grows large. */
+    void advanceConflictClock();
+    /** The states to scan first, most conflicting first; rebuilt after the scores changed. */
+    std::vector<uint64_t> const& conflictScanOrder();
+
+    /**
+     * Relevant states are grouped by identical valuations of the tree variables: path enabledness
+     * only depends on this valuation, so each choice selection evaluates the tree once per
+     * valuation class and copies the result to member states.
+     */
+    std::vector<uint64_t> state_to_valuation_class;
+    /** For each valuation class, its representative state. */
+    std::vector<uint64_t> valuation_class_representative;
+
     /** Add unexplored destinations of the given choice to the queue and mark them as reached. */
     void visitChoice(uint64_t choice, BitVector & state_reached, std::queue<uint64_t> & unexplored_states);
 
@@ -180,6 +336,28 @@ protected:
     void loadUnsatCore(z3::expr_vector const& unsat_core_expr, Family const& subfamily);
     void loadUnsatCore(z3::expr_vector const& unsat_core_expr, Family const& subfamily, BitVector const& choices);
 
+    /** A conflict core valid for any run on the same template (see \ref loadClauseDatabase). */
+    struct LearnedCore {
+        /** Holes restricted by the subfamily the core was learned in, with their options. */
+        std::vector<std::pair<uint64_t,std::vector<uint64_t>>> restricted_holes;
+        /** The conflicting (choice,path) colors. */
+        std::vector<std::pair<uint64_t,uint64_t>> core;
+    };
+    /** Cap on the database size; CI sweeps would otherwise grow it without bound. */
+    static const uint64_t MAX_LEARNED_CORES = 1 << 16;
+    /** Marks a file as a clause database. */
+    static const uint64_t CLAUSE_DATABASE_MAGIC = 0x73726f636c6f63ull;
+    /** Cores learned in this run plus the loaded ones, in discovery order. */
+    std::vector<LearnedCore> learned_cores;
+    /** Flattened keys of \ref learned_cores, for deduplication across runs. */
+    std::set<std::vector<uint64_t>> learned_core_keys;
+    /** Hash of the construction inputs; identifies the template a database belongs to. */
+    uint64_t template_hash;
+    /** Remember the last UNSAT core for persistence, unless known already. */
+    void recordLearnedCore(Family const& subfamily);
+    /** Assert the implication form of the stored core at the base solver level. */
+    void preassertLearnedCore(LearnedCore const& learned_core);
+
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "ColoringSmtPool.h"
+
+#include <storm/adapters/RationalNumberAdapter.h>
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/utility/macros.h>
+
+#include <atomic>
+#include <thread>
+
+namespace synthesis {
+
+template<typename ValueType>
+ColoringSmtPool<ValueType>::ColoringSmtPool(
+    uint64_t num_workers,
+    std::vector<uint64_t> const& row_groups,
+    std::vector<uint64_t> const& choice_to_action,
+    uint64_t num_actions,
+    uint64_t dont_care_action,
+    storm::storage::sparse::StateValuations const& state_valuations,
+    BitVector const& state_is_relevant,
+    std::vector<std::string> const& variable_name,
+    std::vector<std::vector<int64_t>> const& variable_domain,
+    std::vector<std::tuple<uint64_t,uint64_t,uint64_t>> const& tree_list,
+    bool enable_harmonization
+) {
+    STORM_LOG_THROW(num_workers > 0, storm::exceptions::InvalidArgumentException, "pool requires at least one worker");
+    for(uint64_t worker = 0; worker < num_workers; ++worker) {
+        workers.push_back(std::make_shared<ColoringSmt<ValueType>>(
+            row_groups,choice_to_action,num_actions,dont_care_action,state_valuations,state_is_relevant,
+            variable_name,variable_domain,tree_list,enable_harmonization
+        ));
+    }
+}
+
+template<typename ValueType>
+uint64_t ColoringSmtPool<ValueType>::numWorkers() const {
+    return workers.size();
+}
+
+template<typename ValueType>
+std::shared_ptr<ColoringSmt<ValueType>> ColoringSmtPool<ValueType>::getPrimary() {
+    return workers[0];
+}
+
+template<typename ValueType>
+std::vector<std::pair<bool,std::vector<std::vector<uint64_t>>>> ColoringSmtPool<ValueType>::areChoicesConsistentBatch(
+    std::vector<BitVector> const& choices_list, std::vector<Family> const& subfamilies
+) {
+    STORM_LOG_THROW(
+        choices_list.size() == subfamilies.size(), storm::exceptions::InvalidArgumentException,
+        "number of choice selections does not match the number of subfamilies"
+    );
+    std::vector<std::pair<bool,std::vector<std::vector<uint64_t>>>> results(choices_list.size());
+    std::atomic<uint64_t> next_query(0);
+    auto run_worker = [&](uint64_t worker) {
+        while(true) {
+            uint64_t query = next_query.fetch_add(1);
+            if(query >= choices_list.size()) {
+                break;
+            }
+            // refresh per-state path masks for this subfamily before the check
+            workers[worker]->selectCompatibleChoices(subfamilies[query]);
+            results[query] = workers[worker]->areChoicesConsistent(choices_list[query],subfamilies[query]);
+        }
+    };
+    std::vector<std::thread> threads;
+    for(uint64_t worker = 1; worker < numWorkers(); ++worker) {
+        threads.emplace_back(run_worker,worker);
+    }
+    run_worker(0);
+    for(auto& thread: threads) {
+        thread.join();
+    }
+    return results;
+}
+
+template class ColoringSmtPool<>;
+template class ColoringSmtPool<storm::RationalNumber>;
+
+}
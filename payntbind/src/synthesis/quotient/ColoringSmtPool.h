@@ -0,0 +1,57 @@
+#pragma once
+
+#include "src/synthesis/quotient/ColoringSmt.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * A pool of independent \ref ColoringSmt instances for parallel consistency checking. Z3 contexts
+ * are single-threaded, so the tree constraints are cloned into one context per worker at
+ * construction; batches of consistency queries are then dispatched across the workers, which pull
+ * queries from a shared counter so that faster workers pick up the remaining load.
+ */
+template<typename ValueType = double>
+class ColoringSmtPool {
+public:
+
+    /** Construct \p num_workers independent colorings from the given quotient description. */
+    ColoringSmtPool(
+        uint64_t num_workers,
+        std::vector<uint64_t> const& row_groups,
+        std::vector<uint64_t> const& choice_to_action,
+        uint64_t num_actions,
+        uint64_t dont_care_action,
+        storm::storage::sparse::StateValuations const& state_valuations,
+        BitVector const& state_is_relevant,
+        std::vector<std::string> const& variable_name,
+        std::vector<std::vector<int64_t>> const& variable_domain,
+        std::vector<std::tuple<uint64_t,uint64_t,uint64_t>> const& tree_list,
+        bool enable_harmonization
+    );
+
+    /** Number of workers in the pool. */
+    uint64_t numWorkers() const;
+    /** Get the primary coloring, e.g. to run choice selection on. */
+    std::shared_ptr<ColoringSmt<ValueType>> getPrimary();
+
+    /**
+     * Check consistency of a batch of (choice selection, subfamily) queries in parallel.
+     * Each worker re-runs choice selection for the query's subfamily before the check to refresh
+     * its per-state path masks.
+     * @return for each query, the result of \ref ColoringSmt::areChoicesConsistent
+     */
+    std::vector<std::pair<bool,std::vector<std::vector<uint64_t>>>> areChoicesConsistentBatch(
+        std::vector<BitVector> const& choices_list, std::vector<Family> const& subfamilies
+    );
+
+protected:
+
+    /** Per-worker colorings, each with its own Z3 context. */
+    std::vector<std::shared_ptr<ColoringSmt<ValueType>>> workers;
+};
+
+}
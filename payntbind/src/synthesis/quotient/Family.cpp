@@ -1,76 +1,113 @@
 #include "Coloring.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 
 namespace synthesis {
 
 Family::Family(Family const& other) {
-    hole_options = std::vector<std::vector<uint64_t>>(other.numHoles());
-    hole_options_mask = std::vector<BitVector>(other.numHoles());
-    for(uint64_t hole = 0; hole < numHoles(); ++hole) {
-        hole_options[hole] = other.holeOptions(hole);
-        hole_options_mask[hole] = other.holeOptionsMask(hole);
-    }
+    holes = other.holes;
+    hole_options_packed = other.hole_options_packed;
+    hole_packed_offset = other.hole_packed_offset;
+}
+
+void Family::assign(Family const& other) {
+    holes = other.holes;
+    hole_options_packed = other.hole_options_packed;
+    hole_packed_offset = other.hole_packed_offset;
 }
 
 uint64_t Family::numHoles() const {
-    return hole_options.size();
+    return holes.size();
 }
 
 uint64_t Family::addHole(uint64_t num_options) {
     uint64_t hole = numHoles();
-    hole_options_mask.push_back(BitVector(num_options,true));
-    std::vector<uint64_t> options(num_options);
+    auto hole_options = std::make_shared<HoleOptions>();
+    hole_options->mask = BitVector(num_options,true);
+    hole_options->options.resize(num_options);
     for(uint64_t option=0; option<num_options; ++option) {
-        options[option] = option;
+        hole_options->options[option] = option;
     }
-    hole_options.push_back(options);
+    holes.push_back(hole_options);
+    uint64_t num_words = (num_options+63)/64;
+    hole_packed_offset.push_back(hole_packed_offset.back()+num_words);
+    hole_options_packed.resize(hole_packed_offset.back(),0);
+    packHoleOptions(hole);
     return hole;
 }
 
+void Family::packHoleOptions(uint64_t hole) {
+    uint64_t offset = hole_packed_offset[hole];
+    std::fill(
+        hole_options_packed.begin()+offset, hole_options_packed.begin()+hole_packed_offset[hole+1], 0
+    );
+    for(uint64_t option: holes[hole]->mask) {
+        hole_options_packed[offset + option/64] |= uint64_t(1) << (option%64);
+    }
+}
+
 void Family::holeSetOptions(uint64_t hole, std::vector<uint64_t> const& options) {
-    hole_options_mask[hole].clear();
+    // detach the hole from storage shared with other families
+    auto hole_options = std::make_shared<HoleOptions>();
+    hole_options->mask = BitVector(holes[hole]->mask.size(),false);
     for(uint64_t option: options) {
-        hole_options_mask[hole].set(option);
+        hole_options->mask.set(option);
     }
-    hole_options[hole].clear();
-    for(uint64_t option: hole_options_mask[hole]) {
-        hole_options[hole].push_back(option);
+    for(uint64_t option: hole_options->mask) {
+        hole_options->options.push_back(option);
     }
+    holes[hole] = hole_options;
+    packHoleOptions(hole);
 }
 void Family::holeSetOptions(uint64_t hole, BitVector const& options) {
-    hole_options[hole].clear();
+    auto hole_options = std::make_shared<HoleOptions>();
     for(uint64_t option: options) {
-        hole_options[hole].push_back(option);
+        hole_options->options.push_back(option);
     }
-    hole_options_mask[hole] = options;
+    hole_options->mask = options;
+    holes[hole] = hole_options;
+    packHoleOptions(hole);
 }
 
 
 std::vector<uint64_t> const& Family::holeOptions(uint64_t hole) const {
-    return hole_options[hole];
+    return holes[hole]->options;
 }
 
 BitVector const& Family::holeOptionsMask(uint64_t hole) const {
-    return hole_options_mask[hole];
+    return holes[hole]->mask;
 }
 
 uint64_t Family::holeNumOptions(uint64_t hole) const {
-    return hole_options[hole].size();
+    return holes[hole]->options.size();
 }
 
 uint64_t Family::holeNumOptionsTotal(uint64_t hole) const {
-    return hole_options_mask[hole].size();
+    return holes[hole]->mask.size();
+}
+
+std::pair<double,int64_t> Family::size() const {
+    double mantissa = 1;
+    int64_t exponent = 0;
+    for(uint64_t hole = 0; hole < numHoles(); ++hole) {
+        mantissa *= holeNumOptions(hole);
+        int hole_exponent;
+        mantissa = std::frexp(mantissa,&hole_exponent);
+        exponent += hole_exponent;
+    }
+    return std::make_pair(mantissa,exponent);
 }
 
-/*uint128_t Family::size() const {
-    uint128_t size = 1;
+double Family::logSize() const {
+    double log_size = 0;
     for(uint64_t hole = 0; hole < numHoles(); ++hole) {
-        size *= holeNumOptions(hole);
+        log_size += std::log2(static_cast<double>(holeNumOptions(hole)));
     }
-    return size;
-}*/
+    return log_size;
+}
 
 bool Family::isAssignment() const {
     for(uint64_t hole = 0; hole < numHoles(); ++hole) {
@@ -82,13 +119,44 @@ bool Family::isAssignment() const {
 }
 
 bool Family::holeContains(uint64_t hole, uint64_t option) const {
-    return hole_options_mask[hole][option];
+    return (hole_options_packed[hole_packed_offset[hole] + option/64] >> (option%64)) & 1;
+}
+
+
+bool Family::isCanonical(std::vector<uint64_t> const& orbit) const {
+    for(uint64_t index = 0; index+1 < orbit.size(); ++index) {
+        if(holes[orbit[index]]->options > holes[orbit[index+1]]->options) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Family::canonicalize(std::vector<uint64_t> const& orbit) {
+    if(isCanonical(orbit)) {
+        return false;
+    }
+    std::vector<std::vector<uint64_t>> option_lists;
+    option_lists.reserve(orbit.size());
+    for(uint64_t hole: orbit) {
+        option_lists.push_back(holes[hole]->options);
+    }
+    std::sort(option_lists.begin(),option_lists.end());
+    for(uint64_t index = 0; index < orbit.size(); ++index) {
+        if(holes[orbit[index]]->options != option_lists[index]) {
+            holeSetOptions(orbit[index],option_lists[index]);
+        }
+    }
+    return true;
 }
 
 
 bool Family::isSubsetOf(Family const& other) const {
     for(uint64_t hole = 0; hole < numHoles(); ++hole) {
-        if(not hole_options_mask[hole].isSubsetOf(other.holeOptionsMask(hole))) {
+        if(holes[hole] == other.holes[hole]) {
+            continue;
+        }
+        if(not holes[hole]->mask.isSubsetOf(other.holeOptionsMask(hole))) {
             return false;
         }
     }
@@ -97,7 +165,7 @@ bool Family::isSubsetOf(Family const& other) const {
 
 bool Family::includesAssignment(std::vector<uint64_t> const& hole_to_option) const {
     for(uint64_t hole = 0; hole < numHoles(); ++hole) {
-        if(not hole_options_mask[hole][hole_to_option[hole]]) {
+        if(not holeContains(hole,hole_to_option[hole])) {
             return false;
         }
     }
@@ -106,7 +174,7 @@ bool Family::includesAssignment(std::vector<uint64_t> const& hole_to_option) con
 
 bool Family::includesAssignment(std::map<uint64_t,uint64_t> const& hole_to_option) const {
     for(auto const& [hole,option]: hole_to_option) {
-        if(not hole_options_mask[hole][option]) {
+        if(not holeContains(hole,option)) {
             return false;
         }
     }
@@ -115,19 +183,11 @@ bool Family::includesAssignment(std::map<uint64_t,uint64_t> const& hole_to_optio
 
 bool Family::includesAssignment(std::vector<std::pair<uint64_t,uint64_t>> const& hole_to_option) const {
     for(auto const& [hole,option]: hole_to_option) {
-    if(not hole_options_mask[hole][option]) {
+        if(not holeContains(hole,option)) {
             return false;
         }
     }
-    return true;   
-}
-
-std::vector<BitVector>::iterator Family::begin() {
-    return hole_options_mask.begin();
-}
-
-std::vector<BitVector>::iterator Family::end() {
-    return hole_options_mask.end();
+    return true;
 }
 
 
@@ -143,4 +203,26 @@ BitVector const& Family::getChoices() const {
     return choices;
 }
 
-}
\ No newline at end of file
+
+Family& FamilyArena::acquire(Family const& parent) {
+    if(num_acquired == slots.size()) {
+        slots.emplace_back();
+    }
+    Family& family = slots[num_acquired++];
+    family.assign(parent);
+    return family;
+}
+
+void FamilyArena::releaseAll() {
+    num_acquired = 0;
+}
+
+uint64_t FamilyArena::numAcquired() const {
+    return num_acquired;
+}
+
+uint64_t FamilyArena::numSlots() const {
+    return slots.size();
+}
+
+}
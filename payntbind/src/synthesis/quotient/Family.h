@@ -5,18 +5,26 @@
 #include <cstdint>
 #include <vector>
 #include <map>
+#include <deque>
+#include <memory>
 
 namespace synthesis {
 
 using BitVector = storm::storage::BitVector;
-// typedef unsigned __int128 uint128_t;
 
 class Family {
 public:
-    
+
     Family() {};
     Family(Family const& other);
 
+    /**
+     * Make this family a copy of \p other, reusing previously allocated hole storage. In contrast
+     * to the copy constructor, no fresh heap allocations are made when this family already held at
+     * least as many options per hole.
+     */
+    void assign(Family const& other);
+
     uint64_t numHoles() const;
     uint64_t addHole(uint64_t num_options);
 
@@ -29,19 +37,34 @@ public:
 
     uint64_t holeNumOptions(uint64_t hole) const;
     uint64_t holeNumOptionsTotal(uint64_t hole) const;
-    // uint128_t size() const;
+    /**
+     * Number of family members as a normalized (mantissa,exponent) pair with mantissa in [0.5,1)
+     * and the value being mantissa*2^exponent. Exact integer arithmetic overflows 64 bits already
+     * for modest families, while this form ranks families of any size.
+     */
+    std::pair<double,int64_t> size() const;
+    /** Base-2 logarithm of the number of family members (-inf for an empty family). */
+    double logSize() const;
     bool isAssignment() const;
 
     bool holeContains(uint64_t hole, uint64_t option) const;
     bool isSubsetOf(Family const& other) const;
+    /**
+     * Check whether the family is canonical with respect to an orbit of interchangeable holes:
+     * the option lists of the orbit's holes are lexicographically non-decreasing. Exactly one
+     * arrangement of each symmetric equivalence class is canonical, so a refinement loop can
+     * discard subfamilies for which this returns false (see \ref Coloring::symmetricHoleOrbits).
+     */
+    bool isCanonical(std::vector<uint64_t> const& orbit) const;
+    /**
+     * Rearrange the option lists of the orbit's holes into the canonical order.
+     * @return true if the family changed
+     */
+    bool canonicalize(std::vector<uint64_t> const& orbit);
     bool includesAssignment(std::vector<uint64_t> const& hole_to_option) const;
     bool includesAssignment(std::map<uint64_t,uint64_t> const& hole_to_option) const;
     bool includesAssignment(std::vector<std::pair<uint64_t,uint64_t>> const& hole_to_option) const;
 
-    // iterator over hole options
-    std::vector<BitVector>::iterator begin();
-    std::vector<BitVector>::iterator end();
-
     // choice operations
     void setChoices(BitVector const& choices);
     void setChoices(BitVector&& choices);
@@ -49,10 +72,33 @@ public:
 
 protected:
 
-    /** For each hole, a list of available options. */
-    std::vector<std::vector<uint64_t>> hole_options;
-    /** For each hole, a mastk of available options. */
-    std::vector<BitVector> hole_options_mask;
+    /** Option list and mask of a single hole. Immutable once created and shared between families. */
+    struct HoleOptions {
+        /** List of available options. */
+        std::vector<uint64_t> options;
+        /** Mask of available options. */
+        BitVector mask;
+    };
+
+    /**
+     * For each hole, its (possibly shared) options. Copying a family shares all entries with the
+     * original; \ref holeSetOptions detaches the affected hole by installing a fresh entry, so a
+     * refinement tree stores each unchanged hole only once.
+     */
+    std::vector<std::shared_ptr<HoleOptions const>> holes;
+
+    /**
+     * All hole masks packed into one contiguous word array, with the mask of hole h occupying
+     * words [hole_packed_offset[h],hole_packed_offset[h+1]). Option tests on the packed storage
+     * are resolved with plain word operations, which keeps the per-choice compatibility loops in
+     * \ref Coloring free of per-bit BitVector queries and lets the compiler vectorize them.
+     */
+    std::vector<uint64_t> hole_options_packed;
+    /** Word offset of each hole's mask in \ref hole_options_packed (plus one past-the-end entry). */
+    std::vector<uint64_t> hole_packed_offset = {0};
+
+    /** Rewrite the packed words of the given hole from its current option mask. */
+    void packHoleOptions(uint64_t hole);
 
     /** Whether choices have been set for this family. */
     bool choices_set = false;
@@ -60,4 +106,35 @@ protected:
     BitVector choices;
 };
 
-}
\ No newline at end of file
+
+/**
+ * Bump allocator for subfamilies created during refinement. Families are acquired one by one,
+ * each initialized as a copy of a given parent, and retired wholesale via \ref releaseAll when
+ * the corresponding subtree of the refinement tree is discarded. Retired slots keep their hole
+ * storage and are recycled by subsequent acquisitions, so a steady-state refinement loop makes
+ * no heap allocations at all.
+ */
+class FamilyArena {
+public:
+
+    FamilyArena() {};
+
+    /** Acquire a family initialized as a copy of \p parent. The reference is valid until \ref releaseAll. */
+    Family& acquire(Family const& parent);
+    /** Retire all acquired families at once, keeping their storage for reuse. */
+    void releaseAll();
+
+    /** Number of families currently acquired. */
+    uint64_t numAcquired() const;
+    /** Number of family slots held by the arena, including retired ones. */
+    uint64_t numSlots() const;
+
+protected:
+
+    /** Family slots, live ones first. */
+    std::deque<Family> slots;
+    /** Number of slots currently acquired. */
+    uint64_t num_acquired = 0;
+};
+
+}
@@ -0,0 +1,237 @@
+#include "FamilyQueue.h"
+
+#include <storm/exceptions/InvalidOperationException.h>
+#include <storm/utility/macros.h>
+
+namespace synthesis {
+
+FamilyQueue::FamilyQueue(bool maximizing) : maximizing(maximizing) {}
+
+bool FamilyQueue::better(double challenger, double incumbent) const {
+    return maximizing ? challenger > incumbent : challenger < incumbent;
+}
+
+uint64_t FamilyQueue::acquireSlot(double bound) {
+    uint64_t handle;
+    if(not free_slots.empty()) {
+        handle = free_slots.back();
+        free_slots.pop_back();
+        slot_bound[handle] = bound;
+    } else {
+        handle = slots.size();
+        slots.emplace_back();
+        slot_bound.push_back(bound);
+        slot_delta.emplace_back();
+        slot_pending_children.push_back(0);
+        slot_release_deferred.push_back(false);
+    }
+    return handle;
+}
+
+uint64_t FamilyQueue::storeFamily(Family const& family, double bound) {
+    uint64_t handle = acquireSlot(bound);
+    slots[handle].assign(family);
+    return handle;
+}
+
+uint64_t FamilyQueue::storeDelta(uint64_t parent, uint64_t hole, std::vector<uint64_t> const& options, double bound) {
+    uint64_t handle = acquireSlot(bound);
+    slot_delta[handle].pending = true;
+    slot_delta[handle].parent = parent;
+    slot_delta[handle].hole = hole;
+    slot_delta[handle].options = options;
+    ++slot_pending_children[parent];
+    return handle;
+}
+
+void FamilyQueue::materialize(uint64_t handle) {
+    if(not slot_delta[handle].pending) {
+        return;
+    }
+    slot_delta[handle].pending = false;
+    uint64_t parent = slot_delta[handle].parent;
+    // the parent may itself be an untouched child of an earlier split
+    materialize(parent);
+    slots[handle].assign(slots[parent]);
+    slots[handle].holeSetOptions(slot_delta[handle].hole,slot_delta[handle].options);
+    slot_delta[handle].options.clear();
+    unpinParent(parent);
+}
+
+void FamilyQueue::unpinParent(uint64_t parent) {
+    if(--slot_pending_children[parent] == 0 and slot_release_deferred[parent]) {
+        slot_release_deferred[parent] = false;
+        free_slots.push_back(parent);
+    }
+}
+
+void FamilyQueue::siftUp(uint64_t position) {
+    Entry entry = heap[position];
+    while(position > 0) {
+        uint64_t parent = (position-1)/ARITY;
+        if(not better(entry.bound,heap[parent].bound)) {
+            break;
+        }
+        heap[position] = heap[parent];
+        position = parent;
+    }
+    heap[position] = entry;
+}
+
+void FamilyQueue::siftDown(uint64_t position) {
+    Entry entry = heap[position];
+    while(true) {
+        uint64_t first_child = position*ARITY+1;
+        if(first_child >= heap.size()) {
+            break;
+        }
+        uint64_t best_child = first_child;
+        uint64_t last_child = std::min<uint64_t>(first_child+ARITY,heap.size());
+        for(uint64_t child = first_child+1; child < last_child; ++child) {
+            if(better(heap[child].bound,heap[best_child].bound)) {
+                best_child = child;
+            }
+        }
+        if(not better(heap[best_child].bound,entry.bound)) {
+            break;
+        }
+        heap[position] = heap[best_child];
+        position = best_child;
+    }
+    heap[position] = entry;
+}
+
+uint64_t FamilyQueue::push(Family const& family, double bound) {
+    uint64_t handle = storeFamily(family,bound);
+    heap.push_back({bound,handle});
+    siftUp(heap.size()-1);
+    return handle;
+}
+
+std::vector<uint64_t> FamilyQueue::pushSplit(std::vector<Family> const& families, double bound) {
+    std::vector<uint64_t> handles;
+    handles.reserve(families.size());
+    // the buffer takes the batch only if the bound keeps its back the best entry of the queue
+    bool buffered = (split_buffer.empty() or not better(split_buffer.back().bound,bound))
+        and (heap.empty() or not better(heap.front().bound,bound));
+    for(auto const& family: families) {
+        uint64_t handle = storeFamily(family,bound);
+        if(buffered) {
+            split_buffer.push_back({bound,handle});
+        } else {
+            heap.push_back({bound,handle});
+            siftUp(heap.size()-1);
+        }
+        handles.push_back(handle);
+    }
+    return handles;
+}
+
+uint64_t FamilyQueue::pop() {
+    STORM_LOG_THROW(not empty(), storm::exceptions::InvalidOperationException, "popping an empty family queue");
+    if(not split_buffer.empty() and (heap.empty() or not better(heap.front().bound,split_buffer.back().bound))) {
+        uint64_t handle = split_buffer.back().handle;
+        split_buffer.pop_back();
+        return handle;
+    }
+    uint64_t handle = heap.front().handle;
+    heap.front() = heap.back();
+    heap.pop_back();
+    if(not heap.empty()) {
+        siftDown(0);
+    }
+    return handle;
+}
+
+double FamilyQueue::topBound() const {
+    STORM_LOG_THROW(not empty(), storm::exceptions::InvalidOperationException, "inspecting an empty family queue");
+    if(heap.empty()) {
+        return split_buffer.back().bound;
+    }
+    if(split_buffer.empty()) {
+        return heap.front().bound;
+    }
+    return better(heap.front().bound,split_buffer.back().bound) ? heap.front().bound : split_buffer.back().bound;
+}
+
+std::vector<uint64_t> FamilyQueue::splitFamily(uint64_t parent_handle, uint64_t hole, std::vector<std::vector<uint64_t>> const& partition) {
+    double bound = slot_bound[parent_handle];
+    std::vector<uint64_t> handles;
+    handles.reserve(partition.size());
+    // the buffer takes the batch only if the bound keeps its back the best entry of the queue
+    bool buffered = (split_buffer.empty() or not better(split_buffer.back().bound,bound))
+        and (heap.empty() or not better(heap.front().bound,bound));
+    for(auto const& options: partition) {
+        uint64_t handle = storeDelta(parent_handle,hole,options,bound);
+        if(buffered) {
+            split_buffer.push_back({bound,handle});
+        } else {
+            heap.push_back({bound,handle});
+            siftUp(heap.size()-1);
+        }
+        handles.push_back(handle);
+    }
+    return handles;
+}
+
+Family const& FamilyQueue::family(uint64_t handle) {
+    materialize(handle);
+    return slots[handle];
+}
+
+double FamilyQueue::bound(uint64_t handle) const {
+    return slot_bound[handle];
+}
+
+void FamilyQueue::release(uint64_t handle) {
+    if(slot_delta[handle].pending) {
+        slot_delta[handle].pending = false;
+        slot_delta[handle].options.clear();
+        unpinParent(slot_delta[handle].parent);
+    }
+    if(slot_pending_children[handle] > 0) {
+        // pending children still read this slot upon materialization; recycle it with the last of them
+        slot_release_deferred[handle] = true;
+        return;
+    }
+    free_slots.push_back(handle);
+}
+
+bool FamilyQueue::isMaximizing() const {
+    return maximizing;
+}
+
+std::vector<std::pair<double,uint64_t>> FamilyQueue::enqueuedEntries() const {
+    std::vector<std::pair<double,uint64_t>> entries;
+    entries.reserve(size());
+    for(auto const& entry: heap) {
+        entries.emplace_back(entry.bound,entry.handle);
+    }
+    for(auto const& entry: split_buffer) {
+        entries.emplace_back(entry.bound,entry.handle);
+    }
+    return entries;
+}
+
+uint64_t FamilyQueue::size() const {
+    return heap.size() + split_buffer.size();
+}
+
+bool FamilyQueue::empty() const {
+    return heap.empty() and split_buffer.empty();
+}
+
+void FamilyQueue::clear() {
+    heap.clear();
+    split_buffer.clear();
+    free_slots.clear();
+    for(uint64_t handle = 0; handle < slots.size(); ++handle) {
+        slot_delta[handle].pending = false;
+        slot_delta[handle].options.clear();
+        slot_pending_children[handle] = 0;
+        slot_release_deferred[handle] = false;
+        free_slots.push_back(handle);
+    }
+}
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Family.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Best-first queue of families keyed by their value bounds. Families are stored in recycled
+ * slots and travel through the queue as plain integer handles, so an enqueued family costs a
+ * handle plus whatever its copy-on-write holes do not share with the parent. The ordering
+ * structure is a 4-ary heap; subfamilies produced by a split are batch-pushed under the bound
+ * of their just-popped parent, which appends them in constant time instead of sifting each
+ * one through the heap.
+ */
+class FamilyQueue {
+public:
+
+    /** A queue popping the family with the largest (\p maximizing) or smallest bound first. */
+    FamilyQueue(bool maximizing);
+
+    /** Enqueue a copy of \p family under the given bound and return its handle. */
+    uint64_t push(Family const& family, double bound);
+    /**
+     * Enqueue copies of all \p families under a common bound, typically the bound of the
+     * parent they were split from. If the bound is at least as good as everything already
+     * enqueued, which holds whenever the parent was the last family popped, each subfamily
+     * is appended in constant time.
+     */
+    std::vector<uint64_t> pushSplit(std::vector<Family> const& families, double bound);
+
+    /**
+     * Split the family behind \p parent_handle on one hole and enqueue the children under the
+     * parent's bound, without materializing them: each child slot records only the parent
+     * handle, the split hole and its option share, and the actual family - a copy-on-write
+     * copy of the parent with one hole replaced - is built on the child's first access via
+     * \ref family. Children that are pruned and released unmaterialized never cost more than
+     * the handle; the parent slot is pinned until its last pending child materializes or is
+     * released, so releasing the parent right after the split is safe.
+     * @param parent_handle handle of the family to split, typically the last popped one
+     * @param hole the hole to split on
+     * @param partition for each child, its share of the hole's options
+     * @return the handles of the children, in partition order
+     */
+    std::vector<uint64_t> splitFamily(uint64_t parent_handle, uint64_t hole, std::vector<std::vector<uint64_t>> const& partition);
+
+    /** Dequeue and return the handle of the best family; ties are broken LIFO. */
+    uint64_t pop();
+    /** Bound of the family that \ref pop would return next. */
+    double topBound() const;
+
+    /**
+     * The family behind the given handle, materializing it first if it is a pending split
+     * delta. The reference is valid until \ref release.
+     */
+    Family const& family(uint64_t handle);
+    /** The bound the given handle was enqueued under. */
+    double bound(uint64_t handle) const;
+    /** Retire a popped handle, recycling its slot for subsequent pushes. */
+    void release(uint64_t handle);
+
+    /** Whether larger bounds are better. */
+    bool isMaximizing() const;
+    /** Bounds and handles of all enqueued families, in no particular order. */
+    std::vector<std::pair<double,uint64_t>> enqueuedEntries() const;
+
+    /** Number of enqueued families. */
+    uint64_t size() const;
+    bool empty() const;
+    /** Retire all handles, enqueued or popped, keeping their storage for reuse. */
+    void clear();
+
+protected:
+
+    /** Heap arity; 4 keeps the tree shallow while parent lookups stay a shift. */
+    static const uint64_t ARITY = 4;
+
+    /** One enqueued family: its ordering key and its slot handle. */
+    struct Entry {
+        double bound;
+        uint64_t handle;
+    };
+
+    /** Whether \p challenger is strictly better than \p incumbent under the queue direction. */
+    bool better(double challenger, double incumbent) const;
+    /** Store a copy of \p family in a recycled (or fresh) slot and return its handle. */
+    uint64_t storeFamily(Family const& family, double bound);
+    /** Store a pending split delta in a recycled (or fresh) slot and return its handle. */
+    uint64_t storeDelta(uint64_t parent, uint64_t hole, std::vector<uint64_t> const& options, double bound);
+    /** Acquire a slot, recycled or fresh (side tables grown along), without filling it. */
+    uint64_t acquireSlot(double bound);
+    /** Build the family of a pending delta slot from its (materialized) parent. */
+    void materialize(uint64_t handle);
+    /** Drop one pending-child pin of the parent, recycling its slot if its release was deferred. */
+    void unpinParent(uint64_t parent);
+    void siftUp(uint64_t position);
+    void siftDown(uint64_t position);
+
+    /** Whether larger bounds are better. */
+    bool maximizing;
+
+    /** A not-yet-materialized child of a split (see \ref splitFamily). */
+    struct SplitDelta {
+        /** Whether the slot still awaits materialization. */
+        bool pending = false;
+        /** Handle of the parent family. */
+        uint64_t parent;
+        /** The split hole. */
+        uint64_t hole;
+        /** The child's share of the hole's options. */
+        std::vector<uint64_t> options;
+    };
+
+    /** Family slots addressed by handle. */
+    std::deque<Family> slots;
+    /** Bound under which each slot was enqueued. */
+    std::vector<double> slot_bound;
+    /** Pending split delta of each slot, if any. */
+    std::vector<SplitDelta> slot_delta;
+    /** Number of pending children pinning each slot. */
+    std::vector<uint64_t> slot_pending_children;
+    /** Slots whose release was deferred because pending children still pin them. */
+    std::vector<bool> slot_release_deferred;
+    /** Handles of retired slots awaiting reuse. */
+    std::vector<uint64_t> free_slots;
+
+    /** 4-ary heap of enqueued entries. */
+    std::vector<Entry> heap;
+    /**
+     * Entries appended by \ref pushSplit whose bound is at least as good as the rest of the
+     * queue, kept outside the heap and popped LIFO before it. Bounds are non-decreasing in
+     * goodness towards the back, so the back is always the best entry of the buffer.
+     */
+    std::vector<Entry> split_buffer;
+};
+
+}
@@ -0,0 +1,216 @@
+#include "FamilyTransport.h"
+
+#include <storm/exceptions/InvalidOperationException.h>
+#include <storm/utility/macros.h>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <limits>
+
+namespace synthesis {
+
+    /** Message tag announcing pool shutdown instead of a family. */
+    const uint64_t SHUTDOWN_TAG = std::numeric_limits<uint64_t>::max();
+
+    static void sendAll(int fd, void const* data, uint64_t num_bytes) {
+        char const* bytes = static_cast<char const*>(data);
+        while(num_bytes > 0) {
+            ssize_t sent = ::send(fd,bytes,num_bytes,0);
+            STORM_LOG_THROW(sent > 0, storm::exceptions::InvalidOperationException, "sending to a pool peer failed");
+            bytes += sent;
+            num_bytes -= sent;
+        }
+    }
+
+    static void recvAll(int fd, void* data, uint64_t num_bytes) {
+        char* bytes = static_cast<char*>(data);
+        while(num_bytes > 0) {
+            ssize_t received = ::recv(fd,bytes,num_bytes,0);
+            STORM_LOG_THROW(received > 0, storm::exceptions::InvalidOperationException, "a pool peer closed the connection");
+            bytes += received;
+            num_bytes -= received;
+        }
+    }
+
+    static void sendWord(int fd, uint64_t word) {
+        sendAll(fd,&word,sizeof(word));
+    }
+
+    static uint64_t recvWord(int fd) {
+        uint64_t word;
+        recvAll(fd,&word,sizeof(word));
+        return word;
+    }
+
+
+    FamilyCoordinator::FamilyCoordinator(uint16_t port) {
+        this->listen_fd = ::socket(AF_INET,SOCK_STREAM,0);
+        STORM_LOG_THROW(this->listen_fd >= 0, storm::exceptions::InvalidOperationException, "creating the pool socket failed");
+        int reuse = 1;
+        ::setsockopt(this->listen_fd,SOL_SOCKET,SO_REUSEADDR,&reuse,sizeof(reuse));
+        sockaddr_in address;
+        std::memset(&address,0,sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        STORM_LOG_THROW(
+            ::bind(this->listen_fd,reinterpret_cast<sockaddr*>(&address),sizeof(address)) == 0 and ::listen(this->listen_fd,SOMAXCONN) == 0,
+            storm::exceptions::InvalidOperationException, "binding the pool port failed"
+        );
+    }
+
+    FamilyCoordinator::~FamilyCoordinator() {
+        for(int fd: this->worker_fds) {
+            if(fd >= 0) {
+                ::close(fd);
+            }
+        }
+        if(this->listen_fd >= 0) {
+            ::close(this->listen_fd);
+        }
+    }
+
+    void FamilyCoordinator::acceptWorkers(uint64_t num_workers) {
+        while(this->worker_fds.size() < num_workers) {
+            int fd = ::accept(this->listen_fd,nullptr,nullptr);
+            STORM_LOG_THROW(fd >= 0, storm::exceptions::InvalidOperationException, "accepting a worker failed");
+            // family deltas are tiny, so latency dominates over throughput
+            int no_delay = 1;
+            ::setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&no_delay,sizeof(no_delay));
+            this->worker_fds.push_back(fd);
+            this->worker_last_options.emplace_back();
+        }
+    }
+
+    uint64_t FamilyCoordinator::numWorkers() const {
+        return this->worker_fds.size();
+    }
+
+    void FamilyCoordinator::sendFamily(uint64_t worker, uint64_t tag, Family const& family) {
+        int fd = this->worker_fds[worker];
+        auto& last_options = this->worker_last_options[worker];
+        last_options.resize(family.numHoles());
+        // collect the holes whose option lists differ from the last family this worker saw;
+        // along a refinement tree this is typically a single hole
+        std::vector<uint64_t> changed_holes;
+        for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+            if(family.holeOptions(hole) != last_options[hole]) {
+                changed_holes.push_back(hole);
+            }
+        }
+        sendWord(fd,tag);
+        sendWord(fd,changed_holes.size());
+        for(uint64_t hole: changed_holes) {
+            auto const& options = family.holeOptions(hole);
+            sendWord(fd,hole);
+            sendWord(fd,options.size());
+            sendAll(fd,options.data(),options.size()*sizeof(uint64_t));
+            last_options[hole] = options;
+        }
+    }
+
+    std::tuple<uint64_t,uint64_t,double> FamilyCoordinator::receiveResult() {
+        std::vector<pollfd> poll_fds(this->worker_fds.size());
+        for(uint64_t worker = 0; worker < this->worker_fds.size(); ++worker) {
+            poll_fds[worker].fd = this->worker_fds[worker];
+            poll_fds[worker].events = POLLIN;
+        }
+        while(true) {
+            int num_ready = ::poll(poll_fds.data(),poll_fds.size(),-1);
+            STORM_LOG_THROW(num_ready > 0, storm::exceptions::InvalidOperationException, "polling the worker pool failed");
+            for(uint64_t worker = 0; worker < poll_fds.size(); ++worker) {
+                if(not (poll_fds[worker].revents & POLLIN)) {
+                    continue;
+                }
+                uint64_t tag = recvWord(this->worker_fds[worker]);
+                double value;
+                recvAll(this->worker_fds[worker],&value,sizeof(value));
+                return std::make_tuple(worker,tag,value);
+            }
+        }
+    }
+
+    void FamilyCoordinator::shutdown() {
+        for(int fd: this->worker_fds) {
+            sendWord(fd,SHUTDOWN_TAG);
+            ::close(fd);
+        }
+        this->worker_fds.clear();
+        this->worker_last_options.clear();
+    }
+
+
+    FamilyWorker::FamilyWorker(std::string const& host, uint16_t port) {
+        addrinfo hints;
+        std::memset(&hints,0,sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses;
+        STORM_LOG_THROW(
+            ::getaddrinfo(host.c_str(),std::to_string(port).c_str(),&hints,&addresses) == 0,
+            storm::exceptions::InvalidOperationException, "resolving the coordinator host failed"
+        );
+        for(addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+            int fd = ::socket(address->ai_family,address->ai_socktype,address->ai_protocol);
+            if(fd < 0) {
+                continue;
+            }
+            if(::connect(fd,address->ai_addr,address->ai_addrlen) == 0) {
+                this->fd = fd;
+                break;
+            }
+            ::close(fd);
+        }
+        ::freeaddrinfo(addresses);
+        STORM_LOG_THROW(this->fd >= 0, storm::exceptions::InvalidOperationException, "connecting to the coordinator failed");
+        int no_delay = 1;
+        ::setsockopt(this->fd,IPPROTO_TCP,TCP_NODELAY,&no_delay,sizeof(no_delay));
+    }
+
+    FamilyWorker::~FamilyWorker() {
+        if(this->fd >= 0) {
+            ::close(this->fd);
+        }
+    }
+
+    void FamilyWorker::setFamilyTemplate(Family const& family) {
+        this->current_family = family;
+    }
+
+    bool FamilyWorker::receiveFamily() {
+        uint64_t tag = recvWord(this->fd);
+        if(tag == SHUTDOWN_TAG) {
+            return false;
+        }
+        this->last_tag = tag;
+        uint64_t num_changed = recvWord(this->fd);
+        for(uint64_t index = 0; index < num_changed; ++index) {
+            uint64_t hole = recvWord(this->fd);
+            std::vector<uint64_t> options(recvWord(this->fd));
+            recvAll(this->fd,options.data(),options.size()*sizeof(uint64_t));
+            this->current_family.holeSetOptions(hole,options);
+        }
+        return true;
+    }
+
+    Family const& FamilyWorker::family() const {
+        return this->current_family;
+    }
+
+    uint64_t FamilyWorker::lastTag() const {
+        return this->last_tag;
+    }
+
+    void FamilyWorker::sendResult(uint64_t tag, double value) {
+        sendWord(this->fd,tag);
+        sendAll(this->fd,&value,sizeof(value));
+    }
+
+}
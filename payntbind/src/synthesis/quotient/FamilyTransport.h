@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Family.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace synthesis {
+
+    /**
+     * Coordinator side of distributed family exploration. Listens on a TCP port, accepts a
+     * pool of workers and shards families to them; a family travels as a delta against the
+     * last family sent to that worker (only holes whose option lists changed are encoded), so
+     * the payload of a refinement step is a handful of integers while every worker holds the
+     * shared quotient locally (see \ref shareModel). Results come back as (tag,value) pairs.
+     * The wire format uses host byte order, assuming a homogeneous pool.
+     */
+    class FamilyCoordinator {
+    public:
+
+        /** Listen on the given port. */
+        FamilyCoordinator(uint16_t port);
+        ~FamilyCoordinator();
+
+        /** Block until the given number of workers has connected. */
+        void acceptWorkers(uint64_t num_workers);
+        /** Number of connected workers. */
+        uint64_t numWorkers() const;
+
+        /**
+         * Send a family to a worker, encoded as a delta against the last family sent to it.
+         * @param tag an identifier echoed back with the result, typically the queue handle
+         */
+        void sendFamily(uint64_t worker, uint64_t tag, Family const& family);
+        /**
+         * Block until any worker reports a result.
+         * @return the worker, the tag of its family and the computed value
+         */
+        std::tuple<uint64_t,uint64_t,double> receiveResult();
+        /** Tell all workers to shut down and close their connections. */
+        void shutdown();
+
+    protected:
+
+        /** Listening socket. */
+        int listen_fd = -1;
+        /** One socket per connected worker. */
+        std::vector<int> worker_fds;
+        /** For each worker, the hole options of the last family sent to it. */
+        std::vector<std::vector<std::vector<uint64_t>>> worker_last_options;
+    };
+
+    /**
+     * Worker side of distributed family exploration: connects to a \ref FamilyCoordinator,
+     * receives family deltas applied onto a local family template and reports result values.
+     * The evaluation itself stays with the caller, which checks \ref family against its local
+     * copy of the quotient between \ref receiveFamily and \ref sendResult.
+     */
+    class FamilyWorker {
+    public:
+
+        /** Connect to the coordinator. */
+        FamilyWorker(std::string const& host, uint16_t port);
+        ~FamilyWorker();
+
+        /**
+         * Install the full family the deltas refine, typically the design space of the
+         * sketch; must match the first family the coordinator shards.
+         */
+        void setFamilyTemplate(Family const& family);
+        /**
+         * Block until the coordinator sends a family or shuts the pool down.
+         * @return false on shutdown
+         */
+        bool receiveFamily();
+        /** The family of the last \ref receiveFamily. */
+        Family const& family() const;
+        /** The tag of the last \ref receiveFamily. */
+        uint64_t lastTag() const;
+        /** Report the value computed for the family with the given tag. */
+        void sendResult(uint64_t tag, double value);
+
+    protected:
+
+        /** Socket to the coordinator. */
+        int fd = -1;
+        /** The family the received deltas are applied onto. */
+        Family current_family;
+        /** Tag of the last received family. */
+        uint64_t last_tag = 0;
+    };
+
+}
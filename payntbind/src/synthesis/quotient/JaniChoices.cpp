@@ -6,6 +6,8 @@
 #include <storm/storage/sparse/JaniChoiceOrigins.h>
 #include <storm/storage/sparse/ModelComponents.h>
 
+#include <map>
+
 namespace synthesis {
     
     template<typename ValueType>
@@ -16,20 +18,32 @@ namespace synthesis {
         auto const& co = model.getChoiceOrigins()->asJaniChoiceOrigins();
         auto const& jani = co.getModel();
 
-        storm::models::sparse::ChoiceLabeling choice_labeling(num_choices);
-        for (auto const& action : jani.getActions()) {
-            choice_labeling.addLabel(action.getName(), storm::storage::BitVector(num_choices,false));
-        }
-        
+        // intern the edge-to-action resolution and collect for each action the bit vector of
+        // its choices, so that each edge is decoded once and each action name is resolved
+        // exactly once instead of per (choice,edge) pair
+        std::map<uint64_t,uint64_t> edge_to_action_index;
+        std::map<uint64_t,storm::storage::BitVector> action_index_to_choices;
         for(uint64_t choice = 0; choice < num_choices; choice++) {
             for(auto const& aut_edge: co.getEdgeIndexSet(choice)) {
-                auto [aut_index,edge_index] = jani.decodeAutomatonAndEdgeIndices(aut_edge);
-                auto action_index = jani.getAutomaton(aut_index).getEdge(edge_index).getActionIndex();
-                choice_labeling.addLabelToChoice(jani.getAction(action_index).getName(), choice);
+                auto action_it = edge_to_action_index.find(aut_edge);
+                if(action_it == edge_to_action_index.end()) {
+                    auto [aut_index,edge_index] = jani.decodeAutomatonAndEdgeIndices(aut_edge);
+                    uint64_t action_index = jani.getAutomaton(aut_index).getEdge(edge_index).getActionIndex();
+                    action_it = edge_to_action_index.emplace(aut_edge,action_index).first;
+                }
+                auto choices_it = action_index_to_choices.find(action_it->second);
+                if(choices_it == action_index_to_choices.end()) {
+                    choices_it = action_index_to_choices.emplace(action_it->second,storm::storage::BitVector(num_choices,false)).first;
+                }
+                choices_it->second.set(choice,true);
             }
         }
 
-        removeUnusedLabels(choice_labeling);
+        // only used actions were collected, so no unused labels have to be removed afterwards
+        storm::models::sparse::ChoiceLabeling choice_labeling(num_choices);
+        for(auto const& [action_index,choices]: action_index_to_choices) {
+            choice_labeling.addLabel(jani.getAction(action_index).getName(), choices);
+        }
         return choice_labeling;
     }
 
@@ -0,0 +1,335 @@
+#include "ParallelQuotientBuilder.h"
+
+#include <storm/generator/CompressedState.h>
+#include <storm/generator/JaniNextStateGenerator.h>
+#include <storm/models/sparse/StandardRewardModel.h>
+#include <storm/storage/sparse/JaniChoiceOrigins.h>
+#include <storm/storage/sparse/ModelComponents.h>
+#include <storm/storage/sparse/StateStorage.h>
+
+#include <boost/any.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+namespace synthesis {
+
+    // number of buckets of the concurrent state index; a discovered state locks only its
+    // bucket, so workers contend only when their discoveries hash-collide
+    const uint64_t STATE_INDEX_SHARDS = 64;
+    // number of frontier states a worker claims per queue access
+    const uint64_t EXPLORATION_BATCH = 64;
+
+    template<typename ValueType>
+    QuotientBuildResult<ValueType> buildQuotientParallel(
+        storm::jani::Model const& program,
+        std::map<uint64_t,std::vector<std::pair<uint64_t,uint64_t>>> const& edge_to_hole_assignment,
+        uint64_t num_holes,
+        uint64_t num_workers
+    ) {
+        typedef uint32_t StateType;
+        typedef storm::generator::CompressedState CompressedState;
+
+        if(num_workers == 0) {
+            num_workers = std::max(std::thread::hardware_concurrency(),1u);
+        }
+        storm::generator::NextStateGeneratorOptions options;
+        options.setBuildAllRewardModels(true);
+        options.setBuildChoiceLabels(true);
+        options.setBuildChoiceOrigins(true);
+
+        // sharded concurrent state index: ids come from a shared counter, so they are dense
+        // but reflect discovery order rather than a breadth-first order
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<CompressedState,StateType> state_to_id;
+        };
+        std::vector<Shard> shards(STATE_INDEX_SHARDS);
+        std::atomic<StateType> next_state_id(0);
+        std::hash<storm::storage::BitVector> state_hash;
+
+        // the shared frontier of discovered-but-unexplored states; pending counts frontier
+        // states plus states currently being expanded, so an empty frontier with zero pending
+        // states means the reachable fragment is exhausted
+        std::deque<std::pair<StateType,CompressedState>> frontier;
+        std::mutex frontier_mutex;
+        std::atomic<uint64_t> pending(0);
+
+        // everything a worker learns about a state, kept in worker-local storage and stitched
+        // into the matrix and the choice-indexed tables only after the workers join
+        struct ExploredState {
+            StateType id;
+            CompressedState state;
+            bool deadlock = false;
+            std::vector<ValueType> state_rewards;
+            /** For each row, its (column,value) entries. */
+            std::vector<std::vector<std::pair<StateType,ValueType>>> rows;
+            /** For each row, its state-action rewards. */
+            std::vector<std::vector<ValueType>> row_rewards;
+            /** For each row, its action labels. */
+            std::vector<std::set<std::string>> row_labels;
+            /** For each row, the hole assignments of its edges and whether they are conflict-free. */
+            std::vector<std::vector<std::pair<uint64_t,uint64_t>>> row_assignment;
+            std::vector<bool> row_valid;
+        };
+        std::vector<std::vector<ExploredState>> worker_explored(num_workers);
+
+        auto registerState = [&](CompressedState const& state, std::vector<std::pair<StateType,CompressedState>>& discovered) {
+            Shard& shard = shards[state_hash(state) % STATE_INDEX_SHARDS];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.state_to_id.find(state);
+            if(it != shard.state_to_id.end()) {
+                return it->second;
+            }
+            StateType id = next_state_id++;
+            shard.state_to_id.emplace(state,id);
+            discovered.emplace_back(id,state);
+            return id;
+        };
+
+        // seed the frontier with the initial states
+        std::vector<StateType> initial_state_ids;
+        uint64_t state_size;
+        uint64_t num_reward_models;
+        {
+            storm::generator::JaniNextStateGenerator<ValueType,StateType> generator(program,options);
+            state_size = generator.getStateSize();
+            num_reward_models = generator.getNumberOfRewardModels();
+            std::vector<std::pair<StateType,CompressedState>> discovered;
+            initial_state_ids = generator.getInitialStates([&](CompressedState const& state) {
+                return registerState(state,discovered);
+            });
+            pending += discovered.size();
+            for(auto& id_state: discovered) {
+                frontier.push_back(std::move(id_state));
+            }
+        }
+
+        auto exploreWorker = [&](uint64_t worker) {
+            // each worker drives its own generator over the shared program
+            storm::generator::JaniNextStateGenerator<ValueType,StateType> generator(program,options);
+            std::vector<ExploredState>& explored = worker_explored[worker];
+            std::vector<std::pair<StateType,CompressedState>> work;
+            std::vector<std::pair<StateType,CompressedState>> discovered;
+            std::vector<bool> hole_set(num_holes,false);
+            std::vector<uint64_t> hole_option(num_holes);
+            auto callback = [&](CompressedState const& state) {
+                return registerState(state,discovered);
+            };
+            while(true) {
+                work.clear();
+                {
+                    std::lock_guard<std::mutex> lock(frontier_mutex);
+                    while(not frontier.empty() and work.size() < EXPLORATION_BATCH) {
+                        work.push_back(std::move(frontier.front()));
+                        frontier.pop_front();
+                    }
+                }
+                if(work.empty()) {
+                    if(pending.load() == 0) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                    continue;
+                }
+                for(auto& [id,state]: work) {
+                    generator.load(state);
+                    storm::generator::StateBehavior<ValueType,StateType> behavior = generator.expand(callback);
+                    ExploredState entry;
+                    entry.id = id;
+                    entry.state = std::move(state);
+                    entry.state_rewards = behavior.getStateRewards();
+                    if(behavior.getChoices().empty()) {
+                        // deadlock: fixed up with a self-loop, like the sequential builder does
+                        entry.deadlock = true;
+                        entry.rows.push_back({std::make_pair(id,storm::utility::one<ValueType>())});
+                        entry.row_rewards.emplace_back();
+                        entry.row_labels.emplace_back();
+                        entry.row_assignment.emplace_back();
+                        entry.row_valid.push_back(true);
+                    }
+                    for(auto const& choice: behavior.getChoices()) {
+                        std::vector<std::pair<StateType,ValueType>> row;
+                        for(auto const& destination: choice) {
+                            row.emplace_back(destination.first,destination.second);
+                        }
+                        // ids reflect discovery order, so the row has to be sorted by column
+                        std::sort(row.begin(),row.end(),
+                            [](std::pair<StateType,ValueType> const& a, std::pair<StateType,ValueType> const& b) { return a.first < b.first; });
+                        entry.rows.push_back(std::move(row));
+                        entry.row_rewards.push_back(choice.getRewards());
+                        entry.row_labels.push_back(choice.hasLabels() ? choice.getLabels() : std::set<std::string>());
+                        // resolve the hole assignments of the originating edges right away; a
+                        // conflict (two edges fixing one hole differently) invalidates the choice
+                        std::fill(hole_set.begin(),hole_set.end(),false);
+                        bool valid_choice = true;
+                        for(uint64_t edge: boost::any_cast<storm::storage::sparse::JaniChoiceOrigins::EdgeIndexSet const&>(choice.getOriginData())) {
+                            auto edge_assignment = edge_to_hole_assignment.find(edge);
+                            if(edge_assignment == edge_to_hole_assignment.end()) {
+                                continue;
+                            }
+                            for(auto const& [hole,option]: edge_assignment->second) {
+                                if(not hole_set[hole]) {
+                                    hole_set[hole] = true;
+                                    hole_option[hole] = option;
+                                } else if(hole_option[hole] != option) {
+                                    valid_choice = false;
+                                    break;
+                                }
+                            }
+                            if(not valid_choice) {
+                                break;
+                            }
+                        }
+                        std::vector<std::pair<uint64_t,uint64_t>> assignment;
+                        if(valid_choice) {
+                            for(uint64_t hole = 0; hole < num_holes; ++hole) {
+                                if(hole_set[hole]) {
+                                    assignment.emplace_back(hole,hole_option[hole]);
+                                }
+                            }
+                        }
+                        entry.row_assignment.push_back(std::move(assignment));
+                        entry.row_valid.push_back(valid_choice);
+                    }
+                    explored.push_back(std::move(entry));
+                }
+                // publish discoveries before retiring the processed states, so pending can
+                // only reach zero once every discovered state has been expanded
+                pending += discovered.size();
+                if(not discovered.empty()) {
+                    std::lock_guard<std::mutex> lock(frontier_mutex);
+                    for(auto& id_state: discovered) {
+                        frontier.push_back(std::move(id_state));
+                    }
+                    discovered.clear();
+                }
+                pending -= work.size();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for(uint64_t worker = 1; worker < num_workers; ++worker) {
+            threads.emplace_back(exploreWorker,worker);
+        }
+        exploreWorker(0);
+        for(auto& thread: threads) {
+            thread.join();
+        }
+
+        // deferred row assembly: the workers explored disjoint state sets, so the rows are
+        // scattered by state id and written out in one ordered pass with exact preallocation
+        uint64_t num_states = next_state_id.load();
+        std::vector<ExploredState const*> state_info(num_states,nullptr);
+        uint64_t num_choices = 0;
+        uint64_t num_entries = 0;
+        for(auto const& explored: worker_explored) {
+            for(auto const& entry: explored) {
+                state_info[entry.id] = &entry;
+                num_choices += entry.rows.size();
+                for(auto const& row: entry.rows) {
+                    num_entries += row.size();
+                }
+            }
+        }
+
+        storm::storage::SparseMatrixBuilder<ValueType> builder(num_choices,num_states,num_entries,true,true,num_states);
+        storm::storage::BitVector choice_is_valid(num_choices,true);
+        std::vector<std::vector<std::pair<uint64_t,uint64_t>>> choice_to_hole_assignment(num_choices);
+        storm::models::sparse::ChoiceLabeling choice_labeling(num_choices);
+        std::vector<StateType> deadlock_state_ids;
+        uint64_t choice = 0;
+        for(uint64_t state = 0; state < num_states; ++state) {
+            ExploredState const* entry = state_info[state];
+            STORM_LOG_ASSERT(entry != nullptr, "state was discovered but never explored");
+            builder.newRowGroup(choice);
+            if(entry->deadlock) {
+                deadlock_state_ids.push_back(state);
+            }
+            for(uint64_t row = 0; row < entry->rows.size(); ++row) {
+                for(auto const& [column,value]: entry->rows[row]) {
+                    builder.addNextValue(choice,column,value);
+                }
+                choice_is_valid.set(choice,entry->row_valid[row]);
+                choice_to_hole_assignment[choice] = entry->row_assignment[row];
+                for(std::string const& label: entry->row_labels[row]) {
+                    if(not choice_labeling.containsLabel(label)) {
+                        choice_labeling.addLabel(label);
+                    }
+                    choice_labeling.addLabelToChoice(label,choice);
+                }
+                ++choice;
+            }
+        }
+
+        storm::storage::sparse::ModelComponents<ValueType> components;
+        components.transitionMatrix = builder.build();
+        components.choiceLabeling = std::move(choice_labeling);
+
+        storm::generator::JaniNextStateGenerator<ValueType,StateType> generator(program,options);
+        // the generator reports state rewards and row rewards separately, each aligned with
+        // the reward models carrying that reward kind; deadlock self-loops keep zero rewards
+        uint64_t state_slot = 0;
+        uint64_t action_slot = 0;
+        for(uint64_t reward_model = 0; reward_model < num_reward_models; ++reward_model) {
+            auto const& info = generator.getRewardModelInformation(reward_model);
+            std::optional<std::vector<ValueType>> state_rewards;
+            std::optional<std::vector<ValueType>> action_rewards;
+            if(info.hasStateRewards()) {
+                std::vector<ValueType> rewards(num_states,storm::utility::zero<ValueType>());
+                for(uint64_t state = 0; state < num_states; ++state) {
+                    auto const& values = state_info[state]->state_rewards;
+                    if(state_slot < values.size()) {
+                        rewards[state] = values[state_slot];
+                    }
+                }
+                state_rewards = std::move(rewards);
+                ++state_slot;
+            }
+            if(info.hasStateActionRewards()) {
+                std::vector<ValueType> rewards(num_choices,storm::utility::zero<ValueType>());
+                uint64_t reward_choice = 0;
+                for(uint64_t state = 0; state < num_states; ++state) {
+                    for(auto const& row_reward: state_info[state]->row_rewards) {
+                        if(action_slot < row_reward.size()) {
+                            rewards[reward_choice] = row_reward[action_slot];
+                        }
+                        ++reward_choice;
+                    }
+                }
+                action_rewards = std::move(rewards);
+                ++action_slot;
+            }
+            components.rewardModels.emplace(info.getName(),
+                storm::models::sparse::StandardRewardModel<ValueType>(std::move(state_rewards),std::move(action_rewards)));
+        }
+
+        // the state labeling is evaluated on the collected compressed states through the
+        // generator, the same way the sequential builder labels after its exploration
+        storm::storage::sparse::StateStorage<StateType> state_storage(state_size);
+        for(uint64_t state = 0; state < num_states; ++state) {
+            state_storage.stateToId.findOrAdd(state_info[state]->state,state);
+        }
+        state_storage.initialStateIndices = initial_state_ids;
+        components.stateLabeling = generator.label(state_storage,initial_state_ids,deadlock_state_ids);
+
+        QuotientBuildResult<ValueType> result;
+        result.quotient = std::make_shared<storm::models::sparse::Mdp<ValueType>>(std::move(components));
+        result.choice_is_valid = std::move(choice_is_valid);
+        result.choice_to_hole_assignment = std::move(choice_to_hole_assignment);
+        return result;
+    }
+
+    template QuotientBuildResult<double> buildQuotientParallel<double>(
+        storm::jani::Model const& program,
+        std::map<uint64_t,std::vector<std::pair<uint64_t,uint64_t>>> const& edge_to_hole_assignment,
+        uint64_t num_holes,
+        uint64_t num_workers
+    );
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <storm/models/sparse/Mdp.h>
+#include <storm/storage/BitVector.h>
+#include <storm/storage/jani/Model.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace synthesis {
+
+    /** Result of \ref buildQuotientParallel. */
+    template<typename ValueType>
+    struct QuotientBuildResult {
+        /** The quotient MDP of the hole-annotated program. */
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> quotient;
+        /** Choices whose edges carry non-conflicting hole assignments. */
+        storm::storage::BitVector choice_is_valid;
+        /** For each choice, its hole assignments, ready for \ref Coloring. */
+        std::vector<std::vector<std::pair<uint64_t,uint64_t>>> choice_to_hole_assignment;
+    };
+
+    /**
+     * Build the quotient MDP of a hole-annotated (unfolded) JANI program by parallel
+     * explicit-state exploration: the frontier is partitioned across workers, each driving its
+     * own next-state generator, with discovered states deduplicated through a sharded
+     * concurrent index and the matrix rows assembled after the workers join, in state-id
+     * order. The hole assignments of each choice are resolved from its edge origins during
+     * expansion, so the model and the coloring input of \ref Coloring come out of one pass
+     * instead of building the model first and recovering the colors from choice origins
+     * after. Choices whose edges carry conflicting hole assignments are reported rather than
+     * removed, mirroring the post-hoc recovery.
+     * @param program the unfolded JANI program
+     * @param edge_to_hole_assignment for (the encoded index of) an unfolded edge, its hole assignments
+     * @param num_holes the number of holes of the family
+     * @param num_workers the number of exploring threads (0 picks the hardware concurrency)
+     */
+    template<typename ValueType>
+    QuotientBuildResult<ValueType> buildQuotientParallel(
+        storm::jani::Model const& program,
+        std::map<uint64_t,std::vector<std::pair<uint64_t,uint64_t>>> const& edge_to_hole_assignment,
+        uint64_t num_holes,
+        uint64_t num_workers
+    );
+
+}
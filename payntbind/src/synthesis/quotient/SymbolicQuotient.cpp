@@ -0,0 +1,139 @@
+#include "SymbolicQuotient.h"
+
+#include <storm/builder/DdJaniModelBuilder.h>
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/storage/dd/Add.h>
+#include <storm/storage/dd/DdManager.h>
+#include <storm/storage/expressions/ExpressionManager.h>
+#include <storm/storage/jani/Variable.h>
+#include <storm/utility/constants.h>
+
+#include <algorithm>
+
+namespace synthesis {
+
+    template<storm::dd::DdType DdType>
+    SymbolicQuotient<DdType>::SymbolicQuotient(
+        storm::jani::Model const& program,
+        std::vector<std::string> const& hole_names,
+        std::vector<std::vector<int64_t>> const& hole_option_values
+    ) : hole_names(hole_names), hole_option_values(hole_option_values) {
+        STORM_LOG_THROW(hole_names.size() == hole_option_values.size(), storm::exceptions::InvalidArgumentException,
+            "expected one option-value list per hole");
+        storm::jani::Model model = program;
+        auto& expression_manager = model.getManager();
+
+        // freeze each hole into a state variable: the constant's expression variable is reused,
+        // so every guard and assignment mentioning the hole now reads the variable instead; the
+        // variable is never written, so its initial value persists along every path
+        storm::expressions::Expression initial_restriction;
+        for(uint64_t hole = 0; hole < hole_names.size(); ++hole) {
+            auto const& values = this->hole_option_values[hole];
+            STORM_LOG_THROW(not values.empty(), storm::exceptions::InvalidArgumentException, "hole has no options");
+            auto variable = model.getConstant(hole_names[hole]).getExpressionVariable();
+            model.removeConstant(hole_names[hole]);
+            int64_t lower = *std::min_element(values.begin(),values.end());
+            int64_t upper = *std::max_element(values.begin(),values.end());
+            model.addVariable(*storm::jani::Variable::makeBoundedIntegerVariable(
+                hole_names[hole], variable, boost::none, false,
+                expression_manager.integer(lower), expression_manager.integer(upper)));
+            // seed the variable with any of the hole's option values (the range may have gaps)
+            storm::expressions::Expression hole_initial;
+            for(auto value: values) {
+                auto option = variable.getExpression() == expression_manager.integer(value);
+                hole_initial = hole_initial.isInitialized() ? hole_initial or option : option;
+            }
+            initial_restriction = initial_restriction.isInitialized() ? initial_restriction and hole_initial : hole_initial;
+        }
+        if(model.hasInitialStatesRestriction()) {
+            initial_restriction = model.getInitialStatesRestriction() and initial_restriction;
+        }
+        model.setInitialStatesRestriction(initial_restriction);
+        model = model.substituteConstantsFunctions();
+
+        storm::builder::DdJaniModelBuilder<DdType,double> builder;
+        this->model = builder.build(model)->template as<storm::models::symbolic::Mdp<DdType,double>>();
+    }
+
+    template<storm::dd::DdType DdType>
+    uint64_t SymbolicQuotient<DdType>::numStates() const {
+        return this->model->getNumberOfStates();
+    }
+
+    template<storm::dd::DdType DdType>
+    uint64_t SymbolicQuotient<DdType>::numTransitionNodes() const {
+        return this->model->getTransitionMatrix().getNodeCount();
+    }
+
+    template<storm::dd::DdType DdType>
+    storm::dd::Bdd<DdType> SymbolicQuotient<DdType>::familyRestriction(
+        std::vector<std::vector<int64_t>> const& hole_options
+    ) const {
+        STORM_LOG_THROW(hole_options.size() == this->hole_names.size(), storm::exceptions::InvalidArgumentException,
+            "expected one option selection per hole");
+        auto const& manager = this->model->getManager();
+        auto restriction = manager.getBddOne();
+        for(uint64_t hole = 0; hole < this->hole_names.size(); ++hole) {
+            auto variable = manager.getMetaVariable(this->hole_names[hole]);
+            auto hole_restriction = manager.getBddZero();
+            for(auto value: hole_options[hole]) {
+                hole_restriction |= manager.getEncoding(variable, value);
+            }
+            restriction &= hole_restriction;
+        }
+        return restriction;
+    }
+
+    template<storm::dd::DdType DdType>
+    std::pair<double,bool> SymbolicQuotient<DdType>::computeFamilyBound(
+        std::string const& target_label,
+        bool minimize,
+        std::vector<std::vector<int64_t>> const& hole_options,
+        double precision,
+        uint64_t max_iterations
+    ) {
+        auto const& manager = this->model->getManager();
+        auto target = this->model->getStates(target_label);
+        auto restriction = familyRestriction(hole_options);
+        // the hole variables never change, so restricting the source rows restricts the
+        // subfamily's entire diagram
+        auto transitions = this->model->getTransitionMatrix() * restriction.template toAdd<double>();
+        auto illegal_mask = this->model->getIllegalMask();
+
+        auto values = target.template toAdd<double>();
+        bool converged = false;
+        for(uint64_t iteration = 0; iteration < max_iterations; ++iteration) {
+            auto next = transitions.multiplyMatrix(
+                values.swapVariables(this->model->getRowColumnMetaVariablePairs()), this->model->getColumnVariables());
+            if(minimize) {
+                // illegal choice encodings carry value zero and must not win the minimum
+                next = illegal_mask.ite(manager.getConstant(storm::utility::infinity<double>()), next);
+                next = next.minAbstract(this->model->getNondeterminismVariables());
+            } else {
+                next = next.maxAbstract(this->model->getNondeterminismVariables());
+            }
+            next = target.ite(manager.template getAddOne<double>(), next);
+            if(values.equalModuloPrecision(next, precision, false)) {
+                values = next;
+                converged = true;
+                break;
+            }
+            values = next;
+        }
+
+        // the bound over the subfamily's initial states bounds every member
+        auto initial = this->model->getInitialStates() && restriction;
+        double bound;
+        if(minimize) {
+            bound = initial.ite(values, manager.getConstant(storm::utility::infinity<double>())).getMin();
+        } else {
+            bound = initial.ite(values, manager.template getAddZero<double>()).getMax();
+        }
+        return std::make_pair(bound, converged);
+    }
+
+
+    template class SymbolicQuotient<storm::dd::DdType::CUDD>;
+    template class SymbolicQuotient<storm::dd::DdType::Sylvan>;
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <storm/models/symbolic/Mdp.h>
+#include <storm/storage/dd/Bdd.h>
+#include <storm/storage/dd/DdType.h>
+#include <storm/storage/jani/Model.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace synthesis {
+
+    /**
+     * Decision-diagram-backed family abstraction. The family is folded into the model
+     * all-in-one style: every hole becomes a frozen state variable of the JANI program - its
+     * value is fixed by the initial state and never assigned - so one symbolic (MTBDD) build
+     * of the program yields the quotients of all family members at once, with the structure
+     * shared across members that the explicit unfolding would duplicate. A (sub)family is then
+     * a BDD cube over the hole variables: selecting its compatible choices is a restriction of
+     * the transition MTBDD, and its bound is computed by symbolic value iteration over the
+     * restricted diagram. Sketches whose explicit quotient does not fit in memory stay
+     * tractable as long as their diagrams do.
+     */
+    template<storm::dd::DdType DdType>
+    class SymbolicQuotient {
+    public:
+
+        /**
+         * Build the symbolic quotient of the sketch. Each hole must appear in the program as
+         * an undefined integer constant; the constant is turned into a frozen global variable
+         * ranging over the hole's option values before the symbolic build.
+         * @param program the sketch with one undefined constant per hole
+         * @param hole_names for each hole, the name of its constant
+         * @param hole_option_values for each hole, the constant values of its options
+         */
+        SymbolicQuotient(
+            storm::jani::Model const& program,
+            std::vector<std::string> const& hole_names,
+            std::vector<std::vector<int64_t>> const& hole_option_values
+        );
+
+        /** Number of reachable states across all family members. */
+        uint64_t numStates() const;
+        /** Number of nodes of the transition diagram, the actual memory footprint. */
+        uint64_t numTransitionNodes() const;
+
+        /**
+         * Compute the bound of a subfamily on a reachability probability by symbolic value
+         * iteration: the restriction of each hole to the selected options is conjoined into a
+         * BDD over the hole variables, the transition diagram is restricted to it and iterated
+         * until the values change by less than the precision or the iteration cap is hit. The
+         * bound is taken over the initial states of the subfamily - the minimum over the
+         * members when minimizing, the maximum when maximizing - so it bounds every member.
+         * @param target_label label of the target states
+         * @param minimize whether the family minimizes the reachability probability
+         * @param hole_options for each hole, the selected option values of the subfamily
+         * @return the bound and whether the iteration converged within the cap
+         */
+        std::pair<double,bool> computeFamilyBound(
+            std::string const& target_label,
+            bool minimize,
+            std::vector<std::vector<int64_t>> const& hole_options,
+            double precision,
+            uint64_t max_iterations
+        );
+
+    protected:
+
+        /** The restriction of the hole variables to the given option values, as a BDD. */
+        storm::dd::Bdd<DdType> familyRestriction(std::vector<std::vector<int64_t>> const& hole_options) const;
+
+        /** For each hole, the name of its (former) constant, now a frozen variable. */
+        std::vector<std::string> hole_names;
+        /** For each hole, the constant values of its options. */
+        std::vector<std::vector<int64_t>> hole_option_values;
+        /** The all-in-one symbolic MDP. */
+        std::shared_ptr<storm::models::symbolic::Mdp<DdType,double>> model;
+    };
+
+}
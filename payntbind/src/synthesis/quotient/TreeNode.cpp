@@ -8,12 +8,12 @@ namespace synthesis {
 
 
 TreeNode::Hole::Hole(bool is_interval_type, z3::context& ctx)
-: is_interval_type(is_interval_type), solver_variable(ctx), solver_variable_harm(ctx), restriction(ctx) {
+: is_interval_type(is_interval_type), solver_variable(ctx), solver_variable_harm(ctx) {
     // left intentionally blank
 }
 
 TreeNode::Hole::Hole(bool is_interval_type, z3::context& ctx, uint64_t depth)
-: is_interval_type(is_interval_type), solver_variable(ctx), solver_variable_harm(ctx), restriction(ctx), depth(depth) {
+: is_interval_type(is_interval_type), solver_variable(ctx), solver_variable_harm(ctx), depth(depth) {
     // left intentionally blank
 }
 
@@ -21,7 +21,6 @@ void TreeNode::Hole::createSolverVariable() {
     solver_variable = solver_variable.ctx().int_const(name.c_str());
     solver_string_domain = "h_" + std::to_string(hole);
     solver_string_domain_harm = "z_" + std::to_string(hole);
-    solver_string_restriction = "r_" + std::to_string(hole);
 
     name_harm = name + "_h";
     solver_variable_harm = solver_variable.ctx().int_const(name_harm.c_str());
@@ -57,11 +56,6 @@ z3::expr TreeNode::Hole::domainEncoding(Family const& subfamily, bool harmonizin
 void TreeNode::Hole::addDomainEncoding(Family const& subfamily, z3::solver& solver) const {
     solver.add(domainEncoding(subfamily, false), solver_string_domain.c_str());
     solver.add(domainEncoding(subfamily, true), solver_string_domain_harm.c_str());
-
-    /*if(is_interval_type) {
-        std::cout << solver_string_restriction.c_str() << " : " << restriction << std::endl;
-        solver.add(restriction, solver_string_restriction.c_str());    
-    }*/
 }
 
 bool TreeNode::verifyExpression(z3::solver & solver, z3::expr const& expr) {
@@ -187,6 +181,10 @@ void TerminalNode::addFamilyEncoding(Family const& subfamily, z3::solver& solver
     action_hole.addDomainEncoding(subfamily,solver);
 }
 
+void TerminalNode::collectFamilyEncoding(Family const& subfamily, z3::expr_vector & encoding) const {
+    encoding.push_back(action_hole.domainEncoding(subfamily,false));
+}
+
 void TerminalNode::loadHoleAssignmentFromModel(z3::model const& model, std::vector<std::vector<uint64_t>> & hole_options) const {
     hole_options[action_hole.hole].push_back(action_hole.getModelValue(model));
 }
@@ -254,38 +252,40 @@ void InnerNode::createHoles(Family& family) {
         variable_hole.push_back(hole);
     }
 
+    // store the bound structure only; it is identical for every variable of this node, and
+    // concrete restriction expressions are materialized on demand, so no solver memory is
+    // held for restrictions that are never asserted
     InnerNode *node = this;
     InnerNode *node_parent = std::dynamic_pointer_cast<InnerNode>(node->parent).get();
-    std::vector<InnerNode *> lower_bounds;
-    std::vector<InnerNode *> upper_bounds;
     while(node_parent != NULL) {
         if(node->isTrueChild()) {
-            upper_bounds.push_back(node_parent);
+            restriction_upper_bounds.push_back(node_parent);
         } else {
-            lower_bounds.push_back(node_parent);
+            restriction_lower_bounds.push_back(node_parent);
         }
         node = node_parent;
         node_parent = std::dynamic_pointer_cast<InnerNode>(node->parent).get();
     }
-    for(uint64_t variable = 0; variable < numVariables(); ++variable) {
-        // Vi=v => (V_lb=v => Xlb <= Xi) and (V_ub=v => Xi <= Xub)
-        z3::expr lhs = decision_hole.solver_variable != ctx.int_val(variable);
-        z3::expr_vector rhs(ctx);
-        z3::expr const& var_node = variable_hole[variable].solver_variable;
-        for(InnerNode *bound: lower_bounds) {
-            z3::expr const& var_bound = bound->variable_hole[variable].solver_variable;
-            rhs.push_back(bound->decision_hole.solver_variable != ctx.int_val(variable) or var_bound <= var_node);
-        }
-        for(InnerNode *bound: upper_bounds) {
-            z3::expr const& var_bound = bound->variable_hole[variable].solver_variable;
-            rhs.push_back(bound->decision_hole.solver_variable != ctx.int_val(variable) or var_node <= var_bound);
-        }
-        variable_hole[variable].restriction = lhs or z3::mk_and(rhs);
-    }
     child_true->createHoles(family);
     child_false->createHoles(family);
 }
 
+z3::expr InnerNode::buildVariableRestriction(uint64_t variable) const {
+    // Vi=v => (V_lb=v => Xlb <= Xi) and (V_ub=v => Xi <= Xub)
+    z3::expr lhs = decision_hole.solver_variable != ctx.int_val(variable);
+    z3::expr_vector rhs(ctx);
+    z3::expr const& var_node = variable_hole[variable].solver_variable;
+    for(InnerNode *bound: restriction_lower_bounds) {
+        z3::expr const& var_bound = bound->variable_hole[variable].solver_variable;
+        rhs.push_back(bound->decision_hole.solver_variable != ctx.int_val(variable) or var_bound <= var_node);
+    }
+    for(InnerNode *bound: restriction_upper_bounds) {
+        z3::expr const& var_bound = bound->variable_hole[variable].solver_variable;
+        rhs.push_back(bound->decision_hole.solver_variable != ctx.int_val(variable) or var_node <= var_bound);
+    }
+    return lhs or z3::mk_and(rhs);
+}
+
 void InnerNode::loadHoleInfo(std::vector<std::tuple<uint64_t,std::string,std::string>> & hole_info) const {
     hole_info[decision_hole.hole] = std::make_tuple(identifier,decision_hole.name,"__decision__");
     for(uint64_t variable = 0; variable < numVariables(); ++variable) {
@@ -447,6 +447,15 @@ void InnerNode::addFamilyEncoding(Family const& subfamily, z3::solver& solver) c
     child_false->addFamilyEncoding(subfamily,solver);
 }
 
+void InnerNode::collectFamilyEncoding(Family const& subfamily, z3::expr_vector & encoding) const {
+    encoding.push_back(decision_hole.domainEncoding(subfamily,false));
+    for(Hole const& hole: variable_hole) {
+        encoding.push_back(hole.domainEncoding(subfamily,false));
+    }
+    child_true->collectFamilyEncoding(subfamily,encoding);
+    child_false->collectFamilyEncoding(subfamily,encoding);
+}
+
 bool InnerNode::isPathEnabledInState(
     std::vector<bool> const& path, Family const& subfamily, std::vector<uint64_t> const& state_valuation
 ) const {
@@ -38,9 +38,6 @@ public:
         z3::expr solver_variable_harm;
         std::string solver_string_domain_harm;
 
-        z3::expr restriction;
-        std::string solver_string_restriction;
-
         uint64_t depth;
 
         Hole(bool is_interval_type, z3::context& ctx);
@@ -139,6 +136,8 @@ public:
 
     /** Add encoding of hole option in the given family. */
     virtual void addFamilyEncoding(Family const& subfamily, z3::solver & solver) const {}
+    /** Collect the domain encodings of all holes as expressions, without asserting them. */
+    virtual void collectFamilyEncoding(Family const& subfamily, z3::expr_vector & encoding) const {}
     /** Check whether the path is enabled in the given state for the given subfamily. */
     virtual bool isPathEnabledInState(
         std::vector<bool> const& path,
@@ -194,6 +193,7 @@ public:
     void clearCache() override;
 
     void addFamilyEncoding(Family const& subfamily, z3::solver & solver) const override;
+    void collectFamilyEncoding(Family const& subfamily, z3::expr_vector & encoding) const override;
     bool isPathEnabledInState(
         std::vector<bool> const& path,
         Family const& subfamily,
@@ -223,6 +223,15 @@ public:
     Hole decision_hole;
     std::vector<Hole> variable_hole;
 
+    /**
+     * Ancestors whose variable holes bound this node's variable holes from below resp. above
+     * in the canonicity restriction. The bound structure is the same for every variable of
+     * the node (only the plugged solver variables differ), so it is stored once per node and
+     * a concrete restriction is materialized on demand via \ref buildVariableRestriction.
+     */
+    std::vector<InnerNode *> restriction_lower_bounds;
+    std::vector<InnerNode *> restriction_upper_bounds;
+
     z3::expr_vector clauses;
 
     // Auxiliary variables to be reused during initalization for memory efficiency.
@@ -248,6 +257,8 @@ public:
     const TerminalNode *getTerminal(std::vector<bool> const& path) const override;
 
     void createHoles(Family& family) override;
+    /** Materialize the canonicity restriction of the given variable hole from the stored bounds. */
+    z3::expr buildVariableRestriction(uint64_t variable) const;
     void loadHoleInfo(std::vector<std::tuple<uint64_t,std::string,std::string>> & hole_info) const override;
     void createPaths(z3::expr const& harmonizing_variable) override;
     uint64_t getPathActionHole(std::vector<bool> const& path);
@@ -263,6 +274,7 @@ public:
     void clearCache() override;
 
     void addFamilyEncoding(Family const& subfamily, z3::solver & solver) const override;
+    void collectFamilyEncoding(Family const& subfamily, z3::expr_vector & encoding) const override;
     bool isPathEnabledInState(
         std::vector<bool> const& path,
         Family const& subfamily,
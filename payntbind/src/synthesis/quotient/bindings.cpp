@@ -1,9 +1,18 @@
 #include "../synthesis.h"
 
+#include <pybind11/numpy.h>
+
 #include "JaniChoices.h"
+#include "ParallelQuotientBuilder.h"
+#include "ColoredBisimulation.h"
+#include "SymbolicQuotient.h"
+#include "FamilyTransport.h"
 #include "Family.h"
+#include "AssignmentEnumerator.h"
+#include "FamilyQueue.h"
 #include "Coloring.h"
 #include "ColoringSmt.h"
+#include "ColoringSmtPool.h"
 #include "src/synthesis/translation/componentTranslations.h"
 
 #include <storm/storage/expressions/ExpressionManager.h>
@@ -224,6 +233,38 @@ std::map<uint64_t,double> computeInconsistentHoleVariance(
     return reachable_choices;
 }*/
 
+/**
+ * For each pair of the given families, check the subset relation.
+ * @return a matrix M with M[i][j] iff families[i] is a subset of families[j]
+ */
+std::vector<storm::storage::BitVector> familySubsetMatrix(std::vector<Family> const& families) {
+    uint64_t num_families = families.size();
+    std::vector<storm::storage::BitVector> matrix(num_families);
+    for(uint64_t index = 0; index < num_families; ++index) {
+        matrix[index] = storm::storage::BitVector(num_families,false);
+        for(uint64_t other = 0; other < num_families; ++other) {
+            if(families[index].isSubsetOf(families[other])) {
+                matrix[index].set(other,true);
+            }
+        }
+    }
+    return matrix;
+}
+
+/** For each of the given assignments, check whether it is included in the family. */
+storm::storage::BitVector familyIncludesAssignments(
+    Family const& family,
+    std::vector<std::vector<std::pair<uint64_t,uint64_t>>> const& assignments
+) {
+    storm::storage::BitVector included(assignments.size(),false);
+    for(uint64_t index = 0; index < assignments.size(); ++index) {
+        if(family.includesAssignment(assignments[index])) {
+            included.set(index,true);
+        }
+    }
+    return included;
+}
+
 // RA: I don't even understand why this needs to be optimized, but it does
 storm::storage::BitVector policyToChoicesForFamily(
     std::vector<uint64_t> const& policy_choices,
@@ -287,16 +328,65 @@ storm::storage::BitVector policyToChoicesForFamily(
 
 void bindings_coloring(py::module& m) {
 
-    m.def("addStateValuations", &synthesis::addStateValuations<double>);
-    m.def("janiMapChoicesToHoleAssignments", &synthesis::janiMapChoicesToHoleAssignments<double>);
-    m.def("addChoiceLabelsFromJani", &synthesis::addChoiceLabelsFromJani<double>);
+    m.def("addStateValuations", &synthesis::addStateValuations<double>, py::call_guard<py::gil_scoped_release>());
+    m.def("janiMapChoicesToHoleAssignments", &synthesis::janiMapChoicesToHoleAssignments<double>, py::call_guard<py::gil_scoped_release>());
+    m.def(
+        "buildQuotientParallel",
+        [](
+            storm::jani::Model const& program,
+            std::map<uint64_t,std::vector<std::pair<uint64_t,uint64_t>>> const& edge_to_hole_assignment,
+            uint64_t num_holes, uint64_t num_workers
+        ) {
+            auto result = synthesis::buildQuotientParallel<double>(program,edge_to_hole_assignment,num_holes,num_workers);
+            return std::make_tuple(result.quotient,result.choice_is_valid,result.choice_to_hole_assignment);
+        },
+        py::arg("program"), py::arg("edge_to_hole_assignment"), py::arg("num_holes"), py::arg("num_workers") = 0,
+        py::call_guard<py::gil_scoped_release>(),
+        "build the quotient MDP and its choice-to-assignment coloring input in one parallel exploration pass"
+    );
+
+    py::class_<synthesis::ColoredBisimulation<double>>(m, "ColoredBisimulation")
+        .def(
+            py::init<
+                storm::models::sparse::Model<double> const&,
+                std::vector<std::vector<std::pair<uint64_t,uint64_t>>> const&
+            >(),
+            py::arg("quotient"), py::arg("choice_to_assignment"),
+            py::call_guard<py::gil_scoped_release>(),
+            "coloring-preserving bisimulation quotient of the quotient MDP"
+        )
+        .def_readonly("reduced", &synthesis::ColoredBisimulation<double>::reduced)
+        .def_readonly("reduced_choice_to_assignment", &synthesis::ColoredBisimulation<double>::reduced_choice_to_assignment)
+        .def_readonly("state_to_class", &synthesis::ColoredBisimulation<double>::state_to_class)
+        .def_readonly("class_to_state", &synthesis::ColoredBisimulation<double>::class_to_state)
+        .def_readonly("reduced_choice_to_choice", &synthesis::ColoredBisimulation<double>::reduced_choice_to_choice)
+        ;
+    py::class_<synthesis::SymbolicQuotient<storm::dd::DdType::Sylvan>>(m, "SymbolicQuotient",
+        "All-in-one MTBDD quotient of a sketch: holes become frozen state variables, subfamilies become "
+        "BDD restrictions and family bounds are computed by symbolic value iteration.")
+        .def(
+            py::init<storm::jani::Model const&, std::vector<std::string> const&, std::vector<std::vector<int64_t>> const&>(),
+            py::arg("program"), py::arg("hole_names"), py::arg("hole_option_values"),
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def_property_readonly("num_states", &synthesis::SymbolicQuotient<storm::dd::DdType::Sylvan>::numStates)
+        .def_property_readonly("num_transition_nodes", &synthesis::SymbolicQuotient<storm::dd::DdType::Sylvan>::numTransitionNodes)
+        .def("compute_family_bound", &synthesis::SymbolicQuotient<storm::dd::DdType::Sylvan>::computeFamilyBound,
+            py::arg("target_label"), py::arg("minimize"), py::arg("hole_options"), py::arg("precision"), py::arg("max_iterations"),
+            py::call_guard<py::gil_scoped_release>(),
+            "reachability bound of the subfamily by symbolic value iteration, returns the bound and whether it converged")
+        ;
+
+    m.def("addChoiceLabelsFromJani", &synthesis::addChoiceLabelsFromJani<double>, py::call_guard<py::gil_scoped_release>());
 
-    m.def("schedulerToStateToGlobalChoice", &synthesis::schedulerToStateToGlobalChoice<double>);
-    m.def("schedulerToStateToGlobalChoiceExact", &synthesis::schedulerToStateToGlobalChoice<storm::RationalNumber>);
+    m.def("schedulerToStateToGlobalChoice", &synthesis::schedulerToStateToGlobalChoice<double>, py::call_guard<py::gil_scoped_release>());
+    m.def("schedulerToStateToGlobalChoiceExact", &synthesis::schedulerToStateToGlobalChoice<storm::RationalNumber>, py::call_guard<py::gil_scoped_release>());
 
-    m.def("computeInconsistentHoleVariance", &synthesis::computeInconsistentHoleVariance);
+    m.def("computeInconsistentHoleVariance", &synthesis::computeInconsistentHoleVariance, py::call_guard<py::gil_scoped_release>());
 
-    m.def("policyToChoicesForFamily", &synthesis::policyToChoicesForFamily);
+    m.def("policyToChoicesForFamily", &synthesis::policyToChoicesForFamily, py::call_guard<py::gil_scoped_release>());
+    m.def("familySubsetMatrix", &synthesis::familySubsetMatrix, py::call_guard<py::gil_scoped_release>());
+    m.def("familyIncludesAssignments", &synthesis::familyIncludesAssignments);
 
     py::class_<synthesis::Family>(m, "Family")
         .def(py::init<>())
@@ -308,9 +398,72 @@ void bindings_coloring(py::module& m) {
         .def("holeOptionsMask", &synthesis::Family::holeOptionsMask)
         .def("holeSetOptions", py::overload_cast<uint64_t, std::vector<uint64_t> const&>(&synthesis::Family::holeSetOptions))
         .def("holeSetOptions", py::overload_cast<uint64_t, storm::storage::BitVector const&>(&synthesis::Family::holeSetOptions))
+        .def("size", &synthesis::Family::size)
+        .def("logSize", &synthesis::Family::logSize)
         .def("holeNumOptions", &synthesis::Family::holeNumOptions)
         .def("holeNumOptionsTotal", &synthesis::Family::holeNumOptionsTotal)
         .def("holeContains", &synthesis::Family::holeContains)
+        .def("isCanonical", &synthesis::Family::isCanonical, py::arg("orbit"))
+        .def("canonicalize", &synthesis::Family::canonicalize, py::arg("orbit"))
+        ;
+
+    py::class_<synthesis::FamilyArena>(m, "FamilyArena")
+        .def(py::init<>())
+        .def("acquire", &synthesis::FamilyArena::acquire, py::return_value_policy::reference_internal)
+        .def("releaseAll", &synthesis::FamilyArena::releaseAll)
+        .def("numAcquired", &synthesis::FamilyArena::numAcquired)
+        .def("numSlots", &synthesis::FamilyArena::numSlots)
+        ;
+
+    py::class_<synthesis::AssignmentEnumerator>(m, "AssignmentEnumerator")
+        .def(py::init<synthesis::Family const&>(), py::arg("family"))
+        .def("done", &synthesis::AssignmentEnumerator::done)
+        .def("numYielded", &synthesis::AssignmentEnumerator::numYielded)
+        .def("numHoles", &synthesis::AssignmentEnumerator::numHoles)
+        .def("reset", &synthesis::AssignmentEnumerator::reset)
+        // the block is returned as a dense (assignments x holes) array so that the brute-force
+        // loop hands the whole batch to the native checker without per-assignment boxing
+        .def("nextBlock", [](synthesis::AssignmentEnumerator& enumerator, uint64_t max_count) {
+            uint64_t num_holes = enumerator.numHoles();
+            auto block = enumerator.nextBlock(max_count);
+            uint64_t num_rows = num_holes > 0 ? block.size()/num_holes : 0;
+            py::array_t<uint64_t> matrix({num_rows,num_holes});
+            std::copy(block.begin(),block.end(),matrix.mutable_data());
+            return matrix;
+        }, py::arg("max_count"))
+        ;
+
+    py::class_<synthesis::FamilyQueue>(m, "FamilyQueue")
+        .def(py::init<bool>(), py::arg("maximizing"))
+        .def("push", &synthesis::FamilyQueue::push)
+        .def("pushSplit", &synthesis::FamilyQueue::pushSplit, py::call_guard<py::gil_scoped_release>())
+        .def("splitFamily", &synthesis::FamilyQueue::splitFamily, py::arg("parent_handle"), py::arg("hole"), py::arg("partition"))
+        .def("pop", &synthesis::FamilyQueue::pop)
+        .def("topBound", &synthesis::FamilyQueue::topBound)
+        .def("family", &synthesis::FamilyQueue::family, py::return_value_policy::reference_internal)
+        .def("bound", &synthesis::FamilyQueue::bound)
+        .def("release", &synthesis::FamilyQueue::release)
+        .def("size", &synthesis::FamilyQueue::size)
+        .def("empty", &synthesis::FamilyQueue::empty)
+        .def("clear", &synthesis::FamilyQueue::clear)
+        ;
+
+    py::class_<synthesis::FamilyCoordinator>(m, "FamilyCoordinator")
+        .def(py::init<uint16_t>(), py::arg("port"))
+        .def("acceptWorkers", &synthesis::FamilyCoordinator::acceptWorkers, py::arg("num_workers"), py::call_guard<py::gil_scoped_release>())
+        .def("numWorkers", &synthesis::FamilyCoordinator::numWorkers)
+        .def("sendFamily", &synthesis::FamilyCoordinator::sendFamily, py::arg("worker"), py::arg("tag"), py::arg("family"), py::call_guard<py::gil_scoped_release>())
+        .def("receiveResult", &synthesis::FamilyCoordinator::receiveResult, py::call_guard<py::gil_scoped_release>())
+        .def("shutdown", &synthesis::FamilyCoordinator::shutdown)
+        ;
+
+    py::class_<synthesis::FamilyWorker>(m, "FamilyWorker")
+        .def(py::init<std::string const&,uint16_t>(), py::arg("host"), py::arg("port"))
+        .def("setFamilyTemplate", &synthesis::FamilyWorker::setFamilyTemplate, py::arg("family"))
+        .def("receiveFamily", &synthesis::FamilyWorker::receiveFamily, py::call_guard<py::gil_scoped_release>())
+        .def("family", &synthesis::FamilyWorker::family, py::return_value_policy::reference_internal)
+        .def("lastTag", &synthesis::FamilyWorker::lastTag)
+        .def("sendResult", &synthesis::FamilyWorker::sendResult, py::arg("tag"), py::arg("value"))
         ;
 
     py::class_<synthesis::Coloring>(m, "Coloring")
@@ -319,10 +472,69 @@ void bindings_coloring(py::module& m) {
             std::vector<uint64_t> const&,
             std::vector<std::vector<std::pair<uint64_t,uint64_t>>>
         >())
+        // numpy-buffer variant of the constructor: the flat choice-to-assignment table is read
+        // straight from the array buffers, skipping the per-pair Python objects of the list form
+        .def(py::init([](
+            synthesis::Family const& family, std::vector<uint64_t> const& row_groups,
+            py::array_t<uint64_t, py::array::c_style | py::array::forcecast> const& assignment_offset,
+            py::array_t<uint64_t, py::array::c_style | py::array::forcecast> const& assignment_hole,
+            py::array_t<uint64_t, py::array::c_style | py::array::forcecast> const& assignment_option
+        ) {
+            auto const* offset = assignment_offset.data();
+            auto const* hole = assignment_hole.data();
+            auto const* option = assignment_option.data();
+            return synthesis::Coloring(
+                family, row_groups,
+                std::vector<uint64_t>(offset,offset+assignment_offset.size()),
+                std::vector<uint64_t>(hole,hole+assignment_hole.size()),
+                std::vector<uint64_t>(option,option+assignment_option.size())
+            );
+        }))
         .def("getChoiceToAssignment", &synthesis::Coloring::getChoiceToAssignment)
         .def("getStateToHoles", &synthesis::Coloring::getStateToHoles)
-        .def("selectCompatibleChoices", &synthesis::Coloring::selectCompatibleChoices)
-        .def("collectHoleOptions", &synthesis::Coloring::collectHoleOptions)
+        .def("symmetricHoleOrbits", &synthesis::Coloring::symmetricHoleOrbits, py::call_guard<py::gil_scoped_release>())
+        .def("numStateGroups", &synthesis::Coloring::numStateGroups)
+        .def_static("fromSnapshot", &synthesis::Coloring::fromSnapshot, py::call_guard<py::gil_scoped_release>())
+        .def("saveSnapshot", &synthesis::Coloring::saveSnapshot, py::call_guard<py::gil_scoped_release>())
+        .def("quotientHash", &synthesis::Coloring::quotientHash)
+        .def("selectCompatibleChoices", &synthesis::Coloring::selectCompatibleChoices, py::call_guard<py::gil_scoped_release>())
+        .def("selectCompatibleChoicesBatch", &synthesis::Coloring::selectCompatibleChoicesBatch, py::call_guard<py::gil_scoped_release>())
+        .def("selectCompatibleChoicesRefined", &synthesis::Coloring::selectCompatibleChoicesRefined, py::call_guard<py::gil_scoped_release>())
+        .def("selectAssignmentChoices", &synthesis::Coloring::selectAssignmentChoices, py::arg("assignment"), py::call_guard<py::gil_scoped_release>(), "for each state, the first choice compatible with the singleton family")
+        .def("applyAssignment", &synthesis::Coloring::applyAssignment<double>, py::arg("assignment"), py::arg("quotient"), py::call_guard<py::gil_scoped_release>(), "compose the DTMC induced by the singleton family directly, skipping the generic restriction machinery")
+        .def("choicesWithHoleOption", &synthesis::Coloring::choicesWithHoleOption, py::arg("hole"), py::arg("option"), py::return_value_policy::reference_internal)
+        .def("pruneConflictChoices", &synthesis::Coloring::pruneConflictChoices, py::arg("selection"), py::arg("conflict"), py::call_guard<py::gil_scoped_release>())
+        .def("scoreSplitCandidates", &synthesis::Coloring::scoreSplitCandidates, py::call_guard<py::gil_scoped_release>())
+        .def(
+            "partitionHoleOptions", &synthesis::Coloring::partitionHoleOptions,
+            py::arg("subfamily"), py::arg("hole"), py::arg("scores"), py::arg("k"),
+            py::call_guard<py::gil_scoped_release>(),
+            "partition the hole options into at most k score-balanced buckets and build the child families"
+        )
+        .def("weightHolesByVisits", &synthesis::Coloring::weightHolesByVisits, py::arg("state_visits"), py::call_guard<py::gil_scoped_release>(), "sum the expected state visits over the states labeled by each hole")
+        .def("collectHoleOptions", py::overload_cast<storm::storage::BitVector const&>(&synthesis::Coloring::collectHoleOptions, py::const_), py::call_guard<py::gil_scoped_release>())
+        .def("collectHoleOptions", py::overload_cast<storm::storage::BitVector const&, uint64_t>(&synthesis::Coloring::collectHoleOptions, py::const_), py::call_guard<py::gil_scoped_release>())
+        // numpy-buffer variant of collectHoleOptions: the options of hole h are
+        // options[offsets[h]:offsets[h+1]], returned as two uint64 arrays built in one pass
+        .def("collectHoleOptionsFlat", [](
+            synthesis::Coloring const& coloring, storm::storage::BitVector const& choices, uint64_t num_threads
+        ) {
+            auto hole_options = num_threads > 1 ?
+                coloring.collectHoleOptions(choices,num_threads) : coloring.collectHoleOptions(choices);
+            auto num_holes = hole_options.size();
+            py::array_t<uint64_t> offsets(num_holes+1);
+            auto* offsets_data = offsets.mutable_data();
+            offsets_data[0] = 0;
+            for(uint64_t hole = 0; hole<num_holes; ++hole) {
+                offsets_data[hole+1] = offsets_data[hole] + hole_options[hole].size();
+            }
+            py::array_t<uint64_t> options(offsets_data[num_holes]);
+            auto* options_data = options.mutable_data();
+            for(uint64_t hole = 0; hole<num_holes; ++hole) {
+                options_data = std::copy(hole_options[hole].begin(),hole_options[hole].end(),options_data);
+            }
+            return py::make_tuple(offsets,options);
+        }, py::arg("choices"), py::arg("num_threads") = 1)
         ;
 
     py::class_<synthesis::ColoringSmt<>, std::shared_ptr<synthesis::ColoringSmt<>>>(m, "ColoringSmt")
@@ -339,10 +551,37 @@ void bindings_coloring(py::module& m) {
         >())
         .def("enableStateExploration", &synthesis::ColoringSmt<>::enableStateExploration)
         .def("getFamilyInfo", &synthesis::ColoringSmt<>::getFamilyInfo)
-        .def("selectCompatibleChoices", py::overload_cast<synthesis::Family const&>(&synthesis::ColoringSmt<>::selectCompatibleChoices))
-        .def("selectCompatibleChoices", py::overload_cast<synthesis::Family const&, storm::storage::BitVector const&>(&synthesis::ColoringSmt<>::selectCompatibleChoices))
-        .def("areChoicesConsistent", &synthesis::ColoringSmt<>::areChoicesConsistent)
+        .def("selectCompatibleChoices", py::overload_cast<synthesis::Family const&>(&synthesis::ColoringSmt<>::selectCompatibleChoices), py::call_guard<py::gil_scoped_release>())
+        .def("selectCompatibleChoices", py::overload_cast<synthesis::Family const&, storm::storage::BitVector const&>(&synthesis::ColoringSmt<>::selectCompatibleChoices), py::call_guard<py::gil_scoped_release>())
+        .def("areChoicesConsistent", &synthesis::ColoringSmt<>::areChoicesConsistent, py::call_guard<py::gil_scoped_release>())
+        .def("setCancellationToken", &synthesis::ColoringSmt<>::setCancellationToken, py::arg("token"))
+        .def("harmonizeInconsistentScheduler", &synthesis::ColoringSmt<>::harmonizeInconsistentScheduler, py::call_guard<py::gil_scoped_release>())
+        .def("enumerateInconsistencyCores", &synthesis::ColoringSmt<>::enumerateInconsistencyCores, py::call_guard<py::gil_scoped_release>())
+        .def("loadClauseDatabase", &synthesis::ColoringSmt<>::loadClauseDatabase, py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+            "pre-assert the conflict cores persisted by a previous run on the same coloring, returns their number")
+        .def("saveClauseDatabase", &synthesis::ColoringSmt<>::saveClauseDatabase, py::arg("path"), py::call_guard<py::gil_scoped_release>(),
+            "persist the conflict cores learned so far for the next run on the same coloring, returns their number")
         // .def_property_readonly("unsat_core", [](synthesis::ColoringSmt<>& coloring) {return coloring.unsat_core;})
         .def("getProfilingInfo", &synthesis::ColoringSmt<>::getProfilingInfo)
+        .def("getProfilingReport", &synthesis::ColoringSmt<>::getProfilingReport)
+        ;
+
+    py::class_<synthesis::ColoringSmtPool<>, std::shared_ptr<synthesis::ColoringSmtPool<>>>(m, "ColoringSmtPool")
+        .def(py::init<
+            uint64_t,
+            std::vector<uint64_t> const&,
+            std::vector<uint64_t> const&,
+            uint64_t, uint64_t,
+            storm::storage::sparse::StateValuations const&,
+            storm::storage::BitVector const&,
+            std::vector<std::string> const&,
+            std::vector<std::vector<int64_t>> const&,
+            std::vector<std::tuple<uint64_t,uint64_t,uint64_t>> const&,
+            bool
+        >())
+        .def("numWorkers", &synthesis::ColoringSmtPool<>::numWorkers)
+        .def("getPrimary", &synthesis::ColoringSmtPool<>::getPrimary)
+        .def("areChoicesConsistentBatch", &synthesis::ColoringSmtPool<>::areChoicesConsistentBatch,
+            py::call_guard<py::gil_scoped_release>())
         ;
 }
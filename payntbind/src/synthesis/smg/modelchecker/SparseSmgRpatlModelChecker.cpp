@@ -10,6 +10,7 @@
 #include <algorithm>
 
 #include <storm/utility/FilteredRewardModel.h>
+#include <storm/utility/vector.h>
 #include <storm/modelchecker/results/ExplicitQualitativeCheckResult.h>
 #include <storm/modelchecker/results/ExplicitQuantitativeCheckResult.h>
 #include <storm/modelchecker/helper/utility/SetInformationFromCheckTask.h>
@@ -213,10 +214,31 @@ namespace synthesis {
 
     template<typename SparseSmgModelType>
     std::unique_ptr<storm::modelchecker::CheckResult> SparseSmgRpatlModelChecker<SparseSmgModelType>::computeLongRunAverageRewards(storm::Environment const& env, storm::modelchecker::CheckTask<storm::logic::LongRunAverageRewardFormula, ValueType> const& checkTask) {
-        auto rewardModel = storm::utility::createFilteredRewardModel(this->getModel(), checkTask);
+        // Look up the flattened reward slice for this reward model, building it on first use.
+        // All long-run-average formulae filter a given reward model identically, so the name
+        // suffices as the cache key.
+        std::string rewardModelName = checkTask.isRewardModelSet() ? checkTask.getRewardModel() : "";
+        auto cacheIt = flattenedRewardModels.find(rewardModelName);
+        if (cacheIt == flattenedRewardModels.end()) {
+            auto rewardModel = storm::utility::createFilteredRewardModel(this->getModel(), checkTask);
+            auto const& transitionMatrix = this->getModel().getTransitionMatrix();
+            std::vector<ValueType> actionRewards(transitionMatrix.getRowCount(), storm::utility::zero<ValueType>());
+            if (rewardModel.get().hasTransitionRewards()) {
+                actionRewards = transitionMatrix.getPointwiseProductRowSumVector(rewardModel.get().getTransitionRewardMatrix());
+            }
+            if (rewardModel.get().hasStateActionRewards()) {
+                storm::utility::vector::addVectors(actionRewards, rewardModel.get().getStateActionRewardVector(), actionRewards);
+            }
+            boost::optional<std::vector<ValueType>> stateRewards;
+            if (rewardModel.get().hasStateRewards()) {
+                stateRewards = rewardModel.get().getStateRewardVector();
+            }
+            cacheIt = flattenedRewardModels.emplace(rewardModelName, RewardModelType(std::move(stateRewards), std::move(actionRewards))).first;
+        }
+
         synthesis::SparseNondeterministicGameInfiniteHorizonHelper<ValueType> helper(this->getModel().getTransitionMatrix(), statesOfCoalition);
         storm::modelchecker::helper::setInformationFromCheckTaskNondeterministic(helper, checkTask, this->getModel());
-        auto values = helper.computeLongRunAverageRewards(env, rewardModel.get());
+        auto values = helper.computeLongRunAverageRewards(env, cacheIt->second);
 
         std::unique_ptr<storm::modelchecker::CheckResult> result(new storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType>(std::move(values)));
         if (checkTask.isProduceSchedulersSet()) {
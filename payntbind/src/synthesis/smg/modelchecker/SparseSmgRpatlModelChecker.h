@@ -54,6 +54,11 @@ namespace synthesis {
 
     private:
         storm::storage::BitVector statesOfCoalition;
+
+        // Reward slices flattened once per reward model and reused across the formulae checked
+        // against the same model: transition rewards are folded into per-choice values, so the
+        // helpers read an array entry instead of recomputing a dot product per evaluation.
+        std::map<std::string, RewardModelType> flattenedRewardModels;
     };
 }
 
@@ -2,8 +2,10 @@
  * code in this file was taken from TEMPEST (https://github.com/PrangerStefan/TempestSynthesis)
  */
 
+#include <algorithm>
 #include <list>
 #include <numeric>
+#include <thread>
 
 #include <storm/storage/StronglyConnectedComponentDecomposition.h>
 
@@ -11,6 +13,9 @@
 
 namespace synthesis {
 
+    // below this many frontier states the thread fan-out does not pay off
+    const uint64_t MEC_CHECK_PARALLEL_THRESHOLD = 1ull << 12;
+
     template<typename ValueType>
     GameMaximalEndComponentDecomposition<ValueType>::GameMaximalEndComponentDecomposition() : Decomposition() {
         // Intentionally left empty.
@@ -117,60 +122,90 @@ namespace synthesis {
             for (auto& scc : sccs) {
                 statesToCheck.set(scc.begin(), scc.end());
 
-                while (!statesToCheck.empty()) {
-                    storm::storage::BitVector statesToRemove(numberOfStates);
+                // Membership tests against a bit vector instead of the sorted state block; the
+                // vector is kept in sync when states are erased below.
+                storm::storage::BitVector sccAsBitVector(numberOfStates);
+                sccAsBitVector.set(scc.begin(), scc.end(), true);
 
-                    for (auto state : statesToCheck) {
-                        bool keepStateInMEC = true;
+                // Decides whether a state can stay: it must have a choice that remains in the SCC.
+                auto stateStaysInMEC = [&](uint_fast64_t state) {
+                    for (uint_fast64_t choice = nondeterministicChoiceIndices[state]; choice < nondeterministicChoiceIndices[state + 1]; ++choice) {
 
-                        for (uint_fast64_t choice = nondeterministicChoiceIndices[state]; choice < nondeterministicChoiceIndices[state + 1]; ++choice) {
+                        // If the choice is not part of our subsystem, skip it.
+                        if (choices && !choices->get(choice)) {
+                            continue;
+                        }
 
-                            // If the choice is not part of our subsystem, skip it.
-                            if (choices && !choices->get(choice)) {
+                        bool choiceContainedInMEC = true;
+                        for (auto const& entry : transitionMatrix.getRow(choice)) {
+                            if (storm::utility::isZero(entry.getValue())) {
                                 continue;
                             }
 
-                            // If the choice is not included any more, skip it.
-                            //if (!includedChoices.get(choice)) {
-                            //    continue;
-                            //}
-
-                            bool choiceContainedInMEC = true;
-                            for (auto const& entry : transitionMatrix.getRow(choice)) {
-                                if (storm::utility::isZero(entry.getValue())) {
-                                    continue;
-                                }
-
-                                if (!scc.containsState(entry.getColumn())) {
-                                    //includedChoices.set(choice, false);
-                                    choiceContainedInMEC = false;
-                                    break;
-                                }
-                            }
-
-                            //TODO If there is at least one choice whose successor states are fully contained in the MEC, we can leave the state in the MEC.
-                            if (!choiceContainedInMEC) {
-                                keepStateInMEC = false;
+                            if (!sccAsBitVector.get(entry.getColumn())) {
+                                choiceContainedInMEC = false;
                                 break;
                             }
                         }
-                        if (!keepStateInMEC) {
-                            statesToRemove.set(state, true);
+
+                        //TODO If there is at least one choice whose successor states are fully contained in the MEC, we can leave the state in the MEC.
+                        if (!choiceContainedInMEC) {
+                            return false;
                         }
+                    }
+                    return true;
+                };
+
+                while (!statesToCheck.empty()) {
+                    storm::storage::BitVector statesToRemove(numberOfStates);
 
+                    // The checks are independent of each other, so a large frontier is spread
+                    // over the cores; every worker writes its own slots of the flag array.
+                    std::vector<uint_fast64_t> frontier(statesToCheck.begin(), statesToCheck.end());
+                    std::vector<char> removeFlag(frontier.size(), 0);
+                    auto checkRange = [&](uint64_t frontierBegin, uint64_t frontierEnd) {
+                        for (uint64_t position = frontierBegin; position < frontierEnd; position++) {
+                            if (!stateStaysInMEC(frontier[position])) {
+                                removeFlag[position] = 1;
+                            }
+                        }
+                    };
+                    uint64_t numWorkers = std::thread::hardware_concurrency();
+                    if (numWorkers > 1 && frontier.size() >= MEC_CHECK_PARALLEL_THRESHOLD) {
+                        uint64_t statesPerWorker = (frontier.size() + numWorkers - 1) / numWorkers;
+                        std::vector<std::thread> workers;
+                        for (uint64_t worker = 1; worker < numWorkers; worker++) {
+                            uint64_t frontierBegin = std::min(worker * statesPerWorker, (uint64_t) frontier.size());
+                            uint64_t frontierEnd = std::min(frontierBegin + statesPerWorker, (uint64_t) frontier.size());
+                            if (frontierBegin < frontierEnd) {
+                                workers.emplace_back(checkRange, frontierBegin, frontierEnd);
+                            }
+                        }
+                        checkRange(0, statesPerWorker);
+                        for (auto& worker : workers) {
+                            worker.join();
+                        }
+                    } else {
+                        checkRange(0, frontier.size());
+                    }
+                    for (uint64_t position = 0; position < frontier.size(); position++) {
+                        if (removeFlag[position]) {
+                            statesToRemove.set(frontier[position], true);
+                        }
                     }
 
                     // Now erase the states that have no option to stay inside the MEC with all successors.
                     mecChanged |= !statesToRemove.empty();
                     for (uint_fast64_t state : statesToRemove) {
                         scc.erase(state);
+                        sccAsBitVector.set(state, false);
                     }
 
                     // Now check which states should be reconsidered, because successors of them were removed.
                     statesToCheck.clear();
                     for (auto state : statesToRemove) {
                         for (auto const& entry : backwardTransitions.getRow(state)) {
-                            if (scc.containsState(entry.getColumn())) {
+                            if (sccAsBitVector.get(entry.getColumn())) {
                                 statesToCheck.set(entry.getColumn());
                             }
                         }
@@ -4,6 +4,9 @@
 
 #include "SparseNondeterministicGameInfiniteHorizonHelper.h"
 
+#include <algorithm>
+#include <thread>
+
 #include <storm/storage/SparseMatrix.h>
 #include <storm/storage/MaximalEndComponentDecomposition.h>
 #include <storm/environment/solver/LongRunAverageSolverEnvironment.h>
@@ -68,18 +71,13 @@ namespace synthesis {
     template <typename ValueType>
     std::vector<ValueType> SparseNondeterministicGameInfiniteHorizonHelper<ValueType>::computeLongRunAverageValues(storm::Environment const& env, ValueGetter const& stateValuesGetter,  ValueGetter const& actionValuesGetter) {
         auto underlyingSolverEnvironment = env;
-        std::vector<ValueType> componentLraValues;
         createDecomposition();
-        componentLraValues.reserve(this->_longRunComponentDecomposition->size());
-        for (auto const& c : *(this->_longRunComponentDecomposition)) {
-            componentLraValues.push_back(computeLraForComponent(underlyingSolverEnvironment, stateValuesGetter, actionValuesGetter, c));
-        }
-        return componentLraValues;
-    }
+        uint64_t numComponents = this->_longRunComponentDecomposition->size();
+        std::vector<ValueType> componentLraValues(numComponents);
 
-    template <typename ValueType>
-    ValueType SparseNondeterministicGameInfiniteHorizonHelper<ValueType>::computeLraForComponent(storm::Environment const& env, ValueGetter const& stateRewardsGetter, ValueGetter const& actionRewardsGetter, storm::storage::MaximalEndComponent const& component) {
-        // Allocate memory for the nondeterministic choices.
+        // Allocate memory for the nondeterministic choices before the components are solved:
+        // every component writes only the entries of its own states, so the components can be
+        // dispatched concurrently once the shared output vectors are in place.
         if (this->isProduceSchedulerSet()) {
             if (!this->_producedOptimalChoices.is_initialized()) {
                 this->_producedOptimalChoices.emplace();
@@ -94,6 +92,37 @@ namespace synthesis {
             this->_choiceValues->resize(this->_transitionMatrix.getRowCount());
         }
 
+        auto solveRange = [&](uint64_t componentBegin, uint64_t componentEnd) {
+            for (uint64_t component = componentBegin; component < componentEnd; component++) {
+                componentLraValues[component] = computeLraForComponent(underlyingSolverEnvironment, stateValuesGetter, actionValuesGetter, (*this->_longRunComponentDecomposition)[component]);
+            }
+        };
+
+        // the components are independent subproblems, so they are spread over the cores; the
+        // stitching of the component values happens in the caller after all workers are done
+        uint64_t numWorkers = std::min<uint64_t>(std::thread::hardware_concurrency(), numComponents);
+        if (numWorkers <= 1) {
+            solveRange(0, numComponents);
+            return componentLraValues;
+        }
+        uint64_t componentsPerWorker = (numComponents + numWorkers - 1) / numWorkers;
+        std::vector<std::thread> workers;
+        for (uint64_t worker = 1; worker < numWorkers; worker++) {
+            uint64_t componentBegin = std::min(worker * componentsPerWorker, numComponents);
+            uint64_t componentEnd = std::min(componentBegin + componentsPerWorker, numComponents);
+            if (componentBegin < componentEnd) {
+                workers.emplace_back(solveRange, componentBegin, componentEnd);
+            }
+        }
+        solveRange(0, componentsPerWorker);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return componentLraValues;
+    }
+
+    template <typename ValueType>
+    ValueType SparseNondeterministicGameInfiniteHorizonHelper<ValueType>::computeLraForComponent(storm::Environment const& env, ValueGetter const& stateRewardsGetter, ValueGetter const& actionRewardsGetter, storm::storage::MaximalEndComponent const& component) {
         storm::solver::LraMethod method = env.solver().lra().getNondetLraMethod();
         if (method == storm::solver::LraMethod::LinearProgramming) {
             STORM_LOG_THROW(false, storm::exceptions::InvalidSettingsException, "Unsupported technique.");
@@ -17,19 +17,10 @@
 #include "internal/GameViHelper.h"
 #include "internal/Multiplier.h"
 #include "GameMaximalEndComponentDecomposition.h"
+#include "src/synthesis/BitVectorOps.h"
 
 namespace synthesis {
 
-    void setClippedStatesOfCoalition(storm::storage::BitVector *vector, storm::storage::BitVector relevantStates, storm::storage::BitVector statesOfCoalition) {
-        auto clippedStatesCounter = 0;
-        for(uint i = 0; i < relevantStates.size(); i++) {
-            if(relevantStates.get(i)) {
-                vector->set(clippedStatesCounter, statesOfCoalition[i]);
-                clippedStatesCounter++;
-            }
-        }
-    }
-
     bool epsilonGreaterOrEqual(double x, double y, double eps=1e-6) {
         return (x>=y) || (fabs(x - y) <= eps);
     }
@@ -49,8 +40,7 @@ namespace synthesis {
         std::vector<ValueType> constrainedChoiceValues = std::vector<ValueType>(b.size(), storm::utility::zero<ValueType>());
         std::unique_ptr<storm::storage::Scheduler<ValueType>> scheduler;
 
-        storm::storage::BitVector clippedStatesOfCoalition(relevantStates.getNumberOfSetBits());
-        synthesis::setClippedStatesOfCoalition(&clippedStatesOfCoalition, relevantStates, statesOfCoalition);
+        storm::storage::BitVector clippedStatesOfCoalition = synthesis::compress(statesOfCoalition, relevantStates);
 
         auto transposed_matrix = storm::storage::SparseMatrix<ValueType>(transitionMatrix.transpose(true));
         auto endComponentDecomposition = storm::storage::MaximalEndComponentDecomposition<ValueType>(transitionMatrix, transposed_matrix);
@@ -59,17 +49,23 @@ namespace synthesis {
         storm::utility::vector::setVectorValues(result, psiStates, storm::utility::one<ValueType>());
 
         if(!relevantStates.empty()) {
-            // Reduce the matrix to relevant states.
-            storm::storage::SparseMatrix<ValueType> submatrix = transitionMatrix.getSubmatrix(true, relevantStates, relevantStates, false);
-            // Create GameViHelper for computations.
-            synthesis::GameViHelper<ValueType> viHelper(submatrix, clippedStatesOfCoalition);
-            if (produceScheduler) {
-                viHelper.setProduceScheduler(true);
+            // Reduce the matrix to relevant states. When every state is relevant the projection
+            // is the original matrix with flipped senses only, so no submatrix is materialized.
+            storm::storage::SparseMatrix<ValueType> submatrix;
+            bool fullProjection = relevantStates.full();
+            if(!fullProjection) {
+                submatrix = transitionMatrix.getSubmatrix(true, relevantStates, relevantStates, false);
             }
-            viHelper.performValueIteration(env, x, b, goal.direction(), constrainedChoiceValues);
+            // Get a GameViHelper for computations. Sequential formulae over one SMG typically
+            // restrict to the same game, so cached helpers keep their prepared multipliers
+            // (and with them the converted matrix and work vectors) across checks.
+            static GameViHelperCache<ValueType> viHelperCache;
+            auto viHelper = viHelperCache.get(fullProjection ? transitionMatrix : submatrix, clippedStatesOfCoalition);
+            viHelper->setProduceScheduler(produceScheduler);
+            viHelper->performValueIteration(env, x, b, goal.direction(), constrainedChoiceValues);
 
             // Fill up the constrainedChoice Values to full size.
-            viHelper.fillChoiceValuesVector(constrainedChoiceValues, relevantStates, transitionMatrix.getRowGroupIndices());
+            viHelper->fillChoiceValuesVector(constrainedChoiceValues, relevantStates, transitionMatrix.getRowGroupIndices());
 
             // Fill up the result vector with the values of x for the relevant states, with 1s for psi states
             storm::utility::vector::setVectorValues(result, relevantStates, x);
@@ -293,8 +289,7 @@ namespace synthesis {
         std::vector<ValueType> constrainedChoiceValues = std::vector<ValueType>(transitionMatrix.getConstrainedRowGroupSumVector(relevantStates, psiStates).size(), storm::utility::zero<ValueType>());
         std::unique_ptr<storm::storage::Scheduler<ValueType>> scheduler;
 
-        storm::storage::BitVector clippedStatesOfCoalition(relevantStates.getNumberOfSetBits());
-        synthesis::setClippedStatesOfCoalition(&clippedStatesOfCoalition, relevantStates, statesOfCoalition);
+        storm::storage::BitVector clippedStatesOfCoalition = synthesis::compress(statesOfCoalition, relevantStates);
 
         // If there are no relevantStates or the upperBound is 0, no computation is needed.
         if(!relevantStates.empty() && upperBound > 0) {
@@ -325,11 +320,11 @@ namespace synthesis {
 
                 // The relevantStates for the second part of the computation are all states.
                 relevantStates = storm::storage::BitVector(phiStates.size(), true);
-                submatrix = transitionMatrix.getSubmatrix(true, relevantStates, relevantStates, false);
 
-                // Update the viHelper for the (full-size) submatrix and statesOfCoalition.
-                viHelper.updateTransitionMatrix(submatrix);
-                viHelper.updateStatesOfCoalition(statesOfCoalition);
+                // The restriction now covers the whole game, so the projection is the original
+                // matrix with the coalition senses as per-state direction metadata; switch the
+                // helper onto a view of it instead of materializing a full-size copy.
+                viHelper.updateTransitionMatrix(CoalitionView<ValueType>{&transitionMatrix, statesOfCoalition});
 
                 // Reset constrainedChoiceValues and b to 0-vector in the correct dimension.
                 constrainedChoiceValues = std::vector<ValueType>(transitionMatrix.getConstrainedRowGroupSumVector(relevantStates, newPsiStates).size(), storm::utility::zero<ValueType>());
@@ -4,32 +4,73 @@
 
 #include "GameViHelper.h"
 
+#include <algorithm>
+#include <deque>
+#include <thread>
+
 #include <storm/environment/solver/SolverEnvironment.h>
 #include <storm/environment/solver/GameSolverEnvironment.h>
+#include <storm/environment/solver/MinMaxSolverEnvironment.h>
+#include <storm/solver/MinMaxLinearEquationSolver.h>
+#include <storm/storage/StronglyConnectedComponentDecomposition.h>
 #include <storm/utility/SignalHandler.h>
 #include <storm/utility/vector.h>
 
 namespace synthesis {
 
+    // a state is locked out of the iteration after its value change stays below the
+    // precision for this many consecutive sweeps; a changing successor unlocks it again
+    const uint64_t LOCKED_STABLE_SWEEPS = 3;
+
     template <typename ValueType>
-    GameViHelper<ValueType>::GameViHelper(storm::storage::SparseMatrix<ValueType> const& transitionMatrix, storm::storage::BitVector statesOfCoalition) : _transitionMatrix(transitionMatrix), _statesOfCoalition(statesOfCoalition) {
-        // Intentionally left empty.
+    GameViHelper<ValueType>::GameViHelper(storm::storage::SparseMatrix<ValueType> const& transitionMatrix, storm::storage::BitVector statesOfCoalition) : _ownedTransitionMatrix(transitionMatrix), _statesOfCoalition(statesOfCoalition) {
+        _transitionMatrix = &_ownedTransitionMatrix;
+    }
+
+    template <typename ValueType>
+    GameViHelper<ValueType>::GameViHelper(CoalitionView<ValueType> view) : _statesOfCoalition(std::move(view.statesOfCoalition)) {
+        // the projection is a view: the matrix stays with the caller, only the coalition
+        // senses travel into the multiplier layer as its direction override
+        _transitionMatrix = view.matrix;
     }
 
     template <typename ValueType>
     void GameViHelper<ValueType>::prepareSolversAndMultipliers(const storm::Environment& env) {
-        _multiplier = synthesis::MultiplierFactory<ValueType>().create(env, _transitionMatrix);
+        // reuse the prepared multiplier (and with it the converted matrix) across computation
+        // calls as long as the matrix and the environment selections are unchanged
+        auto requested_type = env.solver().multiplier().getType();
+        auto solver_type = env.solver().getLinearEquationSolverType();
+        if (_multiplier && _multiplierUpToDate && requested_type == _multiplierEnvType && solver_type == _multiplierEnvSolverType) {
+            _x1IsCurrent = false;
+            return;
+        }
+        _multiplier = synthesis::MultiplierFactory<ValueType>().create(env, *_transitionMatrix);
+        _multiplierEnvType = requested_type;
+        _multiplierEnvSolverType = solver_type;
+        _multiplierUpToDate = true;
         _x1IsCurrent = false;
     }
 
     template <typename ValueType>
     void GameViHelper<ValueType>::performValueIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues) {
+        if (env.solver().game().getMethod() == storm::solver::GameMethod::PolicyIteration) {
+            performPolicyIteration(env, x, b, dir, constrainedChoiceValues);
+            return;
+        }
+        if (env.solver().minMax().getMethod() == storm::solver::MinMaxMethod::Topological && !env.solver().minMax().isMethodSetFromDefault()) {
+            performTopologicalValueIteration(env, x, b, dir, constrainedChoiceValues);
+            return;
+        }
+        if (env.solver().isForceSoundness()) {
+            performOptimisticValueIteration(env, x, b, dir, constrainedChoiceValues);
+            return;
+        }
         prepareSolversAndMultipliers(env);
         // Get precision for convergence check.
         ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().game().getPrecision());
         uint64_t maxIter = env.solver().game().getMaximalNumberOfIterations();
         _b = b;
-        //_x1.assign(_transitionMatrix.getRowGroupCount(), storm::utility::zero<ValueType>());
+        //_x1.assign(_transitionMatrix->getRowGroupCount(), storm::utility::zero<ValueType>());
         _x1 = x;
         _x2 = _x1;
 
@@ -37,36 +78,448 @@ namespace synthesis {
             if (!this->_producedOptimalChoices.is_initialized()) {
                 this->_producedOptimalChoices.emplace();
             }
-            this->_producedOptimalChoices->resize(this->_transitionMatrix.getRowGroupCount());
+            this->_producedOptimalChoices->resize(this->_transitionMatrix->getRowGroupCount());
         }
 
         uint64_t iter = 0;
-        constrainedChoiceValues = std::vector<ValueType>(b.size(), storm::utility::zero<ValueType>());
 
-        while (iter < maxIter) {
-            if(iter == maxIter - 1) {
-                _multiplier->multiply(env, xNew(), &_b, constrainedChoiceValues);
-                auto rowGroupIndices = this->_transitionMatrix.getRowGroupIndices();
-                rowGroupIndices.erase(rowGroupIndices.begin());
-                _multiplier->reduce(env, dir, rowGroupIndices, constrainedChoiceValues, xNew(), nullptr, &_statesOfCoalition);
+        // per-state locking: most states settle within a few sweeps while a small set keeps
+        // oscillating, so states that stay stable for LOCKED_STABLE_SWEEPS consecutive sweeps
+        // are frozen; full multiplier sweeps run while the active set is still large, scalar
+        // sweeps over the active states take over once it has shrunk below half
+        uint64_t stateCount = _transitionMatrix->getRowGroupCount();
+        auto const& rowGroupIndices = _transitionMatrix->getRowGroupIndices();
+        storm::storage::BitVector active(stateCount, true);
+        std::vector<uint8_t> stableSweeps(stateCount, 0);
+        uint64_t numActive = stateCount;
+        bool stopSweeps = false;
+
+        while (iter < maxIter && numActive * 2 > stateCount) {
+            performIterationStep(env, dir);
+            ++iter;
+            auto const& xPrev = xOld();
+            auto const& xCur = xNew();
+            for (uint64_t state = active.getNextSetIndex(0); state < stateCount; state = active.getNextSetIndex(state + 1)) {
+                ValueType diff = xCur[state] - xPrev[state];
+                if (diff < storm::utility::zero<ValueType>()) {
+                    diff = -diff;
+                }
+                if (diff <= precision) {
+                    if (++stableSweeps[state] >= LOCKED_STABLE_SWEEPS) {
+                        active.set(state, false);
+                        --numActive;
+                    }
+                } else {
+                    stableSweeps[state] = 0;
+                }
+            }
+            if (checkConvergence(precision) || storm::utility::resources::isTerminate()) {
+                stopSweeps = true;
                 break;
             }
-            performIterationStep(env, dir);
-            if (checkConvergence(precision)) {
-                _multiplier->multiply(env, xNew(), &_b, constrainedChoiceValues);
+        }
+
+        if (!stopSweeps && numActive > 0) {
+            // a value change wakes the predecessors of the state, so a frozen state never
+            // misses an update that still has to reach it
+            if (!_backwardTransitions) {
+                _backwardTransitions = std::make_unique<storm::storage::SparseMatrix<ValueType>>(_transitionMatrix->transpose(true));
+            }
+            std::vector<ValueType>& xCur = xNew();
+            while (iter < maxIter && numActive > 0) {
+                for (uint64_t state = active.getNextSetIndex(0); state < stateCount; state = active.getNextSetIndex(state + 1)) {
+                    bool flipDir = !_statesOfCoalition.empty() && _statesOfCoalition.get(state);
+                    bool minimize = (dir == storm::solver::OptimizationDirection::Minimize) != flipDir;
+                    ValueType bestValue = storm::utility::zero<ValueType>();
+                    for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1]; row++) {
+                        ValueType value = _b[row];
+                        for (auto const& entry : _transitionMatrix->getRow(row)) {
+                            value += entry.getValue() * xCur[entry.getColumn()];
+                        }
+                        if (row == rowGroupIndices[state] || (minimize ? value < bestValue : value > bestValue)) {
+                            bestValue = value;
+                        }
+                    }
+                    ValueType diff = bestValue - xCur[state];
+                    if (diff < storm::utility::zero<ValueType>()) {
+                        diff = -diff;
+                    }
+                    xCur[state] = bestValue;
+                    if (diff <= precision) {
+                        if (++stableSweeps[state] >= LOCKED_STABLE_SWEEPS) {
+                            active.set(state, false);
+                            --numActive;
+                        }
+                    } else {
+                        stableSweeps[state] = 0;
+                        for (auto const& entry : _backwardTransitions->getRow(state)) {
+                            uint64_t predecessor = entry.getColumn();
+                            if (!active.get(predecessor)) {
+                                active.set(predecessor, true);
+                                stableSweeps[predecessor] = 0;
+                                ++numActive;
+                            }
+                        }
+                    }
+                }
+                ++iter;
+                if (storm::utility::resources::isTerminate()) {
+                    break;
+                }
+            }
+        }
+        x = xNew();
+
+        // One recording sweep computes the choice values and the scheduler choices together.
+        performRecordingSweep(dir, x, constrainedChoiceValues, isProduceSchedulerSet() ? &_producedOptimalChoices.get() : nullptr);
+    }
+
+    template <typename ValueType>
+    void GameViHelper<ValueType>::performDirtyValueIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues, storm::storage::BitVector const& dirtyStates) {
+        uint64_t stateCount = _transitionMatrix->getRowGroupCount();
+        STORM_LOG_ASSERT(x.size() == stateCount, "Previous fixpoint does not match the game.");
+        STORM_LOG_ASSERT(dirtyStates.size() == stateCount, "Dirty mask does not match the game.");
+        // the worklist pays off only while the touched cone stays small
+        uint64_t touchedLimit = stateCount / 4;
+        if (dirtyStates.getNumberOfSetBits() > touchedLimit) {
+            performValueIteration(env, x, std::move(b), dir, constrainedChoiceValues);
+            return;
+        }
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().game().getPrecision());
+        _b = b;
+        if (!_backwardTransitions) {
+            _backwardTransitions = std::make_unique<storm::storage::SparseMatrix<ValueType>>(_transitionMatrix->transpose(true));
+        }
+        auto const& rowGroupIndices = _transitionMatrix->getRowGroupIndices();
+
+        std::deque<uint64_t> worklist(dirtyStates.begin(), dirtyStates.end());
+        storm::storage::BitVector queued(dirtyStates);
+        storm::storage::BitVector touched(dirtyStates);
+        uint64_t numTouched = touched.getNumberOfSetBits();
+        // a worklist that keeps revisiting states is better served by the multiplier-driven
+        // sweeps, whose per-row cost is lower
+        uint64_t processedLimit = stateCount * 10;
+        uint64_t processed = 0;
+        bool fallback = false;
+
+        while (!worklist.empty()) {
+            uint64_t state = worklist.front();
+            worklist.pop_front();
+            queued.set(state, false);
+            bool flipDir = !_statesOfCoalition.empty() && _statesOfCoalition.get(state);
+            bool minimize = (dir == storm::solver::OptimizationDirection::Minimize) != flipDir;
+            ValueType bestValue = storm::utility::zero<ValueType>();
+            for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1]; row++) {
+                ValueType value = _b[row];
+                for (auto const& entry : _transitionMatrix->getRow(row)) {
+                    value += entry.getValue() * x[entry.getColumn()];
+                }
+                if (row == rowGroupIndices[state] || (minimize ? value < bestValue : value > bestValue)) {
+                    bestValue = value;
+                }
+            }
+            ValueType diff = bestValue - x[state];
+            if (diff < storm::utility::zero<ValueType>()) {
+                diff = -diff;
+            }
+            if (diff > precision) {
+                x[state] = bestValue;
+                // the change can propagate to every predecessor of the state
+                for (auto const& entry : _backwardTransitions->getRow(state)) {
+                    uint64_t predecessor = entry.getColumn();
+                    if (!queued.get(predecessor)) {
+                        queued.set(predecessor, true);
+                        worklist.push_back(predecessor);
+                        if (!touched.get(predecessor)) {
+                            touched.set(predecessor, true);
+                            ++numTouched;
+                        }
+                    }
+                }
+            }
+            ++processed;
+            if (numTouched > touchedLimit || processed > processedLimit) {
+                fallback = true;
                 break;
             }
             if (storm::utility::resources::isTerminate()) {
                 break;
             }
+        }
+
+        if (fallback) {
+            // warm-started full iteration; the partial propagation is still a head start
+            performValueIteration(env, x, std::move(b), dir, constrainedChoiceValues);
+            return;
+        }
+
+        if (this->isProduceSchedulerSet()) {
+            if (!this->_producedOptimalChoices.is_initialized()) {
+                this->_producedOptimalChoices.emplace();
+            }
+            this->_producedOptimalChoices->resize(stateCount);
+        }
+        performRecordingSweep(dir, x, constrainedChoiceValues, isProduceSchedulerSet() ? &_producedOptimalChoices.get() : nullptr);
+    }
+
+    template <typename ValueType>
+    void GameViHelper<ValueType>::performOptimisticValueIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues) {
+        prepareSolversAndMultipliers(env);
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().game().getPrecision());
+        uint64_t maxIter = env.solver().game().getMaximalNumberOfIterations();
+        _b = b;
+        _x1 = x;
+        _x2 = _x1;
+
+        if (this->isProduceSchedulerSet()) {
+            if (!this->_producedOptimalChoices.is_initialized()) {
+                this->_producedOptimalChoices.emplace();
+            }
+            this->_producedOptimalChoices->resize(this->_transitionMatrix->getRowGroupCount());
+        }
+
+        std::vector<ValueType> upper, upperNew;
+        ValueType guessEpsilon = precision;
+        ValueType iterPrecision = precision;
+        const uint64_t maxVerificationIters = 50;
+        bool certified = false;
+
+        uint64_t iter = 0;
+        while (iter < maxIter && !certified) {
+            // improve the lower values until they look converged at the current internal precision
+            performIterationStep(env, dir);
             ++iter;
+            if (!checkConvergence(iterPrecision)) {
+                if (storm::utility::resources::isTerminate()) {
+                    break;
+                }
+                continue;
+            }
+
+            // guess an upper vector and verify it is inductive
+            upper = xNew();
+            for (auto& value : upper) {
+                value += guessEpsilon;
+            }
+            upperNew.resize(upper.size());
+            for (uint64_t verificationIter = 0; verificationIter < maxVerificationIters && iter < maxIter; ++verificationIter, ++iter) {
+                _multiplier->multiplyAndReduce(env, dir, upper, &_b, upperNew, nullptr, &_statesOfCoalition);
+                bool inductive = true;
+                for (uint64_t state = 0; state < upper.size(); ++state) {
+                    if (upperNew[state] > upper[state]) {
+                        inductive = false;
+                        break;
+                    }
+                }
+                if (inductive) {
+                    certified = true;
+                    upper.swap(upperNew);
+                    break;
+                }
+                upper.swap(upperNew);
+            }
+            if (certified) {
+                // the bounds must also cross within the precision for the midpoint to be certified
+                ValueType gap = storm::utility::zero<ValueType>();
+                auto const& lower = xNew();
+                for (uint64_t state = 0; state < upper.size(); ++state) {
+                    if (upper[state] - lower[state] > gap) {
+                        gap = upper[state] - lower[state];
+                    }
+                }
+                if (gap > 2 * precision) {
+                    certified = false;
+                }
+            }
+            if (!certified) {
+                // the guess was not verifiable yet: iterate the lower values more precisely
+                iterPrecision = iterPrecision / 10;
+            }
+            if (storm::utility::resources::isTerminate()) {
+                break;
+            }
         }
+
+        // report the certified midpoint, or the plain lower values when interrupted
         x = xNew();
+        if (certified) {
+            for (uint64_t state = 0; state < x.size(); ++state) {
+                x[state] = (x[state] + upper[state]) / 2;
+            }
+        }
+
+        _x1 = x;
+        _x2 = x;
+        _x1IsCurrent = false;
+        performRecordingSweep(dir, x, constrainedChoiceValues, isProduceSchedulerSet() ? &_producedOptimalChoices.get() : nullptr);
+    }
+
+    template <typename ValueType>
+    void GameViHelper<ValueType>::performPolicyIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues) {
+        prepareSolversAndMultipliers(env);
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().game().getPrecision());
+        uint64_t maxIter = env.solver().game().getMaximalNumberOfIterations();
+        _b = b;
+        uint64_t stateCount = _transitionMatrix->getRowGroupCount();
+        auto const& rowGroupIndices = _transitionMatrix->getRowGroupIndices();
+
+        // the coalition flag flips the reduction direction of the flagged states, so their strategy
+        // is the one fixed and improved; the remaining states are solved exactly each round
+        bool flaggedMinimize = (dir == storm::solver::OptimizationDirection::Maximize);
+        std::vector<uint64_t> fixedChoices(stateCount, 0);
+        std::vector<ValueType> choiceValues(_transitionMatrix->getRowCount());
+
+        uint64_t iter = 0;
+        while (iter < maxIter) {
+            // build the model induced by the fixed strategy: flagged states keep only their chosen row
+            storm::storage::SparseMatrixBuilder<ValueType> builder(0, stateCount, 0, false, true, stateCount);
+            std::vector<ValueType> inducedB;
+            uint64_t inducedRow = 0;
+            for (uint64_t state = 0; state < stateCount; state++) {
+                builder.newRowGroup(inducedRow);
+                uint64_t rowBegin = rowGroupIndices[state];
+                uint64_t rowEnd = rowGroupIndices[state + 1];
+                if (_statesOfCoalition.get(state)) {
+                    rowBegin += fixedChoices[state];
+                    rowEnd = rowBegin + 1;
+                }
+                for (uint64_t row = rowBegin; row < rowEnd; row++) {
+                    for (auto const& entry : _transitionMatrix->getRow(row)) {
+                        builder.addNextValue(inducedRow, entry.getColumn(), entry.getValue());
+                    }
+                    inducedB.push_back(_b[row]);
+                    inducedRow++;
+                }
+            }
+            auto solver = storm::solver::GeneralMinMaxLinearEquationSolverFactory<ValueType>().create(env, builder.build());
+            solver->setHasUniqueSolution(true);
+            solver->setRequirementsChecked(true);
+            solver->solveEquations(env, dir, x, inducedB);
+
+            // improve the fixed strategy against the exact values
+            _multiplier->multiply(env, x, &_b, choiceValues);
+            bool improved = false;
+            for (auto state : _statesOfCoalition) {
+                uint64_t currentChoice = fixedChoices[state];
+                ValueType currentValue = choiceValues[rowGroupIndices[state] + currentChoice];
+                uint64_t bestChoice = currentChoice;
+                ValueType bestValue = currentValue;
+                for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1]; row++) {
+                    if (flaggedMinimize ? choiceValues[row] < bestValue : choiceValues[row] > bestValue) {
+                        bestChoice = row - rowGroupIndices[state];
+                        bestValue = choiceValues[row];
+                    }
+                }
+                // switch only upon improvement beyond the precision to guarantee termination
+                if (bestChoice != currentChoice && (flaggedMinimize ? currentValue - bestValue > precision : bestValue - currentValue > precision)) {
+                    fixedChoices[state] = bestChoice;
+                    improved = true;
+                }
+            }
+            if (!improved) {
+                break;
+            }
+            if (storm::utility::resources::isTerminate()) {
+                break;
+            }
+            ++iter;
+        }
 
-        if (isProduceSchedulerSet()) {
-            // We will be doing one more iteration step and track scheduler choices this time.
-            performIterationStep(env, dir, &_producedOptimalChoices.get());
+        // fill the outputs the same way value iteration does
+        _x1 = x;
+        _x2 = x;
+        _x1IsCurrent = false;
+        if (this->isProduceSchedulerSet()) {
+            if (!this->_producedOptimalChoices.is_initialized()) {
+                this->_producedOptimalChoices.emplace();
+            }
+            this->_producedOptimalChoices->resize(stateCount);
         }
+        performRecordingSweep(dir, x, constrainedChoiceValues, isProduceSchedulerSet() ? &_producedOptimalChoices.get() : nullptr);
+    }
+
+    template <typename ValueType>
+    void GameViHelper<ValueType>::performTopologicalValueIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues) {
+        prepareSolversAndMultipliers(env);
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().game().getPrecision());
+        uint64_t maxIter = env.solver().game().getMaximalNumberOfIterations();
+        _b = b;
+        auto const& rowGroupIndices = _transitionMatrix->getRowGroupIndices();
+
+        // sort the components so that every component only depends on already solved ones
+        storm::storage::StronglyConnectedComponentDecomposition<ValueType> sccDecomposition(*_transitionMatrix, storm::storage::StronglyConnectedComponentDecompositionOptions().forceTopologicalSort());
+
+        // reduce one row group against the current values, honoring the coalition flip
+        auto reduceState = [&](uint64_t state) {
+            bool flipDir = !_statesOfCoalition.empty() && _statesOfCoalition.get(state);
+            bool minimize = (dir == storm::solver::OptimizationDirection::Minimize) != flipDir;
+            ValueType bestValue = storm::utility::zero<ValueType>();
+            for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1]; row++) {
+                ValueType value = _b[row];
+                for (auto const& entry : _transitionMatrix->getRow(row)) {
+                    value += entry.getValue() * x[entry.getColumn()];
+                }
+                if (row == rowGroupIndices[state] || (minimize ? value < bestValue : value > bestValue)) {
+                    bestValue = value;
+                }
+            }
+            return bestValue;
+        };
+
+        for (auto const& scc : sccDecomposition) {
+            // a singleton component without a self-loop is settled by a single update
+            if (scc.size() == 1) {
+                uint64_t state = *scc.begin();
+                bool hasSelfLoop = false;
+                for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1] && !hasSelfLoop; row++) {
+                    for (auto const& entry : _transitionMatrix->getRow(row)) {
+                        if (entry.getColumn() == state && !storm::utility::isZero(entry.getValue())) {
+                            hasSelfLoop = true;
+                            break;
+                        }
+                    }
+                }
+                if (!hasSelfLoop) {
+                    x[state] = reduceState(state);
+                    continue;
+                }
+            }
+
+            // iterate the component locally until its values converge; successors are settled,
+            // so in-place updates propagate new values within the component immediately
+            for (uint64_t iter = 0; iter < maxIter; ++iter) {
+                ValueType maxDiff = storm::utility::zero<ValueType>();
+                for (auto state : scc) {
+                    ValueType newValue = reduceState(state);
+                    ValueType diff = newValue > x[state] ? newValue - x[state] : x[state] - newValue;
+                    if (diff > maxDiff) {
+                        maxDiff = diff;
+                    }
+                    x[state] = newValue;
+                }
+                if (maxDiff <= precision) {
+                    break;
+                }
+                if (storm::utility::resources::isTerminate()) {
+                    break;
+                }
+            }
+            if (storm::utility::resources::isTerminate()) {
+                break;
+            }
+        }
+
+        // fill the outputs the same way value iteration does
+        _x1 = x;
+        _x2 = x;
+        _x1IsCurrent = false;
+        if (this->isProduceSchedulerSet()) {
+            if (!this->_producedOptimalChoices.is_initialized()) {
+                this->_producedOptimalChoices.emplace();
+            }
+            this->_producedOptimalChoices->resize(_transitionMatrix->getRowGroupCount());
+        }
+        performRecordingSweep(dir, x, constrainedChoiceValues, isProduceSchedulerSet() ? &_producedOptimalChoices.get() : nullptr);
     }
 
     template <typename ValueType>
@@ -83,6 +536,83 @@ namespace synthesis {
         }
     }
 
+    template <typename ValueType>
+    void GameViHelper<ValueType>::performRecordingSweep(storm::solver::OptimizationDirection const dir, std::vector<ValueType> const& x, std::vector<ValueType>& constrainedChoiceValues, std::vector<uint64_t>* choices) const {
+        auto const& rowGroupIndices = _transitionMatrix->getRowGroupIndices();
+        uint64_t stateCount = _transitionMatrix->getRowGroupCount();
+        uint64_t rowCount = _transitionMatrix->getRowCount();
+        constrainedChoiceValues.assign(rowCount, storm::utility::zero<ValueType>());
+
+        // flag buffer for the shield filter; plain bytes so the workers can write without
+        // racing on shared bit-vector words, packed into the mask after the sweep
+        std::vector<char> admissibleFlag;
+        if (_shieldFilter) {
+            admissibleFlag.assign(rowCount, 0);
+        }
+
+        auto sweepRange = [&](uint64_t stateBegin, uint64_t stateEnd) {
+            for (uint64_t state = stateBegin; state < stateEnd; state++) {
+                bool flipDir = !_statesOfCoalition.empty() && _statesOfCoalition.get(state);
+                bool minimize = (dir == storm::solver::OptimizationDirection::Minimize) != flipDir;
+                uint64_t bestChoice = 0;
+                ValueType bestValue = storm::utility::zero<ValueType>();
+                for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1]; row++) {
+                    ValueType value = _b[row];
+                    for (auto const& entry : _transitionMatrix->getRow(row)) {
+                        value += entry.getValue() * x[entry.getColumn()];
+                    }
+                    constrainedChoiceValues[row] = value;
+                    if (row == rowGroupIndices[state] || (minimize ? value < bestValue : value > bestValue)) {
+                        bestValue = value;
+                        bestChoice = row - rowGroupIndices[state];
+                    }
+                }
+                if (choices) {
+                    (*choices)[state] = bestChoice;
+                }
+                if (_shieldFilter) {
+                    // a choice is admissible if its value is within epsilon of the optimum
+                    ValueType threshold = _shieldRelative ? _shieldEpsilon * (bestValue < storm::utility::zero<ValueType>() ? -bestValue : bestValue) : _shieldEpsilon;
+                    for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1]; row++) {
+                        if (minimize ? constrainedChoiceValues[row] <= bestValue + threshold : constrainedChoiceValues[row] >= bestValue - threshold) {
+                            admissibleFlag[row] = 1;
+                        }
+                    }
+                }
+            }
+        };
+
+        // shielding needs the full choice-value vector anyway, so the sweep is worth spreading
+        // over the row groups; the workers write disjoint entries
+        uint64_t numWorkers = isShieldingTask() ? std::thread::hardware_concurrency() : 1;
+        if (numWorkers <= 1 || stateCount < numWorkers) {
+            sweepRange(0, stateCount);
+        } else {
+            uint64_t statesPerWorker = (stateCount + numWorkers - 1) / numWorkers;
+            std::vector<std::thread> workers;
+            for (uint64_t worker = 1; worker < numWorkers; worker++) {
+                uint64_t stateBegin = std::min(worker * statesPerWorker, stateCount);
+                uint64_t stateEnd = std::min(stateBegin + statesPerWorker, stateCount);
+                if (stateBegin < stateEnd) {
+                    workers.emplace_back(sweepRange, stateBegin, stateEnd);
+                }
+            }
+            sweepRange(0, statesPerWorker);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        if (_shieldFilter) {
+            _admissibleChoices = storm::storage::BitVector(rowCount);
+            for (uint64_t row = 0; row < rowCount; row++) {
+                if (admissibleFlag[row]) {
+                    _admissibleChoices.set(row, true);
+                }
+            }
+        }
+    }
+
     template <typename ValueType>
     bool GameViHelper<ValueType>::checkConvergence(ValueType threshold) const {
         STORM_LOG_ASSERT(_multiplier, "tried to check for convergence without doing an iteration first.");
@@ -133,9 +663,34 @@ namespace synthesis {
         return _shieldingTask;
     }
 
+    template <typename ValueType>
+    void GameViHelper<ValueType>::setShieldFilter(ValueType epsilon, bool relative) {
+        _shieldFilter = true;
+        _shieldEpsilon = epsilon;
+        _shieldRelative = relative;
+    }
+
+    template <typename ValueType>
+    storm::storage::BitVector const& GameViHelper<ValueType>::getAdmissibleChoices() const {
+        STORM_LOG_ASSERT(_shieldFilter, "Trying to get the admissible choices although no shield filter was set.");
+        STORM_LOG_ASSERT(_admissibleChoices.size() > 0, "Trying to get the admissible choices but none were available. Was there a computation call before?");
+        return _admissibleChoices;
+    }
+
     template <typename ValueType>
     void GameViHelper<ValueType>::updateTransitionMatrix(storm::storage::SparseMatrix<ValueType> newTransitionMatrix) {
-        _transitionMatrix = newTransitionMatrix;
+        _ownedTransitionMatrix = std::move(newTransitionMatrix);
+        _transitionMatrix = &_ownedTransitionMatrix;
+        _multiplierUpToDate = false;
+        _backwardTransitions.reset();
+    }
+
+    template <typename ValueType>
+    void GameViHelper<ValueType>::updateTransitionMatrix(CoalitionView<ValueType> view) {
+        _transitionMatrix = view.matrix;
+        _statesOfCoalition = std::move(view.statesOfCoalition);
+        _multiplierUpToDate = false;
+        _backwardTransitions.reset();
     }
 
     template <typename ValueType>
@@ -143,6 +698,16 @@ namespace synthesis {
         _statesOfCoalition = newStatesOfCoalition;
     }
 
+    template <typename ValueType>
+    storm::storage::SparseMatrix<ValueType> const& GameViHelper<ValueType>::getTransitionMatrix() const {
+        return *_transitionMatrix;
+    }
+
+    template <typename ValueType>
+    storm::storage::BitVector const& GameViHelper<ValueType>::getStatesOfCoalition() const {
+        return _statesOfCoalition;
+    }
+
     template <typename ValueType>
     std::vector<uint64_t> const& GameViHelper<ValueType>::getProducedOptimalChoices() const {
         STORM_LOG_ASSERT(this->isProduceSchedulerSet(), "Trying to get the produced optimal choices although no scheduler was requested.");
@@ -207,5 +772,52 @@ namespace synthesis {
         return _x1IsCurrent ? _x2 : _x1;
     }
 
+    template <typename ValueType>
+    const uint64_t GameViHelperCache<ValueType>::CAPACITY = 4;
+
+    template <typename ValueType>
+    uint64_t GameViHelperCache<ValueType>::fingerprint(storm::storage::SparseMatrix<ValueType> const& transitionMatrix, storm::storage::BitVector const& statesOfCoalition) {
+        auto combine = [](uint64_t& h, uint64_t v) {
+            h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        };
+        uint64_t h = transitionMatrix.getRowCount();
+        combine(h, transitionMatrix.getColumnCount());
+        combine(h, transitionMatrix.getEntryCount());
+        for (uint64_t group : transitionMatrix.getRowGroupIndices()) {
+            combine(h, group);
+        }
+        for (uint64_t row = 0; row < transitionMatrix.getRowCount(); ++row) {
+            for (auto const& entry : transitionMatrix.getRow(row)) {
+                combine(h, entry.getColumn());
+                combine(h, std::hash<ValueType>()(entry.getValue()));
+            }
+        }
+        combine(h, std::hash<storm::storage::BitVector>()(statesOfCoalition));
+        return h;
+    }
+
+    template <typename ValueType>
+    std::shared_ptr<GameViHelper<ValueType>> GameViHelperCache<ValueType>::get(storm::storage::SparseMatrix<ValueType> const& transitionMatrix, storm::storage::BitVector const& statesOfCoalition) {
+        uint64_t key = fingerprint(transitionMatrix, statesOfCoalition);
+        for (uint64_t index = 0; index < entries.size(); ++index) {
+            auto const& entry = entries[index];
+            if (entry.fingerprint != key || !(entry.helper->getTransitionMatrix() == transitionMatrix) || entry.helper->getStatesOfCoalition() != statesOfCoalition) {
+                continue;
+            }
+            // hit: move the entry to the most recently used position
+            Entry hit = entries[index];
+            entries.erase(entries.begin() + index);
+            entries.push_back(hit);
+            return hit.helper;
+        }
+        auto helper = std::make_shared<GameViHelper<ValueType>>(transitionMatrix, statesOfCoalition);
+        if (entries.size() == CAPACITY) {
+            entries.erase(entries.begin());
+        }
+        entries.push_back(Entry{key, helper});
+        return helper;
+    }
+
     template class GameViHelper<double>;
+    template class GameViHelperCache<double>;
 }
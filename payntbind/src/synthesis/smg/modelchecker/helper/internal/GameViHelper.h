@@ -5,26 +5,67 @@
  */
 
 #include <storm/storage/SparseMatrix.h>
+#include <storm/environment/solver/MultiplierSolverEnvironment.h>
 #include <storm/solver/LinearEquationSolver.h>
 #include <storm/solver/MinMaxLinearEquationSolver.h>
+#include <storm/solver/SolverSelectionOptions.h>
 #include <storm/storage/Scheduler.h>
 
 #include "Multiplier.h"
 
 namespace synthesis {
 
+    /*!
+        * Non-owning coalition projection of a game: the SMG matrix together with the per-state
+        * optimization senses of the coalition, consumed directly as the direction override of
+        * the multiplier layer. Restricting an SMG to a coalition flips who optimizes where, not
+        * the matrix itself, so checking through a view skips materializing the projected matrix
+        * entirely. The caller keeps the matrix alive for the lifetime of the view and of every
+        * helper constructed from it.
+        */
+    template <typename ValueType>
+    struct CoalitionView {
+        storm::storage::SparseMatrix<ValueType> const* matrix;
+        storm::storage::BitVector statesOfCoalition;
+    };
+
     template <typename ValueType>
     class GameViHelper {
     public:
         GameViHelper(storm::storage::SparseMatrix<ValueType> const& transitionMatrix, storm::storage::BitVector statesOfCoalition);
 
+        /*!
+            * Construct a helper over a coalition view without copying the game matrix (see
+            * CoalitionView). Must not be used for cached helpers, which outlive their caller.
+            */
+        GameViHelper(CoalitionView<ValueType> view);
+
         void prepareSolversAndMultipliers(const storm::Environment& env);
 
         /*!
-            * Perform value iteration until convergence
+            * Perform value iteration until convergence. When the game solver environment selects
+            * the policy-iteration method, strategy iteration is performed instead (see
+            * performPolicyIteration); when the min-max solver environment explicitly selects the
+            * topological method, the game is decomposed into strongly connected components that
+            * are solved one at a time (see performTopologicalValueIteration); when the solver
+            * environment forces soundness, optimistic value iteration is performed instead (see
+            * performOptimisticValueIteration). The interface and the produced results are the
+            * same.
             */
         void performValueIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues);
 
+        /*!
+            * Value iteration warm-started from a previous fixpoint of a locally modified game.
+            * Given the states whose enabled choices changed since the previous solve, value
+            * updates are propagated with a worklist over the backward cone of influence, so a
+            * re-solve perturbing few states costs a handful of row-group updates instead of
+            * full sweeps over the matrix. When the dirty region grows beyond a fraction of the
+            * state space the method falls back to performValueIteration warm-started with the
+            * partially propagated values. The produced values, choice values and scheduler
+            * match performValueIteration up to the solver precision.
+            */
+        void performDirtyValueIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues, storm::storage::BitVector const& dirtyStates);
+
         /*!
             * Sets whether an optimal scheduler shall be constructed during the computation
             */
@@ -46,15 +87,47 @@ namespace synthesis {
         bool isShieldingTask() const;
 
         /*!
-            * Changes the transitionMatrix to the given one.
+            * Enables shield extraction during the recording sweep: every choice whose value is
+            * within epsilon of its state's optimum (relative to the optimum, or absolute) is
+            * marked in a compact per-choice bit mask, available via getAdmissibleChoices. Shields
+            * can consume the mask directly instead of materializing a scheduler and comparing
+            * the full choice-value vector afterwards.
+            */
+        void setShieldFilter(ValueType epsilon, bool relative);
+
+        /*!
+            * @pre before calling this, a computation call with an enabled shield filter should
+            * have been performed.
+            * @return the bit mask of admissible choices of the most recent call.
+            */
+        storm::storage::BitVector const& getAdmissibleChoices() const;
+
+        /*!
+            * Changes the transitionMatrix to the given one. Invalidates the prepared multiplier.
             */
         void updateTransitionMatrix(storm::storage::SparseMatrix<ValueType> newTransitionMatrix);
 
+        /*!
+            * Switches the helper onto a coalition view: matrix and coalition senses change
+            * without materializing a projected matrix. Invalidates the prepared multiplier.
+            */
+        void updateTransitionMatrix(CoalitionView<ValueType> view);
+
         /*!
             * Changes the statesOfCoalition to the given one.
             */
         void updateStatesOfCoalition(storm::storage::BitVector newStatesOfCoalition);
 
+        /*!
+            * @return the transition matrix of the game.
+            */
+        storm::storage::SparseMatrix<ValueType> const& getTransitionMatrix() const;
+
+        /*!
+            * @return the coalition mask of the game.
+            */
+        storm::storage::BitVector const& getStatesOfCoalition() const;
+
         storm::storage::Scheduler<ValueType> extractScheduler() const;
 
         void getChoiceValues(storm::Environment const& env, std::vector<ValueType> const& x, std::vector<ValueType>& choiceValues);
@@ -70,6 +143,46 @@ namespace synthesis {
             */
         void performIterationStep(storm::Environment const& env, storm::solver::OptimizationDirection const dir, std::vector<uint64_t>* choices = nullptr);
 
+        /*!
+            * Perform strategy iteration: fix the strategy of the states whose reduction direction
+            * is flipped by the coalition flag, solve the induced model exactly with a MinMax
+            * linear equation solver, improve the fixed strategy against the exact values and
+            * repeat until no state improves. Converges in few iterations on stiff models where
+            * plain value iteration contracts slowly.
+            */
+        void performPolicyIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues);
+
+        /*!
+            * Perform topological value iteration: decompose the game matrix into strongly
+            * connected components sorted so that every component only depends on already solved
+            * ones, iterate each component locally until it converges and reuse the settled values
+            * of its successors. Singleton components without a self-loop are settled by a single
+            * update. On chain-structured games this avoids sweeping the whole state space in
+            * every iteration.
+            */
+        void performTopologicalValueIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues);
+
+        /*!
+            * Perform optimistic value iteration: iterate lower values as usual, and once they look
+            * converged, guess an upper vector and verify it is inductive (one application of the
+            * Bellman operator does not increase it anywhere). When the verified bounds cross
+            * within the precision, the midpoint is certifiably precision-close to the fixpoint;
+            * otherwise iteration continues at a tighter internal precision. The plain-VI stopping
+            * criterion can report values off by more than epsilon on slowly-mixing models, this
+            * one cannot.
+            */
+        void performOptimisticValueIteration(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> b, storm::solver::OptimizationDirection const dir, std::vector<ValueType>& constrainedChoiceValues);
+
+        /*!
+            * Perform the single recording sweep that follows convergence: compute the choice
+            * values and the optimal choices of all states in one pass over the matrix, instead
+            * of one multiplication for the values and one more reduction for the scheduler.
+            * Tracking choices inside the iteration loop would slow every step even though only
+            * the final choices matter. For shielding tasks the sweep is parallelized over the
+            * row groups.
+            */
+        void performRecordingSweep(storm::solver::OptimizationDirection const dir, std::vector<ValueType> const& x, std::vector<ValueType>& constrainedChoiceValues, std::vector<uint64_t>* choices) const;
+
         /*!
             * Checks whether the curently computed value achieves the desired precision
             */
@@ -94,13 +207,59 @@ namespace synthesis {
             */
         std::vector<uint64_t>& getProducedOptimalChoices();
 
-        storm::storage::SparseMatrix<ValueType> _transitionMatrix;
+        // the game matrix: points to _ownedTransitionMatrix, or to a caller-owned matrix when
+        // the helper operates on a CoalitionView (no materialized projection)
+        storm::storage::SparseMatrix<ValueType> const* _transitionMatrix;
+        storm::storage::SparseMatrix<ValueType> _ownedTransitionMatrix;
         storm::storage::BitVector _statesOfCoalition;
         std::vector<ValueType> _x, _x1, _x2, _b;
         std::unique_ptr<synthesis::Multiplier<ValueType>> _multiplier;
+        // whether _multiplier matches the current transition matrix, so that repeated
+        // computation calls skip the matrix format conversion of the factory
+        bool _multiplierUpToDate = false;
+        // the environment selections _multiplier was created under
+        storm::solver::MultiplierType _multiplierEnvType;
+        storm::solver::EquationSolverType _multiplierEnvSolverType;
+        // backward transitions for the dirty-state worklist, built on first use
+        std::unique_ptr<storm::storage::SparseMatrix<ValueType>> _backwardTransitions;
 
         bool _produceScheduler = false;
         bool _shieldingTask = false;
         boost::optional<std::vector<uint64_t>> _producedOptimalChoices;
+
+        bool _shieldFilter = false;
+        bool _shieldRelative = false;
+        ValueType _shieldEpsilon;
+        storm::storage::BitVector _admissibleChoices;
+    };
+
+    /*!
+        * Cache of GameViHelper instances keyed by the content of the game matrix and the
+        * coalition mask. Workflows that check many formulae over one SMG rebuild the same
+        * restricted game per formula; reusing the helper also reuses the multiplier's converted
+        * matrix and its work vectors, whose setup often exceeds the solve time of repeat queries.
+        * Entries are matched by a content fingerprint and verified by exact comparison; the least
+        * recently used entry is evicted when the capacity is exceeded. Cached helpers must not be
+        * mutated via updateTransitionMatrix, as that would detach them from their key.
+        */
+    template <typename ValueType>
+    class GameViHelperCache {
+    public:
+        /*!
+            * Get a helper for the given game, constructing and caching it on a miss.
+            */
+        std::shared_ptr<GameViHelper<ValueType>> get(storm::storage::SparseMatrix<ValueType> const& transitionMatrix, storm::storage::BitVector const& statesOfCoalition);
+
+    private:
+        struct Entry {
+            uint64_t fingerprint;
+            std::shared_ptr<GameViHelper<ValueType>> helper;
+        };
+
+        static uint64_t fingerprint(storm::storage::SparseMatrix<ValueType> const& transitionMatrix, storm::storage::BitVector const& statesOfCoalition);
+
+        // cached helpers, most recently used last
+        std::vector<Entry> entries;
+        static const uint64_t CAPACITY;
     };
 }
@@ -11,6 +11,88 @@
 
 namespace synthesis {
 
+    /*
+     * Cache of converted gmm matrices keyed by a content fingerprint of the source matrix.
+     * Workflows that alternate between a few restrictions (e.g. two shield configurations)
+     * construct fresh multipliers for matrices whose content was converted before; sharing
+     * the converted matrices lets such alternation pay the conversion once per distinct
+     * matrix. Entries are verified by exact comparison against the csr arrays; the least
+     * recently used entry is evicted when the capacity is exceeded.
+     */
+    template<typename ValueType>
+    class GmmConversionCache {
+    public:
+        std::shared_ptr<gmm::csr_matrix<ValueType> const> get(storm::storage::SparseMatrix<ValueType> const& matrix) {
+            uint64_t key = fingerprint(matrix);
+            for (uint64_t index = 0; index < entries.size(); ++index) {
+                if (entries[index].fingerprint != key || !matches(matrix, *entries[index].converted)) {
+                    continue;
+                }
+                // hit: move the entry to the most recently used position
+                Entry hit = entries[index];
+                entries.erase(entries.begin() + index);
+                entries.push_back(hit);
+                return hit.converted;
+            }
+            std::shared_ptr<gmm::csr_matrix<ValueType> const> converted(storm::adapters::GmmxxAdapter<ValueType>().toGmmxxSparseMatrix(matrix).release());
+            if (entries.size() == CAPACITY) {
+                entries.erase(entries.begin());
+            }
+            entries.push_back(Entry{key, converted});
+            return converted;
+        }
+
+    private:
+        struct Entry {
+            uint64_t fingerprint;
+            std::shared_ptr<gmm::csr_matrix<ValueType> const> converted;
+        };
+
+        static uint64_t fingerprint(storm::storage::SparseMatrix<ValueType> const& matrix) {
+            auto combine = [](uint64_t& h, uint64_t v) {
+                h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            };
+            uint64_t h = matrix.getRowCount();
+            combine(h, matrix.getColumnCount());
+            combine(h, matrix.getEntryCount());
+            for (uint64_t row = 0; row < matrix.getRowCount(); ++row) {
+                for (auto const& entry : matrix.getRow(row)) {
+                    combine(h, entry.getColumn());
+                    combine(h, std::hash<ValueType>()(entry.getValue()));
+                }
+            }
+            return h;
+        }
+
+        static bool matches(storm::storage::SparseMatrix<ValueType> const& matrix, gmm::csr_matrix<ValueType> const& converted) {
+            if (converted.nrows() != matrix.getRowCount() || converted.ncols() != matrix.getColumnCount()) {
+                return false;
+            }
+            uint64_t index = 0;
+            for (uint64_t row = 0; row < matrix.getRowCount(); ++row) {
+                for (auto const& entry : matrix.getRow(row)) {
+                    if (converted.ir[index] != entry.getColumn() || converted.pr[index] != entry.getValue()) {
+                        return false;
+                    }
+                    ++index;
+                }
+                if (converted.jc[row + 1] != index) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<Entry> entries;
+        static const uint64_t CAPACITY = 4;
+    };
+
+    template<typename ValueType>
+    static GmmConversionCache<ValueType>& gmmConversionCache() {
+        static GmmConversionCache<ValueType> cache;
+        return cache;
+    }
+
     template<typename ValueType>
     GmmxxMultiplier<ValueType>::GmmxxMultiplier(storm::storage::SparseMatrix<ValueType> const& matrix) : Multiplier<ValueType>(matrix) {
         // Intentionally left empty.
@@ -19,14 +101,14 @@ namespace synthesis {
 
     template<typename ValueType>
     void GmmxxMultiplier<ValueType>::initialize() const {
-        if (gmmMatrix.nrows() == 0) {
-            gmmMatrix = std::move(*storm::adapters::GmmxxAdapter<ValueType>().toGmmxxSparseMatrix(this->matrix));
+        if (!gmmMatrix) {
+            gmmMatrix = gmmConversionCache<ValueType>().get(this->matrix);
         }
     }
 
     template<typename ValueType>
     void GmmxxMultiplier<ValueType>::clearCache() const {
-        gmmMatrix = gmm::csr_matrix<ValueType>();
+        gmmMatrix.reset();
         Multiplier<ValueType>::clearCache();
     }
 
@@ -64,18 +146,18 @@ namespace synthesis {
     template<typename ValueType>
     void GmmxxMultiplier<ValueType>::multiplyGaussSeidel(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const* b, bool backwards) const {
         initialize();
-        STORM_LOG_ASSERT(gmmMatrix.nr == gmmMatrix.nc, "Expecting square matrix.");
+        STORM_LOG_ASSERT(gmmMatrix->nr == gmmMatrix->nc, "Expecting square matrix.");
         if (backwards) {
             if (b) {
-                gmm::mult_add_by_row_bwd(gmmMatrix, x, *b, x, gmm::abstract_dense());
+                gmm::mult_add_by_row_bwd(*gmmMatrix, x, *b, x, gmm::abstract_dense());
             } else {
-                gmm::mult_by_row_bwd(gmmMatrix, x, x, gmm::abstract_dense());
+                gmm::mult_by_row_bwd(*gmmMatrix, x, x, gmm::abstract_dense());
             }
         } else {
             if (b) {
-                gmm::mult_add_by_row(gmmMatrix, x, *b, x, gmm::abstract_dense());
+                gmm::mult_add_by_row(*gmmMatrix, x, *b, x, gmm::abstract_dense());
             } else {
-                gmm::mult_by_row(gmmMatrix, x, x, gmm::abstract_dense());
+                gmm::mult_by_row(*gmmMatrix, x, x, gmm::abstract_dense());
             }
         }
     }
@@ -111,19 +193,19 @@ namespace synthesis {
     template<typename ValueType>
     void GmmxxMultiplier<ValueType>::multiplyRow(uint64_t const& rowIndex, std::vector<ValueType> const& x, ValueType& value) const {
         initialize();
-        value += vect_sp(gmm::mat_const_row(gmmMatrix, rowIndex), x, typename gmm::linalg_traits<gmm::csr_matrix<ValueType>>::storage_type(), typename gmm::linalg_traits<std::vector<ValueType>>::storage_type());
+        value += vect_sp(gmm::mat_const_row(*gmmMatrix, rowIndex), x, typename gmm::linalg_traits<gmm::csr_matrix<ValueType>>::storage_type(), typename gmm::linalg_traits<std::vector<ValueType>>::storage_type());
     }
 
     template<typename ValueType>
     void GmmxxMultiplier<ValueType>::multAdd(std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result) const {
         if (b) {
             if (b == &result) {
-                gmm::mult_add(gmmMatrix, x, result);
+                gmm::mult_add(*gmmMatrix, x, result);
             } else {
-                gmm::mult_add(gmmMatrix, x, *b, result);
+                gmm::mult_add(*gmmMatrix, x, *b, result);
             }
         } else {
-            gmm::mult(gmmMatrix, x, result);
+            gmm::mult(*gmmMatrix, x, result);
         }
     }
 
@@ -135,13 +217,13 @@ namespace synthesis {
                 if (backwards) {
                     multAddReduceHelper<storm::utility::ElementLess<ValueType>, true, true>(rowGroupIndices, x, b, result, choices, dirOverride);
                 } else {
-                    multAddReduceHelper<storm::utility::ElementLess<ValueType>, false, true>(rowGroupIndices, x, b, result, choices, dirOverride);
+                    multAddReduceFlat<storm::utility::ElementLess<ValueType>, true>(rowGroupIndices, x, b, result, choices, dirOverride);
                 }
             } else {
                 if (backwards) {
                     multAddReduceHelper<storm::utility::ElementLess<ValueType>, true, false>(rowGroupIndices, x, b, result, choices);
                 } else {
-                    multAddReduceHelper<storm::utility::ElementLess<ValueType>, false, false>(rowGroupIndices, x, b, result, choices);
+                    multAddReduceFlat<storm::utility::ElementLess<ValueType>, false>(rowGroupIndices, x, b, result, choices);
                 }
             }
         } else {
@@ -149,13 +231,13 @@ namespace synthesis {
                 if (backwards) {
                     multAddReduceHelper<storm::utility::ElementGreater<ValueType>, true, true>(rowGroupIndices, x, b, result, choices, dirOverride);
                 } else {
-                    multAddReduceHelper<storm::utility::ElementGreater<ValueType>, false, true>(rowGroupIndices, x, b, result, choices, dirOverride);
+                    multAddReduceFlat<storm::utility::ElementGreater<ValueType>, true>(rowGroupIndices, x, b, result, choices, dirOverride);
                 }
             } else {
                 if (backwards) {
                     multAddReduceHelper<storm::utility::ElementGreater<ValueType>, true, false>(rowGroupIndices, x, b, result, choices);
                 } else {
-                    multAddReduceHelper<storm::utility::ElementGreater<ValueType>, false, false>(rowGroupIndices, x, b, result, choices);
+                    multAddReduceFlat<storm::utility::ElementGreater<ValueType>, false>(rowGroupIndices, x, b, result, choices);
                 }
             }
         }
@@ -174,7 +256,7 @@ namespace synthesis {
             add_ite = backwards ?gmm::vect_begin(*b) - 1 : gmm::vect_end(*b);
         }
         typename gmm::linalg_traits<VectorType>::iterator target_it = backwards ? gmm::vect_end(result) - 1 : gmm::vect_begin(result);
-        typename gmm::linalg_traits<MatrixType>::const_row_iterator itr = backwards ? mat_row_const_end(gmmMatrix) - 1 : mat_row_const_begin(gmmMatrix);
+        typename gmm::linalg_traits<MatrixType>::const_row_iterator itr = backwards ? mat_row_const_end(*gmmMatrix) - 1 : mat_row_const_begin(*gmmMatrix);
         typename std::vector<uint64_t>::iterator choice_it;
         if (choices) {
             choice_it = backwards ? choices->end() - 1 : choices->begin();
@@ -184,7 +266,7 @@ namespace synthesis {
         ValueType oldSelectedChoiceValue;
         uint64_t selectedChoice;
 
-        uint64_t currentRow = backwards ? gmmMatrix.nrows() - 1 : 0;
+        uint64_t currentRow = backwards ? gmmMatrix->nrows() - 1 : 0;
         uint64_t currentRowGroup = backwards ? rowGroupIndices.size() - 2 : 0;
         auto row_group_it = backwards ? rowGroupIndices.end() - 2 : rowGroupIndices.begin();
         auto row_group_ite = backwards ? rowGroupIndices.begin() - 1 : rowGroupIndices.end() - 1;
@@ -295,6 +377,67 @@ namespace synthesis {
             //std::cout << std::endl;
     }
 
+    template<typename ValueType>
+    template<typename Compare, bool directionOverridden>
+    void GmmxxMultiplier<ValueType>::multAddReduceFlat(std::vector<uint64_t> const& rowGroupIndices, std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result, std::vector<uint64_t>* choices, storm::storage::BitVector const* dirOverride) const {
+        Compare compare;
+
+        // Raw csr arrays of the gmm matrix: row offsets, column indices and values.
+        auto const& rowOffsets = gmmMatrix->jc;
+        auto const& columns = gmmMatrix->ir;
+        auto const& values = gmmMatrix->pr;
+
+        // Variables for correctly tracking choices (only update if new choice is strictly better).
+        ValueType oldSelectedChoiceValue;
+        uint64_t selectedChoice;
+
+        uint64_t numGroups = rowGroupIndices.size() - 1;
+        for (uint64_t group = 0; group < numGroups; ++group) {
+            uint64_t rowBegin = rowGroupIndices[group];
+            uint64_t rowEnd = rowGroupIndices[group + 1];
+
+            // Only multiply and reduce if the row group is not empty.
+            if (rowBegin == rowEnd) {
+                continue;
+            }
+
+            bool flipDir = false;
+            if (directionOverridden) {
+                flipDir = dirOverride->get(group);
+            }
+
+            ValueType currentValue = storm::utility::zero<ValueType>();
+            selectedChoice = 0;
+            for (uint64_t row = rowBegin; row < rowEnd; ++row) {
+                ValueType newValue = b ? (*b)[row] : storm::utility::zero<ValueType>();
+                // The contiguous dot product the compiler is expected to vectorize.
+                for (uint64_t entry = rowOffsets[row]; entry < rowOffsets[row + 1]; ++entry) {
+                    newValue += values[entry] * x[columns[entry]];
+                }
+
+                if (choices && row == rowBegin + (*choices)[group]) {
+                    oldSelectedChoiceValue = newValue;
+                }
+
+                if (row == rowBegin || (flipDir ? compare(currentValue, newValue) : compare(newValue, currentValue))) {
+                    currentValue = newValue;
+                    selectedChoice = row - rowBegin;
+                }
+            }
+
+            result[group] = currentValue;
+            if (choices && (flipDir ? compare(oldSelectedChoiceValue, currentValue) : compare(currentValue, oldSelectedChoiceValue))) {
+                (*choices)[group] = selectedChoice;
+            }
+        }
+    }
+
+    template<>
+    template<typename Compare, bool directionOverridden>
+    void GmmxxMultiplier<storm::RationalFunction>::multAddReduceFlat(std::vector<uint64_t> const& rowGroupIndices, std::vector<storm::RationalFunction> const& x, std::vector<storm::RationalFunction> const* b, std::vector<storm::RationalFunction>& result, std::vector<uint64_t>* choices, storm::storage::BitVector const* dirOverride) const {
+        STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Operation not supported for this data type.");
+    }
+
     template<>
     template<typename Compare, bool backwards, bool directionOverridden>
     void GmmxxMultiplier<storm::RationalFunction>::multAddReduceHelper(std::vector<uint64_t> const& rowGroupIndices, std::vector<storm::RationalFunction> const& x, std::vector<storm::RationalFunction> const* b, std::vector<storm::RationalFunction>& result, std::vector<uint64_t>* choices, storm::storage::BitVector const* dirOverride) const {
@@ -306,12 +449,12 @@ namespace synthesis {
 #ifdef STORM_HAVE_INTELTBB
         if (b) {
             if (b == &result) {
-                gmm::mult_add_parallel(gmmMatrix, x, result);
+                gmm::mult_add_parallel(*gmmMatrix, x, result);
             } else {
-                gmm::mult_add_parallel(gmmMatrix, x, *b, result);
+                gmm::mult_add_parallel(*gmmMatrix, x, *b, result);
             }
         } else {
-            gmm::mult_parallel(gmmMatrix, x, result);
+            gmm::mult_parallel(*gmmMatrix, x, result);
         }
 #else
         STORM_LOG_WARN("Storm was built without support for Intel TBB, defaulting to sequential version.");
@@ -430,9 +573,9 @@ namespace synthesis {
     void GmmxxMultiplier<ValueType>::multAddReduceParallel(storm::solver::OptimizationDirection const& dir, std::vector<uint64_t> const& rowGroupIndices, std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result, std::vector<uint64_t>* choices, storm::storage::BitVector const* dirOverride) const {
 #ifdef STORM_HAVE_INTELTBB
         if (dir == storm::OptimizationDirection::Minimize) {
-            tbb::parallel_for(tbb::blocked_range<unsigned long>(0, rowGroupIndices.size() - 1, 100), TbbMultAddReduceFunctor<ValueType, storm::utility::ElementLess<ValueType>>(rowGroupIndices, this->gmmMatrix, x, b, result, choices, dirOverride));
+            tbb::parallel_for(tbb::blocked_range<unsigned long>(0, rowGroupIndices.size() - 1, 100), TbbMultAddReduceFunctor<ValueType, storm::utility::ElementLess<ValueType>>(rowGroupIndices, *this->gmmMatrix, x, b, result, choices, dirOverride));
         } else {
-            tbb::parallel_for(tbb::blocked_range<unsigned long>(0, rowGroupIndices.size() - 1, 100), TbbMultAddReduceFunctor<ValueType, storm::utility::ElementGreater<ValueType>>(rowGroupIndices, this->gmmMatrix, x, b, result, choices, dirOverride));
+            tbb::parallel_for(tbb::blocked_range<unsigned long>(0, rowGroupIndices.size() - 1, 100), TbbMultAddReduceFunctor<ValueType, storm::utility::ElementGreater<ValueType>>(rowGroupIndices, *this->gmmMatrix, x, b, result, choices, dirOverride));
         }
 #else
         STORM_LOG_WARN("Storm was built without support for Intel TBB, defaulting to sequential version.");
@@ -6,6 +6,8 @@
 
 #include "Multiplier.h"
 
+#include <memory>
+
 #include <storm/environment/Environment.h>
 #include <storm/storage/BitVector.h>
 #include <storm/storage/SparseMatrix.h>
@@ -39,7 +41,18 @@ namespace synthesis {
         template<typename Compare, bool backwards = true, bool directionOverridden = false>
         void multAddReduceHelper(std::vector<uint64_t> const& rowGroupIndices, std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result, std::vector<uint64_t>* choices = nullptr, storm::storage::BitVector const* dirOverride = nullptr) const;
 
-        mutable gmm::csr_matrix<ValueType> gmmMatrix;
+        /*!
+            * Forward multiply+reduce kernel operating on the raw csr arrays of the gmm matrix.
+            * The contiguous index-based loops (instead of the iterator chains of the generic
+            * helper) let the compiler unroll and vectorize the dot products with gather loads
+            * on targets that support them.
+            */
+        template<typename Compare, bool directionOverridden = false>
+        void multAddReduceFlat(std::vector<uint64_t> const& rowGroupIndices, std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result, std::vector<uint64_t>* choices = nullptr, storm::storage::BitVector const* dirOverride = nullptr) const;
+
+        // converted matrix, shared with the process-wide conversion cache: multipliers for
+        // matrices whose content was converted before reuse the conversion
+        mutable std::shared_ptr<gmm::csr_matrix<ValueType> const> gmmMatrix;
     };
 
 }
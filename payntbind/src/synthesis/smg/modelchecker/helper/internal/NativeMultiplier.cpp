@@ -8,6 +8,11 @@
 #include <storm/storage/SparseMatrix.h>
 #include <storm/utility/macros.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <type_traits>
+
 namespace synthesis {
 
     std::vector<storm::storage::sparse::state_type> getMatrixRowIndications(storm::storage::SparseMatrix<double> const& matrix) {
@@ -239,6 +244,151 @@ namespace synthesis {
     }
 
 
+    // multiplyAndReduce over a single row group, with the reduction direction fixed at compile time
+    template<typename Compare, bool flipDir>
+    void multiplyAndReduceGroup(storm::storage::SparseMatrix<double> const& matrix, std::vector<uint64_t> const& rowGroupIndices, std::vector<double> const& vector, std::vector<double> const* summand, std::vector<double>& result, std::vector<uint_fast64_t>* choices, uint64_t group) {
+        Compare compare;
+
+        uint64_t rowBegin = rowGroupIndices[group];
+        uint64_t rowEnd = rowGroupIndices[group + 1];
+
+        // Only multiply and reduce if there is at least one row in the group.
+        if (rowBegin >= rowEnd) {
+            return;
+        }
+
+        // Variables for correctly tracking choices (only update if new choice is strictly better).
+        double oldSelectedChoiceValue;
+        uint64_t selectedChoice = 0;
+
+        double currentValue = storm::utility::zero<double>();
+        for (uint64_t row = rowBegin; row < rowEnd; ++row) {
+            double newValue = summand ? (*summand)[row] : storm::utility::zero<double>();
+            for (auto const& entry : matrix.getRow(row)) {
+                newValue += entry.getValue() * vector[entry.getColumn()];
+            }
+            if (choices && row == rowBegin + (*choices)[group]) {
+                oldSelectedChoiceValue = newValue;
+            }
+            if (row == rowBegin || (flipDir ? compare(currentValue, newValue) : compare(newValue, currentValue))) {
+                currentValue = newValue;
+                selectedChoice = row - rowBegin;
+            }
+        }
+        result[group] = currentValue;
+        if (choices && (flipDir ? compare(oldSelectedChoiceValue, currentValue) : compare(currentValue, oldSelectedChoiceValue))) {
+            (*choices)[group] = selectedChoice;
+        }
+    }
+
+    // multiplyAndReduce over the row-group range [groupBegin,groupEnd): instead of testing the
+    // coalition bit vector in every group, the range is swept twice along the coalition
+    // partition - own-direction groups first, flipped groups second - so each sweep runs with
+    // the direction known at compile time and the inner loop free of the membership branch
+    template<typename Compare>
+    void multiplyAndReduceRange(storm::storage::SparseMatrix<double> const& matrix, std::vector<uint64_t> const& rowGroupIndices, std::vector<double> const& vector, std::vector<double> const* summand, std::vector<double>& result, std::vector<uint_fast64_t>* choices, storm::storage::BitVector const* dirOverride, uint64_t groupBegin, uint64_t groupEnd) {
+        for (uint64_t group = dirOverride->getNextUnsetIndex(groupBegin); group < groupEnd; group = dirOverride->getNextUnsetIndex(group + 1)) {
+            multiplyAndReduceGroup<Compare, false>(matrix, rowGroupIndices, vector, summand, result, choices, group);
+        }
+        for (uint64_t group = dirOverride->getNextSetIndex(groupBegin); group < groupEnd; group = dirOverride->getNextSetIndex(group + 1)) {
+            multiplyAndReduceGroup<Compare, true>(matrix, rowGroupIndices, vector, summand, result, choices, group);
+        }
+    }
+
+    // below this many non-zero entries the thread fan-out does not pay off
+    const uint64_t MULTIPLY_PARALLEL_THRESHOLD = 1ull << 16;
+
+    // number of multiply workers: the hardware concurrency, unless overridden through the
+    // PAYNT_MULTIPLY_WORKERS environment variable (topology knob for multi-socket hosts
+    // where a worker per core of one socket can beat spanning both)
+    uint64_t getNumMultiplyWorkers() {
+        static uint64_t numWorkers = [] {
+            if (const char* overrideValue = std::getenv("PAYNT_MULTIPLY_WORKERS")) {
+                uint64_t parsed = std::strtoull(overrideValue, nullptr, 10);
+                if (parsed > 0) {
+                    return parsed;
+                }
+            }
+            uint64_t detected = std::thread::hardware_concurrency();
+            return detected > 0 ? detected : (uint64_t)1;
+        }();
+        return numWorkers;
+    }
+
+    // split the row groups into contiguous ranges of roughly equal non-zero count; the
+    // partition is deterministic for a given matrix, so every worker revisits the same
+    // rows in every sweep and, together with first-touch placement of the iteration
+    // vectors, keeps its working set on the local memory node of a multi-socket host
+    std::vector<uint64_t> computeWorkerPartition(storm::storage::SparseMatrix<double> const& matrix, std::vector<uint64_t> const& rowGroupIndices, uint64_t numWorkers) {
+        uint64_t numGroups = rowGroupIndices.size() - 1;
+        std::vector<uint64_t> partition;
+        partition.reserve(numWorkers + 1);
+        partition.push_back(0);
+        uint64_t entriesPerWorker = (matrix.getNonzeroEntryCount() + numWorkers - 1) / numWorkers;
+        uint64_t entriesAssigned = 0;
+        for (uint64_t group = 0; group < numGroups && partition.size() < numWorkers; ++group) {
+            for (uint64_t row = rowGroupIndices[group]; row < rowGroupIndices[group + 1]; ++row) {
+                entriesAssigned += matrix.getRow(row).getNumberOfEntries();
+            }
+            if (entriesAssigned >= partition.size() * entriesPerWorker) {
+                partition.push_back(group + 1);
+            }
+        }
+        while (partition.size() < numWorkers + 1) {
+            partition.push_back(numGroups);
+        }
+        return partition;
+    }
+
+    // allocate a zeroed iteration vector whose pages are distributed along the worker
+    // partition: reserve only maps the address space, each worker then faults in the pages
+    // of its own range, and under the first-touch policy of the OS that fixes the page on
+    // the worker's memory node - the final resize rewrites memory whose placement is
+    // already decided
+    std::vector<double> allocateIterationVector(storm::storage::SparseMatrix<double> const& matrix, std::vector<uint64_t> const& rowGroupIndices, uint64_t size) {
+        uint64_t numWorkers = getNumMultiplyWorkers();
+        if (numWorkers <= 1 || matrix.getNonzeroEntryCount() < MULTIPLY_PARALLEL_THRESHOLD) {
+            return std::vector<double>(size);
+        }
+        auto partition = computeWorkerPartition(matrix, rowGroupIndices, numWorkers);
+        std::vector<double> vector;
+        vector.reserve(size);
+        double* data = vector.data();
+        std::vector<std::thread> threads;
+        for (uint64_t worker = 1; worker < numWorkers; ++worker) {
+            uint64_t begin = std::min(partition[worker], size);
+            uint64_t end = std::min(partition[worker + 1], size);
+            threads.emplace_back([data, begin, end] {
+                std::fill(data + begin, data + end, 0.0);
+            });
+        }
+        std::fill(data + partition[0], data + std::min(partition[1], size), 0.0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        vector.resize(size);
+        return vector;
+    }
+
+    // portable parallel multiplyAndReduce: row groups are independent, so the group range is
+    // partitioned among workers and each worker writes its own result and choice entries
+    template<typename Compare>
+    void multiplyAndReduceParallel(storm::storage::SparseMatrix<double> const& matrix, std::vector<uint64_t> const& rowGroupIndices, std::vector<double> const& vector, std::vector<double> const* summand, std::vector<double>& result, std::vector<uint_fast64_t>* choices, storm::storage::BitVector const* dirOverride, std::vector<uint64_t> const& partition) {
+        uint64_t numWorkers = partition.size() - 1;
+        std::vector<std::thread> threads;
+        for (uint64_t worker = 1; worker < numWorkers; ++worker) {
+            threads.emplace_back(
+                multiplyAndReduceRange<Compare>,
+                std::cref(matrix), std::cref(rowGroupIndices), std::cref(vector), summand,
+                std::ref(result), choices, dirOverride, partition[worker], partition[worker + 1]
+            );
+        }
+        multiplyAndReduceRange<Compare>(matrix, rowGroupIndices, vector, summand, result, choices, dirOverride, partition[0], partition[1]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
     void multiplyAndReduce(storm::storage::SparseMatrix<double> const& matrix, storm::solver::OptimizationDirection const& dir, std::vector<uint64_t> const& rowGroupIndices, std::vector<double> const& vector, std::vector<double> const* summand, std::vector<double>& result, std::vector<uint_fast64_t>* choices, storm::storage::BitVector const* dirOverride) {
 
         // If the vector and the result are aliases, we need and temporary vector.
@@ -246,12 +396,33 @@ namespace synthesis {
         std::vector<double> temporary;
         if (&vector == &result) {
             STORM_LOG_WARN("Vectors are aliased but are not allowed to be. Using temporary, which is potentially slow.");
-            temporary = std::vector<double>(vector.size());
+            temporary = synthesis::allocateIterationVector(matrix, rowGroupIndices, vector.size());
             target = &temporary;
         } else {
             target = &result;
         }
-        synthesis::multiplyAndReduceForward(matrix, dir, rowGroupIndices, vector, summand, *target, choices, dirOverride);
+
+        uint64_t numWorkers = getNumMultiplyWorkers();
+        if (dirOverride && !dirOverride->empty()) {
+            if (numWorkers > 1 && matrix.getNonzeroEntryCount() >= MULTIPLY_PARALLEL_THRESHOLD) {
+                auto partition = computeWorkerPartition(matrix, rowGroupIndices, numWorkers);
+                if (dir == storm::OptimizationDirection::Minimize) {
+                    synthesis::multiplyAndReduceParallel<storm::utility::ElementLess<double>>(matrix, rowGroupIndices, vector, summand, *target, choices, dirOverride, partition);
+                } else {
+                    synthesis::multiplyAndReduceParallel<storm::utility::ElementGreater<double>>(matrix, rowGroupIndices, vector, summand, *target, choices, dirOverride, partition);
+                }
+            } else {
+                // vector and result never alias here, so the partitioned sweep order is safe
+                uint64_t numGroups = rowGroupIndices.size() - 1;
+                if (dir == storm::OptimizationDirection::Minimize) {
+                    synthesis::multiplyAndReduceRange<storm::utility::ElementLess<double>>(matrix, rowGroupIndices, vector, summand, *target, choices, dirOverride, 0, numGroups);
+                } else {
+                    synthesis::multiplyAndReduceRange<storm::utility::ElementGreater<double>>(matrix, rowGroupIndices, vector, summand, *target, choices, dirOverride, 0, numGroups);
+                }
+            }
+        } else {
+            synthesis::multiplyAndReduceForward(matrix, dir, rowGroupIndices, vector, summand, *target, choices, dirOverride);
+        }
 
         if (target == &temporary) {
             std::swap(temporary, result);
@@ -311,7 +482,13 @@ namespace synthesis {
             if (this->cachedVector) {
                 this->cachedVector->resize(x.size());
             } else {
-                this->cachedVector = std::make_unique<std::vector<ValueType>>(x.size());
+                if constexpr (std::is_same<ValueType,double>::value) {
+                    // the cached vector is rewritten by the worker partition in every sweep,
+                    // so place its pages there from the start
+                    this->cachedVector = std::make_unique<std::vector<ValueType>>(synthesis::allocateIterationVector(this->matrix, rowGroupIndices, x.size()));
+                } else {
+                    this->cachedVector = std::make_unique<std::vector<ValueType>>(x.size());
+                }
             }
             target = this->cachedVector.get();
         }
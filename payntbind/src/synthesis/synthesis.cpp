@@ -10,6 +10,8 @@ void define_synthesis(py::module& m) {
     bindings_pomdp_family(m);
 
     bindings_coloring(m);
+    bindings_synthesizer(m);
+    bindings_checkpoint(m);
 
     #ifndef DISABLE_SMG
     bindings_smg(m);
@@ -13,5 +13,7 @@ void bindings_pomdp_family(py::module &m);
 void bindings_posmg(py::module &m);
 
 void bindings_coloring(py::module &m);
+void bindings_synthesizer(py::module &m);
+void bindings_checkpoint(py::module &m);
 
 void bindings_smg(py::module &m);
@@ -0,0 +1,450 @@
+#include "SynthesizerArCore.h"
+
+#include "src/synthesis/BitVectorPool.h"
+#include "src/synthesis/verification/MdpModelChecker.h"
+
+#include <storm/adapters/RationalNumberAdapter.h>
+#include <storm/exceptions/NotSupportedException.h>
+#include <storm/exceptions/WrongFormatException.h>
+#include <storm/environment/solver/MinMaxSolverEnvironment.h>
+#include <storm/utility/constants.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <thread>
+
+namespace synthesis {
+
+template<typename ValueType>
+const uint64_t SynthesizerArCore<ValueType>::NO_PARENT_CHECK = std::numeric_limits<uint64_t>::max();
+
+template<typename ValueType>
+SynthesizerArCore<ValueType>::SynthesizerArCore(
+    std::shared_ptr<storm::models::sparse::Mdp<ValueType>> quotient_mdp,
+    Coloring const& coloring,
+    std::shared_ptr<storm::logic::Formula const> formula
+) : quotient_mdp(quotient_mdp), coloring(coloring), formula(formula) {
+    storm::Environment env;
+    parseRestrictedCheckingFormula<ValueType>(
+        env, quotient_mdp, *formula, minimize, target_states, constraint_states
+    );
+    initial_state = *quotient_mdp->getInitialStates().begin();
+}
+
+template<typename ValueType>
+void SynthesizerArCore<ValueType>::pushFamily(Family const& family) {
+    families.push_back(family);
+    family_parent_check.push_back(NO_PARENT_CHECK);
+    family_choice_mask.emplace_back();
+}
+
+template<typename ValueType>
+uint64_t SynthesizerArCore<ValueType>::queueSize() const {
+    return families.size() + num_spilled_families;
+}
+
+template<typename ValueType>
+uint64_t SynthesizerArCore<ValueType>::numIterations() const {
+    return num_iterations;
+}
+
+template<typename ValueType>
+uint64_t SynthesizerArCore<ValueType>::numParentCheckReuses() const {
+    return num_parent_check_reuses;
+}
+
+template<typename ValueType>
+void SynthesizerArCore<ValueType>::releaseParentCheck(uint64_t record) {
+    if(record == NO_PARENT_CHECK) {
+        return;
+    }
+    if(--parent_checks[record].num_children == 0) {
+        free_parent_checks.push_back(record);
+    }
+}
+
+template<typename ValueType>
+void SynthesizerArCore<ValueType>::setOptimum(ValueType optimum) {
+    this->optimum = optimum;
+    this->optimum_set = true;
+}
+
+template<typename ValueType>
+void SynthesizerArCore<ValueType>::setPrefetchWorkers(uint64_t num_workers) {
+    prefetch_workers = num_workers;
+}
+
+template<typename ValueType>
+void SynthesizerArCore<ValueType>::setMemoryBudget(uint64_t max_resident_families, std::string const& spill_path) {
+    STORM_LOG_THROW(
+        max_resident_families == 0 or not spill_path.empty(),
+        storm::exceptions::WrongFormatException, "a spill path is required to enable the memory budget"
+    );
+    this->max_resident_families = max_resident_families;
+    this->spill_path = spill_path;
+}
+
+template<typename ValueType>
+uint64_t SynthesizerArCore<ValueType>::numSpilledFamilies() const {
+    return num_spilled_families;
+}
+
+template<typename ValueType>
+void SynthesizerArCore<ValueType>::spillColdFamilies() {
+    uint64_t count = families.size()/2;
+    if(count == 0) {
+        return;
+    }
+    if(spill_file_end == 0) {
+        // create (or reset) the spill file
+        std::ofstream(spill_path, std::ios::binary | std::ios::trunc);
+    }
+    std::fstream out(spill_path, std::ios::binary | std::ios::in | std::ios::out);
+    STORM_LOG_THROW(out.good(), storm::exceptions::WrongFormatException, "cannot open spill file " << spill_path);
+    out.seekp(spill_file_end);
+    SpilledBlock block;
+    block.file_offset = spill_file_end;
+    block.num_families = count;
+    block.parent_check.assign(family_parent_check.begin(),family_parent_check.begin()+count);
+    uint64_t num_holes = coloring.getFamily().numHoles();
+    for(uint64_t index = 0; index < count; ++index) {
+        for(uint64_t hole = 0; hole < num_holes; ++hole) {
+            auto const& options = families[index].holeOptions(hole);
+            uint64_t num_options = options.size();
+            out.write(reinterpret_cast<char const*>(&num_options),sizeof(num_options));
+            out.write(reinterpret_cast<char const*>(options.data()),num_options*sizeof(uint64_t));
+        }
+    }
+    STORM_LOG_THROW(out.good(), storm::exceptions::WrongFormatException, "failed to write spill file " << spill_path);
+    spill_file_end = out.tellp();
+    families.erase(families.begin(),families.begin()+count);
+    family_parent_check.erase(family_parent_check.begin(),family_parent_check.begin()+count);
+    family_choice_mask.erase(family_choice_mask.begin(),family_choice_mask.begin()+count);
+    num_spilled_families += count;
+    spilled_blocks.push_back(std::move(block));
+}
+
+template<typename ValueType>
+void SynthesizerArCore<ValueType>::restoreSpilledBlock() {
+    STORM_LOG_ASSERT(families.empty() and not spilled_blocks.empty(), "expected an empty queue and a spilled block");
+    auto block = std::move(spilled_blocks.back());
+    spilled_blocks.pop_back();
+    std::ifstream in(spill_path, std::ios::binary);
+    STORM_LOG_THROW(in.good(), storm::exceptions::WrongFormatException, "cannot open spill file " << spill_path);
+    in.seekg(block.file_offset);
+    uint64_t num_holes = coloring.getFamily().numHoles();
+    std::vector<uint64_t> options;
+    for(uint64_t index = 0; index < block.num_families; ++index) {
+        Family family(coloring.getFamily());
+        for(uint64_t hole = 0; hole < num_holes; ++hole) {
+            uint64_t num_options;
+            in.read(reinterpret_cast<char*>(&num_options),sizeof(num_options));
+            options.resize(num_options);
+            in.read(reinterpret_cast<char*>(options.data()),num_options*sizeof(uint64_t));
+            family.holeSetOptions(hole,options);
+        }
+        families.push_back(std::move(family));
+        family_parent_check.push_back(block.parent_check[index]);
+        family_choice_mask.emplace_back();
+    }
+    STORM_LOG_THROW(in.good(), storm::exceptions::WrongFormatException, "spill file " << spill_path << " is truncated");
+    // the restored block was the end of the live data: the file shrinks back
+    spill_file_end = block.file_offset;
+    num_spilled_families -= block.num_families;
+}
+
+template<typename ValueType>
+BitVector SynthesizerArCore<ValueType>::collectSchedulerChoices(
+    BitVector const& choice_mask, std::vector<ValueType> const& state_values
+) const {
+    auto const& matrix = quotient_mdp->getTransitionMatrix();
+    auto const& row_group_indices = matrix.getRowGroupIndices();
+    BitVector scheduler_choices(matrix.getRowCount(),false);
+    BitVector state_visited(matrix.getRowGroupCount(),false);
+    state_visited.set(initial_state,true);
+    std::queue<uint64_t> state_queue;
+    state_queue.push(initial_state);
+    while(not state_queue.empty()) {
+        auto state = state_queue.front();
+        state_queue.pop();
+        // greedily pick the best enabled row
+        uint64_t best_row = row_group_indices[state+1];
+        ValueType best_value = storm::utility::zero<ValueType>();
+        for(uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+            if(not choice_mask.get(row)) {
+                continue;
+            }
+            ValueType value = storm::utility::zero<ValueType>();
+            for(auto const& entry: matrix.getRow(row)) {
+                value += entry.getValue() * state_values[entry.getColumn()];
+            }
+            if(best_row == row_group_indices[state+1] or (minimize ? value < best_value : value > best_value)) {
+                best_row = row;
+                best_value = value;
+            }
+        }
+        if(best_row == row_group_indices[state+1]) {
+            // no enabled choice: the state is a dead end of the restriction
+            continue;
+        }
+        scheduler_choices.set(best_row,true);
+        for(auto const& entry: matrix.getRow(best_row)) {
+            auto dst = entry.getColumn();
+            if(not state_visited.get(dst)) {
+                state_visited.set(dst,true);
+                state_queue.push(dst);
+            }
+        }
+    }
+    return scheduler_choices;
+}
+
+template<typename ValueType>
+bool SynthesizerArCore<ValueType>::run(storm::Environment const& env, uint64_t iteration_budget) {
+    ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+    uint64_t max_vi_iterations = env.solver().minMax().getMaximalNumberOfIterations();
+    auto const& matrix = quotient_mdp->getTransitionMatrix();
+    for(uint64_t iteration = 0; iteration < iteration_budget and (not families.empty() or not spilled_blocks.empty()); ++iteration) {
+        if(families.empty()) {
+            restoreSpilledBlock();
+        }
+        Family family = std::move(families.back());
+        families.pop_back();
+        uint64_t parent_check = family_parent_check.back();
+        family_parent_check.pop_back();
+        BitVector prefetched_mask = std::move(family_choice_mask.back());
+        family_choice_mask.pop_back();
+        num_iterations += 1;
+
+        if(prefetched_mask.size() == matrix.getRowCount()) {
+            choice_mask_buffer = std::move(prefetched_mask);
+        } else {
+            if(choice_mask_buffer.size() != matrix.getRowCount()) {
+                choice_mask_buffer = storm::storage::BitVector(matrix.getRowCount(),false);
+            }
+            coloring.selectCompatibleChoices(family,choice_mask_buffer);
+        }
+        auto const& choice_mask = choice_mask_buffer;
+
+        if(parent_check != NO_PARENT_CHECK and parent_checks[parent_check].choice_mask == choice_mask) {
+            // restricting the family did not restrict the quotient: the parent's check would be
+            // reproduced verbatim, so replay its bound and (inconsistent) scheduler instead
+            num_parent_check_reuses += 1;
+            auto const& record = parent_checks[parent_check];
+            if(optimum_set and (minimize ? record.bound >= optimum : record.bound <= optimum)) {
+                releaseParentCheck(parent_check);
+                continue;
+            }
+            auto [splitter,suboptions] = coloring.scoreSplitCandidates(family,record.scheduler_choices);
+            // the children inherit the parent record of this family
+            parent_checks[parent_check].num_children += suboptions.size();
+            for(auto const& options: suboptions) {
+                Family subfamily(family);
+                subfamily.holeSetOptions(splitter,options);
+                families.push_back(std::move(subfamily));
+                family_parent_check.push_back(parent_check);
+                family_choice_mask.emplace_back();
+            }
+            releaseParentCheck(parent_check);
+            if(max_resident_families != 0 and families.size() > max_resident_families) {
+                spillColdFamilies();
+            }
+            continue;
+        }
+        releaseParentCheck(parent_check);
+
+        // while this family is being checked, background workers compute the restrictions of
+        // the upcoming families from the top of the queue; the queue is not mutated until the
+        // workers are joined, and each worker writes only its own mask slot
+        std::vector<std::thread> prefetchers;
+        if(prefetch_workers > 0) {
+            uint64_t num_prefetch = std::min<uint64_t>(prefetch_workers,families.size());
+            for(uint64_t offset = 0; offset < num_prefetch; ++offset) {
+                uint64_t index = families.size()-1-offset;
+                if(family_choice_mask[index].size() != 0) {
+                    continue;
+                }
+                prefetchers.emplace_back([this,index,&matrix]() {
+                    BitVector mask(matrix.getRowCount(),false);
+                    coloring.selectCompatibleChoices(families[index],mask);
+                    family_choice_mask[index] = std::move(mask);
+                });
+            }
+        }
+
+        std::vector<ValueType> state_values;
+        bool pruned = false;
+        if(optimum_set) {
+            // only the side of the optimum matters here, so run interval iteration that
+            // exits as soon as the initial-state interval clears it
+            auto [values,decided] = restrictedValueIterationThreshold<ValueType>(
+                matrix, choice_mask, target_states, constraint_states, minimize,
+                precision, max_vi_iterations, optimum, not minimize, initial_state
+            );
+            // the bound provably cannot beat the best known value: prune
+            pruned = decided;
+            if(not pruned) {
+                state_values = std::move(values);
+            }
+        } else {
+            state_values = restrictedValueIteration<ValueType>(
+                matrix, choice_mask, target_states, constraint_states, minimize, precision, max_vi_iterations
+            );
+        }
+        for(auto& prefetcher: prefetchers) {
+            prefetcher.join();
+        }
+        if(pruned) {
+            continue;
+        }
+        ValueType bound = state_values[initial_state];
+        if(optimum_set and (minimize ? bound >= optimum : bound <= optimum)) {
+            // the bound cannot beat the best known value: prune
+            continue;
+        }
+
+        auto scheduler_choices = collectSchedulerChoices(choice_mask,state_values);
+        auto selection = coloring.collectHoleOptions(scheduler_choices);
+        bool consistent = true;
+        for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+            if(selection[hole].size() > 1) {
+                consistent = false;
+                break;
+            }
+        }
+        if(consistent) {
+            // a hole not involved in the selection can be fixed to an arbitrary option
+            for(uint64_t hole = 0; hole < family.numHoles(); ++hole) {
+                if(selection[hole].empty()) {
+                    selection[hole].push_back(family.holeOptions(hole)[0]);
+                }
+            }
+            candidate_family = std::move(family);
+            candidate_selection = std::move(selection);
+            candidate_value = bound;
+            return true;
+        }
+
+        // undecided: split on the most inconsistent hole and record the check for the children
+        auto [splitter,suboptions] = coloring.scoreSplitCandidates(family,scheduler_choices);
+        uint64_t record;
+        if(free_parent_checks.empty()) {
+            record = parent_checks.size();
+            parent_checks.emplace_back();
+        } else {
+            record = free_parent_checks.back();
+            free_parent_checks.pop_back();
+        }
+        parent_checks[record].choice_mask = choice_mask;
+        parent_checks[record].bound = bound;
+        parent_checks[record].scheduler_choices = std::move(scheduler_choices);
+        parent_checks[record].num_children = suboptions.size();
+        for(auto const& options: suboptions) {
+            Family subfamily(family);
+            subfamily.holeSetOptions(splitter,options);
+            families.push_back(std::move(subfamily));
+            family_parent_check.push_back(record);
+            family_choice_mask.emplace_back();
+        }
+        if(max_resident_families != 0 and families.size() > max_resident_families) {
+            spillColdFamilies();
+        }
+    }
+    return false;
+}
+
+template<typename ValueType>
+Family const& SynthesizerArCore<ValueType>::candidateFamily() const {
+    return candidate_family;
+}
+
+template<typename ValueType>
+std::vector<std::vector<uint64_t>> const& SynthesizerArCore<ValueType>::candidateSelection() const {
+    return candidate_selection;
+}
+
+template<typename ValueType>
+ValueType SynthesizerArCore<ValueType>::candidateValue() const {
+    return candidate_value;
+}
+
+template<typename ValueType>
+std::vector<ValueType> verifyAssignmentBlock(
+    storm::Environment const& env,
+    std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+    Coloring const& coloring,
+    std::vector<uint64_t> const& assignment_block,
+    std::shared_ptr<storm::logic::Formula const> formula
+) {
+    uint64_t num_holes = coloring.getFamily().numHoles();
+    STORM_LOG_THROW(
+        num_holes > 0 and assignment_block.size() % num_holes == 0,
+        storm::exceptions::NotSupportedException, "expected a block of full hole assignments"
+    );
+    uint64_t num_assignments = assignment_block.size() / num_holes;
+
+    bool minimize;
+    storm::storage::BitVector target_states, constraint_states;
+    parseRestrictedCheckingFormula<ValueType>(
+        env, quotient_mdp, *formula, minimize, target_states, constraint_states
+    );
+    ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+    uint64_t max_vi_iterations = env.solver().minMax().getMaximalNumberOfIterations();
+    auto const& matrix = quotient_mdp->getTransitionMatrix();
+    uint64_t initial_state = *quotient_mdp->getInitialStates().begin();
+
+    Family assignment(coloring.getFamily());
+    auto choice_mask = bitVectorPool().acquire(matrix.getRowCount());
+    std::vector<uint64_t> option(1);
+    std::vector<ValueType> values;
+    values.reserve(num_assignments);
+    for(uint64_t row = 0; row < num_assignments; ++row) {
+        uint64_t const* row_options = assignment_block.data() + row*num_holes;
+        if(row == 0) {
+            for(uint64_t hole = 0; hole < num_holes; ++hole) {
+                option[0] = row_options[hole];
+                assignment.holeSetOptions(hole,option);
+            }
+            coloring.selectCompatibleChoices(assignment,choice_mask);
+        } else {
+            // consecutive Gray-code rows differ in one hole; only its choices are re-evaluated
+            uint64_t const* previous_options = row_options - num_holes;
+            for(uint64_t hole = 0; hole < num_holes; ++hole) {
+                if(row_options[hole] == previous_options[hole]) {
+                    continue;
+                }
+                option[0] = row_options[hole];
+                assignment.holeSetOptions(hole,option);
+                coloring.updateCompatibleChoicesForHole(assignment,choice_mask,hole);
+            }
+        }
+        auto state_values = restrictedValueIteration<ValueType>(
+            matrix, choice_mask, target_states, constraint_states, minimize, precision, max_vi_iterations
+        );
+        values.push_back(state_values[initial_state]);
+    }
+    bitVectorPool().release(std::move(choice_mask));
+    return values;
+}
+
+template class SynthesizerArCore<double>;
+template class SynthesizerArCore<storm::RationalNumber>;
+
+template std::vector<double> verifyAssignmentBlock<double>(
+    storm::Environment const& env,
+    std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp,
+    Coloring const& coloring,
+    std::vector<uint64_t> const& assignment_block,
+    std::shared_ptr<storm::logic::Formula const> formula
+);
+template std::vector<storm::RationalNumber> verifyAssignmentBlock<storm::RationalNumber>(
+    storm::Environment const& env,
+    std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& quotient_mdp,
+    Coloring const& coloring,
+    std::vector<uint64_t> const& assignment_block,
+    std::shared_ptr<storm::logic::Formula const> formula
+);
+
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "src/synthesis/quotient/Coloring.h"
+#include "src/synthesis/quotient/Family.h"
+
+#include <storm/environment/Environment.h>
+#include <storm/logic/Formula.h>
+#include <storm/models/sparse/Mdp.h>
+#include <storm/storage/BitVector.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Native driver for the inner loop of abstraction refinement over a single optimizing
+ * reachability (or until) probability formula. The driver owns the family queue and runs
+ * verify-split iterations without crossing into Python: it selects the compatible choices,
+ * checks the restricted quotient, extracts the greedy scheduler, tests it for consistency
+ * and splits inconsistent families. Control returns to Python only when a consistent
+ * improving candidate is found (for the exact re-check and the optimum update), when the
+ * queue empties or when the iteration budget runs out.
+ */
+template<typename ValueType>
+class SynthesizerArCore {
+public:
+
+    SynthesizerArCore(
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> quotient_mdp,
+        Coloring const& coloring,
+        std::shared_ptr<storm::logic::Formula const> formula
+    );
+
+    /** Put a family on the queue (typically the full design space). */
+    void pushFamily(Family const& family);
+    /** Number of families awaiting exploration. */
+    uint64_t queueSize() const;
+    /** Total number of verified families so far. */
+    uint64_t numIterations() const;
+    /** Number of iterations that replayed the parent's check result (see \ref ParentCheck). */
+    uint64_t numParentCheckReuses() const;
+
+    /** Set the best known value; families whose bound cannot beat it are pruned. */
+    void setOptimum(ValueType optimum);
+
+    /**
+     * Set a residency budget for the family queue: whenever more than this many families are
+     * resident, the cold entries at the bottom of the queue are serialized to a binary spill
+     * file and restored transparently once the queue drains down to them. Long runs degrade
+     * to occasional sequential disk traffic instead of outgrowing RAM.
+     * @param max_resident_families spill threshold; 0 (the default) disables spilling
+     * @param spill_path path of the spill file, owned and overwritten by this synthesizer
+     */
+    void setMemoryBudget(uint64_t max_resident_families, std::string const& spill_path);
+    /** Number of families currently spilled to disk. */
+    uint64_t numSpilledFamilies() const;
+
+    /**
+     * Enable the restriction prefetch pipeline: while a family is being model-checked, the
+     * compatible-choice masks of up to this many families from the top of the queue are
+     * computed on background threads. Value iteration saturates only a few cores, so the
+     * remaining ones hide the restriction latency of the upcoming iterations. 0 (the
+     * default) disables prefetching.
+     */
+    void setPrefetchWorkers(uint64_t num_workers);
+
+    /**
+     * Run verify-split iterations until a candidate is found, the queue empties or the
+     * iteration budget runs out.
+     * @return true if a candidate was found (see the candidate getters)
+     */
+    bool run(storm::Environment const& env, uint64_t iteration_budget);
+
+    /** Family that produced the last candidate. */
+    Family const& candidateFamily() const;
+    /** For each hole, the options used by the candidate scheduler (exactly one per hole). */
+    std::vector<std::vector<uint64_t>> const& candidateSelection() const;
+    /** Bound of the candidate family at the initial state. */
+    ValueType candidateValue() const;
+
+private:
+
+    /** Select the greedy scheduler choices reachable from the initial state. */
+    BitVector collectSchedulerChoices(BitVector const& choice_mask, std::vector<ValueType> const& state_values) const;
+
+    /**
+     * Check result of a split family, kept alive while any of its children await exploration.
+     * A child whose compatible-choice mask equals the parent's would reproduce the exact same
+     * value iteration and greedy scheduler, so the stored bound and scheduler are replayed and
+     * the child proceeds straight to its own split.
+     */
+    struct ParentCheck {
+        /** Compatible-choice mask of the split family. */
+        BitVector choice_mask;
+        /** Bound of the split family at the initial state. */
+        ValueType bound;
+        /** Greedy scheduler choices of the split family (necessarily inconsistent). */
+        BitVector scheduler_choices;
+        /** Number of queued families still referencing this record. */
+        uint64_t num_children;
+    };
+
+    /** Decrement the reference count of the given record, recycling the slot when it drops to zero. */
+    void releaseParentCheck(uint64_t record);
+
+    /** Spill the bottom half of the resident queue to the spill file (see \ref setMemoryBudget). */
+    void spillColdFamilies();
+    /** Restore the most recently spilled block into the (empty) resident queue. */
+    void restoreSpilledBlock();
+
+    /** Bookkeeping of one block of spilled families; the hole options live in the spill file. */
+    struct SpilledBlock {
+        /** Position of the serialized block in the spill file. */
+        uint64_t file_offset;
+        /** Number of families in the block. */
+        uint64_t num_families;
+        /** Parent check records of the block's families (kept resident, they are refcounted). */
+        std::vector<uint64_t> parent_check;
+    };
+
+    std::shared_ptr<storm::models::sparse::Mdp<ValueType>> quotient_mdp;
+    Coloring const& coloring;
+    std::shared_ptr<storm::logic::Formula const> formula;
+
+    /** Whether the formula minimizes. */
+    bool minimize;
+    /** States satisfying the target subformula. */
+    BitVector target_states;
+    /** States satisfying the constraint subformula (all states for reachability). */
+    BitVector constraint_states;
+    /** The initial state of the quotient. */
+    uint64_t initial_state;
+
+    /** DFS queue of unexplored families. */
+    std::vector<Family> families;
+    /** For each queued family, the record of its parent's check, or \ref NO_PARENT_CHECK for roots. */
+    std::vector<uint64_t> family_parent_check;
+    /** For each queued family, its prefetched compatible-choice mask, or empty if not prefetched. */
+    std::vector<BitVector> family_choice_mask;
+    /** Number of prefetch workers (see \ref setPrefetchWorkers). */
+    uint64_t prefetch_workers = 0;
+    /** Residency budget of the family queue; 0 disables spilling (see \ref setMemoryBudget). */
+    uint64_t max_resident_families = 0;
+    /** Path of the spill file. */
+    std::string spill_path;
+    /** Spilled blocks, coldest first; blocks are restored in LIFO order. */
+    std::vector<SpilledBlock> spilled_blocks;
+    /** End of the live data in the spill file; restored blocks are overwritten in place. */
+    uint64_t spill_file_end = 0;
+    /** Total number of families across all spilled blocks. */
+    uint64_t num_spilled_families = 0;
+    /** Pool of parent check records; retired slots are recycled via \ref free_parent_checks. */
+    std::vector<ParentCheck> parent_checks;
+    /** Retired slots of \ref parent_checks. */
+    std::vector<uint64_t> free_parent_checks;
+    /** Marks a family without a parent record. */
+    static const uint64_t NO_PARENT_CHECK;
+    /** Compatible-choice mask reused across iterations. */
+    BitVector choice_mask_buffer;
+    /** Total number of verified families. */
+    uint64_t num_iterations = 0;
+    /** Number of iterations decided by replaying the parent's check result. */
+    uint64_t num_parent_check_reuses = 0;
+
+    /** Best known value, if any. */
+    ValueType optimum;
+    bool optimum_set = false;
+
+    Family candidate_family;
+    std::vector<std::vector<uint64_t>> candidate_selection;
+    ValueType candidate_value;
+};
+
+/**
+ * Check a block of assignments against the quotient in one native sweep. The rows are
+ * hole-option assignments as produced by \ref AssignmentEnumerator; since consecutive rows
+ * differ in one hole, the compatible-choice mask is updated per changed hole instead of being
+ * recomputed per assignment.
+ * @return the value of each assignment in the initial state
+ */
+template<typename ValueType>
+std::vector<ValueType> verifyAssignmentBlock(
+    storm::Environment const& env,
+    std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+    Coloring const& coloring,
+    std::vector<uint64_t> const& assignment_block,
+    std::shared_ptr<storm::logic::Formula const> formula
+);
+
+}
@@ -0,0 +1,50 @@
+#include "../synthesis.h"
+
+#include "SynthesizerArCore.h"
+
+#include <storm/adapters/RationalNumberAdapter.h>
+
+#include <string>
+
+template<typename ValueType>
+void bindings_synthesizer_vt(py::module& m, std::string const& vtSuffix) {
+
+    py::class_<synthesis::SynthesizerArCore<ValueType>>(m, (vtSuffix + "SynthesizerArCore").c_str())
+        .def(
+            py::init<
+                std::shared_ptr<storm::models::sparse::Mdp<ValueType>>,
+                synthesis::Coloring const&,
+                std::shared_ptr<storm::logic::Formula const>
+            >(),
+            py::arg("quotient_mdp"), py::arg("coloring"), py::arg("formula"),
+            py::keep_alive<1,3>()
+        )
+        .def("pushFamily", &synthesis::SynthesizerArCore<ValueType>::pushFamily, py::arg("family"))
+        .def("queueSize", &synthesis::SynthesizerArCore<ValueType>::queueSize)
+        .def("numIterations", &synthesis::SynthesizerArCore<ValueType>::numIterations)
+        .def("numParentCheckReuses", &synthesis::SynthesizerArCore<ValueType>::numParentCheckReuses)
+        .def("setOptimum", &synthesis::SynthesizerArCore<ValueType>::setOptimum, py::arg("optimum"))
+        .def("setPrefetchWorkers", &synthesis::SynthesizerArCore<ValueType>::setPrefetchWorkers, py::arg("num_workers"), "prefetch the restrictions of this many queued families while a family is being checked")
+        .def("setMemoryBudget", &synthesis::SynthesizerArCore<ValueType>::setMemoryBudget, py::arg("max_resident_families"), py::arg("spill_path"), "spill cold queued families to the given file whenever more than the given number are resident")
+        .def("numSpilledFamilies", &synthesis::SynthesizerArCore<ValueType>::numSpilledFamilies)
+        .def(
+            "run", &synthesis::SynthesizerArCore<ValueType>::run,
+            py::arg("env"), py::arg("iteration_budget"),
+            py::call_guard<py::gil_scoped_release>(),
+            "run verify-split iterations natively, returns true when a candidate awaits the exact re-check"
+        )
+        .def("candidateFamily", &synthesis::SynthesizerArCore<ValueType>::candidateFamily)
+        .def("candidateSelection", &synthesis::SynthesizerArCore<ValueType>::candidateSelection)
+        .def("candidateValue", &synthesis::SynthesizerArCore<ValueType>::candidateValue)
+        ;
+
+    m.def(("verifyAssignmentBlock" + vtSuffix).c_str(), &synthesis::verifyAssignmentBlock<ValueType>,
+        py::arg("env"), py::arg("quotient_mdp"), py::arg("coloring"), py::arg("assignment_block"), py::arg("formula"),
+        py::call_guard<py::gil_scoped_release>(),
+        "check a block of Gray-code-ordered assignments natively, returns the value of each in the initial state");
+}
+
+void bindings_synthesizer(py::module& m) {
+    bindings_synthesizer_vt<double>(m, "");
+    bindings_synthesizer_vt<storm::RationalNumber>(m, "Exact");
+}
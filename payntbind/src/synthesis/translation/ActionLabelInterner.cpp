@@ -0,0 +1,75 @@
+#include "ActionLabelInterner.h"
+
+#include "src/synthesis/translation/choiceTransformation.h"
+
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/utility/macros.h>
+
+namespace synthesis {
+
+ActionLabelInterner::ActionLabelInterner() {
+    // fix the ids of the synthetic labels so that id-based code can refer to them as constants
+    intern(NO_ACTION_LABEL);
+    intern(DONT_CARE_ACTION_LABEL);
+}
+
+uint64_t ActionLabelInterner::intern(std::string const& label) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = label_to_id.find(label);
+    if(it != label_to_id.end()) {
+        return it->second;
+    }
+    uint64_t id = id_to_label.size();
+    id_to_label.push_back(label);
+    label_to_id.emplace(label,id);
+    return id;
+}
+
+std::vector<uint64_t> ActionLabelInterner::intern(std::vector<std::string> const& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<uint64_t> ids;
+    ids.reserve(labels.size());
+    for(std::string const& label: labels) {
+        auto it = label_to_id.find(label);
+        if(it != label_to_id.end()) {
+            ids.push_back(it->second);
+            continue;
+        }
+        uint64_t id = id_to_label.size();
+        id_to_label.push_back(label);
+        label_to_id.emplace(label,id);
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+std::string const& ActionLabelInterner::labelOf(uint64_t id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    STORM_LOG_THROW(id < id_to_label.size(), storm::exceptions::InvalidArgumentException,
+        "action id " << id << " was never interned");
+    return id_to_label[id];
+}
+
+std::vector<std::string> ActionLabelInterner::labelsOf(std::vector<uint64_t> const& ids) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> labels;
+    labels.reserve(ids.size());
+    for(uint64_t id: ids) {
+        STORM_LOG_THROW(id < id_to_label.size(), storm::exceptions::InvalidArgumentException,
+            "action id " << id << " was never interned");
+        labels.push_back(id_to_label[id]);
+    }
+    return labels;
+}
+
+uint64_t ActionLabelInterner::numLabels() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return id_to_label.size();
+}
+
+ActionLabelInterner& actionLabelInterner() {
+    static ActionLabelInterner interner;
+    return interner;
+}
+
+}
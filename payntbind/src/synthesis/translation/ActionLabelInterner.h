@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace synthesis {
+
+// interned id of NO_ACTION_LABEL, fixed by the interner constructor
+const uint64_t NO_ACTION_ID = 0;
+// interned id of DONT_CARE_ACTION_LABEL, fixed by the interner constructor
+const uint64_t DONT_CARE_ACTION_ID = 1;
+
+/**
+ * Process-wide intern table for action labels. Action identity travels through the pipeline as
+ * strings in several places, so the same labels are compared and hashed over and over; the
+ * interner assigns each distinct label a stable integer id once and the utilities operate on
+ * ids, keeping strings only at the import and export boundaries. Ids are never recycled, so an
+ * id obtained from one model remains valid for every later model of the process. The two
+ * synthetic labels (see \ref NO_ACTION_LABEL, \ref DONT_CARE_ACTION_LABEL) are pre-interned at
+ * fixed ids.
+ */
+class ActionLabelInterner {
+public:
+
+    ActionLabelInterner();
+
+    /** Get the id of the given label, interning it first if it is new. */
+    uint64_t intern(std::string const& label);
+    /** Bulk variant of \ref intern, taking the table lock once for the whole batch. */
+    std::vector<uint64_t> intern(std::vector<std::string> const& labels);
+
+    /** Get the label of the given interned id. */
+    std::string const& labelOf(uint64_t id) const;
+    /** Bulk variant of \ref labelOf. */
+    std::vector<std::string> labelsOf(std::vector<uint64_t> const& ids) const;
+
+    /** Number of labels interned so far. */
+    uint64_t numLabels() const;
+
+protected:
+
+    mutable std::mutex mutex;
+    /** For each label, its id. */
+    std::unordered_map<std::string,uint64_t> label_to_id;
+    /** For each id, its label; a deque so that references handed out by \ref labelOf stay valid. */
+    std::deque<std::string> id_to_label;
+};
+
+/** The process-wide action-label intern table. */
+ActionLabelInterner& actionLabelInterner();
+
+}
@@ -0,0 +1,281 @@
+#include "BinaryModelExport.h"
+
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/exceptions/NotSupportedException.h>
+#include <storm/exceptions/WrongFormatException.h>
+#include <storm/models/sparse/Mdp.h>
+#include <storm/models/sparse/StandardRewardModel.h>
+#include <storm/storage/sparse/ModelComponents.h>
+#include <storm/utility/builder.h>
+#include <storm/utility/constants.h>
+#include <storm/utility/macros.h>
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace synthesis {
+
+    static const char BINARY_MODEL_MAGIC[8] = {'P','A','Y','N','T','M','D','L'};
+    static const uint64_t BINARY_MODEL_VERSION = 1;
+
+    namespace {
+
+    /** Append the 8-byte-aligned binary sections to a growing buffer. */
+    struct BufferWriter {
+
+        std::vector<char>& buffer;
+
+        void writeBytes(char const* data, uint64_t size) {
+            buffer.insert(buffer.end(), data, data+size);
+        }
+
+        void writeUint(uint64_t value) {
+            writeBytes(reinterpret_cast<char const*>(&value), sizeof(value));
+        }
+
+        void writeUintVector(std::vector<uint64_t> const& values) {
+            writeUint(values.size());
+            writeBytes(reinterpret_cast<char const*>(values.data()), values.size()*sizeof(uint64_t));
+        }
+
+        void writeDoubleVector(std::vector<double> const& values) {
+            writeUint(values.size());
+            writeBytes(reinterpret_cast<char const*>(values.data()), values.size()*sizeof(double));
+        }
+
+        /** Write a length-prefixed string padded to an 8-byte boundary. */
+        void writeString(std::string const& value) {
+            writeUint(value.size());
+            uint64_t padded_size = (value.size()+7)/8*8;
+            std::vector<char> padded(padded_size, 0);
+            std::memcpy(padded.data(), value.data(), value.size());
+            writeBytes(padded.data(), padded_size);
+        }
+
+        /** Write a bitset as raw 64-bit words. */
+        void writeBitVector(storm::storage::BitVector const& bits) {
+            std::vector<uint64_t> words((bits.size()+63)/64, 0);
+            for(uint64_t bit: bits) {
+                words[bit/64] |= (1ull << (bit%64));
+            }
+            writeUint(bits.size());
+            writeUintVector(words);
+        }
+    };
+
+    /** Read the binary sections back from a (possibly memory-mapped) buffer. */
+    struct BufferReader {
+
+        char const* data;
+        uint64_t size;
+        uint64_t pos = 0;
+
+        char const* readBytes(uint64_t num_bytes) {
+            STORM_LOG_THROW(pos+num_bytes <= size, storm::exceptions::WrongFormatException, "binary model data is truncated");
+            char const* bytes = data+pos;
+            pos += num_bytes;
+            return bytes;
+        }
+
+        uint64_t readUint() {
+            uint64_t value;
+            std::memcpy(&value, readBytes(sizeof(value)), sizeof(value));
+            return value;
+        }
+
+        std::vector<uint64_t> readUintVector() {
+            uint64_t count = readUint();
+            std::vector<uint64_t> values(count);
+            std::memcpy(values.data(), readBytes(count*sizeof(uint64_t)), count*sizeof(uint64_t));
+            return values;
+        }
+
+        std::vector<double> readDoubleVector() {
+            uint64_t count = readUint();
+            std::vector<double> values(count);
+            std::memcpy(values.data(), readBytes(count*sizeof(double)), count*sizeof(double));
+            return values;
+        }
+
+        std::string readString() {
+            uint64_t length = readUint();
+            uint64_t padded_size = (length+7)/8*8;
+            return std::string(readBytes(padded_size), length);
+        }
+
+        storm::storage::BitVector readBitVector() {
+            uint64_t num_bits = readUint();
+            auto words = readUintVector();
+            STORM_LOG_THROW(words.size() == (num_bits+63)/64, storm::exceptions::WrongFormatException, "bitset word count does not match its size");
+            storm::storage::BitVector bits(num_bits, false);
+            for(uint64_t bit = 0; bit < num_bits; ++bit) {
+                if(words[bit/64] & (1ull << (bit%64))) {
+                    bits.set(bit, true);
+                }
+            }
+            return bits;
+        }
+    };
+
+    }
+
+    template<typename ValueType>
+    std::vector<char> serializeModelBinary(storm::models::sparse::Model<ValueType> const& model) {
+        STORM_LOG_THROW((std::is_same<ValueType,double>::value), storm::exceptions::NotSupportedException, "binary export supports double-valued models only");
+        std::vector<char> buffer;
+        BufferWriter out{buffer};
+
+        auto const& matrix = model.getTransitionMatrix();
+        uint64_t num_states = model.getNumberOfStates();
+        uint64_t num_choices = model.getNumberOfChoices();
+        uint64_t num_entries = matrix.getEntryCount();
+
+        // header
+        out.writeBytes(BINARY_MODEL_MAGIC, sizeof(BINARY_MODEL_MAGIC));
+        out.writeUint(BINARY_MODEL_VERSION);
+        out.writeUint(num_states);
+        out.writeUint(num_choices);
+        out.writeUint(num_entries);
+
+        // transition matrix in CSR
+        out.writeUintVector(matrix.getRowGroupIndices());
+        std::vector<uint64_t> row_offsets;
+        row_offsets.reserve(num_choices+1);
+        std::vector<uint64_t> columns;
+        columns.reserve(num_entries);
+        std::vector<double> values;
+        values.reserve(num_entries);
+        row_offsets.push_back(0);
+        for(uint64_t choice = 0; choice < num_choices; ++choice) {
+            for(auto const& entry: matrix.getRow(choice)) {
+                columns.push_back(entry.getColumn());
+                values.push_back(storm::utility::convertNumber<double>(entry.getValue()));
+            }
+            row_offsets.push_back(columns.size());
+        }
+        out.writeUintVector(row_offsets);
+        out.writeUintVector(columns);
+        out.writeDoubleVector(values);
+
+        // state labeling
+        auto const& state_labeling = model.getStateLabeling();
+        out.writeUint(state_labeling.getNumberOfLabels());
+        for(std::string const& label: state_labeling.getLabels()) {
+            out.writeString(label);
+            out.writeBitVector(state_labeling.getStates(label));
+        }
+
+        // choice labeling
+        if(model.hasChoiceLabeling()) {
+            auto const& choice_labeling = model.getChoiceLabeling();
+            out.writeUint(choice_labeling.getNumberOfLabels());
+            for(std::string const& label: choice_labeling.getLabels()) {
+                out.writeString(label);
+                out.writeBitVector(choice_labeling.getChoices(label));
+            }
+        } else {
+            out.writeUint(0);
+        }
+
+        // reward models (state-action rewards)
+        out.writeUint(model.getRewardModels().size());
+        for(auto const& [name,reward_model]: model.getRewardModels()) {
+            out.writeString(name);
+            std::vector<double> action_rewards(num_choices, 0);
+            if(reward_model.hasStateActionRewards()) {
+                for(uint64_t choice = 0; choice < num_choices; ++choice) {
+                    action_rewards[choice] = storm::utility::convertNumber<double>(reward_model.getStateActionReward(choice));
+                }
+            }
+            out.writeDoubleVector(action_rewards);
+        }
+
+        return buffer;
+    }
+
+    std::shared_ptr<storm::models::sparse::Mdp<double>> deserializeModelBinary(char const* data, uint64_t size) {
+        BufferReader in{data,size};
+
+        // header
+        STORM_LOG_THROW(
+            std::memcmp(in.readBytes(sizeof(BINARY_MODEL_MAGIC)), BINARY_MODEL_MAGIC, sizeof(BINARY_MODEL_MAGIC)) == 0
+            and in.readUint() == BINARY_MODEL_VERSION,
+            storm::exceptions::WrongFormatException, "data is not a compatible binary model"
+        );
+        uint64_t num_states = in.readUint();
+        uint64_t num_choices = in.readUint();
+        uint64_t num_entries = in.readUint();
+
+        // transition matrix in CSR
+        auto row_group_indices = in.readUintVector();
+        auto row_offsets = in.readUintVector();
+        auto columns = in.readUintVector();
+        auto values = in.readDoubleVector();
+        STORM_LOG_THROW(
+            row_group_indices.size() == num_states+1 and row_offsets.size() == num_choices+1 and columns.size() == num_entries,
+            storm::exceptions::WrongFormatException, "matrix sections do not match the header"
+        );
+        storm::storage::SparseMatrixBuilder<double> builder(num_choices, num_states, num_entries, true, true, num_states);
+        for(uint64_t state = 0; state < num_states; ++state) {
+            builder.newRowGroup(row_group_indices[state]);
+            for(uint64_t choice = row_group_indices[state]; choice < row_group_indices[state+1]; ++choice) {
+                for(uint64_t index = row_offsets[choice]; index < row_offsets[choice+1]; ++index) {
+                    builder.addNextValue(choice, columns[index], values[index]);
+                }
+            }
+        }
+        storm::storage::sparse::ModelComponents<double> components;
+        components.transitionMatrix = builder.build();
+
+        // state labeling
+        storm::models::sparse::StateLabeling state_labeling(num_states);
+        uint64_t num_state_labels = in.readUint();
+        for(uint64_t index = 0; index < num_state_labels; ++index) {
+            auto label = in.readString();
+            state_labeling.addLabel(label, in.readBitVector());
+        }
+        components.stateLabeling = std::move(state_labeling);
+
+        // choice labeling
+        uint64_t num_choice_labels = in.readUint();
+        if(num_choice_labels > 0) {
+            storm::models::sparse::ChoiceLabeling choice_labeling(num_choices);
+            for(uint64_t index = 0; index < num_choice_labels; ++index) {
+                auto label = in.readString();
+                choice_labeling.addLabel(label, in.readBitVector());
+            }
+            components.choiceLabeling = std::move(choice_labeling);
+        }
+
+        // reward models (state-action rewards)
+        uint64_t num_reward_models = in.readUint();
+        for(uint64_t index = 0; index < num_reward_models; ++index) {
+            auto name = in.readString();
+            components.rewardModels.emplace(
+                name, storm::models::sparse::StandardRewardModel<double>(std::nullopt, in.readDoubleVector())
+            );
+        }
+
+        return std::make_shared<storm::models::sparse::Mdp<double>>(std::move(components));
+    }
+
+    template<typename ValueType>
+    void exportModelBinary(
+        storm::models::sparse::Model<ValueType> const& model,
+        std::string const& path
+    ) {
+        auto buffer = serializeModelBinary(model);
+        std::ofstream out(path, std::ios::binary);
+        STORM_LOG_THROW(out.good(), storm::exceptions::InvalidArgumentException, "cannot open " << path << " for writing");
+        out.write(buffer.data(), buffer.size());
+        STORM_LOG_THROW(out.good(), storm::exceptions::InvalidArgumentException, "writing to " << path << " failed");
+    }
+
+    template std::vector<char> serializeModelBinary<double>(
+        storm::models::sparse::Model<double> const& model);
+
+    template void exportModelBinary<double>(
+        storm::models::sparse::Model<double> const& model,
+        std::string const& path);
+}
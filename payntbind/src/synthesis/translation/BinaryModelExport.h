@@ -0,0 +1,35 @@
+#pragma once
+
+#include <storm/models/sparse/Mdp.h>
+#include <storm/models/sparse/Model.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Export a sparse model to a compact binary file, avoiding the text serialization of the DRN
+ * writer. The layout keeps every section 8-byte aligned so that a reader can memory-map the
+ * file and use the arrays in place:
+ *  - header: magic "PAYNTMDL", format version, number of states, choices and entries
+ *  - transition matrix in CSR: row group indices, row offsets, column indices, raw doubles
+ *  - state labeling and (if present) choice labeling: for each label its name and its bitset
+ *    as raw 64-bit words
+ *  - reward models: for each model its name and its state-action rewards as raw doubles
+ */
+template<typename ValueType>
+void exportModelBinary(
+    storm::models::sparse::Model<ValueType> const& model,
+    std::string const& path
+);
+
+/** Serialize a sparse model into a buffer holding the binary layout described above. */
+template<typename ValueType>
+std::vector<char> serializeModelBinary(storm::models::sparse::Model<ValueType> const& model);
+
+/** Rebuild an MDP from the binary layout described above. */
+std::shared_ptr<storm::models::sparse::Mdp<double>> deserializeModelBinary(char const* data, uint64_t size);
+
+}
@@ -1,26 +1,97 @@
 #include "ItemKeyTranslator.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace synthesis {
 
+    // 64-bit mix (splitmix64 finalizer) to spread consecutive item/key values across buckets
+    static uint64_t mixBits(uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdull;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ull;
+        value ^= value >> 33;
+        return value;
+    }
+
+    static uint64_t keyBits(uint64_t key) {
+        return key;
+    }
+
+    static uint64_t keyBits(std::pair<uint64_t,uint64_t> const& key) {
+        return mixBits(key.first) ^ key.second;
+    }
+
+    static uint64_t keyBits(std::tuple<uint64_t,uint64_t,bool> const& key) {
+        return mixBits(std::get<0>(key)) ^ mixBits(std::get<1>(key)) ^ (std::get<2>(key) ? 1 : 0);
+    }
+
+    template<typename K>
+    const uint64_t ItemKeyTranslator<K>::NO_TRANSLATION = std::numeric_limits<uint64_t>::max();
+
     template<typename K>
     ItemKeyTranslator<K>::ItemKeyTranslator() : num_items(0) {
         // left intentionally blank
     }
 
     template<typename K>
-    ItemKeyTranslator<K>::ItemKeyTranslator(uint64_t num_items) : num_items(num_items)  {
-        item_key_to_translation.resize(num_items);
+    ItemKeyTranslator<K>::ItemKeyTranslator(uint64_t num_items) : num_items(num_items) {
+        // left intentionally blank
     }
 
     template<typename K>
     void ItemKeyTranslator<K>::clear() {
-        item_key_to_translation.clear();
         translation_to_item_key.clear();
+        std::fill(buckets.begin(), buckets.end(), NO_TRANSLATION);
     }
 
     template<typename K>
     void ItemKeyTranslator<K>::resize(uint64_t num_items) {
-        item_key_to_translation.resize(num_items);
+        this->num_items = num_items;
+    }
+
+    template<typename K>
+    void ItemKeyTranslator<K>::reserve(uint64_t expected_translations) {
+        translation_to_item_key.reserve(expected_translations);
+        uint64_t new_capacity = buckets.empty() ? 64 : buckets.size();
+        while(new_capacity < 2*expected_translations) {
+            new_capacity *= 2;
+        }
+        if(new_capacity > buckets.size()) {
+            rehash(new_capacity);
+        }
+    }
+
+    template<typename K>
+    uint64_t ItemKeyTranslator<K>::bucketOf(uint64_t item, K const& key) const {
+        return mixBits(mixBits(item) ^ keyBits(key)) & (buckets.size()-1);
+    }
+
+    template<typename K>
+    uint64_t ItemKeyTranslator<K>::findBucket(uint64_t item, K const& key) const {
+        uint64_t capacity_mask = buckets.size()-1;
+        uint64_t bucket = bucketOf(item,key);
+        while(true) {
+            uint64_t translation = buckets[bucket];
+            if(translation == NO_TRANSLATION) {
+                return bucket;
+            }
+            auto const& [translated_item,translated_key] = translation_to_item_key[translation];
+            if(translated_item == item and translated_key == key) {
+                return bucket;
+            }
+            bucket = (bucket+1) & capacity_mask;
+        }
+    }
+
+    template<typename K>
+    void ItemKeyTranslator<K>::rehash(uint64_t new_capacity) {
+        buckets.assign(new_capacity, NO_TRANSLATION);
+        for(uint64_t translation = 0; translation < translation_to_item_key.size(); ++translation) {
+            auto const& [item,key] = translation_to_item_key[translation];
+            buckets[findBucket(item,key)] = translation;
+        }
     }
 
     template<typename K>
@@ -30,17 +101,26 @@ namespace synthesis {
 
     template<typename K>
     bool ItemKeyTranslator<K>::hasTranslation(uint64_t item, K key) const {
-        return item_key_to_translation[item].find(key) != item_key_to_translation[item].end();
+        if(buckets.empty()) {
+            return false;
+        }
+        return buckets[findBucket(item,key)] != NO_TRANSLATION;
     }
 
     template<typename K>
     uint64_t ItemKeyTranslator<K>::translate(uint64_t item, K key) {
-        auto new_translation = numTranslations();
-        auto const& result = item_key_to_translation[item].try_emplace(key,new_translation);
-        if(result.second) {
-            translation_to_item_key.push_back(std::make_pair(item,key));
+        // keep the load factor at one half so that probe sequences stay short
+        if(2*(numTranslations()+1) > buckets.size()) {
+            rehash(buckets.empty() ? 64 : 2*buckets.size());
+        }
+        uint64_t bucket = findBucket(item,key);
+        if(buckets[bucket] != NO_TRANSLATION) {
+            return buckets[bucket];
         }
-        return (*result.first).second;
+        uint64_t new_translation = numTranslations();
+        buckets[bucket] = new_translation;
+        translation_to_item_key.push_back(std::make_pair(item,key));
+        return new_translation;
     }
 
     template<typename K>
@@ -65,4 +145,4 @@ namespace synthesis {
     template class ItemKeyTranslator<uint64_t>;
     template class ItemKeyTranslator<std::pair<uint64_t,uint64_t>>;
     template class ItemKeyTranslator<std::tuple<uint64_t,uint64_t,bool>>;
-}
\ No newline at end of file
+}
@@ -1,29 +1,38 @@
 #pragma once
 
 #include <cstdint>
-#include <map>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 namespace synthesis {
 
+    /**
+     * Bidirectional mapping between item-key pairs and dense translation indices. The forward
+     * direction is a flat open-addressing hash table with power-of-two capacity and linear
+     * probing; the probed keys live in the contiguous translation-to-item-key vector, so
+     * translation involves no per-item node allocations or pointer chasing.
+     */
     template<typename K>
     class ItemKeyTranslator {
     public:
 
         ItemKeyTranslator();
         ItemKeyTranslator(uint64_t num_items);
+        /** Remove all translations; the table capacity is kept for reuse. */
         void clear();
         void resize(uint64_t num_items);
+        /** Pre-size the table for the expected number of translations. */
+        void reserve(uint64_t expected_translations);
 
         uint64_t numTranslations() const;
 
         /** Check if the item-key pair has a translation. */
         bool hasTranslation(uint64_t item, K key) const;
-        
+
         /** Translate an item-key pair. If the pair does not have a translation, create and remember a new one. */
         uint64_t translate(uint64_t item, K key);
-        
+
         /** Retrieve the item-key pair that has the given translation. */
         std::pair<uint64_t,K> retrieve(uint64_t translation) const;
 
@@ -35,9 +44,20 @@ namespace synthesis {
 
     private:
 
+        /** Marks an unoccupied bucket. */
+        static const uint64_t NO_TRANSLATION;
+
         uint64_t num_items;
-        std::vector<std::map<K,uint64_t>> item_key_to_translation;
+        /** Open-addressing buckets holding translation indices; the size is a power of two. */
+        std::vector<uint64_t> buckets;
         std::vector<std::pair<uint64_t,K>> translation_to_item_key;
+
+        /** Hash an item-key pair into a bucket index. */
+        uint64_t bucketOf(uint64_t item, K const& key) const;
+        /** Probe for the bucket holding the pair or, if absent, the first free bucket. */
+        uint64_t findBucket(uint64_t item, K const& key) const;
+        /** Grow the table to the given power-of-two capacity and re-insert all translations. */
+        void rehash(uint64_t new_capacity);
     };
 
-}
\ No newline at end of file
+}
@@ -2,16 +2,17 @@
 
 namespace synthesis {
 
-    ItemTranslator::ItemTranslator() : num_items(0) {
+    ItemTranslator::ItemTranslator() : num_items(0), current_epoch(1) {
         // left intentionally blank
     }
 
-    ItemTranslator::ItemTranslator(uint64_t num_items) : num_items(num_items) {
+    ItemTranslator::ItemTranslator(uint64_t num_items) : num_items(num_items), current_epoch(1) {
         item_to_translation.resize(num_items, num_items);
+        item_epoch.resize(num_items, 0);
     }
 
     void ItemTranslator::clear() {
-        std::fill(item_to_translation.begin(),item_to_translation.end(),num_items);
+        current_epoch++;
         translation_to_item.clear();
     }
 
@@ -20,12 +21,13 @@ namespace synthesis {
     }
 
     bool ItemTranslator::hasTranslation(uint64_t item) const {
-        return item_to_translation[item] != num_items;
+        return item_epoch[item] == current_epoch;
     }
 
     uint64_t ItemTranslator::translate(uint64_t item) {
         uint64_t *translation = &(item_to_translation[item]);
-        if(*translation == num_items) {
+        if(item_epoch[item] != current_epoch) {
+            item_epoch[item] = current_epoch;
             *translation = numTranslations();
             translation_to_item.push_back(item);
         }
@@ -12,7 +12,7 @@ namespace synthesis {
         ItemTranslator();
         /** Create translator of specified size. */
         ItemTranslator(uint64_t num_items);
-        /** Remove all translations. */
+        /** Remove all translations (O(1), translations are invalidated by advancing the epoch). */
         void clear();
 
         /** Number of created translations. */
@@ -24,7 +24,10 @@ namespace synthesis {
         /** Retrieve the item that has the given translation. */
         uint64_t retrieve(uint64_t translation) const;
         
-        /** Returns mapping of item to translation. */
+        /**
+         * Returns mapping of item to translation. Entries of items not translated in the current
+         * epoch are stale; consult \ref hasTranslation before reading them.
+         */
         std::vector<uint64_t> const& itemToTranslation() const;
         /** Returns reverse mapping of translation to item. */
         std::vector<uint64_t> const& translationToItem() const;
@@ -34,10 +37,14 @@ namespace synthesis {
         /** Maximum number of items to be translated. */
         uint64_t num_items;
         /**
-         * For each item, contains a translation. Item without previously defined translation has translation equal to
-         * \p num_items.
+         * For each item, contains a translation. The translation is valid only if the item's epoch stamp matches
+         * \p current_epoch; stale entries are left behind by \ref clear.
          */
         std::vector<uint64_t> item_to_translation;
+        /** For each item, the epoch in which its translation was created. */
+        std::vector<uint64_t> item_epoch;
+        /** Current epoch; advanced by \ref clear to invalidate all translations at once. */
+        uint64_t current_epoch;
         /** Reverse mapping of translation to item. Grows when new translations are created. */
         std::vector<uint64_t> translation_to_item;
     };
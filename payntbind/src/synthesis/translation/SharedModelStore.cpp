@@ -0,0 +1,64 @@
+#include "SharedModelStore.h"
+#include "BinaryModelExport.h"
+
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/utility/macros.h>
+
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace synthesis {
+
+    void shareModel(storm::models::sparse::Model<double> const& model, std::string const& name) {
+        auto buffer = serializeModelBinary(model);
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT|O_EXCL|O_RDWR, 0600);
+        STORM_LOG_THROW(fd >= 0, storm::exceptions::InvalidArgumentException, "cannot create shared-memory segment " << name);
+        if(ftruncate(fd, buffer.size()) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            STORM_LOG_THROW(false, storm::exceptions::InvalidArgumentException, "cannot size shared-memory segment " << name);
+        }
+        void* mapping = mmap(NULL, buffer.size(), PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(mapping == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            STORM_LOG_THROW(false, storm::exceptions::InvalidArgumentException, "cannot map shared-memory segment " << name);
+        }
+        std::memcpy(mapping, buffer.data(), buffer.size());
+        munmap(mapping, buffer.size());
+    }
+
+    std::shared_ptr<storm::models::sparse::Mdp<double>> attachSharedModel(std::string const& name) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        STORM_LOG_THROW(fd >= 0, storm::exceptions::InvalidArgumentException, "cannot open shared-memory segment " << name);
+        struct stat segment_stat;
+        if(fstat(fd, &segment_stat) != 0) {
+            close(fd);
+            STORM_LOG_THROW(false, storm::exceptions::InvalidArgumentException, "cannot stat shared-memory segment " << name);
+        }
+        uint64_t size = segment_stat.st_size;
+        void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        STORM_LOG_THROW(mapping != MAP_FAILED, storm::exceptions::InvalidArgumentException, "cannot map shared-memory segment " << name);
+        std::shared_ptr<storm::models::sparse::Mdp<double>> model;
+        try {
+            model = deserializeModelBinary(static_cast<char const*>(mapping), size);
+        } catch(...) {
+            munmap(mapping, size);
+            throw;
+        }
+        munmap(mapping, size);
+        return model;
+    }
+
+    void unlinkSharedModel(std::string const& name) {
+        shm_unlink(name.c_str());
+    }
+
+}
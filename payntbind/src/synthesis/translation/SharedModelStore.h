@@ -0,0 +1,30 @@
+#pragma once
+
+#include <storm/models/sparse/Mdp.h>
+#include <storm/models/sparse/Model.h>
+
+#include <memory>
+#include <string>
+
+namespace synthesis {
+
+/**
+ * Publish a constructed model in a POSIX shared-memory segment so that sibling worker
+ * processes can pick it up without re-parsing and re-unfolding the quotient. The segment
+ * holds the binary layout of \ref exportModelBinary; an existing segment of the same name
+ * is replaced.
+ * @param name segment name, by convention "/paynt.<sweep id>"
+ */
+void shareModel(storm::models::sparse::Model<double> const& model, std::string const& name);
+
+/**
+ * Attach a model previously published via \ref shareModel. The segment is mapped read-only
+ * and the Storm model is rebuilt from the mapped arrays in a single pass, which costs one
+ * copy but skips the parse and the unfold entirely.
+ */
+std::shared_ptr<storm::models::sparse::Mdp<double>> attachSharedModel(std::string const& name);
+
+/** Remove a published segment once every worker has attached. */
+void unlinkSharedModel(std::string const& name);
+
+}
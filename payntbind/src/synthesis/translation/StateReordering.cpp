@@ -0,0 +1,141 @@
+#include "StateReordering.h"
+#include "componentTranslations.h"
+
+#include <storm/adapters/RationalNumberAdapter.h>
+#include <storm/storage/BitVector.h>
+
+#include <algorithm>
+#include <queue>
+
+namespace synthesis {
+
+template<typename ValueType>
+std::vector<uint64_t> reverseCuthillMckeeOrder(storm::models::sparse::Mdp<ValueType> const& model) {
+    auto const& matrix = model.getTransitionMatrix();
+    auto const& row_group_indices = matrix.getRowGroupIndices();
+    uint64_t num_states = matrix.getRowGroupCount();
+
+    // undirected adjacency of the state graph, self-loops skipped
+    std::vector<std::vector<uint64_t>> adjacency(num_states);
+    for(uint64_t state = 0; state < num_states; ++state) {
+        for(uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+            for(auto const& entry: matrix.getRow(row)) {
+                uint64_t successor = entry.getColumn();
+                if(successor != state) {
+                    adjacency[state].push_back(successor);
+                    adjacency[successor].push_back(state);
+                }
+            }
+        }
+    }
+    for(auto& neighbors: adjacency) {
+        std::sort(neighbors.begin(),neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(),neighbors.end()),neighbors.end());
+    }
+
+    auto degree_order = [&](uint64_t left, uint64_t right) {
+        return std::make_pair(adjacency[left].size(),left) < std::make_pair(adjacency[right].size(),right);
+    };
+
+    std::vector<uint64_t> order;
+    order.reserve(num_states);
+    storm::storage::BitVector visited(num_states,false);
+    // per connected component: BFS from a minimum-degree state, visiting neighbors in
+    // increasing degree order; reversing the finished order yields the RCM numbering
+    for(uint64_t root_candidate = 0; root_candidate < num_states; ++root_candidate) {
+        if(visited.get(root_candidate)) {
+            continue;
+        }
+        uint64_t root = root_candidate;
+        for(uint64_t state = root_candidate+1; state < num_states; ++state) {
+            if(not visited.get(state) and degree_order(state,root)) {
+                root = state;
+            }
+        }
+        visited.set(root,true);
+        std::queue<uint64_t> frontier;
+        frontier.push(root);
+        while(not frontier.empty()) {
+            uint64_t state = frontier.front();
+            frontier.pop();
+            order.push_back(state);
+            std::vector<uint64_t> unvisited_neighbors;
+            for(uint64_t neighbor: adjacency[state]) {
+                if(not visited.get(neighbor)) {
+                    visited.set(neighbor,true);
+                    unvisited_neighbors.push_back(neighbor);
+                }
+            }
+            std::sort(unvisited_neighbors.begin(),unvisited_neighbors.end(),degree_order);
+            for(uint64_t neighbor: unvisited_neighbors) {
+                frontier.push(neighbor);
+            }
+        }
+    }
+    std::reverse(order.begin(),order.end());
+    return order;
+}
+
+template<typename ValueType>
+std::pair<std::shared_ptr<storm::models::sparse::Mdp<ValueType>>,std::vector<uint64_t>> reorderStates(
+    storm::models::sparse::Mdp<ValueType> const& model
+) {
+    auto const& matrix = model.getTransitionMatrix();
+    auto const& row_group_indices = matrix.getRowGroupIndices();
+    uint64_t num_states = matrix.getRowGroupCount();
+    uint64_t num_choices = matrix.getRowCount();
+
+    std::vector<uint64_t> new_to_old_state = reverseCuthillMckeeOrder(model);
+    std::vector<uint64_t> old_to_new_state(num_states);
+    for(uint64_t new_state = 0; new_state < num_states; ++new_state) {
+        old_to_new_state[new_to_old_state[new_state]] = new_state;
+    }
+
+    std::vector<uint64_t> new_to_old_choice;
+    new_to_old_choice.reserve(num_choices);
+    storm::storage::SparseMatrixBuilder<ValueType> builder(
+        num_choices,num_states,matrix.getEntryCount(),true,true,num_states
+    );
+    uint64_t new_choice = 0;
+    std::vector<std::pair<uint64_t,ValueType>> row_entries;
+    for(uint64_t new_state = 0; new_state < num_states; ++new_state) {
+        builder.newRowGroup(new_choice);
+        uint64_t old_state = new_to_old_state[new_state];
+        for(uint64_t row = row_group_indices[old_state]; row < row_group_indices[old_state+1]; ++row) {
+            row_entries.clear();
+            for(auto const& entry: matrix.getRow(row)) {
+                row_entries.emplace_back(old_to_new_state[entry.getColumn()],entry.getValue());
+            }
+            std::sort(row_entries.begin(),row_entries.end());
+            for(auto const& [column,value]: row_entries) {
+                builder.addNextValue(new_choice,column,value);
+            }
+            new_to_old_choice.push_back(row);
+            ++new_choice;
+        }
+    }
+
+    storm::storage::sparse::ModelComponents<ValueType> components;
+    components.transitionMatrix = builder.build();
+    uint64_t initial_state = old_to_new_state[*model.getInitialStates().begin()];
+    components.stateLabeling = translateStateLabeling(model,new_to_old_state,initial_state);
+    components.stateValuations = translateStateValuations(model,new_to_old_state);
+    storm::storage::BitVector choice_mask(num_choices,true);
+    if(model.hasChoiceLabeling()) {
+        components.choiceLabeling = translateChoiceLabeling(model,new_to_old_choice,choice_mask);
+    }
+    components.rewardModels = translateRewardModels(model,new_to_old_choice,choice_mask);
+    auto mdp = std::make_shared<storm::models::sparse::Mdp<ValueType>>(std::move(components));
+    return std::make_pair(mdp,std::move(new_to_old_state));
+}
+
+template std::vector<uint64_t> reverseCuthillMckeeOrder<double>(storm::models::sparse::Mdp<double> const& model);
+template std::pair<std::shared_ptr<storm::models::sparse::Mdp<double>>,std::vector<uint64_t>> reorderStates<double>(
+    storm::models::sparse::Mdp<double> const& model
+);
+template std::vector<uint64_t> reverseCuthillMckeeOrder<storm::RationalNumber>(storm::models::sparse::Mdp<storm::RationalNumber> const& model);
+template std::pair<std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>>,std::vector<uint64_t>> reorderStates<storm::RationalNumber>(
+    storm::models::sparse::Mdp<storm::RationalNumber> const& model
+);
+
+}
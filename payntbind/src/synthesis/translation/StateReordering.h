@@ -0,0 +1,32 @@
+#pragma once
+
+#include <storm/models/sparse/Mdp.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace synthesis {
+
+/**
+ * Bandwidth-minimizing state order (reverse Cuthill-McKee) over the undirected state graph of
+ * the model. Unfolded MDPs interleave the memory copies of each prototype state, so value
+ * iteration strides across the full state range; renumbering the states so that neighbors get
+ * nearby indices keeps the value vector accesses of one row group within a few cache lines.
+ * @return the permutation as a new-to-old state map
+ */
+template<typename ValueType>
+std::vector<uint64_t> reverseCuthillMckeeOrder(storm::models::sparse::Mdp<ValueType> const& model);
+
+/**
+ * Renumber the states of the model along \ref reverseCuthillMckeeOrder, translating the
+ * transition matrix, labelings, valuations and reward models.
+ * @return the reordered model and the new-to-old state map, through which results map back to
+ *   the original states (and, for unfolded models, further back to (prototype,memory))
+ */
+template<typename ValueType>
+std::pair<std::shared_ptr<storm::models::sparse::Mdp<ValueType>>,std::vector<uint64_t>> reorderStates(
+    storm::models::sparse::Mdp<ValueType> const& model
+);
+
+}
@@ -45,26 +45,15 @@ namespace synthesis {
     }
 
     template<typename ValueType>
-    std::shared_ptr<storm::models::sparse::Pomdp<ValueType>> SubPomdpBuilder<ValueType>::startFromBelief(
-        std::map<uint64_t,ValueType> const& initial_belief
+    storm::storage::SparseMatrix<ValueType> SubPomdpBuilder<ValueType>::buildTransitionMatrix(
+        std::map<uint64_t,ValueType> const& initial_belief,
+        uint64_t translated_initial_state, uint64_t translated_initial_choice,
+        uint64_t num_translated_entries
     ) {
-        auto translated_initial_state = this->state_translator.translate(pomdp.getNumberOfStates());
-        auto translated_initial_choice = this->choice_translator.translate(pomdp.getNumberOfChoices());
-        for(auto const& [state,_]: initial_belief) {
-            collectReachableStates(state);
-        }
-
-        storm::storage::sparse::ModelComponents<ValueType> components;
-        components.stateLabeling = synthesis::translateStateLabeling(
-            pomdp, state_translator.translationToItem(), translated_initial_state
-        );
-
-        storm::storage::BitVector translated_choice_mask(choice_translator.numTranslations(),true);
-
         auto translated_num_states = state_translator.numTranslations();
         auto translated_num_choices = choice_translator.numTranslations();
         storm::storage::SparseMatrixBuilder<ValueType> builder(
-            translated_num_choices, translated_num_states, 0, false, true, translated_num_states
+            translated_num_choices, translated_num_states, num_translated_entries, false, true, translated_num_states
         );
         for(uint64_t translated_state = 0; translated_state < translated_num_states; ++translated_state) {
             if(translated_state == translated_initial_state) {
@@ -75,17 +64,47 @@ namespace synthesis {
                 }
                 continue;
             }
-            
+
             auto state = state_translator.retrieve(translated_state);
             builder.newRowGroup(builder.getLastRow()+1);
             synthesis::translateTransitionMatrixRowGroup(
                 pomdp, builder, state_translator.itemToTranslation(), choice_translator.itemToTranslation(), state
             );
         }
-        components.transitionMatrix =  builder.build();
+        return builder.build();
+    }
+
+    template<typename ValueType>
+    std::shared_ptr<storm::models::sparse::Pomdp<ValueType>> SubPomdpBuilder<ValueType>::startFromBelief(
+        std::map<uint64_t,ValueType> const& initial_belief
+    ) {
+        return startFromBeliefs({initial_belief})[0];
+    }
+
+    template<typename ValueType>
+    std::vector<std::shared_ptr<storm::models::sparse::Pomdp<ValueType>>> SubPomdpBuilder<ValueType>::startFromBeliefs(
+        std::vector<std::map<uint64_t,ValueType>> const& initial_beliefs
+    ) {
+        auto translated_initial_state = this->state_translator.translate(pomdp.getNumberOfStates());
+        auto translated_initial_choice = this->choice_translator.translate(pomdp.getNumberOfChoices());
+        // the closure is shared: collect states reachable from the union of the belief supports
+        for(auto const& initial_belief: initial_beliefs) {
+            for(auto const& [state,_]: initial_belief) {
+                collectReachableStates(state);
+            }
+        }
+
+        // translate the components once
+        auto state_labeling = synthesis::translateStateLabeling(
+            pomdp, state_translator.translationToItem(), translated_initial_state
+        );
 
-        components.choiceLabeling = synthesis::translateChoiceLabeling(pomdp,choice_translator.translationToItem(),translated_choice_mask);
-        components.rewardModels = synthesis::translateRewardModels(pomdp,choice_translator.translationToItem(),translated_choice_mask);
+        storm::storage::BitVector translated_choice_mask(choice_translator.numTranslations(),true);
+        auto choice_labeling = synthesis::translateChoiceLabeling(pomdp,choice_translator.translationToItem(),translated_choice_mask);
+        auto reward_models = synthesis::translateRewardModels(pomdp,choice_translator.translationToItem(),translated_choice_mask);
+
+        // keep state valuations so that downstream coloring does not have to re-unfold
+        auto state_valuations = synthesis::translateStateValuations(pomdp, state_translator.translationToItem());
 
         // build state observations
         auto observability_classes = synthesis::translateObservabilityClasses(
@@ -93,12 +112,35 @@ namespace synthesis {
         );
         // add fresh observation for the initial belief
         observability_classes[translated_initial_state] = pomdp.getNrObservations();
-        components.observabilityClasses = observability_classes;
 
         state_sub_to_full = state_translator.translationToItem();
 
+        // count the entries shared by all sub-POMDPs once; per belief only the size of the
+        // fresh initial row differs
+        uint64_t num_translated_entries_base = 0;
+        for(uint64_t choice: choice_translator.translationToItem()) {
+            if(choice < pomdp.getNumberOfChoices()) {
+                num_translated_entries_base += pomdp.getTransitionMatrix().getRow(choice).getNumberOfEntries();
+            }
+        }
+
+        // the sub-POMDPs differ only in the row of the fresh initial state
+        std::vector<std::shared_ptr<storm::models::sparse::Pomdp<ValueType>>> sub_pomdps;
+        sub_pomdps.reserve(initial_beliefs.size());
+        for(auto const& initial_belief: initial_beliefs) {
+            storm::storage::sparse::ModelComponents<ValueType> components;
+            components.transitionMatrix = buildTransitionMatrix(initial_belief,translated_initial_state,translated_initial_choice,
+                num_translated_entries_base+initial_belief.size());
+            components.stateLabeling = state_labeling;
+            components.stateValuations = state_valuations;
+            components.choiceLabeling = choice_labeling;
+            components.rewardModels = reward_models;
+            components.observabilityClasses = observability_classes;
+            sub_pomdps.push_back(std::make_shared<storm::models::sparse::Pomdp<ValueType>>(std::move(components)));
+        }
+
         clearMemory();
-        return std::make_shared<storm::models::sparse::Pomdp<ValueType>>(std::move(components));
+        return sub_pomdps;
     }
 
     template<typename ValueType>
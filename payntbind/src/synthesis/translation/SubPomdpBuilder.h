@@ -26,6 +26,16 @@ namespace synthesis {
             std::map<uint64_t,ValueType> const& initial_belief
         );
 
+        /**
+         * Batched version of \ref startFromBelief. The reachability closure is computed once over
+         * the union of all belief supports and the components are translated once; the resulting
+         * sub-POMDPs share this state space and differ only in the row of the fresh initial state.
+         * @param initial_beliefs initial probability distributions
+         */
+        std::vector<std::shared_ptr<storm::models::sparse::Pomdp<ValueType>>> startFromBeliefs(
+            std::vector<std::map<uint64_t,ValueType>> const& initial_beliefs
+        );
+
         /**
          * Sub-POMDP-to-POMDP state mapping. Fresh states have an invalid value
          * equal to the number of states in the POMDP.
@@ -48,7 +58,18 @@ namespace synthesis {
         void translateState(uint64_t state);
         /** Translate states reachable from the given initial state. */
         void collectReachableStates(uint64_t initial_state);
-        
+
+        /**
+         * Build the transition matrix of the current closure with the given initial belief row.
+         * @param num_translated_entries the exact entry count of the matrix, so that the builder
+         *  allocates it upfront
+         */
+        storm::storage::SparseMatrix<ValueType> buildTransitionMatrix(
+            std::map<uint64_t,ValueType> const& initial_belief,
+            uint64_t translated_initial_state, uint64_t translated_initial_choice,
+            uint64_t num_translated_entries
+        );
+
         void clearMemory();
 
     };
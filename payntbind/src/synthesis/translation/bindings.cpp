@@ -1,25 +1,49 @@
 #include "../synthesis.h"
 #include "SubPomdpBuilder.h"
 
+#include "src/synthesis/translation/ActionLabelInterner.h"
 #include "src/synthesis/translation/componentTranslations.h"
 #include "src/synthesis/translation/choiceTransformation.h"
+#include "src/synthesis/translation/BinaryModelExport.h"
+#include "src/synthesis/translation/SharedModelStore.h"
+#include "src/synthesis/translation/StateReordering.h"
 #include <storm/adapters/RationalNumberAdapter.h>
 
 template <typename ValueType>
 void bindings_translation_vt(py::module& m, std::string const& vtSuffix) {
 
-    m.def(("computeChoiceDestinations" + vtSuffix).c_str(), &synthesis::computeChoiceDestinations<ValueType>);
-    m.def(("addMissingChoiceLabels" + vtSuffix).c_str(), &synthesis::addMissingChoiceLabelsModel<ValueType>);
+    m.def(("computeChoiceDestinations" + vtSuffix).c_str(), [](std::shared_ptr<storm::models::sparse::Model<ValueType> const> const& model) {
+        return synthesis::computeChoiceDestinationsCached(model);
+    }, py::call_guard<py::gil_scoped_release>());
+    // repair the labeling in place whenever the model has one; models without a choice
+    // labeling still go through the rebuild so that one gets attached
+    m.def(("addMissingChoiceLabels" + vtSuffix).c_str(), [](std::shared_ptr<storm::models::sparse::Model<ValueType>> const& model) -> std::shared_ptr<storm::models::sparse::Model<ValueType>> {
+        if(model->hasChoiceLabeling()) {
+            return synthesis::addMissingChoiceLabelsInPlace(*model) ? model : NULL;
+        }
+        return synthesis::addMissingChoiceLabelsModel(*model);
+    }, py::call_guard<py::gil_scoped_release>());
     m.def(("assertChoiceLabelingIsCanonic" + vtSuffix).c_str(), &synthesis::assertChoiceLabelingIsCanonic);
-    m.def(("extractActionLabels" + vtSuffix).c_str(), &synthesis::extractActionLabels<ValueType>);
-    m.def(("enableAllActions" + vtSuffix).c_str(), py::overload_cast<storm::models::sparse::Model<ValueType> const&>(&synthesis::enableAllActions<ValueType>));
-    m.def(("restoreActionsInAbsorbingStates" + vtSuffix).c_str(), &synthesis::restoreActionsInAbsorbingStates<ValueType>);
-    m.def(("addDontCareAction" + vtSuffix).c_str(), &synthesis::addDontCareAction<ValueType>);
-    m.def(("createModelUnion" + vtSuffix).c_str(), &synthesis::createModelUnion<ValueType>);
+    m.def(("extractActionLabels" + vtSuffix).c_str(), &synthesis::extractActionLabels<ValueType>, py::call_guard<py::gil_scoped_release>());
+    m.def(("extractActionLabelIds" + vtSuffix).c_str(), &synthesis::extractActionLabelIds<ValueType>,
+        "extract the interned label ids of the actions and a choice-to-action mapping",
+        py::call_guard<py::gil_scoped_release>());
+    m.def(("enableAllActions" + vtSuffix).c_str(), py::overload_cast<storm::models::sparse::Model<ValueType> const&>(&synthesis::enableAllActions<ValueType>), py::call_guard<py::gil_scoped_release>());
+    m.def(("restoreActionsInAbsorbingStates" + vtSuffix).c_str(), &synthesis::restoreActionsInAbsorbingStates<ValueType>, py::call_guard<py::gil_scoped_release>());
+    m.def(("addDontCareAction" + vtSuffix).c_str(), &synthesis::addDontCareAction<ValueType>, py::call_guard<py::gil_scoped_release>());
+    m.def(("removeDominatedDontCareActions" + vtSuffix).c_str(), &synthesis::removeDominatedDontCareActions<ValueType>,
+        py::arg("model"), py::arg("choice_values"), py::arg("maximizing"), py::arg("precision"),
+        "remove don't-care rows dominated under the given choice-value bounds, returns the pruned model (or None) and the new-to-old choice map",
+        py::call_guard<py::gil_scoped_release>());
+    m.def(("createModelUnion" + vtSuffix).c_str(), &synthesis::createModelUnion<ValueType>, py::call_guard<py::gil_scoped_release>());
+    m.def(("reorderStates" + vtSuffix).c_str(), &synthesis::reorderStates<ValueType>, py::arg("model"),
+        "renumber states along a bandwidth-minimizing (reverse Cuthill-McKee) order, returns the model and the new-to-old state map",
+        py::call_guard<py::gil_scoped_release>());
 
     py::class_<synthesis::SubPomdpBuilder<ValueType>, std::shared_ptr<synthesis::SubPomdpBuilder<ValueType>>>(m, ("SubPomdpBuilder" + vtSuffix).c_str())
         .def(py::init<storm::models::sparse::Pomdp<ValueType> const&>())
-        .def("start_from_belief", &synthesis::SubPomdpBuilder<ValueType>::startFromBelief)
+        .def("start_from_belief", &synthesis::SubPomdpBuilder<ValueType>::startFromBelief, py::call_guard<py::gil_scoped_release>())
+        .def("start_from_beliefs", &synthesis::SubPomdpBuilder<ValueType>::startFromBeliefs, py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("state_sub_to_full", [](synthesis::SubPomdpBuilder<ValueType>& b) {return b.state_sub_to_full;} )
         ;
 }
@@ -27,4 +51,21 @@ void bindings_translation_vt(py::module& m, std::string const& vtSuffix) {
 void bindings_translation(py::module& m) {
     bindings_translation_vt<double>(m, "");
     bindings_translation_vt<storm::RationalNumber>(m, "Exact");
+
+    m.def("exportModelBinary", &synthesis::exportModelBinary<double>, py::arg("model"), py::arg("path"),
+        "export the model to a compact memory-mappable binary file", py::call_guard<py::gil_scoped_release>());
+
+    m.def("shareModel", &synthesis::shareModel, py::arg("model"), py::arg("name"),
+        "publish the model in a POSIX shared-memory segment for sibling worker processes", py::call_guard<py::gil_scoped_release>());
+    m.def("attachSharedModel", &synthesis::attachSharedModel, py::arg("name"),
+        "rebuild a model published via shareModel from its shared-memory segment", py::call_guard<py::gil_scoped_release>());
+    m.def("unlinkSharedModel", &synthesis::unlinkSharedModel, py::arg("name"),
+        "remove a published shared-memory segment");
+
+    m.def("internActionLabels", [](std::vector<std::string> const& labels) {
+        return synthesis::actionLabelInterner().intern(labels);
+    }, py::arg("labels"), "intern the given action labels, returning their stable ids", py::call_guard<py::gil_scoped_release>());
+    m.def("internedActionLabels", [](std::vector<uint64_t> const& ids) {
+        return synthesis::actionLabelInterner().labelsOf(ids);
+    }, py::arg("ids"), "look up the action labels of the given interned ids", py::call_guard<py::gil_scoped_release>());
 }
@@ -1,5 +1,6 @@
 #include "choiceTransformation.h"
 
+#include "src/synthesis/translation/ActionLabelInterner.h"
 #include "src/synthesis/translation/componentTranslations.h"
 
 #include <storm/adapters/RationalNumberAdapter.h>
@@ -11,9 +12,17 @@
 #include <storm/transformer/SubsystemBuilder.h>
 #include <storm/utility/builder.h>
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <thread>
+
 
 namespace synthesis {
 
+// minimum number of states to spread the canonicity check across threads
+const uint64_t CANONICITY_CHECK_PARALLEL_THRESHOLD = 1ull << 14;
+
 template<typename ValueType>
 std::vector<std::vector<uint64_t>> computeChoiceDestinations(storm::models::sparse::Model<ValueType> const& model) {
     uint64_t num_choices = model.getNumberOfChoices();
@@ -26,16 +35,45 @@ std::vector<std::vector<uint64_t>> computeChoiceDestinations(storm::models::spar
     return choice_destinations;
 }
 
+// destination indices cached per model: several components request the destinations of the
+// same quotient during setup, so the O(transitions) pass runs once per model identity; the
+// weak pointers guard against a recycled address of a freed model
+template<typename ValueType>
+static std::map<void const*, std::pair<std::weak_ptr<storm::models::sparse::Model<ValueType> const>,std::vector<std::vector<uint64_t>>>>& choiceDestinationsCache() {
+    static std::map<void const*, std::pair<std::weak_ptr<storm::models::sparse::Model<ValueType> const>,std::vector<std::vector<uint64_t>>>> cache;
+    return cache;
+}
+
+template<typename ValueType>
+std::vector<std::vector<uint64_t>> const& computeChoiceDestinationsCached(
+    std::shared_ptr<storm::models::sparse::Model<ValueType> const> const& model
+) {
+    auto& cache = choiceDestinationsCache<ValueType>();
+    for(auto it = cache.begin(); it != cache.end();) {
+        if(it->second.first.expired()) {
+            it = cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    auto it = cache.find(model.get());
+    if(it == cache.end() or it->second.first.lock() != model) {
+        it = cache.insert_or_assign(model.get(),
+            std::make_pair(std::weak_ptr<storm::models::sparse::Model<ValueType> const>(model), computeChoiceDestinations(*model))).first;
+    }
+    return it->second.second;
+}
+
 template<typename ValueType>
 void addMissingChoiceLabelsLabeling(
     storm::models::sparse::Model<ValueType> const& model,
     storm::models::sparse::ChoiceLabeling& choice_labeling
 ) {
-    storm::storage::BitVector choice_has_no_label(model.getNumberOfChoices(),false);
-    for(uint64_t choice = 0; choice < model.getNumberOfChoices(); ++choice) {
-        if(choice_labeling.getLabelsOfChoice(choice).size() == 0) {
-            choice_has_no_label.set(choice,true);
-        }
+    // the unlabeled choices are the complement of the union of the per-label choice sets,
+    // which avoids materializing a label set for every single choice
+    storm::storage::BitVector choice_has_no_label(model.getNumberOfChoices(),true);
+    for(std::string const& label: choice_labeling.getLabels()) {
+        choice_has_no_label &= ~choice_labeling.getChoices(label);
     }
     if(choice_has_no_label.empty()) {
         return;
@@ -44,6 +82,17 @@ void addMissingChoiceLabelsLabeling(
     choice_labeling.addLabel(NO_ACTION_LABEL, choice_has_no_label);
 }
 
+template<typename ValueType>
+bool addMissingChoiceLabelsInPlace(storm::models::sparse::Model<ValueType>& model) {
+    if(not model.hasChoiceLabeling()) {
+        return false;
+    }
+    storm::models::sparse::ChoiceLabeling& choice_labeling = model.getChoiceLabeling();
+    bool had_no_action_label = choice_labeling.containsLabel(NO_ACTION_LABEL);
+    addMissingChoiceLabelsLabeling(model,choice_labeling);
+    return not had_no_action_label and choice_labeling.containsLabel(NO_ACTION_LABEL);
+}
+
 template<typename ValueType>
 std::shared_ptr<storm::models::sparse::Model<ValueType>> addMissingChoiceLabelsModel(
     storm::models::sparse::Model<ValueType> const& model
@@ -91,32 +140,66 @@ bool assertChoiceLabelingIsCanonic(
         }
     }
 
-    // check existence for a choice
-    for(uint64_t action: choice_to_action) {
-        if(action == num_actions) {
-            if(throw_on_fail) {
-                STORM_LOG_THROW(false, storm::exceptions::InvalidModelException, "a choice has no labels");
-            } else {
-                return false;
+    // check existence for a choice and uniqueness for a state in one sweep over the row
+    // groups; the sweep is spread across threads for large models, with each worker recording
+    // a violation instead of throwing so that exceptions are raised after the join
+    uint64_t num_states = row_groups.size()-1;
+    uint64_t num_workers = std::max(std::thread::hardware_concurrency(), 1u);
+    if(num_states < CANONICITY_CHECK_PARALLEL_THRESHOLD) {
+        num_workers = 1;
+    }
+    num_workers = std::min<uint64_t>(num_workers, num_states);
+    num_workers = std::max<uint64_t>(num_workers, 1);
+    // violation kind per worker: 0 = none, 1 = unlabeled choice, 2 = duplicate label in state
+    std::vector<char> worker_violation(num_workers, 0);
+    std::vector<uint64_t> worker_violation_state(num_workers, 0);
+    auto checkRange = [&](uint64_t worker, uint64_t state_begin, uint64_t state_end) {
+        storm::storage::BitVector state_labels(num_actions, false);
+        for(uint64_t state = state_begin; state < state_end; ++state) {
+            for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+                uint64_t action = choice_to_action[choice];
+                if(action == num_actions) {
+                    worker_violation[worker] = 1;
+                    worker_violation_state[worker] = state;
+                    return;
+                }
+                if(state_labels[action]) {
+                    worker_violation[worker] = 2;
+                    worker_violation_state[worker] = state;
+                    return;
+                }
+                state_labels.set(action,true);
             }
+            state_labels.clear();
+        }
+    };
+    if(num_workers == 1) {
+        checkRange(0, 0, num_states);
+    } else {
+        uint64_t states_per_worker = (num_states + num_workers - 1) / num_workers;
+        std::vector<std::thread> workers;
+        workers.reserve(num_workers-1);
+        for(uint64_t worker = 1; worker < num_workers; ++worker) {
+            uint64_t state_begin = std::min(worker*states_per_worker, num_states);
+            uint64_t state_end = std::min(state_begin+states_per_worker, num_states);
+            workers.emplace_back(checkRange, worker, state_begin, state_end);
+        }
+        checkRange(0, 0, std::min(states_per_worker, num_states));
+        for(auto& worker: workers) {
+            worker.join();
         }
     }
-
-    // check uniqueness for a state
-    storm::storage::BitVector state_labels(num_actions, false);
-    for(uint64_t state = 0; state < row_groups.size()-1; ++state) {
-        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
-            uint64_t action = choice_to_action[choice];
-            if(state_labels[action]) {
-                if(throw_on_fail) {
-                    STORM_LOG_THROW(false, storm::exceptions::InvalidModelException, "a label is used twice for choices in state " << state);
-                } else {
-                    return false;
-                }
-            }
-            state_labels.set(action,true);
+    for(uint64_t worker = 0; worker < num_workers; ++worker) {
+        if(worker_violation[worker] == 0) {
+            continue;
         }
-        state_labels.clear();
+        if(not throw_on_fail) {
+            return false;
+        }
+        if(worker_violation[worker] == 1) {
+            STORM_LOG_THROW(false, storm::exceptions::InvalidModelException, "a choice has no labels");
+        }
+        STORM_LOG_THROW(false, storm::exceptions::InvalidModelException, "a label is used twice for choices in state " << worker_violation_state[worker]);
     }
     return true;
 }
@@ -125,20 +208,22 @@ bool isChoiceLabelingCanonic(
     std::vector<uint64_t> const& row_groups,
     storm::models::sparse::ChoiceLabeling const& choice_labeling
 ) {
-    std::set<std::string> state_labels;
+    // compare interned ids instead of the label strings themselves; the per-state duplicate
+    // check then works on integers and repeated checks of the same model reuse the table
+    std::set<uint64_t> state_label_ids;
     for(uint64_t state = 0; state < row_groups.size()-1; ++state) {
         for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
             auto const& labels = choice_labeling.getLabelsOfChoice(choice);
             if(labels.size() != 1) {
                 return false;
             }
-            std::string const& label = *(labels.begin());
-            if(state_labels.find(label) != state_labels.end()) {
+            uint64_t label_id = actionLabelInterner().intern(*(labels.begin()));
+            if(state_label_ids.find(label_id) != state_label_ids.end()) {
                 return false;
             }
-            state_labels.insert(label);
+            state_label_ids.insert(label_id);
         }
-        state_labels.clear();
+        state_label_ids.clear();
     }
     return true;
 }
@@ -177,6 +262,14 @@ std::pair<std::vector<std::string>,std::vector<uint64_t>> extractActionLabels(
     return std::make_pair(action_labels,choice_to_action);
 }
 
+template<typename ValueType>
+std::pair<std::vector<uint64_t>,std::vector<uint64_t>> extractActionLabelIds(
+    storm::models::sparse::Model<ValueType> const& model
+) {
+    auto [action_labels,choice_to_action] = extractActionLabels(model);
+    return std::make_pair(actionLabelInterner().intern(action_labels),std::move(choice_to_action));
+}
+
 template<typename ValueType>
 std::pair<std::shared_ptr<storm::models::sparse::Model<ValueType>>,std::vector<uint64_t>> enableAllActions(
     storm::models::sparse::Model<ValueType> const& model
@@ -189,14 +282,14 @@ std::pair<std::shared_ptr<storm::models::sparse::Model<ValueType>>,std::vector<u
     storm::models::sparse::Model<ValueType> const& model,
     storm::storage::BitVector const& state_mask
 ) {
-    auto [action_labels,choice_to_action] = synthesis::extractActionLabels<ValueType>(model);
-    uint64_t num_actions = action_labels.size();
+    auto [action_label_ids,choice_to_action] = synthesis::extractActionLabelIds<ValueType>(model);
+    uint64_t num_actions = action_label_ids.size();
     uint64_t num_states = model.getNumberOfStates();
     uint64_t num_choices = model.getNumberOfChoices();
 
     uint64_t dont_care_action = num_actions;
     for(uint64_t action = 0; action < num_actions; ++action) {
-        if(action_labels[action] == DONT_CARE_ACTION_LABEL) {
+        if(action_label_ids[action] == DONT_CARE_ACTION_ID) {
             dont_care_action = action;
             break;
         }
@@ -255,12 +348,19 @@ std::pair<std::shared_ptr<storm::models::sparse::Model<ValueType>>,std::vector<u
     row_groups_new.push_back(translated_to_original_choice.size());
     uint64_t num_translated_choices = translated_to_original_choice.size();
 
-    // build components
-    storm::storage::sparse::ModelComponents<ValueType> components = componentsFromModel(model);
-    components.choiceOrigins.reset();
+    // build components; the choice-indexed components are built anew below, so only the
+    // state-indexed ones are copied from the model
+    storm::storage::sparse::ModelComponents<ValueType> components = stateComponentsFromModel(model);
     storm::storage::BitVector translated_choice_mask(num_translated_choices,true);
     components.choiceLabeling = synthesis::translateChoiceLabeling<ValueType>(model,translated_to_original_choice_label,translated_choice_mask);
-    storm::storage::SparseMatrixBuilder<ValueType> builder(num_translated_choices, num_states, 0, true, true, num_states);
+    // the translated choices intern rows by original choice index, so the exact entry count
+    // of the expanded matrix is known upfront and the builder allocates it in one go instead
+    // of growing through the replicated fallback rows
+    uint64_t num_translated_entries = 0;
+    for(uint64_t choice: translated_to_original_choice) {
+        num_translated_entries += model.getTransitionMatrix().getRow(choice).getNumberOfEntries();
+    }
+    storm::storage::SparseMatrixBuilder<ValueType> builder(num_translated_choices, num_states, num_translated_entries, true, true, num_states);
     for(uint64_t state = 0; state < num_states; ++state) {
         builder.newRowGroup(row_groups_new[state]);
         for(uint64_t translated_choice = row_groups_new[state]; translated_choice < row_groups_new[state+1]; ++translated_choice) {
@@ -283,14 +383,15 @@ std::shared_ptr<storm::models::sparse::Model<ValueType>> removeAction(
     std::string const& action_to_remove_label,
     storm::storage::BitVector const& state_mask
 ) {
-    auto [action_labels,choice_to_action] = synthesis::extractActionLabels<ValueType>(model);
-    uint64_t num_actions = action_labels.size();
+    auto [action_label_ids,choice_to_action] = synthesis::extractActionLabelIds<ValueType>(model);
+    uint64_t num_actions = action_label_ids.size();
     uint64_t num_states = model.getNumberOfStates();
     uint64_t num_choices = model.getNumberOfChoices();
-    // identify action to remove
+    // identify action to remove; the label string stays at this API boundary, inside we match ids
+    uint64_t action_to_remove_id = actionLabelInterner().intern(action_to_remove_label);
     uint64_t action_to_remove = num_actions;
     for(action_to_remove = 0; action_to_remove < num_actions; ++action_to_remove) {
-        if(action_labels[action_to_remove] == action_to_remove_label) {
+        if(action_label_ids[action_to_remove] == action_to_remove_id) {
             break;
         }
     }
@@ -369,11 +470,11 @@ std::shared_ptr<storm::models::sparse::Model<ValueType>> addDontCareAction(
     storm::models::sparse::Model<ValueType> const& model,
     storm::storage::BitVector const& state_mask
 ) {
-    auto [action_labels,choice_to_action] = synthesis::extractActionLabels<ValueType>(model);
-    auto it = std::find(action_labels.begin(),action_labels.end(),DONT_CARE_ACTION_LABEL);
-    STORM_LOG_THROW(it == action_labels.end(), storm::exceptions::UnexpectedException,
+    auto [action_label_ids,choice_to_action] = synthesis::extractActionLabelIds<ValueType>(model);
+    auto it = std::find(action_label_ids.begin(),action_label_ids.end(),DONT_CARE_ACTION_ID);
+    STORM_LOG_THROW(it == action_label_ids.end(), storm::exceptions::UnexpectedException,
         "label " << DONT_CARE_ACTION_LABEL << " is already defined");
-    uint64_t num_actions = action_labels.size();
+    uint64_t num_actions = action_label_ids.size();
     uint64_t num_states = model.getNumberOfStates();
     uint64_t num_choices = model.getNumberOfChoices();
 
@@ -406,12 +507,12 @@ std::shared_ptr<storm::models::sparse::Model<ValueType>> addDontCareAction(
         translated_choice_mask.set(translated_choice, translated_to_original_choice[translated_choice] < num_choices);
     }
 
-    // build components
-    storm::storage::sparse::ModelComponents<ValueType> components = componentsFromModel(model);
-    components.choiceOrigins.reset();
+    // build components; the choice-indexed components are built anew below, so only the
+    // state-indexed ones are copied from the model
+    storm::storage::sparse::ModelComponents<ValueType> components = stateComponentsFromModel(model);
     auto choiceLabeling = synthesis::translateChoiceLabeling<ValueType>(model,translated_to_original_choice,translated_choice_mask);
     choiceLabeling.addLabel(DONT_CARE_ACTION_LABEL, ~translated_choice_mask);
-    components.choiceLabeling = choiceLabeling;
+    components.choiceLabeling = std::move(choiceLabeling);
     storm::storage::SparseMatrixBuilder<ValueType> builder(num_translated_choices, num_states, 0, true, true, num_states);
     for(uint64_t state = 0; state < num_states; ++state) {
         builder.newRowGroup(row_groups_new[state]);
@@ -452,11 +553,96 @@ std::shared_ptr<storm::models::sparse::Model<ValueType>> addDontCareAction(
             choice_reward[dont_care_translated_choice] = reward_sum / storm::utility::convertNumber<ValueType>(state_num_choices);
         }
     }
-    components.rewardModels = rewardModels;
+    components.rewardModels = std::move(rewardModels);
     return storm::utility::builder::buildModelFromComponents<ValueType,storm::models::sparse::StandardRewardModel<ValueType>>(model.getType(),std::move(components));
 }
 
 
+template<typename ValueType>
+storm::storage::BitVector identifyDominatedDontCareChoices(
+    storm::models::sparse::Model<ValueType> const& model,
+    std::vector<ValueType> const& choice_values,
+    bool maximizing,
+    ValueType precision
+) {
+    uint64_t num_states = model.getNumberOfStates();
+    uint64_t num_choices = model.getNumberOfChoices();
+    STORM_LOG_THROW(choice_values.size() == num_choices, storm::exceptions::InvalidArgumentException,
+        "expected one value per choice");
+    storm::storage::BitVector dominated(num_choices,false);
+    if(not model.hasChoiceLabeling() or not model.getChoiceLabeling().containsLabel(DONT_CARE_ACTION_LABEL)) {
+        return dominated;
+    }
+    storm::storage::BitVector const& dont_care_choices = model.getChoiceLabeling().getChoices(DONT_CARE_ACTION_LABEL);
+    std::vector<uint64_t> const& row_groups = model.getTransitionMatrix().getRowGroupIndices();
+    for(uint64_t state = 0; state < num_states; ++state) {
+        for(uint64_t choice = row_groups[state]; choice < row_groups[state+1]; ++choice) {
+            if(not dont_care_choices[choice]) {
+                continue;
+            }
+            // value of the best labeled sibling
+            bool sibling_found = false;
+            ValueType best_sibling = storm::utility::zero<ValueType>();
+            for(uint64_t sibling = row_groups[state]; sibling < row_groups[state+1]; ++sibling) {
+                if(dont_care_choices[sibling]) {
+                    continue;
+                }
+                if(not sibling_found or (maximizing ? choice_values[sibling] > best_sibling : choice_values[sibling] < best_sibling)) {
+                    best_sibling = choice_values[sibling];
+                    sibling_found = true;
+                }
+            }
+            if(not sibling_found) {
+                continue;
+            }
+            bool choice_dominated = maximizing
+                ? choice_values[choice] + precision < best_sibling
+                : choice_values[choice] - precision > best_sibling;
+            dominated.set(choice,choice_dominated);
+        }
+    }
+    return dominated;
+}
+
+template<typename ValueType>
+std::pair<std::shared_ptr<storm::models::sparse::Model<ValueType>>,std::vector<uint64_t>> removeDominatedDontCareActions(
+    storm::models::sparse::Model<ValueType> const& model,
+    std::vector<ValueType> const& choice_values,
+    bool maximizing,
+    ValueType precision
+) {
+    std::pair<std::shared_ptr<storm::models::sparse::Model<ValueType>>,std::vector<uint64_t>> result(nullptr,std::vector<uint64_t>());
+    storm::storage::BitVector dominated = identifyDominatedDontCareChoices(model,choice_values,maximizing,precision);
+    if(dominated.empty()) {
+        return result;
+    }
+    storm::storage::BitVector choice_enabled = ~dominated;
+
+    // construct the corresponding sub-MDP; every state keeps its labeled choices, so the new
+    // choices are exactly the enabled ones in their original order
+    storm::storage::BitVector all_states(model.getNumberOfStates(),true);
+    storm::storage::sparse::ModelComponents<ValueType> components = componentsFromModel(model);
+    if((model.getChoiceLabeling().getChoices(DONT_CARE_ACTION_LABEL) & choice_enabled).empty()) {
+        components.choiceLabeling.value().removeLabel(DONT_CARE_ACTION_LABEL);
+    }
+    std::shared_ptr<storm::models::sparse::Model<ValueType>> mdp = storm::utility::builder::buildModelFromComponents<ValueType>(storm::models::ModelType::Mdp,std::move(components));
+    storm::transformer::SubsystemBuilderReturnType<ValueType> build_result = storm::transformer::buildSubsystem(*mdp, all_states, choice_enabled);
+    std::vector<uint64_t> new_to_old_choice;
+    new_to_old_choice.reserve(choice_enabled.getNumberOfSetBits());
+    for(uint64_t choice: choice_enabled) {
+        new_to_old_choice.push_back(choice);
+    }
+    std::shared_ptr<storm::models::sparse::Model<ValueType>> submdp = build_result.model;
+    if(model.getType() == storm::models::ModelType::Pomdp) {
+        components = componentsFromModel(*submdp);
+        components.observabilityClasses = translateObservabilityClasses(model,build_result.newToOldStateIndexMapping);
+        submdp = storm::utility::builder::buildModelFromComponents<ValueType>(model.getType(),std::move(components));
+    }
+    result.first = submdp;
+    result.second = std::move(new_to_old_choice);
+    return result;
+}
+
 
 template<typename ValueType>
 std::shared_ptr<storm::models::sparse::Model<ValueType>> createModelUnion(
@@ -594,11 +780,17 @@ template std::vector<std::vector<uint64_t>> computeChoiceDestinations<double>(
     storm::models::sparse::Model<double> const& model);
 template std::pair<std::vector<std::string>,std::vector<uint64_t>> extractActionLabels<double>(
     storm::models::sparse::Model<double> const& model);
+template std::pair<std::vector<uint64_t>,std::vector<uint64_t>> extractActionLabelIds<double>(
+    storm::models::sparse::Model<double> const& model);
 template void addMissingChoiceLabelsLabeling<double>(
     storm::models::sparse::Model<double> const& model,
     storm::models::sparse::ChoiceLabeling& choice_labeling);
 template std::shared_ptr<storm::models::sparse::Model<double>> addMissingChoiceLabelsModel<double>(
     storm::models::sparse::Model<double> const& model);
+template bool addMissingChoiceLabelsInPlace<double>(
+    storm::models::sparse::Model<double>& model);
+template std::vector<std::vector<uint64_t>> const& computeChoiceDestinationsCached<double>(
+    std::shared_ptr<storm::models::sparse::Model<double> const> const& model);
 template std::pair<std::shared_ptr<storm::models::sparse::Model<double>>,std::vector<uint64_t>> enableAllActions(
     storm::models::sparse::Model<double> const& model);
 template std::pair<std::shared_ptr<storm::models::sparse::Model<double>>,std::vector<uint64_t>> enableAllActions<double>(
@@ -613,6 +805,14 @@ template std::shared_ptr<storm::models::sparse::Model<double>> restoreActionsInA
 template std::shared_ptr<storm::models::sparse::Model<double>> addDontCareAction<double>(
     storm::models::sparse::Model<double> const& model,
     storm::storage::BitVector const& state_mask);
+template storm::storage::BitVector identifyDominatedDontCareChoices<double>(
+    storm::models::sparse::Model<double> const& model,
+    std::vector<double> const& choice_values,
+    bool maximizing, double precision);
+template std::pair<std::shared_ptr<storm::models::sparse::Model<double>>,std::vector<uint64_t>> removeDominatedDontCareActions<double>(
+    storm::models::sparse::Model<double> const& model,
+    std::vector<double> const& choice_values,
+    bool maximizing, double precision);
 template std::shared_ptr<storm::models::sparse::Model<double>> createModelUnion(
     std::vector<std::shared_ptr<storm::models::sparse::Model<double>>> const&
 );
@@ -621,11 +821,17 @@ template std::vector<std::vector<uint64_t>> computeChoiceDestinations<storm::Rat
     storm::models::sparse::Model<storm::RationalNumber> const& model);
 template std::pair<std::vector<std::string>,std::vector<uint64_t>> extractActionLabels<storm::RationalNumber>(
     storm::models::sparse::Model<storm::RationalNumber> const& model);
+template std::pair<std::vector<uint64_t>,std::vector<uint64_t>> extractActionLabelIds<storm::RationalNumber>(
+    storm::models::sparse::Model<storm::RationalNumber> const& model);
 template void addMissingChoiceLabelsLabeling<storm::RationalNumber>(
     storm::models::sparse::Model<storm::RationalNumber> const& model,
     storm::models::sparse::ChoiceLabeling& choice_labeling);
 template std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber>> addMissingChoiceLabelsModel<storm::RationalNumber>(
     storm::models::sparse::Model<storm::RationalNumber> const& model);
+template bool addMissingChoiceLabelsInPlace<storm::RationalNumber>(
+    storm::models::sparse::Model<storm::RationalNumber>& model);
+template std::vector<std::vector<uint64_t>> const& computeChoiceDestinationsCached<storm::RationalNumber>(
+    std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber> const> const& model);
 template std::pair<std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber>>,std::vector<uint64_t>> enableAllActions(
     storm::models::sparse::Model<storm::RationalNumber> const& model);
 template std::pair<std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber>>,std::vector<uint64_t>> enableAllActions<storm::RationalNumber>(
@@ -640,6 +846,14 @@ template std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber>> re
 template std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber>> addDontCareAction<storm::RationalNumber>(
     storm::models::sparse::Model<storm::RationalNumber> const& model,
     storm::storage::BitVector const& state_mask);
+template storm::storage::BitVector identifyDominatedDontCareChoices<storm::RationalNumber>(
+    storm::models::sparse::Model<storm::RationalNumber> const& model,
+    std::vector<storm::RationalNumber> const& choice_values,
+    bool maximizing, storm::RationalNumber precision);
+template std::pair<std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber>>,std::vector<uint64_t>> removeDominatedDontCareActions<storm::RationalNumber>(
+    storm::models::sparse::Model<storm::RationalNumber> const& model,
+    std::vector<storm::RationalNumber> const& choice_values,
+    bool maximizing, storm::RationalNumber precision);
 template std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber>> createModelUnion(
     std::vector<std::shared_ptr<storm::models::sparse::Model<storm::RationalNumber>>> const&
 );
@@ -6,6 +6,7 @@
 #include <storm/models/sparse/StateLabeling.h>
 #include <storm/models/sparse/ChoiceLabeling.h>
 
+#include <memory>
 #include <vector>
 
 namespace synthesis {
@@ -21,6 +22,16 @@ const std::string DONT_CARE_ACTION_LABEL = "__random__";
 template<typename ValueType>
 std::vector<std::vector<uint64_t>> computeChoiceDestinations(storm::models::sparse::Model<ValueType> const& model);
 
+/**
+ * Like \ref computeChoiceDestinations, but cached per model identity: repeated requests for
+ * the same model return the index computed on the first call. The cache entry is dropped once
+ * the model itself is released.
+ */
+template<typename ValueType>
+std::vector<std::vector<uint64_t>> const& computeChoiceDestinationsCached(
+    std::shared_ptr<storm::models::sparse::Model<ValueType> const> const& model
+);
+
 /**
  * Add \p NO_ACTION_LABEL label to any choice that does not have any.
  */
@@ -39,6 +50,14 @@ std::shared_ptr<storm::models::sparse::Model<ValueType>> addMissingChoiceLabelsM
     storm::models::sparse::Model<ValueType> const& model
 );
 
+/**
+ * Add \p NO_ACTION_LABEL label to any choice that does not have any, repairing the model's own
+ * choice labeling without rebuilding the model.
+ * @return whether the label was added
+ */
+template<typename ValueType>
+bool addMissingChoiceLabelsInPlace(storm::models::sparse::Model<ValueType>& model);
+
 /**
  * Assert that choice labeling is canonic, i.e. each choice has exactly one label and each has at most one choice with
  * any given label.
@@ -64,6 +83,18 @@ std::pair<std::vector<std::string>,std::vector<uint64_t>> extractActionLabels(
     storm::models::sparse::Model<ValueType> const& model
 );
 
+/**
+ * Variant of \ref extractActionLabels for id-based consumers: the action labels are interned
+ * (see \ref ActionLabelInterner) and returned as their stable ids, so downstream code compares
+ * integers instead of strings. The action order is the same deterministic order as in
+ * \ref extractActionLabels.
+ * @return for each action its interned label id, and a choice-to-action mapping
+ */
+template<typename ValueType>
+std::pair<std::vector<uint64_t>,std::vector<uint64_t>> extractActionLabelIds(
+    storm::models::sparse::Model<ValueType> const& model
+);
+
 template<typename ValueType>
 std::pair<std::shared_ptr<storm::models::sparse::Model<ValueType>>,std::vector<uint64_t>> enableAllActions(
     storm::models::sparse::Model<ValueType> const& model
@@ -113,6 +144,35 @@ std::shared_ptr<storm::models::sparse::Model<ValueType>> addDontCareAction(
     storm::storage::BitVector const& state_mask
 );
 
+/**
+ * Identify dominated don't-care rows. Given for each choice a bound on its value in the
+ * direction of optimization, obtained from a quotient check, the don't-care row of a state is
+ * dominated if its bound falls short of the best labeled sibling by more than \p precision.
+ * Since the don't-care action mixes its siblings uniformly, such a row is never the uniquely
+ * optimal choice of the state, so the rest of the pipeline can run without it.
+ * @return mask of dominated don't-care choices (empty mask if the label does not exist)
+ */
+template<typename ValueType>
+storm::storage::BitVector identifyDominatedDontCareChoices(
+    storm::models::sparse::Model<ValueType> const& model,
+    std::vector<ValueType> const& choice_values,
+    bool maximizing,
+    ValueType precision
+);
+
+/**
+ * Remove dominated don't-care rows (see \ref identifyDominatedDontCareChoices) from the model.
+ * @return the pruned model and, for each of its choices, the original choice index; the model
+ * is NULL if no row is dominated
+ */
+template<typename ValueType>
+std::pair<std::shared_ptr<storm::models::sparse::Model<ValueType>>,std::vector<uint64_t>> removeDominatedDontCareActions(
+    storm::models::sparse::Model<ValueType> const& model,
+    std::vector<ValueType> const& choice_values,
+    bool maximizing,
+    ValueType precision
+);
+
 /**
  * Create a union model with a fresh initial state simulating a uniform choice.
  */
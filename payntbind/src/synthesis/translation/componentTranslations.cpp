@@ -10,16 +10,12 @@
 namespace synthesis {
 
 template<typename ValueType>
-storm::storage::sparse::ModelComponents<ValueType> componentsFromModel(
+storm::storage::sparse::ModelComponents<ValueType> stateComponentsFromModel(
     storm::models::sparse::Model<ValueType> const& model
 ) {
     storm::storage::sparse::ModelComponents<ValueType> components;
     components.stateLabeling = model.getStateLabeling();
     components.stateValuations = model.getOptionalStateValuations();
-    components.transitionMatrix = model.getTransitionMatrix();
-    components.choiceLabeling = model.getOptionalChoiceLabeling();
-    components.choiceOrigins = model.getOptionalChoiceOrigins();
-    components.rewardModels = model.getRewardModels();
     if (model.getType() == storm::models::ModelType::Pomdp) {
         auto pomdp = static_cast<storm::models::sparse::Pomdp<ValueType> const&>(model);
         components.observabilityClasses = pomdp.getObservations();
@@ -33,6 +29,18 @@ storm::storage::sparse::ModelComponents<ValueType> componentsFromModel(
     return components;
 }
 
+template<typename ValueType>
+storm::storage::sparse::ModelComponents<ValueType> componentsFromModel(
+    storm::models::sparse::Model<ValueType> const& model
+) {
+    storm::storage::sparse::ModelComponents<ValueType> components = stateComponentsFromModel(model);
+    components.transitionMatrix = model.getTransitionMatrix();
+    components.choiceLabeling = model.getOptionalChoiceLabeling();
+    components.choiceOrigins = model.getOptionalChoiceOrigins();
+    components.rewardModels = model.getRewardModels();
+    return components;
+}
+
 template<typename ValueType>
 storm::models::sparse::StateLabeling translateStateLabeling(
     storm::models::sparse::Model<ValueType> const& model,
@@ -80,6 +88,19 @@ std::vector<uint32_t> translateObservabilityClasses(
 }
 
 
+template<typename ValueType>
+boost::optional<storm::storage::sparse::StateValuations> translateStateValuations(
+    storm::models::sparse::Model<ValueType> const& model,
+    std::vector<uint64_t> const& translated_to_original_state
+) {
+    if(not model.hasStateValuations()) {
+        return boost::none;
+    }
+    // single bulk selection instead of re-adding valuations state by state through a builder;
+    // fresh states (mapped beyond the original state space) receive empty valuations
+    return model.getStateValuations().selectStates(translated_to_original_state);
+}
+
 template<typename ValueType>
 storm::models::sparse::ChoiceLabeling translateChoiceLabeling(
     storm::models::sparse::Model<ValueType> const& model,
@@ -132,8 +153,8 @@ std::unordered_map<std::string,storm::models::sparse::StandardRewardModel<ValueT
 ) {
     std::unordered_map<std::string,storm::models::sparse::StandardRewardModel<ValueType>> reward_models;
     for(auto const& reward_model : model.getRewardModels()) {
-        auto new_reward_model = translateRewardModel(reward_model.second,translated_to_original_choice,translated_choice_mask);
-        reward_models.emplace(reward_model.first, new_reward_model);
+        reward_models.emplace(reward_model.first,
+            translateRewardModel(reward_model.second,translated_to_original_choice,translated_choice_mask));
     }
     return reward_models;
 }
@@ -169,6 +190,8 @@ void translateTransitionMatrixRowGroup(
 }
 
 
+template storm::storage::sparse::ModelComponents<double> stateComponentsFromModel<double>(
+    storm::models::sparse::Model<double> const& model);
 template storm::storage::sparse::ModelComponents<double> componentsFromModel<double>(
     storm::models::sparse::Model<double> const& model);
 
@@ -190,6 +213,9 @@ template void translateTransitionMatrixRowGroup<double>(
     std::vector<uint64_t> const& original_to_translated_choice,
     uint64_t state);
 
+template boost::optional<storm::storage::sparse::StateValuations> translateStateValuations<double>(
+    storm::models::sparse::Model<double> const& model,
+    std::vector<uint64_t> const& translated_to_original_state);
 template storm::models::sparse::ChoiceLabeling translateChoiceLabeling<double>(
     storm::models::sparse::Model<double> const& model,
     std::vector<uint64_t> const& translated_to_original_choice,
@@ -210,6 +236,8 @@ template std::vector<uint32_t> translateObservabilityClasses<double>(
 
 
 
+template storm::storage::sparse::ModelComponents<storm::RationalNumber> stateComponentsFromModel<storm::RationalNumber>(
+    storm::models::sparse::Model<storm::RationalNumber> const& model);
 template storm::storage::sparse::ModelComponents<storm::RationalNumber> componentsFromModel<storm::RationalNumber>(
     storm::models::sparse::Model<storm::RationalNumber> const& model);
 
@@ -231,6 +259,9 @@ template void translateTransitionMatrixRowGroup<storm::RationalNumber>(
     std::vector<uint64_t> const& original_to_translated_choice,
     uint64_t state);
 
+template boost::optional<storm::storage::sparse::StateValuations> translateStateValuations<storm::RationalNumber>(
+    storm::models::sparse::Model<storm::RationalNumber> const& model,
+    std::vector<uint64_t> const& translated_to_original_state);
 template storm::models::sparse::ChoiceLabeling translateChoiceLabeling<storm::RationalNumber>(
     storm::models::sparse::Model<storm::RationalNumber> const& model,
     std::vector<uint64_t> const& translated_to_original_choice,
@@ -6,11 +6,23 @@
 #include <storm/models/sparse/StateLabeling.h>
 #include <storm/models/sparse/ChoiceLabeling.h>
 #include <storm/models/sparse/StandardRewardModel.h>
+#include <storm/storage/sparse/StateValuations.h>
 
 #include <vector>
 
 namespace synthesis {
 
+/**
+ * Copy the state-indexed components (state labeling, state valuations, observability classes,
+ * player indications) from an existing model, leaving the choice-indexed ones (transition
+ * matrix, choice labeling, choice origins, reward models) default-initialized. Use this when
+ * the caller rebuilds the choice-indexed components anyway so that they are not copied first.
+ */
+template<typename ValueType>
+storm::storage::sparse::ModelComponents<ValueType> stateComponentsFromModel(
+    storm::models::sparse::Model<ValueType> const& model
+);
+
 /**
  * Copy components from existing model.
  */
@@ -32,6 +44,18 @@ std::vector<uint32_t> translateObservabilityClasses(
     std::vector<uint64_t> const& translated_to_original_state
 );
 
+/**
+ * Translate state valuations through a translated-to-original state mapping in one bulk
+ * selection, so that sub-models keep their valuations (needed e.g. by coloring). Fresh states
+ * mapped beyond the original state space receive empty valuations.
+ * @return the translated valuations, or none if the model has no state valuations
+ */
+template<typename ValueType>
+boost::optional<storm::storage::sparse::StateValuations> translateStateValuations(
+    storm::models::sparse::Model<ValueType> const& model,
+    std::vector<uint64_t> const& translated_to_original_state
+);
+
 template<typename ValueType>
 storm::models::sparse::ChoiceLabeling translateChoiceLabeling(
     storm::models::sparse::Model<ValueType> const& model,
@@ -0,0 +1,106 @@
+#include "CheckResultCache.h"
+
+#include "storm/adapters/RationalNumberAdapter.h"
+
+#include <limits>
+
+namespace synthesis {
+
+    template<typename ValueType>
+    const uint64_t CheckResultCache<ValueType>::NO_SCHEDULER = std::numeric_limits<uint64_t>::max();
+
+    template<typename ValueType>
+    bool CheckResultCache<ValueType>::Key::operator==(Key const& other) const {
+        return quotient_id == other.quotient_id
+            and mask_fingerprint == other.mask_fingerprint
+            and formula_id == other.formula_id;
+    }
+
+    template<typename ValueType>
+    std::size_t CheckResultCache<ValueType>::KeyHash::operator()(Key const& key) const {
+        std::size_t seed = key.quotient_id;
+        seed ^= std::hash<uint64_t>()(key.mask_fingerprint) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        seed ^= std::hash<uint64_t>()(key.formula_id) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+
+    template<typename ValueType>
+    CheckResultCache<ValueType>::CheckResultCache(uint64_t capacity) : capacity(capacity) {}
+
+    template<typename ValueType>
+    uint64_t CheckResultCache<ValueType>::maskFingerprint(storm::storage::BitVector const& mask) {
+        // FNV-1a over the mask size and the set bit positions
+        uint64_t fingerprint = 14695981039346656037ull;
+        auto mix = [&fingerprint](uint64_t word) {
+            fingerprint = (fingerprint ^ word) * 1099511628211ull;
+        };
+        mix(mask.size());
+        for(uint64_t bit: mask) {
+            mix(bit);
+        }
+        return fingerprint;
+    }
+
+    template<typename ValueType>
+    bool CheckResultCache<ValueType>::lookup(
+        uint64_t quotient_id, uint64_t mask_fingerprint, uint64_t formula_id,
+        ValueType& value, uint64_t& scheduler_handle
+    ) {
+        num_lookups++;
+        auto it = entries.find(Key{quotient_id,mask_fingerprint,formula_id});
+        if(it == entries.end()) {
+            return false;
+        }
+        num_hits++;
+        value = it->second.value;
+        scheduler_handle = it->second.scheduler_handle;
+        return true;
+    }
+
+    template<typename ValueType>
+    void CheckResultCache<ValueType>::insert(
+        uint64_t quotient_id, uint64_t mask_fingerprint, uint64_t formula_id,
+        ValueType value, uint64_t scheduler_handle
+    ) {
+        if(capacity == 0) {
+            return;
+        }
+        Key key{quotient_id,mask_fingerprint,formula_id};
+        auto it = entries.find(key);
+        if(it != entries.end()) {
+            it->second = Entry{value,scheduler_handle};
+            return;
+        }
+        while(entries.size() >= capacity) {
+            entries.erase(insertion_order.front());
+            insertion_order.pop_front();
+        }
+        entries.emplace(key, Entry{value,scheduler_handle});
+        insertion_order.push_back(key);
+    }
+
+    template<typename ValueType>
+    uint64_t CheckResultCache<ValueType>::size() const {
+        return entries.size();
+    }
+
+    template<typename ValueType>
+    uint64_t CheckResultCache<ValueType>::numLookups() const {
+        return num_lookups;
+    }
+
+    template<typename ValueType>
+    uint64_t CheckResultCache<ValueType>::numHits() const {
+        return num_hits;
+    }
+
+    template<typename ValueType>
+    void CheckResultCache<ValueType>::clear() {
+        entries.clear();
+        insertion_order.clear();
+    }
+
+    template class CheckResultCache<double>;
+    template class CheckResultCache<storm::RationalNumber>;
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "storm/storage/BitVector.h"
+
+#include <unordered_map>
+#include <deque>
+
+namespace synthesis {
+
+    /**
+     * Bounded cache for initial-state check results, keyed by (quotient id, choice-mask
+     * fingerprint, formula id). Across AR, CEGIS and hybrid switches the same restricted
+     * model is checked against the same formula multiple times - double-checks, mode
+     * switches, merge validation - so the verifyMdp wrappers consult the cache before
+     * calling the model checker and feed it afterwards. Entries are evicted in insertion
+     * order once the capacity is reached. Masks enter the key through a 64-bit fingerprint,
+     * so a hit identifies the restricted model up to a hash collision; schedulers travel as
+     * registry handles, see \ref SchedulerRegistry.
+     */
+    template<typename ValueType>
+    class CheckResultCache {
+    public:
+
+        /** Marks entries carrying no scheduler handle. */
+        static const uint64_t NO_SCHEDULER;
+
+        CheckResultCache(uint64_t capacity = 1 << 16);
+
+        /** 64-bit fingerprint of a choice mask. */
+        static uint64_t maskFingerprint(storm::storage::BitVector const& mask);
+
+        /**
+         * Look up the result of a previous identical check.
+         * @param value (output) the initial-state value of the cached check
+         * @param scheduler_handle (output) the scheduler handle of the cached check
+         *   (NO_SCHEDULER if none was stored)
+         * @return whether the entry was present
+         */
+        bool lookup(uint64_t quotient_id, uint64_t mask_fingerprint, uint64_t formula_id,
+            ValueType& value, uint64_t& scheduler_handle);
+
+        /** Store a check result, evicting the oldest entry when the cache is full. */
+        void insert(uint64_t quotient_id, uint64_t mask_fingerprint, uint64_t formula_id,
+            ValueType value, uint64_t scheduler_handle = NO_SCHEDULER);
+
+        /** Number of entries currently stored. */
+        uint64_t size() const;
+        /** Number of lookups made so far. */
+        uint64_t numLookups() const;
+        /** Number of lookups answered from the cache so far. */
+        uint64_t numHits() const;
+        /** Drop all entries; the statistics are kept. */
+        void clear();
+
+    private:
+
+        struct Key {
+            uint64_t quotient_id;
+            uint64_t mask_fingerprint;
+            uint64_t formula_id;
+            bool operator==(Key const& other) const;
+        };
+        struct KeyHash {
+            std::size_t operator()(Key const& key) const;
+        };
+        struct Entry {
+            ValueType value;
+            uint64_t scheduler_handle;
+        };
+
+        uint64_t capacity;
+        std::unordered_map<Key,Entry,KeyHash> entries;
+        /** Keys in insertion order, oldest first, for eviction. */
+        std::deque<Key> insertion_order;
+        uint64_t num_lookups = 0;
+        uint64_t num_hits = 0;
+    };
+
+}
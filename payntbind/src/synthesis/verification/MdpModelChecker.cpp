@@ -1,8 +1,23 @@
 #include "MdpModelChecker.h"
+#include "SchedulerRegistry.h"
+
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/utility/NumberTraits.h"
 
 #include "storm/modelchecker/prctl/SparseMdpPrctlModelChecker.h"
+#include "storm/modelchecker/propositional/SparsePropositionalModelChecker.h"
+#include "storm/modelchecker/results/ExplicitQualitativeCheckResult.h"
+#include "storm/modelchecker/results/ExplicitQuantitativeCheckResult.h"
+#include "storm/environment/solver/MinMaxSolverEnvironment.h"
+#include "storm/modelchecker/hints/ExplicitModelCheckerHint.h"
+#include "storm/exceptions/InvalidArgumentException.h"
 #include "storm/exceptions/NotSupportedException.h"
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <thread>
+
 namespace synthesis {
 
     template<typename ValueType>
@@ -24,4 +39,1142 @@ namespace synthesis {
         storm::logic::Formula const& formula,
         bool produce_schedulers
     );
+    template std::shared_ptr<storm::modelchecker::CheckResult> verifyMdp<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& mdp,
+        storm::logic::Formula const& formula,
+        bool produce_schedulers
+    );
+
+    // warm-start registry: parent result vectors referenced by id, so sibling checks reuse
+    // them without the vectors travelling through the python layer
+    template<typename ValueType>
+    static std::map<uint64_t, std::vector<ValueType>>& resultVectorRegistry() {
+        static std::map<uint64_t, std::vector<ValueType>> registry;
+        return registry;
+    }
+
+    template<typename ValueType>
+    uint64_t storeResultVector(std::vector<ValueType>&& values) {
+        static uint64_t next_id = 0;
+        uint64_t vector_id = next_id++;
+        resultVectorRegistry<ValueType>().emplace(vector_id, std::move(values));
+        return vector_id;
+    }
+
+    template<typename ValueType>
+    void dropResultVector(uint64_t vector_id) {
+        resultVectorRegistry<ValueType>().erase(vector_id);
+    }
+
+    template<typename ValueType>
+    std::shared_ptr<storm::modelchecker::CheckResult> verifyMdp(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        storm::logic::Formula const& formula,
+        bool produce_schedulers,
+        uint64_t initial_values_id
+    ) {
+        auto const& registry = resultVectorRegistry<ValueType>();
+        auto it = registry.find(initial_values_id);
+        STORM_LOG_THROW(it != registry.end(), storm::exceptions::NotSupportedException, "unknown warm-start vector id");
+        storm::modelchecker::CheckTask<storm::logic::Formula, ValueType> task(formula);
+        task.setProduceSchedulers(produce_schedulers);
+        auto hint = std::make_shared<storm::modelchecker::ExplicitModelCheckerHint<ValueType>>();
+        hint->setResultHint(it->second);
+        task.setHint(hint);
+        storm::modelchecker::SparseMdpPrctlModelChecker<storm::models::sparse::Mdp<ValueType>> modelchecker(*mdp);
+        return modelchecker.check(env, task);
+    }
+
+    template uint64_t storeResultVector<double>(std::vector<double>&& values);
+    template void dropResultVector<double>(uint64_t vector_id);
+    template std::shared_ptr<storm::modelchecker::CheckResult> verifyMdp<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp,
+        storm::logic::Formula const& formula,
+        bool produce_schedulers,
+        uint64_t initial_values_id
+    );
+    template uint64_t storeResultVector<storm::RationalNumber>(std::vector<storm::RationalNumber>&& values);
+    template void dropResultVector<storm::RationalNumber>(uint64_t vector_id);
+    template std::shared_ptr<storm::modelchecker::CheckResult> verifyMdp<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& mdp,
+        storm::logic::Formula const& formula,
+        bool produce_schedulers,
+        uint64_t initial_values_id
+    );
+
+    template<typename ValueType>
+    void parseRestrictedCheckingFormula(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::logic::Formula const& formula,
+        bool& minimize,
+        storm::storage::BitVector& target_states,
+        storm::storage::BitVector& constraint_states
+    ) {
+        STORM_LOG_THROW(formula.isProbabilityOperatorFormula(), storm::exceptions::NotSupportedException, "restricted checking supports probability operators only");
+        auto const& operator_formula = formula.asProbabilityOperatorFormula();
+        STORM_LOG_THROW(operator_formula.hasOptimalityType(), storm::exceptions::NotSupportedException, "formula must specify whether minimal or maximal values are to be computed");
+        minimize = storm::solver::minimize(operator_formula.getOptimalityType());
+
+        // the restriction keeps the quotient's state space, so the state sets of the
+        // subformulae can be evaluated on the quotient itself
+        storm::modelchecker::SparsePropositionalModelChecker<storm::models::sparse::Mdp<ValueType>> propositional(*quotient_mdp);
+        auto computeStateSet = [&](storm::logic::Formula const& state_formula) {
+            storm::modelchecker::CheckTask<storm::logic::Formula, ValueType> task(state_formula);
+            return propositional.check(env, task)->asExplicitQualitativeCheckResult().getTruthValuesVector();
+        };
+        uint64_t state_count = quotient_mdp->getNumberOfStates();
+        auto const& path_formula = operator_formula.getSubformula();
+        if (path_formula.isEventuallyFormula()) {
+            target_states = computeStateSet(path_formula.asEventuallyFormula().getSubformula());
+            constraint_states = storm::storage::BitVector(state_count, true);
+        } else if (path_formula.isUntilFormula()) {
+            constraint_states = computeStateSet(path_formula.asUntilFormula().getLeftSubformula());
+            target_states = computeStateSet(path_formula.asUntilFormula().getRightSubformula());
+        } else {
+            STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "restricted checking supports reachability and until formulae only");
+        }
+    }
+
+    template<typename ValueType>
+    std::vector<ValueType> restrictedValueIteration(
+        storm::storage::SparseMatrix<ValueType> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        ValueType precision,
+        uint64_t max_iterations
+    ) {
+        auto const& row_group_indices = matrix.getRowGroupIndices();
+        uint64_t state_count = matrix.getRowGroupCount();
+        std::vector<ValueType> state_values(state_count, storm::utility::zero<ValueType>());
+        for (auto state : target_states) {
+            state_values[state] = storm::utility::one<ValueType>();
+        }
+        std::vector<ValueType> state_values_new = state_values;
+        // locking: a state whose value change stays below the precision for a few consecutive
+        // iterations is frozen and skipped until one of its successors changes again; most
+        // states settle early while a small set oscillates for many more iterations
+        uint64_t const iterations_to_lock = 3;
+        storm::storage::BitVector active = constraint_states & ~target_states;
+        std::vector<uint8_t> stable_iterations(state_count, 0);
+        storm::storage::SparseMatrix<ValueType> backward_transitions;
+        bool backward_transitions_built = false;
+        for (uint64_t iteration = 0; iteration < max_iterations; ++iteration) {
+            ValueType max_diff = storm::utility::zero<ValueType>();
+            for (uint64_t state = active.getNextSetIndex(0); state < state_count; state = active.getNextSetIndex(state+1)) {
+                ValueType best_value = storm::utility::zero<ValueType>();
+                bool first_row = true;
+                for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                    if (not choice_mask.get(row)) {
+                        continue;
+                    }
+                    ValueType value = storm::utility::zero<ValueType>();
+                    for (auto const& entry : matrix.getRow(row)) {
+                        value += entry.getValue() * state_values[entry.getColumn()];
+                    }
+                    if (first_row or (minimize ? value < best_value : value > best_value)) {
+                        best_value = value;
+                        first_row = false;
+                    }
+                }
+                STORM_LOG_ASSERT(not first_row, "state has no enabled choice");
+                ValueType diff = best_value > state_values[state] ? best_value - state_values[state] : state_values[state] - best_value;
+                if (diff > max_diff) {
+                    max_diff = diff;
+                }
+                state_values_new[state] = best_value;
+                if (diff <= precision) {
+                    if (++stable_iterations[state] >= iterations_to_lock) {
+                        // freeze the state in both buffers so the swap keeps its value intact
+                        state_values[state] = best_value;
+                        active.set(state,false);
+                        if (not backward_transitions_built) {
+                            backward_transitions = matrix.transpose(true);
+                            backward_transitions_built = true;
+                        }
+                    }
+                } else {
+                    stable_iterations[state] = 0;
+                    if (backward_transitions_built) {
+                        // the change has to reach the predecessors, so wake the frozen ones
+                        for (auto const& entry : backward_transitions.getRow(state)) {
+                            uint64_t predecessor = entry.getColumn();
+                            if (not active.get(predecessor) and not target_states.get(predecessor) and constraint_states.get(predecessor)) {
+                                active.set(predecessor,true);
+                                stable_iterations[predecessor] = 0;
+                            }
+                        }
+                    }
+                }
+            }
+            state_values.swap(state_values_new);
+            if (active.empty()) {
+                break;
+            }
+            // exact arithmetic either hits the fixed point exactly or is governed by the
+            // iteration cap, so the epsilon test is compiled out of the rational build
+            if constexpr (storm::NumberTraits<ValueType>::IsExact) {
+                if (storm::utility::isZero(max_diff)) {
+                    break;
+                }
+            } else {
+                if (max_diff <= precision) {
+                    break;
+                }
+            }
+        }
+        return state_values;
+    }
+
+    template<typename ValueType>
+    std::pair<std::vector<ValueType>,bool> restrictedValueIterationThreshold(
+        storm::storage::SparseMatrix<ValueType> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        ValueType precision,
+        uint64_t max_iterations,
+        ValueType threshold,
+        bool decide_below,
+        uint64_t initial_state
+    ) {
+        auto const& row_group_indices = matrix.getRowGroupIndices();
+        uint64_t state_count = matrix.getRowGroupCount();
+        std::vector<ValueType> lower_values(state_count, storm::utility::zero<ValueType>());
+        std::vector<ValueType> upper_values(state_count, storm::utility::one<ValueType>());
+        for (auto state : target_states) {
+            lower_values[state] = storm::utility::one<ValueType>();
+        }
+        for (uint64_t state = 0; state < state_count; ++state) {
+            if (not constraint_states.get(state) and not target_states.get(state)) {
+                upper_values[state] = storm::utility::zero<ValueType>();
+            }
+        }
+        std::vector<ValueType> lower_values_new = lower_values;
+        std::vector<ValueType> upper_values_new = upper_values;
+        auto sweep = [&](std::vector<ValueType> const& values, std::vector<ValueType>& values_new) {
+            ValueType max_diff = storm::utility::zero<ValueType>();
+            for (uint64_t state = 0; state < state_count; ++state) {
+                if (target_states.get(state) or not constraint_states.get(state)) {
+                    continue;
+                }
+                ValueType best_value = storm::utility::zero<ValueType>();
+                bool first_row = true;
+                for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                    if (not choice_mask.get(row)) {
+                        continue;
+                    }
+                    ValueType value = storm::utility::zero<ValueType>();
+                    for (auto const& entry : matrix.getRow(row)) {
+                        value += entry.getValue() * values[entry.getColumn()];
+                    }
+                    if (first_row or (minimize ? value < best_value : value > best_value)) {
+                        best_value = value;
+                        first_row = false;
+                    }
+                }
+                STORM_LOG_ASSERT(not first_row, "state has no enabled choice");
+                ValueType diff = best_value > values[state] ? best_value - values[state] : values[state] - best_value;
+                if (diff > max_diff) {
+                    max_diff = diff;
+                }
+                values_new[state] = best_value;
+            }
+            return max_diff;
+        };
+        for (uint64_t iteration = 0; iteration < max_iterations; ++iteration) {
+            ValueType max_diff = sweep(lower_values, lower_values_new);
+            sweep(upper_values, upper_values_new);
+            lower_values.swap(lower_values_new);
+            upper_values.swap(upper_values_new);
+            if (decide_below ? upper_values[initial_state] <= threshold : lower_values[initial_state] >= threshold) {
+                return std::make_pair(std::move(lower_values), true);
+            }
+            if constexpr (storm::NumberTraits<ValueType>::IsExact) {
+                if (storm::utility::isZero(max_diff)) {
+                    break;
+                }
+            } else {
+                if (max_diff <= precision) {
+                    break;
+                }
+            }
+        }
+        return std::make_pair(std::move(lower_values), false);
+    }
+
+    template<typename ValueType>
+    std::pair<ValueType,bool> verifyMdpBudgeted(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        storm::logic::Formula const& formula,
+        uint64_t max_iterations
+    ) {
+        bool minimize;
+        storm::storage::BitVector target_states, constraint_states;
+        parseRestrictedCheckingFormula(env, mdp, formula, minimize, target_states, constraint_states);
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+        auto const& matrix = mdp->getTransitionMatrix();
+        auto const& row_group_indices = matrix.getRowGroupIndices();
+        uint64_t state_count = matrix.getRowGroupCount();
+        uint64_t initial_state = *(mdp->getInitialStates().begin());
+
+        std::vector<ValueType> lower_values(state_count, storm::utility::zero<ValueType>());
+        std::vector<ValueType> upper_values(state_count, storm::utility::one<ValueType>());
+        for (auto state : target_states) {
+            lower_values[state] = storm::utility::one<ValueType>();
+        }
+        for (uint64_t state = 0; state < state_count; ++state) {
+            if (not constraint_states.get(state) and not target_states.get(state)) {
+                upper_values[state] = storm::utility::zero<ValueType>();
+            }
+        }
+        std::vector<ValueType> lower_values_new = lower_values;
+        std::vector<ValueType> upper_values_new = upper_values;
+        auto sweep = [&](std::vector<ValueType> const& values, std::vector<ValueType>& values_new) {
+            ValueType max_diff = storm::utility::zero<ValueType>();
+            for (uint64_t state = 0; state < state_count; ++state) {
+                if (target_states.get(state) or not constraint_states.get(state)) {
+                    continue;
+                }
+                ValueType best_value = storm::utility::zero<ValueType>();
+                bool first_row = true;
+                for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                    ValueType value = storm::utility::zero<ValueType>();
+                    for (auto const& entry : matrix.getRow(row)) {
+                        value += entry.getValue() * values[entry.getColumn()];
+                    }
+                    if (first_row or (minimize ? value < best_value : value > best_value)) {
+                        best_value = value;
+                        first_row = false;
+                    }
+                }
+                ValueType diff = best_value > values[state] ? best_value - values[state] : values[state] - best_value;
+                if (diff > max_diff) {
+                    max_diff = diff;
+                }
+                values_new[state] = best_value;
+            }
+            return max_diff;
+        };
+        bool converged = false;
+        for (uint64_t iteration = 0; iteration < max_iterations; ++iteration) {
+            ValueType max_diff = sweep(lower_values, lower_values_new);
+            ValueType max_diff_upper = sweep(upper_values, upper_values_new);
+            if (max_diff_upper > max_diff) {
+                max_diff = max_diff_upper;
+            }
+            lower_values.swap(lower_values_new);
+            upper_values.swap(upper_values_new);
+            if constexpr (storm::NumberTraits<ValueType>::IsExact) {
+                converged = storm::utility::isZero(max_diff);
+            } else {
+                converged = max_diff <= precision;
+            }
+            if (converged) {
+                break;
+            }
+        }
+        ValueType bound = minimize ? lower_values[initial_state] : upper_values[initial_state];
+        return std::make_pair(bound, converged);
+    }
+
+    template std::pair<double,bool> verifyMdpBudgeted<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp,
+        storm::logic::Formula const& formula,
+        uint64_t max_iterations
+    );
+    template std::pair<storm::RationalNumber,bool> verifyMdpBudgeted<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& mdp,
+        storm::logic::Formula const& formula,
+        uint64_t max_iterations
+    );
+
+    template<typename ValueType>
+    std::pair<std::shared_ptr<storm::modelchecker::CheckResult>,std::shared_ptr<storm::modelchecker::CheckResult>> verifyMdpBidirectional(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        storm::logic::Formula const& formula
+    ) {
+        bool minimize;
+        storm::storage::BitVector target_states, constraint_states;
+        parseRestrictedCheckingFormula(env, mdp, formula, minimize, target_states, constraint_states);
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+        uint64_t max_iterations = env.solver().minMax().getMaximalNumberOfIterations();
+        auto const& matrix = mdp->getTransitionMatrix();
+        auto const& row_group_indices = matrix.getRowGroupIndices();
+        uint64_t state_count = matrix.getRowGroupCount();
+
+        std::vector<ValueType> min_values(state_count, storm::utility::zero<ValueType>());
+        for (auto state : target_states) {
+            min_values[state] = storm::utility::one<ValueType>();
+        }
+        std::vector<ValueType> max_values = min_values;
+        std::vector<ValueType> min_values_new = min_values;
+        std::vector<ValueType> max_values_new = max_values;
+        for (uint64_t iteration = 0; iteration < max_iterations; ++iteration) {
+            ValueType max_diff = storm::utility::zero<ValueType>();
+            for (uint64_t state = 0; state < state_count; ++state) {
+                if (target_states.get(state) or not constraint_states.get(state)) {
+                    continue;
+                }
+                ValueType best_min = storm::utility::zero<ValueType>();
+                ValueType best_max = storm::utility::zero<ValueType>();
+                bool first_row = true;
+                for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                    // one traversal of the row feeds both reductions
+                    ValueType value_min = storm::utility::zero<ValueType>();
+                    ValueType value_max = storm::utility::zero<ValueType>();
+                    for (auto const& entry : matrix.getRow(row)) {
+                        value_min += entry.getValue() * min_values[entry.getColumn()];
+                        value_max += entry.getValue() * max_values[entry.getColumn()];
+                    }
+                    if (first_row) {
+                        best_min = value_min;
+                        best_max = value_max;
+                        first_row = false;
+                    } else {
+                        if (value_min < best_min) {
+                            best_min = value_min;
+                        }
+                        if (value_max > best_max) {
+                            best_max = value_max;
+                        }
+                    }
+                }
+                ValueType diff = best_min > min_values[state] ? best_min - min_values[state] : min_values[state] - best_min;
+                if (diff > max_diff) {
+                    max_diff = diff;
+                }
+                diff = best_max > max_values[state] ? best_max - max_values[state] : max_values[state] - best_max;
+                if (diff > max_diff) {
+                    max_diff = diff;
+                }
+                min_values_new[state] = best_min;
+                max_values_new[state] = best_max;
+            }
+            min_values.swap(min_values_new);
+            max_values.swap(max_values_new);
+            if constexpr (storm::NumberTraits<ValueType>::IsExact) {
+                if (storm::utility::isZero(max_diff)) {
+                    break;
+                }
+            } else {
+                if (max_diff <= precision) {
+                    break;
+                }
+            }
+        }
+        return std::make_pair(
+            std::make_shared<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType>>(std::move(min_values)),
+            std::make_shared<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType>>(std::move(max_values))
+        );
+    }
+
+    template std::pair<std::shared_ptr<storm::modelchecker::CheckResult>,std::shared_ptr<storm::modelchecker::CheckResult>> verifyMdpBidirectional<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp,
+        storm::logic::Formula const& formula
+    );
+    template std::pair<std::shared_ptr<storm::modelchecker::CheckResult>,std::shared_ptr<storm::modelchecker::CheckResult>> verifyMdpBidirectional<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& mdp,
+        storm::logic::Formula const& formula
+    );
+
+    template<typename ValueType>
+    std::vector<ValueType> computeExpectedVisits(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        storm::storage::BitVector const& scheduler_choices
+    ) {
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+        uint64_t max_iterations = env.solver().minMax().getMaximalNumberOfIterations();
+        auto const& matrix = mdp->getTransitionMatrix();
+        auto const& row_group_indices = matrix.getRowGroupIndices();
+        uint64_t state_count = matrix.getRowGroupCount();
+        uint64_t initial_state = *(mdp->getInitialStates().begin());
+
+        // the played row of each state, or the group end for absorbing states
+        std::vector<uint64_t> state_to_row(state_count);
+        for (uint64_t state = 0; state < state_count; ++state) {
+            uint64_t played_row = row_group_indices[state+1];
+            for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                if (scheduler_choices.get(row)) {
+                    played_row = row;
+                    break;
+                }
+            }
+            state_to_row[state] = played_row;
+        }
+
+        std::vector<ValueType> visits(state_count, storm::utility::zero<ValueType>());
+        visits[initial_state] = storm::utility::one<ValueType>();
+        std::vector<ValueType> visits_new(state_count);
+        for (uint64_t iteration = 0; iteration < max_iterations; ++iteration) {
+            // transposed flow equations: scatter the visits of each state to its successors
+            std::fill(visits_new.begin(), visits_new.end(), storm::utility::zero<ValueType>());
+            visits_new[initial_state] = storm::utility::one<ValueType>();
+            for (uint64_t state = 0; state < state_count; ++state) {
+                if (state_to_row[state] == row_group_indices[state+1]) {
+                    continue;
+                }
+                for (auto const& entry : matrix.getRow(state_to_row[state])) {
+                    visits_new[entry.getColumn()] += entry.getValue() * visits[state];
+                }
+            }
+            ValueType max_diff = storm::utility::zero<ValueType>();
+            for (uint64_t state = 0; state < state_count; ++state) {
+                ValueType diff = visits_new[state] > visits[state] ?
+                    visits_new[state] - visits[state] : visits[state] - visits_new[state];
+                if (diff > max_diff) {
+                    max_diff = diff;
+                }
+            }
+            visits.swap(visits_new);
+            bool converged;
+            if constexpr (storm::NumberTraits<ValueType>::IsExact) {
+                converged = storm::utility::isZero(max_diff);
+            } else {
+                converged = max_diff <= precision;
+            }
+            if (converged) {
+                break;
+            }
+        }
+        return visits;
+    }
+
+    template std::vector<double> computeExpectedVisits<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp,
+        storm::storage::BitVector const& scheduler_choices
+    );
+    template std::vector<storm::RationalNumber> computeExpectedVisits<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& mdp,
+        storm::storage::BitVector const& scheduler_choices
+    );
+
+    template<typename ValueType>
+    std::pair<storm::storage::BitVector,storm::storage::BitVector> restrictedProb01(
+        storm::storage::SparseMatrix<ValueType> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize
+    ) {
+        auto const& row_group_indices = matrix.getRowGroupIndices();
+        uint64_t state_count = matrix.getRowGroupCount();
+
+        // existential backward reachability: grow the source set by states (within \p through)
+        // having some enabled choice with a successor in the set, until stable
+        auto existentialReach = [&](storm::storage::BitVector const& source, storm::storage::BitVector const& through) {
+            storm::storage::BitVector reach = source;
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                for (uint64_t state = 0; state < state_count; ++state) {
+                    if (reach.get(state) or not through.get(state)) {
+                        continue;
+                    }
+                    bool can_reach = false;
+                    for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1] and not can_reach; ++row) {
+                        if (not choice_mask.get(row)) {
+                            continue;
+                        }
+                        for (auto const& entry : matrix.getRow(row)) {
+                            if (reach.get(entry.getColumn())) {
+                                can_reach = true;
+                                break;
+                            }
+                        }
+                    }
+                    if (can_reach) {
+                        reach.set(state);
+                        changed = true;
+                    }
+                }
+            }
+            return reach;
+        };
+
+        if (minimize) {
+            // greatest fixpoint of states from which the target can be avoided forever:
+            // a constraint state stays if some enabled choice keeps all its mass in the set;
+            // states outside the constraint (and not target) have value 0 and always stay
+            storm::storage::BitVector avoid = ~target_states;
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                for (uint64_t state = 0; state < state_count; ++state) {
+                    if (not avoid.get(state) or not constraint_states.get(state)) {
+                        continue;
+                    }
+                    bool can_stay = false;
+                    for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1] and not can_stay; ++row) {
+                        if (not choice_mask.get(row)) {
+                            continue;
+                        }
+                        bool stays = true;
+                        for (auto const& entry : matrix.getRow(row)) {
+                            if (not avoid.get(entry.getColumn())) {
+                                stays = false;
+                                break;
+                            }
+                        }
+                        can_stay = stays;
+                    }
+                    if (not can_stay) {
+                        avoid.set(state,false);
+                        changed = true;
+                    }
+                }
+            }
+            // the value is below 1 wherever the minimizer reaches the avoid set with
+            // positive probability
+            storm::storage::BitVector below_one = existentialReach(avoid, ~target_states);
+            return std::make_pair(std::move(avoid), ~below_one);
+        }
+
+        // maximizing: prob0 is the complement of existential backward reachability
+        storm::storage::BitVector prob0 = ~existentialReach(target_states, constraint_states);
+        // prob1 via the standard double fixpoint: shrink the candidate set to the states
+        // reaching the target through choices that never leave the candidates
+        storm::storage::BitVector candidates(state_count, true);
+        while (true) {
+            storm::storage::BitVector reach = target_states;
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                for (uint64_t state = 0; state < state_count; ++state) {
+                    if (reach.get(state) or not constraint_states.get(state) or not candidates.get(state)) {
+                        continue;
+                    }
+                    bool can_reach = false;
+                    for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1] and not can_reach; ++row) {
+                        if (not choice_mask.get(row)) {
+                            continue;
+                        }
+                        bool stays = true;
+                        bool progresses = false;
+                        for (auto const& entry : matrix.getRow(row)) {
+                            if (not candidates.get(entry.getColumn())) {
+                                stays = false;
+                                break;
+                            }
+                            if (reach.get(entry.getColumn())) {
+                                progresses = true;
+                            }
+                        }
+                        can_reach = stays and progresses;
+                    }
+                    if (can_reach) {
+                        reach.set(state);
+                        changed = true;
+                    }
+                }
+            }
+            if (reach == candidates) {
+                break;
+            }
+            candidates = std::move(reach);
+        }
+        return std::make_pair(std::move(prob0), std::move(candidates));
+    }
+
+    template<typename ValueType>
+    std::pair<storm::storage::BitVector,storm::storage::BitVector> verifyRestrictedMdpQualitative(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula
+    ) {
+        bool minimize;
+        storm::storage::BitVector target_states, constraint_states;
+        parseRestrictedCheckingFormula(env, quotient_mdp, formula, minimize, target_states, constraint_states);
+        return restrictedProb01(quotient_mdp->getTransitionMatrix(), choice_mask, target_states, constraint_states, minimize);
+    }
+
+    template<typename ValueType>
+    std::shared_ptr<storm::modelchecker::CheckResult> verifyRestrictedMdp(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula
+    ) {
+        bool minimize;
+        storm::storage::BitVector target_states, constraint_states;
+        parseRestrictedCheckingFormula(env, quotient_mdp, formula, minimize, target_states, constraint_states);
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+        uint64_t max_iterations = env.solver().minMax().getMaximalNumberOfIterations();
+        std::vector<ValueType> state_values = restrictedValueIteration(
+            quotient_mdp->getTransitionMatrix(), choice_mask, target_states, constraint_states, minimize, precision, max_iterations);
+        return std::make_shared<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType>>(std::move(state_values));
+    }
+
+    template<typename ValueType>
+    std::vector<ValueType> restrictedRewardBoundedReachability(
+        storm::storage::SparseMatrix<ValueType> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        std::vector<uint64_t> const& choice_rewards,
+        uint64_t reward_bound,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        ValueType precision,
+        uint64_t max_iterations
+    ) {
+        auto const& row_group_indices = matrix.getRowGroupIndices();
+        uint64_t state_count = matrix.getRowGroupCount();
+        // the largest reward of an enabled row bounds how far an epoch looks back, so only
+        // that many epochs are kept in a ring; older epochs can never be referenced again
+        uint64_t max_reward = 0;
+        for (uint64_t row : choice_mask) {
+            if (choice_rewards[row] > max_reward) {
+                max_reward = choice_rewards[row];
+            }
+        }
+        if (max_reward == 0) {
+            // no enabled row accumulates reward, so the bound never binds
+            return restrictedValueIteration(matrix, choice_mask, target_states, constraint_states, minimize, precision, max_iterations);
+        }
+        // states with an enabled zero-reward row need fixpoint iteration within an epoch; the
+        // values of all other states follow from older epochs in a single pass
+        storm::storage::BitVector state_iterated = constraint_states & ~target_states;
+        storm::storage::BitVector state_one_pass(state_count, false);
+        for (uint64_t state = state_iterated.getNextSetIndex(0); state < state_count; state = state_iterated.getNextSetIndex(state+1)) {
+            bool has_zero_reward_row = false;
+            for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                if (choice_mask.get(row) and choice_rewards[row] == 0) {
+                    has_zero_reward_row = true;
+                    break;
+                }
+            }
+            if (not has_zero_reward_row) {
+                state_iterated.set(state,false);
+                state_one_pass.set(state,true);
+            }
+        }
+        // ring of epoch value vectors; target states carry value one in every epoch and states
+        // outside the constraint carry zero, so those entries are set once and never rewritten
+        uint64_t ring_size = max_reward + 1;
+        std::vector<std::vector<ValueType>> epochs(ring_size, std::vector<ValueType>(state_count, storm::utility::zero<ValueType>()));
+        for (auto& epoch_values : epochs) {
+            for (auto state : target_states) {
+                epoch_values[state] = storm::utility::one<ValueType>();
+            }
+        }
+        for (uint64_t epoch = 0; epoch <= reward_bound; ++epoch) {
+            std::vector<ValueType>& values = epochs[epoch % ring_size];
+            // the value of a row of reward r: rows exceeding the remaining budget can no longer
+            // reach the target within the bound, rows of positive reward read the already-fixed
+            // values of an older epoch, zero-reward rows read the current epoch in place
+            auto rowValue = [&](uint64_t row) {
+                uint64_t reward = choice_rewards[row];
+                if (reward > epoch) {
+                    return storm::utility::zero<ValueType>();
+                }
+                std::vector<ValueType> const& successor_values = epochs[(epoch-reward) % ring_size];
+                ValueType value = storm::utility::zero<ValueType>();
+                for (auto const& entry : matrix.getRow(row)) {
+                    value += entry.getValue() * successor_values[entry.getColumn()];
+                }
+                return value;
+            };
+            auto bestRowValue = [&](uint64_t state) {
+                ValueType best_value = storm::utility::zero<ValueType>();
+                bool first_row = true;
+                for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                    if (not choice_mask.get(row)) {
+                        continue;
+                    }
+                    ValueType value = rowValue(row);
+                    if (first_row or (minimize ? value < best_value : value > best_value)) {
+                        best_value = value;
+                        first_row = false;
+                    }
+                }
+                STORM_LOG_ASSERT(not first_row, "state has no enabled choice");
+                return best_value;
+            };
+            // one-pass states first, so that the iterated states read their fresh values
+            for (uint64_t state = state_one_pass.getNextSetIndex(0); state < state_count; state = state_one_pass.getNextSetIndex(state+1)) {
+                values[state] = bestRowValue(state);
+            }
+            if (state_iterated.empty()) {
+                continue;
+            }
+            // seed the iterated states with the previous epoch, a lower bound on this epoch's
+            // value by monotonicity in the budget, then run in-place sweeps to the fixpoint;
+            // reading a mix of old and new values within a sweep stays sound and typically
+            // converges in fewer sweeps than the two-buffer scheme
+            if (epoch > 0) {
+                std::vector<ValueType> const& previous_values = epochs[(epoch-1) % ring_size];
+                for (uint64_t state = state_iterated.getNextSetIndex(0); state < state_count; state = state_iterated.getNextSetIndex(state+1)) {
+                    values[state] = previous_values[state];
+                }
+            }
+            for (uint64_t iteration = 0; iteration < max_iterations; ++iteration) {
+                ValueType max_diff = storm::utility::zero<ValueType>();
+                for (uint64_t state = state_iterated.getNextSetIndex(0); state < state_count; state = state_iterated.getNextSetIndex(state+1)) {
+                    ValueType best_value = bestRowValue(state);
+                    ValueType diff = best_value > values[state] ? best_value - values[state] : values[state] - best_value;
+                    if (diff > max_diff) {
+                        max_diff = diff;
+                    }
+                    values[state] = best_value;
+                }
+                if constexpr (storm::NumberTraits<ValueType>::IsExact) {
+                    if (storm::utility::isZero(max_diff)) {
+                        break;
+                    }
+                } else {
+                    if (max_diff <= precision) {
+                        break;
+                    }
+                }
+            }
+        }
+        return std::move(epochs[reward_bound % ring_size]);
+    }
+
+    template<typename ValueType>
+    std::shared_ptr<storm::modelchecker::CheckResult> verifyRestrictedMdpRewardBounded(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula,
+        std::string const& reward_model_name,
+        uint64_t reward_bound
+    ) {
+        bool minimize;
+        storm::storage::BitVector target_states, constraint_states;
+        parseRestrictedCheckingFormula(env, quotient_mdp, formula, minimize, target_states, constraint_states);
+        STORM_LOG_THROW(quotient_mdp->hasRewardModel(reward_model_name), storm::exceptions::InvalidArgumentException,
+            "model has no reward model " << reward_model_name);
+        auto const& reward_model = quotient_mdp->getRewardModel(reward_model_name);
+        STORM_LOG_THROW(not reward_model.hasStateRewards() and not reward_model.hasTransitionRewards() and reward_model.hasStateActionRewards(),
+            storm::exceptions::NotSupportedException, "expected state-action rewards");
+        uint64_t num_choices = quotient_mdp->getNumberOfChoices();
+        std::vector<uint64_t> choice_rewards(num_choices);
+        for (uint64_t choice = 0; choice < num_choices; ++choice) {
+            ValueType reward = reward_model.getStateActionReward(choice);
+            STORM_LOG_THROW(reward >= storm::utility::zero<ValueType>() and storm::utility::isInteger(reward),
+                storm::exceptions::NotSupportedException, "epoch-based checking expects non-negative integer rewards");
+            choice_rewards[choice] = storm::utility::convertNumber<uint64_t>(reward);
+        }
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+        uint64_t max_iterations = env.solver().minMax().getMaximalNumberOfIterations();
+        std::vector<ValueType> state_values = restrictedRewardBoundedReachability(
+            quotient_mdp->getTransitionMatrix(), choice_mask, choice_rewards, reward_bound,
+            target_states, constraint_states, minimize, precision, max_iterations);
+        return std::make_shared<storm::modelchecker::ExplicitQuantitativeCheckResult<ValueType>>(std::move(state_values));
+    }
+
+    template void parseRestrictedCheckingFormula<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp,
+        storm::logic::Formula const& formula,
+        bool& minimize,
+        storm::storage::BitVector& target_states,
+        storm::storage::BitVector& constraint_states
+    );
+
+    template std::vector<double> restrictedValueIteration<double>(
+        storm::storage::SparseMatrix<double> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        double precision,
+        uint64_t max_iterations
+    );
+
+    template std::pair<std::vector<double>,bool> restrictedValueIterationThreshold<double>(
+        storm::storage::SparseMatrix<double> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        double precision,
+        uint64_t max_iterations,
+        double threshold,
+        bool decide_below,
+        uint64_t initial_state
+    );
+
+    template std::pair<storm::storage::BitVector,storm::storage::BitVector> restrictedProb01<double>(
+        storm::storage::SparseMatrix<double> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize
+    );
+
+    template std::pair<storm::storage::BitVector,storm::storage::BitVector> verifyRestrictedMdpQualitative<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula
+    );
+
+    template std::shared_ptr<storm::modelchecker::CheckResult> verifyRestrictedMdp<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula
+    );
+
+    template std::vector<double> restrictedRewardBoundedReachability<double>(
+        storm::storage::SparseMatrix<double> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        std::vector<uint64_t> const& choice_rewards,
+        uint64_t reward_bound,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        double precision,
+        uint64_t max_iterations
+    );
+
+    template std::shared_ptr<storm::modelchecker::CheckResult> verifyRestrictedMdpRewardBounded<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula,
+        std::string const& reward_model_name,
+        uint64_t reward_bound
+    );
+
+    template void parseRestrictedCheckingFormula<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& quotient_mdp,
+        storm::logic::Formula const& formula,
+        bool& minimize,
+        storm::storage::BitVector& target_states,
+        storm::storage::BitVector& constraint_states
+    );
+
+    template std::vector<storm::RationalNumber> restrictedValueIteration<storm::RationalNumber>(
+        storm::storage::SparseMatrix<storm::RationalNumber> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        storm::RationalNumber precision,
+        uint64_t max_iterations
+    );
+
+    template std::pair<std::vector<storm::RationalNumber>,bool> restrictedValueIterationThreshold<storm::RationalNumber>(
+        storm::storage::SparseMatrix<storm::RationalNumber> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        storm::RationalNumber precision,
+        uint64_t max_iterations,
+        storm::RationalNumber threshold,
+        bool decide_below,
+        uint64_t initial_state
+    );
+
+    template std::pair<storm::storage::BitVector,storm::storage::BitVector> restrictedProb01<storm::RationalNumber>(
+        storm::storage::SparseMatrix<storm::RationalNumber> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize
+    );
+
+    template std::pair<storm::storage::BitVector,storm::storage::BitVector> verifyRestrictedMdpQualitative<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula
+    );
+
+    template std::shared_ptr<storm::modelchecker::CheckResult> verifyRestrictedMdp<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula
+    );
+
+    template std::vector<storm::RationalNumber> restrictedRewardBoundedReachability<storm::RationalNumber>(
+        storm::storage::SparseMatrix<storm::RationalNumber> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        std::vector<uint64_t> const& choice_rewards,
+        uint64_t reward_bound,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        storm::RationalNumber precision,
+        uint64_t max_iterations
+    );
+
+    template std::shared_ptr<storm::modelchecker::CheckResult> verifyRestrictedMdpRewardBounded<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula,
+        std::string const& reward_model_name,
+        uint64_t reward_bound
+    );
+
+    template<typename ValueType>
+    std::vector<std::shared_ptr<storm::modelchecker::CheckResult>> verifyMdpMultiple(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulae,
+        bool produce_schedulers
+    ) {
+        storm::modelchecker::SparseMdpPrctlModelChecker<storm::models::sparse::Mdp<ValueType>> modelchecker(*mdp);
+        std::vector<std::shared_ptr<storm::modelchecker::CheckResult>> results;
+        results.reserve(formulae.size());
+        // formulae over the same target sets print identically, so the string form works as
+        // the deduplication key and coinciding formulae share one check and one result
+        std::map<std::string, std::shared_ptr<storm::modelchecker::CheckResult>> result_for_formula;
+        for (auto const& formula : formulae) {
+            std::string key = formula->toString();
+            auto it = result_for_formula.find(key);
+            if (it == result_for_formula.end()) {
+                storm::modelchecker::CheckTask<storm::logic::Formula, ValueType> task(*formula);
+                task.setProduceSchedulers(produce_schedulers);
+                it = result_for_formula.emplace(key, modelchecker.check(env, task)).first;
+            }
+            results.push_back(it->second);
+        }
+        return results;
+    }
+
+    template std::vector<std::shared_ptr<storm::modelchecker::CheckResult>> verifyMdpMultiple<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& mdp,
+        std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulae,
+        bool produce_schedulers
+    );
+    template std::vector<std::shared_ptr<storm::modelchecker::CheckResult>> verifyMdpMultiple<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& mdp,
+        std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulae,
+        bool produce_schedulers
+    );
+
+    template<typename ValueType>
+    std::pair<storm::storage::BitVector,std::vector<ValueType>> verifyPolicyTreeLeaves(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        std::vector<uint64_t> const& choice_to_action,
+        SchedulerRegistry const& registry,
+        std::vector<storm::storage::BitVector> const& family_choices,
+        std::vector<uint64_t> const& policy_handles,
+        storm::logic::Formula const& formula,
+        ValueType threshold,
+        bool threshold_is_upper_bound
+    ) {
+        STORM_LOG_THROW(family_choices.size() == policy_handles.size(), storm::exceptions::NotSupportedException, "expected one policy handle per family");
+        bool minimize;
+        storm::storage::BitVector target_states, constraint_states;
+        parseRestrictedCheckingFormula(env, quotient_mdp, formula, minimize, target_states, constraint_states);
+        ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+        uint64_t max_iterations = env.solver().minMax().getMaximalNumberOfIterations();
+
+        auto const& matrix = quotient_mdp->getTransitionMatrix();
+        auto const& row_group_indices = matrix.getRowGroupIndices();
+        uint64_t state_count = matrix.getRowGroupCount();
+        uint64_t initial_state = *quotient_mdp->getInitialStates().begin();
+
+        uint64_t num_leaves = family_choices.size();
+        std::vector<ValueType> leaf_values(num_leaves, storm::utility::zero<ValueType>());
+        std::vector<char> leaf_sat(num_leaves, 0);
+        auto verifyRange = [&](uint64_t leaf_begin, uint64_t leaf_end) {
+            for (uint64_t leaf = leaf_begin; leaf < leaf_end; ++leaf) {
+                auto const& policy = registry.getPolicy(policy_handles[leaf]);
+                auto const& leaf_choices = family_choices[leaf];
+                // enabled rows: family choices that execute the policy action; at states where
+                // the policy is undefined or its action is unavailable (both unreachable under
+                // the policy), keep all family choices so that every state keeps a choice
+                storm::storage::BitVector choice_mask(matrix.getRowCount(), false);
+                for (uint64_t state = 0; state < state_count; ++state) {
+                    bool any_enabled = false;
+                    bool policy_defined = policy[state] != SchedulerRegistry::UNDEFINED_ACTION;
+                    for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                        if (leaf_choices.get(row) and (not policy_defined or choice_to_action[row] == policy[state])) {
+                            choice_mask.set(row, true);
+                            any_enabled = true;
+                        }
+                    }
+                    if (not any_enabled) {
+                        for (uint64_t row = row_group_indices[state]; row < row_group_indices[state+1]; ++row) {
+                            choice_mask.set(row, leaf_choices.get(row));
+                        }
+                    }
+                }
+                std::vector<ValueType> state_values = restrictedValueIteration(
+                    matrix, choice_mask, target_states, constraint_states, minimize, precision, max_iterations);
+                ValueType value = state_values[initial_state];
+                leaf_values[leaf] = value;
+                leaf_sat[leaf] = (threshold_is_upper_bound ? value <= threshold : value >= threshold) ? 1 : 0;
+            }
+        };
+
+        uint64_t num_workers = std::min<uint64_t>(std::max(std::thread::hardware_concurrency(), 1u), num_leaves);
+        if (num_workers <= 1) {
+            verifyRange(0, num_leaves);
+        } else {
+            uint64_t leaves_per_worker = (num_leaves + num_workers - 1) / num_workers;
+            std::vector<std::thread> workers;
+            workers.reserve(num_workers-1);
+            for (uint64_t worker = 1; worker < num_workers; ++worker) {
+                uint64_t leaf_begin = std::min(worker*leaves_per_worker, num_leaves);
+                uint64_t leaf_end = std::min(leaf_begin+leaves_per_worker, num_leaves);
+                workers.emplace_back(verifyRange, leaf_begin, leaf_end);
+            }
+            verifyRange(0, std::min(leaves_per_worker, num_leaves));
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        storm::storage::BitVector sat_mask(num_leaves, false);
+        for (uint64_t leaf = 0; leaf < num_leaves; ++leaf) {
+            if (leaf_sat[leaf]) {
+                sat_mask.set(leaf, true);
+            }
+        }
+        return std::make_pair(std::move(sat_mask), std::move(leaf_values));
+    }
+
+    template std::pair<storm::storage::BitVector,std::vector<double>> verifyPolicyTreeLeaves<double>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<double>> const& quotient_mdp,
+        std::vector<uint64_t> const& choice_to_action,
+        SchedulerRegistry const& registry,
+        std::vector<storm::storage::BitVector> const& family_choices,
+        std::vector<uint64_t> const& policy_handles,
+        storm::logic::Formula const& formula,
+        double threshold,
+        bool threshold_is_upper_bound
+    );
+    template std::pair<storm::storage::BitVector,std::vector<storm::RationalNumber>> verifyPolicyTreeLeaves<storm::RationalNumber>(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<storm::RationalNumber>> const& quotient_mdp,
+        std::vector<uint64_t> const& choice_to_action,
+        SchedulerRegistry const& registry,
+        std::vector<storm::storage::BitVector> const& family_choices,
+        std::vector<uint64_t> const& policy_handles,
+        storm::logic::Formula const& formula,
+        storm::RationalNumber threshold,
+        bool threshold_is_upper_bound
+    );
 }
@@ -15,4 +15,259 @@ namespace synthesis {
         bool produce_schedulers
     );
 
+    /**
+     * Store a result vector in the warm-start registry and return its id. Registered vectors
+     * can be passed to verifyMdp as an initial-value hint without copying them through the
+     * python layer; drop them via dropResultVector when the family node is discarded.
+     */
+    template<typename ValueType>
+    uint64_t storeResultVector(std::vector<ValueType>&& values);
+
+    /** Remove a result vector from the warm-start registry. */
+    template<typename ValueType>
+    void dropResultVector(uint64_t vector_id);
+
+    /**
+     * Like verifyMdp, but seeds the solver with the registered result vector as an
+     * initial-value hint. Sibling subfamilies have value functions close to their parent's,
+     * so iteration converges in a fraction of the sweeps.
+     */
+    template<typename ValueType>
+    std::shared_ptr<storm::modelchecker::CheckResult> verifyMdp(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        storm::logic::Formula const& formula,
+        bool produce_schedulers,
+        uint64_t initial_values_id
+    );
+
+    /**
+     * Cheap budgeted check of a reachability or until probability operator: at most
+     * \p max_iterations sweeps of interval iteration (a lower sweep from zero, an upper sweep
+     * from one) and no solver setup. The returned bound is taken on the optimistic side -
+     * the upper value in the initial state when maximizing, the lower value when minimizing -
+     * so it is always a valid bound for pruning: the upper sweep may only over-approximate
+     * (inside end components), the lower sweep only under-approximates. The flag reports
+     * whether the sweeps converged within the budget, i.e. whether the bound is the value
+     * itself up to the precision of the environment.
+     * @return the bound in the initial state and whether it is converged
+     */
+    template<typename ValueType>
+    std::pair<ValueType,bool> verifyMdpBudgeted(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        storm::logic::Formula const& formula,
+        uint64_t max_iterations
+    );
+
+    /**
+     * Compute the expected number of visits of each state under the given memoryless
+     * deterministic scheduler, starting from the initial state of the MDP. The transposed
+     * flow equations - the visits of a state are its initial mass plus the inflow from its
+     * predecessors - are iterated until the counts change by less than the precision of the
+     * environment or the iteration cap of the environment is hit (states inside recurrent
+     * classes have unbounded visit counts and never converge). For each state the first
+     * enabled row of \p scheduler_choices is played; states without an enabled row are
+     * absorbing.
+     */
+    template<typename ValueType>
+    std::vector<ValueType> computeExpectedVisits(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        storm::storage::BitVector const& scheduler_choices
+    );
+
+    /**
+     * Evaluate the state sets of a reachability or until probability operator on the quotient
+     * and read off the optimization direction. Shared by the restricted checking routines.
+     */
+    template<typename ValueType>
+    void parseRestrictedCheckingFormula(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::logic::Formula const& formula,
+        bool& minimize,
+        storm::storage::BitVector& target_states,
+        storm::storage::BitVector& constraint_states
+    );
+
+    /**
+     * Value iteration over the quotient matrix, reducing only over the enabled rows. States
+     * whose value change stays below the precision for a few consecutive iterations are
+     * frozen and skipped until one of their successors changes again.
+     */
+    template<typename ValueType>
+    std::vector<ValueType> restrictedValueIteration(
+        storm::storage::SparseMatrix<ValueType> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        ValueType precision,
+        uint64_t max_iterations
+    );
+
+    /**
+     * Threshold-aware variant of \ref restrictedValueIteration running interval iteration:
+     * a lower sweep from zero and an upper sweep from one. Iteration stops as soon as the
+     * initial-state interval clears the threshold on the pruning side - upper value at or
+     * below the threshold when \p decide_below, lower value at or above it otherwise - which
+     * typically happens many sweeps before convergence. The upper sweep may over-approximate
+     * inside end components, which keeps it sound for this one-sided decision.
+     * @return the lower state values and whether the threshold decision was reached
+     */
+    template<typename ValueType>
+    std::pair<std::vector<ValueType>,bool> restrictedValueIterationThreshold(
+        storm::storage::SparseMatrix<ValueType> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        ValueType precision,
+        uint64_t max_iterations,
+        ValueType threshold,
+        bool decide_below,
+        uint64_t initial_state
+    );
+
+    /**
+     * Graph-based qualitative analysis of the restriction of the quotient to the enabled
+     * choices: compute the states whose reachability probability is exactly 0 and exactly 1
+     * in the given optimization direction, by backward-reachability fixpoints only, without
+     * any numeric iteration. The complement of the two sets is the remaining quantitative
+     * problem. The restriction must keep the quotient's state space.
+     * @return the prob0 states and the prob1 states
+     */
+    template<typename ValueType>
+    std::pair<storm::storage::BitVector,storm::storage::BitVector> restrictedProb01(
+        storm::storage::SparseMatrix<ValueType> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize
+    );
+
+    /**
+     * Qualitative preprocessing of a reachability or until probability formula on the
+     * restriction of the quotient MDP to the enabled choices, see \ref restrictedProb01.
+     * Sub-checks whose initial state lands in one of the returned sets are decided without
+     * ever running value iteration.
+     * @return the prob0 states and the prob1 states
+     */
+    template<typename ValueType>
+    std::pair<storm::storage::BitVector,storm::storage::BitVector> verifyRestrictedMdpQualitative(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula
+    );
+
+    /**
+     * Check a reachability or until probability formula against the restriction of the given
+     * quotient MDP to the enabled choices, without materializing the restricted model: value
+     * iteration runs directly over the quotient's transition matrix and skips masked rows.
+     * The restriction must keep the quotient's state space (every state keeps at least one
+     * enabled choice). Other formula types are rejected.
+     */
+    template<typename ValueType>
+    std::shared_ptr<storm::modelchecker::CheckResult> verifyRestrictedMdp(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula
+    );
+
+    /**
+     * Reward-bounded reachability over the restriction of the quotient matrix to the enabled
+     * rows, computed Storm-style by sequential epoch sweeps instead of unfolding the bound
+     * into the state space: epoch b holds for each state the probability of reaching a target
+     * state while accumulating at most b reward. A row of reward r read in epoch b refers to
+     * the values of epoch b-r, which are already fixed, so only the zero-reward rows are
+     * iterated within an epoch; epochs older than the largest row reward are dropped, keeping
+     * the memory footprint independent of the bound. Rewards are per enabled row, non-negative
+     * integers.
+     * @return for each state, the value of the final epoch \p reward_bound
+     */
+    template<typename ValueType>
+    std::vector<ValueType> restrictedRewardBoundedReachability(
+        storm::storage::SparseMatrix<ValueType> const& matrix,
+        storm::storage::BitVector const& choice_mask,
+        std::vector<uint64_t> const& choice_rewards,
+        uint64_t reward_bound,
+        storm::storage::BitVector const& target_states,
+        storm::storage::BitVector const& constraint_states,
+        bool minimize,
+        ValueType precision,
+        uint64_t max_iterations
+    );
+
+    /**
+     * Check a reward-bounded reachability property against the restriction of the quotient
+     * MDP to the enabled choices: the probability of reaching the target states of \p formula
+     * while accumulating at most \p reward_bound reward of the named reward model. The state
+     * sets and the optimization direction are taken from \p formula (a plain reachability or
+     * until operator); the bound is passed explicitly, so the quotient never has to be
+     * unfolded. The reward model must assign non-negative integer state-action rewards.
+     */
+    template<typename ValueType>
+    std::shared_ptr<storm::modelchecker::CheckResult> verifyRestrictedMdpRewardBounded(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::storage::BitVector const& choice_mask,
+        storm::logic::Formula const& formula,
+        std::string const& reward_model_name,
+        uint64_t reward_bound
+    );
+
+    /**
+     * Check a reachability or until probability operator in both optimization directions at
+     * once. AR runs the minimizing and the maximizing bound of a family as two sequential
+     * checks over the same matrix; here a single sweep per iteration walks every row once
+     * and reduces its value into both bounds, halving the memory traffic of that
+     * double-check pattern. The optimality type of the formula is ignored.
+     * @return the minimizing and the maximizing state values
+     */
+    template<typename ValueType>
+    std::pair<std::shared_ptr<storm::modelchecker::CheckResult>,std::shared_ptr<storm::modelchecker::CheckResult>> verifyMdpBidirectional(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        storm::logic::Formula const& formula
+    );
+
+    /**
+     * Check multiple formulae against the same MDP in one call. The model checker is
+     * constructed once and formulae that coincide are checked only once, with the result
+     * shared between their slots. The results are returned in the order of the formulae.
+     */
+    template<typename ValueType>
+    std::vector<std::shared_ptr<storm::modelchecker::CheckResult>> verifyMdpMultiple(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& mdp,
+        std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulae,
+        bool produce_schedulers
+    );
+
+    class SchedulerRegistry;
+
+    /**
+     * Re-verify the policies of the leaves of a policy tree in one parallel sweep. For each
+     * leaf, the quotient is restricted to the family choices that execute its policy (looked
+     * up in the registry by handle), the reachability/until formula is checked on the
+     * restriction without materializing a model, and the value in the initial state is
+     * compared against the threshold.
+     * @return for each leaf, whether the value meets the threshold, and the values themselves
+     */
+    template<typename ValueType>
+    std::pair<storm::storage::BitVector,std::vector<ValueType>> verifyPolicyTreeLeaves(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        std::vector<uint64_t> const& choice_to_action,
+        SchedulerRegistry const& registry,
+        std::vector<storm::storage::BitVector> const& family_choices,
+        std::vector<uint64_t> const& policy_handles,
+        storm::logic::Formula const& formula,
+        ValueType threshold,
+        bool threshold_is_upper_bound
+    );
+
 }
@@ -0,0 +1,143 @@
+#include "QuantizedQuotientChecker.h"
+#include "MdpModelChecker.h"
+
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/environment/solver/MinMaxSolverEnvironment.h"
+#include "storm/utility/constants.h"
+
+#include <cmath>
+
+namespace synthesis {
+
+    template<typename ValueType>
+    QuantizedQuotientChecker<ValueType>::QuantizedQuotientChecker(
+        storm::Environment const& env,
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+        storm::logic::Formula const& formula
+    ) : quotient_mdp(quotient_mdp) {
+        parseRestrictedCheckingFormula(env, quotient_mdp, formula, this->minimize, this->target_states, this->constraint_states);
+        this->initial_state = *(quotient_mdp->getInitialStates().begin());
+        this->precision = storm::utility::convertNumber<ValueType>(env.solver().minMax().getPrecision());
+
+        // quantize the matrix into a flat float32 image; the row-group layout is shared with
+        // the quotient, so restriction masks index the shadow and the original alike
+        auto const& matrix = quotient_mdp->getTransitionMatrix();
+        this->row_group_indices.assign(matrix.getRowGroupIndices().begin(), matrix.getRowGroupIndices().end());
+        uint64_t num_rows = matrix.getRowCount();
+        this->row_indices.reserve(num_rows+1);
+        this->shadow_columns.reserve(matrix.getEntryCount());
+        this->shadow_values.reserve(matrix.getEntryCount());
+        for(uint64_t row = 0; row < num_rows; ++row) {
+            this->row_indices.push_back(this->shadow_columns.size());
+            for(auto const& entry: matrix.getRow(row)) {
+                this->shadow_columns.push_back(entry.getColumn());
+                this->shadow_values.push_back(static_cast<float>(storm::utility::convertNumber<double>(entry.getValue())));
+            }
+        }
+        this->row_indices.push_back(this->shadow_columns.size());
+    }
+
+    template<typename ValueType>
+    std::pair<ValueType,bool> QuantizedQuotientChecker<ValueType>::checkThreshold(
+        storm::storage::BitVector const& choice_mask,
+        ValueType threshold,
+        bool decide_below,
+        uint64_t max_iterations
+    ) {
+        ++this->num_checks;
+        uint64_t state_count = this->row_group_indices.size()-1;
+        double threshold_double = storm::utility::convertNumber<double>(threshold);
+        float precision_float = static_cast<float>(storm::utility::convertNumber<double>(this->precision));
+
+        std::vector<float> lower_values(state_count, 0.0f);
+        std::vector<float> upper_values(state_count, 1.0f);
+        for(auto state: this->target_states) {
+            lower_values[state] = 1.0f;
+        }
+        for(uint64_t state = 0; state < state_count; ++state) {
+            if(not this->constraint_states.get(state) and not this->target_states.get(state)) {
+                upper_values[state] = 0.0f;
+            }
+        }
+        std::vector<float> lower_values_new = lower_values;
+        std::vector<float> upper_values_new = upper_values;
+        auto sweep = [&](std::vector<float> const& values, std::vector<float>& values_new) {
+            float max_diff = 0.0f;
+            for(uint64_t state = 0; state < state_count; ++state) {
+                if(this->target_states.get(state) or not this->constraint_states.get(state)) {
+                    continue;
+                }
+                float best_value = 0.0f;
+                bool first_row = true;
+                for(uint64_t row = this->row_group_indices[state]; row < this->row_group_indices[state+1]; ++row) {
+                    if(not choice_mask.get(row)) {
+                        continue;
+                    }
+                    float value = 0.0f;
+                    for(uint64_t entry = this->row_indices[row]; entry < this->row_indices[row+1]; ++entry) {
+                        value += this->shadow_values[entry] * values[this->shadow_columns[entry]];
+                    }
+                    if(first_row or (this->minimize ? value < best_value : value > best_value)) {
+                        best_value = value;
+                        first_row = false;
+                    }
+                }
+                STORM_LOG_ASSERT(not first_row, "state has no enabled choice");
+                float diff = std::abs(best_value - values[state]);
+                if(diff > max_diff) {
+                    max_diff = diff;
+                }
+                values_new[state] = best_value;
+            }
+            return max_diff;
+        };
+
+        bool converged = false;
+        uint64_t iteration = 0;
+        for(; iteration < max_iterations; ++iteration) {
+            float max_diff = sweep(lower_values, lower_values_new);
+            sweep(upper_values, upper_values_new);
+            lower_values.swap(lower_values_new);
+            upper_values.swap(upper_values_new);
+            double allowance = (iteration+1) * QUANTIZATION_EPS_PER_SWEEP;
+            // decide only when the interval clears the threshold by more than the rounding
+            // allowance, so the float verdict coincides with the full-precision one
+            if(decide_below ? upper_values[this->initial_state] <= threshold_double-allowance
+                : lower_values[this->initial_state] >= threshold_double+allowance) {
+                return std::make_pair(storm::utility::convertNumber<ValueType>(static_cast<double>(lower_values[this->initial_state])), true);
+            }
+            if(max_diff <= precision_float) {
+                converged = true;
+                break;
+            }
+        }
+
+        // the converged bound sits on the non-pruning side; when it does so by more than the
+        // allowance the negative verdict is equally trustworthy, otherwise the family is one
+        // of the few actually close to the threshold and is re-decided in full precision
+        double allowance = (iteration+1) * QUANTIZATION_EPS_PER_SWEEP;
+        double bound = decide_below ? upper_values[this->initial_state] : lower_values[this->initial_state];
+        if(converged and std::abs(bound - threshold_double) > allowance) {
+            return std::make_pair(storm::utility::convertNumber<ValueType>(static_cast<double>(lower_values[this->initial_state])), false);
+        }
+        ++this->num_promotions;
+        auto [state_values,decided] = restrictedValueIterationThreshold<ValueType>(
+            this->quotient_mdp->getTransitionMatrix(), choice_mask, this->target_states, this->constraint_states,
+            this->minimize, this->precision, max_iterations, threshold, decide_below, this->initial_state);
+        return std::make_pair(state_values[this->initial_state], decided);
+    }
+
+    template<typename ValueType>
+    uint64_t QuantizedQuotientChecker<ValueType>::numChecks() const {
+        return this->num_checks;
+    }
+
+    template<typename ValueType>
+    uint64_t QuantizedQuotientChecker<ValueType>::numPromotions() const {
+        return this->num_promotions;
+    }
+
+
+    template class QuantizedQuotientChecker<double>;
+
+}
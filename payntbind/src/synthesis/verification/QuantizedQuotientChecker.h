@@ -0,0 +1,96 @@
+#pragma once
+
+#include "storm/environment/Environment.h"
+#include "storm/logic/Formula.h"
+#include "storm/models/sparse/Mdp.h"
+#include "storm/storage/BitVector.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace synthesis {
+
+    /**
+     * Quantized threshold checking of restricted quotients. The checker keeps a float32 shadow
+     * of the quotient's transition matrix, built once, and decides family bounds against a
+     * threshold by interval iteration over the shadow: the value vectors and the matrix entries
+     * are single-precision, halving the memory traffic of the sweeps that dominate family bound
+     * computation. The decision is taken in float only when the interval clears the threshold
+     * by more than a conservative allowance for the accumulated rounding of the sweeps; bounds
+     * landing inside the allowance - the rare families that are actually close to the
+     * threshold - are promoted transparently to a double-precision re-check, so the verdict is
+     * always the one full precision would give.
+     */
+    template<typename ValueType>
+    class QuantizedQuotientChecker {
+    public:
+
+        /**
+         * Build the float32 shadow of the quotient and evaluate the state sets of the formula.
+         * @param formula a reachability or until probability operator with an optimality type
+         */
+        QuantizedQuotientChecker(
+            storm::Environment const& env,
+            std::shared_ptr<storm::models::sparse::Mdp<ValueType>> const& quotient_mdp,
+            storm::logic::Formula const& formula
+        );
+
+        /**
+         * Decide the bound of the restriction of the quotient to the enabled choices against
+         * the threshold, mirroring \ref restrictedValueIterationThreshold: iteration stops as
+         * soon as the initial-state interval clears the threshold on the pruning side by more
+         * than the quantization allowance. The restriction must keep the quotient's state
+         * space.
+         * @return the bound in the initial state and whether the threshold decision was reached
+         */
+        std::pair<ValueType,bool> checkThreshold(
+            storm::storage::BitVector const& choice_mask,
+            ValueType threshold,
+            bool decide_below,
+            uint64_t max_iterations
+        );
+
+        /** Number of threshold checks so far. */
+        uint64_t numChecks() const;
+        /** Number of checks whose float bound landed inside the allowance and were re-run in full precision. */
+        uint64_t numPromotions() const;
+
+    protected:
+
+        /**
+         * Absolute rounding allowance added per sweep. Probability values stay within [0,1],
+         * so one fused row reduction perturbs a value by a small multiple of the float32
+         * epsilon (~1.2e-7); the allowance grows linearly with the sweeps performed, which
+         * over-approximates the drift of the contracting iteration.
+         */
+        static constexpr double QUANTIZATION_EPS_PER_SWEEP = 1e-6;
+
+        /** The quotient, kept for the double-precision promotion path. */
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> quotient_mdp;
+        /** Whether the formula minimizes. */
+        bool minimize;
+        /** States satisfying the target subformula. */
+        storm::storage::BitVector target_states;
+        /** States satisfying the constraint subformula (all states for reachability). */
+        storm::storage::BitVector constraint_states;
+        /** The initial state of the quotient. */
+        uint64_t initial_state;
+        /** Precision of the double-precision promotion path. */
+        ValueType precision;
+
+        /** Row group indices of the shadow (shared with the quotient matrix layout). */
+        std::vector<uint64_t> row_group_indices;
+        /** Begin of each row in \ref shadow_columns / \ref shadow_values. */
+        std::vector<uint64_t> row_indices;
+        /** Column of each shadow entry. */
+        std::vector<uint32_t> shadow_columns;
+        /** Value of each shadow entry, quantized to single precision. */
+        std::vector<float> shadow_values;
+
+        /** Number of threshold checks so far. */
+        uint64_t num_checks = 0;
+        /** Number of checks promoted to full precision. */
+        uint64_t num_promotions = 0;
+    };
+
+}
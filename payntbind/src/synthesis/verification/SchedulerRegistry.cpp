@@ -0,0 +1,90 @@
+#include "SchedulerRegistry.h"
+
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/utility/macros.h"
+
+#include <limits>
+
+namespace synthesis {
+
+    const uint64_t SchedulerRegistry::UNDEFINED_ACTION = std::numeric_limits<uint64_t>::max();
+
+    std::size_t SchedulerRegistry::PolicyHash::operator()(std::vector<uint64_t> const& policy) const {
+        std::size_t seed = policy.size();
+        for (uint64_t choice : policy) {
+            seed ^= std::hash<uint64_t>()(choice) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+
+    uint64_t SchedulerRegistry::insertPolicy(std::vector<uint64_t> policy) {
+        auto it = policy_to_handle.find(policy);
+        if (it != policy_to_handle.end()) {
+            return it->second;
+        }
+        uint64_t handle = policies.size();
+        policy_to_handle.emplace(policy, handle);
+        policies.push_back(std::move(policy));
+        return handle;
+    }
+
+    uint64_t SchedulerRegistry::insertScheduler(storm::storage::Scheduler<double> const& scheduler) {
+        std::vector<uint64_t> policy(scheduler.getNumberOfModelStates());
+        for (uint64_t state = 0; state < policy.size(); ++state) {
+            auto const& choice = scheduler.getChoice(state);
+            policy[state] = choice.isDefined() ? choice.getDeterministicChoice() : UNDEFINED_ACTION;
+        }
+        return insertPolicy(std::move(policy));
+    }
+
+    std::vector<uint64_t> const& SchedulerRegistry::getPolicy(uint64_t handle) const {
+        STORM_LOG_THROW(handle < policies.size(), storm::exceptions::InvalidArgumentException, "unknown policy handle");
+        return policies[handle];
+    }
+
+    uint64_t SchedulerRegistry::numPolicies() const {
+        return policies.size();
+    }
+
+    bool SchedulerRegistry::policiesAreCompatible(uint64_t handle1, uint64_t handle2) const {
+        auto const& policy1 = getPolicy(handle1);
+        auto const& policy2 = getPolicy(handle2);
+        STORM_LOG_THROW(policy1.size() == policy2.size(), storm::exceptions::InvalidArgumentException, "policies have different state spaces");
+        for (uint64_t state = 0; state < policy1.size(); ++state) {
+            if (policy1[state] == UNDEFINED_ACTION or policy2[state] == UNDEFINED_ACTION) {
+                continue;
+            }
+            if (policy1[state] != policy2[state]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint64_t SchedulerRegistry::mergePolicies(uint64_t handle1, uint64_t handle2) {
+        STORM_LOG_THROW(policiesAreCompatible(handle1, handle2), storm::exceptions::InvalidArgumentException, "policies are not compatible");
+        std::vector<uint64_t> merged = getPolicy(handle1);
+        auto const& policy2 = getPolicy(handle2);
+        for (uint64_t state = 0; state < merged.size(); ++state) {
+            if (merged[state] == UNDEFINED_ACTION) {
+                merged[state] = policy2[state];
+            }
+        }
+        return insertPolicy(std::move(merged));
+    }
+
+    std::pair<uint64_t,uint64_t> SchedulerRegistry::mergePoliciesExclusively(uint64_t handle1, uint64_t handle2) {
+        std::vector<uint64_t> policy12 = getPolicy(handle1);
+        std::vector<uint64_t> policy21 = getPolicy(handle2);
+        STORM_LOG_THROW(policy12.size() == policy21.size(), storm::exceptions::InvalidArgumentException, "policies have different state spaces");
+        for (uint64_t state = 0; state < policy12.size(); ++state) {
+            if (policy12[state] == UNDEFINED_ACTION) {
+                policy12[state] = policy21[state];
+            } else if (policy21[state] == UNDEFINED_ACTION) {
+                policy21[state] = policy12[state];
+            }
+        }
+        return std::make_pair(insertPolicy(std::move(policy12)), insertPolicy(std::move(policy21)));
+    }
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "storm/storage/Scheduler.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace synthesis {
+
+    /**
+     * Content-addressed storage for memoryless policies. A policy is a vector that maps each
+     * state to a choice, with UNDEFINED_ACTION marking states where the policy is undefined.
+     * Policies are deduplicated on insertion: identical contents share one slot and one
+     * integer handle, so callers can keep per-leaf handles instead of per-leaf copies.
+     */
+    class SchedulerRegistry {
+    public:
+
+        /** Marks states where a policy is undefined. */
+        static const uint64_t UNDEFINED_ACTION;
+
+        /** Store a policy and return its handle; identical policies share a handle. */
+        uint64_t insertPolicy(std::vector<uint64_t> policy);
+
+        /** Store the deterministic choices of a scheduler produced by model checking. */
+        uint64_t insertScheduler(storm::storage::Scheduler<double> const& scheduler);
+
+        /** Retrieve a stored policy. */
+        std::vector<uint64_t> const& getPolicy(uint64_t handle) const;
+
+        /** @return the number of distinct policies stored. */
+        uint64_t numPolicies() const;
+
+        /** Check whether two policies agree on every state where both are defined. */
+        bool policiesAreCompatible(uint64_t handle1, uint64_t handle2) const;
+
+        /**
+         * Merge two compatible policies into their union: each state takes the choice of
+         * whichever policy defines it, preferring the first.
+         * @return the handle of the merged policy
+         */
+        uint64_t mergePolicies(uint64_t handle1, uint64_t handle2);
+
+        /**
+         * Fill the undefined states of each policy with the choices of the other.
+         * @return the handles of both filled policies
+         */
+        std::pair<uint64_t,uint64_t> mergePoliciesExclusively(uint64_t handle1, uint64_t handle2);
+
+    private:
+
+        struct PolicyHash {
+            std::size_t operator()(std::vector<uint64_t> const& policy) const;
+        };
+
+        /** Storage of distinct policies, indexed by handle. */
+        std::vector<std::vector<uint64_t>> policies;
+        /** Content index for deduplication. */
+        std::unordered_map<std::vector<uint64_t>, uint64_t, PolicyHash> policy_to_handle;
+    };
+
+}
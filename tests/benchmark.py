@@ -0,0 +1,184 @@
+"""
+Performance regression harness.
+
+Runs a curated subset of models/ through the synthesis engines with fixed seeds,
+collects the overall wall time plus the per-phase breakdown from the native trace
+counters, and compares both against the budgets checked in at perf_budgets.json.
+A measurement fails when it exceeds its budget by more than the tolerance band,
+so a 2x regression is caught before a build ships while machine noise is not.
+
+Budgets are machine-specific: seed or refresh them on the reference machine with
+
+    python3 benchmark.py --update
+
+and review the rewritten perf_budgets.json like any other diff. The harness exits
+nonzero on the first over-budget benchmark, making it usable as a CI gate.
+"""
+
+import json
+import os
+import random
+import time
+
+import click
+
+import payntbind
+
+import paynt.parser.sketch
+import paynt.synthesizer.synthesizer
+import paynt.utils.timer
+
+import logging
+logger = logging.getLogger(__name__)
+
+MODELS_ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "models")
+BUDGETS_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "perf_budgets.json")
+
+# phases shorter than this are not budgeted: their relative jitter exceeds any
+# band that would still catch a real regression
+MIN_BUDGETED_PHASE_SECONDS = 0.05
+
+
+class Benchmark:
+    """One synthesis run: a project from models/ plus the engine to drive it with."""
+
+    def __init__(self, name, project, method="ar", sketch="sketch.templ", props="sketch.props", tree_depth=0):
+        self.name = name
+        self.project = project
+        self.method = method
+        self.sketch = sketch
+        self.props = props
+        self.tree_depth = tree_depth
+
+
+# the curated corpus: small enough to finish in seconds, one project per model
+# class, and the kydie sketch across every engine so each synthesis mode is
+# exercised at least once
+BENCHMARKS = [
+    Benchmark("dtmc-kydie-onebyone", "dtmc/kydie", method="onebyone"),
+    Benchmark("dtmc-kydie-ar", "dtmc/kydie", method="ar"),
+    Benchmark("dtmc-kydie-cegis", "dtmc/kydie", method="cegis"),
+    Benchmark("dtmc-kydie-hybrid", "dtmc/kydie", method="hybrid"),
+    Benchmark("mdp-maze-tree", "mdp/maze", tree_depth=2),
+    Benchmark("mdp-simple-tree", "mdp/simple", tree_depth=1),
+    Benchmark("pomdp-maze-tiny-ar", "pomdp/maze/tiny", method="ar"),
+    Benchmark("posmg-dice-and-coin-ar", "posmg/dice-and-coin", method="ar"),
+    Benchmark("cassandra-1d-ar", "cassandra/pomdp", method="ar",
+        sketch="1d.pomdp", props="../max_discounted_reward.props"),
+]
+
+
+def run_benchmark(benchmark, timeout):
+    """Run one benchmark and return its measurement: total wall time plus the
+    per-phase seconds aggregated from the native trace counters."""
+    # hiding the import here to avoid mutual top-level imports, as in choose_synthesizer
+    import paynt.synthesizer.decision_tree
+    paynt.synthesizer.decision_tree.SynthesizerDecisionTree.tree_depth = benchmark.tree_depth
+
+    # fixed seeds so that every heuristic tie-break replays the same way
+    random.seed(0)
+    paynt.utils.timer.GlobalTimer.start(timeout)
+
+    sketch_path = os.path.join(MODELS_ROOT, benchmark.project, benchmark.sketch)
+    properties_path = os.path.join(MODELS_ROOT, benchmark.project, benchmark.props)
+    quotient = paynt.parser.sketch.Sketch.load_sketch(sketch_path, properties_path)
+    synthesizer = paynt.synthesizer.synthesizer.Synthesizer.choose_synthesizer(quotient, benchmark.method)
+
+    payntbind.synthesis.trace_reset()
+    start = time.perf_counter()
+    synthesizer.run()
+    total_seconds = time.perf_counter() - start
+
+    trace = json.loads(payntbind.synthesis.trace_report())
+    phases = {
+        phase: round(stats["total_ns"] / 1e9, 3)
+        for phase, stats in sorted(trace.items())
+        if stats["total_ns"] / 1e9 >= MIN_BUDGETED_PHASE_SECONDS
+    }
+    return {"total_seconds": round(total_seconds, 3), "phases": phases}
+
+
+def within_budget(measured, budget, tolerance, slack):
+    return measured <= budget * tolerance + slack
+
+
+def compare_measurement(name, measurement, budget, tolerance, slack):
+    """Compare one measurement against its budget and return the list of violations."""
+    violations = []
+    if not within_budget(measurement["total_seconds"], budget["total_seconds"], tolerance, slack):
+        violations.append("{}: total {} s exceeds budget {} s (tolerance {}x + {} s)".format(
+            name, measurement["total_seconds"], budget["total_seconds"], tolerance, slack))
+    for phase, budget_seconds in budget.get("phases", {}).items():
+        measured_seconds = measurement["phases"].get(phase, 0)
+        if not within_budget(measured_seconds, budget_seconds, tolerance, slack):
+            violations.append("{}: phase {} took {} s, budget {} s".format(
+                name, phase, measured_seconds, budget_seconds))
+    return violations
+
+
+def load_budgets():
+    if not os.path.isfile(BUDGETS_PATH):
+        return {}
+    with open(BUDGETS_PATH) as file:
+        budgets = json.load(file)
+    return {name: budget for name, budget in budgets.items() if not name.startswith("_")}
+
+
+def save_budgets(budgets):
+    header = {"_comment":
+        "Wall-time budgets in seconds per benchmark, seeded on the reference machine "
+        "with 'python3 benchmark.py --update'; see benchmark.py for the tolerance bands."}
+    with open(BUDGETS_PATH, "w") as file:
+        json.dump({**header, **dict(sorted(budgets.items()))}, file, indent=4)
+        file.write("\n")
+
+
+@click.command()
+@click.option("--filter", "name_filter", default=None,
+    help="run only benchmarks whose name contains this substring")
+@click.option("--tolerance", default=1.5, show_default=True,
+    help="multiplicative tolerance band over each budget")
+@click.option("--slack", default=0.25, show_default=True,
+    help="absolute slack (s) added on top of the band, absorbs noise on sub-second budgets")
+@click.option("--timeout", type=int, default=300, show_default=True,
+    help="per-benchmark synthesis timeout (s)")
+@click.option("--update", is_flag=True, default=False,
+    help="rewrite the budgets from this run instead of checking against them")
+def main(name_filter, tolerance, slack, timeout, update):
+    benchmarks = [b for b in BENCHMARKS if name_filter is None or name_filter in b.name]
+    if not benchmarks:
+        print(f"no benchmark matches '{name_filter}'")
+        exit(1)
+
+    budgets = load_budgets()
+    violations = []
+    for benchmark in benchmarks:
+        print(f"running {benchmark.name} ...", flush=True)
+        measurement = run_benchmark(benchmark, timeout)
+        print(f"  total: {measurement['total_seconds']} s")
+        for phase, seconds in measurement["phases"].items():
+            print(f"  {phase}: {seconds} s")
+        if update:
+            budgets[benchmark.name] = measurement
+        elif benchmark.name not in budgets:
+            print(f"  no budget for {benchmark.name}, measurement recorded only; seed budgets with --update")
+        else:
+            benchmark_violations = compare_measurement(
+                benchmark.name, measurement, budgets[benchmark.name], tolerance, slack)
+            violations += benchmark_violations
+            print("  over budget" if benchmark_violations else "  within budget")
+
+    if update:
+        save_budgets(budgets)
+        print(f"budgets written to {BUDGETS_PATH}")
+        return
+    if violations:
+        print("perf budget violations:")
+        for violation in violations:
+            print(f"  {violation}")
+        exit(1)
+    print("all benchmarks within budget")
+
+
+if __name__ == "__main__":
+    main()
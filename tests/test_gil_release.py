@@ -0,0 +1,65 @@
+import random
+import threading
+import time
+import unittest
+
+import payntbind
+
+"""
+GilReleaseTestSuite, which ensures that long-running payntbind natives release
+the GIL: a Python thread must keep making progress while a native call runs.
+"""
+
+
+class GilReleaseTestSuite(unittest.TestCase):
+
+    def test_progress_during_native_call(self):
+
+        # 1.setup phase: a synthetic coloring large enough that the batch
+        # compatibility check runs for a macroscopic amount of time
+        num_holes = 8
+        options_per_hole = 4
+        family = payntbind.synthesis.Family()
+        for hole in range(num_holes):
+            family.addHole(options_per_hole)
+
+        num_states = 100000
+        choices_per_state = 4
+        num_choices = num_states * choices_per_state
+        row_groups = list(range(0, num_choices + 1, choices_per_state))
+        rng = random.Random(0)
+        choice_to_hole_options = [
+            [(rng.randrange(num_holes), rng.randrange(options_per_hole))]
+            for choice in range(num_choices)
+        ]
+        coloring = payntbind.synthesis.Coloring(family, row_groups, choice_to_hole_options)
+        subfamilies = [payntbind.synthesis.Family(family) for _ in range(256)]
+
+        # 2.exercise phase: run the native call in a worker thread and count
+        # how often the main thread gets scheduled in the meantime
+        entered = threading.Event()
+
+        def run_batch():
+            entered.set()
+            coloring.selectCompatibleChoicesBatch(subfamilies)
+
+        worker = threading.Thread(target=run_batch)
+        start = time.time()
+        worker.start()
+        entered.wait()
+        ticks = 0
+        while worker.is_alive():
+            ticks += 1
+            time.sleep(0.001)
+        worker.join()
+        elapsed = time.time() - start
+
+        # 3.verify phase: without py::gil_scoped_release the main thread would
+        # be frozen for the whole call and record no ticks at all; only insist
+        # on progress if the call ran long enough for the check to be meaningful
+        if elapsed > 0.1:
+            self.assertGreater(ticks, 0)
+
+
+if __name__ == '__main__':
+    unittest.main()